@@ -1,6 +1,7 @@
 /* ============================================================================
    /core/api.c — Runtime C11 « ultra complet » pour applis Vitte/Vitl
-   Mono-fichier amalgamé. Zéro dépendance hors libc.
+   Mono-fichier amalgamé. Dépend de la libc, et de table.c + hash.c pour
+   MapStrU64.
    Plateformes: POSIX (Linux/macOS), Windows.
    ============================================================================
  */
@@ -22,6 +23,7 @@
 #include <string.h>
 #include <time.h>
 
+#include "table.h"
 #include "utf8.h"
 
 #if defined(_WIN32)
@@ -452,71 +454,62 @@ API_EXPORT u64 hash64(const void* data, usize n) {
 API_EXPORT u64 hash_str(const char* s) { return hash64(s, strlen(s)); }
 
 /* --------------------------------------------------------------------------
-   Table de hachage (open addressing, string → u64)
+   Table de hachage (string → u64), moteur swiss de table.c
+   Un bloc par clé: [u64 valeur][clé\0]. La table adopte la clé (bloc + 8)
+   et garde en valeur le début du bloc; une mise à jour écrit en place.
    -------------------------------------------------------------------------- */
 typedef struct {
-  char* key;
-  u64 val;
-  u64 hash;
-  bool used;
-} HSlot;
-
-typedef struct {
-  HSlot* slots;
-  usize cap;
+  vt_table* tab; /* créée à la première insertion */
   usize len;
 } MapStrU64;
 
-static usize map_ideal_cap(usize need) {
-  usize c = 16;
-  while (c < need * 2) c <<= 1;
-  return c;
-}
-static void map_rehash(MapStrU64* m, usize ncap) {
-  HSlot* ns = (HSlot*)calloc(ncap, sizeof(HSlot));
-  for (usize i = 0; i < m->cap; i++) {
-    HSlot* s = &m->slots[i];
-    if (!s->used) continue;
-    usize j = s->hash & (ncap - 1);
-    while (ns[j].used) j = (j + 1) & (ncap - 1);
-    ns[j] = *s;
-  }
-  free(m->slots);
-  m->slots = ns;
-  m->cap = ncap;
+static void map_free_block(void* key, void* udata) {
+  (void)udata;
+  free((u8*)key - sizeof(u64));
 }
-API_EXPORT void map_init(MapStrU64* m) { m->slots = NULL; m->cap = 0; m->len = 0; }
+API_EXPORT void map_init(MapStrU64* m) { m->tab = NULL; m->len = 0; }
 API_EXPORT void map_free(MapStrU64* m) {
-  if (m->slots) {
-    for (usize i = 0; i < m->cap; i++) if (m->slots[i].used) free(m->slots[i].key);
-    free(m->slots);
-  }
-  m->slots = NULL; m->cap = 0; m->len = 0;
+  vt_table_delete(m->tab);
+  m->tab = NULL; m->len = 0;
 }
 API_EXPORT void map_put(MapStrU64* m, const char* key, u64 val) {
-  if (m->cap == 0) { m->cap = 16; m->slots = (HSlot*)calloc(m->cap, sizeof(HSlot)); }
-  if ((m->len * 10) / m->cap >= 7) map_rehash(m, m->cap * 2);
-  u64 h = hash_str(key);
-  usize i = h & (m->cap - 1);
-  for (;;) {
-    HSlot* s = &m->slots[i];
-    if (!s->used) {
-      s->used = true; s->hash = h; s->key = xstrdup(key); s->val = val; m->len++; return;
+  if (!m->tab) {
+    vt_table_config c = {0};
+    c.backend = VT_TABLE_SWISS;
+    c.free_key = map_free_block;
+    c.free_key_always = 1; /* clés adoptées */
+    m->tab = vt_table_new(&c);
+    if (!m->tab) {
+      fprintf(stderr, "OOM-map\n");
+      abort();
     }
-    if (s->hash == h && strcmp(s->key, key) == 0) { s->val = val; return; }
-    i = (i + 1) & (m->cap - 1);
   }
+  usize n = strlen(key);
+  void* v;
+  if (vt_table_get(m->tab, key, n, &v)) { *(u64*)v = val; return; }
+  u8* b = (u8*)xmalloc(sizeof(u64) + n + 1);
+  *(u64*)b = val;
+  memcpy(b + sizeof(u64), key, n + 1);
+  vt_table_put(m->tab, b + sizeof(u64), n, b, NULL);
+  m->len = vt_table_len(m->tab);
 }
 API_EXPORT bool map_get(const MapStrU64* m, const char* key, u64* out) {
-  if (m->cap == 0) return false;
-  u64 h = hash_str(key);
-  usize i = h & (m->cap - 1);
-  for (;;) {
-    const HSlot* s = &m->slots[i];
-    if (!s->used) return false;
-    if (s->hash == h && strcmp(s->key, key) == 0) { if (out) *out = s->val; return true; }
-    i = (i + 1) & (m->cap - 1);
-  }
+  void* v;
+  if (!m->tab || !vt_table_get(m->tab, key, strlen(key), &v)) return false;
+  if (out) *out = *(const u64*)v;
+  return true;
+}
+API_EXPORT void map_foreach(const MapStrU64* m,
+                            void (*fn)(const char* key, u64 val, void* udata),
+                            void* udata) {
+  if (!m->tab) return;
+  vt_table_iter it;
+  vt_table_iter_init(&it);
+  const void* k;
+  size_t kl;
+  void* v;
+  while (vt_table_next(m->tab, &it, &k, &kl, &v))
+    fn((const char*)k, *(const u64*)v, udata);
 }
 
 /* --------------------------------------------------------------------------
@@ -192,17 +192,20 @@ API_EXPORT u64 hash_str(const char* s);
 /* -------------------------------------------------------------------------- */
 /* Hash map string -> u64                                                     */
 /* -------------------------------------------------------------------------- */
-struct HSlot; /* opaque */
+struct vt_table; /* table.h (moteur swiss) */
 typedef struct {
-  struct HSlot* slots;
-  usize         cap;
-  usize         len;
+  struct vt_table* tab;
+  usize            len;
 } MapStrU64;
 
 API_EXPORT void map_init(MapStrU64* m);
 API_EXPORT void map_free(MapStrU64* m);
 API_EXPORT void map_put (MapStrU64* m, const char* key, u64 val);
 API_EXPORT bool map_get (const MapStrU64* m, const char* key, u64* out_val);
+/* Appelle fn(clé, valeur, udata) pour chaque entrée, dans un ordre quelconque. */
+API_EXPORT void map_foreach(const MapStrU64* m,
+                            void (*fn)(const char* key, u64 val, void* udata),
+                            void* udata);
 
 /* -------------------------------------------------------------------------- */
 /* Arena allocator (bump)                                                     */
@@ -1,6 +1,6 @@
 /* ============================================================================
    core/arena.c — Allocateur « bump » C11 ultra complet pour Vitte/Vitl
-   Mono-fichier autonome. Zéro dépendance hors libc.
+   Mono-fichier; buffers mmap (huge pages, NUMA) via vt_page_map de mem.c.
    Plateformes: POSIX (Linux/macOS), Windows.
    ============================================================================
  */
@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "mem.h" /* vt_page_map */
+
 /* --------------------------------------------------------------------------
    Export / visibilité
    -------------------------------------------------------------------------- */
@@ -91,8 +93,16 @@ typedef struct Arena {
   u8*   base;
   usize cap;
   usize off;
+  usize mapped; /* octets mmap (0: malloc) */
 } Arena;
 
+typedef struct ArenaOpts {
+  usize cap;
+  bool  huge_pages;
+  bool  prefault;
+  int   numa_node;
+} ArenaOpts;
+
 /* helpers internes */
 static inline bool is_pow2(usize x){ return x && ((x & (x-1))==0); }
 
@@ -141,25 +151,37 @@ static inline void stats_reset(void){}
 /* --------------------------------------------------------------------------
    Implémentation
    -------------------------------------------------------------------------- */
-API_EXPORT Arena arena_new(usize cap) {
-  Arena a; a.base=NULL; a.cap=0; a.off=0;
-  if (cap == 0) cap = ARENA_DEFAULT_CAP;
-  a.base = (u8*)malloc(cap);
+API_EXPORT Arena arena_new_ex(const ArenaOpts* o) {
+  Arena a; a.base=NULL; a.cap=0; a.off=0; a.mapped=0;
+  usize cap = o && o->cap ? o->cap : ARENA_DEFAULT_CAP;
+  if (o && (o->huge_pages || o->numa_node >= 0)) {
+    usize len = cap; /* mmap (Linux); NULL ailleurs → malloc */
+    a.base = (u8*)vt_page_map(&len, o->huge_pages, o->numa_node, o->prefault);
+    if (a.base) { a.mapped = len; cap = len; }
+  }
+  if (!a.base) a.base = (u8*)malloc(cap);
   if (!a.base) { fprintf(stderr, "arena_new: OOM (%zu)\n", (size_t)cap); return a; }
   a.cap = cap; a.off = 0;
+  if (o && o->prefault && !a.mapped) memset(a.base, 0, a.cap);
 #if ARENA_POISON_RESET
   memset(a.base, ARENA_POISON_VAL, a.cap);
 #endif
   return a;
 }
 
+API_EXPORT Arena arena_new(usize cap) {
+  ArenaOpts o = { cap, false, false, -1 };
+  return arena_new_ex(&o);
+}
+
 API_EXPORT void arena_free(Arena* a) {
   if (!a) return;
 #if ARENA_POISON_FREE
   if (a->base && a->cap) memset(a->base, ARENA_FREE_VAL, a->cap);
 #endif
+  if (a->mapped) vt_page_free(a->base, a->mapped); else
   free(a->base);
-  a->base=NULL; a->cap=0; a->off=0;
+  a->base=NULL; a->cap=0; a->off=0; a->mapped=0;
 }
 
 API_EXPORT void arena_reset(Arena* a) {
@@ -52,10 +52,20 @@ typedef struct Arena {
   u8*   base;
   usize cap;
   usize off;
+  usize mapped; /* octets mmap (0: malloc) */
 } Arena;
 
+/* Options de création (Linux; ignorées ailleurs ou en cas d’échec) */
+typedef struct ArenaOpts {
+  usize cap;        /* 0 → valeur par défaut */
+  bool  huge_pages; /* mmap arrondi à 2 MiB + pages de 2 MiB / THP */
+  bool  prefault;   /* toutes les pages fautées à la création */
+  int   numa_node;  /* ≥0: mbind sur ce nœud; -1 = aucun */
+} ArenaOpts;
+
 /* Création / destruction */
 API_EXPORT Arena arena_new(usize cap);  /* cap==0 → valeur par défaut */
+API_EXPORT Arena arena_new_ex(const ArenaOpts* o); /* cap arrondie au mapping */
 API_EXPORT void  arena_free(Arena* a);
 
 /* Réinitialisation et allocation */
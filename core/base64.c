@@ -0,0 +1,644 @@
+// SPDX-License-Identifier: MIT
+/* ============================================================================
+   core/base64.c — Base64 (RFC 4648, standard et URL) et base16 pour VitteLight
+   - Noyaux AVX2 (Muła & Lemire, « Faster Base64 Encoding and Decoding Using
+     AVX2 Instructions ») et NEON (vld3/vst4 + vqtbl4), choisis à
+     l’exécution; repli scalaire par tables.
+   - Le vectoriel ne traite que des blocs propres: au premier bloc contenant
+     un caractère hors alphabet (padding, espace, erreur), la machine à états
+     scalaire prend le relais puis rend la main au bloc suivant.
+   - Aucune allocation: tout s’écrit dans les tampons de l’appelant.
+   ============================================================================
+*/
+
+#include "base64.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define VT_B64_X86 1
+#endif
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VT_B64_NEON 1
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* Tables                                                                     */
+/* -------------------------------------------------------------------------- */
+static const char vt__b64_std[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char vt__b64_url[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const char vt__b16_lo[] = "0123456789abcdef";
+static const char vt__b16_up[] = "0123456789ABCDEF";
+
+/* Inverses: 0..63 (0..15), 0xFE '=', 0xFD blanc, 0xFF invalide */
+#define VT_B64_PAD 0xFE
+#define VT_B64_WS 0xFD
+static const unsigned char vt__b64_rev_std[256] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xFD, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF,
+  0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+  0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static const unsigned char vt__b64_rev_url[256] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xFD, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF,
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF,
+  0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+  0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+  0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static const unsigned char vt__b16_rev[256] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+/* -------------------------------------------------------------------------- */
+/* Scalaire                                                                   */
+/* -------------------------------------------------------------------------- */
+/* Les noyaux consomment un préfixe fait de blocs entiers et retournent sa
+   longueur: encode par 3 octets, décode par quadruplets valides (arrêt au
+   premier caractère hors alphabet), hex par paires. */
+static size_t vt__b64_enc_scalar(const unsigned char* s, size_t n, char* d, int url) {
+  const char* T = url ? vt__b64_url : vt__b64_std;
+  size_t i = 0;
+  for (; i + 3 <= n; i += 3, d += 4) {
+    uint32_t v = (uint32_t)s[i] << 16 | (uint32_t)s[i + 1] << 8 | s[i + 2];
+    d[0] = T[v >> 18];
+    d[1] = T[(v >> 12) & 63];
+    d[2] = T[(v >> 6) & 63];
+    d[3] = T[v & 63];
+  }
+  return i;
+}
+
+static size_t vt__b64_dec_scalar(const char* s, size_t n, unsigned char* d, int url) {
+  const unsigned char* R = url ? vt__b64_rev_url : vt__b64_rev_std;
+  const unsigned char* p = (const unsigned char*)s;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4, d += 3) {
+    unsigned a = R[p[i]], b = R[p[i + 1]], c = R[p[i + 2]], e = R[p[i + 3]];
+    if ((a | b | c | e) > 63) break;
+    uint32_t v = a << 18 | b << 12 | c << 6 | e;
+    d[0] = (unsigned char)(v >> 16);
+    d[1] = (unsigned char)(v >> 8);
+    d[2] = (unsigned char)v;
+  }
+  return i;
+}
+
+static size_t vt__b16_enc_scalar(const unsigned char* s, size_t n, char* d, int upper) {
+  const char* H = upper ? vt__b16_up : vt__b16_lo;
+  for (size_t i = 0; i < n; i++) {
+    d[2 * i] = H[s[i] >> 4];
+    d[2 * i + 1] = H[s[i] & 15];
+  }
+  return n;
+}
+
+static size_t vt__b16_dec_scalar(const char* s, size_t n, unsigned char* d) {
+  const unsigned char* p = (const unsigned char*)s;
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    unsigned h = vt__b16_rev[p[i]], l = vt__b16_rev[p[i + 1]];
+    if ((h | l) > 15) break;
+    *d++ = (unsigned char)(h << 4 | l);
+  }
+  return i;
+}
+
+#if defined(VT_B64_X86)
+/* -------------------------------------------------------------------------- */
+/* AVX2                                                                       */
+/* -------------------------------------------------------------------------- */
+/* 24 octets → 32 caractères; lit 28 octets. */
+__attribute__((target("avx2")))
+static size_t vt__b64_enc_avx2(const unsigned char* s, size_t n, char* d, int url) {
+  const __m256i shuf = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  /* décalage vers l’ASCII selon la classe de l’indice (A-Z, a-z, 0-9, 62, 63) */
+  const char c62 = url ? '-' - 62 : '+' - 62, c63 = url ? '_' - 63 : '/' - 63;
+  const __m256i lut = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, c62, c63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, c62, c63, 'A', 0, 0);
+  size_t i = 0;
+  for (; i + 28 <= n; i += 24, d += 32) {
+    __m256i in = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(s + i))),
+        _mm_loadu_si128((const __m128i*)(s + i + 12)), 1);
+    in = _mm256_shuffle_epi8(in, shuf);
+    __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                                     _mm256_set1_epi32(0x04000040));
+    __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                                     _mm256_set1_epi32(0x01000010));
+    __m256i idx = _mm256_or_si256(t0, t1);
+    __m256i r = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+    r = _mm256_or_si256(r, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx),
+                                            _mm256_set1_epi8(13)));
+    r = _mm256_add_epi8(_mm256_shuffle_epi8(lut, r), idx);
+    _mm256_storeu_si256((__m256i*)d, r);
+  }
+  return i;
+}
+
+/* 32 caractères → 24 octets; un bloc hors alphabet arrête le noyau. */
+__attribute__((target("avx2")))
+static size_t vt__b64_dec_avx2(const char* s, size_t n, unsigned char* d, int url) {
+  const __m256i lut_lo = url
+      ? _mm256_setr_epi8(0x25, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x23, 0x3B, 0x3B, 0x3A, 0x3B, 0x33,
+                         0x25, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x23, 0x3B, 0x3B, 0x3A, 0x3B, 0x33)
+      : _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                         0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const __m256i lut_hi = url
+      ? _mm256_setr_epi8(0x20, 0x20, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+                         0x20, 0x20, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20)
+      : _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                         0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  /* décalage par quartet haut; 62/63 partagent le quartet d’une autre classe
+     et sont déplacés vers une case libre (std: '/' → 1, url: '_' → 13) */
+  const __m256i lut_roll = url
+      ? _mm256_setr_epi8(0, 0, 17, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, -32, 0, 0,
+                         0, 0, 17, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, -32, 0, 0)
+      : _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                         0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i special = _mm256_set1_epi8(url ? '_' : '/');
+  const __m256i delta = _mm256_set1_epi8(url ? 8 : -1);
+  const __m256i m0f = _mm256_set1_epi8(0x0F);
+  const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32, d += 24) {
+    __m256i in = _mm256_loadu_si256((const __m256i*)(s + i));
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi32(in, 4), m0f);
+    __m256i lo = _mm256_and_si256(in, m0f);
+    if (!_mm256_testz_si256(_mm256_shuffle_epi8(lut_lo, lo), _mm256_shuffle_epi8(lut_hi, hi))) break;
+    __m256i ridx = _mm256_add_epi8(hi, _mm256_and_si256(_mm256_cmpeq_epi8(in, special), delta));
+    __m256i v = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut_roll, ridx));
+    v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+    v = _mm256_shuffle_epi8(v, pack);
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+    _mm_storeu_si128((__m128i*)d, _mm256_castsi256_si128(v));
+    _mm_storel_epi64((__m128i*)(d + 16), _mm256_extracti128_si256(v, 1));
+  }
+  return i;
+}
+
+/* 32 octets → 64 caractères */
+__attribute__((target("avx2")))
+static size_t vt__b16_enc_avx2(const unsigned char* s, size_t n, char* d, int upper) {
+  const __m256i lut = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128((const __m128i*)(upper ? vt__b16_up : vt__b16_lo)));
+  const __m256i m0f = _mm256_set1_epi8(0x0F);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32, d += 64) {
+    __m256i in = _mm256_loadu_si256((const __m256i*)(s + i));
+    __m256i h = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), m0f));
+    __m256i l = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, m0f));
+    __m256i a = _mm256_unpacklo_epi8(h, l), b = _mm256_unpackhi_epi8(h, l);
+    _mm256_storeu_si256((__m256i*)d, _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256((__m256i*)(d + 32), _mm256_permute2x128_si256(a, b, 0x31));
+  }
+  return i;
+}
+
+/* Valeur des chiffres hex, ou mauvais masque si un caractère ne l’est pas */
+__attribute__((target("avx2")))
+static inline __m256i vt__b16_val_avx2(__m256i c, __m256i* ok) {
+  __m256i dg = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+  __m256i isd = _mm256_cmpeq_epi8(_mm256_min_epu8(dg, _mm256_set1_epi8(9)), dg);
+  __m256i lt = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+  __m256i isl = _mm256_cmpeq_epi8(_mm256_min_epu8(lt, _mm256_set1_epi8(5)), lt);
+  *ok = _mm256_and_si256(*ok, _mm256_or_si256(isd, isl));
+  return _mm256_blendv_epi8(_mm256_add_epi8(lt, _mm256_set1_epi8(10)), dg, isd);
+}
+
+/* 64 caractères → 32 octets */
+__attribute__((target("avx2")))
+static size_t vt__b16_dec_avx2(const char* s, size_t n, unsigned char* d) {
+  const __m256i w = _mm256_set1_epi16(0x0110);
+  size_t i = 0;
+  for (; i + 64 <= n; i += 64, d += 32) {
+    __m256i ok = _mm256_set1_epi8(-1);
+    __m256i a = vt__b16_val_avx2(_mm256_loadu_si256((const __m256i*)(s + i)), &ok);
+    __m256i b = vt__b16_val_avx2(_mm256_loadu_si256((const __m256i*)(s + i + 32)), &ok);
+    if (_mm256_movemask_epi8(ok) != -1) break;
+    __m256i r = _mm256_packus_epi16(_mm256_maddubs_epi16(a, w), _mm256_maddubs_epi16(b, w));
+    _mm256_storeu_si256((__m256i*)d, _mm256_permute4x64_epi64(r, 0xD8));
+  }
+  return i;
+}
+#endif /* VT_B64_X86 */
+
+#if defined(VT_B64_NEON)
+/* -------------------------------------------------------------------------- */
+/* NEON                                                                       */
+/* -------------------------------------------------------------------------- */
+/* 48 octets → 64 caractères (désentrelacement par vld3, vst4) */
+static size_t vt__b64_enc_neon(const unsigned char* s, size_t n, char* d, int url) {
+  const char* T = url ? vt__b64_url : vt__b64_std;
+  uint8x16x4_t lut = {{vld1q_u8((const uint8_t*)T), vld1q_u8((const uint8_t*)T + 16),
+                       vld1q_u8((const uint8_t*)T + 32), vld1q_u8((const uint8_t*)T + 48)}};
+  const uint8x16_t m3f = vdupq_n_u8(0x3F);
+  size_t i = 0;
+  for (; i + 48 <= n; i += 48, d += 64) {
+    uint8x16x3_t in = vld3q_u8(s + i);
+    uint8x16x4_t o;
+    o.val[0] = vshrq_n_u8(in.val[0], 2);
+    o.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), m3f);
+    o.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), m3f);
+    o.val[3] = vandq_u8(in.val[2], m3f);
+    for (int k = 0; k < 4; k++) o.val[k] = vqtbl4q_u8(lut, o.val[k]);
+    vst4q_u8((uint8_t*)d, o);
+  }
+  return i;
+}
+
+/* 64 caractères → 48 octets: deux tables de 64 (codes 0..127), 0xFF hors
+   alphabet; un code ≥ 128 sort des deux tables et vaut 0, d’où le test à part. */
+static size_t vt__b64_dec_neon(const char* s, size_t n, unsigned char* d, int url) {
+  const unsigned char* R = url ? vt__b64_rev_url : vt__b64_rev_std;
+  uint8x16x4_t t0 = {{vld1q_u8(R), vld1q_u8(R + 16), vld1q_u8(R + 32), vld1q_u8(R + 48)}};
+  uint8x16x4_t t1 = {{vld1q_u8(R + 64), vld1q_u8(R + 80), vld1q_u8(R + 96), vld1q_u8(R + 112)}};
+  const uint8x16_t k64 = vdupq_n_u8(64);
+  size_t i = 0;
+  for (; i + 64 <= n; i += 64, d += 48) {
+    uint8x16x4_t in = vld4q_u8((const uint8_t*)s + i);
+    uint8x16_t bad = vdupq_n_u8(0);
+    for (int k = 0; k < 4; k++) {
+      uint8x16_t c = in.val[k];
+      uint8x16_t v = vqtbx4q_u8(vqtbl4q_u8(t0, c), t1, vsubq_u8(c, k64));
+      bad = vorrq_u8(bad, vorrq_u8(v, vandq_u8(c, vdupq_n_u8(0x80))));
+      in.val[k] = v;
+    }
+    if (vmaxvq_u8(bad) > 63) break;
+    uint8x16x3_t o;
+    o.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+    o.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+    o.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+    vst3q_u8(d, o);
+  }
+  return i;
+}
+
+static size_t vt__b16_enc_neon(const unsigned char* s, size_t n, char* d, int upper) {
+  const uint8x16_t lut = vld1q_u8((const uint8_t*)(upper ? vt__b16_up : vt__b16_lo));
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16, d += 32) {
+    uint8x16_t in = vld1q_u8(s + i);
+    uint8x16x2_t o = {{vqtbl1q_u8(lut, vshrq_n_u8(in, 4)), vqtbl1q_u8(lut, vandq_u8(in, vdupq_n_u8(15)))}};
+    vst2q_u8((uint8_t*)d, o);
+  }
+  return i;
+}
+
+static inline uint8x16_t vt__b16_val_neon(uint8x16_t c, uint8x16_t* ok) {
+  uint8x16_t dg = vsubq_u8(c, vdupq_n_u8('0'));
+  uint8x16_t lt = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  uint8x16_t isd = vcleq_u8(dg, vdupq_n_u8(9));
+  *ok = vandq_u8(*ok, vorrq_u8(isd, vcleq_u8(lt, vdupq_n_u8(5))));
+  return vbslq_u8(isd, dg, vaddq_u8(lt, vdupq_n_u8(10)));
+}
+
+static size_t vt__b16_dec_neon(const char* s, size_t n, unsigned char* d) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32, d += 16) {
+    uint8x16x2_t in = vld2q_u8((const uint8_t*)s + i);
+    uint8x16_t ok = vdupq_n_u8(0xFF);
+    uint8x16_t h = vt__b16_val_neon(in.val[0], &ok), l = vt__b16_val_neon(in.val[1], &ok);
+    if (vminvq_u8(ok) != 0xFF) break;
+    vst1q_u8(d, vorrq_u8(vshlq_n_u8(h, 4), l));
+  }
+  return i;
+}
+#endif /* VT_B64_NEON */
+
+/* -------------------------------------------------------------------------- */
+/* Sélection                                                                  */
+/* -------------------------------------------------------------------------- */
+typedef struct {
+  size_t (*enc)(const unsigned char* s, size_t n, char* d, int url);
+  size_t (*dec)(const char* s, size_t n, unsigned char* d, int url);
+  size_t (*hexenc)(const unsigned char* s, size_t n, char* d, int upper);
+  size_t (*hexdec)(const char* s, size_t n, unsigned char* d);
+  const char* name;
+} vt__b64impl;
+
+static const vt__b64impl vt__b64impls[] = {
+  {NULL, NULL, NULL, NULL, "auto"},
+  {vt__b64_enc_scalar, vt__b64_dec_scalar, vt__b16_enc_scalar, vt__b16_dec_scalar, "scalar"},
+#if defined(VT_B64_X86)
+  {vt__b64_enc_avx2, vt__b64_dec_avx2, vt__b16_enc_avx2, vt__b16_dec_avx2, "avx2"},
+#else
+  {NULL, NULL, NULL, NULL, "avx2"},
+#endif
+#if defined(VT_B64_NEON)
+  {vt__b64_enc_neon, vt__b64_dec_neon, vt__b16_enc_neon, vt__b16_dec_neon, "neon"},
+#else
+  {NULL, NULL, NULL, NULL, "neon"},
+#endif
+};
+static _Atomic(const vt__b64impl*) vt__b64_cur;
+
+static int vt__b64_impl_ok(vt_b64_impl i) {
+  if (i <= VT_B64_IMPL_AUTO || i > VT_B64_IMPL_NEON || !vt__b64impls[i].enc) return 0;
+#if defined(VT_B64_X86)
+  if (i == VT_B64_IMPL_AVX2) return __builtin_cpu_supports("avx2");
+#endif
+  return 1;
+}
+
+int vt_b64_set_impl(vt_b64_impl impl) {
+  if (impl == VT_B64_IMPL_AUTO) {
+    static const vt_b64_impl pref[] = {VT_B64_IMPL_AVX2, VT_B64_IMPL_NEON, VT_B64_IMPL_SCALAR};
+    for (size_t i = 0;; i++)
+      if (vt__b64_impl_ok(pref[i])) { impl = pref[i]; break; }
+  } else if (!vt__b64_impl_ok(impl)) {
+    return -ENOTSUP;
+  }
+  atomic_store_explicit(&vt__b64_cur, &vt__b64impls[impl], memory_order_relaxed);
+  return 0;
+}
+
+static const vt__b64impl* vt__b64_get(void) {
+  const vt__b64impl* b = atomic_load_explicit(&vt__b64_cur, memory_order_relaxed);
+  if (b) return b;
+  vt_b64_set_impl(VT_B64_IMPL_AUTO);
+  return atomic_load_explicit(&vt__b64_cur, memory_order_relaxed);
+}
+
+const char* vt_b64_impl_name(void) { return vt__b64_get()->name; }
+
+/* -------------------------------------------------------------------------- */
+/* Base64 en flux                                                             */
+/* -------------------------------------------------------------------------- */
+void vt_b64_init(vt_b64_state* st, int flags) {
+  memset(st, 0, sizeof *st);
+  st->flags = flags;
+}
+
+size_t vt_b64_encode_update(vt_b64_state* st, const void* src, size_t n, char* dst) {
+  const unsigned char* s = (const unsigned char*)src;
+  const int url = st->flags & VT_B64_URL;
+  size_t i = 0, o = 0;
+  if (st->nq) {
+    while (st->nq < 3 && i < n) { st->acc = st->acc << 8 | s[i++]; st->nq++; }
+    if (st->nq < 3) return 0;
+    unsigned char t[3] = {(unsigned char)(st->acc >> 16), (unsigned char)(st->acc >> 8),
+                          (unsigned char)st->acc};
+    o += vt__b64_enc_scalar(t, 3, dst, url) / 3 * 4;
+    st->nq = 0; st->acc = 0;
+  }
+  size_t bulk = (n - i) / 3 * 3;
+  size_t k = vt__b64_get()->enc(s + i, bulk, dst + o, url);
+  k += vt__b64_enc_scalar(s + i + k, bulk - k, dst + o + k / 3 * 4, url);
+  i += k; o += k / 3 * 4;
+  for (; i < n; i++) { st->acc = st->acc << 8 | s[i]; st->nq++; }
+  return o;
+}
+
+size_t vt_b64_encode_final(vt_b64_state* st, char* dst) {
+  const char* T = (st->flags & VT_B64_URL) ? vt__b64_url : vt__b64_std;
+  size_t o = 0;
+  if (st->nq) {
+    uint32_t v = st->acc << (st->nq == 1 ? 16 : 8);
+    dst[o++] = T[v >> 18];
+    dst[o++] = T[(v >> 12) & 63];
+    if (st->nq == 2) dst[o++] = T[(v >> 6) & 63];
+    if (!(st->flags & VT_B64_NOPAD))
+      while (o < 4) dst[o++] = '=';
+  }
+  st->nq = 0; st->acc = 0;
+  return o;
+}
+
+int vt_b64_decode_update(vt_b64_state* st, const char* src, size_t n, void* dst, size_t* written) {
+  const unsigned char* R = (st->flags & VT_B64_URL) ? vt__b64_rev_url : vt__b64_rev_std;
+  const int url = st->flags & VT_B64_URL;
+  const vt__b64impl* impl = vt__b64_get();
+  unsigned char* d = (unsigned char*)dst;
+  size_t i = 0, o = 0;
+  int rc = 0;
+  while (i < n) {
+    if (st->nq == 0 && st->pad == 0) {
+      size_t k = impl->dec(src + i, n - i, d + o, url);
+      k += vt__b64_dec_scalar(src + i + k, n - i - k, d + o + k / 4 * 3, url);
+      i += k; o += k / 4 * 3;
+      if (i >= n) break;
+    }
+    unsigned v = R[(unsigned char)src[i++]];
+    if (v < 64) {
+      if (st->pad) { rc = -EINVAL; break; }
+      st->acc = st->acc << 6 | v;
+      if (++st->nq == 4) {
+        d[o++] = (unsigned char)(st->acc >> 16);
+        d[o++] = (unsigned char)(st->acc >> 8);
+        d[o++] = (unsigned char)st->acc;
+        st->nq = 0; st->acc = 0;
+      }
+    } else if (v == VT_B64_PAD) {
+      if (st->pad == 0 && st->nq == 2) {
+        d[o++] = (unsigned char)(st->acc >> 4);
+        st->pad = 1;
+      } else if (st->pad == 0 && st->nq == 3) {
+        d[o++] = (unsigned char)(st->acc >> 10);
+        d[o++] = (unsigned char)(st->acc >> 2);
+        st->pad = 2;
+      } else if (st->pad == 1) {
+        st->pad = 2;
+      } else {
+        rc = -EINVAL; break;
+      }
+      st->nq = 0; st->acc = 0;
+    } else if (!(v == VT_B64_WS && (st->flags & VT_B64_SPACE))) {
+      rc = -EINVAL; break;
+    }
+  }
+  if (written) *written = o;
+  return rc;
+}
+
+int vt_b64_decode_final(vt_b64_state* st, void* dst, size_t* written) {
+  unsigned char* d = (unsigned char*)dst;
+  size_t o = 0;
+  int rc = 0;
+  if (st->pad == 1 || st->nq == 1) {
+    rc = -EINVAL;
+  } else if (st->nq) {
+    if (!(st->flags & VT_B64_NOPAD)) {
+      rc = -EINVAL;
+    } else if (st->nq == 2) {
+      d[o++] = (unsigned char)(st->acc >> 4);
+    } else {
+      d[o++] = (unsigned char)(st->acc >> 10);
+      d[o++] = (unsigned char)(st->acc >> 2);
+    }
+  }
+  if (written) *written = o;
+  vt_b64_init(st, st->flags);
+  return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Base64 one-shot                                                            */
+/* -------------------------------------------------------------------------- */
+size_t vt_b64_encode(const void* src, size_t n, char* dst, int flags) {
+  vt_b64_state st;
+  vt_b64_init(&st, flags);
+  size_t o = vt_b64_encode_update(&st, src, n, dst);
+  return o + vt_b64_encode_final(&st, dst + o);
+}
+
+int vt_b64_decode(const char* src, size_t n, void* dst, size_t* outlen, int flags) {
+  vt_b64_state st;
+  size_t a = 0, b = 0;
+  vt_b64_init(&st, flags);
+  int rc = vt_b64_decode_update(&st, src, n, dst, &a);
+  if (rc == 0) rc = vt_b64_decode_final(&st, (unsigned char*)dst + a, &b);
+  if (outlen) *outlen = a + b;
+  return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Base16                                                                     */
+/* -------------------------------------------------------------------------- */
+size_t vt_b16_encode(const void* src, size_t n, char* dst, int flags) {
+  const unsigned char* s = (const unsigned char*)src;
+  const int up = (flags & VT_B16_UPPER) != 0;
+  size_t k = vt__b64_get()->hexenc(s, n, dst, up);
+  vt__b16_enc_scalar(s + k, n - k, dst + 2 * k, up);
+  return 2 * n;
+}
+
+int vt_b16_decode_update(vt_b64_state* st, const char* src, size_t n, void* dst, size_t* written) {
+  unsigned char* d = (unsigned char*)dst;
+  size_t i = 0, o = 0;
+  int rc = 0;
+  if (st->nq && n) {
+    unsigned l = vt__b16_rev[(unsigned char)src[i++]];
+    if (l > 15) { rc = -EINVAL; goto out; }
+    d[o++] = (unsigned char)(st->acc << 4 | l);
+    st->nq = 0;
+  }
+  {
+    size_t k = vt__b64_get()->hexdec(src + i, n - i, d + o);
+    k += vt__b16_dec_scalar(src + i + k, n - i - k, d + o + k / 2);
+    i += k; o += k / 2;
+  }
+  if (i + 1 < n) { rc = -EINVAL; goto out; }
+  if (i < n) {
+    unsigned h = vt__b16_rev[(unsigned char)src[i]];
+    if (h > 15) { rc = -EINVAL; goto out; }
+    st->acc = h; st->nq = 1;
+  }
+out:
+  if (written) *written = o;
+  return rc;
+}
+
+int vt_b16_decode_final(vt_b64_state* st) {
+  int rc = st->nq ? -EINVAL : 0;
+  vt_b64_init(st, st->flags);
+  return rc;
+}
+
+int vt_b16_decode(const char* src, size_t n, void* dst, size_t* outlen) {
+  if (outlen) *outlen = 0;
+  if (n & 1) return -EINVAL;
+  vt_b64_state st;
+  vt_b64_init(&st, 0);
+  return vt_b16_decode_update(&st, src, n, dst, outlen);
+}
+
+#ifdef VT_B64_BENCH
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double vt__b64_now(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+  static const vt_b64_impl impls[] = {VT_B64_IMPL_SCALAR, VT_B64_IMPL_AVX2, VT_B64_IMPL_NEON};
+  size_t n = (size_t)1 << 20;
+  unsigned char* src = (unsigned char*)malloc(n);
+  unsigned char* back = (unsigned char*)malloc(n);
+  char* txt = (char*)malloc(VT_B64_ENC_LEN(n) + 2 * n);
+  if (!src || !back || !txt) return 1;
+  uint64_t x = 0x9E3779B97F4A7C15ull;
+  for (size_t i = 0; i < n; i++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    src[i] = (unsigned char)x;
+  }
+  vt_b64_set_impl(VT_B64_IMPL_AUTO);
+  printf("base64/hex (auto: %s), Go/s côté binaire\n", vt_b64_impl_name());
+  for (size_t k = 0; k < sizeof impls / sizeof impls[0]; k++) {
+    if (vt_b64_set_impl(impls[k]) != 0) continue;
+    const int reps = 100;
+    size_t m = 0, got = 0;
+    double t0 = vt__b64_now();
+    for (int r = 0; r < reps; r++) m = vt_b64_encode(src, n, txt, 0);
+    double e64 = (double)n * reps / (vt__b64_now() - t0) / 1e9;
+    t0 = vt__b64_now();
+    for (int r = 0; r < reps; r++) vt_b64_decode(txt, m, back, &got, 0);
+    double d64 = (double)n * reps / (vt__b64_now() - t0) / 1e9;
+    if (got != n || memcmp(src, back, n) != 0) { printf("%s: base64 faux\n", vt_b64_impl_name()); return 1; }
+    t0 = vt__b64_now();
+    for (int r = 0; r < reps; r++) m = vt_b16_encode(src, n, txt, 0);
+    double e16 = (double)n * reps / (vt__b64_now() - t0) / 1e9;
+    t0 = vt__b64_now();
+    for (int r = 0; r < reps; r++) vt_b16_decode(txt, m, back, &got);
+    double d16 = (double)n * reps / (vt__b64_now() - t0) / 1e9;
+    if (got != n || memcmp(src, back, n) != 0) { printf("%s: hex faux\n", vt_b64_impl_name()); return 1; }
+    printf("  %-7s b64 enc %6.2f  dec %6.2f   hex enc %6.2f  dec %6.2f\n", vt_b64_impl_name(), e64,
+           d64, e16, d16);
+  }
+  free(src); free(back); free(txt);
+  return 0;
+}
+#endif /* VT_B64_BENCH */
@@ -0,0 +1,99 @@
+/* ============================================================================
+   base64.h — Base64 (RFC 4648, standard et URL) et base16/hex (C17, MIT)
+   - Encodage/décodage dans des tampons fournis par l’appelant, sans malloc
+   - One-shot ou en flux (update/final), AVX2/NEON choisi à l’exécution,
+     repli scalaire; même résultat partout
+   Lier avec base64.c
+   ============================================================================
+*/
+#ifndef VT_BASE64_H
+#define VT_BASE64_H
+#pragma once
+
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VT_BASE64_API
+#define VT_BASE64_API extern
+#endif
+
+/* Options (OU binaire) */
+enum {
+  VT_B64_URL = 1 << 0,   /* alphabet « -_ » au lieu de « +/ » */
+  VT_B64_NOPAD = 1 << 1, /* encode sans '=', décode avec ou sans */
+  VT_B64_SPACE = 1 << 2, /* décode: ignore espaces, \t, \r, \n */
+  VT_B16_UPPER = 1 << 3  /* hex: A-F au lieu de a-f */
+};
+
+/* Tailles de tampon: sortie de l’encodage (exacte avec padding), et borne
+   de la sortie du décodage d’un bloc de n caractères (flux compris). */
+#define VT_B64_ENC_LEN(n) ((((n) + 2) / 3) * 4)
+#define VT_B64_DEC_MAX(n) ((((n) + 3) / 4) * 3)
+
+/* ----------------------------------------------------------------------------
+   Base64 one-shot
+---------------------------------------------------------------------------- */
+/* Écrit VT_B64_ENC_LEN(n) caractères au plus (pas de NUL); retourne le
+   nombre écrit. */
+VT_BASE64_API size_t vt_b64_encode(const void* src, size_t n, char* dst, int flags);
+/* dst: VT_B64_DEC_MAX(n) octets. 0, ou -EINVAL (caractère hors alphabet,
+   padding mal placé, longueur impossible); *outlen = octets écrits. */
+VT_BASE64_API int vt_b64_decode(const char* src, size_t n, void* dst, size_t* outlen,
+                                int flags);
+
+/* ----------------------------------------------------------------------------
+   Base64 en flux
+---------------------------------------------------------------------------- */
+typedef struct {
+  int flags;
+  int nq;        /* octets (encode) ou sextets (décode) en attente */
+  int pad;       /* décode: 0 rien, 1 un '=' attendu, 2 fini */
+  uint32_t acc;
+} vt_b64_state;
+
+VT_BASE64_API void vt_b64_init(vt_b64_state* st, int flags);
+/* update: dst reçoit au plus VT_B64_ENC_LEN(n) caractères; final: 4. */
+VT_BASE64_API size_t vt_b64_encode_update(vt_b64_state* st, const void* src, size_t n,
+                                          char* dst);
+VT_BASE64_API size_t vt_b64_encode_final(vt_b64_state* st, char* dst);
+/* update: dst reçoit au plus VT_B64_DEC_MAX(n) octets; final: 2.
+   *written = octets écrits; -EINVAL au premier caractère fautif. */
+VT_BASE64_API int vt_b64_decode_update(vt_b64_state* st, const char* src, size_t n,
+                                       void* dst, size_t* written);
+VT_BASE64_API int vt_b64_decode_final(vt_b64_state* st, void* dst, size_t* written);
+
+/* ----------------------------------------------------------------------------
+   Base16 (hex)
+---------------------------------------------------------------------------- */
+/* Écrit 2n caractères (pas de NUL); retourne 2n. */
+VT_BASE64_API size_t vt_b16_encode(const void* src, size_t n, char* dst, int flags);
+/* Majuscules et minuscules acceptées; dst: n/2 octets. 0, ou -EINVAL
+   (longueur impaire, caractère non hex). */
+VT_BASE64_API int vt_b16_decode(const char* src, size_t n, void* dst, size_t* outlen);
+/* En flux: un demi-octet peut rester en attente entre deux appels.
+   update: dst reçoit au plus (n + 1) / 2 octets. */
+VT_BASE64_API int vt_b16_decode_update(vt_b64_state* st, const char* src, size_t n,
+                                       void* dst, size_t* written);
+VT_BASE64_API int vt_b16_decode_final(vt_b64_state* st);
+
+/* ----------------------------------------------------------------------------
+   Noyaux: AUTO = AVX2 > NEON > scalaire; -ENOTSUP si indisponible.
+---------------------------------------------------------------------------- */
+typedef enum {
+  VT_B64_IMPL_AUTO = 0,
+  VT_B64_IMPL_SCALAR,
+  VT_B64_IMPL_AVX2,
+  VT_B64_IMPL_NEON
+} vt_b64_impl;
+VT_BASE64_API int vt_b64_set_impl(vt_b64_impl impl);
+VT_BASE64_API const char* vt_b64_impl_name(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* VT_BASE64_H */
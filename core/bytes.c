@@ -2,7 +2,7 @@
 /* ============================================================================
    core/bytes.c — Utilitaires C11 « ultra complets » pour buffers binaires
    API prévue par core/bytes.h (lecture/écriture, varints, endian, hex, b64).
-   Dépendances : libc uniquement.
+   Dépendances : libc, base64.c (hex, base64).
    ============================================================================
  */
 
@@ -15,6 +15,7 @@
 #endif
 
 #include "bytes.h"
+#include "base64.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -305,37 +306,17 @@ API_EXPORT bool br_r_str(ByteRO* r, const char** s, usize* n){
 /* -------------------------------------------------------------------------- */
 /* Hex encode/decode + hexdump                                                */
 /* -------------------------------------------------------------------------- */
-static const char HEXU[] = "0123456789ABCDEF";
-static const char HEXL[] = "0123456789abcdef";
-
 API_EXPORT void hex_encode(const void* data, usize n, bool upper, ByteBuf* out){
-  const u8* p = (const u8*)data;
   bb_reserve(out, out->len + n*2);
-  const char* ALPH = upper ? HEXU : HEXL;
-  for (usize i=0;i<n;i++){
-    u8 v = p[i];
-    u8 h = (u8)(v>>4), l = (u8)(v & 0xF);
-    bb_w_u8(out, (u8)ALPH[h]);
-    bb_w_u8(out, (u8)ALPH[l]);
-  }
+  out->len += vt_b16_encode(data, n, (char*)out->data + out->len, upper ? VT_B16_UPPER : 0);
 }
 
-static inline int hex_val(int c){
-  if (c>='0' && c<='9') return c-'0';
-  if (c>='a' && c<='f') return c-'a'+10;
-  if (c>='A' && c<='F') return c-'A'+10;
-  return -1;
-}
+/* Rien n’est ajouté à out si l’entrée est invalide */
 API_EXPORT bool hex_decode(const char* s, usize n, ByteBuf* out){
-  if ((n & 1u) != 0) return false;
+  size_t got = 0;
   bb_reserve(out, out->len + n/2);
-  for (usize i=0;i<n;i+=2){
-    int hi = hex_val((unsigned char)s[i]);
-    int lo = hex_val((unsigned char)s[i+1]);
-    if (hi < 0 || lo < 0) return false;
-    u8 v = (u8)((hi<<4) | lo);
-    bb_w_u8(out, v);
-  }
+  if (vt_b16_decode(s, n, out->data + out->len, &got) != 0) return false;
+  out->len += got;
   return true;
 }
 
@@ -361,64 +342,17 @@ API_EXPORT void hexdump(FILE* fp, const void* data, usize n, usize base_addr){
 /* -------------------------------------------------------------------------- */
 /* Base64 (RFC 4648, sans sauts de ligne)                                     */
 /* -------------------------------------------------------------------------- */
-static const char B64TAB[] =
-  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-static inline u8 b64_val(int c){
-  if (c>='A'&&c<='Z') return (u8)(c-'A');
-  if (c>='a'&&c<='z') return (u8)(c-'a'+26);
-  if (c>='0'&&c<='9') return (u8)(c-'0'+52);
-  if (c=='+') return 62;
-  if (c=='/') return 63;
-  return 0xFFu;
-}
-
 API_EXPORT void b64_encode(const void* data, usize n, ByteBuf* out){
-  const u8* s = (const u8*)data;
-  usize q = n/3, r = n%3;
-  bb_reserve(out, out->len + 4*((n+2)/3));
-  for (usize i=0;i<q;i++){
-    u32 v = (u32)(s[3*i]<<16 | s[3*i+1]<<8 | s[3*i+2]);
-    bb_w_u8(out, (u8)B64TAB[(v>>18)&63]);
-    bb_w_u8(out, (u8)B64TAB[(v>>12)&63]);
-    bb_w_u8(out, (u8)B64TAB[(v>>6 )&63]);
-    bb_w_u8(out, (u8)B64TAB[(v    )&63]);
-  }
-  if (r){
-    u32 v = (u32)(s[3*q]<<16);
-    if (r==2) v |= (u32)(s[3*q+1]<<8);
-    bb_w_u8(out, (u8)B64TAB[(v>>18)&63]);
-    bb_w_u8(out, (u8)B64TAB[(v>>12)&63]);
-    if (r==2){
-      bb_w_u8(out, (u8)B64TAB[(v>>6)&63]);
-      bb_w_u8(out, '=');
-    } else {
-      bb_w_u8(out, '=');
-      bb_w_u8(out, '=');
-    }
-  }
+  bb_reserve(out, out->len + VT_B64_ENC_LEN(n));
+  out->len += vt_b64_encode(data, n, (char*)out->data + out->len, 0);
 }
 
+/* Padding obligatoire; rien n’est ajouté à out si l’entrée est invalide */
 API_EXPORT bool b64_decode(const char* s, usize n, ByteBuf* out){
-  if (n==0) return true;
-  if (n%4 != 0) return false;
-  /* worst-case size */
-  bb_reserve(out, out->len + (n/4)*3);
-  for (usize i=0;i<n;i+=4){
-    u8 a=b64_val(s[i]), b=b64_val(s[i+1]);
-    if (a==0xFFu || b==0xFFu) return false;
-    u8 c = (s[i+2]=='=')? 0xFEu : b64_val(s[i+2]);
-    u8 d = (s[i+3]=='=')? 0xFEu : b64_val(s[i+3]);
-    if ((c==0xFFu)||(d==0xFFu)) return false;
-
-    u32 v = ((u32)a<<18) | ((u32)b<<12) |
-            ((c<=63? (u32)c : 0)<<6) |
-            ((d<=63? (u32)d : 0));
-
-    bb_w_u8(out, (u8)((v>>16)&0xFF));
-    if (c != 0xFEu) bb_w_u8(out, (u8)((v>>8)&0xFF));
-    if (d != 0xFEu) bb_w_u8(out, (u8)(v&0xFF));
-  }
+  size_t got = 0;
+  bb_reserve(out, out->len + VT_B64_DEC_MAX(n));
+  if (vt_b64_decode(s, n, out->data + out->len, &got, 0) != 0) return false;
+  out->len += got;
   return true;
 }
 
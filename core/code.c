@@ -1,15 +1,17 @@
 // SPDX-License-Identifier: MIT
 /* ============================================================================
    /core/code.c — Implémentation « ultra complète » de l’API CLI
-   Dépend de /core/api.h et /core/code.h
+   Dépend de /core/api.h, /core/code.h et /core/hash.h
    Build (exécutable autonome) :
-     cc -O2 -std=c99 core/api.c core/code.c -DCODE_STANDALONE -o vitte-cli
+     cc -O2 -std=gnu17 -I. core/api.c core/hash.c core/table.c core/code.c \
+        -DCODE_STANDALONE -o vitte-cli
    ============================================================================
  */
 
 #include "code.h"
 #include "api.h"   // pour Err, StrBuf, vec_init, vec_push, etc.
 #include "utf8.h"  // utf8_decode_1
+#include "hash.h"  // vt_hash64 & co (bench)
 
 #include <string.h>
 #include <stdlib.h>
@@ -19,14 +21,6 @@
 #include <stddef.h>
 #include <stdint.h>
 
-/* Accès interne à la hash-map pour itération */
-struct HSlot {
-  char* key;
-  u64 val;
-  u64 hash;
-  bool used;
-};
-
 /* -------------------------------------------------------------------------- */
 /* Utils locaux */
 /* -------------------------------------------------------------------------- */
@@ -78,7 +72,7 @@ void code_usage(FILE* out) {
           "  json [out.json]                 JSON de démo\n"
           "  utf8 <texte>                    liste des codepoints\n"
           "  freq <fichier> [topK]           fréquences des mots\n"
-          "  bench [bytes] [iters]           bench hash64\n"
+          "  bench [bytes] [iters] [algo]    débit (GB/s) des hachages\n"
           "  ansi <texte>                    sortie colorée\n"
           "  demo                            démonstration\n",
           app, CODE_APP_VERSION, app, app);
@@ -189,6 +183,14 @@ Err code_utf8_list_cps(const char* s, vec_u32* out) {
   return api_ok();
 }
 
+static void freq_pair_push(const char* key, u64 val, void* udata) {
+  vec_CodeKV* out = (vec_CodeKV*)udata;
+  CodeKV kv;
+  kv.word = xstrdup(key);
+  kv.count = val;
+  vec_push(out, kv);
+}
+
 Err code_freq_pairs(const char* path, vec_CodeKV* out_pairs) {
   if (!path || !out_pairs) return api_errf(CODE_EINVAL, "args");
   vec_u8 file;
@@ -222,15 +224,7 @@ Err code_freq_pairs(const char* path, vec_CodeKV* out_pairs) {
   }
 
   vec_init(out_pairs);
-  for (usize s = 0; s < map.cap; s++) {
-    struct HSlot* slot = &map.slots[s];
-    if (slot->used) {
-      CodeKV kv;
-      kv.word = xstrdup(slot->key);
-      kv.count = slot->val;
-      vec_push(out_pairs, kv);
-    }
-  }
+  map_foreach(&map, freq_pair_push, out_pairs);
 
   map_free(&map);
   vec_free(&file);
@@ -242,30 +236,76 @@ void code_freq_sort_desc(vec_CodeKV* xs) {
   qsort(xs->data, xs->len, sizeof(CodeKV), cmp_kv_desc);
 }
 
-Err code_bench_hash64(size_t bytes, int iters, CodeBench* out) {
-  if (bytes == 0 || iters <= 0 || !out) return api_errf(CODE_EINVAL, "args");
+/* Algorithmes mesurés par `bench`; impl >= 0: variante vt_hash64 forcée */
+typedef u64 (*code_hash_fn)(const u8* p, size_t n, u64 seed);
+static u64 bench_api_hash64(const u8* p, size_t n, u64 seed) { (void)seed; return hash64(p, n); }
+static u64 bench_fnv1a64(const u8* p, size_t n, u64 seed) { return vt_fnv1a64(p, n, seed); }
+static u64 bench_murmur3(const u8* p, size_t n, u64 seed) { return vt_murmur3_32(p, n, (uint32_t)seed); }
+static u64 bench_crc32(const u8* p, size_t n, u64 seed) { return vt_crc32(p, n, (uint32_t)seed); }
+static u64 bench_vt_hash64(const u8* p, size_t n, u64 seed) { return vt_hash64(p, n, seed); }
+
+static const struct { const char* name; code_hash_fn fn; int impl; } code_bench_algos[] = {
+  {"hash64", bench_api_hash64, -1},
+  {"fnv1a64", bench_fnv1a64, -1},
+  {"murmur3", bench_murmur3, -1},
+  {"crc32", bench_crc32, -1},
+  {"vt_hash64/scalar", bench_vt_hash64, VT_HASH_IMPL_SCALAR},
+  {"vt_hash64/sse2", bench_vt_hash64, VT_HASH_IMPL_SSE2},
+  {"vt_hash64/avx2", bench_vt_hash64, VT_HASH_IMPL_AVX2},
+  {"vt_hash64/neon", bench_vt_hash64, VT_HASH_IMPL_NEON},
+};
+
+size_t code_bench_algo_count(void) {
+  return sizeof(code_bench_algos) / sizeof(code_bench_algos[0]);
+}
+const char* code_bench_algo_name(size_t i) {
+  return i < code_bench_algo_count() ? code_bench_algos[i].name : NULL;
+}
+
+Err code_bench_hash(const char* algo, size_t bytes, int iters, CodeBench* out) {
+  if (!algo || bytes == 0 || iters <= 0 || !out) return api_errf(CODE_EINVAL, "args");
+  size_t k = 0;
+  while (k < code_bench_algo_count() && strcmp(code_bench_algos[k].name, algo) != 0) k++;
+  if (k == code_bench_algo_count()) return api_errf(CODE_EINVAL, "algo inconnu: %s", algo);
+  if (code_bench_algos[k].impl >= 0 &&
+      vt_hash_set_impl((vt_hash_impl)code_bench_algos[k].impl) != 0)
+    return api_errf(CODE_EINVAL, "%s: indisponible sur ce CPU", algo);
+
   vec_u8 buf;
   vec_init(&buf);
   vec_reserve(&buf, bytes);
   buf.len = bytes;
-  for (size_t i = 0; i < bytes; i++) buf.data[i] = (u8)(rand_u64() & 0xFF);
+  u64 x = 0x9E3779B97F4A7C15ull; /* même entrée pour tous les algos */
+  for (size_t i = 0; i < bytes; i++) {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+    buf.data[i] = (u8)(x >> 56);
+  }
 
+  code_hash_fn fn = code_bench_algos[k].fn;
   u64 t0 = time_ns_monotonic();
   u64 acc = 0;
-  for (int i = 0; i < iters; i++) acc ^= hash64(buf.data, buf.len);
+  for (int i = 0; i < iters; i++) acc += fn(buf.data, buf.len, (u64)i);
   u64 t1 = time_ns_monotonic();
+  if (code_bench_algos[k].impl >= 0) (void)vt_hash_set_impl(VT_HASH_IMPL_AUTO);
 
   double sec = (t1 - t0) / 1e9;
-  double gib = ((double)bytes * (double)iters) / (1024.0 * 1024.0 * 1024.0);
+  double bytes_total = (double)bytes * (double)iters;
+  double gib = bytes_total / (1024.0 * 1024.0 * 1024.0);
+  out->algo = code_bench_algos[k].name;
   out->seconds = sec;
   out->gib = gib;
   out->gib_per_s = gib / sec;
+  out->gb_per_s = bytes_total / 1e9 / sec;
   out->accumulator = acc;
 
   vec_free(&buf);
   return api_ok();
 }
 
+Err code_bench_hash64(size_t bytes, int iters, CodeBench* out) {
+  return code_bench_hash("hash64", bytes, iters, out);
+}
+
 Err code_ansi_render(const char* text, StrBuf* out) {
   if (!text || !out) return api_errf(CODE_EINVAL, "args");
   ansi_paint_to(out, text, ansi_green());
@@ -404,18 +444,26 @@ int code_main(int argc, char** argv) {
       for (int i = 0; i < limit; i++) {
         printf("%8llu  %s\n", (unsigned long long)xs.data[i].count,
                xs.data[i].word ? xs.data[i].word : "");
-        free((void*)xs.data[i].word);
       }
+      for (usize i = 0; i < xs.len; i++) free((void*)xs.data[i].word);
       vec_free(&xs); return 0;
     }
 
     case CMD_BENCH: {
       size_t bytes = (argc >= 3) ? (size_t)strtoull(argv[2], NULL, 10) : ((size_t)1 << 20);
       int iters = (argc >= 4) ? atoi(argv[3]) : 200;
-      CodeBench r; Err e = code_bench_hash64(bytes, iters, &r);
-      if (e.code) { vl_logf(VL_LOG_ERROR, "%s", e.msg); return code_status_from_err(&e); }
-      printf("hash64: %.3fs, %.2f GiB, %.2f GiB/s, acc=%016llx\n",
-             r.seconds, r.gib, r.gib_per_s, (unsigned long long)r.accumulator);
+      const char* only = (argc >= 5) ? argv[4] : NULL;
+      printf("%zu octets x %d (vt_hash64 auto: %s)\n", bytes, iters, vt_hash_impl_name());
+      for (size_t i = 0; i < (only ? 1 : code_bench_algo_count()); i++) {
+        const char* name = only ? only : code_bench_algo_name(i);
+        CodeBench r; Err e = code_bench_hash(name, bytes, iters, &r);
+        if (e.code) {
+          if (only) { vl_logf(VL_LOG_ERROR, "%s", e.msg); return code_status_from_err(&e); }
+          continue; /* variante absente sur ce CPU */
+        }
+        printf("%-18s %8.2f GB/s  %.3fs  acc=%016llx\n", r.algo, r.gb_per_s, r.seconds,
+               (unsigned long long)r.accumulator);
+      }
       return 0;
     }
 
@@ -58,9 +58,11 @@ typedef struct CodeKV {
 } CodeKV;
 
 typedef struct CodeBench {
+  const char* algo;   /* nom tel que listé par code_bench_algo_name */
   double seconds;
   double gib;
   double gib_per_s;
+  double gb_per_s;    /* 1e9 octets/s */
   u64    accumulator;
 } CodeBench;
 
@@ -96,7 +98,12 @@ Err  code_utf8_list_cps(const char* s, vec_u32* out_codepoints);
 Err  code_freq_pairs(const char* path, vec_CodeKV* out_pairs);
 void code_freq_sort_desc(vec_CodeKV* xs);
 
-Err  code_bench_hash64(size_t bytes, int iters, CodeBench* out);
+/* Bench de débit: hash64 (api), fnv1a64, murmur3, crc32, vt_hash64/<impl>.
+   Une variante vt_hash64 absente du CPU donne CODE_EINVAL. */
+size_t      code_bench_algo_count(void);
+const char* code_bench_algo_name(size_t i);
+Err  code_bench_hash(const char* algo, size_t bytes, int iters, CodeBench* out);
+Err  code_bench_hash64(size_t bytes, int iters, CodeBench* out); /* "hash64" */
 Err  code_ansi_render(const char* text, StrBuf* out);
 void code_demo(void);
 
@@ -4,13 +4,14 @@
      - info        : type (ELF/PE/Mach-O), taille, horodatage, permissions
      - hexdump     : hex/ascii, colonnes/groupes, offset/longueur
      - strings     : extraction chaînes ASCII ou UTF-16LE, seuil min
-     - hash        : CRC32, SHA-256
+     - hash        : CRC32, SHA-256 (plusieurs fichiers, --jobs N threads)
      - entropy     : Shannon globale ou fenêtrée
      - diff        : comparaison de deux fichiers, résumé + contexte
      - slice       : extrait une tranche vers un fichier
-   Dépendances: standard C. Optionnel: debug.h (VT_*). Sinon fallback.
-   Build (POSIX): cc -std=c17 -O2 dump.c -o dump
-   Build (Win)  : cl /std:c17 /O2 dump.c
+   Dépendances: standard C, hash.c. Optionnel: debug.h (VT_*), <threads.h>
+   (sinon --jobs ignoré).
+   Build (POSIX): cc -std=c17 -O2 dump.c hash.c -o dump
+   Build (Win)  : cl /std:c17 /O2 dump.c hash.c
    Licence: MIT.
    ============================================================================
  */
@@ -35,6 +36,16 @@
 #include <time.h>
 #include <math.h>
 
+#include "hash.h" /* vt_crc32, vt_sha256_multi */
+
+#if !defined(__STDC_NO_THREADS__)
+#include <stdatomic.h>
+#include <threads.h>
+#define DUMP_HAS_THREADS 1
+#else
+#define DUMP_HAS_THREADS 0
+#endif
+
 /* ---------------------------------------------------------------------------
    Logging: utilise debug.h si présent, sinon macros fallback
 --------------------------------------------------------------------------- */
@@ -407,149 +418,90 @@ static void hexdump(const uint8_t* p, size_t len, uint64_t base, int cols,
 }
 
 /* ---------------------------------------------------------------------------
-   CRC32 (IEEE 802.3) + SHA-256 (petite implémentation)
+   hash: CRC32 / SHA-256 de nombreux fichiers (hash.h)
+   Les threads prennent les fichiers par lots de 8 (compteur atomique) et
+   passent chaque lot à vt_sha256_multi; l’affichage reste dans l’ordre.
 --------------------------------------------------------------------------- */
-static uint32_t crc32_tab[256];
-static void crc32_init(void) {
-  uint32_t poly = 0xEDB88320u;
-  for (uint32_t i = 0; i < 256; i++) {
-    uint32_t c = i;
-    for (int j = 0; j < 8; j++) c = (c & 1) ? (poly ^ (c >> 1)) : (c >> 1);
-    crc32_tab[i] = c;
-  }
-}
-static uint32_t crc32_compute(const void* data, size_t len) {
-  const uint8_t* p = (const uint8_t*)data;
-  uint32_t c = 0xFFFFFFFFu;
-  for (size_t i = 0; i < len; i++) c = crc32_tab[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
-  return c ^ 0xFFFFFFFFu;
-}
+#define HASH_BATCH 8
 
-/* ---- SHA-256 ---- */
 typedef struct {
-  uint32_t h[8];
-  uint64_t bits;
-  uint8_t buf[64];
-  size_t blen;
-} sha256_t;
-static uint32_t ROR(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
-static uint32_t Ch(uint32_t x, uint32_t y, uint32_t z) {
-  return (x & y) ^ (~x & z);
-}
-static uint32_t Maj(uint32_t x, uint32_t y, uint32_t z) {
-  return (x & y) ^ (x & z) ^ (y & z);
-}
-static uint32_t BSIG0(uint32_t x) {
-  return ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22);
-}
-static uint32_t BSIG1(uint32_t x) {
-  return ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25);
-}
-static uint32_t SSIG0(uint32_t x) { return ROR(x, 7) ^ ROR(x, 18) ^ (x >> 3); }
-static uint32_t SSIG1(uint32_t x) {
-  return ROR(x, 17) ^ ROR(x, 19) ^ (x >> 10);
-}
-
-static const uint32_t K256[64] = {
-    0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu,
-    0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u, 0xd807aa98u, 0x12835b01u,
-    0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u,
-    0xc19bf174u, 0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu,
-    0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau, 0x983e5152u,
-    0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u,
-    0x06ca6351u, 0x14292967u, 0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu,
-    0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
-    0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u,
-    0xd6990624u, 0xf40e3585u, 0x106aa070u, 0x19a4c116u, 0x1e376c08u,
-    0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu,
-    0x682e6ff3u, 0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u,
-    0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u};
+  const char* path;
+  int err; /* errno de map_file, 0 = OK */
+  uint64_t size;
+  uint32_t crc;
+  uint8_t sha[32];
+} hash_item;
 
-static void sha256_init(sha256_t* s) {
-  s->h[0] = 0x6a09e667u;
-  s->h[1] = 0xbb67ae85u;
-  s->h[2] = 0x3c6ef372u;
-  s->h[3] = 0xa54ff53au;
-  s->h[4] = 0x510e527fu;
-  s->h[5] = 0x9b05688cu;
-  s->h[6] = 0x1f83d9abu;
-  s->h[7] = 0x5be0cd19u;
-  s->bits = 0;
-  s->blen = 0;
-}
-static void sha256_block(sha256_t* s, const uint8_t b[64]) {
-  uint32_t W[64];
-  for (int i = 0; i < 16; i++) {
-    W[i] = ((uint32_t)b[4 * i] << 24) | ((uint32_t)b[4 * i + 1] << 16) |
-           ((uint32_t)b[4 * i + 2] << 8) | ((uint32_t)b[4 * i + 3]);
-  }
-  for (int i = 16; i < 64; i++)
-    W[i] = SSIG1(W[i - 2]) + W[i - 7] + SSIG0(W[i - 15]) + W[i - 16];
-  uint32_t a = s->h[0], b0 = s->h[1], c = s->h[2], d = s->h[3], e = s->h[4],
-           f = s->h[5], g = s->h[6], h = s->h[7];
-  for (int i = 0; i < 64; i++) {
-    uint32_t T1 = h + BSIG1(e) + Ch(e, f, g) + K256[i] + W[i];
-    uint32_t T2 = BSIG0(a) + Maj(a, b0, c);
-    h = g;
-    g = f;
-    f = e;
-    e = d + T1;
-    d = c;
-    c = b0;
-    b0 = a;
-    a = T1 + T2;
-  }
-  s->h[0] += a;
-  s->h[1] += b0;
-  s->h[2] += c;
-  s->h[3] += d;
-  s->h[4] += e;
-  s->h[5] += f;
-  s->h[6] += g;
-  s->h[7] += h;
-}
-static void sha256_update(sha256_t* s, const void* data, size_t len) {
-  const uint8_t* p = (const uint8_t*)data;
-  s->bits += (uint64_t)len * 8u;
-  if (s->blen) {
-    size_t need = 64 - s->blen;
-    size_t take = (len < need) ? len : need;
-    memcpy(s->buf + s->blen, p, take);
-    s->blen += take;
-    p += take;
-    len -= take;
-    if (s->blen == 64) {
-      sha256_block(s, s->buf);
-      s->blen = 0;
+typedef struct {
+  hash_item* items;
+  size_t n;
+  int want_crc, want_sha;
+#if DUMP_HAS_THREADS
+  atomic_size_t next;
+#else
+  size_t next;
+#endif
+} hash_job;
+
+static void hash_batch(hash_job* J, size_t lo, size_t hi) {
+  map_t m[HASH_BATCH];
+  const void* ptr[HASH_BATCH] = {0};
+  size_t len[HASH_BATCH] = {0}, idx[HASH_BATCH], k = 0;
+  uint8_t out[HASH_BATCH][32];
+  for (size_t i = lo; i < hi; i++) {
+    hash_item* it = &J->items[i];
+    if (map_file(it->path, &m[k]) != 0) {
+      it->err = errno ? errno : EIO;
+      continue;
     }
+    it->size = m[k].len;
+    if (J->want_crc) it->crc = vt_crc32(m[k].ptr, m[k].len, 0);
+    ptr[k] = m[k].ptr;
+    len[k] = m[k].len;
+    idx[k++] = i;
   }
-  while (len >= 64) {
-    sha256_block(s, p);
-    p += 64;
-    len -= 64;
-  }
-  if (len) {
-    memcpy(s->buf, p, len);
-    s->blen = len;
+  if (J->want_sha) {
+    vt_sha256_multi(ptr, len, k, out);
+    for (size_t j = 0; j < k; j++) memcpy(J->items[idx[j]].sha, out[j], 32);
   }
+  for (size_t j = 0; j < k; j++) unmap_file(&m[j]);
 }
-static void sha256_final(sha256_t* s, uint8_t out[32]) {
-  /* padding */
-  uint8_t pad[64] = {0x80};
-  size_t padlen = (s->blen < 56) ? (56 - s->blen) : (120 - s->blen);
-  sha256_update(s, pad, padlen);
-  uint8_t lenb[8];
-  for (int i = 0; i < 8; i++)
-    lenb[7 - i] = (uint8_t)((s->bits >> (i * 8)) & 0xFFu);
-  sha256_update(s, lenb, 8);
-  for (int i = 0; i < 8; i++) {
-    out[4 * i + 0] = (uint8_t)(s->h[i] >> 24);
-    out[4 * i + 1] = (uint8_t)(s->h[i] >> 16);
-    out[4 * i + 2] = (uint8_t)(s->h[i] >> 8);
-    out[4 * i + 3] = (uint8_t)(s->h[i]);
+
+static int hash_worker(void* arg) {
+  hash_job* J = (hash_job*)arg;
+  for (;;) {
+#if DUMP_HAS_THREADS
+    size_t lo = atomic_fetch_add(&J->next, HASH_BATCH);
+#else
+    size_t lo = J->next;
+    J->next += HASH_BATCH;
+#endif
+    if (lo >= J->n) return 0;
+    hash_batch(J, lo, lo + HASH_BATCH < J->n ? lo + HASH_BATCH : J->n);
   }
 }
 
+/* jobs ≤ 1 ou sans threads: tout dans le thread appelant */
+static void hash_run(hash_job* J, unsigned jobs) {
+#if DUMP_HAS_THREADS
+  atomic_init(&J->next, 0);
+  size_t max = (J->n + HASH_BATCH - 1) / HASH_BATCH;
+  if (jobs > max) jobs = (unsigned)max;
+  thrd_t* th = jobs > 1 ? (thrd_t*)malloc((jobs - 1) * sizeof *th) : NULL;
+  unsigned started = 0;
+  if (th)
+    while (started < jobs - 1 && thrd_create(&th[started], hash_worker, J) == thrd_success)
+      started++;
+  hash_worker(J);
+  for (unsigned i = 0; i < started; i++) thrd_join(th[i], NULL);
+  free(th);
+#else
+  (void)jobs;
+  J->next = 0;
+  hash_worker(J);
+#endif
+}
+
 /* ---------------------------------------------------------------------------
    Entropie de Shannon (0..8 bits) + version fenêtrée
 --------------------------------------------------------------------------- */
@@ -779,7 +731,7 @@ static void usage(const char* prog) {
           "  hexdump <file> [--cols N] [--group N] [--ascii on|off] [--offset "
           "OFF] [--length LEN]\n"
           "  strings <file> [--min N] [--utf16]\n"
-          "  hash <file> [--crc32] [--sha256]\n"
+          "  hash <file>... [--crc32] [--sha256] [--jobs N]\n"
           "  entropy <file> [--window N] [--step N]\n"
           "  diff <A> <B> [--context N] [--summary]\n"
           "  slice <file> --offset OFF --length LEN --out PATH\n"
@@ -797,7 +749,6 @@ int main(int argc, char** argv) {
     return 2;
   }
   D_LOG_INIT();
-  crc32_init();
 
   const char* cmd = argv[1];
 
@@ -889,41 +840,63 @@ int main(int argc, char** argv) {
 
   /* ---------------- hash ---------------- */
   if (streq(cmd, "hash")) {
-    const char* path = argv[2];
     int want_crc = 0, want_sha = 0;
-    for (int i = 3; i < argc; i++) {
+    unsigned jobs = 1;
+    hash_job J;
+    memset(&J, 0, sizeof J);
+    J.items = (hash_item*)calloc((size_t)argc, sizeof *J.items);
+    if (!J.items) {
+      D_ERROR("oom");
+      D_LOG_SHUTDOWN();
+      return 1;
+    }
+    for (int i = 2; i < argc; i++) {
       if (streq(argv[i], "--crc32"))
         want_crc = 1;
       else if (streq(argv[i], "--sha256"))
         want_sha = 1;
+      else if (streq(argv[i], "--jobs") && i + 1 < argc) {
+        int ok;
+        uint64_t v = parse_u64(argv[++i], &ok);
+        jobs = ok && v > 0 ? (v > 256 ? 256u : (unsigned)v) : 1u;
+      } else
+        J.items[J.n++].path = argv[i];
     }
     if (!want_crc && !want_sha) {
       want_crc = 1;
       want_sha = 1;
     }
-    map_t m;
-    if (map_file(path, &m) != 0) {
-      D_ERROR("open: %s", strerror(errno));
-      D_LOG_SHUTDOWN();
-      return 1;
-    }
-    if (want_crc) {
-      uint32_t c = crc32_compute(m.ptr, m.len);
-      printf("CRC32: %08x\n", c);
-    }
-    if (want_sha) {
-      sha256_t s;
-      sha256_init(&s);
-      sha256_update(&s, m.ptr, m.len);
-      uint8_t out[32];
-      sha256_final(&s, out);
-      printf("SHA256: ");
-      for (int i = 0; i < 32; i++) printf("%02x", out[i]);
-      putchar('\n');
+    J.want_crc = want_crc;
+    J.want_sha = want_sha;
+    hash_run(&J, jobs);
+
+    int rc = 0;
+    for (size_t f = 0; f < J.n; f++) {
+      const hash_item* it = &J.items[f];
+      if (it->err) {
+        D_ERROR("open %s: %s", it->path, strerror(it->err));
+        rc = 1;
+        continue;
+      }
+      if (J.n == 1) { /* format historique */
+        if (want_crc) printf("CRC32: %08x\n", it->crc);
+        if (want_sha) {
+          printf("SHA256: ");
+          for (int i = 0; i < 32; i++) printf("%02x", it->sha[i]);
+          putchar('\n');
+        }
+        continue;
+      }
+      if (want_crc) printf("%08x  ", it->crc);
+      if (want_sha) {
+        for (int i = 0; i < 32; i++) printf("%02x", it->sha[i]);
+        printf("  ");
+      }
+      printf("%s\n", it->path);
     }
-    unmap_file(&m);
+    free(J.items);
     D_LOG_SHUTDOWN();
-    return 0;
+    return rc;
   }
 
   /* ---------------- entropy ---------------- */
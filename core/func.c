@@ -8,9 +8,9 @@
      - entropy     : Shannon globale ou fenêtrée
      - diff        : comparaison de deux fichiers, résumé + contexte
      - slice       : extrait une tranche vers un fichier
-   Dépendances: standard C. Optionnel: debug.h (VT_*). Sinon fallback.
-   Build (POSIX): cc -std=c17 -O2 dump.c -o dump
-   Build (Win)  : cl /std:c17 /O2 dump.c
+   Dépendances: standard C, hash.c (CRC32). Optionnel: debug.h (VT_*).
+   Build (POSIX): cc -std=c17 -O2 dump.c hash.c -o dump
+   Build (Win)  : cl /std:c17 /O2 dump.c hash.c
    Licence: MIT.
    ============================================================================
  */
@@ -35,6 +35,9 @@
 #include <time.h>
 #include <math.h>
 
+#include "hash.h" /* vt_crc32 */
+#include "utf8.h" /* utf8_validate */
+
 /* ---------------------------------------------------------------------------
    Logging: utilise debug.h si présent, sinon macros fallback
 --------------------------------------------------------------------------- */
@@ -73,6 +76,13 @@
   } while (0)
 #endif
 
+/* ---------------------------------------------------------------------------
+   UTF-8 (func.h): validateur partagé de core/utf8.c
+--------------------------------------------------------------------------- */
+int vt_utf8_is_valid(const unsigned char* s, size_t n) {
+  return utf8_validate((const char*)s, n);
+}
+
 #if defined(VT_ENABLE_TOOLS)
 
 /* ---------------------------------------------------------------------------
@@ -407,25 +417,8 @@ static void hexdump(const uint8_t* p, size_t len, uint64_t base, int cols,
 }
 
 /* ---------------------------------------------------------------------------
-   CRC32 (IEEE 802.3) + SHA-256 (petite implémentation)
+   SHA-256 (petite implémentation); CRC32: vt_crc32 (hash.h)
 --------------------------------------------------------------------------- */
-static uint32_t crc32_tab[256];
-static void crc32_init(void) {
-  uint32_t poly = 0xEDB88320u;
-  for (uint32_t i = 0; i < 256; i++) {
-    uint32_t c = i;
-    for (int j = 0; j < 8; j++) c = (c & 1) ? (poly ^ (c >> 1)) : (c >> 1);
-    crc32_tab[i] = c;
-  }
-}
-static uint32_t crc32_compute(const void* data, size_t len) {
-  const uint8_t* p = (const uint8_t*)data;
-  uint32_t c = 0xFFFFFFFFu;
-  for (size_t i = 0; i < len; i++) c = crc32_tab[(c ^ p[i]) & 0xFFu] ^ (c >> 8);
-  return c ^ 0xFFFFFFFFu;
-}
-
-/* ---- SHA-256 ---- */
 typedef struct {
   uint32_t h[8];
   uint64_t bits;
@@ -797,7 +790,6 @@ int main(int argc, char** argv) {
     return 2;
   }
   D_LOG_INIT();
-  crc32_init();
 
   const char* cmd = argv[1];
 
@@ -908,7 +900,7 @@ int main(int argc, char** argv) {
       return 1;
     }
     if (want_crc) {
-      uint32_t c = crc32_compute(m.ptr, m.len);
+      uint32_t c = vt_crc32(m.ptr, m.len, 0);
       printf("CRC32: %08x\n", c);
     }
     if (want_sha) {
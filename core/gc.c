@@ -6,6 +6,26 @@
      - Racines explicites: enregistrer des pointeurs (void**) modifiables.
      - Finalizers optionnels, pin/unpin, limite d’heap, stats.
      - Thread-safe si <threads.h> dispo, sinon mono-thread.
+     - Génération jeune optionnelle (nursery_bytes): bump pointer, collecte
+       mineure de Cheney aux points sûrs (vt_gc_safepoint); tout survivant
+       est promu par copie dans la liste mark-sweep. Les anciens qui reçoivent
+       un pointeur jeune entrent dans un remembered set (barrière d’écriture);
+       s’il ne peut grandir, la mineure rescanne tout l’espace ancien.
+     - Mode incrémental optionnel (incremental): marquage tricolore par
+       tranches bornées (objets et/ou µs) payées par le volume alloué; le
+       travail d’une tranche vaut VTGC_STEPMUL fois les objets alloués
+       depuis la précédente, et au-delà de VTGC_OVERSHOOT fois la limite le
+       cycle cède à une collecte complète,
+       barrière de Steele (un noir modifié redevient gris et n’est
+       rescanné qu’à la remarque), remarque atomique des racines, du
+       remembered set et des jeunes, puis sweep paresseux par tranches.
+       Un objet est toujours parcouru d’un bloc. Pauses dans vt_gc_stats.
+     - Collectes complètes parallèles optionnelles (mark_threads): N
+       marqueurs, chacun avec une deque de Chase-Lev (vol de travail),
+       réclamation des objets par échange atomique de mark_epoch. Sweep
+       optionnel sur un thread de fond (concurrent_sweep): la liste des
+       objets est détachée, balayée pendant que le mutateur alloue dans une
+       liste neuve, puis les survivants sont raccrochés.
    Auteur: MIT.
    ============================================================================
  */
@@ -17,30 +37,73 @@
 #include <string.h>
 #include <time.h>
 
-#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#if __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__) && \
+    !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
 #include <threads.h>
 #define VTGC_HAS_THREADS 1
 #else
 #define VTGC_HAS_THREADS 0
 #endif
 
+/* Champs d’en-tête lus par les marqueurs et le sweep de fond: atomiques
+   relâchés (simples mov sur x86-64/arm64). */
+#if VTGC_HAS_THREADS
+typedef _Atomic uint32_t vtgc_u32;
+#define VTGC_LD(x)    atomic_load_explicit(&(x), memory_order_relaxed)
+#define VTGC_ST(x, v) atomic_store_explicit(&(x), (v), memory_order_relaxed)
+#else
+typedef uint32_t vtgc_u32;
+#define VTGC_LD(x)    (x)
+#define VTGC_ST(x, v) ((x) = (v))
+#endif
+
 /* -------------------------------- API publique (protos) ------------------- */
 typedef struct vt_gc vt_gc;
 
 typedef void (*vt_gc_visit_fn)(void* child, void* ctx);
 typedef void (*vt_gc_trace_fn)(void* obj, vt_gc_visit_fn visit, void* ctx);
 typedef void (*vt_gc_finalizer)(void* obj);
+typedef void* (*vt_gc_move_fn)(void* child, void* ctx);
+typedef void (*vt_gc_update_fn)(void* obj, vt_gc_move_fn move, void* ctx);
 
 typedef struct {
   size_t heap_limit_bytes; /* 0 = auto (8 Mo) */
   int enable_logging;      /* 1 = logs sur stderr */
+  size_t nursery_bytes;    /* 0 = pas de génération jeune */
+  int incremental;         /* 1 = marquage incrémental + sweep paresseux */
+  size_t slice_work;       /* objets par tranche (0 = 1024) */
+  uint32_t slice_us;       /* plafond de durée d’une tranche (0 = aucun) */
+  size_t slice_bytes;      /* octets alloués par tranche (0 = 64 Kio) */
+  unsigned mark_threads;   /* >1: marquage parallèle des collectes complètes */
+  int concurrent_sweep;    /* 1: sweep des collectes complètes en fond */
 } vt_gc_config;
 
+typedef struct {
+  size_t bytes_live, object_count;
+  uint64_t cycles;       /* collectes complètes terminées */
+  uint64_t minors;       /* collectes mineures */
+  uint64_t slices;       /* tranches incrémentales (marquage + sweep) */
+  uint64_t slice_ns_total, slice_ns_max;
+  uint64_t remark_ns_max; /* remarque atomique de fin de marquage */
+  uint64_t stw_ns_max;    /* vt_gc_collect complet */
+  uint64_t minor_ns_max;
+  uint64_t mark_ns_total, marked_total; /* collectes complètes */
+  uint64_t sweep_ns_total, swept_total;
+  int phase;              /* 0 repos, 1 marquage, 2 sweep */
+  int sweeping;           /* sweep de fond en cours */
+} vt_gc_stats;
+
 vt_gc* vt_gc_create(const vt_gc_config* cfg);
 void vt_gc_destroy(vt_gc* gc);
 
 void* vt_gc_alloc(vt_gc* gc, size_t size, vt_gc_trace_fn trace,
                   vt_gc_finalizer fin, uint32_t tag);
+void* vt_gc_alloc_young(vt_gc* gc, size_t size, vt_gc_update_fn update,
+                        vt_gc_finalizer fin, uint32_t tag);
+void vt_gc_write_barrier(vt_gc* gc, void* obj);
+int vt_gc_safepoint(vt_gc* gc);
+int vt_gc_is_minor(void* ctx);
 
 void vt_gc_collect(vt_gc* gc, const char* reason);
 
@@ -57,6 +120,8 @@ size_t vt_gc_object_count(vt_gc* gc);
 uint32_t vt_gc_tag_of(const void* obj);
 void vt_gc_set_tag(void* obj, uint32_t tag);
 
+void vt_gc_get_stats(vt_gc* gc, vt_gc_stats* out);
+
 void vt_gc_dump(vt_gc* gc, FILE* out); /* debug */
 
 /* -------------------------------- Implémentation -------------------------- */
@@ -82,30 +147,90 @@ typedef struct {
   size_t n, cap;
 } vt_gc_roots;
 
+/* flags */
+#define VTGC_YOUNG 1u      /* dans la nursery */
+#define VTGC_REMEMBERED 2u /* ancien présent dans le remembered set */
+#define VTGC_FORWARDED 4u  /* jeune évacué: next_all = copie promue */
+#define VTGC_GRAY 8u       /* sur la pile grise */
+
+/* phases du cycle incrémental */
+enum { VTGC_IDLE = 0, VTGC_MARK, VTGC_SWEEP };
+
+/* Rythme incrémental: unités de travail (objet marqué ou balayé) dues par
+   objet alloué pendant un cycle. >1: le cycle avance plus vite que
+   l’allocation et se termine. Filet: si bytes_live dépasse OVERSHOOT fois
+   la limite en cours de cycle (tranches plafonnées en µs), collecte
+   complète. */
+#define VTGC_STEPMUL 4u
+#define VTGC_OVERSHOOT 2u
+
 struct vt_gc_obj {
   vt_gc_obj* next_all;
   vt_gc_obj* next_gray;
   size_t size;         /* taille du payload */
   uint32_t tag;        /* libre pour l’utilisateur */
-  uint32_t pin;        /* >0 => non libérable */
-  uint32_t mark_epoch; /* dernière époque marquée */
+  vtgc_u32 pin;        /* >0 => non libérable */
+  vtgc_u32 mark_epoch; /* dernière époque marquée */
+  uint32_t flags;      /* VTGC_* */
   vt_gc_trace_fn trace;
+  vt_gc_update_fn update; /* objets déplaçables (exclusif avec trace) */
   vt_gc_finalizer fin;
   VT_MAX_ALIGN _align_guard; /* force l’alignement du payload */
                             /* payload suit immédiatement */
 };
 
+/* Sweep d’une liste détachée (en place ou sur le thread de fond) */
+typedef struct {
+  vt_gc_obj* list; /* à balayer, puis survivants */
+  vt_gc_obj* tail; /* dernier survivant */
+  uint32_t epoch;
+  size_t live, count, swept;
+  uint64_t ns;
+} vtgc_sweep_job;
+
 struct vt_gc {
+  int in_minor;      /* en tête: les marqueurs parallèles partagent ce
+                        préfixe (ctx de vt_gc_is_minor) */
   vt_gc_obj* all;    /* liste simplement chaînée de tous les objets */
   vt_gc_obj* gray;   /* pile gris pour le marquage */
   vt_gc_roots roots; /* racines explicites */
   size_t bytes_live;
   size_t obj_count;
   size_t heap_limit;
+  size_t next_gc; /* seuil réarmé après chaque cycle (vtgc_rearm) */
   size_t bytes_since_gc;
   uint32_t epoch;
   int logging;
+  /* Génération jeune (nursery == NULL: désactivée) */
+  uint8_t* nursery;
+  size_t nursery_size, nursery_top;
+  size_t young_bytes, young_count; /* payloads alloués depuis la mineure */
+  int minor_pending;               /* nursery pleine: mineure au point sûr */
+  vt_gc_obj** remset;              /* anciens pointant (peut-être) vers jeunes */
+  size_t nrem, rem_cap;
+  int rem_overflow; /* remset incomplet: la mineure scanne tout l’ancien */
+  size_t minor_count;
+  vt_gc_obj* scan; /* file des promus de la mineure (lien next_gray) */
+  /* Incrémental */
+  int incremental;
+  int phase;                /* VTGC_* */
+  int remark;               /* remarque atomique: les jeunes sont suivis */
+  size_t slice_work, slice_bytes;
+  uint64_t slice_ns;        /* 0 = pas de plafond de temps */
+  size_t debt;              /* octets alloués depuis la dernière tranche */
+  size_t debt_objs;         /* objets alloués depuis la dernière tranche */
+  vt_gc_obj** sweep_at;     /* lien courant du sweep paresseux */
+  vt_gc_obj* dirty;         /* noirs modifiés, rescannés à la remarque
+                               (lien next_gray, drapeau GRAY) */
+  vt_gc_stats st;
+  /* Collectes complètes parallèles */
+  unsigned mark_threads;
+  int bg_sweep;
+  vtgc_sweep_job job;
 #if VTGC_HAS_THREADS
+  int sweeping;           /* job détaché, thread sweeper actif */
+  atomic_int sweep_done;  /* posé par le sweeper, lu par le mutateur */
+  thrd_t sweeper;
   mtx_t lock;
 #endif
 };
@@ -183,28 +308,69 @@ static inline void* vtgc_ptr_from_hdr(vt_gc_obj* h) {
   return (void*)((uint8_t*)h + sizeof(vt_gc_obj));
 }
 
+/* --------- Horloge (pauses) --------- */
+static uint64_t vtgc_now_ns(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
 /* --------- Marquage --------- */
-static inline void vtgc_mark_hdr(vt_gc* gc, vt_gc_obj* h) {
-  if (!h) return;
-  if (h->mark_epoch == gc->epoch) return;
-  h->mark_epoch = gc->epoch;
+static inline void vtgc_push_gray(vt_gc* gc, vt_gc_obj* h) {
+  h->flags |= VTGC_GRAY;
   h->next_gray = gc->gray;
   gc->gray = h;
 }
+static inline vt_gc_obj* vtgc_pop_gray(vt_gc* gc) {
+  vt_gc_obj* h = gc->gray;
+  gc->gray = h->next_gray;
+  h->next_gray = NULL;
+  h->flags &= ~VTGC_GRAY;
+  return h;
+}
+static inline void vtgc_mark_hdr(vt_gc* gc, vt_gc_obj* h) {
+  if (!h) return;
+  if (VTGC_LD(h->mark_epoch) == gc->epoch) return;
+  /* Tranches incrémentales: une mineure peut déplacer un jeune entre deux
+     tranches, il n’entre donc jamais sur la pile grise (voir remarque). */
+  if ((h->flags & VTGC_YOUNG) && gc->phase == VTGC_MARK && !gc->remark)
+    return;
+  VTGC_ST(h->mark_epoch, gc->epoch);
+  vtgc_push_gray(gc, h);
+}
+/* Remet un objet déjà marqué (noir) en gris pour le rescanner. */
+static inline void vtgc_regray(vt_gc* gc, vt_gc_obj* h) {
+  if (h->flags & VTGC_GRAY) return;
+  VTGC_ST(h->mark_epoch, gc->epoch);
+  vtgc_push_gray(gc, h);
+}
 static void vtgc_visit_child(void* child, void* ctx) {
   if (!child) return;
   vt_gc* gc = (vt_gc*)ctx;
   vtgc_mark_hdr(gc, vtgc_hdr_from_ptr(child));
 }
+static void* vtgc_mark_move(void* child, void* ctx) {
+  vtgc_visit_child(child, ctx);
+  return child;
+}
+static inline void vtgc_scan(vt_gc_obj* h, vt_gc* gc) {
+  if (h->trace)
+    h->trace(vtgc_ptr_from_hdr(h), vtgc_visit_child, gc);
+  else if (h->update)
+    h->update(vtgc_ptr_from_hdr(h), vtgc_mark_move, gc);
+}
 
 /* --------- Sweep --------- */
-static void vtgc_sweep(vt_gc* gc) {
+/* Balaye j->list (époque j->epoch): y laisse les survivants, dans l’ordre. */
+static void vtgc_sweep_list(vtgc_sweep_job* j) {
   vt_gc_obj* prev = NULL;
-  vt_gc_obj* cur = gc->all;
-  size_t new_live = 0, new_count = 0;
+  vt_gc_obj* cur = j->list;
+  size_t new_live = 0, new_count = 0, n = 0;
   while (cur) {
     vt_gc_obj* next = cur->next_all;
-    const int alive = (cur->mark_epoch == gc->epoch) || (cur->pin > 0);
+    const int alive =
+        (VTGC_LD(cur->mark_epoch) == j->epoch) || (VTGC_LD(cur->pin) > 0);
+    n++;
     if (alive) {
       new_live += cur->size;
       new_count += 1;
@@ -217,15 +383,345 @@ static void vtgc_sweep(vt_gc* gc) {
       if (prev)
         prev->next_all = next;
       else
-        gc->all = next;
+        j->list = next;
       free(cur);
     }
     cur = next;
   }
-  gc->bytes_live = new_live;
-  gc->obj_count = new_count;
+  j->tail = prev;
+  j->live = new_live;
+  j->count = new_count;
+  j->swept = n;
+}
+
+/* Seuil du prochain cycle d’après les survivants: max(limite, 2 × vivant).
+   Un tas vivant au-delà de la limite ne déclenche donc pas une collecte
+   par allocation; le coût d’un cycle reste proportionnel à l’allocation
+   qui le précède. */
+static void vtgc_rearm(vt_gc* gc) {
+  const size_t twice =
+      gc->bytes_live > SIZE_MAX / 2 ? SIZE_MAX : 2 * gc->bytes_live;
+  gc->next_gc = twice > gc->heap_limit ? twice : gc->heap_limit;
+}
+
+static void vtgc_sweep(vt_gc* gc) {
+  const uint64_t t0 = vtgc_now_ns();
+  vtgc_sweep_job j = {.list = gc->all, .epoch = gc->epoch};
+  vtgc_sweep_list(&j);
+  gc->all = j.list;
+  gc->bytes_live = j.live;
+  gc->obj_count = j.count;
+  gc->st.sweep_ns_total += vtgc_now_ns() - t0;
+  gc->st.swept_total += j.swept;
+  vtgc_rearm(gc);
+}
+
+#if VTGC_HAS_THREADS
+static int vtgc_sweeper_main(void* arg) {
+  vt_gc* gc = (vt_gc*)arg;
+  const uint64_t t0 = vtgc_now_ns();
+  vtgc_sweep_list(&gc->job);
+  gc->job.ns = vtgc_now_ns() - t0;
+  atomic_store_explicit(&gc->sweep_done, 1, memory_order_release);
+  return 0;
+}
+
+/* Détache la liste et la confie au sweeper; 0 si lancé. Le mutateur repart
+   d’une liste vide: bytes_live ne compte plus que les nouveaux objets
+   jusqu’au raccord. */
+static int vtgc_sweep_start(vt_gc* gc) {
+  gc->job = (vtgc_sweep_job){.list = gc->all, .epoch = gc->epoch};
+  atomic_store_explicit(&gc->sweep_done, 0, memory_order_relaxed);
+  if (thrd_create(&gc->sweeper, vtgc_sweeper_main, gc) != thrd_success)
+    return -1;
+  gc->sweeping = 1;
+  gc->all = NULL;
+  gc->bytes_live = 0;
+  gc->obj_count = 0;
+  return 0;
+}
+#endif
+
+/* Raccorde les survivants du sweep de fond. wait=0: seulement s’il a fini.
+   À appeler avant tout parcours de gc->all et avant un nouveau marquage. */
+static void vtgc_sweep_join(vt_gc* gc, int wait) {
+#if VTGC_HAS_THREADS
+  if (!gc->sweeping) return;
+  if (!wait && !atomic_load_explicit(&gc->sweep_done, memory_order_acquire))
+    return;
+  thrd_join(gc->sweeper, NULL);
+  gc->sweeping = 0;
+  vtgc_sweep_job* j = &gc->job;
+  if (j->list) {
+    j->tail->next_all = gc->all;
+    gc->all = j->list;
+  }
+  gc->bytes_live += j->live;
+  gc->obj_count += j->count;
+  gc->st.sweep_ns_total += j->ns;
+  gc->st.swept_total += j->swept;
+  vtgc_rearm(gc);
+  vtgc_log(gc, "INFO", "background sweep end (objs=%zu, live=%zu)",
+           gc->obj_count, gc->bytes_live);
+#else
+  (void)gc;
+  (void)wait;
+#endif
 }
 
+/* --------- Marquage parallèle --------- */
+#if VTGC_HAS_THREADS
+typedef struct vtgc_ring {
+  size_t cap;             /* puissance de 2 */
+  struct vtgc_ring* prev; /* anneau remplacé, libéré après le marquage */
+  _Atomic(vt_gc_obj*) v[];
+} vtgc_ring;
+
+/* Deque de Chase-Lev (version C11 de Lê et al.): le propriétaire pousse et
+   reprend en bas, les voleurs prennent en haut. */
+typedef struct {
+  atomic_ptrdiff_t top, bottom;
+  _Atomic(vtgc_ring*) ring;
+} vtgc_deque;
+
+typedef struct vtgc_par vtgc_par;
+typedef struct {
+  int in_minor; /* toujours 0: même préfixe que vt_gc */
+  vt_gc* gc;
+  vtgc_par* par;
+  vtgc_deque dq;
+  vt_gc_obj* spill; /* deque pleine et anneau impossible à agrandir: pile
+                       privée (lien next_gray), jamais volée */
+  uint64_t marked;
+  uint32_t seed;
+} vtgc_marker;
+
+struct vtgc_par {
+  vtgc_marker* m;
+  unsigned n;
+  atomic_uint idle; /* marqueurs sans travail; n: marquage fini */
+};
+
+static vtgc_ring* vtgc_ring_new(size_t cap) {
+  vtgc_ring* r = (vtgc_ring*)malloc(sizeof *r + cap * sizeof r->v[0]);
+  if (!r) return NULL;
+  r->cap = cap;
+  r->prev = NULL;
+  return r;
+}
+
+static int vtgc_dq_push(vtgc_deque* d, vt_gc_obj* h) {
+  const ptrdiff_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+  const ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  vtgc_ring* r = atomic_load_explicit(&d->ring, memory_order_relaxed);
+  if (b - t >= (ptrdiff_t)r->cap) {
+    vtgc_ring* g = vtgc_ring_new(r->cap * 2);
+    if (!g) return -1;
+    for (ptrdiff_t i = t; i < b; i++)
+      atomic_store_explicit(
+          &g->v[(size_t)i & (g->cap - 1)],
+          atomic_load_explicit(&r->v[(size_t)i & (r->cap - 1)],
+                               memory_order_relaxed),
+          memory_order_relaxed);
+    g->prev = r; /* un voleur peut encore lire l’ancien */
+    atomic_store_explicit(&d->ring, g, memory_order_release);
+    r = g;
+  }
+  atomic_store_explicit(&r->v[(size_t)b & (r->cap - 1)], h,
+                        memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+  return 0;
+}
+
+static vt_gc_obj* vtgc_dq_take(vtgc_deque* d) {
+  const ptrdiff_t b =
+      atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+  vtgc_ring* r = atomic_load_explicit(&d->ring, memory_order_relaxed);
+  atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_relaxed);
+  vt_gc_obj* h = NULL;
+  if (t <= b) {
+    h = atomic_load_explicit(&r->v[(size_t)b & (r->cap - 1)],
+                             memory_order_relaxed);
+    if (t == b) {
+      /* dernier élément: course avec les voleurs */
+      if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                   memory_order_seq_cst,
+                                                   memory_order_relaxed))
+        h = NULL;
+      atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+  } else {
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+  }
+  return h;
+}
+
+static vt_gc_obj* vtgc_dq_steal(vtgc_deque* d) {
+  ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  const ptrdiff_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+  if (t >= b) return NULL;
+  vtgc_ring* r = atomic_load_explicit(&d->ring, memory_order_acquire);
+  vt_gc_obj* h = atomic_load_explicit(&r->v[(size_t)t & (r->cap - 1)],
+                                      memory_order_relaxed);
+  if (!atomic_compare_exchange_strong_explicit(
+          &d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+    return NULL; /* perdu contre un autre voleur ou le propriétaire */
+  return h;
+}
+
+static inline int vtgc_dq_nonempty(vtgc_deque* d) {
+  return atomic_load_explicit(&d->bottom, memory_order_acquire) -
+             atomic_load_explicit(&d->top, memory_order_acquire) >
+         0;
+}
+
+/* Réclame h (échange de l’époque): un seul marqueur le scanne. */
+static inline void vtgc_par_mark(vtgc_marker* m, vt_gc_obj* h) {
+  const uint32_t e = m->gc->epoch;
+  if (VTGC_LD(h->mark_epoch) == e) return;
+  if (atomic_exchange_explicit(&h->mark_epoch, e, memory_order_relaxed) == e)
+    return;
+  if (!h->trace && !h->update) { /* feuille: rien à pousser */
+    m->marked++;
+    return;
+  }
+  if (vtgc_dq_push(&m->dq, h) != 0) {
+    h->next_gray = m->spill;
+    m->spill = h;
+  }
+}
+static void vtgc_par_visit(void* child, void* ctx) {
+  if (child) vtgc_par_mark((vtgc_marker*)ctx, vtgc_hdr_from_ptr(child));
+}
+static void* vtgc_par_move(void* child, void* ctx) {
+  vtgc_par_visit(child, ctx);
+  return child;
+}
+static inline void vtgc_par_scan(vtgc_marker* m, vt_gc_obj* h) {
+  m->marked++;
+  if (h->trace)
+    h->trace(vtgc_ptr_from_hdr(h), vtgc_par_visit, m);
+  else if (h->update)
+    h->update(vtgc_ptr_from_hdr(h), vtgc_par_move, m);
+}
+
+static vt_gc_obj* vtgc_par_steal(vtgc_marker* m) {
+  vtgc_par* P = m->par;
+  m->seed = m->seed * 1664525u + 1013904223u;
+  const unsigned start = (m->seed >> 16) % P->n;
+  for (unsigned k = 0; k < P->n; k++) {
+    vtgc_marker* v = &P->m[(start + k) % P->n];
+    if (v == m) continue;
+    vt_gc_obj* h = vtgc_dq_steal(&v->dq);
+    if (h) return h;
+  }
+  return NULL;
+}
+
+/* Boucle d’un marqueur. Fin: tous inactifs. Un inactif a sa deque et sa
+   pile privée vides et ne pousse plus rien: le compteur à n suffit. */
+static int vtgc_par_main(void* arg) {
+  vtgc_marker* m = (vtgc_marker*)arg;
+  vtgc_par* P = m->par;
+  for (;;) {
+    vt_gc_obj* h;
+    for (;;) {
+      if ((h = vtgc_dq_take(&m->dq)) == NULL && (h = m->spill) != NULL) {
+        m->spill = h->next_gray;
+        h->next_gray = NULL;
+      }
+      if (!h) break;
+      vtgc_par_scan(m, h);
+    }
+    if ((h = vtgc_par_steal(m)) != NULL) {
+      vtgc_par_scan(m, h);
+      continue;
+    }
+    atomic_fetch_add(&P->idle, 1);
+    for (;;) {
+      if (atomic_load(&P->idle) == P->n) return 0;
+      int busy = 0;
+      for (unsigned k = 0; k < P->n && !busy; k++)
+        busy = vtgc_dq_nonempty(&P->m[k].dq);
+      if (busy) {
+        atomic_fetch_sub(&P->idle, 1);
+        break;
+      }
+      thrd_yield();
+    }
+  }
+}
+
+static void vtgc_par_free(vtgc_marker* m, unsigned n) {
+  for (unsigned i = 0; i < n; i++) {
+    vtgc_ring* r = atomic_load_explicit(&m[i].dq.ring, memory_order_relaxed);
+    while (r) {
+      vtgc_ring* p = r->prev;
+      free(r);
+      r = p;
+    }
+  }
+  free(m);
+}
+
+/* Marquage complet à gc->mark_threads marqueurs (le thread appelant est le
+   n° 0 et reçoit les racines). -1 sans mémoire: marquer en série. */
+static int vtgc_mark_parallel(vt_gc* gc) {
+  const unsigned n = gc->mark_threads;
+  vtgc_marker* m = (vtgc_marker*)calloc(n, sizeof *m);
+  thrd_t* th = (thrd_t*)calloc(n, sizeof *th);
+  unsigned char* up = (unsigned char*)calloc(n, 1);
+  if (!m || !th || !up) {
+    free(m);
+    free(th);
+    free(up);
+    return -1;
+  }
+  vtgc_par P = {.m = m, .n = n};
+  atomic_init(&P.idle, 0);
+  for (unsigned i = 0; i < n; i++) {
+    vtgc_ring* r = vtgc_ring_new(1024);
+    if (!r) {
+      vtgc_par_free(m, i);
+      free(th);
+      free(up);
+      return -1;
+    }
+    m[i].gc = gc;
+    m[i].par = &P;
+    m[i].seed = 0x9e3779b9u * (i + 1);
+    atomic_init(&m[i].dq.top, 0);
+    atomic_init(&m[i].dq.bottom, 0);
+    atomic_init(&m[i].dq.ring, r);
+  }
+  for (size_t i = 0; i < gc->roots.n; ++i) {
+    void** slot = gc->roots.v[i];
+    if (slot && *slot) vtgc_par_mark(&m[0], vtgc_hdr_from_ptr(*slot));
+  }
+  for (unsigned i = 1; i < n; i++) {
+    if (thrd_create(&th[i], vtgc_par_main, &m[i]) == thrd_success)
+      up[i] = 1;
+    else
+      atomic_fetch_add(&P.idle, 1); /* absent = inactif, deque vide */
+  }
+  vtgc_par_main(&m[0]);
+  uint64_t marked = 0;
+  for (unsigned i = 0; i < n; i++) {
+    if (up[i]) thrd_join(th[i], NULL);
+    marked += m[i].marked;
+  }
+  gc->st.marked_total += marked;
+  vtgc_par_free(m, n);
+  free(th);
+  free(up);
+  return 0;
+}
+#endif
+
 /* --------- Collect --------- */
 static void vtgc_mark_from_roots(vt_gc* gc) {
   /* 1) Marquer racines */
@@ -235,63 +731,427 @@ static void vtgc_mark_from_roots(vt_gc* gc) {
     vtgc_mark_hdr(gc, vtgc_hdr_from_ptr(*slot));
   }
   /* 2) Propager */
-  while (gc->gray) {
-    vt_gc_obj* h = gc->gray;
-    gc->gray = h->next_gray;
-    h->next_gray = NULL;
-    if (h->trace) {
-      h->trace(vtgc_ptr_from_hdr(h), vtgc_visit_child, gc);
-    }
+  uint64_t n = 0;
+  for (; gc->gray; n++) vtgc_scan(vtgc_pop_gray(gc), gc);
+  gc->st.marked_total += n;
+}
+
+/* Les anciens morts quittent le remembered set avant le sweep. */
+static void vtgc_remset_filter(vt_gc* gc) {
+  size_t k = 0;
+  for (size_t i = 0; i < gc->nrem; ++i) {
+    vt_gc_obj* h = gc->remset[i];
+    if (VTGC_LD(h->mark_epoch) == gc->epoch || VTGC_LD(h->pin) > 0)
+      gc->remset[k++] = h;
   }
+  gc->nrem = k;
+}
+
+static inline void vtgc_pause(uint64_t t0, uint64_t* max) {
+  const uint64_t dt = vtgc_now_ns() - t0;
+  if (dt > *max) *max = dt;
 }
 
 void vt_gc_collect(vt_gc* gc, const char* reason) {
   if (!gc) return;
   vtgc_lock(gc);
+  const uint64_t t0 = vtgc_now_ns();
+  vtgc_sweep_join(gc, 1);
+  /* Un cycle incrémental en cours est abandonné: la collecte complète
+     repart d’une époque neuve. */
+  while (gc->gray) vtgc_pop_gray(gc);
+  while (gc->dirty) {
+    vt_gc_obj* h = gc->dirty;
+    gc->dirty = h->next_gray;
+    h->next_gray = NULL;
+    h->flags &= ~VTGC_GRAY;
+  }
+  gc->phase = VTGC_IDLE;
+  gc->sweep_at = NULL;
   gc->epoch++;
   vtgc_log(gc, "INFO",
            "collect start (epoch=%u, reason=%s, objs=%zu, live=%zu)", gc->epoch,
            reason ? reason : "manual", gc->obj_count, gc->bytes_live);
-  vtgc_mark_from_roots(gc);
-  vtgc_sweep(gc);
+  const uint64_t tm = vtgc_now_ns();
+#if VTGC_HAS_THREADS
+  if (gc->mark_threads < 2 || vtgc_mark_parallel(gc) != 0)
+#endif
+    vtgc_mark_from_roots(gc);
+  gc->st.mark_ns_total += vtgc_now_ns() - tm;
+  vtgc_remset_filter(gc);
+#if VTGC_HAS_THREADS
+  if (!gc->bg_sweep || vtgc_sweep_start(gc) != 0)
+#endif
+    vtgc_sweep(gc);
   gc->bytes_since_gc = 0;
+  gc->st.cycles++;
+  vtgc_pause(t0, &gc->st.stw_ns_max);
   vtgc_log(gc, "INFO", "collect end   (objs=%zu, live=%zu)", gc->obj_count,
            gc->bytes_live);
   vtgc_unlock(gc);
 }
 
+/* --------- Cycle incrémental --------- */
+static void vtgc_cycle_start(vt_gc* gc, const char* reason) {
+  vtgc_lock(gc);
+  vtgc_sweep_join(gc, 1); /* le sweep paresseux parcourt gc->all */
+  gc->epoch++;
+  gc->phase = VTGC_MARK;
+  gc->bytes_since_gc = 0;
+  gc->debt = 0;
+  gc->debt_objs = 0;
+  vtgc_log(gc, "INFO", "cycle start (epoch=%u, reason=%s, objs=%zu, live=%zu)",
+           gc->epoch, reason, gc->obj_count, gc->bytes_live);
+  for (size_t i = 0; i < gc->roots.n; ++i) {
+    void** slot = gc->roots.v[i];
+    if (slot) vtgc_mark_hdr(gc, vtgc_hdr_from_ptr(*slot));
+  }
+  vtgc_unlock(gc);
+}
+
+/* Fin de marquage, atomique: racines (non protégées par la barrière),
+   anciens du remembered set (seuls à pointer vers des jeunes) et jeunes
+   atteignables sont parcourus jusqu’à vider la pile grise. */
+static void vtgc_remark(vt_gc* gc) {
+  const uint64_t t0 = vtgc_now_ns();
+  gc->remark = 1;
+  while (gc->dirty) { /* déjà marqués GRAY */
+    vt_gc_obj* h = gc->dirty;
+    gc->dirty = h->next_gray;
+    h->next_gray = gc->gray;
+    gc->gray = h;
+  }
+  for (size_t i = 0; i < gc->roots.n; ++i) {
+    void** slot = gc->roots.v[i];
+    if (slot && *slot) vtgc_regray(gc, vtgc_hdr_from_ptr(*slot));
+  }
+  if (gc->rem_overflow) {
+    for (vt_gc_obj* h = gc->all; h; h = h->next_all)
+      if (VTGC_LD(h->mark_epoch) == gc->epoch) vtgc_regray(gc, h);
+  } else {
+    for (size_t i = 0; i < gc->nrem; ++i)
+      if (VTGC_LD(gc->remset[i]->mark_epoch) == gc->epoch)
+        vtgc_regray(gc, gc->remset[i]);
+  }
+  while (gc->gray) vtgc_scan(vtgc_pop_gray(gc), gc);
+  gc->remark = 0;
+  vtgc_remset_filter(gc);
+  gc->phase = VTGC_SWEEP;
+  gc->sweep_at = &gc->all;
+  vtgc_pause(t0, &gc->st.remark_ns_max);
+}
+
+/* Sweep paresseux: les objets créés depuis la remarque sont insérés en tête
+   (derrière le curseur) et portent l’époque courante. */
+static size_t vtgc_sweep_some(vt_gc* gc, size_t budget) {
+  size_t n = 0;
+  while (*gc->sweep_at && n < budget) {
+    vt_gc_obj* cur = *gc->sweep_at;
+    n++;
+    if (VTGC_LD(cur->mark_epoch) == gc->epoch || VTGC_LD(cur->pin) > 0) {
+      gc->sweep_at = &cur->next_all;
+      continue;
+    }
+    *gc->sweep_at = cur->next_all;
+    if (cur->fin) cur->fin(vtgc_ptr_from_hdr(cur));
+    gc->bytes_live -= cur->size;
+    gc->obj_count -= 1;
+    free(cur);
+  }
+  if (!*gc->sweep_at) {
+    gc->phase = VTGC_IDLE;
+    gc->sweep_at = NULL;
+    gc->st.cycles++;
+    vtgc_rearm(gc);
+    vtgc_log(gc, "INFO", "cycle end   (objs=%zu, live=%zu)", gc->obj_count,
+             gc->bytes_live);
+  }
+  return n;
+}
+
+/* Une tranche: VTGC_STEPMUL unités par objet alloué depuis la précédente
+   (au moins slice_work), et au plus slice_ns si fixé (horloge lue tous les
+   32 objets). */
+static void vtgc_step(vt_gc* gc) {
+  vtgc_lock(gc);
+  const uint64_t t0 = vtgc_now_ns();
+  size_t work = 0, budget = gc->debt_objs * VTGC_STEPMUL;
+  if (budget < gc->slice_work) budget = gc->slice_work;
+  gc->debt = 0;
+  gc->debt_objs = 0;
+  while (gc->phase != VTGC_IDLE && work < budget) {
+    if (gc->phase == VTGC_MARK) {
+      if (!gc->gray) {
+        vtgc_remark(gc);
+        continue;
+      }
+      vtgc_scan(vtgc_pop_gray(gc), gc);
+      work++;
+    } else {
+      work += vtgc_sweep_some(gc, 32);
+    }
+    if (gc->slice_ns && (work & 31) == 0 && vtgc_now_ns() - t0 >= gc->slice_ns)
+      break;
+  }
+  const uint64_t dt = vtgc_now_ns() - t0;
+  gc->st.slices++;
+  gc->st.slice_ns_total += dt;
+  if (dt > gc->st.slice_ns_max) gc->st.slice_ns_max = dt;
+  vtgc_unlock(gc);
+}
+
+/* Paiement de l’allocation: une tranche tous les slice_bytes alloués. */
+static inline void vtgc_pay(vt_gc* gc, size_t bytes) {
+  if (gc->phase == VTGC_IDLE) return;
+  gc->debt += bytes;
+  gc->debt_objs++;
+  if (gc->debt >= gc->slice_bytes) vtgc_step(gc);
+}
+
 /* --------- Politique de GC --------- */
 static void vtgc_maybe_collect(vt_gc* gc, size_t just_alloc) {
   gc->bytes_since_gc += just_alloc;
-  const size_t limit =
-      gc->heap_limit ? gc->heap_limit : (8u << 20); /* 8 MiB par défaut */
+  vtgc_sweep_join(gc, 0);
+  const size_t limit = gc->next_gc;
+  if (gc->phase != VTGC_IDLE) {
+    /* cycle distancé par l’allocation: on le remplace par une collecte
+       complète plutôt que de laisser le tas croître */
+    if (gc->bytes_live / VTGC_OVERSHOOT > limit)
+      vt_gc_collect(gc, "incremental_overshoot");
+    return;
+  }
   if (gc->bytes_live > limit || gc->bytes_since_gc > limit / 2) {
-    vt_gc_collect(
-        gc, gc->bytes_live > limit ? "heap_limit" : "allocation_pressure");
+    const char* why =
+        gc->bytes_live > limit ? "heap_limit" : "allocation_pressure";
+    if (gc->incremental)
+      vtgc_cycle_start(gc, why);
+    else
+      vt_gc_collect(gc, why);
   }
 }
 
+/* --------- Génération jeune --------- */
+static inline size_t vtgc_round(size_t n) {
+  const size_t a = alignof(VT_MAX_ALIGN);
+  return (n + a - 1) & ~(a - 1);
+}
+
+static void vtgc_remember(vt_gc* gc, vt_gc_obj* h) {
+  if (gc->nrem == gc->rem_cap) {
+    size_t ncap = gc->rem_cap ? gc->rem_cap * 2 : 256;
+    vt_gc_obj** nv =
+        (vt_gc_obj**)realloc(gc->remset, ncap * sizeof(vt_gc_obj*));
+    if (!nv) {
+      gc->rem_overflow = 1;
+      return;
+    }
+    gc->remset = nv;
+    gc->rem_cap = ncap;
+  }
+  h->flags |= VTGC_REMEMBERED;
+  gc->remset[gc->nrem++] = h;
+}
+
+/* move de la mineure: copie un jeune dans l’espace ancien (une fois), laisse
+   l’adresse de la copie dans l’original et la met en file de scan. */
+static void* vtgc_evacuate(void* child, void* ctx) {
+  vt_gc* gc = (vt_gc*)ctx;
+  vt_gc_obj* h = vtgc_hdr_from_ptr(child);
+  if (!h || !(h->flags & VTGC_YOUNG)) return child;
+  if (h->flags & VTGC_FORWARDED) return vtgc_ptr_from_hdr(h->next_all);
+  const size_t total = sizeof(vt_gc_obj) + h->size;
+  vt_gc_obj* n = (vt_gc_obj*)malloc(total);
+  if (!n) {
+    /* Impossible de laisser la nursery à moitié évacuée. */
+    fprintf(stderr, "vt_gc: promotion impossible (%zu octets)\n", h->size);
+    abort();
+  }
+  memcpy(n, h, total);
+  n->flags = 0;
+  n->next_all = gc->all;
+  gc->all = n;
+  n->next_gray = gc->scan;
+  gc->scan = n;
+  h->flags |= VTGC_FORWARDED;
+  h->next_all = n;
+  gc->bytes_live += n->size;
+  gc->obj_count += 1;
+  gc->bytes_since_gc += n->size;
+  return vtgc_ptr_from_hdr(n);
+}
+
+static inline void vtgc_rescan(vt_gc* gc, vt_gc_obj* h) {
+  if (h->update) h->update(vtgc_ptr_from_hdr(h), vtgc_evacuate, gc);
+}
+
+static void vtgc_minor(vt_gc* gc) {
+  const uint64_t t0 = vtgc_now_ns();
+  const size_t young = gc->young_count, live0 = gc->bytes_live;
+  gc->in_minor = 1;
+  /* 1) Racines: évacuer la cible, ou la revisiter si elle est ancienne */
+  for (size_t i = 0; i < gc->roots.n; ++i) {
+    void** slot = gc->roots.v[i];
+    if (!slot || !*slot) continue;
+    vt_gc_obj* h = vtgc_hdr_from_ptr(*slot);
+    if (h->flags & VTGC_YOUNG)
+      *slot = vtgc_evacuate(*slot, gc);
+    else
+      vtgc_rescan(gc, h);
+  }
+  /* 2) Anciens mémorisés (ou tout l’ancien si le set a débordé) */
+  if (gc->rem_overflow) {
+    vtgc_sweep_join(gc, 1); /* les anciens vivants sont peut-être détachés */
+    for (vt_gc_obj* h = gc->all; h; h = h->next_all) {
+      h->flags &= ~VTGC_REMEMBERED;
+      /* sweep paresseux en cours: un mort peut désigner un objet libéré */
+      if (gc->phase == VTGC_SWEEP && VTGC_LD(h->mark_epoch) != gc->epoch &&
+          !VTGC_LD(h->pin))
+        continue;
+      vtgc_rescan(gc, h);
+    }
+    gc->rem_overflow = 0;
+  } else {
+    for (size_t i = 0; i < gc->nrem; ++i) {
+      gc->remset[i]->flags &= ~VTGC_REMEMBERED;
+      vtgc_rescan(gc, gc->remset[i]);
+    }
+  }
+  gc->nrem = 0;
+  /* 3) Propager dans les promus. Pendant un cycle incrémental ils sont
+     vivants pour ce cycle: gris en marquage (enfants anciens peut-être
+     blancs), marqués en sweep. */
+  while (gc->scan) {
+    vt_gc_obj* h = gc->scan;
+    gc->scan = h->next_gray;
+    h->next_gray = NULL;
+    vtgc_rescan(gc, h);
+    if (gc->phase == VTGC_MARK)
+      vtgc_regray(gc, h);
+    else
+      VTGC_ST(h->mark_epoch, gc->epoch);
+  }
+  /* 4) Finaliser les morts, vider la nursery */
+  for (size_t off = 0; off < gc->nursery_top;) {
+    vt_gc_obj* h = (vt_gc_obj*)(gc->nursery + off);
+    off += vtgc_round(sizeof(vt_gc_obj) + h->size);
+    if (!(h->flags & VTGC_FORWARDED) && h->fin) h->fin(vtgc_ptr_from_hdr(h));
+  }
+  gc->nursery_top = 0;
+  gc->young_bytes = 0;
+  gc->young_count = 0;
+  gc->minor_pending = 0;
+  gc->in_minor = 0;
+  gc->minor_count++;
+  vtgc_pause(t0, &gc->st.minor_ns_max);
+  vtgc_log(gc, "INFO", "minor #%zu (young=%zu, promoted=%zuB)",
+           gc->minor_count, young, gc->bytes_live - live0);
+}
+
+static void* vtgc_alloc_old(vt_gc* gc, size_t size, vt_gc_trace_fn trace,
+                            vt_gc_update_fn update, vt_gc_finalizer fin,
+                            uint32_t tag);
+
+void* vt_gc_alloc_young(vt_gc* gc, size_t size, vt_gc_update_fn update,
+                        vt_gc_finalizer fin, uint32_t tag) {
+  if (!gc || size == 0) return NULL;
+  if (!gc->nursery) return vtgc_alloc_old(gc, size, NULL, update, fin, tag);
+  const size_t total = vtgc_round(sizeof(vt_gc_obj) + size);
+  /* Les gros objets (> 1/8 de nursery) vont directement dans l’ancien. */
+  const int large = total > gc->nursery_size / 8;
+  if (!large && total <= gc->nursery_size - gc->nursery_top) {
+    vtgc_pay(gc, total); /* ne déplace rien: sans danger hors point sûr */
+    vt_gc_obj* h = (vt_gc_obj*)(gc->nursery + gc->nursery_top);
+    gc->nursery_top += total;
+    h->next_all = NULL;
+    h->next_gray = NULL;
+    h->size = size;
+    h->tag = tag;
+    VTGC_ST(h->pin, 0);
+    VTGC_ST(h->mark_epoch, 0);
+    h->flags = VTGC_YOUNG;
+    h->trace = NULL;
+    h->update = update;
+    h->fin = fin;
+    gc->young_bytes += size;
+    gc->young_count += 1;
+    return vtgc_ptr_from_hdr(h);
+  }
+  if (!large) gc->minor_pending = 1;
+  void* p = vtgc_alloc_old(gc, size, NULL, update, fin, tag);
+  /* L’appelant l’initialise comme un objet jeune, sans barrière. */
+  if (p) vtgc_remember(gc, vtgc_hdr_from_ptr(p));
+  return p;
+}
+
+void vt_gc_write_barrier(vt_gc* gc, void* obj) {
+  if (!gc || !obj) return;
+  vt_gc_obj* h = vtgc_hdr_from_ptr(obj);
+  if (h->flags & VTGC_YOUNG) return;
+  /* Steele: un noir modifié redevient gris (le nouvel enfant est peut-être
+     blanc). Rescan différé à la remarque: un objet réécrit sans cesse (pile
+     de tableau) ne relance pas le marquage à chaque tranche. */
+  if (gc->phase == VTGC_MARK && VTGC_LD(h->mark_epoch) == gc->epoch &&
+      !(h->flags & VTGC_GRAY)) {
+    h->flags |= VTGC_GRAY;
+    h->next_gray = gc->dirty;
+    gc->dirty = h;
+  }
+  if (gc->nursery && !(h->flags & VTGC_REMEMBERED)) vtgc_remember(gc, h);
+}
+
+/* ctx: vt_gc (mineure) ou vtgc_marker, qui commencent tous deux par
+   in_minor. */
+int vt_gc_is_minor(void* ctx) { return ctx && *(const int*)ctx; }
+
+int vt_gc_safepoint(vt_gc* gc) {
+  if (!gc || !gc->minor_pending) return 0;
+  vtgc_lock(gc);
+  vtgc_minor(gc);
+  vtgc_unlock(gc);
+  /* les promotions comptent dans la pression de l’espace ancien */
+  vtgc_maybe_collect(gc, 0);
+  return 1;
+}
+
 /* --------- API publique --------- */
 vt_gc* vt_gc_create(const vt_gc_config* cfg) {
   vt_gc* gc = (vt_gc*)calloc(1, sizeof *gc);
   if (!gc) return NULL;
   gc->heap_limit =
       (cfg && cfg->heap_limit_bytes) ? cfg->heap_limit_bytes : (8u << 20);
+  gc->next_gc = gc->heap_limit;
   gc->logging = (cfg && cfg->enable_logging) ? 1 : 0;
   gc->epoch = 1; /* éviter zéro */
+  gc->incremental = (cfg && cfg->incremental) ? 1 : 0;
+  gc->slice_work = (cfg && cfg->slice_work) ? cfg->slice_work : 1024;
+  gc->slice_bytes = (cfg && cfg->slice_bytes) ? cfg->slice_bytes : (64u << 10);
+  gc->slice_ns = cfg ? (uint64_t)cfg->slice_us * 1000u : 0;
+  gc->mark_threads = cfg ? cfg->mark_threads : 0;
+  gc->bg_sweep = (cfg && cfg->concurrent_sweep) ? 1 : 0;
+  if (cfg && cfg->nursery_bytes) {
+    gc->nursery_size = vtgc_round(cfg->nursery_bytes);
+    gc->nursery = (uint8_t*)malloc(gc->nursery_size);
+    if (!gc->nursery) {
+      free(gc);
+      return NULL;
+    }
+  }
 #if VTGC_HAS_THREADS
   if (mtx_init(&gc->lock, mtx_plain) != thrd_success) {
+    free(gc->nursery);
     free(gc);
     return NULL;
   }
 #endif
-  vtgc_log(gc, "INFO", "gc created (limit=%zu)", gc->heap_limit);
+  vtgc_log(gc, "INFO", "gc created (limit=%zu, nursery=%zu)", gc->heap_limit,
+           gc->nursery_size);
   return gc;
 }
 
 void vt_gc_destroy(vt_gc* gc) {
   if (!gc) return;
   vtgc_lock(gc);
+  vtgc_sweep_join(gc, 1);
   /* libère tout sans marquage */
   vt_gc_obj* cur = gc->all;
   while (cur) {
@@ -300,6 +1160,13 @@ void vt_gc_destroy(vt_gc* gc) {
     free(cur);
     cur = next;
   }
+  for (size_t off = 0; off < gc->nursery_top;) {
+    vt_gc_obj* h = (vt_gc_obj*)(gc->nursery + off);
+    off += vtgc_round(sizeof(vt_gc_obj) + h->size);
+    if (!(h->flags & VTGC_FORWARDED) && h->fin) h->fin(vtgc_ptr_from_hdr(h));
+  }
+  free(gc->nursery);
+  free(gc->remset);
   free(gc->roots.v);
   vtgc_unlock(gc);
 #if VTGC_HAS_THREADS
@@ -312,6 +1179,16 @@ void vt_gc_destroy(vt_gc* gc) {
 void* vt_gc_alloc(vt_gc* gc, size_t size, vt_gc_trace_fn trace,
                   vt_gc_finalizer fin, uint32_t tag) {
   if (!gc || size == 0) return NULL;
+  return vtgc_alloc_old(gc, size, trace, NULL, fin, tag);
+}
+
+static void* vtgc_alloc_old(vt_gc* gc, size_t size, vt_gc_trace_fn trace,
+                            vt_gc_update_fn update, vt_gc_finalizer fin,
+                            uint32_t tag) {
+  /* Collecte *avant* l’allocation: le nouvel objet n’est pas encore atteignable
+     depuis les racines et serait libéré par un sweep immédiat. */
+  vtgc_maybe_collect(gc, size);
+  vtgc_pay(gc, size);
   /* on s’assure d’un header aligné pour payload */
   size_t total = sizeof(vt_gc_obj) + size;
   vt_gc_obj* h = (vt_gc_obj*)malloc(total);
@@ -322,9 +1199,13 @@ void* vt_gc_alloc(vt_gc* gc, size_t size, vt_gc_trace_fn trace,
   h->next_gray = NULL;
   h->size = size;
   h->tag = tag;
-  h->pin = 0;
-  h->mark_epoch = 0; /* pas marqué */
+  VTGC_ST(h->pin, 0);
+  /* blanc en marquage (atteint par racines/barrière s’il vit), marqué en
+     sweep paresseux (inséré derrière le curseur) */
+  VTGC_ST(h->mark_epoch, gc->phase == VTGC_SWEEP ? gc->epoch : 0);
+  h->flags = 0;
   h->trace = trace;
+  h->update = update;
   h->fin = fin;
 
   void* p = vtgc_ptr_from_hdr(h);
@@ -333,8 +1214,6 @@ void* vt_gc_alloc(vt_gc* gc, size_t size, vt_gc_trace_fn trace,
   gc->bytes_live += size;
   gc->obj_count += 1;
   vtgc_unlock(gc);
-
-  vtgc_maybe_collect(gc, size);
   return p;
 }
 
@@ -362,23 +1241,47 @@ void vt_gc_remove_root(vt_gc* gc, void** slot) {
 void vt_gc_pin(void* obj) {
   vt_gc_obj* h = vtgc_hdr_from_ptr(obj);
   if (!h) return;
-  h->pin++;
+  assert(!(h->flags & VTGC_YOUNG) && "vt_gc_pin: objet jeune");
+  VTGC_ST(h->pin, VTGC_LD(h->pin) + 1); /* écrit par le seul mutateur */
 }
 void vt_gc_unpin(void* obj) {
   vt_gc_obj* h = vtgc_hdr_from_ptr(obj);
   if (!h) return;
-  if (h->pin > 0) h->pin--;
+  const uint32_t n = VTGC_LD(h->pin);
+  if (n > 0) VTGC_ST(h->pin, n - 1);
 }
 
 void vt_gc_set_limit(vt_gc* gc, size_t bytes) {
   if (!gc) return;
   vtgc_lock(gc);
-  gc->heap_limit = bytes;
+  gc->heap_limit = bytes ? bytes : (8u << 20);
+  vtgc_rearm(gc);
   vtgc_unlock(gc);
 }
 
-size_t vt_gc_bytes_live(vt_gc* gc) { return gc ? gc->bytes_live : 0; }
-size_t vt_gc_object_count(vt_gc* gc) { return gc ? gc->obj_count : 0; }
+void vt_gc_get_stats(vt_gc* gc, vt_gc_stats* out) {
+  if (!out) return;
+  memset(out, 0, sizeof *out);
+  if (!gc) return;
+  vtgc_lock(gc);
+  vtgc_sweep_join(gc, 0);
+  *out = gc->st;
+  out->bytes_live = gc->bytes_live + gc->young_bytes;
+  out->object_count = gc->obj_count + gc->young_count;
+  out->minors = gc->minor_count;
+  out->phase = gc->phase;
+#if VTGC_HAS_THREADS
+  out->sweeping = gc->sweeping;
+#endif
+  vtgc_unlock(gc);
+}
+
+size_t vt_gc_bytes_live(vt_gc* gc) {
+  return gc ? gc->bytes_live + gc->young_bytes : 0;
+}
+size_t vt_gc_object_count(vt_gc* gc) {
+  return gc ? gc->obj_count + gc->young_count : 0;
+}
 
 uint32_t vt_gc_tag_of(const void* obj) {
   const vt_gc_obj* h = vtgc_hdr_from_ptr(obj);
@@ -393,14 +1296,22 @@ void vt_gc_set_tag(void* obj, uint32_t tag) {
 void vt_gc_dump(vt_gc* gc, FILE* out) {
   if (!gc) return;
   if (!out) out = stderr;
-  fprintf(out, "GC dump: objs=%zu live=%zuB epoch=%u roots=%zu limit=%zuB\n",
+  vtgc_sweep_join(gc, 1);
+  fprintf(out,
+          "GC dump: objs=%zu live=%zuB epoch=%u roots=%zu limit=%zuB "
+          "phase=%d\n",
           gc->obj_count, gc->bytes_live, gc->epoch, gc->roots.n,
-          gc->heap_limit);
+          gc->heap_limit, gc->phase);
+  if (gc->nursery)
+    fprintf(out,
+            "  nursery: %zu/%zuB young=%zu remembered=%zu minors=%zu\n",
+            gc->nursery_top, gc->nursery_size, gc->young_count, gc->nrem,
+            gc->minor_count);
   size_t i = 0;
   for (vt_gc_obj* h = gc->all; h; h = h->next_all, ++i) {
     fprintf(out, "  #%zu obj=%p size=%zu tag=%u pin=%u mark=%u\n", i,
-            (void*)vtgc_ptr_from_hdr(h), h->size, h->tag, h->pin,
-            h->mark_epoch);
+            (void*)vtgc_ptr_from_hdr(h), h->size, h->tag, VTGC_LD(h->pin),
+            VTGC_LD(h->mark_epoch));
   }
 }
 
@@ -415,3 +1326,197 @@ void vt_gc_dump(vt_gc* gc, FILE* out) {
    }
    Node* n = (Node*)vt_gc_alloc(gc, sizeof(Node), node_trace, NULL, 0);
    ------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------------
+   Test: cc -std=c17 -O2 -DVT_GC_TEST gc.c -lpthread && ./a.out
+   Déchets en masse sous le mode incrémental (tranches libres, plafonnées
+   en µs, avec nursery): bytes_live doit rester borné et la liste enracinée
+   intacte.
+---------------------------------------------------------------------------- */
+#ifdef VT_GC_TEST
+typedef struct gt_node {
+  struct gt_node* next;
+  uint64_t v;
+} gt_node;
+
+static void gt_trace(void* obj, vt_gc_visit_fn visit, void* ctx) {
+  visit(((gt_node*)obj)->next, ctx);
+}
+
+static void gt_update(void* obj, vt_gc_move_fn move, void* ctx) {
+  gt_node* n = (gt_node*)obj;
+  n->next = (gt_node*)move(n->next, ctx);
+}
+
+#define GT_CHECK(c)                                                   \
+  do {                                                                \
+    if (!(c)) {                                                       \
+      fprintf(stderr, "%s:%d: échec: %s\n", __FILE__, __LINE__, #c); \
+      exit(1);                                                        \
+    }                                                                 \
+  } while (0)
+
+static void gt_garbage(uint32_t slice_us, size_t nursery) {
+  enum { KEEP = 1000, N = 4000000 };
+  const size_t limit = 1u << 20;
+  vt_gc_config cfg = {0};
+  cfg.heap_limit_bytes = limit;
+  cfg.incremental = 1;
+  cfg.slice_us = slice_us;
+  cfg.nursery_bytes = nursery;
+  vt_gc* gc = vt_gc_create(&cfg);
+  GT_CHECK(gc);
+  void* root = NULL;
+  vt_gc_add_root(gc, &root);
+  for (int i = 0; i < KEEP; i++) {
+    gt_node* n = (gt_node*)vt_gc_alloc(gc, sizeof *n, gt_trace, NULL, 1);
+    GT_CHECK(n);
+    n->next = (gt_node*)root;
+    n->v = (uint64_t)i;
+    root = n;
+  }
+  size_t peak = 0;
+  for (size_t i = 0; i < N; i++) {
+    gt_node* g = nursery
+                     ? (gt_node*)vt_gc_alloc_young(gc, 16, gt_update, NULL, 2)
+                     : (gt_node*)vt_gc_alloc(gc, 16, gt_trace, NULL, 2);
+    GT_CHECK(g);
+    g->next = NULL;
+    if (nursery) vt_gc_safepoint(gc);
+    const size_t live = vt_gc_bytes_live(gc);
+    if (live > peak) peak = live;
+  }
+  vt_gc_stats st;
+  vt_gc_get_stats(gc, &st);
+  printf("  slice_us=%u nursery=%zu: pic %zu Kio, %llu cycles, %llu tranches\n",
+         slice_us, nursery, peak >> 10, (unsigned long long)st.cycles,
+         (unsigned long long)st.slices);
+  GT_CHECK(nursery ? st.minors > 0 : st.cycles > 0);
+  GT_CHECK(peak <= VTGC_OVERSHOOT * limit + (64u << 10));
+  size_t k = 0;
+  uint64_t want = KEEP;
+  for (gt_node* n = (gt_node*)root; n; n = n->next, k++)
+    GT_CHECK(n->v == --want);
+  GT_CHECK(k == KEEP);
+  vt_gc_destroy(gc);
+}
+
+/* Tas vivant bien au-delà de la limite: le seuil suit les survivants, le
+   nombre de cycles reste logarithmique au lieu d’un par allocation. */
+static void gt_retain(size_t nursery) {
+  enum { N = 1000000 }; /* ~16 Mio de payload gardé */
+  vt_gc_config cfg = {0};
+  cfg.heap_limit_bytes = 1u << 20;
+  cfg.nursery_bytes = nursery;
+  vt_gc* gc = vt_gc_create(&cfg);
+  GT_CHECK(gc);
+  void* root = NULL;
+  vt_gc_add_root(gc, &root);
+  for (size_t i = 0; i < N; i++) {
+    gt_node* n = nursery
+                     ? (gt_node*)vt_gc_alloc_young(gc, sizeof *n, gt_update,
+                                                   NULL, 1)
+                     : (gt_node*)vt_gc_alloc(gc, sizeof *n, gt_trace, NULL, 1);
+    GT_CHECK(n);
+    n->next = (gt_node*)root;
+    n->v = (uint64_t)i;
+    root = n;
+    if (nursery) vt_gc_safepoint(gc);
+  }
+  vt_gc_stats st;
+  vt_gc_get_stats(gc, &st);
+  printf("  nursery=%zu: %zu Kio gardés, %llu cycles\n", nursery,
+         vt_gc_bytes_live(gc) >> 10, (unsigned long long)st.cycles);
+  GT_CHECK(st.cycles > 0 && st.cycles < 32);
+  size_t k = 0;
+  for (gt_node* n = (gt_node*)root; n; n = n->next) k++;
+  GT_CHECK(k == N);
+  vt_gc_destroy(gc);
+}
+
+int main(void) {
+  puts("tas vivant de 16 Mio, limite 1 Mio:");
+  gt_retain(0);
+  gt_retain(256u << 10);
+  puts("GC incrémental, 4M déchets de 16 o, limite 1 Mio:");
+  gt_garbage(0, 0);
+  gt_garbage(1, 0);
+  gt_garbage(0, 256u << 10);
+  puts("gc: OK");
+  return 0;
+}
+#endif /* VT_GC_TEST */
+
+/* ----------------------------------------------------------------------------
+   Bench: cc -std=c17 -O2 -DVT_GC_BENCH gc.c -lpthread && ./a.out [nœuds]
+   Graphe de nœuds à 4 enfants (arbre + arêtes aléatoires) plus un tiers de
+   déchets; débit du marquage et du sweep par nombre de marqueurs.
+---------------------------------------------------------------------------- */
+#ifdef VT_GC_BENCH
+typedef struct gb_node {
+  struct gb_node* kid[4];
+  uint64_t v;
+} gb_node;
+
+static void gb_trace(void* obj, vt_gc_visit_fn visit, void* ctx) {
+  gb_node* n = (gb_node*)obj;
+  for (int i = 0; i < 4; i++) visit(n->kid[i], ctx);
+}
+
+static void gb_run(size_t n, unsigned threads, int bg) {
+  vt_gc_config cfg = {0};
+  cfg.heap_limit_bytes = SIZE_MAX / 4; /* pas de collecte pendant la
+                                          construction */
+  cfg.mark_threads = threads;
+  cfg.concurrent_sweep = bg;
+  vt_gc* gc = vt_gc_create(&cfg);
+  gb_node** v = (gb_node**)malloc(n * sizeof *v);
+  if (!gc || !v) {
+    fprintf(stderr, "gb: mémoire\n");
+    exit(1);
+  }
+  uint64_t x = 88172645463325252u;
+  for (size_t i = 0; i < n; i++) {
+    v[i] = (gb_node*)vt_gc_alloc(gc, sizeof(gb_node), gb_trace, NULL, 1);
+    memset(v[i], 0, sizeof(gb_node));
+    if (i % 2 == 0) (void)vt_gc_alloc(gc, sizeof(gb_node), NULL, NULL, 2);
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (2 * i + 1 < n) v[i]->kid[0] = v[2 * i + 1];
+    if (2 * i + 2 < n) v[i]->kid[1] = v[2 * i + 2];
+    for (int k = 2; k < 4; k++) {
+      x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+      v[i]->kid[k] = v[x % n];
+    }
+  }
+  void* root = v[0];
+  free(v);
+  vt_gc_add_root(gc, &root);
+  vt_gc_collect(gc, "bench");
+  vt_gc_stats st;
+  vt_gc_get_stats(gc, &st);
+  const uint64_t pause = st.stw_ns_max;
+#if VTGC_HAS_THREADS
+  while (st.sweeping) {
+    thrd_yield();
+    vt_gc_get_stats(gc, &st);
+  }
+#endif
+  printf("  %u marqueur(s)%s  pause %7.2f ms  marquage %7.2f ms "
+         "%6.1f Mobj/s  sweep %7.2f ms %6.1f Mobj/s\n",
+         threads, bg ? ", sweep de fond" : "               ",
+         (double)pause * 1e-6, (double)st.mark_ns_total * 1e-6,
+         (double)st.marked_total * 1e3 / (double)st.mark_ns_total,
+         (double)st.sweep_ns_total * 1e-6,
+         (double)st.swept_total * 1e3 / (double)st.sweep_ns_total);
+  vt_gc_destroy(gc);
+}
+
+int main(int argc, char** argv) {
+  const size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 2000000u;
+  printf("GC, %zu nœuds (+%zu déchets):\n", n, (n + 1) / 2);
+  gb_run(n, 1, 0);
+  for (unsigned t = 1; t <= 8; t *= 2) gb_run(n, t, 1);
+  return 0;
+}
+#endif /* VT_GC_BENCH */
@@ -1,5 +1,12 @@
 /* ============================================================================
    gc.h — Collecteur mark-sweep précis avec racines explicites (C17).
+   Génération jeune optionnelle: nursery à pointeur de bump, collectes
+   mineures par copie (promotion dans l’espace mark-sweep), remembered set
+   alimenté par vt_gc_write_barrier.
+   Mode incrémental optionnel: marquage tricolore par tranches bornées,
+   sweep paresseux, pauses mesurées (vt_gc_stats).
+   Collectes complètes parallèles optionnelles: marquage à N threads (vol de
+   travail), sweep sur un thread de fond.
    S’associe à gc.c. Licence: MIT.
    ============================================================================
  */
@@ -30,12 +37,54 @@ typedef void (*vt_gc_visit_fn)(void* child, void* ctx);
 typedef void (*vt_gc_trace_fn)(void* obj, vt_gc_visit_fn visit, void* ctx);
 typedef void (*vt_gc_finalizer)(void* obj);
 
+/* Objets déplaçables (génération jeune)
+   - update(obj, move, ctx) doit remplacer chaque pointeur enfant géré p par
+   move(p, ctx). Sert au marquage (move rend p) comme à l’évacuation de la
+   nursery (move rend la nouvelle adresse).
+   - Un objet alloué avec un simple trace ne doit jamais pointer vers un objet
+   jeune: ses champs ne seraient pas mis à jour. */
+typedef void* (*vt_gc_move_fn)(void* child, void* ctx);
+typedef void (*vt_gc_update_fn)(void* obj, vt_gc_move_fn move, void* ctx);
+
+/* Dans un update: 1 si ctx vient d’une collecte mineure. Seuls les champs
+   écrits depuis la mineure précédente peuvent alors désigner un jeune: un
+   objet peut limiter son parcours à ceux-là (cartes, zone modifiée). */
+VT_GC_API int vt_gc_is_minor(void* ctx);
+
 /* Configuration runtime */
 typedef struct {
-  size_t heap_limit_bytes; /* 0 = valeur par défaut (8 MiB) */
+  size_t heap_limit_bytes; /* seuil plancher, 0 = 8 MiB; après un cycle le
+                              seuil est max(limite, 2 × octets vivants) */
   int enable_logging;      /* 1 = logs sur stderr */
+  size_t nursery_bytes;    /* 0 = pas de génération jeune */
+  int incremental;         /* 1 = marquage incrémental + sweep paresseux */
+  size_t slice_work;       /* objets par tranche (0 = 1024) */
+  uint32_t slice_us;       /* plafond de durée d’une tranche (0 = aucun);
+                              un objet n’est jamais parcouru à moitié */
+  size_t slice_bytes;      /* octets alloués par tranche (0 = 64 Kio) */
+  unsigned mark_threads;   /* >1: vt_gc_collect marque à N threads */
+  int concurrent_sweep;    /* 1: sweep de vt_gc_collect sur un thread de
+                              fond, pendant que le mutateur reprend */
 } vt_gc_config;
 
+/* Statistiques cumulées (durées en ns, horloge murale) */
+typedef struct {
+  size_t bytes_live, object_count;
+  uint64_t cycles;       /* collectes complètes terminées */
+  uint64_t minors;       /* collectes mineures */
+  uint64_t slices;       /* tranches incrémentales (marquage + sweep) */
+  uint64_t slice_ns_total, slice_ns_max;
+  uint64_t remark_ns_max; /* remarque atomique de fin de marquage */
+  uint64_t stw_ns_max;    /* vt_gc_collect complet */
+  uint64_t minor_ns_max;
+  /* Collectes complètes: durée cumulée et objets parcourus (débit) */
+  uint64_t mark_ns_total, marked_total;
+  uint64_t sweep_ns_total, swept_total; /* sweep de fond compté une fois
+                                           raccordé */
+  int phase;              /* 0 repos, 1 marquage, 2 sweep */
+  int sweeping;           /* sweep de fond en cours */
+} vt_gc_stats;
+
 /* Cycle de vie du GC */
 VT_GC_API vt_gc* vt_gc_create(const vt_gc_config* cfg);
 VT_GC_API void vt_gc_destroy(vt_gc* gc);
@@ -48,12 +97,43 @@ VT_GC_API void vt_gc_destroy(vt_gc* gc);
 VT_GC_API void* vt_gc_alloc(vt_gc* gc, size_t size, vt_gc_trace_fn trace,
                             vt_gc_finalizer fin, uint32_t tag);
 
-/* Déclenche un GC complet (raison libre, peut être NULL) */
+/* Allocation jeune: bump pointer dans la nursery si le GC en a une et que
+   l’objet y tient, sinon espace ancien (objet alors mémorisé: les écritures
+   d’initialisation n’ont pas besoin de barrière).
+   - L’objet peut changer d’adresse à chaque vt_gc_safepoint: hors racines et
+   champs visités par update, ne pas conserver son adresse au-delà.
+   - Nursery réservée à un seul mutateur (pas de verrou sur le chemin rapide).
+   - Pas d’épinglage d’un objet jeune. */
+VT_GC_API void* vt_gc_alloc_young(vt_gc* gc, size_t size,
+                                  vt_gc_update_fn update, vt_gc_finalizer fin,
+                                  uint32_t tag);
+
+/* Barrière d’écriture: à appeler après avoir rangé un pointeur géré dans obj.
+   No-op si obj est jeune, ou sans nursery ni cycle incrémental en cours.
+   En mode incrémental, obligatoire aussi pour les objets à trace: un objet
+   déjà marqué qui la passe sera rescanné. */
+VT_GC_API void vt_gc_write_barrier(vt_gc* gc, void* obj);
+
+/* Point sûr du mutateur: collecte mineure si la nursery est pleine (puis
+   éventuellement complète). Les racines et les champs update sont réécrits.
+   Renvoie 1 si une collecte mineure a eu lieu, 0 sinon. */
+VT_GC_API int vt_gc_safepoint(vt_gc* gc);
+
+/* Déclenche un GC complet (raison libre, peut être NULL). Un cycle
+   incrémental en cours est abandonné et refait en une fois.
+   - mark_threads > 1: trace/update sont appelés depuis plusieurs threads
+   (jamais deux fois en même temps pour un même objet): ils ne doivent
+   toucher qu’à l’objet reçu.
+   - concurrent_sweep: les finalizers des morts tournent sur le thread de
+   fond, en parallèle du mutateur; ils ne doivent libérer que des
+   ressources propres à l’objet. */
 VT_GC_API void vt_gc_collect(vt_gc* gc, const char* reason);
 
 /* Racines explicites
    - slot est l’adresse d’un pointeur (void**) que vous mettez/retirez du set de
-   racines. */
+   racines.
+   - Avec une nursery, la cible d’une racine est revisitée (update) à chaque
+   collecte mineure: elle peut pointer vers des objets jeunes sans barrière. */
 VT_GC_API void vt_gc_add_root(vt_gc* gc, void** slot);
 VT_GC_API void vt_gc_remove_root(vt_gc* gc, void** slot);
 
@@ -61,12 +141,13 @@ VT_GC_API void vt_gc_remove_root(vt_gc* gc, void** slot);
 VT_GC_API void vt_gc_pin(void* obj);
 VT_GC_API void vt_gc_unpin(void* obj);
 
-/* Limite d’heap dynamique */
+/* Limite d’heap dynamique (seuil plancher, voir heap_limit_bytes) */
 VT_GC_API void vt_gc_set_limit(vt_gc* gc, size_t bytes);
 
 /* Stats et introspection */
 VT_GC_API size_t vt_gc_bytes_live(vt_gc* gc);
 VT_GC_API size_t vt_gc_object_count(vt_gc* gc);
+VT_GC_API void vt_gc_get_stats(vt_gc* gc, vt_gc_stats* out);
 VT_GC_API uint32_t vt_gc_tag_of(const void* obj);
 VT_GC_API void vt_gc_set_tag(void* obj, uint32_t tag);
 
@@ -1,16 +1,43 @@
 /* ============================================================================
    hash.c — Fonctions de hachage portables (C17, licence MIT)
    - FNV-1a 32/64 (rapide, simple)
+   - vt_hash64: 64 bits, 8 à 48 octets par tour (≤ 240 octets), sinon
+     bandes de 64 octets sur 8 voies (scalaire/SSE2/AVX2/NEON, résultats
+     identiques); graine mêlée au secret (anti-HashDoS)
    - MurmurHash3 x86_32 (non cryptographique, très diffusant)
-   - CRC32 (IEEE 802.3, poly 0xEDB88320), one-shot et streaming
-   - SHA-256 (cryptographique), one-shot et streaming
+   - CRC32 (IEEE 802.3, poly 0xEDB88320), one-shot et streaming; slice-by-16,
+     PCLMULQDQ ou ARMv8 CRC selon le CPU
+   - SHA-256 (cryptographique), one-shot et streaming; SHA-NI / ARMv8 SHA2,
+     multi-buffer AVX2 (8 messages à la fois)
    - API autonome si hash.h absent
    ============================================================================
 */
+#include <errno.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VT__H_SSE2 1
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define VT__H_AVX2 1 /* compilé à part, choisi si le CPU le permet */
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define VT__H_AVX2 1
+#endif
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define VT__H_NEON 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 /* ----------------------------------------------------------------------------
    API publique (si hash.h absent)
@@ -25,7 +52,29 @@ VT_HASH_API uint64_t vt_fnv1a64(const void* data, size_t len, uint64_t seed);
 
 VT_HASH_API uint32_t vt_murmur3_32(const void* data, size_t len, uint32_t seed);
 
+VT_HASH_API uint64_t vt_hash64(const void* data, size_t len, uint64_t seed);
+VT_HASH_API uint64_t vt_hash_seed(void);
+VT_HASH_API void vt_hash_set_seed(uint64_t seed);
+VT_HASH_API uint64_t vt_hash_random_seed(void);
+typedef enum {
+  VT_HASH_IMPL_AUTO = 0,
+  VT_HASH_IMPL_SCALAR,
+  VT_HASH_IMPL_SSE2,
+  VT_HASH_IMPL_AVX2,
+  VT_HASH_IMPL_NEON
+} vt_hash_impl;
+VT_HASH_API int vt_hash_set_impl(vt_hash_impl impl);
+VT_HASH_API const char* vt_hash_impl_name(void);
+
 VT_HASH_API uint32_t vt_crc32(const void* data, size_t len, uint32_t seed);
+typedef enum {
+  VT_CRC32_IMPL_AUTO = 0,
+  VT_CRC32_IMPL_TABLE, /* slice-by-16 */
+  VT_CRC32_IMPL_CLMUL, /* x86-64 PCLMULQDQ */
+  VT_CRC32_IMPL_ARMV8  /* extension CRC ARMv8 */
+} vt_crc32_impl;
+VT_HASH_API int vt_crc32_set_impl(vt_crc32_impl impl);
+VT_HASH_API const char* vt_crc32_impl_name(void);
 
 typedef struct {
   uint32_t state[8];
@@ -38,6 +87,17 @@ VT_HASH_API void vt_sha256_init(vt_sha256_ctx* ctx);
 VT_HASH_API void vt_sha256_update(vt_sha256_ctx* ctx, const void* data, size_t len);
 VT_HASH_API void vt_sha256_final(vt_sha256_ctx* ctx, uint8_t out[32]);
 VT_HASH_API void vt_sha256(const void* data, size_t len, uint8_t out[32]);
+VT_HASH_API void vt_sha256_multi(const void* const* data, const size_t* lens, size_t n,
+                                 uint8_t (*out)[32]);
+typedef enum {
+  VT_SHA256_IMPL_AUTO = 0,
+  VT_SHA256_IMPL_SCALAR,
+  VT_SHA256_IMPL_SHANI,
+  VT_SHA256_IMPL_ARMV8,
+  VT_SHA256_IMPL_AVX2
+} vt_sha256_impl;
+VT_HASH_API int vt_sha256_set_impl(vt_sha256_impl impl);
+VT_HASH_API const char* vt_sha256_impl_name(void);
 
 #endif /* VT_HASH_HAVE_HEADER */
 
@@ -63,6 +123,323 @@ uint64_t vt_fnv1a64(const void* data, size_t len, uint64_t seed) {
   return h;
 }
 
+/* ----------------------------------------------------------------------------
+   vt_hash64
+   - ≤ 240 octets: tours à la wyhash (produit 64×64→128 replié), 16 ou 48
+     octets par tour.
+   - au-delà: 8 accumulateurs 64 bits, bandes de 64 octets; par voie
+     acc[i^1] += v, acc[i] += lo32(v^k) * hi32(v^k), brassage toutes les 16
+     bandes (1 Kio). Seules des multiplications 32×32→64: vectorisable tel
+     quel (pmuludq, vmull_u32).
+   - la graine s’ajoute/se retranche au secret (même effet sur les deux
+     chemins): sans elle, pas de collisions fabriquées à l’avance.
+---------------------------------------------------------------------------- */
+#define VT__P0 0xa0761d6478bd642fULL
+#define VT__P1 0xe7037ed1a0b428dbULL
+#define VT__P2 0x8ebc6af09c88c6e3ULL
+#define VT__P3 0x589965cc75374cc3ULL
+#define VT__PR32 0x9E3779B1u
+#define VT__PR64 0x9E3779B185EBCA87ULL
+
+#define VT__H_SHORT 240
+#define VT__H_STRIPES 16 /* bandes par bloc */
+
+static const uint64_t vt__hsecret[24] = {
+  0x2cb0f69f4abea221ull, 0x9417034723148989ull, 0xdd555950609dfe03ull,
+  0xdbafb150deb12800ull, 0x7e789b2e6c442cb6ull, 0xf41e5636c7e4f8c4ull,
+  0x0959d150f8fba7e4ull, 0xa97316f13cdb9eeaull, 0x74cd8258f9520068ull,
+  0x55c74a62e116868bull, 0xd2f4c799a2023cbdull, 0xdf98cb79a37b51b9ull,
+  0x396f5885524f3905ull, 0xaf1d56386ca3b276ull, 0xa9ffbe6b5104e85aull,
+  0x6bd0c51b9fd533b3ull, 0x980ce91c50ab4b56ull, 0x28ac395780fe62c5ull,
+  0x768912e3a6bcedc7ull, 0x50b3e8c9332c7c88ull, 0xce3bbfe520bd47daull,
+  0xcba6c8e8e0bb7c4full, 0xbf194db8434a346dull, 0x7d8f2a7b60416d7full,
+};
+
+static inline uint64_t vt__r64(const uint8_t* p) {
+  uint64_t v; memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+static inline uint64_t vt__r32(const uint8_t* p) {
+  uint32_t v; memcpy(&v, p, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
+/* a×b sur 128 bits, moitiés xorées */
+static inline uint64_t vt__mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t r = (__uint128_t)a * b;
+  return (uint64_t)r ^ (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  uint64_t hi, lo = _umul128(a, b, &hi);
+  return lo ^ hi;
+#else
+  uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32), c = t < rl;
+  uint64_t lo = t + (rm1 << 32); c += lo < t;
+  uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+  return lo ^ hi;
+#endif
+}
+
+static uint64_t vt__hash_short(const uint8_t* p, size_t len, uint64_t seed) {
+  uint64_t a, b;
+  seed ^= vt__mum(seed ^ VT__P0, VT__P1);
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t q = (len >> 3) << 2;
+      a = (vt__r32(p) << 32) | vt__r32(p + q);
+      b = (vt__r32(p + len - 4) << 32) | vt__r32(p + len - 4 - q);
+    } else if (len > 0) {
+      a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t s1 = seed, s2 = seed;
+      do {
+        seed = vt__mum(vt__r64(p) ^ VT__P1, vt__r64(p + 8) ^ seed);
+        s1 = vt__mum(vt__r64(p + 16) ^ VT__P2, vt__r64(p + 24) ^ s1);
+        s2 = vt__mum(vt__r64(p + 32) ^ VT__P3, vt__r64(p + 40) ^ s2);
+        p += 48; i -= 48;
+      } while (i > 48);
+      seed ^= s1 ^ s2;
+    }
+    while (i > 16) {
+      seed = vt__mum(vt__r64(p) ^ VT__P1, vt__r64(p + 8) ^ seed);
+      i -= 16; p += 16;
+    }
+    a = vt__r64(p + i - 16);
+    b = vt__r64(p + i - 8);
+  }
+  a ^= VT__P1; b ^= seed;
+  return vt__mum(VT__P1 ^ (uint64_t)len, vt__mum(a, b));
+}
+
+/* Bandes: stripe j utilise key[j..j+8) */
+typedef void (*vt__accum_fn)(uint64_t acc[8], const uint8_t* p, size_t n, const uint64_t* key);
+typedef void (*vt__scramble_fn)(uint64_t acc[8], const uint64_t* key);
+
+static void vt__accum_scalar(uint64_t acc[8], const uint8_t* p, size_t n, const uint64_t* key) {
+  for (size_t j = 0; j < n; j++, p += 64) {
+    for (int i = 0; i < 8; i++) {
+      uint64_t v = vt__r64(p + 8 * i);
+      uint64_t dk = v ^ key[j + (size_t)i];
+      acc[i ^ 1] += v;
+      acc[i] += (dk & 0xffffffffu) * (dk >> 32);
+    }
+  }
+}
+static void vt__scramble_scalar(uint64_t acc[8], const uint64_t* key) {
+  for (int i = 0; i < 8; i++) {
+    uint64_t a = acc[i];
+    a ^= a >> 47;
+    a ^= key[i];
+    acc[i] = a * VT__PR32;
+  }
+}
+
+#if defined(VT__H_SSE2)
+static void vt__accum_sse2(uint64_t acc[8], const uint8_t* p, size_t n, const uint64_t* key) {
+  __m128i x[4];
+  for (int i = 0; i < 4; i++) x[i] = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+  for (size_t j = 0; j < n; j++, p += 64) {
+    for (int i = 0; i < 4; i++) {
+      __m128i d = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+      __m128i k = _mm_loadu_si128((const __m128i*)(key + j + 2 * (size_t)i));
+      __m128i dk = _mm_xor_si128(d, k);
+      __m128i prod = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+      __m128i sw = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+      x[i] = _mm_add_epi64(x[i], _mm_add_epi64(prod, sw));
+    }
+  }
+  for (int i = 0; i < 4; i++) _mm_storeu_si128((__m128i*)(acc + 2 * i), x[i]);
+}
+static void vt__scramble_sse2(uint64_t acc[8], const uint64_t* key) {
+  const __m128i pr = _mm_set1_epi32((int)VT__PR32);
+  for (int i = 0; i < 4; i++) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+    a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+    a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(key + 2 * i)));
+    __m128i lo = _mm_mul_epu32(a, pr);
+    __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), pr);
+    _mm_storeu_si128((__m128i*)(acc + 2 * i), _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+  }
+}
+#endif
+
+#if defined(VT__H_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+#define VT__AVX2_FN __attribute__((target("avx2")))
+#else
+#define VT__AVX2_FN
+#endif
+VT__AVX2_FN static void vt__accum_avx2(uint64_t acc[8], const uint8_t* p, size_t n, const uint64_t* key) {
+  __m256i x0 = _mm256_loadu_si256((const __m256i*)acc);
+  __m256i x1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+  for (size_t j = 0; j < n; j++, p += 64) {
+    __m256i d0 = _mm256_loadu_si256((const __m256i*)p);
+    __m256i d1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+    __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i*)(key + j)));
+    __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i*)(key + j + 4)));
+    __m256i m0 = _mm256_mul_epu32(k0, _mm256_shuffle_epi32(k0, _MM_SHUFFLE(0, 3, 0, 1)));
+    __m256i m1 = _mm256_mul_epu32(k1, _mm256_shuffle_epi32(k1, _MM_SHUFFLE(0, 3, 0, 1)));
+    x0 = _mm256_add_epi64(x0, _mm256_add_epi64(m0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+    x1 = _mm256_add_epi64(x1, _mm256_add_epi64(m1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+  }
+  _mm256_storeu_si256((__m256i*)acc, x0);
+  _mm256_storeu_si256((__m256i*)(acc + 4), x1);
+}
+VT__AVX2_FN static void vt__scramble_avx2(uint64_t acc[8], const uint64_t* key) {
+  const __m256i pr = _mm256_set1_epi32((int)VT__PR32);
+  for (int i = 0; i < 2; i++) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(acc + 4 * i));
+    a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+    a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(key + 4 * i)));
+    __m256i lo = _mm256_mul_epu32(a, pr);
+    __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), pr);
+    _mm256_storeu_si256((__m256i*)(acc + 4 * i), _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+  }
+}
+#endif
+
+#if defined(VT__H_NEON)
+static void vt__accum_neon(uint64_t acc[8], const uint8_t* p, size_t n, const uint64_t* key) {
+  uint64x2_t x[4];
+  for (int i = 0; i < 4; i++) x[i] = vld1q_u64(acc + 2 * i);
+  for (size_t j = 0; j < n; j++, p += 64) {
+    for (int i = 0; i < 4; i++) {
+      uint64x2_t d = vreinterpretq_u64_u8(vld1q_u8(p + 16 * i));
+      uint64x2_t dk = veorq_u64(d, vld1q_u64(key + j + 2 * (size_t)i));
+      uint64x2_t prod = vmull_u32(vmovn_u64(dk), vshrn_n_u64(dk, 32));
+      x[i] = vaddq_u64(x[i], vaddq_u64(prod, vextq_u64(d, d, 1)));
+    }
+  }
+  for (int i = 0; i < 4; i++) vst1q_u64(acc + 2 * i, x[i]);
+}
+static void vt__scramble_neon(uint64_t acc[8], const uint64_t* key) {
+  const uint32x2_t pr = vdup_n_u32(VT__PR32);
+  for (int i = 0; i < 4; i++) {
+    uint64x2_t a = vld1q_u64(acc + 2 * i);
+    a = veorq_u64(a, vshrq_n_u64(a, 47));
+    a = veorq_u64(a, vld1q_u64(key + 2 * i));
+    uint64x2_t lo = vmull_u32(vmovn_u64(a), pr);
+    uint64x2_t hi = vmull_u32(vshrn_n_u64(a, 32), pr);
+    vst1q_u64(acc + 2 * i, vaddq_u64(lo, vshlq_n_u64(hi, 32)));
+  }
+}
+#endif
+
+typedef struct { vt__accum_fn accum; vt__scramble_fn scramble; const char* name; } vt__himpl;
+static const vt__himpl vt__himpls[] = {
+  {NULL, NULL, "auto"},
+  {vt__accum_scalar, vt__scramble_scalar, "scalar"},
+#if defined(VT__H_SSE2)
+  {vt__accum_sse2, vt__scramble_sse2, "sse2"},
+#else
+  {NULL, NULL, "sse2"},
+#endif
+#if defined(VT__H_AVX2)
+  {vt__accum_avx2, vt__scramble_avx2, "avx2"},
+#else
+  {NULL, NULL, "avx2"},
+#endif
+#if defined(VT__H_NEON)
+  {vt__accum_neon, vt__scramble_neon, "neon"},
+#else
+  {NULL, NULL, "neon"},
+#endif
+};
+static _Atomic(const vt__himpl*) vt__himpl_cur;
+
+static int vt__himpl_ok(vt_hash_impl i) {
+  if (i <= VT_HASH_IMPL_AUTO || i > VT_HASH_IMPL_NEON || !vt__himpls[i].accum) return 0;
+#if defined(VT__H_AVX2) && !defined(__AVX2__)
+  if (i == VT_HASH_IMPL_AVX2) return __builtin_cpu_supports("avx2");
+#endif
+  return 1;
+}
+
+static const vt__himpl* vt__himpl_get(void) {
+  const vt__himpl* h = atomic_load_explicit(&vt__himpl_cur, memory_order_relaxed);
+  if (h) return h;
+  vt_hash_set_impl(VT_HASH_IMPL_AUTO);
+  return atomic_load_explicit(&vt__himpl_cur, memory_order_relaxed);
+}
+
+int vt_hash_set_impl(vt_hash_impl impl) {
+  if (impl == VT_HASH_IMPL_AUTO) {
+    static const vt_hash_impl pref[] = {VT_HASH_IMPL_AVX2, VT_HASH_IMPL_NEON, VT_HASH_IMPL_SSE2,
+                                        VT_HASH_IMPL_SCALAR};
+    for (size_t i = 0;; i++)
+      if (vt__himpl_ok(pref[i])) { impl = pref[i]; break; }
+  } else if (!vt__himpl_ok(impl)) {
+    return -ENOTSUP;
+  }
+  atomic_store_explicit(&vt__himpl_cur, &vt__himpls[impl], memory_order_relaxed);
+  return 0;
+}
+
+const char* vt_hash_impl_name(void) { return vt__himpl_get()->name; }
+
+static uint64_t vt__hash_long(const uint8_t* p, size_t len, uint64_t seed) {
+  const vt__himpl* im = vt__himpl_get();
+  uint64_t sk[24];
+  const uint64_t* sec = vt__hsecret;
+  if (seed) {
+    for (int i = 0; i < 24; i += 2) { sk[i] = vt__hsecret[i] + seed; sk[i + 1] = vt__hsecret[i + 1] - seed; }
+    sec = sk;
+  }
+  uint64_t acc[8] = {0xC2B2AE3Du, VT__PR64, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+                     0x85EBCA77C2B2AE63ULL, 0x85EBCA77u, 0x27D4EB2F165667C5ULL, VT__PR32};
+  size_t block = 64 * VT__H_STRIPES;
+  size_t nb = (len - 1) / block;
+  for (size_t b = 0; b < nb; b++) {
+    im->accum(acc, p + b * block, VT__H_STRIPES, sec);
+    im->scramble(acc, sec + 16);
+  }
+  size_t rest = ((len - 1) - nb * block) / 64;
+  im->accum(acc, p + nb * block, rest, sec);
+  im->accum(acc, p + len - 64, 1, sec + 15);
+  uint64_t r = (uint64_t)len * VT__PR64;
+  for (int i = 0; i < 4; i++) r += vt__mum(acc[2 * i] ^ sec[2 * i + 1], acc[2 * i + 1] ^ sec[2 * i + 2]);
+  r ^= r >> 37;
+  r *= 0x165667919E3779F9ULL;
+  return r ^ (r >> 32);
+}
+
+uint64_t vt_hash64(const void* data, size_t len, uint64_t seed) {
+  const uint8_t* p = (const uint8_t*)data;
+  return len <= VT__H_SHORT ? vt__hash_short(p, len, seed) : vt__hash_long(p, len, seed);
+}
+
+/* Graine par défaut des tables (0: hachage reproductible d’un run à l’autre) */
+static _Atomic uint64_t vt__hseed;
+
+uint64_t vt_hash_seed(void) { return atomic_load_explicit(&vt__hseed, memory_order_relaxed); }
+void vt_hash_set_seed(uint64_t seed) { atomic_store_explicit(&vt__hseed, seed, memory_order_relaxed); }
+
+/* Graine imprévisible (horloge, adresses); à passer à vt_hash_set_seed au
+   démarrage si les clés viennent de l’extérieur. */
+uint64_t vt_hash_random_seed(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  uint64_t x = (uint64_t)ts.tv_nsec ^ ((uint64_t)ts.tv_sec << 20);
+  x ^= (uint64_t)(uintptr_t)&ts ^ ((uint64_t)(uintptr_t)&vt_hash_random_seed << 7) ^
+       (uint64_t)clock();
+  x = vt__mum(x ^ VT__P0, VT__P2);
+  return x ? x : VT__P3;
+}
+
 /* ----------------------------------------------------------------------------
    MurmurHash3 x86_32 (Austin Appleby, public domain)
 ---------------------------------------------------------------------------- */
@@ -105,30 +482,192 @@ uint32_t vt_murmur3_32(const void* key, size_t len, uint32_t seed) {
 }
 
 /* ----------------------------------------------------------------------------
-   CRC32 (IEEE)
+   CRC32 (IEEE, réfléchi, poly 0xEDB88320) — moteur unique du dépôt
+   - slice-by-16 portable (16 tables de 256, 16 octets par tour)
+   - x86-64: repliement PCLMULQDQ 4×128 bits (constantes d’Intel, « Fast
+     CRC Computation Using PCLMULQDQ »), réduction de Barrett, reste en
+     slice-by-16. L’instruction crc32 de SSE4.2 calcule CRC-32C: inutile ici.
+   - ARMv8: instructions crc32x/crc32b (extension CRC, vérifiée via HWCAP).
+   vt_crc32(p, n, crc) enchaîne comme zlib: crc = résultat précédent, 0 au
+   départ.
 ---------------------------------------------------------------------------- */
-static uint32_t vt__crc32_table[256];
-static int vt__crc32_inited=0;
+static uint32_t vt__crc_tab[16][256];
+static atomic_int vt__crc_state; /* 0 rien, 1 en cours, 2 prêt */
 
-static void vt__crc32_init(void) {
-  if (vt__crc32_inited) return;
-  for (uint32_t i=0;i<256;i++) {
-    uint32_t c=i;
-    for (int j=0;j<8;j++) {
-      if (c&1) c=0xEDB88320u^(c>>1);
-      else c >>=1;
+static void vt__crc_init_tables(void) {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t c = i;
+    for (int j = 0; j < 8; j++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    vt__crc_tab[0][i] = c;
+  }
+  for (uint32_t i = 0; i < 256; i++)
+    for (int k = 1; k < 16; k++) {
+      uint32_t c = vt__crc_tab[k - 1][i];
+      vt__crc_tab[k][i] = (c >> 8) ^ vt__crc_tab[0][c & 0xFF];
     }
-    vt__crc32_table[i]=c;
+}
+
+/* crc: état interne (déjà inversé) */
+static uint32_t vt__crc_slice16(uint32_t crc, const uint8_t* p, size_t n) {
+  uint32_t (*T)[256] = vt__crc_tab;
+  while (n >= 16) {
+    uint32_t a = (uint32_t)vt__r32(p) ^ crc, b = (uint32_t)vt__r32(p + 4);
+    uint32_t c = (uint32_t)vt__r32(p + 8), d = (uint32_t)vt__r32(p + 12);
+    crc = T[15][a & 0xFF] ^ T[14][(a >> 8) & 0xFF] ^ T[13][(a >> 16) & 0xFF] ^ T[12][a >> 24] ^
+          T[11][b & 0xFF] ^ T[10][(b >> 8) & 0xFF] ^ T[9][(b >> 16) & 0xFF] ^ T[8][b >> 24] ^
+          T[7][c & 0xFF] ^ T[6][(c >> 8) & 0xFF] ^ T[5][(c >> 16) & 0xFF] ^ T[4][c >> 24] ^
+          T[3][d & 0xFF] ^ T[2][(d >> 8) & 0xFF] ^ T[1][(d >> 16) & 0xFF] ^ T[0][d >> 24];
+    p += 16; n -= 16;
   }
-  vt__crc32_inited=1;
+  while (n--) crc = T[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return crc;
 }
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define VT__CRC_CLMUL 1
+/* n ≥ 64; traite n & ~15, le reste en slice-by-16 */
+__attribute__((target("pclmul,sse2")))
+static uint32_t vt__crc_clmul(uint32_t crc, const uint8_t* p, size_t n) {
+  const __m128i k1k2 = _mm_set_epi64x(0x1c6e41596LL, 0x154442bd4LL);
+  const __m128i k3k4 = _mm_set_epi64x(0x0ccaa009eLL, 0x1751997d0LL);
+  const __m128i k5 = _mm_set_epi64x(0, 0x163cd6124LL);
+  const __m128i poly = _mm_set_epi64x(0x1F7011641LL, 0x1DB710641LL); /* mu : P' */
+  const __m128i m32 = _mm_set_epi32(0, 0, 0, -1);
+  __m128i x1 = _mm_loadu_si128((const __m128i*)p);
+  __m128i x2 = _mm_loadu_si128((const __m128i*)(p + 16));
+  __m128i x3 = _mm_loadu_si128((const __m128i*)(p + 32));
+  __m128i x4 = _mm_loadu_si128((const __m128i*)(p + 48));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+  p += 64; n -= 64;
+#define VT__FOLD(x, k, d) \
+  x = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), d)
+  while (n >= 64) {
+    VT__FOLD(x1, k1k2, _mm_loadu_si128((const __m128i*)p));
+    VT__FOLD(x2, k1k2, _mm_loadu_si128((const __m128i*)(p + 16)));
+    VT__FOLD(x3, k1k2, _mm_loadu_si128((const __m128i*)(p + 32)));
+    VT__FOLD(x4, k1k2, _mm_loadu_si128((const __m128i*)(p + 48)));
+    p += 64; n -= 64;
+  }
+  VT__FOLD(x1, k3k4, x2);
+  VT__FOLD(x1, k3k4, x3);
+  VT__FOLD(x1, k3k4, x4);
+  while (n >= 16) {
+    VT__FOLD(x1, k3k4, _mm_loadu_si128((const __m128i*)p));
+    p += 16; n -= 16;
+  }
+#undef VT__FOLD
+  /* 128 → 64 → 32 bits, puis Barrett */
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x10), _mm_srli_si128(x1, 8));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, m32), k5, 0x00), x2);
+  x2 = x1;
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, m32), poly, 0x10);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, m32), poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  crc = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+  return vt__crc_slice16(crc, p, n);
+}
+#endif
+
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__linux__) || defined(__APPLE__))
+#define VT__CRC_ARMV8 1
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+__attribute__((target("+crc")))
+static uint32_t vt__crc_armv8(uint32_t crc, const uint8_t* p, size_t n) {
+  while (n && ((uintptr_t)p & 7)) { crc = __crc32b(crc, *p++); n--; }
+  while (n >= 32) {
+    crc = __crc32d(crc, vt__r64(p));
+    crc = __crc32d(crc, vt__r64(p + 8));
+    crc = __crc32d(crc, vt__r64(p + 16));
+    crc = __crc32d(crc, vt__r64(p + 24));
+    p += 32; n -= 32;
+  }
+  while (n >= 8) { crc = __crc32d(crc, vt__r64(p)); p += 8; n -= 8; }
+  while (n--) crc = __crc32b(crc, *p++);
+  return crc;
+}
+#endif
+
+typedef struct { uint32_t (*fn)(uint32_t crc, const uint8_t* p, size_t n); const char* name; } vt__crcimpl;
+static const vt__crcimpl vt__crcimpls[] = {
+  {NULL, "auto"},
+  {vt__crc_slice16, "table"},
+#if defined(VT__CRC_CLMUL)
+  {vt__crc_clmul, "clmul"},
+#else
+  {NULL, "clmul"},
+#endif
+#if defined(VT__CRC_ARMV8)
+  {vt__crc_armv8, "armv8"},
+#else
+  {NULL, "armv8"},
+#endif
+};
+static _Atomic(const vt__crcimpl*) vt__crc_cur;
+
+static int vt__crc_ok(vt_crc32_impl i) {
+  switch (i) {
+  case VT_CRC32_IMPL_TABLE: return 1;
+#if defined(VT__CRC_CLMUL)
+  case VT_CRC32_IMPL_CLMUL: return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2");
+#endif
+#if defined(VT__CRC_ARMV8)
+  case VT_CRC32_IMPL_ARMV8:
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+    return 1;
+#else
+    return (getauxval(AT_HWCAP) & (1ul << 7)) != 0; /* HWCAP_CRC32 */
+#endif
+#endif
+  default: return 0;
+  }
+}
+
+static void vt__crc_ready(void) {
+  int st = atomic_load_explicit(&vt__crc_state, memory_order_acquire);
+  if (st == 2) return;
+  st = 0;
+  if (atomic_compare_exchange_strong_explicit(&vt__crc_state, &st, 1, memory_order_acquire,
+                                              memory_order_acquire)) {
+    vt__crc_init_tables();
+    atomic_store_explicit(&vt__crc_state, 2, memory_order_release);
+  } else {
+    while (atomic_load_explicit(&vt__crc_state, memory_order_acquire) != 2) {}
+  }
+}
+
+int vt_crc32_set_impl(vt_crc32_impl impl) {
+  vt__crc_ready();
+  if (impl == VT_CRC32_IMPL_AUTO) {
+    impl = vt__crc_ok(VT_CRC32_IMPL_ARMV8)   ? VT_CRC32_IMPL_ARMV8
+           : vt__crc_ok(VT_CRC32_IMPL_CLMUL) ? VT_CRC32_IMPL_CLMUL
+                                             : VT_CRC32_IMPL_TABLE;
+  } else if (!vt__crc_ok(impl)) {
+    return -ENOTSUP;
+  }
+  atomic_store_explicit(&vt__crc_cur, &vt__crcimpls[impl], memory_order_release);
+  return 0;
+}
+
+static const vt__crcimpl* vt__crc_get(void) {
+  const vt__crcimpl* c = atomic_load_explicit(&vt__crc_cur, memory_order_acquire);
+  if (c) return c;
+  vt_crc32_set_impl(VT_CRC32_IMPL_AUTO);
+  return atomic_load_explicit(&vt__crc_cur, memory_order_acquire);
+}
+
+const char* vt_crc32_impl_name(void) { return vt__crc_get()->name; }
+
 uint32_t vt_crc32(const void* data, size_t len, uint32_t seed) {
-  vt__crc32_init();
-  const uint8_t* p=(const uint8_t*)data;
+  const vt__crcimpl* im = vt__crc_get();
+  const uint8_t* p = (const uint8_t*)data;
   uint32_t c = ~seed;
-  for (size_t i=0;i<len;i++) {
-    c = vt__crc32_table[(c^p[i])&0xFF] ^ (c>>8);
-  }
+  /* le repliement ne paie qu’à partir de quelques blocs */
+  c = len >= 64 ? im->fn(c, p, len) : vt__crc_slice16(c, p, len);
   return ~c;
 }
 
@@ -153,56 +692,378 @@ static const uint32_t K[64]={
  0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
  0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2 };
 
+static const uint32_t vt__sha_iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
 void vt_sha256_init(vt_sha256_ctx* ctx) {
-  ctx->state[0]=0x6a09e667; ctx->state[1]=0xbb67ae85; ctx->state[2]=0x3c6ef372; ctx->state[3]=0xa54ff53a;
-  ctx->state[4]=0x510e527f; ctx->state[5]=0x9b05688c; ctx->state[6]=0x1f83d9ab; ctx->state[7]=0x5be0cd19;
+  memcpy(ctx->state, vt__sha_iv, sizeof ctx->state);
   ctx->bitlen=0; ctx->buffer_len=0;
 }
-static void vt__sha256_transform(vt_sha256_ctx* ctx,const uint8_t data[64]){
-  uint32_t m[64];
-  for(int i=0;i<16;i++){
-    m[i] = (uint32_t)data[i*4]<<24 | (uint32_t)data[i*4+1]<<16 | (uint32_t)data[i*4+2]<<8 | (uint32_t)data[i*4+3];
+
+/* Compression de nblk blocs de 64 octets: un noyau par CPU */
+static void vt__sha256_scalar(uint32_t st[8], const uint8_t* data, size_t nblk){
+  for (; nblk; nblk--, data += 64) {
+    uint32_t m[64];
+    for(int i=0;i<16;i++){
+      m[i] = (uint32_t)data[i*4]<<24 | (uint32_t)data[i*4+1]<<16 | (uint32_t)data[i*4+2]<<8 | (uint32_t)data[i*4+3];
+    }
+    for(int i=16;i<64;i++) m[i] = SIG1(m[i-2])+m[i-7]+SIG0(m[i-15])+m[i-16];
+    uint32_t a=st[0],b=st[1],c=st[2],d=st[3],e=st[4],f=st[5],g=st[6],h=st[7];
+    for(int i=0;i<64;i++){
+      uint32_t t1=h+EP1(e)+CH(e,f,g)+K[i]+m[i];
+      uint32_t t2=EP0(a)+MAJ(a,b,c);
+      h=g; g=f; f=e; e=d+t1; d=c; c=b; b=a; a=t1+t2;
+    }
+    st[0]+=a; st[1]+=b; st[2]+=c; st[3]+=d;
+    st[4]+=e; st[5]+=f; st[6]+=g; st[7]+=h;
+  }
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VT__SHA_X86 1
+/* SHA-NI: état en ABEF/CDGH, 4 tours par paire de sha256rnds2; W[g%4]
+   tourne comme dans l’exemple d’Intel (msg1 puis msg2 quatre groupes plus loin) */
+__attribute__((target("sha,sse4.1")))
+static void vt__sha256_shani(uint32_t st[8], const uint8_t* p, size_t nblk) {
+  const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+  __m128i t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)st), 0xB1);  /* CDAB */
+  __m128i s1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(st + 4)), 0x1B); /* EFGH */
+  __m128i s0 = _mm_alignr_epi8(t, s1, 8); /* ABEF */
+  s1 = _mm_blend_epi16(s1, t, 0xF0);      /* CDGH */
+  for (; nblk; nblk--, p += 64) {
+    __m128i a0 = s0, c0 = s1, w[4];
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC unroll 16
+#endif
+    for (int g = 0; g < 16; g++) {
+      if (g < 4) w[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + 16 * g)), bswap);
+      __m128i m = _mm_add_epi32(w[g & 3], _mm_loadu_si128((const __m128i*)&K[4 * g]));
+      s1 = _mm_sha256rnds2_epu32(s1, s0, m);
+      if (g >= 3 && g < 15) {
+        __m128i* n = &w[(g + 1) & 3];
+        *n = _mm_sha256msg2_epu32(_mm_add_epi32(*n, _mm_alignr_epi8(w[g & 3], w[(g + 3) & 3], 4)), w[g & 3]);
+      }
+      s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(m, 0x0E));
+      if (g >= 1 && g <= 12) w[(g - 1) & 3] = _mm_sha256msg1_epu32(w[(g - 1) & 3], w[g & 3]);
+    }
+    s0 = _mm_add_epi32(s0, a0);
+    s1 = _mm_add_epi32(s1, c0);
   }
-  for(int i=16;i<64;i++) m[i] = SIG1(m[i-2])+m[i-7]+SIG0(m[i-15])+m[i-16];
-  uint32_t a=ctx->state[0],b=ctx->state[1],c=ctx->state[2],d=ctx->state[3],e=ctx->state[4],f=ctx->state[5],g=ctx->state[6],h=ctx->state[7];
-  for(int i=0;i<64;i++){
-    uint32_t t1=h+EP1(e)+CH(e,f,g)+K[i]+m[i];
-    uint32_t t2=EP0(a)+MAJ(a,b,c);
-    h=g; g=f; f=e; e=d+t1; d=c; c=b; b=a; a=t1+t2;
+  t = _mm_shuffle_epi32(s0, 0x1B);  /* FEBA */
+  s1 = _mm_shuffle_epi32(s1, 0xB1); /* DCHG */
+  _mm_storeu_si128((__m128i*)st, _mm_blend_epi16(t, s1, 0xF0));     /* DCBA */
+  _mm_storeu_si128((__m128i*)(st + 4), _mm_alignr_epi8(s1, t, 8)); /* HGFE */
+}
+
+/* AVX2: 8 messages indépendants, un par voie de 32 bits. T[mot][voie] */
+#define VT__ROR8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+__attribute__((target("avx2")))
+static void vt__sha256_x8_avx2(uint32_t T[8][8], const uint8_t* const blk[8]) {
+  const __m256i bswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL,
+                                          0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+  __m256i w[16];
+  for (int half = 0; half < 2; half++) { /* transposée 8×8 des mots 0-7 puis 8-15 */
+    __m256i r[8], u[8];
+    for (int l = 0; l < 8; l++) r[l] = _mm256_loadu_si256((const __m256i*)(blk[l] + 32 * half));
+    for (int l = 0; l < 8; l += 2) {
+      u[l] = _mm256_unpacklo_epi32(r[l], r[l + 1]);
+      u[l + 1] = _mm256_unpackhi_epi32(r[l], r[l + 1]);
+    }
+    for (int l = 0; l < 8; l += 4) {
+      r[l] = _mm256_unpacklo_epi64(u[l], u[l + 2]);
+      r[l + 1] = _mm256_unpackhi_epi64(u[l], u[l + 2]);
+      r[l + 2] = _mm256_unpacklo_epi64(u[l + 1], u[l + 3]);
+      r[l + 3] = _mm256_unpackhi_epi64(u[l + 1], u[l + 3]);
+    }
+    for (int j = 0; j < 4; j++) {
+      w[8 * half + j] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r[j], r[j + 4], 0x20), bswap);
+      w[8 * half + j + 4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r[j], r[j + 4], 0x31), bswap);
+    }
   }
-  ctx->state[0]+=a; ctx->state[1]+=b; ctx->state[2]+=c; ctx->state[3]+=d;
-  ctx->state[4]+=e; ctx->state[5]+=f; ctx->state[6]+=g; ctx->state[7]+=h;
+  __m256i v[8], s[8];
+  for (int i = 0; i < 8; i++) v[i] = s[i] = _mm256_load_si256((const __m256i*)T[i]);
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC unroll 16
+#endif
+  for (int i = 0; i < 64; i++) {
+    __m256i x;
+    if (i < 16) {
+      x = w[i];
+    } else {
+      __m256i w2 = w[(i - 2) & 15], w15 = w[(i - 15) & 15];
+      __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(VT__ROR8(w2, 17), VT__ROR8(w2, 19)), _mm256_srli_epi32(w2, 10));
+      __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(VT__ROR8(w15, 7), VT__ROR8(w15, 18)), _mm256_srli_epi32(w15, 3));
+      x = w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+    }
+    __m256i e = v[4], a = v[0];
+    __m256i ep1 = _mm256_xor_si256(_mm256_xor_si256(VT__ROR8(e, 6), VT__ROR8(e, 11)), VT__ROR8(e, 25));
+    __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, v[5]), _mm256_andnot_si256(e, v[6]));
+    __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(v[7], ep1),
+                                  _mm256_add_epi32(_mm256_add_epi32(ch, x), _mm256_set1_epi32((int)K[i])));
+    __m256i ep0 = _mm256_xor_si256(_mm256_xor_si256(VT__ROR8(a, 2), VT__ROR8(a, 13)), VT__ROR8(a, 22));
+    __m256i maj = _mm256_or_si256(_mm256_and_si256(a, v[1]), _mm256_and_si256(v[2], _mm256_or_si256(a, v[1])));
+    v[7] = v[6]; v[6] = v[5]; v[5] = e; v[4] = _mm256_add_epi32(v[3], t1);
+    v[3] = v[2]; v[2] = v[1]; v[1] = a; v[0] = _mm256_add_epi32(t1, _mm256_add_epi32(ep0, maj));
+  }
+  for (int i = 0; i < 8; i++) _mm256_store_si256((__m256i*)T[i], _mm256_add_epi32(v[i], s[i]));
 }
+#undef VT__ROR8
+#endif
+
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__linux__) || defined(__APPLE__)) && !defined(__ARM_BIG_ENDIAN)
+#define VT__SHA_ARMV8 1
+#if defined(__clang__)
+#define VT__SHA2_FN __attribute__((target("sha2")))
+#else
+#define VT__SHA2_FN __attribute__((target("+crypto")))
+#endif
+VT__SHA2_FN
+static void vt__sha256_armv8(uint32_t st[8], const uint8_t* p, size_t nblk) {
+  uint32x4_t s0 = vld1q_u32(st), s1 = vld1q_u32(st + 4);
+  for (; nblk; nblk--, p += 64) {
+    uint32x4_t a0 = s0, c0 = s1, w[4];
+    for (int i = 0; i < 4; i++) w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 16 * i)));
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC unroll 16
+#endif
+    for (int g = 0; g < 16; g++) {
+      uint32x4_t m = vaddq_u32(w[g & 3], vld1q_u32(&K[4 * g])), s2 = s0;
+      if (g < 12) w[g & 3] = vsha256su0q_u32(w[g & 3], w[(g + 1) & 3]);
+      s0 = vsha256hq_u32(s0, s1, m);
+      s1 = vsha256h2q_u32(s1, s2, m);
+      if (g < 12) w[g & 3] = vsha256su1q_u32(w[g & 3], w[(g + 2) & 3], w[(g + 3) & 3]);
+    }
+    s0 = vaddq_u32(s0, a0);
+    s1 = vaddq_u32(s1, c0);
+  }
+  vst1q_u32(st, s0);
+  vst1q_u32(st + 4, s1);
+}
+#endif
+
+typedef void (*vt__sha_blocks_fn)(uint32_t st[8], const uint8_t* p, size_t nblk);
+typedef void (*vt__sha_x8_fn)(uint32_t T[8][8], const uint8_t* const blk[8]);
+typedef struct { vt__sha_blocks_fn blocks; vt__sha_x8_fn x8; const char* name; } vt__shaimpl;
+static const vt__shaimpl vt__shaimpls[] = {
+  {NULL, NULL, "auto"},
+  {vt__sha256_scalar, NULL, "scalar"},
+#if defined(VT__SHA_X86)
+  {vt__sha256_shani, NULL, "sha-ni"},
+#else
+  {NULL, NULL, "sha-ni"},
+#endif
+#if defined(VT__SHA_ARMV8)
+  {vt__sha256_armv8, NULL, "armv8"},
+#else
+  {NULL, NULL, "armv8"},
+#endif
+#if defined(VT__SHA_X86)
+  {vt__sha256_scalar, vt__sha256_x8_avx2, "avx2x8"},
+#else
+  {NULL, NULL, "avx2x8"},
+#endif
+};
+static _Atomic(const vt__shaimpl*) vt__sha_cur;
+
+static int vt__sha_ok(vt_sha256_impl i) {
+  if (i <= VT_SHA256_IMPL_AUTO || i > VT_SHA256_IMPL_AVX2 || !vt__shaimpls[i].blocks) return 0;
+#if defined(VT__SHA_X86)
+  if (i == VT_SHA256_IMPL_SHANI) return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+  if (i == VT_SHA256_IMPL_AVX2) return __builtin_cpu_supports("avx2");
+#endif
+#if defined(VT__SHA_ARMV8) && defined(__linux__) && !defined(__ARM_FEATURE_SHA2)
+  if (i == VT_SHA256_IMPL_ARMV8) return (getauxval(AT_HWCAP) & (1ul << 6)) != 0; /* HWCAP_SHA2 */
+#endif
+  return 1;
+}
+
+int vt_sha256_set_impl(vt_sha256_impl impl) {
+  if (impl == VT_SHA256_IMPL_AUTO) {
+    static const vt_sha256_impl pref[] = {VT_SHA256_IMPL_SHANI, VT_SHA256_IMPL_ARMV8,
+                                          VT_SHA256_IMPL_AVX2, VT_SHA256_IMPL_SCALAR};
+    for (size_t i = 0;; i++)
+      if (vt__sha_ok(pref[i])) { impl = pref[i]; break; }
+  } else if (!vt__sha_ok(impl)) {
+    return -ENOTSUP;
+  }
+  atomic_store_explicit(&vt__sha_cur, &vt__shaimpls[impl], memory_order_relaxed);
+  return 0;
+}
+
+static const vt__shaimpl* vt__sha_get(void) {
+  const vt__shaimpl* s = atomic_load_explicit(&vt__sha_cur, memory_order_relaxed);
+  if (s) return s;
+  vt_sha256_set_impl(VT_SHA256_IMPL_AUTO);
+  return atomic_load_explicit(&vt__sha_cur, memory_order_relaxed);
+}
+
+const char* vt_sha256_impl_name(void) { return vt__sha_get()->name; }
+
 void vt_sha256_update(vt_sha256_ctx* ctx, const void* dat, size_t len) {
   const uint8_t* data=(const uint8_t*)dat;
-  for(size_t i=0;i<len;i++){
-    ctx->buffer[ctx->buffer_len++]=data[i];
-    if(ctx->buffer_len==64){
-      vt__sha256_transform(ctx,ctx->buffer);
-      ctx->bitlen+=512;
-      ctx->buffer_len=0;
-    }
+  vt__sha_blocks_fn blocks = vt__sha_get()->blocks;
+  if (ctx->buffer_len) {
+    size_t k = 64 - ctx->buffer_len < len ? 64 - ctx->buffer_len : len;
+    memcpy(ctx->buffer + ctx->buffer_len, data, k);
+    ctx->buffer_len += k; data += k; len -= k;
+    if (ctx->buffer_len < 64) return;
+    blocks(ctx->state, ctx->buffer, 1);
+    ctx->bitlen += 512;
+    ctx->buffer_len = 0;
   }
+  if (len >= 64) {
+    blocks(ctx->state, data, len / 64);
+    ctx->bitlen += (uint64_t)(len / 64) * 512;
+    data += len & ~(size_t)63; len &= 63;
+  }
+  memcpy(ctx->buffer, data, len);
+  ctx->buffer_len = len;
 }
-void vt_sha256_final(vt_sha256_ctx* ctx, uint8_t out[32]){
-  uint64_t bitlen = ctx->bitlen + ctx->buffer_len*8;
-  size_t i=ctx->buffer_len;
-  ctx->buffer[i++]=0x80;
-  if(i>56){
-    while(i<64) ctx->buffer[i++]=0;
-    vt__sha256_transform(ctx,ctx->buffer);
-    i=0;
-  }
-  while(i<56) ctx->buffer[i++]=0;
-  for(int j=7;j>=0;j--) ctx->buffer[i++]=(uint8_t)(bitlen>>(j*8));
-  vt__sha256_transform(ctx,ctx->buffer);
+
+/* Dernier(s) bloc(s): 0x80, zéros, longueur en bits big-endian; 1 ou 2 blocs */
+static unsigned vt__sha256_pad(uint8_t tail[128], const uint8_t* rest, size_t n, uint64_t bitlen) {
+  unsigned nb = n + 9 <= 64 ? 1 : 2;
+  memcpy(tail, rest, n);
+  tail[n] = 0x80;
+  memset(tail + n + 1, 0, 64 * nb - n - 9);
+  for (int j = 0; j < 8; j++) tail[64 * nb - 1 - j] = (uint8_t)(bitlen >> (8 * j));
+  return nb;
+}
+
+static void vt__sha256_out(const uint32_t st[8], uint8_t out[32]) {
   for(int j=0;j<8;j++){
-    out[j*4]=(uint8_t)(ctx->state[j]>>24);
-    out[j*4+1]=(uint8_t)(ctx->state[j]>>16);
-    out[j*4+2]=(uint8_t)(ctx->state[j]>>8);
-    out[j*4+3]=(uint8_t)(ctx->state[j]);
+    out[j*4]=(uint8_t)(st[j]>>24);
+    out[j*4+1]=(uint8_t)(st[j]>>16);
+    out[j*4+2]=(uint8_t)(st[j]>>8);
+    out[j*4+3]=(uint8_t)(st[j]);
   }
 }
+
+void vt_sha256_final(vt_sha256_ctx* ctx, uint8_t out[32]){
+  uint8_t tail[128];
+  unsigned nb = vt__sha256_pad(tail, ctx->buffer, ctx->buffer_len, ctx->bitlen + ctx->buffer_len * 8);
+  vt__sha_get()->blocks(ctx->state, tail, nb);
+  vt__sha256_out(ctx->state, out);
+}
 void vt_sha256(const void* data, size_t len, uint8_t out[32]){
   vt_sha256_ctx ctx; vt_sha256_init(&ctx); vt_sha256_update(&ctx,data,len); vt_sha256_final(&ctx,out);
 }
+
+/* Multi-buffer: 8 voies; une voie qui finit son message écrit l’empreinte
+   et reprend le suivant, les voies vides hachent un bloc nul sans effet. */
+typedef struct {
+  const uint8_t* p;
+  size_t nfull;
+  uint8_t tail[128];
+  unsigned ntail, tail_i;
+  size_t msg; /* SIZE_MAX: voie libre */
+} vt__sha_lane;
+
+static void vt__sha_lane_load(vt__sha_lane* L, uint32_t T[8][8], int l, size_t msg,
+                              const void* const* data, const size_t* lens) {
+  L->p = (const uint8_t*)data[msg];
+  L->nfull = lens[msg] / 64;
+  L->ntail = vt__sha256_pad(L->tail, L->p + (lens[msg] & ~(size_t)63), lens[msg] & 63,
+                            (uint64_t)lens[msg] * 8);
+  L->tail_i = 0;
+  L->msg = msg;
+  for (int i = 0; i < 8; i++) T[i][l] = vt__sha_iv[i];
+}
+
+void vt_sha256_multi(const void* const* data, const size_t* lens, size_t n, uint8_t (*out)[32]) {
+  const vt__shaimpl* im = vt__sha_get();
+  if (!im->x8 || n < 2) {
+    for (size_t i = 0; i < n; i++) vt_sha256(data[i], lens[i], out[i]);
+    return;
+  }
+  static const uint8_t zero[64];
+  _Alignas(32) uint32_t T[8][8];
+  vt__sha_lane L[8];
+  const uint8_t* blk[8];
+  size_t next = 0, live = 0;
+  for (int l = 0; l < 8; l++) {
+    if (next < n) { vt__sha_lane_load(&L[l], T, l, next++, data, lens); live++; }
+    else L[l].msg = SIZE_MAX;
+  }
+  while (live) {
+    for (int l = 0; l < 8; l++) {
+      vt__sha_lane* x = &L[l];
+      if (x->msg == SIZE_MAX) blk[l] = zero;
+      else if (x->nfull) { blk[l] = x->p; x->p += 64; x->nfull--; }
+      else blk[l] = x->tail + 64 * x->tail_i++;
+    }
+    im->x8(T, blk);
+    for (int l = 0; l < 8; l++) {
+      vt__sha_lane* x = &L[l];
+      if (x->msg == SIZE_MAX || x->nfull || x->tail_i < x->ntail) continue;
+      uint32_t st[8];
+      for (int i = 0; i < 8; i++) st[i] = T[i][l];
+      vt__sha256_out(st, out[x->msg]);
+      if (next < n) vt__sha_lane_load(x, T, l, next++, data, lens);
+      else { x->msg = SIZE_MAX; live--; }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------------
+   Bench (-DVT_HASH_BENCH): SHA-256 par noyau, flux unique (1 Mio) et
+   lots de messages (2048 × 4 Kio, puis 2048 × 256 o) via vt_sha256_multi;
+   chaque noyau est d’abord comparé au scalaire.
+---------------------------------------------------------------------------- */
+#ifdef VT_HASH_BENCH
+#include <stdio.h>
+
+static double vt__hb_now(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+  enum { NMSG = 2048 };
+  static const vt_sha256_impl impls[] = {VT_SHA256_IMPL_SCALAR, VT_SHA256_IMPL_SHANI,
+                                         VT_SHA256_IMPL_ARMV8, VT_SHA256_IMPL_AVX2};
+  size_t big = (size_t)1 << 20, small[] = {4096, 256};
+  uint8_t* buf = (uint8_t*)malloc(big + NMSG * 4096);
+  const void** ptr = (const void**)malloc(NMSG * sizeof *ptr);
+  size_t* lens = (size_t*)malloc(NMSG * sizeof *lens);
+  uint8_t(*ref)[32] = malloc(NMSG * 32), (*got)[32] = malloc(NMSG * 32);
+  if (!buf || !ptr || !lens || !ref || !got) return 1;
+  uint64_t x = 0x9E3779B97F4A7C15ull;
+  for (size_t i = 0; i < big + NMSG * 4096; i++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    buf[i] = (uint8_t)x;
+  }
+  for (size_t i = 0; i < NMSG; i++) { ptr[i] = buf + big + i * 4096; lens[i] = (i * 977) % 4097; }
+  vt_sha256_set_impl(VT_SHA256_IMPL_SCALAR);
+  for (size_t i = 0; i < NMSG; i++) vt_sha256(ptr[i], lens[i], ref[i]);
+
+  printf("SHA-256 (auto: ");
+  vt_sha256_set_impl(VT_SHA256_IMPL_AUTO);
+  printf("%s)\n", vt_sha256_impl_name());
+  for (size_t k = 0; k < sizeof impls / sizeof impls[0]; k++) {
+    if (vt_sha256_set_impl(impls[k]) != 0) continue;
+    vt_sha256_multi(ptr, lens, NMSG, got);
+    if (memcmp(ref, got, NMSG * 32) != 0) { printf("%s: empreintes différentes\n", vt_sha256_impl_name()); return 1; }
+    uint8_t d[32];
+    int reps = 64;
+    double t0 = vt__hb_now();
+    for (int r = 0; r < reps; r++) vt_sha256(buf, big, d);
+    double one = (double)big * reps / (vt__hb_now() - t0) / 1e6;
+    printf("  %-8s flux %8.0f Mo/s", vt_sha256_impl_name(), one);
+    for (size_t s = 0; s < 2; s++) {
+      for (size_t i = 0; i < NMSG; i++) lens[i] = small[s];
+      reps = s ? 64 : 8;
+      t0 = vt__hb_now();
+      for (int r = 0; r < reps; r++) vt_sha256_multi(ptr, lens, NMSG, got);
+      double mb = (double)small[s] * NMSG * reps / (vt__hb_now() - t0) / 1e6;
+      printf("  lots %4zu o %8.0f Mo/s", small[s], mb);
+    }
+    printf("\n");
+    for (size_t i = 0; i < NMSG; i++) lens[i] = (i * 977) % 4097;
+  }
+  free(buf); free(ptr); free(lens); free(ref); free(got);
+  return 0;
+}
+#endif /* VT_HASH_BENCH */
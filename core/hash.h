@@ -2,8 +2,9 @@
    hash.h — API de hachage portable (C17, licence MIT)
    - FNV-1a 32/64
    - MurmurHash3 (x86_32)
-   - CRC32
-   - SHA-256 (streaming et one-shot)
+   - vt_hash64 (64 bits, rapide, graine anti-HashDoS; défaut des tables)
+   - CRC32 (slice-by-16, PCLMULQDQ, ARMv8 CRC)
+   - SHA-256 (streaming, one-shot, multi-buffer; SHA-NI/ARMv8/AVX2)
    Lier avec hash.c
    ============================================================================
 */
@@ -33,11 +34,50 @@ VT_HASH_API uint64_t vt_fnv1a64(const void* data, size_t len, uint64_t seed);
 ---------------------------------------------------------------------------- */
 VT_HASH_API uint32_t vt_murmur3_32(const void* data, size_t len, uint32_t seed);
 
+/* ----------------------------------------------------------------------------
+   vt_hash64 — hachage 64 bits par défaut (vt_table, hashmap, interner, kv)
+   - ≤ 240 octets: 16 à 48 octets par tour; au-delà, bandes de 64 octets
+     en SIMD (AVX2/SSE2/NEON, choisi à l’exécution), même résultat partout.
+   - seed: mêlé à chaque tour; avec une graine secrète, impossible de
+     précalculer des clés en collision.
+   - vt_hash_seed(): graine que les tables prennent à leur création;
+     0 par défaut (reproductible). vt_hash_set_seed(vt_hash_random_seed())
+     au démarrage pour des clés non fiables.
+   - vt_hash_set_impl: force une variante (tests, bench); -ENOTSUP si elle
+     n’est pas disponible ici.
+---------------------------------------------------------------------------- */
+VT_HASH_API uint64_t vt_hash64(const void* data, size_t len, uint64_t seed);
+VT_HASH_API uint64_t vt_hash_seed(void);
+VT_HASH_API void vt_hash_set_seed(uint64_t seed);
+VT_HASH_API uint64_t vt_hash_random_seed(void);
+
+typedef enum {
+  VT_HASH_IMPL_AUTO = 0,
+  VT_HASH_IMPL_SCALAR,
+  VT_HASH_IMPL_SSE2,
+  VT_HASH_IMPL_AVX2,
+  VT_HASH_IMPL_NEON
+} vt_hash_impl;
+VT_HASH_API int vt_hash_set_impl(vt_hash_impl impl);
+VT_HASH_API const char* vt_hash_impl_name(void); /* variante active */
+
 /* ----------------------------------------------------------------------------
    CRC32
 ---------------------------------------------------------------------------- */
+/* crc = résultat précédent pour enchaîner (0 au départ), comme zlib crc32().
+   Slice-by-16, ou PCLMULQDQ (x86-64) / instructions CRC ARMv8 si le CPU les
+   a; même résultat partout. vt_crc32_set_impl: -ENOTSUP si absente. */
 VT_HASH_API uint32_t vt_crc32(const void* data, size_t len, uint32_t seed);
 
+typedef enum {
+  VT_CRC32_IMPL_AUTO = 0,
+  VT_CRC32_IMPL_TABLE, /* slice-by-16 */
+  VT_CRC32_IMPL_CLMUL, /* x86-64 PCLMULQDQ */
+  VT_CRC32_IMPL_ARMV8  /* extension CRC ARMv8 */
+} vt_crc32_impl;
+VT_HASH_API int vt_crc32_set_impl(vt_crc32_impl impl);
+VT_HASH_API const char* vt_crc32_impl_name(void);
+
 /* ----------------------------------------------------------------------------
    SHA-256
 ---------------------------------------------------------------------------- */
@@ -55,6 +95,25 @@ VT_HASH_API void vt_sha256_final(vt_sha256_ctx* ctx, uint8_t out[32]);
 /* one-shot */
 VT_HASH_API void vt_sha256(const void* data, size_t len, uint8_t out[32]);
 
+/* n messages indépendants (data[i], lens[i]) → out[i]. Avec SHA-NI / ARMv8
+   les messages passent un par un sur ce noyau; sinon AVX2 en hache 8 de
+   front (une voie de 32 bits par message, relance dès qu’une voie finit).
+   À privilégier pour beaucoup de petits fichiers. */
+VT_HASH_API void vt_sha256_multi(const void* const* data, const size_t* lens, size_t n,
+                                 uint8_t (*out)[32]);
+
+/* Noyau: AUTO = SHA-NI > ARMv8 > AVX2 (multi seulement) > scalaire.
+   -ENOTSUP si absent du CPU. */
+typedef enum {
+  VT_SHA256_IMPL_AUTO = 0,
+  VT_SHA256_IMPL_SCALAR,
+  VT_SHA256_IMPL_SHANI, /* x86 SHA extensions */
+  VT_SHA256_IMPL_ARMV8, /* ARMv8 SHA2 */
+  VT_SHA256_IMPL_AVX2   /* multi-buffer 8 voies; flux simple en scalaire */
+} vt_sha256_impl;
+VT_HASH_API int vt_sha256_set_impl(vt_sha256_impl impl);
+VT_HASH_API const char* vt_sha256_impl_name(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -5,7 +5,7 @@
    - O(1) amorti: put/get/del. Redimension dynamique
    - Confort: variante « string map » (clé UTF-8, dup/free automatique)
    - Thread-safety: non (à sérialiser côté appelant)
-   - Zéro dépendance hors libc
+   - Dépendances: libc, hash.c (vt_hash64 pour la variante string)
    ============================================================================
 */
 #include <stdint.h>
@@ -13,6 +13,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "hash.h"
+
 /* ----------------------------------------------------------------------------
    API publique si aucun header n’est fourni (vt_hashmap_*)
 ---------------------------------------------------------------------------- */
@@ -63,14 +65,6 @@ VT_HASHMAP_API int         vt_hashmap_del_str(vt_hashmap* m, const char* key);
 #define VT_HM_INLINE static inline
 #endif
 
-/* FNV-1a 64 pour la variante string */
-VT_HM_INLINE uint64_t vt__fnv1a64(const void* data, size_t len) {
-  const unsigned char* p = (const unsigned char*)data;
-  uint64_t h = 1469598103934665603ull;
-  for (size_t i=0;i<len;i++){ h ^= p[i]; h *= 1099511628211ull; }
-  return h;
-}
-
 /* Entrée de bucket */
 typedef struct {
   uint64_t hash;  /* 0 = vide */
@@ -249,10 +243,10 @@ void vt_hashmap_foreach(vt_hashmap* m, vt_hashmap_iter_fn it, void* u) {
 /* ----------------------------------------------------------------------------
    Variante « string map »
 ---------------------------------------------------------------------------- */
+/* udata = graine vt_hash_seed() prise à la création */
 static uint64_t vt__hash_cstr(const void* k, void* udata) {
-  (void)udata;
   const char* s = (const char*)k;
-  return vt__fnv1a64(s, strlen(s));
+  return vt_hash64(s, strlen(s), (uint64_t)(uintptr_t)udata);
 }
 static int vt__eq_cstr(const void* a, const void* b, void* udata) {
   (void)udata; return strcmp((const char*)a, (const char*)b) == 0;
@@ -268,7 +262,8 @@ static char* vt__strdup(const char* s){
 }
 
 vt_hashmap* vt_hashmap_new_string(void) {
-  return vt_hashmap_new(vt__hash_cstr, vt__eq_cstr, vt__kfree_cstr, NULL);
+  return vt_hashmap_new(vt__hash_cstr, vt__eq_cstr, vt__kfree_cstr,
+                        (void*)(uintptr_t)vt_hash_seed());
 }
 int vt_hashmap_put_str(vt_hashmap* m, const char* key, void* value) {
   char* dup = vt__strdup(key);
@@ -285,7 +280,7 @@ int vt_hashmap_del_str(vt_hashmap* m, const char* key) {
 
 /* ----------------------------------------------------------------------------
    Tests optionnels
-   cc -std=c17 -DVT_HASHMAP_TEST hashmap.c
+   cc -std=c17 -DVT_HASHMAP_TEST hashmap.c hash.c
 ---------------------------------------------------------------------------- */
 #ifdef VT_HASHMAP_TEST
 #include <stdio.h>
@@ -0,0 +1,704 @@
+// SPDX-License-Identifier: MIT
+/* ============================================================================
+   ir.c — Abaissement bytecode pile → IR à registres (C17)
+
+   Principe: la profondeur de pile est statique en tout point (flot de
+   données), donc chaque entrée de pile a un registre "maison" fixe
+   (nlocals + profondeur). On simule une pile virtuelle dont les entrées
+   sont soit dans leur maison, soit un alias d’un local (LD), soit une
+   constante entière (ICONST); rien n’est émis tant qu’une valeur n’est pas
+   consommée. Aux frontières (cibles de saut, sauts, insns pile) la pile
+   virtuelle est matérialisée.
+
+   Invariants:
+   - un alias ne désigne jamais qu’un local (jamais un temporaire);
+   - avant toute écriture d’un local L, les alias de L sont matérialisés;
+   - prod[d] = index de l’insn IR qui a écrit la maison d, tant qu’elle est
+     la dernière émise: ST peut alors réécrire sa destination.
+   ============================================================================ */
+
+#include "ir.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "opcodes.h"
+
+/* -------------------------------------------------------------------------- */
+/* Utilitaires                                                                */
+/* -------------------------------------------------------------------------- */
+static const char* const VT_IR_NAMES[VT_IR__COUNT] = {
+    [VT_IR_MOV] = "mov",     [VT_IR_LOADI] = "loadi", [VT_IR_LOADF] = "loadf",
+    [VT_IR_LOADK] = "loadk", [VT_IR_LDG] = "ldg",     [VT_IR_STG] = "stg",
+    [VT_IR_ADD] = "add",     [VT_IR_SUB] = "sub",     [VT_IR_MUL] = "mul",
+    [VT_IR_DIV] = "div",     [VT_IR_MOD] = "mod",     [VT_IR_ADDI] = "addi",
+    [VT_IR_NEG] = "neg",     [VT_IR_NOT] = "not",     [VT_IR_EQ] = "eq",
+    [VT_IR_NE] = "ne",       [VT_IR_LT] = "lt",       [VT_IR_LE] = "le",
+    [VT_IR_GT] = "gt",       [VT_IR_GE] = "ge",       [VT_IR_JMP] = "jmp",
+    [VT_IR_JT] = "jt",       [VT_IR_JF] = "jf",       [VT_IR_CMPJF] = "cmpjf",
+    [VT_IR_CMPJFI] = "cmpjfi", [VT_IR_SETSP] = "setsp", [VT_IR_STK] = "stk",
+};
+
+static const char* const VT_IR_CONDS[6] = {"eq", "ne", "lt", "le", "gt", "ge"};
+
+const char* vt_ir_op_name(vt_ir_op op) {
+  return (unsigned)op < VT_IR__COUNT ? VT_IR_NAMES[op] : "?";
+}
+
+void vt_ir_init(vt_ir* ir) { memset(ir, 0, sizeof *ir); }
+
+void vt_ir_free(vt_ir* ir) {
+  if (!ir) return;
+  free(ir->code);
+  vt_ir_init(ir);
+}
+
+static int vt__ir_fail(char* err, size_t errsz, const char* fmt, ...) {
+  if (err && errsz) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(err, errsz, fmt, ap);
+    va_end(ap);
+  }
+  return -ENOEXEC;
+}
+
+/* Effets de pile exacts (les opcodes variables dépendent des immédiats). */
+static void vt__ir_effect(const vt_insn* in, int* pop, int* push) {
+  switch (in->op) {
+    case OP_POP: *pop = (int)in->imm[0]; *push = 0; return;
+    case OP_NEWA: *pop = (int)in->imm[0]; *push = 1; return;
+    case OP_NEWM: *pop = 2 * (int)in->imm[0]; *push = 1; return;
+    case OP_CALL: *pop = (int)in->imm[0] + 1; *push = (int)in->imm[1]; return;
+    case OP_RET: *pop = (int)in->imm[0]; *push = 0; return;
+    case OP_CLOSURE: *pop = (int)in->imm[1]; *push = 1; return;
+    default: {
+      const vt_opcode_info* ii = vt_op_info(in->op);
+      *pop = ii->stack_in;
+      *push = ii->stack_out;
+      return;
+    }
+  }
+}
+
+static int vt__ir_has_rel(vt_opcode op) {
+  const vt_opcode_info* ii = vt_op_info(op);
+  return ii->argc && ii->argk[0] == VT_OK_REL32;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Pile virtuelle                                                             */
+/* -------------------------------------------------------------------------- */
+enum { VT__IR_HOME = 0, VT__IR_REG, VT__IR_IMM };
+
+typedef struct {
+  uint8_t kind;
+  uint16_t r; /* VT__IR_REG: local aliasé */
+  int64_t k;  /* VT__IR_IMM */
+} vt__ir_slot;
+
+typedef struct {
+  vt_ir* ir;
+  vt__ir_slot* vs;
+  int32_t* prod;
+  uint32_t depth;
+  int32_t sp_depth; /* profondeur reflétée par sp, -1 = inconnue */
+  int oom;
+} vt__ir_ctx;
+
+/* En cas d’échec d’allocation, renvoie une insn poubelle et lève oom: les
+   appelants n’ont pas à tester chaque émission. */
+static vt_ir_insn* vt__ir_emit(vt__ir_ctx* c, vt_ir_op op) {
+  static vt_ir_insn sink;
+  vt_ir* ir = c->ir;
+  if (ir->len == ir->cap) {
+    size_t ncap = ir->cap ? ir->cap * 2 : 64;
+    vt_ir_insn* p = (vt_ir_insn*)realloc(ir->code, ncap * sizeof *p);
+    if (!p) {
+      c->oom = 1;
+      return &sink;
+    }
+    ir->code = p;
+    ir->cap = ncap;
+  }
+  vt_ir_insn* in = &ir->code[ir->len++];
+  memset(in, 0, sizeof *in);
+  in->op = (uint8_t)op;
+  /* seules les entrées "maison" en bas de pile sont écrites en mémoire */
+  uint32_t h = 0;
+  while (h < c->depth && c->vs[h].kind == VT__IR_HOME) h++;
+  in->live = (uint16_t)(ir->nlocals + h);
+  return in;
+}
+
+static uint16_t vt__ir_home(const vt__ir_ctx* c, uint32_t d) {
+  return (uint16_t)(c->ir->nlocals + d);
+}
+
+/* Ramène l’entrée i dans sa maison. */
+static void vt__ir_materialize(vt__ir_ctx* c, uint32_t i) {
+  vt__ir_slot* s = &c->vs[i];
+  if (s->kind == VT__IR_HOME) return;
+  vt_ir_insn* in;
+  if (s->kind == VT__IR_REG) {
+    in = vt__ir_emit(c, VT_IR_MOV);
+    in->a = s->r;
+  } else {
+    in = vt__ir_emit(c, VT_IR_LOADI);
+    in->k = s->k;
+  }
+  in->d = vt__ir_home(c, i);
+  s->kind = VT__IR_HOME;
+  c->prod[i] = (int32_t)c->ir->len - 1;
+}
+
+static void vt__ir_flush(vt__ir_ctx* c) {
+  for (uint32_t i = 0; i < c->depth; i++) vt__ir_materialize(c, i);
+}
+
+/* Avant d’écrire le local L. */
+static void vt__ir_kill(vt__ir_ctx* c, uint16_t L) {
+  for (uint32_t i = 0; i < c->depth; i++)
+    if (c->vs[i].kind == VT__IR_REG && c->vs[i].r == L)
+      vt__ir_materialize(c, i);
+}
+
+/* Registre lisible pour l’entrée i (les constantes vont dans leur maison). */
+static uint16_t vt__ir_reg(vt__ir_ctx* c, uint32_t i) {
+  if (c->vs[i].kind == VT__IR_IMM) vt__ir_materialize(c, i);
+  return c->vs[i].kind == VT__IR_REG ? c->vs[i].r : vt__ir_home(c, i);
+}
+
+/* Empile le résultat que la dernière insn émise a écrit dans sa maison. */
+static void vt__ir_push_home(vt__ir_ctx* c) {
+  c->vs[c->depth].kind = VT__IR_HOME;
+  c->prod[c->depth] = (int32_t)c->ir->len - 1;
+  c->depth++;
+}
+
+static void vt__ir_reset(vt__ir_ctx* c, uint32_t depth) {
+  c->depth = depth;
+  for (uint32_t i = 0; i < depth; i++) {
+    c->vs[i].kind = VT__IR_HOME;
+    c->prod[i] = -1;
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Abaissement                                                                */
+/* -------------------------------------------------------------------------- */
+int vt_ir_lower(const uint8_t* code, size_t len, uint16_t nlocals, vt_ir* out,
+                char* err, size_t errsz) {
+  if (!code || !len || !out || len > UINT32_MAX) return -EINVAL;
+  out->len = 0;
+  out->nlocals = nlocals;
+  out->max_stack = 0;
+  out->n_stack = 0;
+
+  int rc = 0;
+  vt_insn* ins = (vt_insn*)malloc(len * sizeof(vt_insn));
+  uint32_t* offs = (uint32_t*)malloc((len + 1) * sizeof(uint32_t));
+  uint32_t* at = (uint32_t*)malloc((len + 1) * sizeof(uint32_t));
+  uint32_t* tix = (uint32_t*)malloc(len * sizeof(uint32_t));
+  int32_t* depth = (int32_t*)malloc(len * sizeof(int32_t));
+  uint32_t* work = (uint32_t*)malloc((len + 1) * sizeof(uint32_t));
+  uint8_t* leader = (uint8_t*)calloc(len + 1, 1);
+  uint32_t* irmap = (uint32_t*)malloc((len + 1) * sizeof(uint32_t));
+  vt__ir_ctx c = {out, NULL, NULL, 0, 0, 0};
+  if (!ins || !offs || !at || !tix || !depth || !work || !leader || !irmap) {
+    rc = -ENOMEM;
+    goto done;
+  }
+
+  /* 1. décodage, table offset → index */
+  size_t n = 0;
+  for (size_t i = 0; i <= len; i++) at[i] = UINT32_MAX;
+  for (size_t off = 0; off < len;) {
+    size_t got = vt_decode(code + off, len - off, &ins[n]);
+    if (!got) {
+      rc = vt__ir_fail(err, errsz, "décodage @0x%zx", off);
+      goto done;
+    }
+    at[off] = (uint32_t)n;
+    offs[n++] = (uint32_t)off;
+    off += got;
+  }
+  offs[n] = (uint32_t)len;
+
+  /* 2. cibles */
+  for (size_t i = 0; i < n; i++) {
+    tix[i] = UINT32_MAX;
+    if (!vt__ir_has_rel(ins[i].op)) continue;
+    int64_t tgt = (int64_t)offs[i + 1] + (int64_t)(int32_t)ins[i].imm[0];
+    if (tgt < 0 || (uint64_t)tgt >= len || at[tgt] == UINT32_MAX) {
+      rc = vt__ir_fail(err, errsz, "cible invalide @0x%x", offs[i]);
+      goto done;
+    }
+    tix[i] = at[tgt];
+    leader[tix[i]] = 1;
+  }
+
+  /* 3. profondeur par flot de données */
+  int mx = 0;
+  size_t nw = 0;
+  for (size_t i = 0; i < n; i++) depth[i] = -1;
+  depth[0] = 0;
+  work[nw++] = 0;
+  while (nw) {
+    uint32_t i = work[--nw];
+    const vt_insn* in = &ins[i];
+    const vt_opcode_info* ii = vt_op_info(in->op);
+    int pop = 0, push = 0;
+    vt__ir_effect(in, &pop, &push);
+    if (pop < 0 || depth[i] < pop) {
+      rc = vt__ir_fail(err, errsz, "sous-pile @0x%x", offs[i]);
+      goto done;
+    }
+    int nd = depth[i] - pop + push;
+    if (nd > mx) mx = nd;
+    if (((in->op == OP_LD || in->op == OP_ST || in->op == OP_CAPTURE) &&
+         in->imm[0] >= nlocals) ||
+        (in->op == OP_LD_ADDI_ST &&
+         (in->imm[0] >= nlocals || in->imm[2] >= nlocals)) ||
+        (in->op == OP_CMP_JF && in->imm[1] > 5)) {
+      rc = vt__ir_fail(err, errsz, "opérande invalide @0x%x", offs[i]);
+      goto done;
+    }
+    uint32_t succ[2];
+    int32_t sd[2];
+    int ns = 0;
+    if (tix[i] != UINT32_MAX) {
+      succ[ns] = tix[i];
+      sd[ns++] = in->op == OP_TENTER ? nd + 1 : nd;
+      if (in->op == OP_TENTER && nd + 1 > mx) mx = nd + 1;
+    }
+    if (in->op != OP_JMP && !(ii->flags & VT_OF_TERM)) {
+      if (i + 1 >= n) {
+        rc = vt__ir_fail(err, errsz, "sortie de plage @0x%x", offs[i]);
+        goto done;
+      }
+      succ[ns] = i + 1;
+      sd[ns++] = nd;
+    }
+    for (int s = 0; s < ns; s++) {
+      if (depth[succ[s]] < 0) {
+        depth[succ[s]] = sd[s];
+        work[nw++] = succ[s];
+      } else if (depth[succ[s]] != sd[s]) {
+        rc = vt__ir_fail(err, errsz, "profondeur incohérente @0x%x",
+                         offs[succ[s]]);
+        goto done;
+      }
+    }
+  }
+  if ((size_t)nlocals + (size_t)mx + 1 > UINT16_MAX) {
+    rc = vt__ir_fail(err, errsz, "trop de registres");
+    goto done;
+  }
+  out->max_stack = (uint16_t)mx;
+
+  /* 4. traduction */
+  c.vs = (vt__ir_slot*)calloc((size_t)mx + 1, sizeof(vt__ir_slot));
+  c.prod = (int32_t*)calloc((size_t)mx + 1, sizeof(int32_t));
+  if (!c.vs || !c.prod) {
+    rc = -ENOMEM;
+    goto done;
+  }
+  int live = 1;
+  for (size_t i = 0; i < n && !c.oom; i++) {
+    if (depth[i] < 0) {
+      irmap[i] = (uint32_t)out->len; /* inatteignable: rien à émettre */
+      continue;
+    }
+    if (leader[i] || !live) {
+      if (live) vt__ir_flush(&c);
+      vt__ir_reset(&c, (uint32_t)depth[i]);
+      c.sp_depth = (i == 0 && !leader[i]) ? 0 : -1;
+      live = 1;
+    }
+    irmap[i] = (uint32_t)out->len;
+    out->n_stack++;
+
+    const vt_insn* in = &ins[i];
+    const uint32_t d0 = c.depth;
+    vt_ir_insn* e;
+    switch (in->op) {
+      case OP_NOP:
+        break;
+
+      case OP_ICONST:
+        c.vs[c.depth].kind = VT__IR_IMM;
+        c.vs[c.depth++].k = (int64_t)in->imm[0];
+        break;
+      case OP_FCONST:
+        e = vt__ir_emit(&c, VT_IR_LOADF);
+        e->d = vt__ir_home(&c, d0);
+        e->k = (int64_t)in->imm[0];
+        vt__ir_push_home(&c);
+        break;
+      case OP_SCONST:
+      case OP_LOADK:
+        e = vt__ir_emit(&c, VT_IR_LOADK);
+        e->d = vt__ir_home(&c, d0);
+        e->k = (int64_t)in->imm[0];
+        vt__ir_push_home(&c);
+        break;
+      case OP_LDG:
+        e = vt__ir_emit(&c, VT_IR_LDG);
+        e->d = vt__ir_home(&c, d0);
+        e->k = (int64_t)in->imm[0];
+        vt__ir_push_home(&c);
+        break;
+
+      case OP_LD:
+        c.vs[c.depth].kind = VT__IR_REG;
+        c.vs[c.depth++].r = (uint16_t)in->imm[0];
+        break;
+      case OP_ST: {
+        uint16_t L = (uint16_t)in->imm[0];
+        uint32_t top = --c.depth;
+        vt__ir_kill(&c, L);
+        vt__ir_slot s = c.vs[top];
+        if (s.kind == VT__IR_HOME && c.prod[top] >= 0 &&
+            (size_t)c.prod[top] == out->len - 1) {
+          out->code[c.prod[top]].d = L; /* élimination du slot de pile */
+        } else if (s.kind == VT__IR_REG) {
+          if (s.r != L) {
+            e = vt__ir_emit(&c, VT_IR_MOV);
+            e->d = L;
+            e->a = s.r;
+          }
+        } else if (s.kind == VT__IR_IMM) {
+          e = vt__ir_emit(&c, VT_IR_LOADI);
+          e->d = L;
+          e->k = s.k;
+        } else {
+          e = vt__ir_emit(&c, VT_IR_MOV);
+          e->d = L;
+          e->a = vt__ir_home(&c, top);
+        }
+      } break;
+      case OP_STG: {
+        uint16_t r = vt__ir_reg(&c, d0 - 1);
+        e = vt__ir_emit(&c, VT_IR_STG);
+        e->a = r;
+        e->k = (int64_t)in->imm[0];
+        c.depth--;
+      } break;
+      case OP_POP:
+        c.depth -= (uint32_t)in->imm[0];
+        break;
+      case OP_DUP:
+        if (c.vs[d0 - 1].kind == VT__IR_HOME) {
+          e = vt__ir_emit(&c, VT_IR_MOV);
+          e->d = vt__ir_home(&c, d0);
+          e->a = vt__ir_home(&c, d0 - 1);
+          vt__ir_push_home(&c);
+        } else {
+          c.vs[c.depth++] = c.vs[d0 - 1];
+        }
+        break;
+      case OP_SWAP:
+        if (c.vs[d0 - 1].kind != VT__IR_HOME &&
+            c.vs[d0 - 2].kind != VT__IR_HOME) {
+          vt__ir_slot t = c.vs[d0 - 1];
+          c.vs[d0 - 1] = c.vs[d0 - 2];
+          c.vs[d0 - 2] = t;
+          break;
+        }
+        goto stack;
+
+      case OP_ADD:
+      case OP_SUB:
+        if (c.vs[d0 - 1].kind == VT__IR_IMM &&
+            !(in->op == OP_SUB && c.vs[d0 - 1].k == INT64_MIN)) {
+          int64_t k = c.vs[d0 - 1].k;
+          uint16_t ra = vt__ir_reg(&c, d0 - 2);
+          e = vt__ir_emit(&c, VT_IR_ADDI);
+          e->d = vt__ir_home(&c, d0 - 2);
+          e->a = ra;
+          e->k = in->op == OP_SUB ? -k : k;
+          c.depth = d0 - 2;
+          vt__ir_push_home(&c);
+          break;
+        }
+        /* fallthrough */
+      case OP_MUL:
+      case OP_DIV:
+      case OP_MOD: {
+        uint16_t ra = vt__ir_reg(&c, d0 - 2);
+        uint16_t rb = vt__ir_reg(&c, d0 - 1);
+        e = vt__ir_emit(&c, (vt_ir_op)(VT_IR_ADD + (in->op - OP_ADD)));
+        e->d = vt__ir_home(&c, d0 - 2);
+        e->a = ra;
+        e->b = rb;
+        c.depth = d0 - 2;
+        vt__ir_push_home(&c);
+      } break;
+      case OP_NEG:
+      case OP_NOT: {
+        uint16_t ra = vt__ir_reg(&c, d0 - 1);
+        e = vt__ir_emit(&c, in->op == OP_NEG ? VT_IR_NEG : VT_IR_NOT);
+        e->d = vt__ir_home(&c, d0 - 1);
+        e->a = ra;
+        c.depth = d0 - 1;
+        vt__ir_push_home(&c);
+      } break;
+
+      case OP_EQ:
+      case OP_NE:
+      case OP_LT:
+      case OP_LE:
+      case OP_GT:
+      case OP_GE:
+      case OP_CMP_JF: {
+        uint8_t cond = (uint8_t)(in->op == OP_CMP_JF ? in->imm[1]
+                                                      : in->op - OP_EQ);
+        size_t j = i; /* insn portant la cible */
+        if (in->op != OP_CMP_JF) {
+          if (i + 1 < n && ins[i + 1].op == OP_JF && !leader[i + 1]) {
+            j = i + 1;
+          } else {
+            uint16_t ra = vt__ir_reg(&c, d0 - 2);
+            uint16_t rb = vt__ir_reg(&c, d0 - 1);
+            e = vt__ir_emit(&c, (vt_ir_op)(VT_IR_EQ + cond));
+            e->d = vt__ir_home(&c, d0 - 2);
+            e->a = ra;
+            e->b = rb;
+            c.depth = d0 - 2;
+            vt__ir_push_home(&c);
+            break;
+          }
+        }
+        const vt__ir_slot sb = c.vs[d0 - 1];
+        uint16_t ra = vt__ir_reg(&c, d0 - 2);
+        int imm = sb.kind == VT__IR_IMM && sb.k >= INT32_MIN && sb.k <= INT32_MAX;
+        uint16_t rb = imm ? 0 : vt__ir_reg(&c, d0 - 1);
+        c.depth = d0 - 2;
+        vt__ir_flush(&c); /* n’écrit que des maisons < d0-2 */
+        e = vt__ir_emit(&c, imm ? VT_IR_CMPJFI : VT_IR_CMPJF);
+        e->cond = cond;
+        e->a = ra;
+        e->b = rb;
+        e->k = imm ? sb.k : 0;
+        e->t = tix[j];
+        if (j != i) {
+          irmap[++i] = (uint32_t)out->len - 1;
+          out->n_stack++;
+        }
+      } break;
+
+      case OP_LD_ADDI_ST: {
+        uint16_t L = (uint16_t)in->imm[2];
+        vt__ir_kill(&c, L);
+        e = vt__ir_emit(&c, VT_IR_ADDI);
+        e->d = L;
+        e->a = (uint16_t)in->imm[0];
+        e->k = (int64_t)in->imm[1];
+      } break;
+
+      case OP_JMP:
+        vt__ir_flush(&c);
+        e = vt__ir_emit(&c, VT_IR_JMP);
+        e->t = tix[i];
+        live = 0;
+        break;
+      case OP_JT:
+      case OP_JF: {
+        uint16_t r = vt__ir_reg(&c, d0 - 1);
+        c.depth = d0 - 1;
+        vt__ir_flush(&c);
+        e = vt__ir_emit(&c, in->op == OP_JT ? VT_IR_JT : VT_IR_JF);
+        e->a = r;
+        e->t = tix[i];
+      } break;
+
+      default:
+      stack : {
+        int pop = 0, push = 0;
+        vt__ir_effect(in, &pop, &push);
+        vt__ir_flush(&c);
+        if (c.sp_depth != (int32_t)d0) {
+          e = vt__ir_emit(&c, VT_IR_SETSP);
+          e->a = vt__ir_home(&c, d0);
+        }
+        e = vt__ir_emit(&c, VT_IR_STK);
+        e->sop = (uint16_t)in->op;
+        e->k = (int64_t)in->imm[0];
+        e->k2 = in->imm[1];
+        e->t = tix[i];
+        vt__ir_reset(&c, d0 - (uint32_t)pop + (uint32_t)push);
+        c.sp_depth = (int32_t)c.depth;
+        if (vt_op_info(in->op)->flags & VT_OF_TERM) live = 0;
+      } break;
+    }
+  }
+  if (c.oom) {
+    rc = -ENOMEM;
+    goto done;
+  }
+
+  /* 5. cibles: index bytecode → index IR */
+  for (size_t i = 0; i < out->len; i++) {
+    vt_ir_insn* in = &out->code[i];
+    int jump = in->op == VT_IR_JMP || in->op == VT_IR_JT ||
+               in->op == VT_IR_JF || in->op == VT_IR_CMPJF ||
+               in->op == VT_IR_CMPJFI ||
+               (in->op == VT_IR_STK && vt__ir_has_rel((vt_opcode)in->sop));
+    if (jump) in->t = irmap[in->t];
+  }
+
+done:
+  free(c.vs);
+  free(c.prod);
+  free(irmap);
+  free(leader);
+  free(work);
+  free(depth);
+  free(tix);
+  free(at);
+  free(offs);
+  free(ins);
+  if (rc != 0) out->len = 0;
+  return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Dump                                                                       */
+/* -------------------------------------------------------------------------- */
+static void vt__ir_reg_name(char* buf, size_t n, const vt_ir* ir, uint16_t r) {
+  if (r < ir->nlocals)
+    snprintf(buf, n, "l%u", r);
+  else
+    snprintf(buf, n, "s%u", (unsigned)(r - ir->nlocals));
+}
+
+void vt_ir_dump(FILE* out, const vt_ir* ir) {
+  if (!out) out = stderr;
+  fprintf(out, "ir: %zu insn(s) pour %zu insn(s) pile, %u locaux, pile max %u\n",
+          ir->len, ir->n_stack, ir->nlocals, ir->max_stack);
+  for (size_t i = 0; i < ir->len; i++) {
+    const vt_ir_insn* in = &ir->code[i];
+    char d[16], a[16], b[16];
+    vt__ir_reg_name(d, sizeof d, ir, in->d);
+    vt__ir_reg_name(a, sizeof a, ir, in->a);
+    vt__ir_reg_name(b, sizeof b, ir, in->b);
+    fprintf(out, "  %04zu: %-7s", i, vt_ir_op_name((vt_ir_op)in->op));
+    switch (in->op) {
+      case VT_IR_MOV:
+      case VT_IR_NEG:
+      case VT_IR_NOT:
+        fprintf(out, "%s, %s\n", d, a);
+        break;
+      case VT_IR_LOADI:
+        fprintf(out, "%s, %lld\n", d, (long long)in->k);
+        break;
+      case VT_IR_LOADF: {
+        double f;
+        memcpy(&f, &in->k, sizeof f);
+        fprintf(out, "%s, %g\n", d, f);
+      } break;
+      case VT_IR_LOADK:
+        fprintf(out, "%s, k#%lld\n", d, (long long)in->k);
+        break;
+      case VT_IR_LDG:
+        fprintf(out, "%s, g#%lld\n", d, (long long)in->k);
+        break;
+      case VT_IR_STG:
+        fprintf(out, "g#%lld, %s\n", (long long)in->k, a);
+        break;
+      case VT_IR_ADDI:
+        fprintf(out, "%s, %s, %lld\n", d, a, (long long)in->k);
+        break;
+      case VT_IR_JMP:
+        fprintf(out, "-> %04u\n", in->t);
+        break;
+      case VT_IR_JT:
+      case VT_IR_JF:
+        fprintf(out, "%s -> %04u\n", a, in->t);
+        break;
+      case VT_IR_CMPJF:
+        fprintf(out, "%s %s %s -> %04u\n", a, VT_IR_CONDS[in->cond % 6], b,
+                in->t);
+        break;
+      case VT_IR_CMPJFI:
+        fprintf(out, "%s %s %lld -> %04u\n", a, VT_IR_CONDS[in->cond % 6],
+                (long long)in->k, in->t);
+        break;
+      case VT_IR_SETSP:
+        fprintf(out, "%s\n", a);
+        break;
+      case VT_IR_STK: {
+        const vt_opcode_info* ii = vt_op_info((vt_opcode)in->sop);
+        fprintf(out, "%s", ii ? ii->name : "?");
+        if (in->op == VT_IR_STK && vt__ir_has_rel((vt_opcode)in->sop))
+          fprintf(out, " -> %04u", in->t);
+        else if (ii && ii->argc)
+          fprintf(out, " %lld", (long long)in->k);
+        if (ii && ii->argc > 1) fprintf(out, ", %llu", (unsigned long long)in->k2);
+        fputc('\n', out);
+      } break;
+      default: /* binaires et comparaisons */
+        fprintf(out, "%s, %s, %s\n", d, a, b);
+        break;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------------
+   Test rapide: cc -std=c17 -DVT_IR_TEST ir.c opcodes.c
+---------------------------------------------------------------------------- */
+#ifdef VT_IR_TEST
+static void t_op(vt_bcode* bc, vt_opcode op, uint64_t a, uint64_t b) {
+  uint64_t imm[3] = {a, b, 0};
+  vt_emit_insn(bc, op, imm);
+}
+
+int main(void) {
+  /* l1 = 0 ; l0 = 0 ; while (l0 < 1000) { l1 = l1 + l0 * 2 ; l0 = l0 + 1 }
+     ; halt l1 */
+  vt_bcode bc;
+  vt_bcode_init(&bc);
+  t_op(&bc, OP_ICONST, 0, 0);
+  t_op(&bc, OP_ST, 1, 0);
+  t_op(&bc, OP_ICONST, 0, 0);
+  t_op(&bc, OP_ST, 0, 0);
+  size_t top = bc.len;
+  t_op(&bc, OP_LD, 0, 0);
+  t_op(&bc, OP_ICONST, 1000, 0);
+  t_op(&bc, OP_LT, 0, 0);
+  size_t jf = bc.len;
+  t_op(&bc, OP_JF, 0, 0);
+  t_op(&bc, OP_LD, 1, 0);
+  t_op(&bc, OP_LD, 0, 0);
+  t_op(&bc, OP_ICONST, 2, 0);
+  t_op(&bc, OP_MUL, 0, 0);
+  t_op(&bc, OP_ADD, 0, 0);
+  t_op(&bc, OP_ST, 1, 0);
+  t_op(&bc, OP_LD, 0, 0);
+  t_op(&bc, OP_ICONST, 1, 0);
+  t_op(&bc, OP_ADD, 0, 0);
+  t_op(&bc, OP_ST, 0, 0);
+  size_t jmp = bc.len;
+  t_op(&bc, OP_JMP, 0, 0);
+  vt_patch_rel32(bc.data, jmp, (int32_t)((int64_t)top - (int64_t)(jmp + 5)));
+  vt_patch_rel32(bc.data, jf, (int32_t)((int64_t)bc.len - (int64_t)(jf + 5)));
+  t_op(&bc, OP_LD, 1, 0);
+  t_op(&bc, OP_HALT, 0, 0);
+
+  vt_ir ir;
+  vt_ir_init(&ir);
+  char err[128] = "";
+  int rc = vt_ir_lower(bc.data, bc.len, 2, &ir, err, sizeof err);
+  if (rc != 0) {
+    printf("lower: %d %s\n", rc, err);
+    return 1;
+  }
+  vt_ir_dump(stdout, &ir);
+  vt_ir_free(&ir);
+  vt_bcode_free(&bc);
+  return 0;
+}
+#endif
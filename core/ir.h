@@ -0,0 +1,101 @@
+/* ============================================================================
+   ir.h — IR à registres pour le bytecode VTBC (C17, MIT)
+   - Abaissement d’un flux CODE à pile (vt_opcode) vers une forme 3 adresses
+   - Registres = slots du frame: [0, nlocals) locaux, puis un temporaire par
+     profondeur de pile (registre nlocals + d pour la profondeur d)
+   - Propagation de copies (LD/ICONST ne génèrent rien), élimination des
+     slots de pile (ST réécrit la destination du producteur, POP gratuit),
+     comparaison + saut fusionnés
+   - Les opcodes non traduits restent des insns pile (VT_IR_STK) exécutées
+     avec sp recalé (VT_IR_SETSP)
+   ============================================================================
+ */
+#ifndef VT_IR_H
+#define VT_IR_H
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VT_IR_API
+#define VT_IR_API extern
+#endif
+
+/* ---------------------------------------------------------------------------
+   Opérations
+   d/a/b: registres ; k: immédiat ; t: cible (index d’insn IR)
+--------------------------------------------------------------------------- */
+typedef enum vt_ir_op {
+  VT_IR_MOV = 0, /* d = a                                   */
+  VT_IR_LOADI,   /* d = int k                               */
+  VT_IR_LOADF,   /* d = float (bits de k)                   */
+  VT_IR_LOADK,   /* d = const[k]                            */
+  VT_IR_LDG,     /* d = global[k]                           */
+  VT_IR_STG,     /* global[k] = a                           */
+  VT_IR_ADD,     /* d = a + b (mêmes règles que OP_ADD)     */
+  VT_IR_SUB,
+  VT_IR_MUL,
+  VT_IR_DIV,
+  VT_IR_MOD,
+  VT_IR_ADDI, /* d = a + k                               */
+  VT_IR_NEG,  /* d = -a                                  */
+  VT_IR_NOT,  /* d = !a                                  */
+  VT_IR_EQ,   /* d = a == b … d = a >= b                 */
+  VT_IR_NE,
+  VT_IR_LT,
+  VT_IR_LE,
+  VT_IR_GT,
+  VT_IR_GE,
+  VT_IR_JMP,   /* -> t                                    */
+  VT_IR_JT,    /* a vrai -> t                             */
+  VT_IR_JF,    /* a faux -> t                             */
+  VT_IR_CMPJF, /* !(a cond b) -> t   (cond 0=eq..5=ge)    */
+  VT_IR_CMPJFI, /* !(a cond k) -> t  (k int32)            */
+  VT_IR_SETSP, /* sp = registre a (nlocals + profondeur)  */
+  VT_IR_STK,   /* insn pile sop/k/k2 (t si rel32)         */
+  VT_IR__COUNT
+} vt_ir_op;
+
+typedef struct vt_ir_insn {
+  uint8_t op;     /* vt_ir_op */
+  uint8_t cond;   /* CMPJF/CMPJFI: condition */
+  uint16_t sop;   /* STK: vt_opcode d’origine */
+  uint16_t d, a, b;
+  int64_t k;      /* immédiat ; STK: imm[0] */
+  uint64_t k2;    /* STK: imm[1] */
+  uint32_t t;     /* cible */
+  uint16_t live;  /* registres [0, live) valides ici (racines si l’insn lève) */
+} vt_ir_insn;
+
+typedef struct vt_ir {
+  vt_ir_insn* code;
+  size_t len, cap;
+  uint16_t nlocals;
+  uint16_t max_stack; /* profondeur max: registres = nlocals + max_stack */
+  size_t n_stack;     /* insns pile atteignables en entrée (statistique) */
+} vt_ir;
+
+/* ---------------------------------------------------------------------------
+   API
+--------------------------------------------------------------------------- */
+VT_IR_API void vt_ir_init(vt_ir* ir);
+VT_IR_API void vt_ir_free(vt_ir* ir);
+
+/* Abaisse code[0..len) (une fonction, cibles de saut internes) avec nlocals
+   locaux. Vérifie opérandes et profondeur de pile par flot de données.
+   0=OK, -ENOEXEC code invalide (message dans err), -ENOMEM. */
+VT_IR_API int vt_ir_lower(const uint8_t* code, size_t len, uint16_t nlocals,
+                          vt_ir* out, char* err, size_t errsz);
+
+VT_IR_API const char* vt_ir_op_name(vt_ir_op op);
+VT_IR_API void vt_ir_dump(FILE* out, const vt_ir* ir);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* VT_IR_H */
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+/* ============================================================================
+   jit.c — Tampons de code natif (templates + correctifs, pages W^X)
+
+   Le tampon d’assemblage vit en mémoire ordinaire; vt_jit_seal copie le
+   résultat dans des pages fraîches (vt_page_alloc), puis retire l’écriture
+   et ajoute l’exécution via mm_protect. Une fois scellé, le code n’est
+   plus jamais modifié: pas de cache d’instructions à invalider sur x86-64.
+   ============================================================================ */
+
+#include "jit.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mem.h"
+#include "mmap.h"
+
+void vt_jit_buf_init(vt_jit_buf* b) { memset(b, 0, sizeof *b); }
+
+void vt_jit_buf_free(vt_jit_buf* b) {
+  if (!b) return;
+  free(b->data);
+  vt_jit_buf_init(b);
+}
+
+size_t vt_jit_put(vt_jit_buf* b, const uint8_t* tpl, size_t n) {
+  size_t at = b->len;
+  if (b->oom) return at;
+  if (b->len + n > b->cap) {
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < b->len + n) cap *= 2;
+    uint8_t* d = (uint8_t*)realloc(b->data, cap);
+    if (!d) {
+      b->oom = 1;
+      return at;
+    }
+    b->data = d;
+    b->cap = cap;
+  }
+  memcpy(b->data + b->len, tpl, n);
+  b->len += n;
+  return at;
+}
+
+void vt_jit_set8(vt_jit_buf* b, size_t at, uint8_t v) {
+  if (!b->oom && at < b->len) b->data[at] = v;
+}
+
+void vt_jit_set32(vt_jit_buf* b, size_t at, uint32_t v) {
+  if (b->oom || at + 4 > b->len) return;
+  for (int i = 0; i < 4; i++) b->data[at + i] = (uint8_t)(v >> (8 * i));
+}
+
+void vt_jit_set64(vt_jit_buf* b, size_t at, uint64_t v) {
+  if (b->oom || at + 8 > b->len) return;
+  for (int i = 0; i < 8; i++) b->data[at + i] = (uint8_t)(v >> (8 * i));
+}
+
+void vt_jit_rel32(vt_jit_buf* b, size_t at, size_t target) {
+  vt_jit_set32(b, at, (uint32_t)((int64_t)target - (int64_t)(at + 4)));
+}
+
+int vt_jit_seal(const vt_jit_buf* b, vt_jit_code* out) {
+  memset(out, 0, sizeof *out);
+#if VT_JIT_X86_64
+  if (b->oom || !b->len) return -ENOMEM;
+  void* p = vt_page_alloc(b->len);
+  if (!p) return -ENOMEM;
+  memcpy(p, b->data, b->len);
+  mm_region r;
+  memset(&r, 0, sizeof r);
+  r.ptr = p;
+  r.size = b->len;
+  r.fd = -1;
+  if (mm_protect(&r, MM_PROT_READ | MM_PROT_EXEC) != 0) {
+    vt_page_free(p, b->len);
+    return -EACCES;
+  }
+  out->mem = p;
+  out->size = b->len;
+  return 0;
+#else
+  (void)b;
+  return -ENOTSUP;
+#endif
+}
+
+void vt_jit_release(vt_jit_code* c) {
+  if (!c || !c->mem) return;
+  vt_page_free(c->mem, c->size);
+  c->mem = NULL;
+  c->size = 0;
+}
+
+/* ----------------------------------------------------------------------------
+   Test rapide: cc -std=gnu17 -DVT_JIT_TEST jit.c mem.c mmap.c
+---------------------------------------------------------------------------- */
+#ifdef VT_JIT_TEST
+#include <stdio.h>
+
+int main(void) {
+#if VT_JIT_X86_64
+  /* f(): jmp L ; mov eax, 1 ; ret ; L: mov eax, imm32 ; ret */
+  static const uint8_t T_JMP[] = {0xe9, 0, 0, 0, 0};
+  static const uint8_t T_RET[] = {0xb8, 0, 0, 0, 0, 0xc3};
+  vt_jit_buf b;
+  vt_jit_buf_init(&b);
+  size_t j = vt_jit_put(&b, T_JMP, sizeof T_JMP);
+  size_t r1 = vt_jit_put(&b, T_RET, sizeof T_RET);
+  vt_jit_set32(&b, r1 + 1, 1);
+  size_t r2 = vt_jit_put(&b, T_RET, sizeof T_RET);
+  vt_jit_set32(&b, r2 + 1, 42);
+  vt_jit_rel32(&b, j + 1, r2);
+  vt_jit_code c;
+  int rc = vt_jit_seal(&b, &c);
+  vt_jit_buf_free(&b);
+  if (rc != 0) {
+    printf("seal: %d\n", rc);
+    return 1;
+  }
+  int (*f)(void) = (int (*)(void))(uintptr_t)c.mem;
+  int v = f();
+  vt_jit_release(&c);
+  printf("jit: %d (%s)\n", v, v == 42 ? "OK" : "KO");
+  return v == 42 ? 0 : 1;
+#else
+  printf("jit: cible non supportée\n");
+  return 0;
+#endif
+}
+#endif /* VT_JIT_TEST */
@@ -0,0 +1,70 @@
+/* ============================================================================
+   jit.h — Tampons de code natif pour le JIT de base (C17, MIT)
+   - Assemblage par copie de templates (octets pré-assemblés) + correctifs
+     (disp32/imm32/imm64, rel32 entre offsets du tampon)
+   - Scellement dans des pages propres (vt_page_alloc, mem.h) passées en
+     lecture+exécution par mm_protect (mmap.h): jamais W et X à la fois
+   - Cible: x86-64 System V (Linux, *BSD, macOS Intel). Ailleurs,
+     VT_JIT_X86_64 vaut 0 et vt_jit_seal renvoie -ENOTSUP
+   ============================================================================
+ */
+#ifndef VT_JIT_H
+#define VT_JIT_H
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VT_JIT_API
+#define VT_JIT_API extern
+#endif
+
+#if defined(__x86_64__) && !defined(_WIN32) && !defined(VT_JIT_DISABLE)
+#define VT_JIT_X86_64 1
+#else
+#define VT_JIT_X86_64 0
+#endif
+
+/* ---------------------------------------------------------------------------
+   Tampon d’assemblage (mémoire ordinaire, non exécutable)
+--------------------------------------------------------------------------- */
+typedef struct vt_jit_buf {
+  uint8_t* data;
+  size_t len, cap;
+  int oom; /* 1 après un échec d’allocation: seal échoue */
+} vt_jit_buf;
+
+VT_JIT_API void vt_jit_buf_init(vt_jit_buf* b);
+VT_JIT_API void vt_jit_buf_free(vt_jit_buf* b);
+
+/* Copie n octets de template en fin de tampon; renvoie leur offset. */
+VT_JIT_API size_t vt_jit_put(vt_jit_buf* b, const uint8_t* tpl, size_t n);
+
+/* Correctifs LE à l’offset at (déjà émis). */
+VT_JIT_API void vt_jit_set8(vt_jit_buf* b, size_t at, uint8_t v);
+VT_JIT_API void vt_jit_set32(vt_jit_buf* b, size_t at, uint32_t v);
+VT_JIT_API void vt_jit_set64(vt_jit_buf* b, size_t at, uint64_t v);
+/* rel32 en at (fin du champ = at + 4) vers l’offset target. */
+VT_JIT_API void vt_jit_rel32(vt_jit_buf* b, size_t at, size_t target);
+
+/* ---------------------------------------------------------------------------
+   Code scellé (pages R+X)
+--------------------------------------------------------------------------- */
+typedef struct vt_jit_code {
+  void* mem;   /* NULL si vide */
+  size_t size; /* taille mappée (multiple de la page) */
+} vt_jit_code;
+
+/* Copie b dans des pages neuves puis les protège en R+X.
+   0=OK, -ENOMEM, -EACCES (W^X refusé par le système), -ENOTSUP. */
+VT_JIT_API int vt_jit_seal(const vt_jit_buf* b, vt_jit_code* out);
+VT_JIT_API void vt_jit_release(vt_jit_code* c);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* VT_JIT_H */
@@ -2,10 +2,12 @@
 /* ============================================================================
    mem.c — Allocateurs et utilitaires mémoire « ultra complet » (C17)
    - Wrappers sûrs (stats OOM)
+   - Backend optionnel à caches par thread (VT_MEM_TCACHE): classes de
+     tailles, slabs sur vt_page_alloc, stats par thread fusionnées
    - Aligned alloc cross-platform
    - Pages OS (mmap/VirtualAlloc)
-   - Arena allocator (mark/reset)
-   - Pool fixe (free-list)
+   - Arena allocator (mark/reset), chunks mmap (huge pages, NUMA) en option
+   - Pool fixe (free-list), mode concurrent à magazines par thread
    - Buffer dynamique (vt_buf)
    ============================================================================ */
 
@@ -35,6 +37,9 @@
 #else
 #  include <sys/mman.h>
 #  include <unistd.h>
+#  if defined(__linux__)
+#    include <sys/syscall.h> /* mbind sans libnuma */
+#  endif
 #endif
 
 /* ----------------------------------------------------------------------------
@@ -44,6 +49,27 @@
 #  define VT_MEM_DEFAULT_ABORT_ON_OOM 1
 #endif
 
+/* Le bench compare les deux chemins: il a besoin du backend. */
+#if defined(VT_MEM_BENCH) && !defined(VT_MEM_TCACHE)
+#  define VT_MEM_TCACHE 1
+#endif
+
+#if !defined(__STDC_NO_THREADS__)
+#  define VT_MEM_HAS_THREADS 1
+#  include <threads.h>
+#  if defined(_WIN32)
+#    define VT_TLS __declspec(thread)
+#  else
+#    define VT_TLS _Thread_local
+#  endif
+#else
+#  define VT_MEM_HAS_THREADS 0
+#endif
+
+#if defined(VT_MEM_TCACHE) && !VT_MEM_HAS_THREADS
+#  error "VT_MEM_TCACHE: <threads.h> requis"
+#endif
+
 /* ----------------------------------------------------------------------------
    Stats globales
 ---------------------------------------------------------------------------- */
@@ -64,12 +90,19 @@ static void vt__stats_on_free(size_t n) {
   atomic_fetch_add(&g_total_free, 1);
 }
 
+#ifdef VT_MEM_TCACHE
+static void vt__tc_merge_stats(vt_mem_stats* out);
+#endif
+
 void vt_mem_get_stats(vt_mem_stats* out) {
   if (!out) return;
   out->cur_bytes    = atomic_load(&g_cur_bytes);
   out->peak_bytes   = atomic_load(&g_peak_bytes);
   out->total_allocs = atomic_load(&g_total_alloc);
   out->total_frees  = atomic_load(&g_total_free);
+#ifdef VT_MEM_TCACHE
+  vt__tc_merge_stats(out);
+#endif
 }
 
 void vt_mem_set_abort_on_oom(int on) { atomic_store(&g_abort_oom, on ? 1 : 0); }
@@ -99,9 +132,12 @@ static void vt__oom_abort(size_t n) {
 }
 
 /* ----------------------------------------------------------------------------
-   Allocations de base
+   Allocations de base (libc + en-tête, stats globales)
 ---------------------------------------------------------------------------- */
-void* vt_malloc(size_t n) {
+#if !defined(VT_MEM_TCACHE) || defined(VT_MEM_BENCH)
+static void vt__sys_free(void* p);
+
+static void* vt__sys_malloc(size_t n) {
   if (n == 0) n = 1;
   size_t need = sizeof(vt__hdr) + n;
   vt__hdr* h = (vt__hdr*)malloc(need);
@@ -111,8 +147,9 @@ void* vt_malloc(size_t n) {
   return vt__user_from_hdr(h);
 }
 
-void* vt_calloc(size_t nmemb, size_t size) {
-  if (nmemb == 0 || size == 0) return vt_malloc(1);
+#ifndef VT_MEM_TCACHE
+static void* vt__sys_calloc(size_t nmemb, size_t size) {
+  if (nmemb == 0 || size == 0) return vt__sys_malloc(1);
   if (SIZE_MAX / size < nmemb) { if (atomic_load(&g_abort_oom)) vt__oom_abort(SIZE_MAX); errno = ENOMEM; return NULL; }
   size_t n = nmemb * size;
   size_t need = sizeof(vt__hdr) + n;
@@ -123,9 +160,9 @@ void* vt_calloc(size_t nmemb, size_t size) {
   return vt__user_from_hdr(h);
 }
 
-void* vt_realloc(void* p, size_t n) {
-  if (!p) return vt_malloc(n);
-  if (n == 0) { vt_free(p); return vt_malloc(1); }
+static void* vt__sys_realloc(void* p, size_t n) {
+  if (!p) return vt__sys_malloc(n);
+  if (n == 0) { vt__sys_free(p); return vt__sys_malloc(1); }
   vt__hdr* h = vt__hdr_from_user(p);
   size_t old = h->sz;
   if (h->align) {
@@ -142,13 +179,314 @@ void* vt_realloc(void* p, size_t n) {
   if (n > old) vt__stats_on_alloc(n - old); else vt__stats_on_free(old - n);
   return vt__user_from_hdr(nh);
 }
+#endif /* !VT_MEM_TCACHE */
 
-void vt_free(void* p) {
+static void vt__sys_free(void* p) {
   if (!p) return;
   vt__hdr* h = vt__hdr_from_user(p);
   vt__stats_on_free(h->sz);
   free(h);
 }
+#endif
+
+/* ----------------------------------------------------------------------------
+   Backend à caches par thread (VT_MEM_TCACHE)
+   - 84 classes: pas de 16 o jusqu’à 1 Kio, puis 4 par puissance de 2
+     jusqu’à 32 Kio; au-delà, libc.
+   - Un bloc = en-tête vt__hdr (align = VT__SLAB) + charge utile; les blocs
+     libres sont chaînés par leur en-tête.
+   - Cache du thread: une pile par classe, sans verrou. Vide: un lot pris
+     sur la liste centrale de la classe (mutex), ou une page neuve
+     (vt_page_alloc) découpée. Trop pleine: un lot rendu au centre. Un bloc
+     peut être libéré par un autre thread que celui qui l’a alloué.
+   - Stats par thread (un seul écrivain, pas d’instruction atomique
+     verrouillée); les octets sont reversés au global par paquets de
+     256 Kio, ce qui tient le pic à jour à nthreads × 256 Kio près.
+---------------------------------------------------------------------------- */
+#ifdef VT_MEM_TCACHE
+#define VT__SLAB       ((size_t)1)     /* vt__hdr.align d’un bloc de slab */
+#define VT__TC_NCLASS  84
+#define VT__TC_MAX     ((size_t)32768)
+#define VT__TC_SPAN    ((size_t)64 << 10)
+#define VT__TC_FOLD    ((size_t)256 << 10)
+
+typedef struct { vt__hdr* head; uint32_t n; } vt__tbin;
+
+typedef struct vt__tcache {
+  struct vt__tcache* next; /* registre des threads vivants */
+  vt__tbin bin[VT__TC_NCLASS];
+  _Atomic size_t allocs, frees; /* écrits par le seul propriétaire */
+  _Atomic size_t bytes;         /* alloué - libéré (mod 2^N), non reversé */
+} vt__tcache;
+
+typedef struct { mtx_t lock; vt__hdr* head; } vt__tcentral;
+
+static vt__tcentral vt__tc_central[VT__TC_NCLASS];
+static mtx_t        vt__tc_reg_lock;
+static vt__tcache*  vt__tc_reg;
+static tss_t        vt__tc_key;
+static once_flag    vt__tc_once = ONCE_FLAG_INIT;
+
+static VT_TLS vt__tcache vt__tc;
+static VT_TLS int        vt__tc_state; /* 0 neuf, 1 actif, 2 thread fini */
+
+static inline unsigned vt__tc_class(size_t n) {
+  if (n <= 1024) return (unsigned)((n + 15) >> 4) - 1;
+  size_t base = 1024; unsigned c = 64;
+  while (n > base * 2) { base *= 2; c += 4; }
+  return c + (unsigned)((n - base - 1) / (base / 4));
+}
+static inline size_t vt__tc_size(unsigned c) {
+  if (c < 64) return ((size_t)c + 1) * 16;
+  size_t base = (size_t)1024 << ((c - 64) / 4);
+  return base + ((c - 64) % 4 + 1) * (base / 4);
+}
+static inline size_t vt__tc_block(unsigned c) { return sizeof(vt__hdr) + vt__tc_size(c); }
+static inline uint32_t vt__tc_batch(unsigned c) {
+  size_t b = VT__TC_SPAN / vt__tc_block(c);
+  return (uint32_t)(b < 2 ? 2 : b > 32 ? 32 : b);
+}
+
+/* Compteurs à écrivain unique: chargement + rangement relâchés. */
+static inline void vt__tc_add(_Atomic size_t* c, size_t n) {
+  atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n,
+                        memory_order_relaxed);
+}
+static void vt__tc_fold(vt__tcache* t) {
+  size_t d = atomic_load_explicit(&t->bytes, memory_order_relaxed);
+  atomic_store_explicit(&t->bytes, 0, memory_order_relaxed);
+  if ((ptrdiff_t)d < 0) { atomic_fetch_sub(&g_cur_bytes, (size_t)0 - d); return; }
+  size_t cur = atomic_fetch_add(&g_cur_bytes, d) + d;
+  size_t peak = atomic_load(&g_peak_bytes);
+  while (cur > peak && !atomic_compare_exchange_weak(&g_peak_bytes, &peak, cur)) {}
+}
+/* delta modulo 2^N: -n s’écrit (size_t)0 - n */
+static inline void vt__tc_bytes(vt__tcache* t, size_t delta) {
+  size_t d = atomic_load_explicit(&t->bytes, memory_order_relaxed) + delta;
+  atomic_store_explicit(&t->bytes, d, memory_order_relaxed);
+  if (d + VT__TC_FOLD > 2 * VT__TC_FOLD) vt__tc_fold(t); /* |d| > FOLD */
+}
+
+static void vt__tc_push_central(unsigned c, vt__hdr* first, vt__hdr* last) {
+  vt__tcentral* k = &vt__tc_central[c];
+  mtx_lock(&k->lock);
+  *(vt__hdr**)last = k->head;
+  k->head = first;
+  mtx_unlock(&k->lock);
+}
+
+/* Rend tout le cache au centre et reverse les stats (fin de thread). */
+static void vt__tc_release(void* arg) {
+  vt__tcache* t = (vt__tcache*)arg;
+  if (!t) return;
+  for (unsigned c = 0; c < VT__TC_NCLASS; c++) {
+    vt__hdr* h = t->bin[c].head;
+    if (!h) continue;
+    vt__hdr* last = h;
+    while (*(vt__hdr**)last) last = *(vt__hdr**)last;
+    vt__tc_push_central(c, h, last);
+    t->bin[c].head = NULL; t->bin[c].n = 0;
+  }
+  mtx_lock(&vt__tc_reg_lock);
+  vt__tcache** pp = &vt__tc_reg;
+  while (*pp && *pp != t) pp = &(*pp)->next;
+  if (*pp) *pp = t->next;
+  vt__tc_fold(t);
+  atomic_fetch_add(&g_total_alloc, atomic_load_explicit(&t->allocs, memory_order_relaxed));
+  atomic_fetch_add(&g_total_free, atomic_load_explicit(&t->frees, memory_order_relaxed));
+  atomic_store_explicit(&t->allocs, 0, memory_order_relaxed);
+  atomic_store_explicit(&t->frees, 0, memory_order_relaxed);
+  mtx_unlock(&vt__tc_reg_lock);
+  vt__tc_state = 2;
+}
+
+static void vt__tc_init(void) {
+  if (mtx_init(&vt__tc_reg_lock, mtx_plain) != thrd_success ||
+      tss_create(&vt__tc_key, vt__tc_release) != thrd_success) {
+    fprintf(stderr, "[mem] tcache: init impossible\n");
+    abort();
+  }
+  for (unsigned c = 0; c < VT__TC_NCLASS; c++)
+    if (mtx_init(&vt__tc_central[c].lock, mtx_plain) != thrd_success) abort();
+}
+
+/* Cache du thread courant; NULL si le thread est en cours de sortie. */
+static inline vt__tcache* vt__tc_get(void) {
+  if (vt__tc_state == 1) return &vt__tc;
+  if (vt__tc_state == 2) return NULL;
+  call_once(&vt__tc_once, vt__tc_init);
+  mtx_lock(&vt__tc_reg_lock);
+  vt__tc.next = vt__tc_reg;
+  vt__tc_reg = &vt__tc;
+  mtx_unlock(&vt__tc_reg_lock);
+  tss_set(vt__tc_key, &vt__tc);
+  vt__tc_state = 1;
+  return &vt__tc;
+}
+
+static void vt__tc_merge_stats(vt_mem_stats* out) {
+  call_once(&vt__tc_once, vt__tc_init);
+  size_t cur = out->cur_bytes;
+  mtx_lock(&vt__tc_reg_lock);
+  for (vt__tcache* t = vt__tc_reg; t; t = t->next) {
+    cur += atomic_load_explicit(&t->bytes, memory_order_relaxed);
+    out->total_allocs += atomic_load_explicit(&t->allocs, memory_order_relaxed);
+    out->total_frees  += atomic_load_explicit(&t->frees, memory_order_relaxed);
+  }
+  mtx_unlock(&vt__tc_reg_lock);
+  out->cur_bytes = cur;
+  if (cur > out->peak_bytes) out->peak_bytes = cur;
+}
+
+/* Remplit bin[c]: un lot du centre, sinon une page neuve découpée. */
+static int vt__tc_refill(vt__tcache* t, unsigned c) {
+  vt__tcentral* k = &vt__tc_central[c];
+  const uint32_t want = vt__tc_batch(c);
+  vt__tbin* b = &t->bin[c];
+  mtx_lock(&k->lock);
+  while (k->head && b->n < want) {
+    vt__hdr* h = k->head;
+    k->head = *(vt__hdr**)h;
+    *(vt__hdr**)h = b->head; b->head = h; b->n++;
+  }
+  mtx_unlock(&k->lock);
+  if (b->n) return 1;
+  const size_t bs = vt__tc_block(c);
+  const size_t span = bs * 8 > VT__TC_SPAN ? bs * 8 : VT__TC_SPAN;
+  unsigned char* page = (unsigned char*)vt_page_alloc(span);
+  if (!page) return 0;
+  const size_t nblk = span / bs;
+  vt__hdr* first = NULL; vt__hdr* last = NULL;
+  for (size_t i = 0; i < nblk; i++) {
+    vt__hdr* h = (vt__hdr*)(page + i * bs);
+    if (i < want) { *(vt__hdr**)h = b->head; b->head = h; b->n++; continue; }
+    *(vt__hdr**)h = NULL;
+    if (last) *(vt__hdr**)last = h; else first = h;
+    last = h;
+  }
+  if (first) vt__tc_push_central(c, first, last);
+  return 1;
+}
+
+/* Rend un lot de bin[c] au centre. */
+static void vt__tc_flush(vt__tcache* t, unsigned c) {
+  vt__tbin* b = &t->bin[c];
+  uint32_t n = vt__tc_batch(c);
+  vt__hdr* first = b->head; vt__hdr* last = first;
+  for (uint32_t i = 1; i < n; i++) last = *(vt__hdr**)last;
+  b->head = *(vt__hdr**)last; b->n -= n;
+  vt__tc_push_central(c, first, last);
+}
+
+static void* vt__tc_malloc(size_t n) {
+  if (n == 0) n = 1;
+  vt__tcache* t = vt__tc_get();
+  if (n > VT__TC_MAX || !t) {
+    vt__hdr* h = (vt__hdr*)malloc(sizeof(vt__hdr) + n);
+    if (!h) { if (atomic_load(&g_abort_oom)) vt__oom_abort(n); errno = ENOMEM; return NULL; }
+    h->sz = n; h->align = 0;
+    if (t) { vt__tc_add(&t->allocs, 1); vt__tc_bytes(t, n); }
+    else vt__stats_on_alloc(n);
+    return vt__user_from_hdr(h);
+  }
+  const unsigned c = vt__tc_class(n);
+  vt__tbin* b = &t->bin[c];
+  if (!b->head && !vt__tc_refill(t, c)) {
+    if (atomic_load(&g_abort_oom)) vt__oom_abort(n);
+    errno = ENOMEM; return NULL;
+  }
+  vt__hdr* h = b->head;
+  b->head = *(vt__hdr**)h; b->n--;
+  h->sz = n; h->align = VT__SLAB;
+  vt__tc_add(&t->allocs, 1);
+  vt__tc_bytes(t, n);
+  return vt__user_from_hdr(h);
+}
+
+static void vt__tc_free(void* p) {
+  if (!p) return;
+  vt__hdr* h = vt__hdr_from_user(p);
+  vt__tcache* t = vt__tc_get();
+  if (t) { vt__tc_add(&t->frees, 1); vt__tc_bytes(t, (size_t)0 - h->sz); }
+  else vt__stats_on_free(h->sz);
+  if (h->align != VT__SLAB) { free(h); return; }
+  const unsigned c = vt__tc_class(h->sz);
+  if (!t) { *(vt__hdr**)h = NULL; vt__tc_push_central(c, h, h); return; }
+  vt__tbin* b = &t->bin[c];
+  *(vt__hdr**)h = b->head; b->head = h; b->n++;
+  if (b->n > 2 * vt__tc_batch(c)) vt__tc_flush(t, c);
+}
+
+static void* vt__tc_realloc(void* p, size_t n) {
+  if (!p) return vt__tc_malloc(n);
+  if (n == 0) { vt__tc_free(p); return vt__tc_malloc(1); }
+  vt__hdr* h = vt__hdr_from_user(p);
+  if (h->align > VT__SLAB) { /* bloc de vt_aligned_alloc */
+    void* np = vt_aligned_alloc(h->align, n);
+    if (!np) return NULL;
+    memcpy(np, p, h->sz < n ? h->sz : n);
+    vt_aligned_free(p);
+    return np;
+  }
+  const size_t old = h->sz;
+  vt__tcache* t = vt__tc_get();
+  if (t && ((h->align == VT__SLAB && n <= VT__TC_MAX && vt__tc_class(n) == vt__tc_class(old)) ||
+            (h->align == 0 && n > VT__TC_MAX))) {
+    if (h->align == 0) {
+      vt__hdr* nh = (vt__hdr*)realloc(h, sizeof(vt__hdr) + n);
+      if (!nh) { if (atomic_load(&g_abort_oom)) vt__oom_abort(n); errno = ENOMEM; return NULL; }
+      h = nh;
+    }
+    h->sz = n;
+    vt__tc_bytes(t, n - old);
+    return vt__user_from_hdr(h);
+  }
+  void* np = vt__tc_malloc(n);
+  if (!np) return NULL;
+  memcpy(np, p, old < n ? old : n);
+  vt__tc_free(p);
+  return np;
+}
+#endif /* VT_MEM_TCACHE */
+
+/* ----------------------------------------------------------------------------
+   API: backend choisi à la compilation
+---------------------------------------------------------------------------- */
+void* vt_malloc(size_t n) {
+#ifdef VT_MEM_TCACHE
+  return vt__tc_malloc(n);
+#else
+  return vt__sys_malloc(n);
+#endif
+}
+
+void* vt_calloc(size_t nmemb, size_t size) {
+#ifdef VT_MEM_TCACHE
+  if (nmemb && size && SIZE_MAX / size < nmemb) { if (atomic_load(&g_abort_oom)) vt__oom_abort(SIZE_MAX); errno = ENOMEM; return NULL; }
+  size_t n = nmemb * size;
+  void* p = vt__tc_malloc(n);
+  if (p && n) memset(p, 0, n);
+  return p;
+#else
+  return vt__sys_calloc(nmemb, size);
+#endif
+}
+
+void* vt_realloc(void* p, size_t n) {
+#ifdef VT_MEM_TCACHE
+  return vt__tc_realloc(p, n);
+#else
+  return vt__sys_realloc(p, n);
+#endif
+}
+
+void vt_free(void* p) {
+#ifdef VT_MEM_TCACHE
+  vt__tc_free(p);
+#else
+  vt__sys_free(p);
+#endif
+}
 
 /* ----------------------------------------------------------------------------
    Aligned alloc
@@ -251,6 +589,64 @@ void* vt_page_alloc(size_t size) {
 #endif
 }
 
+/* mmap pour allocateurs: pages de 2 Mio réservées si le système en a
+   (MAP_HUGETLB, taille imposée par MAP_HUGE_SHIFT), sinon mapping aligné
+   sur 2 Mio + MADV_HUGEPAGE (THP). mbind avant le premier accès, puis
+   pré-faute éventuelle. */
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+#define VT__HUGE_PAGE ((size_t)2 * 1024 * 1024)
+
+void* vt_page_map(size_t* len, int huge, int numa_node, int prefault) {
+  size_t gran = huge ? VT__HUGE_PAGE : vt__page_size();
+  size_t n = vt__align_up(*len ? *len : 1, gran);
+  unsigned char* p = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+  if (huge) {
+    int hflags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#  if defined(MAP_HUGE_SHIFT)
+    hflags |= 21 << MAP_HUGE_SHIFT;
+#  endif
+    p = mmap(NULL, n, PROT_READ | PROT_WRITE, hflags, -1, 0);
+  }
+#endif
+  if (p == MAP_FAILED) {
+    /* sur-réservation puis découpe: début aligné pour que le THP couvre
+       tout le mapping */
+    size_t extra = huge ? VT__HUGE_PAGE : 0;
+    unsigned char* raw = mmap(NULL, n + extra, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+    p = (unsigned char*)vt__align_up((uintptr_t)raw, gran);
+    if (p > raw) munmap(raw, (size_t)(p - raw));
+    if (p + n < raw + n + extra) munmap(p + n, (size_t)(raw + n + extra - (p + n)));
+#if defined(MADV_HUGEPAGE)
+    if (huge) madvise(p, n, MADV_HUGEPAGE);
+#endif
+  }
+#if defined(SYS_mbind)
+  if (numa_node >= 0 && numa_node < (int)(8 * sizeof(unsigned long))) {
+    unsigned long mask = 1ul << numa_node;
+    syscall(SYS_mbind, p, n, 2 /* MPOL_BIND */, &mask, (unsigned long)numa_node + 2, 0u);
+  }
+#endif
+  if (prefault) {
+#if defined(MADV_POPULATE_WRITE)
+    if (madvise(p, n, MADV_POPULATE_WRITE) != 0)
+#endif
+    {
+      for (size_t off = 0; off < n; off += 4096) ((volatile unsigned char*)p)[off] = 0;
+    }
+  }
+  *len = n;
+  return p;
+}
+#else
+void* vt_page_map(size_t* len, int huge, int numa_node, int prefault) {
+  (void)len; (void)huge; (void)numa_node; (void)prefault;
+  return NULL;
+}
+#endif
+
 void vt_page_free(void* p, size_t size) {
   if (!p) return;
   size_t ps = vt__page_size();
@@ -280,6 +676,7 @@ typedef struct vt__arena_chunk {
   struct vt__arena_chunk* next;
   size_t cap;
   size_t len;
+  size_t mapped; /* octets mmap (0: vt_malloc) */
   alignas(VT_MEM_ALIGN_DEFAULT) unsigned char data[];
 } vt__arena_chunk;
 
@@ -288,47 +685,86 @@ struct vt_arena {
   vt__arena_chunk* head;
   size_t chunk_size; /* taille par défaut à la croissance */
   size_t total;      /* octets totaux réservés (stats) */
+  uint8_t huge, prefault;
+  int numa;          /* nœud + 1 (0: aucun) */
 };
 
 /* --- implé --- */
 
-static vt__arena_chunk* vt__arena_new_chunk(size_t cap) {
-  const size_t need = sizeof(vt__arena_chunk) + cap;
-  vt__arena_chunk* c = (vt__arena_chunk*)vt_malloc(need);
+static size_t vt__align_up(size_t x, size_t a); /* déjà défini plus haut */
+
+/* Chunk sur mmap (Linux, vt_page_map): huge pages, nœud NUMA, pré-faute.
+   NULL: l’appelant retombe sur vt_malloc. */
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+static vt__arena_chunk* vt__arena_map_chunk(const vt_arena* a, size_t cap) {
+  size_t len = sizeof(vt__arena_chunk) + cap;
+  vt__arena_chunk* c =
+      (vt__arena_chunk*)vt_page_map(&len, a->huge, a->numa - 1, a->prefault);
   if (!c) return NULL;
+  c->mapped = len;
+  c->cap = len - sizeof(vt__arena_chunk);
+  return c;
+}
+#endif
+
+static vt__arena_chunk* vt__arena_new_chunk(const vt_arena* a, size_t cap) {
+  vt__arena_chunk* c = NULL;
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+  if (a->huge || a->numa) c = vt__arena_map_chunk(a, cap);
+#endif
+  if (!c) {
+    const size_t need = sizeof(vt__arena_chunk) + cap;
+    c = (vt__arena_chunk*)vt_malloc(need);
+    if (!c) return NULL;
+    c->mapped = 0;
+    c->cap  = cap;
+    if (a->prefault) memset(c->data, 0, cap);
+  }
   c->next = NULL;
-  c->cap  = cap;
   c->len  = 0;
   return c;
 }
 
-static size_t vt__align_up(size_t x, size_t a); /* déjà défini plus haut */
+static void vt__arena_free_chunk(vt__arena_chunk* c) {
+#if !defined(_WIN32)
+  if (c->mapped) { munmap(c, c->mapped); return; }
+#endif
+  vt_free(c);
+}
 
 static void vt__arena_grow(vt_arena* a, size_t need_bytes) {
   size_t cap = a->chunk_size;
   if (cap < need_bytes) cap = vt__align_up(need_bytes, 4096);
-  vt__arena_chunk* c = vt__arena_new_chunk(cap);
+  vt__arena_chunk* c = vt__arena_new_chunk(a, cap);
   if (!c) return;
   c->next  = a->head;
   a->head  = c;
-  a->total += cap;
-  if (a->chunk_size < (size_t)16 * 1024 * 1024) a->chunk_size = cap * 2;
+  a->total += c->cap;
+  if (a->chunk_size < (size_t)16 * 1024 * 1024) a->chunk_size = c->cap * 2;
 }
 
-void vt_arena_init(vt_arena* a, size_t first_chunk) {
+void vt_arena_init_ex(vt_arena* a, const vt_arena_opts* o) {
   if (!a) return;
-  if (first_chunk == 0) first_chunk = 64 * 1024;
-  a->head       = vt__arena_new_chunk(first_chunk);
-  a->chunk_size = first_chunk;
+  size_t first_chunk = o && o->first_chunk_bytes ? o->first_chunk_bytes : 64 * 1024;
+  a->huge       = (uint8_t)(o && o->huge_pages);
+  a->prefault   = (uint8_t)(o && o->prefault);
+  a->numa       = o && o->numa_node >= 0 ? o->numa_node + 1 : 0;
+  a->head       = vt__arena_new_chunk(a, first_chunk);
+  a->chunk_size = a->head ? a->head->cap : first_chunk;
   a->total      = a->head ? a->head->cap : 0;
 }
 
+void vt_arena_init(vt_arena* a, size_t first_chunk) {
+  vt_arena_opts o = {first_chunk, 0, 0, -1};
+  vt_arena_init_ex(a, &o);
+}
+
 void vt_arena_dispose(vt_arena* a) {
   if (!a) return;
   vt__arena_chunk* c = a->head;
   while (c) {
     vt__arena_chunk* n = c->next;
-    vt_free(c);
+    vt__arena_free_chunk(c);
     c = n;
   }
   a->head = NULL;
@@ -340,7 +776,8 @@ static void* vt__arena_alloc(vt_arena* a, size_t n, size_t align) {
   if (align == 0) align = VT_MEM_ALIGN_DEFAULT;
   vt__arena_chunk* c = a->head;
   if (!c) {
-    vt_arena_init(a, n + 1024);
+    if (!a->chunk_size) a->chunk_size = n + 1024;
+    vt__arena_grow(a, n + 1024);
     c = a->head;
     if (!c) return NULL;
   }
@@ -375,7 +812,7 @@ void vt_arena_reset(vt_arena* a) {
   vt__arena_chunk* c = first->next;
   while (c) {
     vt__arena_chunk* n = c->next;
-    vt_free(c);
+    vt__arena_free_chunk(c);
     c = n;
   }
   first->next = NULL;
@@ -401,7 +838,7 @@ void vt_arena_mark_reset(vt_arena* a, vt_arena_mark m) {
   vt__arena_chunk* c = a->head;
   while (c && c != target) {
     vt__arena_chunk* n = c->next;
-    vt_free(c);
+    vt__arena_free_chunk(c);
     c = n;
   }
   a->head   = target;
@@ -412,13 +849,66 @@ void vt_arena_mark_reset(vt_arena* a, vt_arena_mark m) {
 
 /* ----------------------------------------------------------------------------
    Pool (objets fixes)
+   Mode concurrent (vt_pool_init_concurrent), à la Bonwick:
+   - chaque thread a, par pool, un magazine privé (pile d’objets libres,
+     sans verrou) de 0 à 2 × mag objets;
+   - vide: il reprend un lot entier au dépôt; plein: il y rend un lot de
+     mag objets;
+   - le dépôt est une pile de lots sans verrou. La tête est un mot étiqueté
+     (pointeur + compteur incrémenté à chaque CAS) contre l’ABA; le lien
+     d’un lot porte l’id du magazine qui l’a rendu (vol = lot rendu par
+     un autre thread);
+   - seule la croissance (nouveau bloc, nouveau magazine) prend le mutex.
+   Un thread qui se termine rend son magazine au dépôt; le magazine, orphelin,
+   est repris par le prochain thread qui arrive sur ce pool.
 ---------------------------------------------------------------------------- */
 typedef struct vt__blk { struct vt__blk* next; } vt__blk;
 
+#if VT_MEM_HAS_THREADS
+/* Mot étiqueté: pointeur sur les 48 bits bas (32 en 32 bits), étiquette
+   au-dessus. */
+#if UINTPTR_MAX > 0xffffffffu
+#  define VT__TP_SHIFT 48
+#else
+#  define VT__TP_SHIFT 32
+#endif
+#define VT__TP_MASK (((uint64_t)1 << VT__TP_SHIFT) - 1)
+static inline uint64_t vt__tp(void* p, uint64_t tag) { return (uint64_t)(uintptr_t)p | (tag << VT__TP_SHIFT); }
+static inline void*    vt__tp_ptr(uint64_t w) { return (void*)(uintptr_t)(w & VT__TP_MASK); }
+static inline uint64_t vt__tp_tag(uint64_t w) { return w >> VT__TP_SHIFT; }
+
+/* Tête d’un objet libre en mode concurrent */
+typedef struct vt__pnode {
+  _Atomic uint64_t link;  /* tête de lot: lot suivant + id du magazine */
+  struct vt__pnode* next; /* objet suivant du lot / du magazine */
+} vt__pnode;
+
+typedef struct vt__pmag {
+  struct vt__pmag* next; /* magazines du pool */
+  vt__pnode* head;
+  size_t n;
+  uint32_t id;           /* 1..65535 (étiquette des lots rendus) */
+  int orphan;            /* thread fini: repris par le suivant (sous lock) */
+  _Atomic size_t hits, refills, flushes, steals; /* écrivain unique */
+} vt__pmag;
+#endif
+
 struct vt_pool {
   size_t obj_size, obj_align, objs_per_block;
   void*  free_list;
   vt__blk* blocks;
+  size_t hits, grows;    /* mode simple */
+  int concurrent;
+#if VT_MEM_HAS_THREADS
+  size_t mag;            /* objets par lot */
+  uint64_t id;           /* unique, jamais réutilisé */
+  _Atomic uint64_t depot;
+  _Atomic size_t cgrows;
+  mtx_t lock;            /* blocs, liste des magazines */
+  vt__pmag* mags;
+  uint32_t next_mag_id;
+  struct vt_pool* next_live; /* registre des pools concurrents vivants */
+#endif
 };
 
 int vt_pool_init(vt_pool* p, size_t obj_size, size_t obj_align, size_t objs_per_block) {
@@ -427,36 +917,301 @@ int vt_pool_init(vt_pool* p, size_t obj_size, size_t obj_align, size_t objs_per_
   p->obj_align = obj_align ? obj_align : VT_MEM_ALIGN_DEFAULT;
   p->obj_size  = vt__align_up(obj_size, p->obj_align);
   p->objs_per_block = objs_per_block;
-  p->free_list = NULL; p->blocks = NULL; return 1;
+  p->free_list = NULL; p->blocks = NULL;
+  p->hits = p->grows = 0; p->concurrent = 0; return 1;
 }
 
-static int vt__pool_grow(vt_pool* p) {
+/* Nouveau bloc de objs_per_block objets; rend son premier objet (les
+   autres sont chaînés via le premier mot, dans l’ordre). */
+static unsigned char* vt__pool_block(vt_pool* p) {
   size_t hdr = sizeof(vt__blk);
   size_t stride = vt__align_up(p->obj_size, p->obj_align);
   size_t block_bytes = hdr + stride * p->objs_per_block + p->obj_align;
   unsigned char* raw = (unsigned char*)vt_malloc(block_bytes);
-  if (!raw) return 0;
+  if (!raw) return NULL;
   vt__blk* blk = (vt__blk*)raw; blk->next = p->blocks; p->blocks = blk;
   unsigned char* base = raw + hdr;
   uintptr_t aligned = ((uintptr_t)base + (p->obj_align - 1)) & ~(uintptr_t)(p->obj_align - 1);
-  unsigned char* cur = (unsigned char*)aligned;
+  return (unsigned char*)aligned;
+}
+
+static int vt__pool_grow(vt_pool* p) {
+  unsigned char* cur = vt__pool_block(p);
+  if (!cur) return 0;
+  size_t stride = vt__align_up(p->obj_size, p->obj_align);
   for (size_t i = 0; i < p->objs_per_block; ++i) { *(void**)cur = p->free_list; p->free_list = cur; cur += stride; }
+  p->grows++;
+  return 1;
+}
+
+#if VT_MEM_HAS_THREADS
+static mtx_t            vt__pool_reg_lock;
+static vt_pool*         vt__pool_live;
+static _Atomic uint64_t vt__pool_ids = 1;
+static tss_t            vt__pool_key;
+static once_flag        vt__pool_once = ONCE_FLAG_INIT;
+
+/* Magazines du thread, indexés par id de pool (sondage linéaire) */
+#define VT__PMAG_SLOTS 16
+typedef struct { vt_pool* pool; uint64_t id; vt__pmag* m; } vt__pslot;
+static VT_TLS vt__pslot vt__pslots[VT__PMAG_SLOTS];
+static VT_TLS int       vt__pslots_armed;
+
+static inline void vt__cnt(_Atomic size_t* c) {
+  atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/* Empile le lot first..(chaîne next) au dépôt. */
+static void vt__depot_push(vt_pool* p, vt__pnode* first, uint32_t from) {
+  uint64_t old = atomic_load_explicit(&p->depot, memory_order_relaxed);
+  do {
+    atomic_store_explicit(&first->link, vt__tp(vt__tp_ptr(old), from), memory_order_relaxed);
+  } while (!atomic_compare_exchange_weak_explicit(&p->depot, &old, vt__tp(first, vt__tp_tag(old) + 1),
+                                                  memory_order_release, memory_order_relaxed));
+}
+
+/* Dépile un lot; *from = magazine qui l’a rendu (0: bloc neuf). Lire le
+   lien d’une tête déjà reprise est sans danger: les blocs ne sont rendus
+   qu’à vt_pool_dispose, et l’étiquette fait échouer le CAS. */
+static vt__pnode* vt__depot_pop(vt_pool* p, uint32_t* from) {
+  uint64_t old = atomic_load_explicit(&p->depot, memory_order_acquire);
+  for (;;) {
+    vt__pnode* top = (vt__pnode*)vt__tp_ptr(old);
+    if (!top) return NULL;
+    uint64_t link = atomic_load_explicit(&top->link, memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(&p->depot, &old, vt__tp(vt__tp_ptr(link), vt__tp_tag(old) + 1),
+                                              memory_order_acquire, memory_order_acquire)) {
+      *from = (uint32_t)(vt__tp_tag(link) & 0xffffu);
+      return top;
+    }
+  }
+}
+
+/* Rend tout le magazine au dépôt (lot unique, de taille quelconque). */
+static void vt__pmag_drain(vt_pool* p, vt__pmag* m) {
+  if (!m->head) return;
+  vt__depot_push(p, m->head, m->id);
+  m->head = NULL; m->n = 0;
+}
+
+/* Sous vt__pool_reg_lock: pool encore vivant (pas de lecture de *pool). */
+static int vt__pool_is_live(const vt_pool* pool, uint64_t id) {
+  for (vt_pool* q = vt__pool_live; q; q = q->next_live) if (q == pool && q->id == id) return 1;
+  return 0;
+}
+
+/* Sous vt__pool_reg_lock: rend le magazine de l’entrée et la vide. */
+static void vt__pslot_release(vt__pslot* s) {
+  if (s->pool && vt__pool_is_live(s->pool, s->id)) {
+    mtx_lock(&s->pool->lock);
+    vt__pmag_drain(s->pool, s->m);
+    s->m->orphan = 1;
+    mtx_unlock(&s->pool->lock);
+  }
+  s->pool = NULL;
+}
+
+/* Fin de thread: magazines des pools encore vivants rendus et orphelins. */
+static void vt__pool_thread_exit(void* arg) {
+  (void)arg;
+  mtx_lock(&vt__pool_reg_lock);
+  for (int i = 0; i < VT__PMAG_SLOTS; i++) vt__pslot_release(&vt__pslots[i]);
+  mtx_unlock(&vt__pool_reg_lock);
+}
+
+static void vt__pool_once_init(void) {
+  if (mtx_init(&vt__pool_reg_lock, mtx_plain) != thrd_success ||
+      tss_create(&vt__pool_key, vt__pool_thread_exit) != thrd_success) {
+    fprintf(stderr, "[mem] pool: init impossible\n");
+    abort();
+  }
+}
+
+/* Premier accès du thread à p: entrées des pools détruits oubliées, entrée
+   libre (ou la première évincée), magazine orphelin repris ou neuf. */
+static vt__pmag* vt__pmag_slow(vt_pool* p) {
+  unsigned h = (unsigned)(p->id % VT__PMAG_SLOTS);
+  vt__pslot* slot = NULL;
+  if (!vt__pslots_armed) { tss_set(vt__pool_key, vt__pslots); vt__pslots_armed = 1; }
+  mtx_lock(&vt__pool_reg_lock);
+  for (int i = 0; i < VT__PMAG_SLOTS; i++) {
+    vt__pslot* s = &vt__pslots[i];
+    if (s->pool && !vt__pool_is_live(s->pool, s->id)) s->pool = NULL;
+  }
+  for (unsigned k = 0; k < VT__PMAG_SLOTS && !slot; k++)
+    if (!vt__pslots[(h + k) % VT__PMAG_SLOTS].pool) slot = &vt__pslots[(h + k) % VT__PMAG_SLOTS];
+  if (!slot) { slot = &vt__pslots[h]; vt__pslot_release(slot); }
+  mtx_unlock(&vt__pool_reg_lock);
+
+  mtx_lock(&p->lock);
+  vt__pmag* m = p->mags;
+  while (m && !m->orphan) m = m->next;
+  if (m) {
+    m->orphan = 0;
+  } else if (p->next_mag_id <= 0xffffu && (m = (vt__pmag*)vt_calloc(1, sizeof *m)) != NULL) {
+    m->id = p->next_mag_id++;
+    m->next = p->mags;
+    p->mags = m;
+  }
+  mtx_unlock(&p->lock);
+  if (!m) return NULL;
+  slot->pool = p; slot->id = p->id; slot->m = m;
+  return m;
+}
+
+static inline vt__pmag* vt__pmag_get(vt_pool* p) {
+  unsigned h = (unsigned)(p->id % VT__PMAG_SLOTS);
+  for (unsigned k = 0; k < VT__PMAG_SLOTS; k++) {
+    vt__pslot* s = &vt__pslots[(h + k) % VT__PMAG_SLOTS];
+    if (s->pool == p && s->id == p->id) return s->m;
+  }
+  return vt__pmag_slow(p);
+}
+
+/* Dépôt vide: nouveau bloc découpé en lots de mag objets (sous lock, en
+   recontrôlant le dépôt: un autre thread a pu croître entre-temps). */
+static vt__pnode* vt__cpool_grow(vt_pool* p, uint32_t* from) {
+  mtx_lock(&p->lock);
+  vt__pnode* got = vt__depot_pop(p, from);
+  unsigned char* cur = got ? NULL : vt__pool_block(p);
+  if (cur) {
+    size_t stride = vt__align_up(p->obj_size, p->obj_align);
+    vt__pnode* first = NULL; vt__pnode* prev = NULL; size_t k = 0;
+    for (size_t i = 0; i < p->objs_per_block; ++i, cur += stride) {
+      vt__pnode* n = (vt__pnode*)cur;
+      n->next = NULL;
+      if (k == 0) first = n; else prev->next = n;
+      prev = n;
+      if (++k == p->mag || i + 1 == p->objs_per_block) {
+        if (got) vt__depot_push(p, first, 0); else got = first;
+        k = 0;
+      }
+    }
+    *from = 0;
+    atomic_fetch_add_explicit(&p->cgrows, 1, memory_order_relaxed);
+  }
+  mtx_unlock(&p->lock);
+  return got;
+}
+
+static void* vt__cpool_alloc(vt_pool* p) {
+  vt__pmag* m = vt__pmag_get(p);
+  if (!m) { errno = ENOMEM; return NULL; }
+  if (!m->head) {
+    uint32_t from = 0;
+    vt__pnode* b = vt__depot_pop(p, &from);
+    if (!b && !(b = vt__cpool_grow(p, &from))) { errno = ENOMEM; return NULL; }
+    size_t n = 0;
+    for (vt__pnode* it = b; it; it = it->next) n++;
+    m->head = b; m->n = n;
+    vt__cnt(&m->refills);
+    if (from && from != m->id) vt__cnt(&m->steals);
+  } else {
+    vt__cnt(&m->hits);
+  }
+  vt__pnode* o = m->head;
+  m->head = o->next; m->n--;
+  return o;
+}
+
+static void vt__cpool_free(vt_pool* p, void* obj) {
+  vt__pmag* m = vt__pmag_get(p);
+  vt__pnode* o = (vt__pnode*)obj;
+  if (!m) { /* pas de magazine: lot d’un seul objet */
+    o->next = NULL; vt__depot_push(p, o, 0); return;
+  }
+  o->next = m->head; m->head = o;
+  if (++m->n <= 2 * p->mag) return;
+  /* Trop plein: les mag premiers objets partent en un lot */
+  vt__pnode* last = m->head;
+  for (size_t i = 1; i < p->mag; i++) last = last->next;
+  vt__pnode* rest = last->next;
+  last->next = NULL;
+  vt__depot_push(p, m->head, m->id);
+  m->head = rest; m->n -= p->mag;
+  vt__cnt(&m->flushes);
+}
+#endif /* VT_MEM_HAS_THREADS */
+
+int vt_pool_init_concurrent(vt_pool* p, size_t obj_size, size_t obj_align, size_t objs_per_block,
+                            size_t magazine) {
+#if VT_MEM_HAS_THREADS
+  if (obj_size < sizeof(vt__pnode)) obj_size = sizeof(vt__pnode);
+  if (obj_align && obj_align < _Alignof(vt__pnode)) obj_align = _Alignof(vt__pnode);
+  if (!vt_pool_init(p, obj_size, obj_align, objs_per_block)) return 0;
+  if (p->obj_align < _Alignof(vt__pnode)) { p->obj_align = _Alignof(vt__pnode); p->obj_size = vt__align_up(p->obj_size, p->obj_align); }
+  call_once(&vt__pool_once, vt__pool_once_init);
+  if (mtx_init(&p->lock, mtx_plain) != thrd_success) return 0;
+  p->mag = magazine ? magazine : 32;
+  if (p->objs_per_block < p->mag) p->objs_per_block = p->mag;
+  p->id = atomic_fetch_add_explicit(&vt__pool_ids, 1, memory_order_relaxed);
+  atomic_init(&p->depot, 0);
+  atomic_init(&p->cgrows, 0);
+  p->mags = NULL; p->next_mag_id = 1;
+  p->concurrent = 1;
+  mtx_lock(&vt__pool_reg_lock);
+  p->next_live = vt__pool_live; vt__pool_live = p;
+  mtx_unlock(&vt__pool_reg_lock);
   return 1;
+#else
+  (void)p; (void)obj_size; (void)obj_align; (void)objs_per_block; (void)magazine;
+  errno = ENOTSUP; return 0;
+#endif
 }
 
 void* vt_pool_alloc(vt_pool* p) {
   if (!p) { errno = EINVAL; return NULL; }
-  if (!p->free_list && !vt__pool_grow(p)) return NULL;
+#if VT_MEM_HAS_THREADS
+  if (p->concurrent) return vt__cpool_alloc(p);
+#endif
+  if (!p->free_list) { if (!vt__pool_grow(p)) return NULL; } else p->hits++;
   void* obj = p->free_list; p->free_list = *(void**)p->free_list; return obj;
 }
 
 void vt_pool_free(vt_pool* p, void* obj) {
   if (!p || !obj) return;
+#if VT_MEM_HAS_THREADS
+  if (p->concurrent) { vt__cpool_free(p, obj); return; }
+#endif
   *(void**)obj = p->free_list; p->free_list = obj;
 }
 
+void vt_pool_get_stats(vt_pool* p, vt_pool_stats* out) {
+  if (!out) return;
+  memset(out, 0, sizeof *out);
+  if (!p) return;
+  out->hits = p->hits; out->grows = p->grows;
+#if VT_MEM_HAS_THREADS
+  if (!p->concurrent) return;
+  out->grows = atomic_load_explicit(&p->cgrows, memory_order_relaxed);
+  mtx_lock(&p->lock);
+  for (vt__pmag* m = p->mags; m; m = m->next) {
+    out->hits    += atomic_load_explicit(&m->hits, memory_order_relaxed);
+    out->refills += atomic_load_explicit(&m->refills, memory_order_relaxed);
+    out->flushes += atomic_load_explicit(&m->flushes, memory_order_relaxed);
+    out->steals  += atomic_load_explicit(&m->steals, memory_order_relaxed);
+    out->magazines++;
+  }
+  mtx_unlock(&p->lock);
+#endif
+}
+
 void vt_pool_dispose(vt_pool* p) {
   if (!p) return;
+#if VT_MEM_HAS_THREADS
+  if (p->concurrent) {
+    mtx_lock(&vt__pool_reg_lock);
+    vt_pool** pp = &vt__pool_live;
+    while (*pp && *pp != p) pp = &(*pp)->next_live;
+    if (*pp) *pp = p->next_live;
+    mtx_unlock(&vt__pool_reg_lock);
+    vt__pmag* m = p->mags; while (m) { vt__pmag* n = m->next; vt_free(m); m = n; }
+    p->mags = NULL;
+    atomic_store_explicit(&p->depot, 0, memory_order_relaxed);
+    mtx_destroy(&p->lock);
+    p->concurrent = 0;
+  }
+#endif
   vt__blk* b = p->blocks; while (b) { vt__blk* n = b->next; vt_free(b); b = n; }
   p->blocks = NULL; p->free_list = NULL;
 }
@@ -516,6 +1271,214 @@ unsigned char* vt_buf_detach(vt_buf* b, size_t* out_len) {
   b->data = NULL; b->len = b->cap = 0; return p;
 }
 
+/* ----------------------------------------------------------------------------
+   Bench: cc -std=gnu17 -O2 -DVT_MEM_BENCH mem.c -lpthread && ./a.out [ops]
+   T threads, chacun sur 256 cases: libère la case tirée si elle est pleine,
+   sinon l’alloue (8..512 o). Chemin actuel (libc + stats globales) contre
+   caches par thread.
+---------------------------------------------------------------------------- */
+#ifdef VT_MEM_BENCH
+#include <time.h>
+
+typedef struct { int tc; size_t ops; uint64_t seed; } vt__mb_arg;
+
+static int vt__mb_worker(void* p) {
+  vt__mb_arg* a = (vt__mb_arg*)p;
+  void* slot[256] = {0};
+  uint64_t x = a->seed;
+  for (size_t i = 0; i < a->ops; i++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    void** s = &slot[x & 255];
+    if (*s) {
+      if (a->tc) vt_free(*s); else vt__sys_free(*s);
+      *s = NULL;
+    } else {
+      size_t n = 8 + (size_t)((x >> 8) % 505);
+      *s = a->tc ? vt_malloc(n) : vt__sys_malloc(n);
+      *(volatile char*)*s = 1;
+    }
+  }
+  for (int i = 0; i < 256; i++) {
+    if (a->tc) vt_free(slot[i]); else vt__sys_free(slot[i]);
+  }
+  return 0;
+}
+
+static double vt__mb_run(int tc, int nthreads, size_t ops) {
+  thrd_t th[64];
+  vt__mb_arg arg[64];
+  struct timespec t0, t1;
+  timespec_get(&t0, TIME_UTC);
+  for (int i = 0; i < nthreads; i++) {
+    arg[i] = (vt__mb_arg){tc, ops, 0x9e3779b97f4a7c15u * (uint64_t)(i + 1)};
+    thrd_create(&th[i], vt__mb_worker, &arg[i]);
+  }
+  for (int i = 0; i < nthreads; i++) thrd_join(th[i], NULL);
+  timespec_get(&t1, TIME_UTC);
+  double dt = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  return (double)ops * nthreads / dt * 1e-6;
+}
+
+/* Pool: vt_pool simple sous mutex vs mode concurrent */
+typedef struct { vt_pool* p; mtx_t* lk; size_t ops; uint64_t seed; void** objs; size_t n; } vt__pb_arg;
+
+static int vt__pb_worker(void* q) {
+  vt__pb_arg* a = (vt__pb_arg*)q;
+  void* slot[256] = {0};
+  uint64_t x = a->seed;
+  for (size_t i = 0; i < a->ops; i++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    void** s = &slot[x & 255];
+    if (a->lk) mtx_lock(a->lk);
+    if (*s) { vt_pool_free(a->p, *s); *s = NULL; } else *s = vt_pool_alloc(a->p);
+    if (a->lk) mtx_unlock(a->lk);
+    if (*s) *(volatile char*)*s = 1;
+  }
+  for (int i = 0; i < 256; i++) {
+    if (!slot[i]) continue;
+    if (a->lk) mtx_lock(a->lk);
+    vt_pool_free(a->p, slot[i]);
+    if (a->lk) mtx_unlock(a->lk);
+  }
+  return 0;
+}
+
+static double vt__pb_run(vt_pool* p, mtx_t* lk, int nthreads, size_t ops) {
+  thrd_t th[64];
+  vt__pb_arg arg[64];
+  struct timespec t0, t1;
+  timespec_get(&t0, TIME_UTC);
+  for (int i = 0; i < nthreads; i++) {
+    arg[i] = (vt__pb_arg){p, lk, ops, 0x9e3779b97f4a7c15u * (uint64_t)(i + 1), NULL, 0};
+    thrd_create(&th[i], vt__pb_worker, &arg[i]);
+  }
+  for (int i = 0; i < nthreads; i++) thrd_join(th[i], NULL);
+  timespec_get(&t1, TIME_UTC);
+  double dt = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  return (double)ops * nthreads / dt * 1e-6;
+}
+
+/* Producteur/consommateur: chaque thread libère ce qu’un autre a alloué */
+static int vt__pb_fill(void* q) {
+  vt__pb_arg* a = (vt__pb_arg*)q;
+  for (size_t i = 0; i < a->n; i++) { a->objs[i] = vt_pool_alloc(a->p); *(size_t*)a->objs[i] = i; }
+  return 0;
+}
+
+static int vt__pb_drain(void* q) {
+  vt__pb_arg* a = (vt__pb_arg*)q;
+  for (size_t i = 0; i < a->n; i++) {
+    if (*(size_t*)a->objs[i] != i) { fprintf(stderr, "pool: objet corrompu\n"); abort(); }
+    vt_pool_free(a->p, a->objs[i]);
+  }
+  return 0;
+}
+
+static void vt__pb_handoff(vt_pool* p, int nthreads, size_t n, int rounds) {
+  thrd_t th[64];
+  vt__pb_arg arg[64];
+  for (int i = 0; i < nthreads; i++) {
+    arg[i] = (vt__pb_arg){p, NULL, 0, 0, (void**)vt_malloc(n * sizeof(void*)), n};
+  }
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nthreads; i++) thrd_create(&th[i], vt__pb_fill, &arg[i]);
+    for (int i = 0; i < nthreads; i++) thrd_join(th[i], NULL);
+    for (int i = 0; i < nthreads; i++) thrd_create(&th[i], vt__pb_drain, &arg[(i + 1) % nthreads]);
+    for (int i = 0; i < nthreads; i++) thrd_join(th[i], NULL);
+  }
+  for (int i = 0; i < nthreads; i++) vt_free(arg[i].objs);
+}
+
+static int vt__pb_main(size_t ops) {
+  printf("vt_pool 64 o, %zu ops par thread (Mops/s cumulés):\n", ops);
+  for (int t = 1; t <= 32; t *= 2) {
+    vt_pool a, b;
+    mtx_t lk;
+    mtx_init(&lk, mtx_plain);
+    vt_pool_init(&a, 64, 0, 0);
+    vt_pool_init_concurrent(&b, 64, 0, 0, 0);
+    double x = vt__pb_run(&a, &lk, t, ops);
+    double y = vt__pb_run(&b, NULL, t, ops);
+    printf("  %2d threads  mutex %8.1f  magazines %8.1f  (x%.2f)\n", t, x, y, y / x);
+    vt_pool_dispose(&a); vt_pool_dispose(&b);
+    mtx_destroy(&lk);
+  }
+  vt_pool c;
+  vt_pool_stats ps;
+  vt_pool_init_concurrent(&c, 64, 0, 0, 0);
+  vt__pb_handoff(&c, 8, 20000, 4);
+  vt_pool_get_stats(&c, &ps);
+  printf("handoff 8 threads: hits=%zu refills=%zu flushes=%zu steals=%zu grows=%zu magazines=%zu\n",
+         ps.hits, ps.refills, ps.flushes, ps.steals, ps.grows, ps.magazines);
+  vt_pool_dispose(&c);
+  return ps.steals > 0 ? 0 : 1;
+}
+
+/* Arena: chaîne de nœuds de 64 o parcourue dans un ordre aléatoire sur
+   256 Mio, chaque saut touche une page différente (sensible au TLB). */
+typedef struct vt__ab_node { struct vt__ab_node* next; uint64_t pad[7]; } vt__ab_node;
+
+static double vt__ab_now(void) {
+  struct timespec t;
+  timespec_get(&t, TIME_UTC);
+  return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static void vt__ab_run(const char* name, const vt_arena_opts* o) {
+  const size_t n = ((size_t)256 << 20) / sizeof(vt__ab_node);
+  vt_arena a;
+  vt__ab_node** v = (vt__ab_node**)vt_malloc(n * sizeof *v);
+  double t0 = vt__ab_now();
+  vt_arena_init_ex(&a, o);
+  for (size_t i = 0; i < n; i++) { v[i] = (vt__ab_node*)vt_arena_alloc(&a, sizeof(vt__ab_node), 64); v[i]->pad[0] = i; }
+  double t1 = vt__ab_now();
+  uint64_t x = 0x2545f4914f6cdd1du;
+  for (size_t i = n - 1; i > 0; i--) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    size_t j = (size_t)(x % (i + 1));
+    vt__ab_node* t = v[i]; v[i] = v[j]; v[j] = t;
+  }
+  for (size_t i = 0; i < n; i++) v[i]->next = v[(i + 1) % n];
+  vt__ab_node* it = v[0];
+  uint64_t sum = 0;
+  double t2 = vt__ab_now();
+  for (size_t i = 0; i < 4 * n; i++) { sum += it->pad[0]; it = it->next; }
+  double t3 = vt__ab_now();
+  printf("  %-10s remplissage %6.0f Mio/s  parcours %6.1f ns/saut  %6.1f Msauts/s  (%" PRIu64 ")\n", name,
+         256.0 / (t1 - t0), (t3 - t2) * 1e9 / (double)(4 * n), (double)(4 * n) / (t3 - t2) * 1e-6, sum % 1000);
+  vt_arena_dispose(&a);
+  vt_free(v);
+}
+
+static void vt__ab_main(void) {
+  printf("vt_arena 256 Mio, parcours aléatoire:\n");
+  vt_arena_opts o = {(size_t)1 << 20, 0, 0, -1};
+  vt__ab_run("malloc", &o);
+  o.huge_pages = 1;
+  vt__ab_run("huge", &o);
+  o.prefault = 1;
+  vt__ab_run("huge+pref", &o);
+}
+
+int main(int argc, char** argv) {
+  size_t ops = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 4000000u;
+  printf("vt_malloc/vt_free, %zu ops par thread (Mops/s cumulés):\n", ops);
+  for (int t = 1; t <= 32; t *= 2) {
+    double a = vt__mb_run(0, t, ops);
+    double b = vt__mb_run(1, t, ops);
+    printf("  %2d threads  libc+stats %8.1f  tcache %8.1f  (x%.2f)\n", t, a, b, b / a);
+  }
+  vt_mem_stats st;
+  vt_mem_get_stats(&st);
+  printf("stats: cur=%zu peak=%zu allocs=%zu frees=%zu\n", st.cur_bytes,
+         st.peak_bytes, st.total_allocs, st.total_frees);
+  int rc = vt__pb_main(ops / 4);
+  vt__ab_main();
+  vt_mem_get_stats(&st);
+  return rc == 0 && st.cur_bytes == 0 && st.total_allocs == st.total_frees ? 0 : 1;
+}
+#endif /* VT_MEM_BENCH */
+
 /* ============================================================================
    Fin
    ============================================================================ */
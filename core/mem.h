@@ -3,7 +3,7 @@
    - Wrappers sûrs (vt_malloc/calloc/realloc/free) avec statistiques atomiques
    - Aligned alloc cross-platform
    - Pages OS (mmap/VirtualAlloc)
-   - Arena allocator (grow, mark/reset, align)
+   - Arena allocator (grow, mark/reset, align, huge pages / NUMA)
    - Pool d’objets fixes (free-list)
    - Buffer dynamique (vt_buf) + printf-like
    - Duplication (mem/str), fill/zero/swap
@@ -40,13 +40,18 @@ extern "C" {
    Configuration compile-time (optionnelle)
    - VT_MEM_LEAK_TRACK       : active le suivi de fuites (coût modéré)
    - VT_MEM_DEFAULT_ABORT_ON_OOM=1 : abort sur OOM dans vt_*alloc (par défaut 1)
+   - VT_MEM_TCACHE           : vt_malloc/calloc/realloc/free passent par des
+                               caches par thread (classes de tailles ≤ 32 Kio,
+                               slabs sur vt_page_alloc, jamais rendus à l’OS);
+                               stats tenues par thread. <threads.h> requis.
 ---------------------------------------------------------------------------- */
 #ifndef VT_MEM_DEFAULT_ABORT_ON_OOM
 #define VT_MEM_DEFAULT_ABORT_ON_OOM 1
 #endif
 
 /* ----------------------------------------------------------------------------
-   Statistiques globales
+   Statistiques globales (VT_MEM_TCACHE: somme des compteurs par thread au
+   moment de l’appel; pic exact à 256 Kio près par thread)
 ---------------------------------------------------------------------------- */
 typedef struct vt_mem_stats {
   size_t cur_bytes;    /* octets actuellement alloués */
@@ -83,6 +88,11 @@ VT_MEM_API void vt_mem_swap(void* a, void* b, size_t n);
 ---------------------------------------------------------------------------- */
 VT_MEM_API void* vt_page_alloc(size_t size);        /* size arrondi à la page */
 VT_MEM_API void vt_page_free(void* p, size_t size); /* size identique à alloc */
+/* Mapping pour allocateurs (Linux; NULL ailleurs ou en cas d’échec):
+   huge → pages de 2 Mio (réservées, sinon THP), numa_node >= 0 → mbind,
+   prefault → pages touchées d’avance. *len est arrondi (page ou 2 Mio);
+   libérer par vt_page_free(p, *len). */
+VT_MEM_API void* vt_page_map(size_t* len, int huge, int numa_node, int prefault);
 
 /* ----------------------------------------------------------------------------
    Arena allocator
@@ -99,6 +109,17 @@ typedef struct vt_arena_mark {
 
 /* Crée la première chunk (taille suggérée). Si 0 → ~64 KiB par défaut. */
 VT_MEM_API void vt_arena_init(vt_arena* a, size_t first_chunk_bytes);
+
+/* Options de création. Tout ce qui n’est pas disponible (hors Linux, pas de
+   THP, mbind refusé) est ignoré: chunks vt_malloc comme vt_arena_init. */
+typedef struct vt_arena_opts {
+  size_t first_chunk_bytes; /* 0 → ~64 KiB */
+  int huge_pages; /* 1: chunks mmap par multiples de 2 Mio, pages de 2 Mio
+                     réservées (MAP_HUGETLB) sinon MADV_HUGEPAGE */
+  int prefault;   /* 1: chunk entièrement fauté dès sa création */
+  int numa_node;  /* ≥0: chunks mmap liés à ce nœud (mbind); -1 = aucun */
+} vt_arena_opts;
+VT_MEM_API void vt_arena_init_ex(vt_arena* a, const vt_arena_opts* o);
 VT_MEM_API void vt_arena_dispose(vt_arena* a);
 
 /* Alloue n octets, alignés sur `align` (puissance de 2 ; 0 → align par défaut).
@@ -113,7 +134,7 @@ VT_MEM_API vt_arena_mark vt_arena_mark_get(vt_arena* a);
 VT_MEM_API void vt_arena_mark_reset(vt_arena* a, vt_arena_mark m);
 
 /* ----------------------------------------------------------------------------
-   Pool d’objets fixes (free-list)
+   Pool d’objets fixes (free-list), mono-thread ou concurrent
    - vt_pool : opaque
 ---------------------------------------------------------------------------- */
 typedef struct vt_pool vt_pool;
@@ -125,6 +146,29 @@ VT_MEM_API void vt_pool_dispose(vt_pool* p);
 VT_MEM_API void* vt_pool_alloc(vt_pool* p);
 VT_MEM_API void vt_pool_free(vt_pool* p, void* obj);
 
+/* Variante partageable entre threads: alloc/free sans verrou sur un
+   magazine par thread (magazine objets, 0 → 32), échangé par lots entiers
+   avec un dépôt commun sans verrou. obj_size ≥ 2 pointeurs, alignement ≥ 8
+   (relevés si besoin). Un objet peut être libéré par un autre thread que
+   celui qui l’a alloué. vt_pool_dispose quand plus aucun thread ne s’en
+   sert. 0 et errno=ENOTSUP sans <threads.h>. */
+VT_MEM_API int vt_pool_init_concurrent(vt_pool* p, size_t obj_size,
+                                       size_t obj_align,
+                                       size_t objs_per_block,
+                                       size_t magazine);
+
+/* Compteurs cumulés (mode simple: hits et grows seulement)
+   - hits    : alloc servie par le magazine (ou la free-list)
+   - refills : magazine vide rechargé d’un lot du dépôt
+   - flushes : magazine trop plein, un lot rendu au dépôt
+   - steals  : recharge par un lot rendu par un autre thread
+   - grows   : blocs alloués */
+typedef struct vt_pool_stats {
+  size_t hits, refills, flushes, steals, grows;
+  size_t magazines; /* magazines créés (un par thread, réutilisés) */
+} vt_pool_stats;
+VT_MEM_API void vt_pool_get_stats(vt_pool* p, vt_pool_stats* out);
+
 /* ----------------------------------------------------------------------------
    Buffer dynamique (octets) avec helpers printf-like
 ---------------------------------------------------------------------------- */
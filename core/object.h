@@ -14,6 +14,7 @@
 
 #include <stddef.h> /* size_t */
 #include <stdint.h> /* uint64_t, int64_t */
+#include <string.h> /* memcpy (VT_VALUE_NANBOX) */
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,6 +52,103 @@ typedef enum vt_type {
   VT_PTR = 9
 } vt_type;
 
+/* ----------------------------------------------------------------------------
+   Représentation (choix à la compilation, même API)
+   - défaut: 16 octets {type, flags, union}
+   - -DVT_VALUE_NANBOX: 8 octets NaN-boxés. Un flottant est stocké tel quel
+     (NaN canonisés en 0x7FF8…); les autres types occupent l’espace des NaN
+     négatifs: bits 63..48 = 0xFFF8 + étiquette, bits 47..0 = charge utile.
+     Contraintes: VT_INT sur 48 bits signés (arithmétique modulo 2^48),
+     pointeurs sur 48 bits (espace utilisateur x86-64/AArch64), flags absent.
+   Accès uniquement via les accesseurs ci-dessous.
+---------------------------------------------------------------------------- */
+#ifndef VT_OBJECT_INLINE
+#define VT_OBJECT_INLINE static inline
+#endif
+
+#ifdef VT_VALUE_NANBOX
+typedef struct vt_value {
+  uint64_t bits;
+} vt_value;
+
+#define VT_NB_QNAN ((uint64_t)0x7FF8000000000000ull) /* NaN canonique */
+#define VT_NB_TAG(h) ((uint64_t)(0xFFF8u + (h)) << 48)
+#define VT_NB_PAYLOAD ((uint64_t)0x0000FFFFFFFFFFFFull)
+#define VT_NB_BYTES_BIT ((uint64_t)1 << 47) /* BYTES partage l’étiquette PTR */
+enum { /* étiquettes: bits 50..48 */
+  VT_NB_NIL = 0,
+  VT_NB_BOOL,
+  VT_NB_INT,
+  VT_NB_STR,
+  VT_NB_ARRAY,
+  VT_NB_MAP,
+  VT_NB_FUNC,
+  VT_NB_PTR /* PTR, ou BYTES si VT_NB_BYTES_BIT */
+};
+
+VT_OBJECT_INLINE vt_type vt_value_type(const vt_value* v) {
+  static const uint8_t T[8] = {VT_NIL, VT_BOOL,  VT_INT,  VT_STR,
+                               VT_ARRAY, VT_MAP, VT_FUNC, VT_PTR};
+  if (v->bits < VT_NB_TAG(0)) return VT_FLOAT;
+  unsigned h = (unsigned)(v->bits >> 48) - 0xFFF8u;
+  if (h == VT_NB_PTR && (v->bits & VT_NB_BYTES_BIT)) return VT_BYTES;
+  return (vt_type)T[h];
+}
+VT_OBJECT_INLINE int vt_is_int(const vt_value* v) {
+  return (v->bits >> 48) == 0xFFF8u + VT_NB_INT;
+}
+VT_OBJECT_INLINE int vt_is_float(const vt_value* v) {
+  return v->bits < VT_NB_TAG(0);
+}
+VT_OBJECT_INLINE int64_t vt_as_int(const vt_value* v) {
+  /* extension de signe du bit 47 */
+  const uint64_t s = (uint64_t)1 << 47;
+  return (int64_t)(((v->bits & VT_NB_PAYLOAD) ^ s) - s);
+}
+VT_OBJECT_INLINE double vt_as_float(const vt_value* v) {
+  double d;
+  memcpy(&d, &v->bits, sizeof d);
+  return d;
+}
+VT_OBJECT_INLINE void* vt_as_ptr(const vt_value* v) {
+  return (void*)(uintptr_t)(v->bits & VT_NB_PAYLOAD & ~VT_NB_BYTES_BIT);
+}
+VT_OBJECT_INLINE int vt_as_bool(const vt_value* v) {
+  return (int)(v->bits & 1);
+}
+
+VT_OBJECT_INLINE vt_value vt_nil(void) {
+  vt_value v = {VT_NB_TAG(VT_NB_NIL)};
+  return v;
+}
+VT_OBJECT_INLINE vt_value vt_bool(int b) {
+  vt_value v = {VT_NB_TAG(VT_NB_BOOL) | (b ? 1u : 0u)};
+  return v;
+}
+VT_OBJECT_INLINE vt_value vt_int(int64_t x) {
+  vt_value v = {VT_NB_TAG(VT_NB_INT) | ((uint64_t)x & VT_NB_PAYLOAD)};
+  return v;
+}
+VT_OBJECT_INLINE vt_value vt_float(double x) {
+  vt_value v;
+  if (x != x) {
+    v.bits = VT_NB_QNAN;
+  } else {
+    memcpy(&v.bits, &x, sizeof x);
+  }
+  return v;
+}
+/* Valeur de type t (STR..PTR) désignant p. */
+VT_OBJECT_INLINE vt_value vt_obj(vt_type t, void* p) {
+  static const uint8_t H[VT_PTR + 1] = {0,         0,         0,
+                                        0,         VT_NB_STR, VT_NB_PTR,
+                                        VT_NB_ARRAY, VT_NB_MAP, VT_NB_FUNC,
+                                        VT_NB_PTR};
+  vt_value v = {VT_NB_TAG(H[t]) | ((uint64_t)(uintptr_t)p & VT_NB_PAYLOAD)};
+  if (t == VT_BYTES) v.bits |= VT_NB_BYTES_BIT;
+  return v;
+}
+#else
 typedef struct vt_value {
   uint32_t type;  /* vt_type */
   uint32_t flags; /* réservé */
@@ -61,19 +159,56 @@ typedef struct vt_value {
   } as;
 } vt_value;
 
+VT_OBJECT_INLINE vt_type vt_value_type(const vt_value* v) {
+  return (vt_type)v->type;
+}
+VT_OBJECT_INLINE int vt_is_int(const vt_value* v) { return v->type == VT_INT; }
+VT_OBJECT_INLINE int vt_is_float(const vt_value* v) {
+  return v->type == VT_FLOAT;
+}
+VT_OBJECT_INLINE int64_t vt_as_int(const vt_value* v) { return v->as.i; }
+VT_OBJECT_INLINE double vt_as_float(const vt_value* v) { return v->as.f; }
+VT_OBJECT_INLINE void* vt_as_ptr(const vt_value* v) { return v->as.p; }
+VT_OBJECT_INLINE int vt_as_bool(const vt_value* v) { return v->as.i != 0; }
+
+VT_OBJECT_INLINE vt_value vt__value_mk(uint32_t t, int64_t i) {
+  vt_value v;
+  v.type = t;
+  v.flags = 0;
+  v.as.i = i;
+  return v;
+}
+VT_OBJECT_INLINE vt_value vt_nil(void) { return vt__value_mk(VT_NIL, 0); }
+VT_OBJECT_INLINE vt_value vt_bool(int b) {
+  return vt__value_mk(VT_BOOL, b ? 1 : 0);
+}
+VT_OBJECT_INLINE vt_value vt_int(int64_t x) { return vt__value_mk(VT_INT, x); }
+VT_OBJECT_INLINE vt_value vt_float(double x) {
+  vt_value v;
+  v.type = VT_FLOAT;
+  v.flags = 0;
+  v.as.f = x;
+  return v;
+}
+/* Valeur de type t (STR..PTR) désignant p. */
+VT_OBJECT_INLINE vt_value vt_obj(vt_type t, void* p) {
+  vt_value v;
+  v.type = t;
+  v.flags = 0;
+  v.as.p = p;
+  return v;
+}
+#endif /* VT_VALUE_NANBOX */
+
 /* Nom lisible d’un tag */
 VT_OBJECT_API const char* vt_type_name(vt_type t);
 
 /* ----------------------------------------------------------------------------
-   Constructeurs scalaires
+   Constructeurs scalaires (inline ci-dessus: vt_nil, vt_bool, vt_int,
+   vt_float, vt_obj)
 ---------------------------------------------------------------------------- */
-VT_OBJECT_API vt_value vt_nil(void);
-VT_OBJECT_API vt_value vt_bool(int b);
-VT_OBJECT_API vt_value vt_int(int64_t x);
-VT_OBJECT_API vt_value vt_float(double x);
-
 /* Pointeur brut (interop natif) */
-VT_OBJECT_API vt_value vt_ptr(void* p);
+VT_OBJECT_INLINE vt_value vt_ptr(void* p) { return vt_obj(VT_PTR, p); }
 
 /* ----------------------------------------------------------------------------
    Strings (UTF-8 agnostique, NUL-terminé, RC)
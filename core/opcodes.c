@@ -126,6 +126,10 @@ typedef enum vt_opcode {
   /* Debug util */
   OP_PRINT, /* consomme au sommet et écrit debug */
 
+  /* Superinstructions (produites par vt_fuse) */
+  OP_LD_ADDI_ST, /* u16 src, i64 k, u16 dst */
+  OP_CMP_JF,     /* rel32, u8 cond (0=eq,1=ne,2=lt,3=le,4=gt,5=ge) */
+
   OP__COUNT
 } vt_opcode;
 
@@ -182,6 +186,7 @@ VT_OPCODES_API int vt_emit_f64(vt_bcode* bc, double v);
 VT_OPCODES_API int vt_emit_insn(vt_bcode* bc, vt_opcode op,
                                 const uint64_t* imm);
 VT_OPCODES_API int vt_patch_rel32(uint8_t* code, size_t from_off, int32_t rel);
+VT_OPCODES_API int vt_fuse(vt_bcode* bc, uint32_t* remap);
 
 VT_OPCODES_API int vt_branch_target(const uint8_t* base, size_t off, size_t len,
                                     size_t* out_target);
@@ -311,6 +316,19 @@ static const vt_opcode_info G_OPS[OP__COUNT] = {
     [OP_TLEAVE] = {"tleave", 0, {VT_OK_NONE}, 0, 0, 0},
 
     [OP_PRINT] = {"print", 0, {VT_OK_NONE}, 1, 0, 0},
+
+    [OP_LD_ADDI_ST] = {"ld_addi_st",
+                       3,
+                       {VT_OK_U16, VT_OK_I64, VT_OK_U16},
+                       0,
+                       0,
+                       VT_OF_MAYTHROW},
+    [OP_CMP_JF] = {"cmp_jf",
+                   2,
+                   {VT_OK_REL32, VT_OK_U8},
+                   2,
+                   0,
+                   VT_OF_BRANCH | VT_OF_COND | VT_OF_MAYTHROW},
 };
 
 /* Public getter */
@@ -720,6 +738,125 @@ int vt_patch_rel32(uint8_t* code, size_t from_off, int32_t rel) {
   return 1;
 }
 
+/* ----------------------------------------------------------------------------
+   Fusion de superinstructions
+   - Décode tout, marque les cibles de saut (rel32 en premier opérande,
+     TENTER compris), réémet en fusionnant les motifs dont seule la première
+     insn peut être une cible, puis recalcule les rel32 via la table
+     ancien offset -> nouveau.
+---------------------------------------------------------------------------- */
+typedef struct {
+  uint32_t at;  /* offset (nouveau) de l’insn à patcher */
+  uint32_t tgt; /* cible (ancien offset) */
+} fuse_fix;
+
+static int has_rel32(vt_opcode op) {
+  const vt_opcode_info* ii = vt_op_info(op);
+  return ii && ii->argc && ii->argk[0] == VT_OK_REL32;
+}
+
+int vt_fuse(vt_bcode* bc, uint32_t* remap) {
+  if (!bc || (bc->len && !bc->data)) return -1;
+  size_t len = bc->len;
+  if (len >= UINT32_MAX) return -1;
+  if (len == 0) {
+    if (remap) remap[0] = 0;
+    return 0;
+  }
+
+  int rc = -1, nfused = 0;
+  vt_insn* ins = (vt_insn*)malloc(len * sizeof(vt_insn));
+  uint32_t* offs = (uint32_t*)malloc(len * sizeof(uint32_t));
+  uint8_t* leader = (uint8_t*)calloc(len + 1, 1);
+  fuse_fix* fix = (fuse_fix*)malloc(len * sizeof(fuse_fix));
+  uint32_t* map = remap ? remap : (uint32_t*)malloc((len + 1) * sizeof(uint32_t));
+  vt_bcode out;
+  vt_bcode_init(&out);
+  if (!ins || !offs || !leader || !fix || !map || !ensure(&out, len)) goto done;
+
+  size_t n = 0, nfix = 0;
+  for (size_t off = 0; off < len;) {
+    size_t got = vt_decode(bc->data + off, len - off, &ins[n]);
+    if (!got) goto done;
+    offs[n++] = (uint32_t)off;
+    off += got;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (!has_rel32(ins[i].op)) continue;
+    int64_t tgt = (int64_t)offs[i] + (int64_t)ins[i].size +
+                  (int64_t)(int32_t)ins[i].imm[0];
+    if (tgt < 0 || (uint64_t)tgt > len) goto done;
+    leader[tgt] = 1;
+  }
+  for (size_t i = 0; i <= len; i++) map[i] = UINT32_MAX;
+
+  for (size_t i = 0; i < n;) {
+    const vt_insn* a = &ins[i];
+    map[offs[i]] = (uint32_t)out.len;
+
+    if (a->op == OP_LD && i + 3 < n && ins[i + 1].op == OP_ICONST &&
+        (ins[i + 2].op == OP_ADD || ins[i + 2].op == OP_SUB) &&
+        ins[i + 3].op == OP_ST && !leader[offs[i + 1]] &&
+        !leader[offs[i + 2]] && !leader[offs[i + 3]]) {
+      int64_t k = (int64_t)ins[i + 1].imm[0];
+      if (ins[i + 2].op == OP_SUB) {
+        if (k == INT64_MIN) goto plain; /* -k non représentable */
+        k = -k;
+      }
+      uint64_t imm[3] = {a->imm[0], (uint64_t)k, ins[i + 3].imm[0]};
+      if (!vt_emit_insn(&out, OP_LD_ADDI_ST, imm)) goto done;
+      nfused++;
+      i += 4;
+      continue;
+    }
+    if (a->op >= OP_EQ && a->op <= OP_GE && i + 1 < n &&
+        ins[i + 1].op == OP_JF && !leader[offs[i + 1]]) {
+      const vt_insn* j = &ins[i + 1];
+      uint64_t imm[2] = {0, (uint64_t)(a->op - OP_EQ)};
+      fix[nfix].at = (uint32_t)out.len;
+      fix[nfix++].tgt = (uint32_t)((int64_t)offs[i + 1] + (int64_t)j->size +
+                                   (int64_t)(int32_t)j->imm[0]);
+      if (!vt_emit_insn(&out, OP_CMP_JF, imm)) goto done;
+      nfused++;
+      i += 2;
+      continue;
+    }
+
+  plain:
+    if (has_rel32(a->op)) {
+      fix[nfix].at = (uint32_t)out.len;
+      fix[nfix++].tgt = (uint32_t)((int64_t)offs[i] + (int64_t)a->size +
+                                   (int64_t)(int32_t)a->imm[0]);
+    }
+    if (!ensure(&out, a->size)) goto done;
+    memcpy(out.data + out.len, bc->data + offs[i], a->size);
+    out.len += a->size;
+    i++;
+  }
+  map[len] = (uint32_t)out.len;
+
+  for (size_t f = 0; f < nfix; f++) {
+    uint32_t at = fix[f].at, nt = map[fix[f].tgt];
+    if (nt == UINT32_MAX) goto done; /* impossible: cibles jamais fusionnées */
+    int64_t rel = (int64_t)nt - ((int64_t)at + (int64_t)op_size((vt_opcode)out.data[at]));
+    vt_patch_rel32(out.data, at, (int32_t)rel);
+  }
+
+  free(bc->data);
+  *bc = out;
+  vt_bcode_init(&out);
+  rc = nfused;
+
+done:
+  vt_bcode_free(&out);
+  if (map != remap) free(map);
+  free(fix);
+  free(leader);
+  free(offs);
+  free(ins);
+  return rc;
+}
+
 /* ----------------------------------------------------------------------------
    Petite batterie de tests internes (compilation: -DVT_OPCODES_TEST)
 ---------------------------------------------------------------------------- */
@@ -784,6 +921,50 @@ int main(void) {
   if (vt_calc_stack_max(bc.data, bc.len, &mx)) {
     printf("stack_max≈%d\n", mx);
   }
+  vt_bcode_free(&bc);
+
+  /* fusion: L0: ld 0 ; iconst 10 ; lt ; jf L1 ; ld 0 ; iconst 1 ; add ;
+     st 0 ; jmp L0 ; L1: halt */
+  vt_bcode_init(&bc);
+  imm[0] = 0;
+  vt_emit_insn(&bc, OP_LD, imm);
+  imm[0] = 10;
+  vt_emit_insn(&bc, OP_ICONST, imm);
+  vt_emit_insn(&bc, OP_LT, NULL);
+  size_t jf_off = bc.len;
+  vt_emit_insn(&bc, OP_JF, NULL);
+  imm[0] = 0;
+  vt_emit_insn(&bc, OP_LD, imm);
+  imm[0] = 1;
+  vt_emit_insn(&bc, OP_ICONST, imm);
+  vt_emit_insn(&bc, OP_ADD, NULL);
+  imm[0] = 0;
+  vt_emit_insn(&bc, OP_ST, imm);
+  size_t jmp_off = bc.len;
+  vt_emit_insn(&bc, OP_JMP, NULL);
+  size_t L_end = bc.len;
+  vt_emit_insn(&bc, OP_HALT, NULL);
+  vt_patch_rel32(bc.data, jf_off,
+                 (int32_t)((int64_t)L_end - (int64_t)(jf_off + op_size(OP_JF))));
+  vt_patch_rel32(bc.data, jmp_off,
+                 (int32_t)(0 - (int64_t)(jmp_off + op_size(OP_JMP))));
+
+  size_t before = bc.len;
+  uint32_t remap[64];
+  int nf = vt_fuse(&bc, remap);
+  printf("fuse: %d motif(s), %zu -> %zu octets, halt 0x%zx -> 0x%x\n", nf,
+         before, bc.len, L_end, remap[L_end]);
+  if (nf != 2 || !vt_verify(bc.data, bc.len, err, sizeof err)) {
+    printf("fuse fail: %s\n", err);
+    return 1;
+  }
+  for (off = 0; off < bc.len;) {
+    int got = vt_disasm_line(bc.data, off, bc.len, line, sizeof line);
+    if (!got) break;
+    printf("%04zx: %s\n", off, line);
+    off += (size_t)got;
+  }
+  if (vt_calc_stack_max(bc.data, bc.len, &mx)) printf("stack_max≈%d\n", mx);
 
   vt_bcode_free(&bc);
   return 0;
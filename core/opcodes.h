@@ -117,6 +117,10 @@ typedef enum vt_opcode {
   /* Debug */
   OP_PRINT,
 
+  /* Superinstructions (produites par vt_fuse) */
+  OP_LD_ADDI_ST, /* u16 src, i64 k, u16 dst : local[dst] = local[src] + k */
+  OP_CMP_JF,     /* rel32, u8 cond (0=eq..5=ge) : a,b -> saut si !(a cond b) */
+
   OP__COUNT
 } vt_opcode;
 
@@ -211,6 +215,15 @@ VT_OPCODES_API int vt_emit_insn(vt_bcode* bc, vt_opcode op,
 /* Patch rel32 du premier opérande relatif d’une insn à from_off. 1=ok. */
 VT_OPCODES_API int vt_patch_rel32(uint8_t* code, size_t from_off, int32_t rel);
 
+/* Fusion de superinstructions (peephole), réécrit bc en place:
+     LD a; ICONST k; ADD|SUB; ST b  -> LD_ADDI_ST a, ±k, b
+     EQ..GE; JF                     -> CMP_JF rel, cond
+   Aucun motif ne traverse une cible de saut; les rel32 sont recalculés.
+   remap: NULL ou tableau de len+1 entrées (ancien offset -> nouveau,
+   UINT32_MAX si l’offset n’est plus un début d’insn).
+   Retourne le nombre de fusions, -1 si code invalide ou mémoire. */
+VT_OPCODES_API int vt_fuse(vt_bcode* bc, uint32_t* remap);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
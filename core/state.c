@@ -11,6 +11,7 @@
 #define _CRT_SECURE_NO_WARNINGS 1
 
 #include <errno.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -37,6 +38,9 @@
 #if __has_include("mem.h")
 #include "mem.h"
 #endif
+#if __has_include("hash.h")
+#include "hash.h"
+#endif
 #if __has_include("gc.h")
 #include "gc.h"
 #endif
@@ -46,6 +50,9 @@
 #if __has_include("parser.h")
 #include "parser.h"
 #endif
+#if __has_include("ir.h")
+#include "ir.h"
+#endif
 #if __has_include("state.h")
 #include "state.h"
 #endif
@@ -76,6 +83,12 @@ void vt_state_dump_ast(FILE* out, vt_state* st);
 
 const char* vt_intern_cstr(vt_state* st, const char* s);
 size_t vt_intern_id(vt_state* st, const char* s, size_t n);
+const char* vt_intern_str(vt_state* st, size_t id, size_t* len);
+size_t vt_intern_count(vt_state* st);
+int vt_state_add_code(vt_state* st, const char* name, const uint8_t* code,
+                      size_t len, uint16_t nlocals);
+int vt_state_lower(vt_state* st);
+const struct vt_ir* vt_state_ir(vt_state* st, size_t idx);
 #endif /* VT_STATE_H_SENTINEL */
 
 /* ---------------------------------------------------------------------------
@@ -217,14 +230,18 @@ static char* xstrdup(const char* s) {
   return p;
 }
 
-/* FNV-1a 64 */
-static uint64_t fnv1a(const void* key, size_t len) {
+/* Hash des chaînes internées (0 réservé) */
+static uint64_t str_hash(const void* key, size_t len, uint64_t seed) {
+#ifdef VT_HASH_H
+  uint64_t h = vt_hash64(key, len, seed);
+#else
   const unsigned char* p = (const unsigned char*)key;
-  uint64_t h = 1469598103934665603ull;
+  uint64_t h = 1469598103934665603ull ^ seed; /* FNV-1a 64 */
   while (len--) {
     h ^= *p++;
     h *= 1099511628211ull;
   }
+#endif
   return h ? h : 0x9e3779b97f4a7c15ull;
 }
 
@@ -257,19 +274,55 @@ static void path_normalize(char* s) {
 }
 
 /* ---------------------------------------------------------------------------
-   Interner (open addressing, power-of-two capacity)
+   Interner partitionné
+   - VT_INTERN_SHARDS partitions choisies par les bits hauts du hash; chacune
+     a sa table (open addressing, puissance de 2), son mutex et ses chunks.
+   - Lecture sans verrou: la table est publiée par pointeur atomique, chaque
+     case par un store release d’un intern_rec complet. Une case pleine ne
+     change plus; les tables remplacées restent valides jusqu’à la
+     destruction (taille totale < 2 × table finale).
+   - Écriture: mutex de la partition, re-sonde, puis insertion.
+   - Ids denses 1..n (0: aucun), globaux; vt_intern_str les résout sans
+     verrou via un répertoire de pages.
 --------------------------------------------------------------------------- */
-typedef struct intern_entry {
-  const char* s;
-  size_t len;
+#ifndef VT_INTERN_SHARDS
+#define VT_INTERN_SHARDS 64 /* puissance de 2 */
+#endif
+#define VT_INTERN_PAGE_BITS 12
+#define VT_INTERN_PAGES     ((size_t)1 << 14) /* 64 M ids */
+
+typedef struct intern_rec {
   uint64_t h;
-} intern_entry;
+  uint32_t len;
+  uint32_t id;
+  char s[]; /* len octets + '\0' */
+} intern_rec;
+
+typedef struct intern_tab {
+  size_t cap; /* power of two, >= 8 */
+  struct intern_tab* retired; /* table précédente (libérée à la fin) */
+  _Atomic(intern_rec*) slot[];
+} intern_tab;
+
+typedef struct intern_chunk {
+  struct intern_chunk* next;
+  size_t used, cap;
+  _Alignas(8) unsigned char data[];
+} intern_chunk;
+
+typedef struct intern_shard {
+  _Atomic(intern_tab*) tab;
+  size_t len; /* occupancy (sous lock) */
+  vt_mutex lock;
+  intern_chunk* store; /* stockage des intern_rec (jamais déplacés) */
+  char pad[64];
+} intern_shard;
 
 typedef struct interner {
-  intern_entry* tab;
-  size_t cap;      /* power of two, >= 8 */
-  size_t len;      /* occupancy */
-  vt_arena* store; /* stockage des bytes (arène locale) */
+  intern_shard shard[VT_INTERN_SHARDS];
+  _Atomic uint32_t next_id;
+  uint64_t seed; /* vt_hash_seed() à la création */
+  _Atomic(_Atomic(intern_rec*)*) page[VT_INTERN_PAGES];
 } interner;
 
 static size_t round_pow2(size_t x) {
@@ -278,82 +331,140 @@ static size_t round_pow2(size_t x) {
   return p;
 }
 
+static intern_tab* intern_tab_new(size_t cap) {
+  intern_tab* t = (intern_tab*)xcalloc(1, sizeof(*t) + cap * sizeof(t->slot[0]));
+  t->cap = cap;
+  for (size_t i = 0; i < cap; i++) atomic_init(&t->slot[i], NULL);
+  return t;
+}
+
 static interner* interner_create(size_t init_cap) {
   interner* in = (interner*)xcalloc(1, sizeof(*in));
-  in->cap = round_pow2(init_cap ? init_cap : 64);
-  in->tab = (intern_entry*)xcalloc(in->cap, sizeof(intern_entry));
-#ifdef VT_MEM_H_SENTINEL
-  in->store = vt_arena_create(in->cap * 16);
-#else
-  in->store = arena_create(in->cap * 16);
+  size_t cap = round_pow2((init_cap ? init_cap : 64) / VT_INTERN_SHARDS);
+  for (size_t i = 0; i < VT_INTERN_SHARDS; i++) {
+    intern_shard* sh = &in->shard[i];
+    atomic_init(&sh->tab, intern_tab_new(cap));
+    if (vt_mutex_init(&sh->lock) != 0) VT_FATAL("interner mutex");
+  }
+  atomic_init(&in->next_id, 1);
+#ifdef VT_HASH_H
+  in->seed = vt_hash_seed();
 #endif
-  if (!in->store) VT_FATAL("OOM interner arena");
   return in;
 }
 static void interner_destroy(interner* in) {
   if (!in) return;
-  free(in->tab);
-#ifdef VT_MEM_H_SENTINEL
-  vt_arena_destroy(in->store);
-#else
-  arena_destroy(in->store);
-#endif
+  for (size_t i = 0; i < VT_INTERN_SHARDS; i++) {
+    intern_shard* sh = &in->shard[i];
+    intern_tab* t = atomic_load_explicit(&sh->tab, memory_order_relaxed);
+    while (t) {
+      intern_tab* n = t->retired;
+      free(t);
+      t = n;
+    }
+    intern_chunk* c = sh->store;
+    while (c) {
+      intern_chunk* n = c->next;
+      free(c);
+      c = n;
+    }
+    vt_mutex_destroy(&sh->lock);
+  }
+  for (size_t i = 0; i < VT_INTERN_PAGES; i++)
+    free((void*)atomic_load_explicit(&in->page[i], memory_order_relaxed));
   free(in);
 }
-static void interner_rehash(interner* in, size_t ncap) {
-  intern_entry* n = (intern_entry*)xcalloc(ncap, sizeof(*n));
-  for (size_t i = 0; i < in->cap; i++) {
-    intern_entry e = in->tab[i];
-    if (!e.s) continue;
-    size_t mask = ncap - 1;
-    size_t j = (size_t)e.h & mask;
-    while (n[j].s) j = (j + 1) & mask;
-    n[j] = e;
-  }
-  free(in->tab);
-  in->tab = n;
-  in->cap = ncap;
-}
-static const char* interner_put(interner* in, const char* s, size_t len,
-                                uint64_t h) {
-  if ((in->len * 10) >= (in->cap * 7)) { /* 70% */
-    interner_rehash(in, in->cap << 1);
-  }
-  size_t mask = in->cap - 1;
+
+static intern_rec* intern_rec_alloc(intern_shard* sh, size_t len) {
+  size_t need = (sizeof(intern_rec) + len + 1 + 7) & ~(size_t)7;
+  intern_chunk* c = sh->store;
+  if (!c || c->cap - c->used < need) {
+    size_t cap = need > 16384 ? need : 16384;
+    c = (intern_chunk*)xmalloc(sizeof(*c) + cap);
+    c->next = sh->store;
+    c->used = 0;
+    c->cap = cap;
+    sh->store = c;
+  }
+  intern_rec* r = (intern_rec*)(c->data + c->used);
+  c->used += need;
+  return r;
+}
+
+/* Sonde t; NULL si absent (lecture seule, sans verrou). */
+static intern_rec* interner_find(intern_tab* t, const char* s, size_t len,
+                                 uint64_t h) {
+  size_t mask = t->cap - 1;
   size_t i = (size_t)h & mask;
-  while (in->tab[i].s) {
-    if (in->tab[i].h == h && in->tab[i].len == len &&
-        memcmp(in->tab[i].s, s, len) == 0) {
-      return in->tab[i].s;
-    }
+  for (;;) {
+    intern_rec* r = atomic_load_explicit(&t->slot[i], memory_order_acquire);
+    if (!r) return NULL;
+    if (r->h == h && r->len == len && memcmp(r->s, s, len) == 0) return r;
     i = (i + 1) & mask;
   }
-#ifdef VT_MEM_H_SENTINEL
-  char* dst = (char*)vt_arena_alloc(in->store, len + 1, 1);
-#else
-  char* dst = (char*)arena_alloc(in->store, len + 1, 1);
-#endif
-  if (!dst) VT_FATAL("OOM interner store");
-  memcpy(dst, s, len);
-  dst[len] = 0;
-  in->tab[i].s = dst;
-  in->tab[i].len = len;
-  in->tab[i].h = h;
-  in->len++;
-  return dst;
-}
-static const char* interner_get(interner* in, const char* s, size_t len,
-                                uint64_t h) {
-  size_t mask = in->cap - 1;
-  size_t i = (size_t)h & mask;
-  while (in->tab[i].s) {
-    if (in->tab[i].h == h && in->tab[i].len == len &&
-        memcmp(in->tab[i].s, s, len) == 0) {
-      return in->tab[i].s;
+}
+
+static void interner_rehash(intern_shard* sh, intern_tab* old) {
+  intern_tab* n = intern_tab_new(old->cap << 1);
+  size_t mask = n->cap - 1;
+  for (size_t i = 0; i < old->cap; i++) {
+    intern_rec* r = atomic_load_explicit(&old->slot[i], memory_order_relaxed);
+    if (!r) continue;
+    size_t j = (size_t)r->h & mask;
+    while (atomic_load_explicit(&n->slot[j], memory_order_relaxed)) j = (j + 1) & mask;
+    atomic_store_explicit(&n->slot[j], r, memory_order_relaxed);
+  }
+  n->retired = old;
+  atomic_store_explicit(&sh->tab, n, memory_order_release);
+}
+
+/* Publie r sous son id (page allouée à la demande, sous le lock du shard:
+   deux shards peuvent se disputer une page neuve, d’où le CAS). */
+static void interner_publish_id(interner* in, intern_rec* r) {
+  size_t pg = (size_t)r->id >> VT_INTERN_PAGE_BITS;
+  if (pg >= VT_INTERN_PAGES) VT_FATAL("interner: trop d’ids");
+  _Atomic(intern_rec*)* page = atomic_load_explicit(&in->page[pg], memory_order_acquire);
+  if (!page) {
+    _Atomic(intern_rec*)* fresh = (_Atomic(intern_rec*)*)xcalloc((size_t)1 << VT_INTERN_PAGE_BITS, sizeof(*fresh));
+    if (atomic_compare_exchange_strong_explicit(&in->page[pg], &page, fresh, memory_order_acq_rel,
+                                                memory_order_acquire))
+      page = fresh;
+    else
+      free((void*)fresh);
+  }
+  atomic_store_explicit(&page[r->id & (((size_t)1 << VT_INTERN_PAGE_BITS) - 1)], r, memory_order_release);
+}
+
+static intern_rec* interner_intern(interner* in, const char* s, size_t len) {
+  uint64_t h = str_hash(s, len, in->seed);
+  intern_shard* sh = &in->shard[(h >> 58) & (VT_INTERN_SHARDS - 1)];
+  intern_rec* r = interner_find(atomic_load_explicit(&sh->tab, memory_order_acquire), s, len, h);
+  if (r) return r;
+
+  vt_mutex_lock(&sh->lock);
+  intern_tab* t = atomic_load_explicit(&sh->tab, memory_order_relaxed);
+  r = interner_find(t, s, len, h);
+  if (!r) {
+    if ((sh->len + 1) * 10 >= t->cap * 7) { /* 70% */
+      interner_rehash(sh, t);
+      t = atomic_load_explicit(&sh->tab, memory_order_relaxed);
     }
-    i = (i + 1) & mask;
+    if (len > UINT32_MAX) VT_FATAL("interner: chaîne trop longue");
+    r = intern_rec_alloc(sh, len);
+    r->h = h;
+    r->len = (uint32_t)len;
+    memcpy(r->s, s, len);
+    r->s[len] = 0;
+    r->id = atomic_fetch_add_explicit(&in->next_id, 1, memory_order_relaxed);
+    interner_publish_id(in, r);
+    size_t mask = t->cap - 1;
+    size_t i = (size_t)h & mask;
+    while (atomic_load_explicit(&t->slot[i], memory_order_relaxed)) i = (i + 1) & mask;
+    atomic_store_explicit(&t->slot[i], r, memory_order_release);
+    sh->len++;
   }
-  return NULL;
+  vt_mutex_unlock(&sh->lock);
+  return r;
 }
 
 /* ---------------------------------------------------------------------------
@@ -386,6 +497,33 @@ static void vec_src_push(vec_src* v, vt_source s) {
   v->data[v->len++] = s;
 }
 
+/* Unité de bytecode (une fonction) en attente d’abaissement. */
+typedef struct vt_unit {
+  const char* name; /* interné */
+  uint8_t* code;    /* propriété state */
+  size_t len;
+  uint16_t nlocals;
+#ifdef VT_IR_H
+  vt_ir ir; /* rempli par vt_state_lower */
+#endif
+  int lowered;
+} vt_unit;
+
+typedef struct vec_unit {
+  vt_unit* data;
+  size_t len, cap;
+} vec_unit;
+
+static void vec_unit_push(vec_unit* v, vt_unit u) {
+  if (v->len == v->cap) {
+    size_t ncap = v->cap ? v->cap * 2 : 8;
+    v->data = (vt_unit*)realloc(v->data, ncap * sizeof(*v->data));
+    if (!v->data) VT_FATAL("OOM vec_unit");
+    v->cap = ncap;
+  }
+  v->data[v->len++] = u;
+}
+
 /* ---------------------------------------------------------------------------
    État global
 --------------------------------------------------------------------------- */
@@ -409,6 +547,9 @@ struct vt_state {
   /* Sources */
   vec_src sources;
 
+  /* Bytecode + IR */
+  vec_unit units;
+
   /* Stats */
   size_t n_parsed;
   size_t n_errors;
@@ -480,6 +621,15 @@ void vt_state_destroy(vt_state* st) {
   }
   free(st->sources.data);
 
+  /* Free units */
+  for (size_t i = 0; i < st->units.len; i++) {
+#ifdef VT_IR_H
+    vt_ir_free(&st->units.data[i].ir);
+#endif
+    free(st->units.data[i].code);
+  }
+  free(st->units.data);
+
   /* Interner + allocs */
   interner_destroy(st->atoms);
 
@@ -509,25 +659,28 @@ void vt_state_destroy(vt_state* st) {
 --------------------------------------------------------------------------- */
 const char* vt_intern_cstr(vt_state* st, const char* s) {
   if (!s) return "";
-  size_t n = strlen(s);
-  uint64_t h = fnv1a(s, n);
-  vt_mutex_lock(&st->lock);
-  const char* out = interner_get(st->atoms, s, n, h);
-  if (!out) out = interner_put(st->atoms, s, n, h);
-  vt_mutex_unlock(&st->lock);
-  return out;
+  return interner_intern(st->atoms, s, strlen(s))->s;
 }
 
 size_t vt_intern_id(vt_state* st, const char* s, size_t n) {
   if (!s) return 0;
-  uint64_t h = fnv1a(s, n);
-  vt_mutex_lock(&st->lock);
-  const char* out = interner_get(st->atoms, s, n, h);
-  if (!out) out = interner_put(st->atoms, s, n, h);
-  /* hash comme id stable (troncature possible côté appelant si besoin) */
-  size_t id = (size_t)h;
-  vt_mutex_unlock(&st->lock);
-  return id;
+  return interner_intern(st->atoms, s, n)->id;
+}
+
+const char* vt_intern_str(vt_state* st, size_t id, size_t* len) {
+  if (!st || id == 0 || (id >> VT_INTERN_PAGE_BITS) >= VT_INTERN_PAGES) return NULL;
+  _Atomic(intern_rec*)* page =
+      atomic_load_explicit(&st->atoms->page[id >> VT_INTERN_PAGE_BITS], memory_order_acquire);
+  if (!page) return NULL;
+  intern_rec* r = atomic_load_explicit(&page[id & (((size_t)1 << VT_INTERN_PAGE_BITS) - 1)],
+                                       memory_order_acquire);
+  if (!r) return NULL;
+  if (len) *len = r->len;
+  return r->s;
+}
+
+size_t vt_intern_count(vt_state* st) {
+  return st ? (size_t)atomic_load_explicit(&st->atoms->next_id, memory_order_relaxed) - 1 : 0;
 }
 
 /* ---------------------------------------------------------------------------
@@ -658,17 +811,196 @@ void vt_state_dump_ast(FILE* out, vt_state* st) {
 }
 
 /* ---------------------------------------------------------------------------
-   Extensions futures (stubs non fatales)
+   Bytecode → IR à registres
 --------------------------------------------------------------------------- */
-int vt_state_lower(vt_state* st) {
-  (void)st; /* IR/SSA */
+int vt_state_add_code(vt_state* st, const char* name, const uint8_t* code,
+                      size_t len, uint16_t nlocals) {
+  if (!st || !code || !len) return -EINVAL;
+  vt_unit u = {0};
+  u.name = vt_intern_cstr(st, name ? name : "<code>");
+  u.code = (uint8_t*)xmalloc(len);
+  memcpy(u.code, code, len);
+  u.len = len;
+  u.nlocals = nlocals;
+#ifdef VT_IR_H
+  vt_ir_init(&u.ir);
+#endif
+  vt_mutex_lock(&st->lock);
+  vec_unit_push(&st->units, u);
+  vt_mutex_unlock(&st->lock);
   return 0;
 }
+
+/* Abaisse chaque unité non encore traitée (vt_ir_lower: propagation de
+   copies, élimination des slots de pile, cmp+saut fusionnés).
+   0=OK, <0 si une unité est invalide (les autres sont abaissées). */
+int vt_state_lower(vt_state* st) {
+#ifndef VT_IR_H
+  (void)st;
+  VT_ERROR("ir.h absent: vt_state_lower indisponible");
+  return -ENOSYS;
+#else
+  if (!st) return -EINVAL;
+  int rc = 0;
+  vt_mutex_lock(&st->lock);
+  for (size_t i = 0; i < st->units.len; i++) {
+    vt_unit* u = &st->units.data[i];
+    if (u->lowered) continue;
+    char err[128] = "";
+    int r = vt_ir_lower(u->code, u->len, u->nlocals, &u->ir, err, sizeof err);
+    if (r != 0) {
+      VT_ERROR("lower: %s — %s (%d)", u->name, err, r);
+      if (rc == 0) rc = r;
+      continue;
+    }
+    u->lowered = 1;
+#ifdef VT_DEBUG_H
+    VT_DEBUG("lower: %s — %zu insn(s) pile → %zu insn(s) IR", u->name,
+             u->ir.n_stack, u->ir.len);
+#endif
+  }
+  vt_mutex_unlock(&st->lock);
+  return rc;
+#endif
+}
+
+const struct vt_ir* vt_state_ir(vt_state* st, size_t idx) {
+#ifndef VT_IR_H
+  (void)st;
+  (void)idx;
+  return NULL;
+#else
+  if (!st) return NULL;
+  vt_mutex_lock(&st->lock);
+  const vt_ir* ir = NULL;
+  if (idx < st->units.len && st->units.data[idx].lowered)
+    ir = &st->units.data[idx].ir;
+  vt_mutex_unlock(&st->lock);
+  return ir;
+#endif
+}
+
+/* ---------------------------------------------------------------------------
+   Extensions futures (stubs non fatales)
+--------------------------------------------------------------------------- */
 int vt_state_codegen(vt_state* st) {
   (void)st; /* bytecode/obj */
   return 0;
 }
 
+/* ---------------------------------------------------------------------------
+   Bench (-DVT_STATE_BENCH, POSIX): N threads internent chacun leur part
+   d’un flux d’identifiants (distribution biaisée comme un vrai corpus);
+   référence: les mêmes appels sérialisés par un mutex global.
+   cc -std=gnu17 -O2 -DVT_STATE_BENCH state.c hash.c debug.c ir.c opcodes.c \
+      parser.c lex.c -lpthread -lm
+--------------------------------------------------------------------------- */
+#if defined(VT_STATE_BENCH) && !defined(_WIN32)
+#define VT_SB_DISTINCT 200000u
+#define VT_SB_TOKENS   4000000u
+
+typedef struct {
+  vt_state* st;
+  pthread_mutex_t* serial;
+  const uint32_t* toks;
+  size_t n;
+  char (*names)[24];
+  size_t* out; /* un id par jeton de la tranche, lu après pthread_join */
+} vt_sb_arg;
+
+static void* vt_sb_worker(void* p) {
+  vt_sb_arg* a = (vt_sb_arg*)p;
+  for (size_t i = 0; i < a->n; i++) {
+    const char* nm = a->names[a->toks[i]];
+    if (a->serial) pthread_mutex_lock(a->serial);
+    size_t id = vt_intern_id(a->st, nm, strlen(nm));
+    if (a->serial) pthread_mutex_unlock(a->serial);
+    a->out[i] = id;
+  }
+  return NULL;
+}
+
+static double vt_sb_run(int nthreads, int serial, const uint32_t* toks,
+                        char (*names)[24], size_t* out, size_t* ids) {
+  vt_state_config cfg = {4, 0, NULL, 0, 256};
+  vt_state* st = vt_state_create(&cfg);
+  pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
+  pthread_t th[64];
+  vt_sb_arg arg[64];
+  struct timespec t0, t1;
+  memset(ids, 0, VT_SB_DISTINCT * sizeof(*ids));
+  timespec_get(&t0, TIME_UTC);
+  size_t per = VT_SB_TOKENS / (size_t)nthreads;
+  for (int i = 0; i < nthreads; i++) {
+    arg[i] = (vt_sb_arg){st, serial ? &mu : NULL, toks + per * (size_t)i,
+                         i + 1 == nthreads ? VT_SB_TOKENS - per * (size_t)i : per,
+                         names, out + per * (size_t)i};
+    pthread_create(&th[i], NULL, vt_sb_worker, &arg[i]);
+  }
+  for (int i = 0; i < nthreads; i++) pthread_join(th[i], NULL);
+  timespec_get(&t1, TIME_UTC);
+
+  /* même id pour un même nom quel que soit le thread */
+  for (size_t i = 0; i < VT_SB_TOKENS; i++) {
+    if (ids[toks[i]] && ids[toks[i]] != out[i]) {
+      fprintf(stderr, "intern: deux ids pour %s\n", names[toks[i]]);
+      exit(1);
+    }
+    ids[toks[i]] = out[i];
+  }
+  /* ids denses, bijectifs, résolus par vt_intern_str */
+  size_t n = vt_intern_count(st), seen = 0;
+  unsigned char* hit = (unsigned char*)xcalloc(n + 1, 1);
+  for (size_t i = 0; i < VT_SB_DISTINCT; i++) {
+    if (!ids[i]) continue;
+    const char* s = vt_intern_str(st, ids[i], NULL);
+    if (ids[i] > n || hit[ids[i]] || !s || strcmp(s, names[i]) != 0) {
+      fprintf(stderr, "intern: id %zu incohérent pour %s\n", ids[i], names[i]);
+      exit(1);
+    }
+    hit[ids[i]] = 1;
+    seen++;
+  }
+  if (seen != n) {
+    fprintf(stderr, "intern: %zu ids pour %zu chaînes\n", n, seen);
+    exit(1);
+  }
+  free(hit);
+  vt_state_destroy(st);
+  double dt = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  return (double)VT_SB_TOKENS / dt * 1e-6;
+}
+
+int main(void) {
+  static const char* syl[] = {"get", "set", "node", "buf", "len", "tmp", "ctx", "vt",
+                              "map", "key", "val", "idx", "ptr", "str", "tok", "ir"};
+  char (*names)[24] = (char (*)[24])xmalloc(VT_SB_DISTINCT * sizeof(*names));
+  uint32_t* toks = (uint32_t*)xmalloc(VT_SB_TOKENS * sizeof(*toks));
+  size_t* ids = (size_t*)xmalloc(VT_SB_DISTINCT * sizeof(*ids));
+  size_t* out = (size_t*)xmalloc(VT_SB_TOKENS * sizeof(*out));
+  uint64_t x = 0x9e3779b97f4a7c15ull;
+  for (uint32_t i = 0; i < VT_SB_DISTINCT; i++) {
+    snprintf(names[i], sizeof names[i], "%s_%s%u", syl[i & 15], syl[(i >> 4) & 15], i >> 8);
+  }
+  for (size_t i = 0; i < VT_SB_TOKENS; i++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    double u = (double)(x >> 11) * (1.0 / 9007199254740992.0);
+    toks[i] = (uint32_t)(u * u * u * VT_SB_DISTINCT); /* rangs faibles fréquents */
+  }
+  printf("vt_intern_id, %u jetons, %u identifiants (Mjetons/s):\n", VT_SB_TOKENS, VT_SB_DISTINCT);
+  for (int t = 1; t <= 16; t *= 2) {
+    double a = vt_sb_run(t, 1, toks, names, out, ids);
+    double b = vt_sb_run(t, 0, toks, names, out, ids);
+    printf("  %2d threads  sérialisé %7.1f  partitionné %7.1f  (x%.2f)\n", t, a, b, b / a);
+  }
+  free(out);
+  free(ids);
+  free(toks);
+  free(names);
+  return 0;
+}
+#endif /* VT_STATE_BENCH */
+
 /* ---------------------------------------------------------------------------
    Fin
 --------------------------------------------------------------------------- */
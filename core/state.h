@@ -11,6 +11,7 @@
 #define VT_STATE_H_SENTINEL 1
 
 #include <stddef.h> /* size_t */
+#include <stdint.h> /* uint8_t, uint16_t */
 #include <stdio.h>  /* FILE */
 
 #ifdef __cplusplus
@@ -69,15 +70,40 @@ VT_STATE_API int vt_state_parse_all(vt_state* st);
 /* Dump lisible de tous les AST et diagnostics. out=NULL → stderr. */
 VT_STATE_API void vt_state_dump_ast(FILE* out, vt_state* st);
 
+/* ---------------------------------------------------------------------------
+   Bytecode et IR à registres (ir.h)
+--------------------------------------------------------------------------- */
+struct vt_ir;
+
+/* Enregistre une unité de bytecode VTBC (une fonction, nlocals locaux).
+   Le code est copié. 0=OK, <0=erreur. */
+VT_STATE_API int vt_state_add_code(vt_state* st, const char* name,
+                                   const uint8_t* code, size_t len,
+                                   uint16_t nlocals);
+
+/* Abaisse les unités enregistrées vers l’IR à registres.
+   0=OK, -ENOEXEC si une unité est invalide, -ENOSYS si ir.h absent. */
+VT_STATE_API int vt_state_lower(vt_state* st);
+
+/* IR de l’unité idx (ordre d’ajout), NULL si absente ou non abaissée.
+   Lifetime = st. */
+VT_STATE_API const struct vt_ir* vt_state_ir(vt_state* st, size_t idx);
+
 /* ---------------------------------------------------------------------------
    Interning (chaînes uniques, stables)
+   Appelable depuis plusieurs threads: table partitionnée, chaîne déjà
+   internée trouvée sans verrou.
 --------------------------------------------------------------------------- */
 /* Intern une chaîne C terminée par '\0'. Retourne un pointeur stable (lifetime
  * = st). */
 VT_STATE_API const char* vt_intern_cstr(vt_state* st, const char* s);
-/* Intern depuis (s,n). Retourne un identifiant dérivé du hash (stable dans le
- * run). */
+/* Intern depuis (s,n). Retourne un identifiant dense (1, 2, … dans l’ordre
+ * d’arrivée des chaînes nouvelles), stable dans le run; 0 si s == NULL. */
 VT_STATE_API size_t vt_intern_id(vt_state* st, const char* s, size_t n);
+/* Chaîne d’un id (len optionnel), NULL si inconnu. Sans verrou. */
+VT_STATE_API const char* vt_intern_str(vt_state* st, size_t id, size_t* len);
+/* Nombre d’ids attribués (plus grand id). */
+VT_STATE_API size_t vt_intern_count(vt_state* st);
 
 #ifdef __cplusplus
 } /* extern "C" */
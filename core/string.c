@@ -41,6 +41,14 @@ typedef ptrdiff_t ssize_t;
 #if __has_include("vt_string.h")
 #include "vt_string.h"
 #endif
+#if __has_include("utf8.h")
+#include "utf8.h"
+#define VT_STRING_HAVE_UTF8 1
+#endif
+#if __has_include("base64.h")
+#include "base64.h"
+#define VT_STRING_HAVE_B64 1
+#endif
 #endif
 
 /* ----------------------------------------------------------------------------
@@ -620,6 +628,9 @@ int32_t vt_utf8_next(const char* p, size_t n, size_t* adv) {
   return cp;
 }
 bool vt_utf8_valid(vt_sv s) {
+#ifdef VT_STRING_HAVE_UTF8
+  return utf8_validate(s.data, s.len) != 0;
+#else
   size_t i = 0;
   while (i < s.len) {
     size_t adv = 0;
@@ -628,8 +639,13 @@ bool vt_utf8_valid(vt_sv s) {
     i += adv;
   }
   return true;
+#endif
 }
 size_t vt_utf8_count(vt_sv s) {
+#ifdef VT_STRING_HAVE_UTF8
+  if (!utf8_validate(s.data, s.len)) return (size_t)-1;
+  return utf8_count(s.data, s.len);
+#else
   size_t i = 0, cnt = 0;
   while (i < s.len) {
     size_t adv = 0;
@@ -639,6 +655,7 @@ size_t vt_utf8_count(vt_sv s) {
     cnt++;
   }
   return cnt;
+#endif
 }
 
 /* ----------------------------------------------------------------------------
@@ -735,6 +752,37 @@ bool vt_parse_f64(vt_sv s, double* out) {
 /* ----------------------------------------------------------------------------
    Hex / Base64
 ---------------------------------------------------------------------------- */
+#ifdef VT_STRING_HAVE_B64
+/* Moteur vectoriel de base64.c; out n’est pas étendu si l’entrée est invalide */
+void vt_hex_encode(vt_str* out, const void* data, size_t n, bool upper) {
+  vt_str_reserve(out, out->len + n * 2);
+  out->len += vt_b16_encode(data, n, out->data + out->len, upper ? VT_B16_UPPER : 0);
+  out->data[out->len] = 0;
+}
+bool vt_hex_decode(vt_str* out_bin, vt_sv hex) {
+  size_t got = 0;
+  vt_str_reserve(out_bin, out_bin->len + hex.len / 2);
+  bool ok = vt_b16_decode(hex.data, hex.len, out_bin->data + out_bin->len, &got) == 0;
+  if (ok) out_bin->len += got;
+  out_bin->data[out_bin->len] = 0;
+  return ok;
+}
+void vt_base64_encode(vt_str* out, const void* data, size_t n) {
+  vt_str_reserve(out, out->len + VT_B64_ENC_LEN(n));
+  out->len += vt_b64_encode(data, n, out->data + out->len, 0);
+  out->data[out->len] = 0;
+}
+/* Blancs ignorés, padding obligatoire */
+bool vt_base64_decode(vt_str* out_bin, vt_sv b64) {
+  size_t got = 0;
+  vt_str_reserve(out_bin, out_bin->len + VT_B64_DEC_MAX(b64.len));
+  bool ok = vt_b64_decode(b64.data, b64.len, out_bin->data + out_bin->len, &got,
+                          VT_B64_SPACE) == 0;
+  if (ok) out_bin->len += got;
+  out_bin->data[out_bin->len] = 0;
+  return ok;
+}
+#else
 void vt_hex_encode(vt_str* out, const void* data, size_t n, bool upper) {
   static const char* HEX = "0123456789abcdef";
   static const char* HEXU = "0123456789ABCDEF";
@@ -824,6 +872,7 @@ bool vt_base64_decode(vt_str* out_bin, vt_sv b64) {
   }
   return qi == 0;
 }
+#endif
 
 /* ----------------------------------------------------------------------------
    Hash
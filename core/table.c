@@ -6,10 +6,14 @@
    - Effacement par backward-shift (pas de tombstones). Rehash auto.
    - Iteration stable via vt_table_next.
    - Thread-safety non incluse par design.
+   - Moteur « swiss » optionnel (config.backend = VT_TABLE_SWISS): octets de
+     contrôle à part (7 bits de hash ou vide/supprimé), sondés 16 par 16 en
+     SSE2/NEON, cases vt_entry dans un tableau distinct.
    Licence: MIT.
    ============================================================================
  */
 #include "table.h"
+#include "hash.h"
 
 #include <assert.h>
 #include <stdbool.h>
@@ -18,6 +22,17 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VT__SW_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VT__SW_NEON 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 /* ----------------------------------------------------------------------------
    Helpers
 ---------------------------------------------------------------------------- */
@@ -35,23 +50,6 @@ static inline uint64_t vt__rotl64(uint64_t x, unsigned r) {
   return (x << r) | (x >> (64 - r));
 }
 
-static uint64_t vt__fnv1a64(const void* p, size_t n, void* u) {
-  (void)u;
-  const uint8_t* b = (const uint8_t*)p;
-  uint64_t h = 1469598103934665603ull; /* FNV offset basis */
-  for (size_t i = 0; i < n; i++) {
-    h ^= b[i];
-    h *= 1099511628211ull; /* FNV prime */
-  }
-  /* légère avalanche */
-  h ^= h >> 33;
-  h *= 0xff51afd7ed558ccdULL;
-  h ^= h >> 33;
-  h *= 0xc4ceb9fe1a85ec53ULL;
-  h ^= h >> 33;
-  return h;
-}
-
 static int vt__bytes_eq(const void* a, size_t alen, const void* b, size_t blen,
                         void* u) {
   (void)u;
@@ -88,6 +86,14 @@ struct vt_table {
   size_t len;     /* nb d’entrées occupées */
   size_t grow_at; /* seuil de redimensionnement */
   bool copy_keys; /* si 1 → duplique les clés à l’insertion */
+  /* swiss */
+  bool swiss;
+  int8_t* ctrl;       /* cap octets, alignés sur 16 */
+  void* ctrl_raw;
+  size_t growth_left; /* cases vides consommables avant rehash */
+  /* hash par défaut: vt_hash64 avec la graine prise à l’init */
+  bool default_hash;
+  uint64_t seed;
 };
 
 /* ----------------------------------------------------------------------------
@@ -103,6 +109,8 @@ static void vt__free_key_val(const vt_table* t, vt_entry* e) {
   if (e->hash == 0) return;
   if (t->cfg.free_key && (t->copy_keys || t->cfg.free_key_always)) {
     t->cfg.free_key(e->kptr, t->cfg.udata);
+  } else if (t->copy_keys) {
+    VT_FREE(e->kptr); /* copie faite par la table */
   }
   if (t->cfg.free_val) {
     t->cfg.free_val(e->vptr, t->cfg.udata);
@@ -273,6 +281,212 @@ static void vt__erase_at(vt_table* t, size_t idx) {
   t->len--;
 }
 
+/* ----------------------------------------------------------------------------
+   Core swiss
+   - ctrl[i]: EMPTY, DELETED, ou 0..127 = 7 bits bas du hash (case pleine).
+   - Groupe = 16 cases alignées; sonde triangulaire de groupe en groupe
+     (couvre tous les groupes, leur nombre étant une puissance de 2).
+   - Un groupe contenant une case EMPTY arrête la recherche: une suppression
+     n’y remet EMPTY que si le groupe en a déjà une (sinon DELETED).
+---------------------------------------------------------------------------- */
+#define VT__SW_GROUP 16
+#define VT__SW_EMPTY ((int8_t)-128)
+#define VT__SW_DELETED ((int8_t)-2)
+
+#if defined(VT__SW_NEON)
+typedef uint64_t vt__swmask; /* 4 bits par case */
+#define VT__SW_BITS 2
+#define VT__SW_KEEP 0x8888888888888888ull
+#else
+typedef uint32_t vt__swmask; /* 1 bit par case */
+#define VT__SW_BITS 0
+#define VT__SW_KEEP 0xffffu
+#endif
+
+static inline unsigned vt__sw_ctz(vt__swmask m) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_ctzll((unsigned long long)m);
+#elif defined(_MSC_VER) && defined(_WIN64)
+  unsigned long i;
+  _BitScanForward64(&i, (unsigned long long)m);
+  return (unsigned)i;
+#else
+  unsigned n = 0;
+  while (!(m & 1)) { m >>= 1; n++; }
+  return n;
+#endif
+}
+
+/* Cases du groupe g dont le contrôle vaut b */
+static inline vt__swmask vt__sw_match(const int8_t* g, int8_t b) {
+#if defined(VT__SW_SSE2)
+  __m128i c = _mm_load_si128((const __m128i*)g);
+  return (vt__swmask)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(b)));
+#elif defined(VT__SW_NEON)
+  uint8x16_t eq = vceqq_s8(vld1q_s8(g), vdupq_n_s8(b));
+  uint8x8_t nib = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(nib), 0) & VT__SW_KEEP;
+#else
+  vt__swmask m = 0;
+  for (unsigned i = 0; i < VT__SW_GROUP; i++) m |= (vt__swmask)(g[i] == b) << i;
+  return m;
+#endif
+}
+
+/* Cases EMPTY ou DELETED (bit de signe) */
+static inline vt__swmask vt__sw_match_free(const int8_t* g) {
+#if defined(VT__SW_SSE2)
+  return (vt__swmask)_mm_movemask_epi8(_mm_load_si128((const __m128i*)g));
+#elif defined(VT__SW_NEON)
+  uint8x16_t neg = vcltq_s8(vld1q_s8(g), vdupq_n_s8(0));
+  uint8x8_t nib = vshrn_n_u16(vreinterpretq_u16_u8(neg), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(nib), 0) & VT__SW_KEEP;
+#else
+  vt__swmask m = 0;
+  for (unsigned i = 0; i < VT__SW_GROUP; i++) m |= (vt__swmask)(g[i] < 0) << i;
+  return m;
+#endif
+}
+
+static inline size_t vt__sw_growth(const vt_table* t, size_t cap) {
+  size_t g = (size_t)((double)cap * (double)t->cfg.max_load);
+  return g >= cap ? cap - 1 : g;
+}
+
+/* Nouveau tableau de cap cases (puissance de 2, ≥ 16), entrées réinsérées. */
+static void vt__sw_resize(vt_table* t, size_t new_cap) {
+  vt_entry* old = t->slots;
+  int8_t* old_ctrl = t->ctrl;
+  void* old_raw = t->ctrl_raw;
+  size_t old_cap = t->cap;
+
+  void* raw = VT_MALLOC(new_cap + VT__SW_GROUP);
+  vt_entry* slots = (vt_entry*)VT_MALLOC(new_cap * sizeof(vt_entry));
+  assert(raw && slots && "allocation failed");
+  t->ctrl_raw = raw;
+  t->ctrl = (int8_t*)(((uintptr_t)raw + VT__SW_GROUP - 1) & ~(uintptr_t)(VT__SW_GROUP - 1));
+  memset(t->ctrl, (unsigned char)VT__SW_EMPTY, new_cap);
+  memset(slots, 0, new_cap * sizeof(vt_entry));
+  t->slots = slots;
+  t->cap = new_cap;
+  t->growth_left = vt__sw_growth(t, new_cap) - t->len;
+
+  size_t gmask = new_cap / VT__SW_GROUP - 1;
+  for (size_t i = 0; i < old_cap; i++) {
+    if (old_ctrl[i] < 0) continue;
+    uint64_t h = old[i].hash;
+    size_t g = (size_t)(h >> 7) & gmask;
+    for (size_t step = 0;; g = (g + ++step) & gmask) {
+      vt__swmask m = vt__sw_match_free(t->ctrl + g * VT__SW_GROUP);
+      if (m) {
+        size_t j = g * VT__SW_GROUP + (vt__sw_ctz(m) >> VT__SW_BITS);
+        t->ctrl[j] = (int8_t)(h & 0x7f);
+        slots[j] = old[i];
+        break;
+      }
+    }
+  }
+  VT_FREE(old);
+  VT_FREE(old_raw);
+}
+
+static vt_entry* vt__sw_find(const vt_table* t, const void* key, size_t klen,
+                             uint64_t h, size_t* out_idx) {
+  size_t gmask = t->cap / VT__SW_GROUP - 1;
+  size_t g = (size_t)(h >> 7) & gmask;
+  int8_t h2 = (int8_t)(h & 0x7f);
+  for (size_t step = 0;; g = (g + ++step) & gmask) {
+    const int8_t* ctrl = t->ctrl + g * VT__SW_GROUP;
+    for (vt__swmask m = vt__sw_match(ctrl, h2); m; m &= m - 1) {
+      size_t i = g * VT__SW_GROUP + (vt__sw_ctz(m) >> VT__SW_BITS);
+      vt_entry* cur = &t->slots[i];
+      if (VT_LIKELY(cur->hash == h) &&
+          t->cfg.eq(cur->kptr, cur->klen, key, klen, t->cfg.udata)) {
+        if (out_idx) *out_idx = i;
+        return cur;
+      }
+    }
+    if (vt__sw_match(ctrl, VT__SW_EMPTY)) return NULL;
+  }
+}
+
+/* Première case libre (EMPTY ou DELETED) de la séquence de h */
+static size_t vt__sw_find_free(const vt_table* t, uint64_t h) {
+  size_t gmask = t->cap / VT__SW_GROUP - 1;
+  size_t g = (size_t)(h >> 7) & gmask;
+  for (size_t step = 0;; g = (g + ++step) & gmask) {
+    vt__swmask m = vt__sw_match_free(t->ctrl + g * VT__SW_GROUP);
+    if (m) return g * VT__SW_GROUP + (vt__sw_ctz(m) >> VT__SW_BITS);
+  }
+}
+
+static vt_entry* vt__sw_insert(vt_table* t, const void* key, size_t klen,
+                               void* val, uint64_t h, bool* replaced,
+                               void** old_val) {
+  vt_entry* cur = vt__sw_find(t, key, klen, h, NULL);
+  if (cur) {
+    void* prev = cur->vptr;
+    cur->vptr = val;
+    if (replaced) *replaced = true;
+    if (old_val) *old_val = prev;
+    return cur;
+  }
+  size_t i = vt__sw_find_free(t, h);
+  if (VT_UNLIKELY(t->growth_left == 0 && t->ctrl[i] == VT__SW_EMPTY)) {
+    /* plein: doubler, ou seulement purger les tombstones si la table est
+       à moins de moitié de sa charge max */
+    size_t nc = t->len + 1 > vt__sw_growth(t, t->cap) / 2 ? t->cap * 2 : t->cap;
+    vt__sw_resize(t, nc);
+    i = vt__sw_find_free(t, h);
+  }
+  if (t->ctrl[i] == VT__SW_EMPTY) t->growth_left--;
+  t->ctrl[i] = (int8_t)(h & 0x7f);
+  cur = &t->slots[i];
+  cur->hash = h;
+  cur->dib = 0;
+  cur->klen = klen;
+  cur->vptr = val;
+  if (t->copy_keys) {
+    void* dup = VT_MALLOC(klen);
+    assert(dup && "alloc key");
+    memcpy(dup, key, klen);
+    cur->kptr = dup;
+  } else {
+    cur->kptr = (void*)key; /* adoption */
+  }
+  t->len++;
+  if (replaced) *replaced = false;
+  if (old_val) *old_val = NULL;
+  return cur;
+}
+
+static void vt__sw_erase_at(vt_table* t, size_t idx) {
+  vt__free_key_val(t, &t->slots[idx]);
+  const int8_t* g = t->ctrl + (idx & ~(size_t)(VT__SW_GROUP - 1));
+  if (vt__sw_match(g, VT__SW_EMPTY)) {
+    t->ctrl[idx] = VT__SW_EMPTY;
+    t->growth_left++;
+  } else {
+    t->ctrl[idx] = VT__SW_DELETED;
+  }
+  memset(&t->slots[idx], 0, sizeof(vt_entry));
+  t->len--;
+}
+
+/* Hash utilisateur, 0 réservé aux cases vides */
+static inline uint64_t vt__hash(const vt_table* t, const void* key,
+                                size_t klen) {
+  uint64_t h = VT_LIKELY(t->default_hash) ? vt_hash64(key, klen, t->seed)
+                                          : t->cfg.hash(key, klen, t->cfg.udata);
+  return h ? h : 1;
+}
+
+static inline vt_entry* vt__lookup(const vt_table* t, const void* key,
+                                   size_t klen, uint64_t h, size_t* out_idx) {
+  return t->swiss ? vt__sw_find(t, key, klen, h, out_idx)
+                  : vt__find(t, key, klen, h, out_idx);
+}
+
 /* ----------------------------------------------------------------------------
    API
 ---------------------------------------------------------------------------- */
@@ -280,12 +494,18 @@ int vt_table_init(vt_table* t, const vt_table_config* cfg) {
   if (!t) return -1;
   memset(t, 0, sizeof(*t));
 
-  t->cfg.hash = cfg && cfg->hash ? cfg->hash : vt__fnv1a64;
+  t->default_hash = !(cfg && cfg->hash);
+  t->seed = t->default_hash ? vt_hash_seed() : 0;
+  t->cfg.hash = t->default_hash ? NULL : cfg->hash;
   t->cfg.eq = cfg && cfg->eq ? cfg->eq : vt__bytes_eq;
   t->cfg.free_key = cfg ? cfg->free_key : NULL;
   t->cfg.free_val = cfg ? cfg->free_val : NULL;
   t->cfg.udata = cfg ? cfg->udata : NULL;
-  t->cfg.max_load = cfg && cfg->max_load > 0.f ? cfg->max_load : 0.85f;
+  t->swiss = cfg && cfg->backend == VT_TABLE_SWISS;
+  t->cfg.backend = t->swiss ? VT_TABLE_SWISS : VT_TABLE_ROBIN_HOOD;
+  t->cfg.max_load = cfg && cfg->max_load > 0.f ? cfg->max_load
+                    : t->swiss                 ? 0.875f
+                                               : 0.85f;
   t->cfg.initial_cap = cfg && cfg->initial_cap ? cfg->initial_cap : 16;
   t->cfg.free_key_always = cfg ? cfg->free_key_always : 0;
 
@@ -296,7 +516,12 @@ int vt_table_init(vt_table* t, const vt_table_config* cfg) {
   t->len = 0;
   t->grow_at = 0;
 
-  vt__set_capacity(t, vt__next_pow2(t->cfg.initial_cap));
+  if (t->swiss) {
+    size_t c = vt__next_pow2(t->cfg.initial_cap);
+    vt__sw_resize(t, c < VT__SW_GROUP ? VT__SW_GROUP : c);
+  } else {
+    vt__set_capacity(t, vt__next_pow2(t->cfg.initial_cap));
+  }
   return 0;
 }
 
@@ -306,8 +531,27 @@ void vt_table_free(vt_table* t) {
     vt__free_key_val(t, &t->slots[i]);
   }
   VT_FREE(t->slots);
+  VT_FREE(t->ctrl_raw);
   t->slots = NULL;
-  t->cap = t->len = t->grow_at = 0;
+  t->ctrl = NULL;
+  t->ctrl_raw = NULL;
+  t->cap = t->len = t->grow_at = t->growth_left = 0;
+}
+
+vt_table* vt_table_new(const vt_table_config* cfg) {
+  vt_table* t = (vt_table*)VT_MALLOC(sizeof *t);
+  if (!t) return NULL;
+  if (vt_table_init(t, cfg) != 0) {
+    VT_FREE(t);
+    return NULL;
+  }
+  return t;
+}
+
+void vt_table_delete(vt_table* t) {
+  if (!t) return;
+  vt_table_free(t);
+  VT_FREE(t);
 }
 
 void vt_table_clear(vt_table* t) {
@@ -321,6 +565,10 @@ void vt_table_clear(vt_table* t) {
     t->slots[i].vptr = NULL;
   }
   t->len = 0;
+  if (t->swiss) {
+    memset(t->ctrl, (unsigned char)VT__SW_EMPTY, t->cap);
+    t->growth_left = vt__sw_growth(t, t->cap);
+  }
 }
 
 size_t vt_table_len(const vt_table* t) { return t ? t->len : 0; }
@@ -328,10 +576,13 @@ size_t vt_table_len(const vt_table* t) { return t ? t->len : 0; }
 bool vt_table_put(vt_table* t, const void* key, size_t klen, void* val,
                   void** old_val_out) {
   if (!t || !key) return false;
-  uint64_t h = t->cfg.hash(key, klen, t->cfg.udata);
+  uint64_t h = vt__hash(t, key, klen);
   bool replaced = false;
   void* oldv = NULL;
-  vt__insert(t, key, klen, val, h, &replaced, &oldv);
+  if (t->swiss)
+    vt__sw_insert(t, key, klen, val, h, &replaced, &oldv);
+  else
+    vt__insert(t, key, klen, val, h, &replaced, &oldv);
   if (old_val_out)
     *old_val_out = oldv;
   else if (replaced && t->cfg.free_val)
@@ -342,8 +593,8 @@ bool vt_table_put(vt_table* t, const void* key, size_t klen, void* val,
 bool vt_table_get(const vt_table* t, const void* key, size_t klen,
                   void** val_out) {
   if (!t || !key) return false;
-  uint64_t h = t->cfg.hash(key, klen, t->cfg.udata);
-  vt_entry* e = vt__find(t, key, klen, h, NULL);
+  uint64_t h = vt__hash(t, key, klen);
+  vt_entry* e = vt__lookup(t, key, klen, h, NULL);
   if (!e) return false;
   if (val_out) *val_out = e->vptr;
   return true;
@@ -353,43 +604,32 @@ bool vt_table_del(vt_table* t, const void* key, size_t klen,
                   void** old_val_out) {
   if (!t || !key) return false;
   size_t idx = 0;
-  uint64_t h = t->cfg.hash(key, klen, t->cfg.udata);
-  vt_entry* e = vt__find(t, key, klen, h, &idx);
+  uint64_t h = vt__hash(t, key, klen);
+  vt_entry* e = vt__lookup(t, key, klen, h, &idx);
   if (!e) return false;
 
   /* si on veut renvoyer la valeur, la sauver avant free_val */
   void* saved_val = e->vptr;
-  void* saved_key = e->kptr;
-  size_t saved_klen = e->klen;
 
   /* neutraliser free_val si l’appelant veut récupérer old_val_out */
   if (old_val_out && t->cfg.free_val) {
     /* on va contourner vt__free_key_val pour la valeur */
     e->vptr = NULL;
   }
-  vt__erase_at(t, idx);
+  if (t->swiss)
+    vt__sw_erase_at(t, idx);
+  else
+    vt__erase_at(t, idx);
 
-  if (old_val_out)
-    *old_val_out = saved_val;
-  else if (t->cfg.free_val)
-    t->cfg.free_val(saved_val, t->cfg.udata);
-
-  /* si la clé était copiée et que free_key n’est pas défini, la libérer
-   * nous-mêmes */
-  if (t->copy_keys && !t->cfg.free_key) {
-    VT_FREE(saved_key);
-  } else if (t->copy_keys && t->cfg.free_key && t->cfg.free_key_always == 0) {
-    /* déjà libérée par vt__free_key_val */
-    (void)saved_key;
-    (void)saved_klen;
-  }
+  /* sinon valeur et clé copiée: libérées par vt__free_key_val */
+  if (old_val_out) *old_val_out = saved_val;
   return true;
 }
 
 bool vt_table_has(const vt_table* t, const void* key, size_t klen) {
   if (!t || !key) return false;
-  uint64_t h = t->cfg.hash(key, klen, t->cfg.udata);
-  return vt__find(t, key, klen, h, NULL) != NULL;
+  uint64_t h = vt__hash(t, key, klen);
+  return vt__lookup(t, key, klen, h, NULL) != NULL;
 }
 
 void* vt_table_getptr(const vt_table* t, const void* key, size_t klen) {
@@ -402,8 +642,8 @@ void* vt_table_getptr(const vt_table* t, const void* key, size_t klen) {
 bool vt_table_replace(vt_table* t, const void* key, size_t klen, void* val,
                       void** old_val_out) {
   if (!t || !key) return false;
-  uint64_t h = t->cfg.hash(key, klen, t->cfg.udata);
-  vt_entry* e = vt__find(t, key, klen, h, NULL);
+  uint64_t h = vt__hash(t, key, klen);
+  vt_entry* e = vt__lookup(t, key, klen, h, NULL);
   if (!e) return false;
   void* prev = e->vptr;
   e->vptr = val;
@@ -422,7 +662,11 @@ void vt_table_reserve(vt_table* t, size_t n) {
                (double)(t->cfg.max_load <= 0.f ? 0.85f : t->cfg.max_load)) +
       1;
   need = vt__next_pow2(need < 16 ? 16 : need);
-  if (need > t->cap) vt__set_capacity(t, need);
+  if (need <= t->cap) return;
+  if (t->swiss)
+    vt__sw_resize(t, need);
+  else
+    vt__set_capacity(t, need);
 }
 
 /* Changement de stratégie de clés: copy/adopt. Non thread-safe. */
@@ -460,11 +704,11 @@ bool vt_table_next(vt_table* t, vt_table_iter* it, const void** kptr,
    Utilitaires standards de hachage (exposés par table.h)
 ---------------------------------------------------------------------------- */
 uint64_t vt_hash_bytes(const void* p, size_t n) {
-  return vt__fnv1a64(p, n, NULL);
+  return vt_hash64(p, n, 0);
 }
 
 uint64_t vt_hash_cstr(const char* z) {
-  return vt__fnv1a64(z, z ? strlen(z) : 0, NULL);
+  return vt_hash64(z, z ? strlen(z) : 0, 0);
 }
 
 int vt_keyeq_bytes(const void* a, size_t alen, const void* b, size_t blen) {
@@ -480,6 +724,22 @@ void vt_table__self_check(const vt_table* t) {
   assert(t);
   assert(vt__is_power_of_two(t->cap));
   size_t seen = 0;
+  if (t->swiss) {
+    size_t empty = 0;
+    for (size_t i = 0; i < t->cap; i++) {
+      const vt_entry* e = &t->slots[i];
+      if (t->ctrl[i] < 0) {
+        assert(e->hash == 0);
+        empty += t->ctrl[i] == VT__SW_EMPTY;
+        continue;
+      }
+      assert(e->hash != 0 && t->ctrl[i] == (int8_t)(e->hash & 0x7f));
+      seen++;
+    }
+    assert(seen == t->len);
+    assert(empty >= t->growth_left + 1);
+    return;
+  }
   for (size_t i = 0; i < t->cap; i++) {
     const vt_entry* e = &t->slots[i];
     if (e->hash == 0) {
@@ -494,3 +754,205 @@ void vt_table__self_check(const vt_table* t) {
   assert(seen == t->len);
 }
 #endif
+
+/* ----------------------------------------------------------------------------
+   Bench (-DVT_TABLE_BENCH): robin-hood vs swiss, clés 8 octets adoptées,
+   table pré-dimensionnée (1 Mi cases) remplie à divers taux; puis les deux
+   moteurs contre la map robin-hood de hashmap.c, tables vides au départ.
+   cc -std=c17 -O2 -DVT_TABLE_BENCH table.c hashmap.c hash.c
+---------------------------------------------------------------------------- */
+#ifdef VT_TABLE_BENCH
+#include <stdio.h>
+#include <time.h>
+/* hashmap.h déclare aussi un vt_hash_fn (sans taille): renommé ici */
+#define vt_hash_fn vt_hashmap_hash_fn
+#include "hashmap.h"
+#undef vt_hash_fn
+
+static double vt__tb_now(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t vt__tb_rng(uint64_t* x) {
+  *x ^= *x << 13; *x ^= *x >> 7; *x ^= *x << 17;
+  return *x;
+}
+
+/* Suite aléatoire put/del/get comparée entre les deux moteurs */
+static int vt__tb_check(void) {
+  vt_table_config ca = {0}, cb = {0};
+  ca.copy_keys = cb.copy_keys = 1;
+  cb.backend = VT_TABLE_SWISS;
+  vt_table a, b;
+  vt_table_init(&a, &ca);
+  vt_table_init(&b, &cb);
+  uint64_t x = 88172645463325252ull;
+  int rc = 0;
+  for (int i = 0; i < 2000000; i++) {
+    uint64_t r = vt__tb_rng(&x);
+    uint64_t k = (r >> 8) % 50000;
+    void* va = NULL; void* vb = NULL;
+    bool ra, rb;
+    switch (r & 3) {
+      case 0: case 1:
+        ra = vt_table_put(&a, &k, sizeof k, (void*)(uintptr_t)r, &va);
+        rb = vt_table_put(&b, &k, sizeof k, (void*)(uintptr_t)r, &vb);
+        break;
+      case 2:
+        ra = vt_table_del(&a, &k, sizeof k, &va);
+        rb = vt_table_del(&b, &k, sizeof k, &vb);
+        break;
+      default:
+        ra = vt_table_get(&a, &k, sizeof k, &va);
+        rb = vt_table_get(&b, &k, sizeof k, &vb);
+        break;
+    }
+    if (ra != rb || va != vb || vt_table_len(&a) != vt_table_len(&b)) {
+      fprintf(stderr, "table: divergence à l’op %d\n", i);
+      rc = 1;
+      goto out;
+    }
+  }
+#ifndef NDEBUG
+  vt_table__self_check(&a);
+  vt_table__self_check(&b);
+#endif
+  size_t n = 0;
+  vt_table_iter it; vt_table_iter_init(&it);
+  const void* kp; size_t kl; void* v;
+  while (vt_table_next(&b, &it, &kp, &kl, &v)) {
+    void* w = NULL;
+    if (!vt_table_get(&a, kp, kl, &w) || w != v) break;
+    n++;
+  }
+  rc = n == vt_table_len(&a) ? 0 : 1;
+out:
+  vt_table_free(&a);
+  vt_table_free(&b);
+  return rc;
+}
+
+static void vt__tb_run(int backend, double load, const uint64_t* keys,
+                       const uint64_t* miss, const uint32_t* order) {
+  const size_t cap = (size_t)1 << 20;
+  size_t n = (size_t)((double)cap * load);
+  vt_table_config c = {0};
+  c.backend = backend;
+  c.max_load = 0.9f;
+  c.initial_cap = cap;
+  vt_table t;
+  vt_table_init(&t, &c);
+  double t0 = vt__tb_now();
+  for (size_t i = 0; i < n; i++) vt_table_put(&t, &keys[i], 8, (void*)(uintptr_t)(i + 1), NULL);
+  double t1 = vt__tb_now();
+  uintptr_t sum = 0;
+  for (size_t i = 0; i < n; i++) sum += (uintptr_t)vt_table_getptr(&t, &keys[order[i] % n], 8);
+  double t2 = vt__tb_now();
+  for (size_t i = 0; i < n; i++) sum += (uintptr_t)vt_table_getptr(&t, &miss[i], 8);
+  double t3 = vt__tb_now();
+  for (size_t i = 0; i < n; i++) vt_table_del(&t, &keys[order[i] % n], 8, NULL);
+  double t4 = vt__tb_now();
+  double k = 1e9 / (double)n;
+  printf("  %-10s %5.1f%%  insert %6.1f  hit %6.1f  miss %6.1f  del %6.1f ns/op%s\n",
+         backend == VT_TABLE_SWISS ? "swiss" : "robin-hood", load * 100, (t1 - t0) * k,
+         (t2 - t1) * k, (t3 - t2) * k, (t4 - t3) * k, sum ? "" : " ?");
+  vt_table_free(&t);
+}
+
+/* Contre hashmap.c: pas de réserve possible côté hashmap, donc les trois
+   partent vides et croissent au même seuil (0.85); l’insertion compte la
+   croissance et toutes finissent à 1 Mi cases. */
+static uint64_t vt__tb_hm_hash(const void* k, void* udata) {
+  return vt_hash64(k, 8, (uint64_t)(uintptr_t)udata);
+}
+static int vt__tb_hm_eq(const void* a, const void* b, void* udata) {
+  (void)udata;
+  return *(const uint64_t*)a == *(const uint64_t*)b;
+}
+
+static void vt__tb_grow(int engine, double load, const uint64_t* keys,
+                        const uint64_t* miss, const uint32_t* order) {
+  const size_t n = (size_t)((double)((size_t)1 << 20) * load);
+  vt_hashmap* m = NULL;
+  vt_table t;
+  if (engine < 0) {
+    m = vt_hashmap_new(vt__tb_hm_hash, vt__tb_hm_eq, NULL,
+                       (void*)(uintptr_t)vt_hash_seed());
+    if (!m) return;
+  } else {
+    vt_table_config c = {0};
+    c.backend = engine;
+    c.max_load = 0.85f;
+    vt_table_init(&t, &c);
+  }
+  uintptr_t sum = 0;
+  void* v;
+  double t0 = vt__tb_now();
+  for (size_t i = 0; i < n; i++) {
+    if (m) vt_hashmap_put(m, (void*)&keys[i], (void*)(uintptr_t)(i + 1));
+    else vt_table_put(&t, &keys[i], 8, (void*)(uintptr_t)(i + 1), NULL);
+  }
+  double t1 = vt__tb_now();
+  for (size_t i = 0; i < n; i++) {
+    const uint64_t* k = &keys[order[i] % n];
+    if (m) sum += vt_hashmap_get(m, k, &v) ? (uintptr_t)v : 0;
+    else sum += (uintptr_t)vt_table_getptr(&t, k, 8);
+  }
+  double t2 = vt__tb_now();
+  for (size_t i = 0; i < n; i++) {
+    if (m) sum += vt_hashmap_get(m, &miss[i], &v) ? (uintptr_t)v : 0;
+    else sum += (uintptr_t)vt_table_getptr(&t, &miss[i], 8);
+  }
+  double t3 = vt__tb_now();
+  for (size_t i = 0; i < n; i++) {
+    const uint64_t* k = &keys[order[i] % n];
+    if (m) vt_hashmap_del(m, k);
+    else vt_table_del(&t, k, 8, NULL);
+  }
+  double t4 = vt__tb_now();
+  double k = 1e9 / (double)n;
+  printf("  %-10s %5.1f%%  insert %6.1f  hit %6.1f  miss %6.1f  del %6.1f ns/op%s\n",
+         engine < 0 ? "hashmap.c" : engine == VT_TABLE_SWISS ? "swiss" : "robin-hood",
+         load * 100, (t1 - t0) * k, (t2 - t1) * k, (t3 - t2) * k, (t4 - t3) * k,
+         sum ? "" : " ?");
+  if (m) vt_hashmap_free(m);
+  else vt_table_free(&t);
+}
+
+int main(void) {
+  if (vt__tb_check() != 0) return 1;
+  const size_t cap = (size_t)1 << 20;
+  uint64_t* keys = (uint64_t*)malloc(cap * sizeof *keys);
+  uint64_t* miss = (uint64_t*)malloc(cap * sizeof *miss);
+  uint32_t* order = (uint32_t*)malloc(cap * sizeof *order);
+  if (!keys || !miss || !order) return 1;
+  uint64_t x = 0x9e3779b97f4a7c15ull;
+  for (size_t i = 0; i < cap; i++) {
+    keys[i] = vt__tb_rng(&x) | 1;    /* impaires: présentes */
+    miss[i] = vt__tb_rng(&x) & ~1ull; /* paires: absentes */
+  }
+  for (size_t i = 0; i < cap; i++) order[i] = (uint32_t)i;
+  for (size_t i = cap - 1; i > 0; i--) {
+    size_t j = (size_t)(vt__tb_rng(&x) % (i + 1));
+    uint32_t tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+  }
+  static const double loads[] = {0.25, 0.5, 0.75, 0.875};
+  printf("vt_table, 1 Mi cases, clés u64:\n");
+  for (size_t l = 0; l < sizeof loads / sizeof loads[0]; l++) {
+    vt__tb_run(VT_TABLE_ROBIN_HOOD, loads[l], keys, miss, order);
+    vt__tb_run(VT_TABLE_SWISS, loads[l], keys, miss, order);
+  }
+  /* sous 0.425, hashmap.c s’arrête à 512 Ki cases */
+  static const double grown[] = {0.5, 0.65, 0.75, 0.85};
+  printf("contre hashmap.c, tables vides au départ (finales 1 Mi cases):\n");
+  for (size_t l = 0; l < sizeof grown / sizeof grown[0]; l++)
+    for (int e = -1; e <= VT_TABLE_SWISS; e++)
+      vt__tb_grow(e, grown[l], keys, miss, order);
+  free(keys);
+  free(miss);
+  free(order);
+  return 0;
+}
+#endif /* VT_TABLE_BENCH */
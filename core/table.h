@@ -1,5 +1,7 @@
 /* ============================================================================
    table.h — Hash table générique (C17), robin-hood open addressing.
+   - Moteur alternatif « swiss » (groupes de 16 cases, octets de contrôle
+     comparés en SSE2/NEON, séparés des clés/valeurs), choisi à l’init.
    - Clés = octets arbitraires (ptr + taille). Valeurs = void*.
    - Callbacks configurables: hash, égalité, free(key), free(val).
    - Copy-on-insert optionnel des clés (copy_keys=1) ou adoption.
@@ -37,6 +39,13 @@ typedef struct vt_table_iter {
   size_t idx; /* interne */
 } vt_table_iter;
 
+/* Moteurs (vt_table_config.backend) */
+typedef enum vt_table_backend {
+  VT_TABLE_ROBIN_HOOD = 0, /* défaut: backward-shift, sans tombstones */
+  VT_TABLE_SWISS = 1       /* groupes de 16, 7 bits de hash par case,
+                              tombstones purgées au rehash */
+} vt_table_backend;
+
 /* Callbacks utilisateur */
 typedef uint64_t (*vt_hash_fn)(const void* key, size_t klen, void* udata);
 /* doit retourner !=0 seulement si a==b, 0 sinon */
@@ -46,7 +55,7 @@ typedef void (*vt_free_fn)(void* p, void* udata);
 
 /* Configuration de la table */
 typedef struct vt_table_config {
-  vt_hash_fn hash;     /* défaut: FNV-1a 64 + avalanche */
+  vt_hash_fn hash;     /* défaut: vt_hash64, graine vt_hash_seed() */
   vt_keyeq_fn eq;      /* défaut: memcmp + taille */
   vt_free_fn free_key; /* appelé sur clé lors de destroy/erase si pertinent */
   vt_free_fn
@@ -60,6 +69,8 @@ typedef struct vt_table_config {
                           pointeur */
   int free_key_always; /* 1: toujours free_key(k) à la suppression même si
                           copy_keys=0 */
+  int backend;         /* vt_table_backend (0: robin-hood). max_load 0 →
+                          0.875f pour VT_TABLE_SWISS */
 } vt_table_config;
 
 /* ----------------------------------------------------------------------------
@@ -67,6 +78,10 @@ typedef struct vt_table_config {
 ---------------------------------------------------------------------------- */
 VT_TABLE_API int vt_table_init(vt_table* t, const vt_table_config* cfg);
 VT_TABLE_API void vt_table_free(vt_table* t);
+/* Variante sur le tas, pour les appelants hors de table.c (vt_table est
+   opaque). NULL si OOM. */
+VT_TABLE_API vt_table* vt_table_new(const vt_table_config* cfg);
+VT_TABLE_API void vt_table_delete(vt_table* t);
 VT_TABLE_API void vt_table_clear(vt_table* t);
 VT_TABLE_API void vt_table_reserve(vt_table* t, size_t n);
 VT_TABLE_API size_t vt_table_len(const vt_table* t);
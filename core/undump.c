@@ -9,12 +9,15 @@
    ============================================================================
  */
 #include <errno.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "hash.h" /* vt_crc32 */
+
 /* ----------------------------------------------------------------------------
    Définition interne de l’image.
    Une .h publique peut redéclarer ce type si besoin.
@@ -45,6 +48,10 @@ typedef struct vt_img {
   uint64_t image_size;  /* taille totale attendue */
   uint32_t crc32_file;  /* CRC stocké */
   uint32_t toc_count;
+
+  /* Cache dérivé (vt_img_cache_*) */
+  _Atomic(void*) cache;
+  void (*cache_free)(void*);
 } vt_img;
 
 /* ----------------------------------------------------------------------------
@@ -74,31 +81,6 @@ static uint64_t vt__rd_u64_le(const uint8_t* p) {
   return (uint64_t)vt__rd_u32_le(p) | ((uint64_t)vt__rd_u32_le(p + 4) << 32);
 }
 
-/* ----------------------------------------------------------------------------
-   CRC-32 (poly 0xEDB88320), table générée au premier appel
----------------------------------------------------------------------------- */
-static uint32_t vt__crc_table[256];
-static int vt__crc_ready = 0;
-
-static void vt__crc_init(void) {
-  if (vt__crc_ready) return;
-  for (uint32_t i = 0; i < 256; i++) {
-    uint32_t c = i;
-    for (int k = 0; k < 8; k++)
-      c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
-    vt__crc_table[i] = c;
-  }
-  vt__crc_ready = 1;
-}
-static uint32_t vt__crc32(const void* data, size_t len) {
-  vt__crc_init();
-  const uint8_t* p = (const uint8_t*)data;
-  uint32_t c = ~0u;
-  for (size_t i = 0; i < len; i++)
-    c = vt__crc_table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
-  return ~c;
-}
-
 /* ----------------------------------------------------------------------------
    Format binaire "VTBC" (little-endian)
    Layout:
@@ -208,7 +190,7 @@ static int vt__parse(vt_img* img) {
   /* CRC du payload (après header) */
   const uint8_t* payload = img->buf + img->header_size;
   size_t payload_sz = img->size - img->header_size;
-  uint32_t crc_calc = vt__crc32(payload, payload_sz);
+  uint32_t crc_calc = vt_crc32(payload, payload_sz, 0);
   if (crc_calc != img->crc32_file) return -EBADMSG;
 
   /* TOC: placé immédiatement après le FileHeader, jusqu’à header_size */
@@ -281,6 +263,7 @@ int vt_img_load_memory(const void* data, size_t size, int copy,
   if (!data || !size || !out_img) return -EINVAL;
   vt_img* img = (vt_img*)calloc(1, sizeof *img);
   if (!img) return -ENOMEM;
+  atomic_init(&img->cache, NULL);
 
   if (copy) {
     img->buf = (uint8_t*)malloc(size);
@@ -329,10 +312,26 @@ int vt_img_load_file(const char* path, vt_img** out_img) {
 
 void vt_img_release(vt_img* img) {
   if (!img) return;
+  void* cache = atomic_load(&img->cache);
+  if (cache && img->cache_free) img->cache_free(cache);
   if (img->owns && img->buf) free(img->buf);
   free(img);
 }
 
+void* vt_img_cache_get(const vt_img* img) {
+  if (!img) return NULL;
+  return atomic_load(&((vt_img*)(uintptr_t)img)->cache);
+}
+
+int vt_img_cache_set(vt_img* img, void* data, void (*free_fn)(void*)) {
+  if (!img || !data) return -EINVAL;
+  void* expected = NULL;
+  if (!atomic_compare_exchange_strong(&img->cache, &expected, data))
+    return -EEXIST;
+  img->cache_free = free_fn;
+  return 0;
+}
+
 /* Cherche une section par tag 4-char. Renvoie 0 si trouvée. */
 int vt_img_find(const vt_img* img, const char tag4[4], const uint8_t** out_ptr,
                 size_t* out_sz) {
@@ -54,6 +54,16 @@ VT_UNDUMP_API int vt_img_find(const vt_img* img, const char tag4[4],
 
 VT_UNDUMP_API void vt_img_info(const vt_img* img, FILE* out /* NULL=stderr */);
 
+/* ----------------------------------------------------------------------------
+   Cache dérivé attaché à l’image (ex: flux d’instructions pré-décodé par la
+   VM). Un seul cache par image, libéré par vt_img_release via free_fn.
+   vt_img_cache_set: 0 si installé, -EEXIST si un autre thread l’a devancé
+   (l’appelant garde alors la propriété de data).
+---------------------------------------------------------------------------- */
+VT_UNDUMP_API void* vt_img_cache_get(const vt_img* img);
+VT_UNDUMP_API int vt_img_cache_set(vt_img* img, void* data,
+                                   void (*free_fn)(void*));
+
 /* ----------------------------------------------------------------------------
    STRS iterator (concat de chaînes NUL-terminées)
 ---------------------------------------------------------------------------- */
@@ -1,12 +1,28 @@
 // SPDX-License-Identifier: MIT
 /* ============================================================================
    core/utf8.c — Primitives UTF-8 pour VitteLight
+   - Validation stricte vectorisée (tables de Keiser & Lemire, « Validating
+     UTF-8 In Less Than One Instruction Per Byte »): SSE4.1 / AVX2 / NEON
+     choisi à l’exécution, blocs ASCII sautés, repli scalaire.
+   - Comptage de code points, transcodage UTF-8 ⇄ UTF-16.
    ============================================================================
 */
 
 #include "utf8.h"
+#include <errno.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define UTF8__X86 1
+#endif
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define UTF8__NEON 1
+#endif
 
 /* Types courts si non inclus via api.h */
 #ifndef U32_DEFINED
@@ -65,13 +81,522 @@ u32 utf8_decode_1(const char* s, size_t n, size_t* adv) {
   return 0xFFFD;
 }
 
-int utf8_validate(const char* s, size_t n) {
-  size_t i = 0, adv = 0;
+/* -------------------------------------------------------------------------- */
+/* Validation                                                                  */
+/* -------------------------------------------------------------------------- */
+/* Scalaire: 8 octets ASCII d’un coup, sinon bornes de la RFC 3629 (pas de
+   surlongs, de surrogates ni de code point > U+10FFFF). */
+static int utf8__valid_scalar(const unsigned char* s, size_t n) {
+  size_t i = 0;
   while (i < n) {
-    u32 cp = utf8_decode_1(s + i, n - i, &adv);
-    if (adv == 0) return 0;
-    (void)cp; /* on ignore juste la valeur */
-    i += adv;
+    if (i + 8 <= n) {
+      uint64_t w;
+      memcpy(&w, s + i, 8);
+      if (!(w & 0x8080808080808080ull)) { i += 8; continue; }
+    }
+    unsigned char c = s[i++];
+    if (c < 0x80) continue;
+    int extra = (c >= 0xC2 && c <= 0xDF) ? 1 : (c >= 0xE0 && c <= 0xEF) ? 2
+              : (c >= 0xF0 && c <= 0xF4) ? 3 : -1;
+    if (extra < 0 || i + (size_t)extra > n) return 0;
+    unsigned char lo = 0x80, hi = 0xBF;
+    if (c == 0xE0) lo = 0xA0;
+    else if (c == 0xED) hi = 0x9F;
+    else if (c == 0xF0) lo = 0x90;
+    else if (c == 0xF4) hi = 0x8F;
+    if (s[i] < lo || s[i] > hi) return 0;
+    for (int k = 1; k < extra; k++)
+      if ((s[i + (size_t)k] & 0xC0) != 0x80) return 0;
+    i += (size_t)extra;
   }
   return 1;
 }
+
+/* Tables: octet précédent (quartet haut, bas) et octet courant (quartet
+   haut); une erreur = un bit commun aux trois. TWO_CONTS (bit 7) est en
+   plus croisé avec « doit être la 3e/4e d’une séquence ». */
+#define U8_TOO_SHORT (1 << 0)
+#define U8_TOO_LONG (1 << 1)
+#define U8_OVERLONG_3 (1 << 2)
+#define U8_TOO_LARGE (1 << 3)
+#define U8_SURROGATE (1 << 4)
+#define U8_OVERLONG_2 (1 << 5)
+#define U8_TOO_LARGE_1000 (1 << 6)
+#define U8_OVERLONG_4 (1 << 6)
+#define U8_TWO_CONTS (1 << 7)
+#define U8_CARRY (U8_TOO_SHORT | U8_TOO_LONG | U8_TWO_CONTS)
+#define U8_TL (U8_TOO_LARGE | U8_TOO_LARGE_1000)
+
+static const unsigned char utf8__t1h[16] = {
+  U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+  U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+  U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS,
+  U8_TOO_SHORT | U8_OVERLONG_2,
+  U8_TOO_SHORT,
+  U8_TOO_SHORT | U8_OVERLONG_3 | U8_SURROGATE,
+  U8_TOO_SHORT | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_OVERLONG_4};
+static const unsigned char utf8__t1l[16] = {
+  U8_CARRY | U8_OVERLONG_3 | U8_OVERLONG_2 | U8_OVERLONG_4,
+  U8_CARRY | U8_OVERLONG_2,
+  U8_CARRY, U8_CARRY,
+  U8_CARRY | U8_TOO_LARGE,
+  U8_CARRY | U8_TL, U8_CARRY | U8_TL, U8_CARRY | U8_TL,
+  U8_CARRY | U8_TL, U8_CARRY | U8_TL, U8_CARRY | U8_TL, U8_CARRY | U8_TL, U8_CARRY | U8_TL,
+  U8_CARRY | U8_TL | U8_SURROGATE,
+  U8_CARRY | U8_TL, U8_CARRY | U8_TL};
+static const unsigned char utf8__t2h[16] = {
+  U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+  U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+  U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 | U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+  U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 | U8_TOO_LARGE,
+  U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE | U8_TOO_LARGE,
+  U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE | U8_TOO_LARGE,
+  U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT};
+/* Derniers octets d’un bloc au-delà desquels une séquence reste ouverte */
+static const unsigned char utf8__maxv[32] = {
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xEF, 0xDF, 0xBF};
+
+#if defined(UTF8__X86)
+__attribute__((target("sse4.1")))
+static int utf8__valid_sse4(const unsigned char* s, size_t n) {
+  const __m128i t1h = _mm_loadu_si128((const __m128i*)utf8__t1h);
+  const __m128i t1l = _mm_loadu_si128((const __m128i*)utf8__t1l);
+  const __m128i t2h = _mm_loadu_si128((const __m128i*)utf8__t2h);
+  const __m128i maxv = _mm_loadu_si128((const __m128i*)(utf8__maxv + 16));
+  const __m128i m0f = _mm_set1_epi8(0x0F), m80 = _mm_set1_epi8((char)0x80);
+  const __m128i k3 = _mm_set1_epi8((char)(0xE0 - 0x80)), k4 = _mm_set1_epi8((char)(0xF0 - 0x80));
+  __m128i err = _mm_setzero_si128(), prev = err, inc = err;
+  unsigned char tail[16];
+  for (size_t i = 0; i < n; i += 16) {
+    const unsigned char* q = s + i;
+    if (n - i < 16) {
+      memset(tail, 0, sizeof tail);
+      memcpy(tail, q, n - i);
+      q = tail;
+    }
+    __m128i in = _mm_loadu_si128((const __m128i*)q);
+    if (!_mm_movemask_epi8(in)) {
+      err = _mm_or_si128(err, inc);
+      inc = _mm_setzero_si128();
+    } else {
+      __m128i p1 = _mm_alignr_epi8(in, prev, 15);
+      __m128i sc = _mm_and_si128(
+          _mm_and_si128(_mm_shuffle_epi8(t1h, _mm_and_si128(_mm_srli_epi16(p1, 4), m0f)),
+                        _mm_shuffle_epi8(t1l, _mm_and_si128(p1, m0f))),
+          _mm_shuffle_epi8(t2h, _mm_and_si128(_mm_srli_epi16(in, 4), m0f)));
+      __m128i must = _mm_or_si128(_mm_subs_epu8(_mm_alignr_epi8(in, prev, 14), k3),
+                                  _mm_subs_epu8(_mm_alignr_epi8(in, prev, 13), k4));
+      err = _mm_or_si128(err, _mm_xor_si128(_mm_and_si128(must, m80), sc));
+      inc = _mm_subs_epu8(in, maxv);
+    }
+    prev = in;
+  }
+  err = _mm_or_si128(err, inc);
+  return _mm_testz_si128(err, err);
+}
+
+/* prev<k> sur 32 octets: les 16 octets hauts de prev suivis de in */
+#define UTF8__PREV(in, pp, k) _mm256_alignr_epi8(in, pp, 16 - (k))
+__attribute__((target("avx2")))
+static int utf8__valid_avx2(const unsigned char* s, size_t n) {
+  const __m256i t1h = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)utf8__t1h));
+  const __m256i t1l = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)utf8__t1l));
+  const __m256i t2h = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)utf8__t2h));
+  const __m256i maxv = _mm256_loadu_si256((const __m256i*)utf8__maxv);
+  const __m256i m0f = _mm256_set1_epi8(0x0F), m80 = _mm256_set1_epi8((char)0x80);
+  const __m256i k3 = _mm256_set1_epi8((char)(0xE0 - 0x80)), k4 = _mm256_set1_epi8((char)(0xF0 - 0x80));
+  __m256i err = _mm256_setzero_si256(), prev = err, inc = err;
+  unsigned char tail[32];
+  for (size_t i = 0; i < n; i += 32) {
+    const unsigned char* q = s + i;
+    if (n - i < 32) {
+      memset(tail, 0, sizeof tail);
+      memcpy(tail, q, n - i);
+      q = tail;
+    }
+    __m256i in = _mm256_loadu_si256((const __m256i*)q);
+    if (!_mm256_movemask_epi8(in)) {
+      err = _mm256_or_si256(err, inc);
+      inc = _mm256_setzero_si256();
+    } else {
+      __m256i pp = _mm256_permute2x128_si256(prev, in, 0x21);
+      __m256i p1 = UTF8__PREV(in, pp, 1);
+      __m256i sc = _mm256_and_si256(
+          _mm256_and_si256(_mm256_shuffle_epi8(t1h, _mm256_and_si256(_mm256_srli_epi16(p1, 4), m0f)),
+                           _mm256_shuffle_epi8(t1l, _mm256_and_si256(p1, m0f))),
+          _mm256_shuffle_epi8(t2h, _mm256_and_si256(_mm256_srli_epi16(in, 4), m0f)));
+      __m256i must = _mm256_or_si256(_mm256_subs_epu8(UTF8__PREV(in, pp, 2), k3),
+                                     _mm256_subs_epu8(UTF8__PREV(in, pp, 3), k4));
+      err = _mm256_or_si256(err, _mm256_xor_si256(_mm256_and_si256(must, m80), sc));
+      inc = _mm256_subs_epu8(in, maxv);
+    }
+    prev = in;
+  }
+  err = _mm256_or_si256(err, inc);
+  return _mm256_testz_si256(err, err);
+}
+#undef UTF8__PREV
+#endif
+
+#if defined(UTF8__NEON)
+static int utf8__valid_neon(const unsigned char* s, size_t n) {
+  const uint8x16_t t1h = vld1q_u8(utf8__t1h), t1l = vld1q_u8(utf8__t1l), t2h = vld1q_u8(utf8__t2h);
+  const uint8x16_t maxv = vld1q_u8(utf8__maxv + 16), m0f = vdupq_n_u8(0x0F), m80 = vdupq_n_u8(0x80);
+  const uint8x16_t k3 = vdupq_n_u8(0xE0 - 0x80), k4 = vdupq_n_u8(0xF0 - 0x80);
+  uint8x16_t err = vdupq_n_u8(0), prev = err, inc = err;
+  unsigned char tail[16];
+  for (size_t i = 0; i < n; i += 16) {
+    const unsigned char* q = s + i;
+    if (n - i < 16) {
+      memset(tail, 0, sizeof tail);
+      memcpy(tail, q, n - i);
+      q = tail;
+    }
+    uint8x16_t in = vld1q_u8(q);
+    if (vmaxvq_u8(in) < 0x80) {
+      err = vorrq_u8(err, inc);
+      inc = vdupq_n_u8(0);
+    } else {
+      uint8x16_t p1 = vextq_u8(prev, in, 15);
+      uint8x16_t sc = vandq_u8(vandq_u8(vqtbl1q_u8(t1h, vshrq_n_u8(p1, 4)), vqtbl1q_u8(t1l, vandq_u8(p1, m0f))),
+                               vqtbl1q_u8(t2h, vshrq_n_u8(in, 4)));
+      uint8x16_t must = vorrq_u8(vqsubq_u8(vextq_u8(prev, in, 14), k3), vqsubq_u8(vextq_u8(prev, in, 13), k4));
+      err = vorrq_u8(err, veorq_u8(vandq_u8(must, m80), sc));
+      inc = vqsubq_u8(in, maxv);
+    }
+    prev = in;
+  }
+  return vmaxvq_u8(vorrq_u8(err, inc)) == 0;
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* Comptage (octets hors continuation)                                        */
+/* -------------------------------------------------------------------------- */
+static size_t utf8__count_scalar(const unsigned char* s, size_t n) {
+  size_t c = 0;
+  for (size_t i = 0; i < n; i++) c += (s[i] & 0xC0) != 0x80;
+  return c;
+}
+
+#if defined(UTF8__X86)
+__attribute__((target("sse4.1,popcnt")))
+static size_t utf8__count_sse4(const unsigned char* s, size_t n) {
+  const __m128i lim = _mm_set1_epi8(-65); /* 0xBF signé: continuation ≤ -65 */
+  size_t c = 0, i = 0;
+  for (; i + 16 <= n; i += 16)
+    c += (size_t)__builtin_popcount((unsigned)_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)(s + i)), lim)));
+  return c + utf8__count_scalar(s + i, n - i);
+}
+__attribute__((target("avx2,popcnt")))
+static size_t utf8__count_avx2(const unsigned char* s, size_t n) {
+  const __m256i lim = _mm256_set1_epi8(-65);
+  size_t c = 0, i = 0;
+  for (; i + 32 <= n; i += 32)
+    c += (size_t)__builtin_popcount((unsigned)_mm256_movemask_epi8(
+        _mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i*)(s + i)), lim)));
+  return c + utf8__count_scalar(s + i, n - i);
+}
+#endif
+
+#if defined(UTF8__NEON)
+static size_t utf8__count_neon(const unsigned char* s, size_t n) {
+  const int8x16_t lim = vdupq_n_s8(-65);
+  size_t c = 0, i = 0;
+  while (i + 16 <= n) {
+    uint8x16_t acc = vdupq_n_u8(0);
+    /* ≤ 255 tours avant débordement des compteurs 8 bits */
+    for (int k = 0; k < 255 && i + 16 <= n; k++, i += 16)
+      acc = vsubq_u8(acc, vcgtq_s8(vreinterpretq_s8_u8(vld1q_u8(s + i)), lim));
+    c += vaddlvq_u8(acc);
+  }
+  return c + utf8__count_scalar(s + i, n - i);
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* Sélection                                                                  */
+/* -------------------------------------------------------------------------- */
+typedef struct {
+  int (*valid)(const unsigned char* s, size_t n);
+  size_t (*count)(const unsigned char* s, size_t n);
+  const char* name;
+} utf8__impl_t;
+static const utf8__impl_t utf8__impls[] = {
+  {NULL, NULL, "auto"},
+  {utf8__valid_scalar, utf8__count_scalar, "scalar"},
+#if defined(UTF8__X86)
+  {utf8__valid_sse4, utf8__count_sse4, "sse4"},
+  {utf8__valid_avx2, utf8__count_avx2, "avx2"},
+#else
+  {NULL, NULL, "sse4"},
+  {NULL, NULL, "avx2"},
+#endif
+#if defined(UTF8__NEON)
+  {utf8__valid_neon, utf8__count_neon, "neon"},
+#else
+  {NULL, NULL, "neon"},
+#endif
+};
+static _Atomic(const utf8__impl_t*) utf8__cur;
+
+static int utf8__impl_ok(utf8_impl i) {
+  if (i <= UTF8_IMPL_AUTO || i > UTF8_IMPL_NEON || !utf8__impls[i].valid) return 0;
+#if defined(UTF8__X86)
+  if (i == UTF8_IMPL_SSE4) return __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt");
+  if (i == UTF8_IMPL_AVX2) return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+  return 1;
+}
+
+int utf8_set_impl(utf8_impl impl) {
+  if (impl == UTF8_IMPL_AUTO) {
+    static const utf8_impl pref[] = {UTF8_IMPL_AVX2, UTF8_IMPL_NEON, UTF8_IMPL_SSE4, UTF8_IMPL_SCALAR};
+    for (size_t i = 0;; i++)
+      if (utf8__impl_ok(pref[i])) { impl = pref[i]; break; }
+  } else if (!utf8__impl_ok(impl)) {
+    return -ENOTSUP;
+  }
+  atomic_store_explicit(&utf8__cur, &utf8__impls[impl], memory_order_relaxed);
+  return 0;
+}
+
+static const utf8__impl_t* utf8__get(void) {
+  const utf8__impl_t* u = atomic_load_explicit(&utf8__cur, memory_order_relaxed);
+  if (u) return u;
+  utf8_set_impl(UTF8_IMPL_AUTO);
+  return atomic_load_explicit(&utf8__cur, memory_order_relaxed);
+}
+
+const char* utf8_impl_name(void) { return utf8__get()->name; }
+
+int utf8_validate(const char* s, size_t n) {
+  if (n == 0) return 1;
+  if (!s) return 0;
+  /* en deçà d’un registre, le scalaire évite la copie du reste */
+  if (n < 16) return utf8__valid_scalar((const unsigned char*)s, n);
+  return utf8__get()->valid((const unsigned char*)s, n);
+}
+
+size_t utf8_count(const char* s, size_t n) {
+  if (!s) return 0;
+  return utf8__get()->count((const unsigned char*)s, n);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Transcodage (entrée validée d’abord; blocs ASCII élargis/resserrés par 8)  */
+/* -------------------------------------------------------------------------- */
+size_t utf8_utf16_len(const char* s, size_t n) {
+  const unsigned char* p = (const unsigned char*)s;
+  size_t four = 0;
+  for (size_t i = 0; i < n; i++) four += p[i] >= 0xF0;
+  return utf8_count(s, n) + four;
+}
+
+/* Blocs de 16 octets ASCII: SSE2/NEON sont la base de x86-64/AArch64, pas
+   de sélection à l’exécution. Retourne le nombre d’octets consommés. */
+static size_t utf8__widen_ascii(const unsigned char* p, size_t n, uint16_t* out) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i z = _mm_setzero_si128();
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+    if (_mm_movemask_epi8(v)) break;
+    _mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi8(v, z));
+    _mm_storeu_si128((__m128i*)(out + i + 8), _mm_unpackhi_epi8(v, z));
+  }
+#elif defined(UTF8__NEON)
+  for (; i + 16 <= n; i += 16) {
+    uint8x16_t v = vld1q_u8(p + i);
+    if (vmaxvq_u8(v) >= 0x80) break;
+    vst1q_u16(out + i, vmovl_u8(vget_low_u8(v)));
+    vst1q_u16(out + i + 8, vmovl_high_u8(v));
+  }
+#else
+  (void)p; (void)n; (void)out;
+#endif
+  return i;
+}
+
+static size_t utf8__narrow_ascii(const uint16_t* s, size_t n, unsigned char* out) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i hi = _mm_set1_epi16((short)0xFF80);
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(s + i));
+    __m128i b = _mm_loadu_si128((const __m128i*)(s + i + 8));
+    __m128i m = _mm_and_si128(_mm_or_si128(a, b), hi);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128())) != 0xFFFF) break;
+    _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(a, b));
+  }
+#elif defined(UTF8__NEON)
+  for (; i + 16 <= n; i += 16) {
+    uint16x8_t a = vld1q_u16(s + i), b = vld1q_u16(s + i + 8);
+    if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) break;
+    vst1q_u8(out + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+  }
+#else
+  (void)s; (void)n; (void)out;
+#endif
+  return i;
+}
+
+size_t utf8_to_utf16(const char* s, size_t n, uint16_t* out) {
+  if (!utf8_validate(s, n)) return SIZE_MAX;
+  const unsigned char* p = (const unsigned char*)s;
+  size_t i = 0, o = 0;
+  while (i < n) {
+    if (i + 16 <= n && p[i] < 0x80) {
+      size_t k = utf8__widen_ascii(p + i, n - i, out + o);
+      i += k; o += k;
+      if (k) continue;
+    }
+    if (i + 8 <= n) {
+      uint64_t w;
+      memcpy(&w, p + i, 8);
+      if (!(w & 0x8080808080808080ull)) {
+        for (int k = 0; k < 8; k++) out[o + (size_t)k] = p[i + (size_t)k];
+        i += 8; o += 8;
+        continue;
+      }
+    }
+    unsigned c = p[i];
+    if (c < 0x80) {
+      out[o++] = (uint16_t)c; i += 1;
+    } else if (c < 0xE0) {
+      out[o++] = (uint16_t)(((c & 0x1F) << 6) | (p[i + 1] & 0x3F)); i += 2;
+    } else if (c < 0xF0) {
+      out[o++] = (uint16_t)(((c & 0x0F) << 12) | ((p[i + 1] & 0x3F) << 6) | (p[i + 2] & 0x3F)); i += 3;
+    } else {
+      u32 cp = ((u32)(c & 0x07) << 18) | ((u32)(p[i + 1] & 0x3F) << 12) |
+               ((u32)(p[i + 2] & 0x3F) << 6) | (u32)(p[i + 3] & 0x3F);
+      cp -= 0x10000;
+      out[o++] = (uint16_t)(0xD800 | (cp >> 10));
+      out[o++] = (uint16_t)(0xDC00 | (cp & 0x3FF));
+      i += 4;
+    }
+  }
+  return o;
+}
+
+size_t utf16_to_utf8(const uint16_t* s, size_t n, char* out) {
+  unsigned char* q = (unsigned char*)out;
+  size_t i = 0, o = 0;
+  while (i < n) {
+    if (i + 16 <= n && s[i] < 0x80) {
+      size_t k = utf8__narrow_ascii(s + i, n - i, q + o);
+      i += k; o += k;
+      if (k) continue;
+    }
+    if (i + 8 <= n) {
+      uint16_t m = 0;
+      for (int k = 0; k < 8; k++) m |= s[i + (size_t)k];
+      if (m < 0x80) {
+        for (int k = 0; k < 8; k++) q[o + (size_t)k] = (unsigned char)s[i + (size_t)k];
+        i += 8; o += 8;
+        continue;
+      }
+    }
+    u32 c = s[i++];
+    if (c < 0x80) {
+      q[o++] = (unsigned char)c;
+    } else if (c < 0x800) {
+      q[o++] = (unsigned char)(0xC0 | (c >> 6));
+      q[o++] = (unsigned char)(0x80 | (c & 0x3F));
+    } else if (c < 0xD800 || c > 0xDFFF) {
+      q[o++] = (unsigned char)(0xE0 | (c >> 12));
+      q[o++] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+      q[o++] = (unsigned char)(0x80 | (c & 0x3F));
+    } else {
+      if (c > 0xDBFF || i >= n || s[i] < 0xDC00 || s[i] > 0xDFFF) return SIZE_MAX;
+      c = 0x10000 + ((c - 0xD800) << 10) + (u32)(s[i++] - 0xDC00);
+      q[o++] = (unsigned char)(0xF0 | (c >> 18));
+      q[o++] = (unsigned char)(0x80 | ((c >> 12) & 0x3F));
+      q[o++] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+      q[o++] = (unsigned char)(0x80 | (c & 0x3F));
+    }
+  }
+  return o;
+}
+
+#ifdef VT_UTF8_BENCH
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double utf8__bnow(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Remplit buf de n octets (au plus) en répétant des morceaux valides */
+static size_t utf8__bfill(char* buf, size_t n, const char* const* parts, size_t np) {
+  size_t o = 0;
+  uint64_t x = 0x9E3779B97F4A7C15ull;
+  for (;;) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    const char* p = parts[(x >> 32) % np];
+    size_t l = strlen(p);
+    if (o + l > n) break;
+    memcpy(buf + o, p, l);
+    o += l;
+  }
+  return o;
+}
+
+int main(void) {
+  static const char* const ascii[] = {"the quick brown fox ", "jumps over ", "the lazy dog. "};
+  static const char* const latin[] = {"l’été ", "déjà vu ", "à bientôt, ", "garçon "};
+  static const char* const cjk[] = {"日本語の", "文字列", "漢字かな"};
+  static const char* const emoji[] = {"😀", "🚀 ", "a😀b", "€"};
+  static const struct { const char* name; const char* const* p; size_t n; } sets[] = {
+    {"ascii", ascii, 3}, {"latin", latin, 4}, {"cjk", cjk, 3}, {"emoji", emoji, 4}};
+  static const utf8_impl impls[] = {UTF8_IMPL_SCALAR, UTF8_IMPL_SSE4, UTF8_IMPL_AVX2, UTF8_IMPL_NEON};
+  size_t cap = (size_t)1 << 20;
+  char* buf = (char*)malloc(cap);
+  char* back = (char*)malloc(3 * cap);
+  uint16_t* w = (uint16_t*)malloc(cap * sizeof *w);
+  if (!buf || !back || !w) return 1;
+  utf8_set_impl(UTF8_IMPL_AUTO);
+  printf("UTF-8 (auto: %s), Go/s\n", utf8_impl_name());
+  for (size_t d = 0; d < sizeof sets / sizeof sets[0]; d++) {
+    size_t n = utf8__bfill(buf, cap, sets[d].p, sets[d].n);
+    utf8_set_impl(UTF8_IMPL_SCALAR);
+    size_t cref = utf8_count(buf, n);
+    for (size_t k = 0; k < sizeof impls / sizeof impls[0]; k++) {
+      if (utf8_set_impl(impls[k]) != 0) continue;
+      if (!utf8_validate(buf, n) || utf8_count(buf, n) != cref) {
+        printf("%s: résultat différent\n", utf8_impl_name());
+        return 1;
+      }
+      int reps = 200;
+      double t0 = utf8__bnow();
+      for (int r = 0; r < reps; r++) buf[0] = (char)(buf[0] ^ utf8_validate(buf, n) ^ 1);
+      double v = (double)n * reps / (utf8__bnow() - t0) / 1e9;
+      size_t acc = 0;
+      t0 = utf8__bnow();
+      for (int r = 0; r < reps; r++) acc += utf8_count(buf, n);
+      double c = (double)n * reps / (utf8__bnow() - t0) / 1e9;
+      reps = 20;
+      size_t m = 0, b = 0;
+      t0 = utf8__bnow();
+      for (int r = 0; r < reps; r++) m = utf8_to_utf16(buf, n, w);
+      double to = (double)n * reps / (utf8__bnow() - t0) / 1e9;
+      t0 = utf8__bnow();
+      for (int r = 0; r < reps; r++) b = utf16_to_utf8(w, m, back);
+      double from = (double)n * reps / (utf8__bnow() - t0) / 1e9;
+      if (m == SIZE_MAX || b != n || memcmp(back, buf, n) != 0 || acc != cref * 200) {
+        printf("%s: aller-retour UTF-16 faux\n", utf8_impl_name());
+        return 1;
+      }
+      printf("  %-6s %-7s valid %6.2f  count %6.2f  →16 %5.2f  16→ %5.2f\n", sets[d].name,
+             utf8_impl_name(), v, c, to, from);
+    }
+  }
+  free(buf); free(back); free(w);
+  return 0;
+}
+#endif /* VT_UTF8_BENCH */
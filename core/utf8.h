@@ -26,10 +26,34 @@ typedef uint32_t u32;
    Retourne le code point (U+FFFD sur erreur). */
 u32 utf8_decode_1(const char* s, size_t n, size_t* adv);
 
-/* Valide une chaîne UTF-8.
+/* Valide une chaîne UTF-8 (stricte: surlongs, surrogates, > U+10FFFF et
+   séquences tronquées refusés). SIMD si le CPU le permet.
    Retourne 1 si valide, 0 sinon. */
 int utf8_validate(const char* s, size_t n);
 
+/* Nombre de code points (octets hors continuation); exact si s est valide. */
+size_t utf8_count(const char* s, size_t n);
+
+/* Transcodage. out: n unités UTF-16 (resp. 3n octets) suffisent toujours.
+   Retourne le nombre d’unités (resp. d’octets) écrites, SIZE_MAX si
+   l’entrée est invalide (UTF-8 refusé par utf8_validate, surrogate isolé). */
+size_t utf8_to_utf16(const char* s, size_t n, uint16_t* out);
+size_t utf16_to_utf8(const uint16_t* s, size_t n, char* out);
+/* Unités UTF-16 nécessaires pour s valide. */
+size_t utf8_utf16_len(const char* s, size_t n);
+
+/* Noyau de validation/comptage: AUTO = AVX2 > NEON > SSE4.1 > scalaire.
+   -ENOTSUP si indisponible. */
+typedef enum {
+  UTF8_IMPL_AUTO = 0,
+  UTF8_IMPL_SCALAR,
+  UTF8_IMPL_SSE4,
+  UTF8_IMPL_AVX2,
+  UTF8_IMPL_NEON
+} utf8_impl;
+int utf8_set_impl(utf8_impl impl);
+const char* utf8_impl_name(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
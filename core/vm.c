@@ -1,25 +1,297 @@
 // SPDX-License-Identifier: MIT
 /* ============================================================================
-   vm.c — Implémentation minimale de la VM VitteLight (stub fonctionnel)
+   vm.c — Interpréteur VTBC de VitteLight
 
-   Cette version assure la cohérence avec l’API exposée par vm.h sans encore
-   proposer une exécution de bytecode. Les hooks principaux sont en place et
-   retournent ENOSYS lorsque la fonctionnalité n’est pas disponible.
+   - Chargement d’images (undump.h), d’un tampon mémoire ou de CODE brut
+   - Pré-décodage à la charge: CODE → tableau d’instructions de taille fixe
+     (16 o), cibles de saut en index absolus, constantes résolues en
+     pointeurs. Le programme est immuable et mis en cache sur le vt_img
+     (vt_img_cache_*), partagé par toutes les VM exécutant l’image.
+   - Vérification à la charge: opérandes, cibles, profondeur de pile exacte
+     par flot de données → aucune vérif de débordement dans la boucle chaude
+   - Superinstructions (vt_fuse) appliquées à la charge, sauf cfg.no_fuse
+   - Forme registres (ir.h) à la charge, sauf cfg.no_regs: chaque fonction
+     est abaissée par vt_ir_lower; les temporaires sont les slots de pile du
+     frame, les insns non traduites restent des insns pile
+   - JIT de base x86-64 (jit.h) si cfg.jit_hot: une fonction est compilée
+     par copie de templates après jit_hot entrées + sauts arrière; int et
+     float seulement, le reste (et toute garde ratée) repasse à
+     l’interpréteur sur la même insn (-DVT_VM_NO_JIT le retire)
+   - Caches en ligne par site MGET/MSET (slot de la clé dans la map) et
+     CALL (fonction déjà vérifiée), table par VM parallèle aux insns;
+     succès/échecs via vt_vm_ic_stats (-DVT_VM_PROFILE)
+   - Dispatch "threaded" par goto calculé (GCC/Clang), switch sinon
+     (forcer le switch: -DVT_VM_NO_THREADED; profil par opcode:
+     -DVT_VM_PROFILE + vt_vm_set_profile)
+   - Objets heap (string/array/map/closure) alloués via gc.h dans une
+     nursery (bump pointer, sauf cfg.no_nursery); collecte mineure aux
+     points sûrs en fin d’insn allouante, barrière d’écriture sur
+     APUSH/ASET/MSET/CAPTURE. Un objet pouvant changer d’adresse, les
+     clés array/map/closure hachent un identifiant stable. Marquage
+     incrémental si cfg.gc_slice_us (même barrière), collectes complètes
+     parallèles si cfg.gc_threads > 1
+   - Exceptions (TENTER/TLEAVE/THROW) et step_limit avec reprise
    ============================================================================ */
 
 #include "vm.h"
 
 #include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef VT_OBJECT_H
+#include "gc.h"
+#include "ir.h"
+#include "jit.h"
+#include "opcodes.h"
+#include "undump.h"
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VT_VM_LIKELY(x) __builtin_expect(!!(x), 1)
+#define VT_VM_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define VT_VM_LIKELY(x) (x)
+#define VT_VM_UNLIKELY(x) (x)
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(VT_VM_NO_THREADED)
+#define VT_VM_THREADED 1
+#else
+#define VT_VM_THREADED 0
+#endif
+
+/* JIT de base: x86-64, disposition 16 o de vt_value (pas en NaN-boxing).
+   -DVT_VM_NO_JIT le retire. */
+#if defined(VT_OBJECT_H) && VT_JIT_X86_64 && !defined(VT_VALUE_NANBOX) && \
+    !defined(VT_VM_NO_JIT)
+#define VT_VM_JIT 1
+#else
+#define VT_VM_JIT 0
+#endif
+
+#ifndef VT_VM_MAX_FRAMES
+#define VT_VM_MAX_FRAMES 100000
+#endif
+
 /* -------------------------------------------------------------------------- */
 /* VM interne                                                                 */
 /* -------------------------------------------------------------------------- */
+#ifdef VT_OBJECT_H
+/* Instruction pré-décodée (taille fixe, alignée sur 8). */
+typedef struct vt__pinsn {
+  uint8_t op;  /* vt_opcode ou VT__R_* */
+  uint8_t c;   /* u8 secondaire: CALL nrets, CLOSURE nup, condition */
+  uint16_t a;  /* u16/u8 principal: slot, gslot, n, nargs, nrets ; reg. a */
+  uint16_t b;  /* reg. b ; LDG/STG registres: gslot */
+  uint16_t d;  /* reg. destination ; LD_ADDI_ST: slot destination */
+  union {
+    int64_t i;
+    double f;
+    const vt_value* k; /* constante résolue */
+    uint32_t ic;       /* MGET/MSET/CALL: index dans vm->ic */
+    struct {
+      uint32_t t; /* cible absolue (index d’insn): sauts, TENTER */
+      int32_t k;  /* CMPJFI: immédiat */
+    } j;
+  } x;
+} vt__pinsn;
+
+/* Opcodes de la forme registres (vt_ir_op), numérotés après les opcodes
+   pile. VT_IR_STK n’existe pas à l’exécution: l’insn pile est émise telle
+   quelle. Registre r = bp[r] (locaux puis temporaires). */
+enum {
+  VT__R_MOV = OP__COUNT + VT_IR_MOV,
+  VT__R_LOADI = OP__COUNT + VT_IR_LOADI,
+  VT__R_LOADF = OP__COUNT + VT_IR_LOADF,
+  VT__R_LOADK = OP__COUNT + VT_IR_LOADK,
+  VT__R_LDG = OP__COUNT + VT_IR_LDG,
+  VT__R_STG = OP__COUNT + VT_IR_STG,
+  VT__R_ADD = OP__COUNT + VT_IR_ADD,
+  VT__R_SUB = OP__COUNT + VT_IR_SUB,
+  VT__R_MUL = OP__COUNT + VT_IR_MUL,
+  VT__R_DIV = OP__COUNT + VT_IR_DIV,
+  VT__R_MOD = OP__COUNT + VT_IR_MOD,
+  VT__R_ADDI = OP__COUNT + VT_IR_ADDI,
+  VT__R_NEG = OP__COUNT + VT_IR_NEG,
+  VT__R_NOT = OP__COUNT + VT_IR_NOT,
+  VT__R_EQ = OP__COUNT + VT_IR_EQ,
+  VT__R_NE = OP__COUNT + VT_IR_NE,
+  VT__R_LT = OP__COUNT + VT_IR_LT,
+  VT__R_LE = OP__COUNT + VT_IR_LE,
+  VT__R_GT = OP__COUNT + VT_IR_GT,
+  VT__R_GE = OP__COUNT + VT_IR_GE,
+  VT__R_JMP = OP__COUNT + VT_IR_JMP,
+  VT__R_JT = OP__COUNT + VT_IR_JT,
+  VT__R_JF = OP__COUNT + VT_IR_JF,
+  VT__R_CMPJF = OP__COUNT + VT_IR_CMPJF,
+  VT__R_CMPJFI = OP__COUNT + VT_IR_CMPJFI,
+  VT__R_SETSP = OP__COUNT + VT_IR_SETSP,
+  VT__OP_MAX = OP__COUNT + VT_IR__COUNT
+};
+
+typedef struct vt__vfunc {
+  uint32_t entry;     /* index de la première insn */
+  uint32_t end;       /* index de fin (exclu) */
+  uint16_t nparams;
+  uint16_t nlocals;
+  uint32_t max_stack; /* profondeur d’opérandes exacte (vérifiée) */
+} vt__vfunc;
+
+/* Programme pré-décodé, immuable une fois construit. */
+typedef struct vt__vprog {
+  vt__pinsn* insns;
+  size_t ninsns;
+  vt__vfunc* funcs;
+  size_t nfuncs;
+  vt_value* consts; /* objets heap permanents (hors GC) */
+  size_t nconsts;
+  size_t nglobals;  /* slots globaux référencés */
+  uint16_t* rlive;  /* forme registres: slots valides (depuis bp) par insn,
+                       sp recalé avant de lever; NULL en forme pile */
+  uint32_t nic;     /* sites MGET/MSET/CALL (caches en ligne) */
+} vt__vprog;
+
+/* Cache en ligne d’un site, polymorphe à VT__IC_WAYS voies (0 = libre).
+   MGET/MSET: a = slot + 1 dans ents, valable tant que l’entrée porte une
+   clé identique (les maps ne suppriment pas: une clé ne bouge qu’au grow,
+   ce que la vérif détecte). CALL: a = fn + 1, b = nup, arité et upvalues
+   déjà vérifiées pour ce site (nargs y est constant). Après VT__IC_MEGA
+   échecs d’affilée le site est mégamorphe: plus de sondage ni de remplissage.
+ */
+#define VT__IC_WAYS 4
+#define VT__IC_MEGA 64
+typedef struct vt__ic {
+  struct {
+    uint32_t a, b;
+  } w[VT__IC_WAYS];
+  uint16_t next; /* voie remplacée au prochain échec */
+  uint16_t miss; /* échecs consécutifs (VT__IC_MEGA: mégamorphe) */
+} vt__ic;
+
+typedef struct vt__frame {
+  uint32_t fn;
+  uint32_t nrets;    /* résultats attendus par l’appelant */
+  size_t ret_ip;     /* index d’insn de retour */
+  size_t bp;         /* base des locaux (index pile) */
+  size_t nhandlers;  /* profondeur handlers à l’entrée */
+} vt__frame;
+
+typedef struct vt__handler {
+  size_t nframes; /* frames à conserver */
+  size_t sp;      /* pile restaurée avant push de l’exception */
+  size_t ip;      /* index d’insn du handler */
+} vt__handler;
+
+/* Objets heap (payload gc.h, tag = vt_type). perm=1: objet permanent du
+   programme (constante), alloué hors GC et jamais visité. */
+typedef struct vt__vstr {
+  uint32_t perm;
+  size_t len;
+  uint64_t hash;
+  char data[];
+} vt__vstr;
+
+typedef struct vt__varr {
+  uint32_t perm;
+  uint32_t id; /* identité stable (hash), l’adresse peut changer */
+  size_t len, cap;
+  vt_value* items;
+  size_t clean; /* items[0, clean) sans jeune depuis la dernière mineure */
+} vt__varr;
+
+typedef struct vt__vment {
+  uint64_t h; /* 0 = libre, sinon hash|1 */
+  vt_value key;
+  vt_value val;
+} vt__vment;
+
+typedef struct vt__vmap {
+  uint32_t perm;
+  uint32_t id;
+  size_t len, cap; /* cap = puissance de 2 */
+  vt__vment* ents;
+} vt__vmap;
+
+typedef struct vt__vclo {
+  uint32_t perm;
+  uint32_t id;
+  uint32_t fn;
+  uint32_t nup, cap;
+  vt_value* up;
+} vt__vclo;
+
+typedef struct vt__vroot {
+  vt_vm* vm;
+} vt__vroot;
+
+enum { VT__IDLE = 0, VT__SUSPENDED, VT__DONE };
+
+#if VT_VM_JIT
+/* Contexte du code natif (offsets figés dans les templates). */
+typedef struct vt__jctx {
+  vt_value* bp;      /* +0  */
+  vt_value* sp;      /* +8  */
+  vt_value* globals; /* +16 */
+  uint64_t steps;    /* +24 */
+  uint64_t limit;    /* +32 */
+} vt__jctx;
+
+/* Point d’entrée (prologue en tête du code): saute à at, renvoie l’index
+   d’insn où l’interpréteur reprend. */
+typedef uint32_t (*vt__jentry)(vt__jctx* ctx, const void* at);
+
+/* État JIT d’une fonction (par VM: le programme, lui, est partagé). */
+typedef struct vt__jfn {
+  uint32_t hot;      /* entrées + sauts arrière avant compilation */
+  vt_jit_code code;
+  uint32_t* off;     /* offset natif par insn (| VT__JNONE: interprétée) */
+} vt__jfn;
+#endif
+#endif /* VT_OBJECT_H */
+
 struct vt_vm {
   vt_vm_config cfg;
   vt_cfunc*    natives;
   size_t       native_cap;
+#ifdef VT_OBJECT_H
+  vt_gc*       gc;
+  vt__vroot*   root;
+  uint32_t     oid;       /* prochain vt__varr/vmap/vclo.id */
+
+  /* Programme */
+  vt_img*      img;       /* image possédée (NULL si empruntée) */
+  const vt__vprog* prog;  /* programme courant (cache d’image ou prog_own) */
+  vt__vprog*   prog_own;  /* programme privé (vt_vm_load_code) */
+
+  /* État d’exécution */
+  vt_value*    stack;
+  size_t       stack_cap;
+  size_t       sp;
+  size_t       ip;
+  vt__frame*   frames;
+  size_t       nframes, frame_cap;
+  vt__handler* handlers;
+  size_t       nhandlers, handler_cap;
+  vt_value*    globals;
+  size_t       nglobals;
+  vt_value     tnames[VT_PTR + 1]; /* noms de types mis en cache (TYPEOF) */
+  int          status;
+  uint64_t     steps;
+  uint64_t*    prof;      /* compteurs par opcode (VT_VM_PROFILE) */
+  vt__ic*      ic;        /* caches en ligne (prog->nic) */
+#ifdef VT_VM_PROFILE
+  vt_vm_icstats icstat;
+#endif
+#if VT_VM_JIT
+  vt__jfn*     jit;       /* par fonction si cfg.jit_hot, NULL sinon */
+  size_t       njit;
+#endif
+#endif
+  char         err[256];
 };
 
 static const vt_vm_config VT_VM_DEFAULT_CFG = {
@@ -27,8 +299,16 @@ static const vt_vm_config VT_VM_DEFAULT_CFG = {
   .initial_frame_cap   = 32,
   .default_step_limit  = 0,
   .enable_traces       = 0,
+  .no_fuse             = 0,
+  .no_regs             = 0,
+  .jit_hot             = 0,
+  .no_nursery          = 0,
+  .gc_slice_us         = 0,
+  .gc_threads          = 0,
 };
 
+#define VT__NURSERY (512u << 10) /* octets de génération jeune par VM */
+
 static int vt__ensure_native_cap(vt_vm* vm, size_t need) {
   if (need <= vm->native_cap) return 0;
   size_t cap = vm->native_cap ? vm->native_cap : 16;
@@ -41,6 +321,2624 @@ static int vt__ensure_native_cap(vt_vm* vm, size_t need) {
   return 0;
 }
 
+static int vt__fail(vt_vm* vm, int code, const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(vm->err, sizeof vm->err, fmt, ap);
+  va_end(ap);
+  return code;
+}
+
+#ifdef VT_OBJECT_H
+/* -------------------------------------------------------------------------- */
+/* Valeurs                                                                    */
+/* -------------------------------------------------------------------------- */
+static inline int vt__is_heap(const vt_value* v) {
+  const vt_type t = vt_value_type(v);
+  return t == VT_STR || t == VT_ARRAY || t == VT_MAP || t == VT_FUNC;
+}
+static inline int vt__is_num(const vt_value* v) {
+  return vt_is_int(v) || vt_is_float(v);
+}
+static inline double vt__num(const vt_value* v) {
+  return vt_is_int(v) ? (double)vt_as_int(v) : vt_as_float(v);
+}
+static inline int vt__truthy(const vt_value* v) {
+  switch (vt_value_type(v)) {
+    case VT_NIL: return 0;
+    case VT_BOOL: return vt_as_bool(v);
+    case VT_INT: return vt_as_int(v) != 0;
+    case VT_FLOAT: return vt_as_float(v) != 0.0;
+    default: return 1;
+  }
+}
+
+static const char* const VT__TNAMES[VT_PTR + 1] = {
+    "nil", "bool", "int", "float", "string",
+    "bytes", "array", "map", "func", "ptr"};
+
+/* -------------------------------------------------------------------------- */
+/* Objets heap                                                                */
+/* -------------------------------------------------------------------------- */
+static uint64_t vt__fnv1a(const void* p, size_t n) {
+  const uint8_t* s = (const uint8_t*)p;
+  uint64_t h = 1469598103934665603ull;
+  for (size_t i = 0; i < n; i++) {
+    h ^= s[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+/* Champs gérés (vt_gc_update_fn): move rend l’adresse courante de l’enfant,
+   inchangée au marquage, copie promue en collecte mineure. Les objets
+   permanents sont hors GC. */
+static void vt__move_value(vt_value* v, vt_gc_move_fn move, void* ctx) {
+  if (vt__is_heap(v) && !*(const uint32_t*)vt_as_ptr(v))
+    *v = vt_obj((vt_type)vt_value_type(v), move(vt_as_ptr(v), ctx));
+}
+/* Mineure: seule la zone écrite depuis la précédente (APUSH en fin, ASET
+   abaisse clean) est revue; un gros tableau ancien n’est pas rescanné en
+   entier à chaque collecte. */
+static void vt__arr_update(void* obj, vt_gc_move_fn move, void* ctx) {
+  vt__varr* a = (vt__varr*)obj;
+  size_t i = 0;
+  if (vt_gc_is_minor(ctx)) {
+    i = a->clean;
+    a->clean = a->len;
+  }
+  for (; i < a->len; i++) vt__move_value(&a->items[i], move, ctx);
+}
+static void vt__arr_fin(void* obj) { free(((vt__varr*)obj)->items); }
+static void vt__map_update(void* obj, vt_gc_move_fn move, void* ctx) {
+  vt__vmap* m = (vt__vmap*)obj;
+  for (size_t i = 0; i < m->cap; i++) {
+    if (!m->ents[i].h) continue;
+    vt__move_value(&m->ents[i].key, move, ctx);
+    vt__move_value(&m->ents[i].val, move, ctx);
+  }
+}
+static void vt__map_fin(void* obj) { free(((vt__vmap*)obj)->ents); }
+static void vt__clo_update(void* obj, vt_gc_move_fn move, void* ctx) {
+  vt__vclo* c = (vt__vclo*)obj;
+  for (uint32_t i = 0; i < c->nup; i++) vt__move_value(&c->up[i], move, ctx);
+}
+static void vt__clo_fin(void* obj) { free(((vt__vclo*)obj)->up); }
+
+static void vt__root_update(void* obj, vt_gc_move_fn move, void* ctx) {
+  vt_vm* vm = ((vt__vroot*)obj)->vm;
+  if (!vm) return;
+  for (size_t i = 0; i < vm->sp; i++) vt__move_value(&vm->stack[i], move, ctx);
+  for (size_t i = 0; i < vm->nglobals; i++)
+    vt__move_value(&vm->globals[i], move, ctx);
+  for (size_t i = 0; i <= VT_PTR; i++) vt__move_value(&vm->tnames[i], move, ctx);
+}
+
+/* Barrière d’écriture: obj (géré) vient de recevoir v. */
+static inline void vt__wb(vt_vm* vm, void* obj, const vt_value* v) {
+  if (vt__is_heap(v) && !*(const uint32_t*)obj)
+    vt_gc_write_barrier(vm->gc, obj);
+}
+
+/* Chaîne de n octets non initialisés (terminer par vt__str_seal). */
+static vt__vstr* vt__str_alloc(vt_vm* vm, size_t n) {
+  vt__vstr* o = (vt__vstr*)vt_gc_alloc_young(vm->gc, sizeof(vt__vstr) + n + 1,
+                                             NULL, NULL, VT_STR);
+  if (o) {
+    o->perm = 0;
+    o->len = n;
+  }
+  return o;
+}
+static void vt__str_seal(vt__vstr* o) {
+  o->data[o->len] = 0;
+  o->hash = vt__fnv1a(o->data, o->len);
+}
+static vt__vstr* vt__str_new(vt_vm* vm, const char* s, size_t n) {
+  vt__vstr* o = vt__str_alloc(vm, n);
+  if (!o) return NULL;
+  if (n) memcpy(o->data, s, n);
+  vt__str_seal(o);
+  return o;
+}
+
+static vt__varr* vt__arr_new(vt_vm* vm, size_t cap) {
+  vt__varr* a = (vt__varr*)vt_gc_alloc_young(vm->gc, sizeof(vt__varr),
+                                             vt__arr_update, vt__arr_fin,
+                                             VT_ARRAY);
+  if (!a) return NULL;
+  a->perm = 0;
+  a->id = vm->oid++;
+  a->len = 0;
+  a->cap = 0;
+  a->items = NULL;
+  a->clean = 0;
+  if (cap) {
+    a->items = (vt_value*)malloc(cap * sizeof(vt_value));
+    if (a->items) a->cap = cap;
+  }
+  return a;
+}
+static int vt__arr_reserve(vt__varr* a, size_t need) {
+  if (need <= a->cap) return 1;
+  size_t ncap = a->cap ? a->cap * 2 : 8;
+  while (ncap < need) ncap *= 2;
+  vt_value* p = (vt_value*)realloc(a->items, ncap * sizeof(vt_value));
+  if (!p) return 0;
+  a->items = p;
+  a->cap = ncap;
+  return 1;
+}
+
+static vt__vmap* vt__map_new(vt_vm* vm) {
+  vt__vmap* m = (vt__vmap*)vt_gc_alloc_young(vm->gc, sizeof(vt__vmap),
+                                             vt__map_update, vt__map_fin,
+                                             VT_MAP);
+  if (!m) return NULL;
+  m->perm = 0;
+  m->id = vm->oid++;
+  m->len = 0;
+  m->cap = 0;
+  m->ents = NULL;
+  return m;
+}
+
+static vt__vclo* vt__clo_new(vt_vm* vm, uint32_t fn, uint32_t nup) {
+  vt__vclo* c = (vt__vclo*)vt_gc_alloc_young(vm->gc, sizeof(vt__vclo),
+                                             vt__clo_update, vt__clo_fin,
+                                             VT_FUNC);
+  if (!c) return NULL;
+  c->perm = 0;
+  c->id = vm->oid++;
+  c->fn = fn;
+  c->nup = 0;
+  c->cap = 0;
+  c->up = NULL;
+  if (nup) {
+    c->up = (vt_value*)malloc(nup * sizeof(vt_value));
+    if (c->up) c->cap = nup;
+  }
+  return c;
+}
+static int vt__clo_push(vt__vclo* c, vt_value v) {
+  if (c->nup == c->cap) {
+    uint32_t ncap = c->cap ? c->cap * 2 : 4;
+    vt_value* p = (vt_value*)realloc(c->up, ncap * sizeof(vt_value));
+    if (!p) return 0;
+    c->up = p;
+    c->cap = ncap;
+  }
+  c->up[c->nup++] = v;
+  return 1;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Égalité / hash / ordre                                                     */
+/* -------------------------------------------------------------------------- */
+static int vt__equal(const vt_value* a, const vt_value* b) {
+  if (vt__is_num(a) && vt__is_num(b)) {
+    if (vt_is_int(a) && vt_is_int(b)) return vt_as_int(a) == vt_as_int(b);
+    return vt__num(a) == vt__num(b);
+  }
+  if (vt_value_type(a) != vt_value_type(b)) return 0;
+  switch (vt_value_type(a)) {
+    case VT_NIL: return 1;
+    case VT_BOOL: return vt_as_int(a) == vt_as_int(b);
+    case VT_STR: {
+      const vt__vstr* x = (const vt__vstr*)vt_as_ptr(a);
+      const vt__vstr* y = (const vt__vstr*)vt_as_ptr(b);
+      return x == y || (x->len == y->len && x->hash == y->hash &&
+                        memcmp(x->data, y->data, x->len) == 0);
+    }
+    default: return vt_as_ptr(a) == vt_as_ptr(b);
+  }
+}
+
+static uint64_t vt__hash(const vt_value* v) {
+  switch (vt_value_type(v)) {
+    case VT_NIL: return 0x9e3779b97f4a7c15ull;
+    case VT_BOOL:
+    case VT_INT: return (uint64_t)vt_as_int(v) * 0x9e3779b97f4a7c15ull;
+    case VT_FLOAT: {
+      double d = vt_as_float(v);
+      /* les flottants entiers hashent comme l’entier correspondant (-0.0
+         compris); conversion seulement dans l’intervalle d’int64_t: NaN,
+         ±inf et |d| >= 2^63 hashent leurs bits */
+      if (isfinite(d) && d >= -0x1p63 && d < 0x1p63 &&
+          d == (double)(int64_t)d)
+        return (uint64_t)(int64_t)d * 0x9e3779b97f4a7c15ull;
+      uint64_t u;
+      memcpy(&u, &d, sizeof u);
+      return u * 0x9e3779b97f4a7c15ull;
+    }
+    case VT_STR: return ((const vt__vstr*)vt_as_ptr(v))->hash;
+    case VT_ARRAY: /* id en tête de vt__varr/vmap/vclo, après perm */
+    case VT_MAP:
+    case VT_FUNC:
+      return ((uint64_t)((const uint32_t*)vt_as_ptr(v))[1] + 1) *
+             0x9e3779b97f4a7c15ull;
+    default: return (uint64_t)(uintptr_t)vt_as_ptr(v) * 0x9e3779b97f4a7c15ull;
+  }
+}
+
+/* -1/0/1, ou 2 si non comparable */
+static int vt__compare(const vt_value* a, const vt_value* b) {
+  if (vt_is_int(a) && vt_is_int(b))
+    return (vt_as_int(a) > vt_as_int(b)) - (vt_as_int(a) < vt_as_int(b));
+  if (vt__is_num(a) && vt__is_num(b)) {
+    double x = vt__num(a), y = vt__num(b);
+    if (x != x || y != y) return 2;
+    return (x > y) - (x < y);
+  }
+  if (vt_value_type(a) == VT_STR && vt_value_type(b) == VT_STR) {
+    const vt__vstr* x = (const vt__vstr*)vt_as_ptr(a);
+    const vt__vstr* y = (const vt__vstr*)vt_as_ptr(b);
+    size_t n = x->len < y->len ? x->len : y->len;
+    int c = memcmp(x->data, y->data, n);
+    if (c) return c < 0 ? -1 : 1;
+    return (x->len > y->len) - (x->len < y->len);
+  }
+  return 2;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Map (sondage linéaire, clés vt_value)                                      */
+/* -------------------------------------------------------------------------- */
+static vt__vment* vt__map_slot(const vt__vmap* m, const vt_value* key,
+                               uint64_t h) {
+  size_t mask = m->cap - 1;
+  size_t i = (size_t)h & mask;
+  for (;;) {
+    vt__vment* e = &m->ents[i];
+    if (!e->h) return e;
+    if (e->h == h && vt__equal(&e->key, key)) return e;
+    i = (i + 1) & mask;
+  }
+}
+
+static int vt__map_grow(vt__vmap* m) {
+  size_t ncap = m->cap ? m->cap * 2 : 8;
+  vt__vment* ne = (vt__vment*)calloc(ncap, sizeof(vt__vment));
+  if (!ne) return 0;
+  vt__vment* old = m->ents;
+  size_t ocap = m->cap;
+  m->ents = ne;
+  m->cap = ncap;
+  for (size_t i = 0; i < ocap; i++) {
+    if (!old[i].h) continue;
+    *vt__map_slot(m, &old[i].key, old[i].h) = old[i];
+  }
+  free(old);
+  return 1;
+}
+
+/* Écrit key → val; renvoie l’entrée, NULL si mémoire insuffisante. */
+static vt__vment* vt__map_put(vt__vmap* m, vt_value key, vt_value val) {
+  if ((m->len + 1) * 4 > m->cap * 3 && !vt__map_grow(m)) return NULL;
+  uint64_t h = vt__hash(&key) | 1u;
+  vt__vment* e = vt__map_slot(m, &key, h);
+  if (!e->h) {
+    e->h = h;
+    e->key = key;
+    m->len++;
+  }
+  e->val = val;
+  return e;
+}
+
+static int vt__map_set(vt__vmap* m, vt_value key, vt_value val) {
+  return vt__map_put(m, key, val) != NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Caches en ligne                                                            */
+/* -------------------------------------------------------------------------- */
+#ifdef VT_VM_PROFILE
+#define VT__ICSTAT(vm, f) ((vm)->icstat.f++)
+#else
+#define VT__ICSTAT(vm, f) ((void)(vm))
+#endif
+
+/* Même représentation (pas seulement égale): une entrée de map identique à
+   la clé cherchée est forcément celle que trouverait vt__map_slot. */
+static inline int vt__ident(const vt_value* a, const vt_value* b) {
+  return memcmp(a, b, sizeof(vt_value)) == 0;
+}
+
+static void vt__ic_fill(vt__ic* ic, uint32_t a, uint32_t b) {
+  if (ic->miss >= VT__IC_MEGA) return;
+  ic->miss++;
+  ic->w[ic->next].a = a;
+  ic->w[ic->next].b = b;
+  ic->next = (uint16_t)((ic->next + 1) % VT__IC_WAYS);
+}
+
+/* Entrée de m pour key via le cache du site, NULL si absente. Les clés
+   float (NaN ≠ NaN) passent toujours par la recherche. */
+static vt__vment* vt__ic_map(vt_vm* vm, vt__ic* ic, const vt__vmap* m,
+                             const vt_value* key, int set) {
+  if (ic->miss < VT__IC_MEGA && !vt_is_float(key)) {
+    for (int w = 0; w < VT__IC_WAYS; w++) {
+      uint32_t s = ic->w[w].a;
+      if (s && s <= m->cap && m->ents[s - 1].h &&
+          vt__ident(&m->ents[s - 1].key, key)) {
+        if (set) VT__ICSTAT(vm, mset_hits);
+        else VT__ICSTAT(vm, mget_hits);
+        ic->miss = 0;
+        return &m->ents[s - 1];
+      }
+    }
+  }
+  if (set) VT__ICSTAT(vm, mset_misses);
+  else VT__ICSTAT(vm, mget_misses);
+  if (!m->len) return NULL;
+  vt__vment* e = vt__map_slot(m, key, vt__hash(key) | 1u);
+  if (!e->h) return NULL;
+  if (!vt_is_float(key)) vt__ic_fill(ic, (uint32_t)(e - m->ents) + 1, 0);
+  return e;
+}
+
+/* MSET: écrase en place si la clé est déjà là, sinon insère puis met le
+   slot en cache. 0 si mémoire insuffisante. */
+static int vt__ic_mset(vt_vm* vm, vt__ic* ic, vt__vmap* m, vt_value key,
+                       vt_value val) {
+  vt__vment* e = vt__ic_map(vm, ic, m, &key, 1);
+  if (e) {
+    e->val = val;
+    vt__wb(vm, m, &val);
+    return 1;
+  }
+  e = vt__map_put(m, key, val);
+  if (!e) return 0;
+  vt__wb(vm, m, &key);
+  vt__wb(vm, m, &val);
+  if (!vt_is_float(&key)) vt__ic_fill(ic, (uint32_t)(e - m->ents) + 1, 0);
+  return 1;
+}
+
+/* CALL: 1 si la fonction de c a déjà passé les vérifs d’entrée ici. */
+static int vt__ic_call(vt_vm* vm, vt__ic* ic, const vt__vclo* c) {
+  for (int w = 0; ic->miss < VT__IC_MEGA && w < VT__IC_WAYS; w++) {
+    if (ic->w[w].a == c->fn + 1 && ic->w[w].b == c->nup) {
+      VT__ICSTAT(vm, call_hits);
+      ic->miss = 0;
+      return 1;
+    }
+  }
+  VT__ICSTAT(vm, call_misses);
+  return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stringify                                                                  */
+/* -------------------------------------------------------------------------- */
+static int vt__fmt_scalar(const vt_value* v, char* buf, size_t n) {
+  switch (vt_value_type(v)) {
+    case VT_NIL: return snprintf(buf, n, "nil");
+    case VT_BOOL:
+      return snprintf(buf, n, "%s", vt_as_bool(v) ? "true" : "false");
+    case VT_INT: return snprintf(buf, n, "%lld", (long long)vt_as_int(v));
+    case VT_FLOAT: return snprintf(buf, n, "%.17g", vt_as_float(v));
+    case VT_ARRAY:
+      return snprintf(buf, n, "<array %zu>", ((vt__varr*)vt_as_ptr(v))->len);
+    case VT_MAP:
+      return snprintf(buf, n, "<map %zu>", ((vt__vmap*)vt_as_ptr(v))->len);
+    case VT_FUNC:
+      return snprintf(buf, n, "<func #%u>", ((vt__vclo*)vt_as_ptr(v))->fn);
+    case VT_PTR: return snprintf(buf, n, "<native %p>", vt_as_ptr(v));
+    default: return snprintf(buf, n, "<%s>", VT__TNAMES[vt_value_type(v)]);
+  }
+}
+
+/* Vue texte d’une valeur: string → données, sinon formatage dans buf. */
+static const char* vt__text(const vt_value* v, char* buf, size_t n,
+                            size_t* out_len) {
+  if (vt_value_type(v) == VT_STR) {
+    const vt__vstr* s = (const vt__vstr*)vt_as_ptr(v);
+    *out_len = s->len;
+    return s->data;
+  }
+  int k = vt__fmt_scalar(v, buf, n);
+  *out_len = k < 0 ? 0 : ((size_t)k < n ? (size_t)k : n - 1);
+  return buf;
+}
+
+static void vt__print(const vt_value* v) {
+  char buf[64];
+  size_t n = 0;
+  const char* s = vt__text(v, buf, sizeof buf, &n);
+  fwrite(s, 1, n, stdout);
+  fputc('\n', stdout);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Lecture LE des opérandes                                                   */
+/* -------------------------------------------------------------------------- */
+static inline uint16_t vt__u16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+static inline uint32_t vt__u32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+static inline int32_t vt__i32(const uint8_t* p) { return (int32_t)vt__u32(p); }
+static inline uint64_t vt__u64(const uint8_t* p) {
+  return (uint64_t)vt__u32(p) | ((uint64_t)vt__u32(p + 4) << 32);
+}
+static inline double vt__f64(const uint8_t* p) {
+  uint64_t u = vt__u64(p);
+  double d;
+  memcpy(&d, &u, sizeof d);
+  return d;
+}
+
+#if VT_VM_JIT
+/* -------------------------------------------------------------------------- */
+/* JIT de base (x86-64)                                                       */
+/* -------------------------------------------------------------------------- */
+/* Compilation d’une fonction entière par copie de templates: chaque insn
+   supportée devient "inc r14" (steps) suivi de quelques templates, opérandes
+   dans rsi/rdi, destination dans r8. Le code natif travaille sur les slots
+   de l’interpréteur (r12 = bp, r13 = sp, r15 = globals) et n’alloue ni ne
+   lève jamais: une garde ratée (type, diviseur 0 ou -1) rend la main sur la
+   même insn, step annulé; une insn non supportée (appels, objets,
+   exceptions, NOT…) aussi. La step_limit n’est testée qu’aux sauts arrière.
+   Les champs à corriger sont zéro dans les templates (offsets: voir les
+   appels vt_jit_set32/set64/rel32). */
+_Static_assert(sizeof(vt_value) == 16 && offsetof(vt_value, as) == 8,
+               "templates JIT: vt_value 16 o {type, flags, as}");
+_Static_assert(VT_BOOL == 1 && VT_INT == 2 && VT_FLOAT == 3,
+               "templates JIT: étiquettes de type figées");
+_Static_assert(offsetof(vt__jctx, limit) == 32, "templates JIT: vt__jctx");
+
+/* push rbx,r12-r15 ; rbx=ctx ; r12=bp ; r13=sp ; r15=globals ;
+   r14=steps ; jmp rsi */
+static const uint8_t VT__JB_PRO[] = {
+    0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57, 0x48, 0x89, 0xfb,
+    0x4c, 0x8b, 0x23, 0x4c, 0x8b, 0x6b, 0x08, 0x4c, 0x8b, 0x7b, 0x10, 0x4c,
+    0x8b, 0x73, 0x18, 0xff, 0xe6};
+/* ctx.sp=r13 ; ctx.steps=r14 ; pop r15-r12,rbx ; ret (eax = insn) */
+static const uint8_t VT__JB_EPI[] = {
+    0x4c, 0x89, 0x6b, 0x08, 0x4c, 0x89, 0x73, 0x18, 0x41, 0x5f, 0x41, 0x5e,
+    0x41, 0x5d, 0x41, 0x5c, 0x5b, 0xc3};
+/* mov eax, t ; jmp epi */
+static const uint8_t VT__JB_EXIT[] = {
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00};
+/* dec r14 (pas rejoué) ; mov eax, i ; jmp epi */
+static const uint8_t VT__JB_DEOPT[] = {
+    0x49, 0xff, 0xce, 0xb8, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00,
+    0x00};
+/* inc r14 */
+static const uint8_t VT__JB_STEP[] = {
+    0x49, 0xff, 0xc6};
+/* cmp r14, [rbx+32] ; jb L ; mov eax, t ; jmp epi */
+static const uint8_t VT__JB_BACK[] = {
+    0x4c, 0x3b, 0x73, 0x20, 0x0f, 0x82, 0x00, 0x00, 0x00, 0x00, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00};
+/* jmp L */
+static const uint8_t VT__JB_JMP[] = {
+    0xe9, 0x00, 0x00, 0x00, 0x00};
+/* lea rsi, [r12+d] */
+static const uint8_t VT__JB_A[] = {
+    0x49, 0x8d, 0xb4, 0x24, 0x00, 0x00, 0x00, 0x00};
+/* lea rdi, [r12+d] */
+static const uint8_t VT__JB_B[] = {
+    0x49, 0x8d, 0xbc, 0x24, 0x00, 0x00, 0x00, 0x00};
+/* lea r8, [r12+d] */
+static const uint8_t VT__JB_D[] = {
+    0x4d, 0x8d, 0x84, 0x24, 0x00, 0x00, 0x00, 0x00};
+/* mov rsi, r13 */
+static const uint8_t VT__JB_S0[] = {
+    0x4c, 0x89, 0xee};
+/* lea rsi, [r13-16] ; mov r8, rsi */
+static const uint8_t VT__JB_S1[] = {
+    0x49, 0x8d, 0x75, 0xf0, 0x49, 0x89, 0xf0};
+/* lea rsi, [r13-32] ; lea rdi, [r13-16] ; mov r8, rsi */
+static const uint8_t VT__JB_S2[] = {
+    0x49, 0x8d, 0x75, 0xe0, 0x49, 0x8d, 0x7d, 0xf0, 0x49, 0x89, 0xf0};
+/* mov r8, r13 */
+static const uint8_t VT__JB_SP[] = {
+    0x4d, 0x89, 0xe8};
+/* add r13, 16 */
+static const uint8_t VT__JB_PUSH[] = {
+    0x49, 0x83, 0xc5, 0x10};
+/* sub r13, n */
+static const uint8_t VT__JB_DROP[] = {
+    0x49, 0x81, 0xed, 0x00, 0x00, 0x00, 0x00};
+/* lea r13, [r12+d] */
+static const uint8_t VT__JB_SETSP[] = {
+    0x4d, 0x8d, 0xac, 0x24, 0x00, 0x00, 0x00, 0x00};
+/* [r8] = [rsi] (movdqu) */
+static const uint8_t VT__JB_COPY[] = {
+    0xf3, 0x0f, 0x6f, 0x06, 0xf3, 0x41, 0x0f, 0x7f, 0x00};
+/* mov rax, k ; [r8] = [rax] */
+static const uint8_t VT__JB_KONST[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf3, 0x0f,
+    0x6f, 0x00, 0xf3, 0x41, 0x0f, 0x7f, 0x00};
+/* mov qword [r8], type ; mov rax, bits ; mov [r8+8], rax */
+static const uint8_t VT__JB_IMM[] = {
+    0x49, 0xc7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0x89, 0x40, 0x08};
+/* [r8] = [r15+d] */
+static const uint8_t VT__JB_GLD[] = {
+    0xf3, 0x41, 0x0f, 0x6f, 0x87, 0x00, 0x00, 0x00, 0x00, 0xf3, 0x41, 0x0f,
+    0x7f, 0x00};
+/* [r15+d] = [rsi] */
+static const uint8_t VT__JB_GST[] = {
+    0xf3, 0x0f, 0x6f, 0x06, 0xf3, 0x41, 0x0f, 0x7f, 0x87, 0x00, 0x00, 0x00,
+    0x00};
+/* échange [r13-16] et [r13-32] */
+static const uint8_t VT__JB_SWAP[] = {
+    0xf3, 0x41, 0x0f, 0x6f, 0x45, 0xf0, 0xf3, 0x41, 0x0f, 0x6f, 0x4d, 0xe0,
+    0xf3, 0x41, 0x0f, 0x7f, 0x45, 0xe0, 0xf3, 0x41, 0x0f, 0x7f, 0x4d, 0xf0};
+/* [r8] = [rsi] + [rdi]: int∘int (add) ou float∘float (addsd) */
+static const uint8_t VT__JB_ADD[] = {
+    0x8b, 0x06, 0x8b, 0x0f, 0x83, 0xf8, 0x02, 0x75, 0x1e, 0x83, 0xf9, 0x02,
+    0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46, 0x08, 0x48, 0x03,
+    0x47, 0x08, 0x49, 0xc7, 0x00, 0x02, 0x00, 0x00, 0x00, 0x49, 0x89, 0x40,
+    0x08, 0xeb, 0x29, 0x83, 0xf8, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+    0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f, 0x10,
+    0x46, 0x08, 0xf2, 0x0f, 0x58, 0x47, 0x08, 0x49, 0xc7, 0x00, 0x03, 0x00,
+    0x00, 0x00, 0xf2, 0x41, 0x0f, 0x11, 0x40, 0x08};
+/* idem, sub / subsd */
+static const uint8_t VT__JB_SUB[] = {
+    0x8b, 0x06, 0x8b, 0x0f, 0x83, 0xf8, 0x02, 0x75, 0x1e, 0x83, 0xf9, 0x02,
+    0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46, 0x08, 0x48, 0x2b,
+    0x47, 0x08, 0x49, 0xc7, 0x00, 0x02, 0x00, 0x00, 0x00, 0x49, 0x89, 0x40,
+    0x08, 0xeb, 0x29, 0x83, 0xf8, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+    0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f, 0x10,
+    0x46, 0x08, 0xf2, 0x0f, 0x5c, 0x47, 0x08, 0x49, 0xc7, 0x00, 0x03, 0x00,
+    0x00, 0x00, 0xf2, 0x41, 0x0f, 0x11, 0x40, 0x08};
+/* idem, imul / mulsd */
+static const uint8_t VT__JB_MUL[] = {
+    0x8b, 0x06, 0x8b, 0x0f, 0x83, 0xf8, 0x02, 0x75, 0x1f, 0x83, 0xf9, 0x02,
+    0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46, 0x08, 0x48, 0x0f,
+    0xaf, 0x47, 0x08, 0x49, 0xc7, 0x00, 0x02, 0x00, 0x00, 0x00, 0x49, 0x89,
+    0x40, 0x08, 0xeb, 0x29, 0x83, 0xf8, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00,
+    0x00, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f,
+    0x10, 0x46, 0x08, 0xf2, 0x0f, 0x59, 0x47, 0x08, 0x49, 0xc7, 0x00, 0x03,
+    0x00, 0x00, 0x00, 0xf2, 0x41, 0x0f, 0x11, 0x40, 0x08};
+/* idem, idiv (diviseur 0 ou -1 → sortie) / divsd */
+static const uint8_t VT__JB_DIV[] = {
+    0x8b, 0x06, 0x8b, 0x0f, 0x83, 0xf8, 0x02, 0x75, 0x36, 0x83, 0xf9, 0x02,
+    0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x4f, 0x08, 0x48, 0x85,
+    0xc9, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xf9, 0xff, 0x0f,
+    0x84, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46, 0x08, 0x48, 0x99, 0x48,
+    0xf7, 0xf9, 0x49, 0xc7, 0x00, 0x02, 0x00, 0x00, 0x00, 0x49, 0x89, 0x40,
+    0x08, 0xeb, 0x29, 0x83, 0xf8, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+    0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f, 0x10,
+    0x46, 0x08, 0xf2, 0x0f, 0x5e, 0x47, 0x08, 0x49, 0xc7, 0x00, 0x03, 0x00,
+    0x00, 0x00, 0xf2, 0x41, 0x0f, 0x11, 0x40, 0x08};
+/* int∘int seulement, idiv → rdx (diviseur 0 ou -1 → sortie) */
+static const uint8_t VT__JB_MOD[] = {
+    0x83, 0x3e, 0x02, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x83, 0x3f, 0x02,
+    0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x4f, 0x08, 0x48, 0x85,
+    0xc9, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xf9, 0xff, 0x0f,
+    0x84, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46, 0x08, 0x48, 0x99, 0x48,
+    0xf7, 0xf9, 0x49, 0xc7, 0x00, 0x02, 0x00, 0x00, 0x00, 0x49, 0x89, 0x50,
+    0x08};
+/* int: [r8] = -[rsi] */
+static const uint8_t VT__JB_NEG[] = {
+    0x83, 0x3e, 0x02, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46,
+    0x08, 0x48, 0xf7, 0xd8, 0x49, 0xc7, 0x00, 0x02, 0x00, 0x00, 0x00, 0x49,
+    0x89, 0x40, 0x08};
+/* int: [r8] = [rsi] + k */
+static const uint8_t VT__JB_ADDI[] = {
+    0x83, 0x3e, 0x02, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x03, 0x46, 0x08, 0x49,
+    0xc7, 0x00, 0x02, 0x00, 0x00, 0x00, 0x49, 0x89, 0x40, 0x08};
+/* int∘int: [r8] = bool(setcc) */
+static const uint8_t VT__JB_CMP[] = {
+    0x83, 0x3e, 0x02, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x83, 0x3f, 0x02,
+    0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46, 0x08, 0x48, 0x3b,
+    0x47, 0x08, 0x0f, 0x9c, 0xc0, 0x0f, 0xb6, 0xc0, 0x49, 0xc7, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x49, 0x89, 0x40, 0x08};
+/* int∘int: rax = [rsi+8] */
+static const uint8_t VT__JB_CMPG[] = {
+    0x83, 0x3e, 0x02, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x83, 0x3f, 0x02,
+    0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x46, 0x08};
+/* cmp rax, [rdi+8] ; jcc L */
+static const uint8_t VT__JB_CMPJ[] = {
+    0x48, 0x3b, 0x47, 0x08, 0x0f, 0x8d, 0x00, 0x00, 0x00, 0x00};
+/* int: cmp qword [rsi+8], k ; jcc L */
+static const uint8_t VT__JB_CMPJI[] = {
+    0x83, 0x3e, 0x02, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48, 0x81, 0x7e,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x8d, 0x00, 0x00, 0x00, 0x00};
+/* type ∈ {BOOL, INT} sinon sortie */
+static const uint8_t VT__JB_TRUTH[] = {
+    0x8b, 0x06, 0x83, 0xe8, 0x01, 0x83, 0xf8, 0x01, 0x0f, 0x87, 0x00, 0x00,
+    0x00, 0x00};
+/* cmp qword [rsi+8], 0 ; je/jne L */
+static const uint8_t VT__JB_TEST[] = {
+    0x48, 0x83, 0x7e, 0x08, 0x00, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00};
+
+/* Offsets des jcc rel32 de garde (→ stub de sortie) dans chaque template. */
+static const uint8_t VT__JX_ADD[] = {14, 44, 53};
+static const uint8_t VT__JX_MUL[] = {14, 45, 54};
+static const uint8_t VT__JX_DIV[] = {14, 27, 37, 68, 77};
+static const uint8_t VT__JX_MOD[] = {5, 14, 27, 37};
+static const uint8_t VT__JX_CMP[] = {5, 14};
+static const uint8_t VT__JX_ONE[] = {5}; /* NEG, ADDI, CMPJI */
+static const uint8_t VT__JX_TRUTH[] = {10};
+
+/* Conditions 0=eq..5=ge: setcc si vrai, jcc si faux (second octet). */
+static const uint8_t VT__JSET[6] = {0x94, 0x95, 0x9c, 0x9e, 0x9f, 0x9d};
+static const uint8_t VT__JNOT[6] = {0x85, 0x84, 0x8d, 0x8f, 0x8e, 0x8c};
+
+#define VT__JNONE 0x80000000u /* off[]: insn non compilée */
+#define VT__JEPI (sizeof VT__JB_PRO)
+
+enum { VT__JF_LABEL = 0, VT__JF_DEOPT, VT__JF_BACK };
+
+typedef struct vt__jfix {
+  uint32_t at;   /* champ rel32 */
+  uint32_t t;    /* LABEL/BACK: insn cible ; DEOPT: insn de reprise */
+  uint32_t kind;
+} vt__jfix;
+
+typedef struct vt__jc {
+  vt_jit_buf b;
+  vt__jfix* fix;
+  size_t nfix, fix_cap;
+  uint32_t cur; /* insn en cours */
+} vt__jc;
+
+static void vt__jfix_add(vt__jc* c, size_t at, uint32_t t, uint32_t kind) {
+  if (c->nfix == c->fix_cap) {
+    size_t ncap = c->fix_cap ? c->fix_cap * 2 : 64;
+    vt__jfix* nf = (vt__jfix*)realloc(c->fix, ncap * sizeof(vt__jfix));
+    if (!nf) {
+      c->b.oom = 1;
+      return;
+    }
+    c->fix = nf;
+    c->fix_cap = ncap;
+  }
+  c->fix[c->nfix++] = (vt__jfix){(uint32_t)at, t, kind};
+}
+
+#define VT__JPUT(N) vt_jit_put(&c->b, VT__JB_##N, sizeof VT__JB_##N)
+#define VT__JGUARD(N, X) \
+  vt__jguard(c, VT__JPUT(N), VT__JX_##X, sizeof VT__JX_##X)
+
+/* Template gardé: chaque jcc listé sort sur l’insn courante. */
+static size_t vt__jguard(vt__jc* c, size_t at, const uint8_t* x, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    vt__jfix_add(c, at + x[i], c->cur, VT__JF_DEOPT);
+  return at;
+}
+
+static void vt__jlea(vt__jc* c, size_t at, uint32_t slot) {
+  vt_jit_set32(&c->b, at + 4, slot * (uint32_t)sizeof(vt_value));
+}
+
+static void vt__jdrop(vt__jc* c, uint32_t n) {
+  vt_jit_set32(&c->b, VT__JPUT(DROP) + 3, n * (uint32_t)sizeof(vt_value));
+}
+
+static void vt__jexit(vt__jc* c, uint32_t t) {
+  size_t at = VT__JPUT(EXIT);
+  vt_jit_set32(&c->b, at + 1, t);
+  vt_jit_rel32(&c->b, at + 6, VT__JEPI);
+}
+
+/* rel32 en at vers l’insn t: direct en avant, via un stub qui teste la
+   step_limit en arrière. */
+static void vt__jbranch(vt__jc* c, size_t at, uint32_t t) {
+  vt__jfix_add(c, at, t, t > c->cur ? VT__JF_LABEL : VT__JF_BACK);
+}
+
+/* Saut conditionnel: second octet du jcc en at, rel32 juste après. */
+static void vt__jcc(vt__jc* c, size_t at, uint8_t cc, uint32_t t) {
+  vt_jit_set8(&c->b, at, cc);
+  vt__jbranch(c, at + 1, t);
+}
+
+static void vt__jimm(vt__jc* c, uint32_t type, int64_t bits) {
+  size_t at = VT__JPUT(IMM);
+  vt_jit_set32(&c->b, at + 3, type);
+  vt_jit_set64(&c->b, at + 9, (uint64_t)bits);
+}
+
+static void vt__jkonst(vt__jc* c, const vt_value* k) {
+  vt_jit_set64(&c->b, VT__JPUT(KONST) + 2, (uint64_t)(uintptr_t)k);
+}
+
+static void vt__jarith(vt__jc* c, uint32_t op) {
+  size_t at;
+  switch (op) {
+    case VT_IR_ADD: VT__JGUARD(ADD, ADD); break;
+    case VT_IR_SUB: VT__JGUARD(SUB, ADD); break;
+    case VT_IR_MUL: VT__JGUARD(MUL, MUL); break;
+    case VT_IR_DIV: VT__JGUARD(DIV, DIV); break;
+    case VT_IR_MOD: VT__JGUARD(MOD, MOD); break;
+    case VT_IR_NEG: VT__JGUARD(NEG, ONE); break;
+    default: /* VT_IR_EQ..VT_IR_GE */
+      at = VT__JGUARD(CMP, CMP);
+      vt_jit_set8(&c->b, at + 27, VT__JSET[op - VT_IR_EQ]);
+      break;
+  }
+}
+
+/* Émet l’insn p (index i). 0 si elle n’est pas supportée (rien émis). */
+static int vt__jinsn(vt__jc* c, const vt__pinsn* p, uint32_t i) {
+  size_t at;
+  c->cur = i;
+  if (p->op >= OP__COUNT) goto regs;
+  switch ((vt_opcode)p->op) {
+    case OP_NOP: VT__JPUT(STEP); return 1;
+    case OP_ICONST:
+    case OP_FCONST:
+      VT__JPUT(STEP);
+      VT__JPUT(SP);
+      vt__jimm(c, p->op == OP_ICONST ? VT_INT : VT_FLOAT, p->x.i);
+      VT__JPUT(PUSH);
+      return 1;
+    case OP_SCONST:
+    case OP_LOADK:
+      VT__JPUT(STEP);
+      VT__JPUT(SP);
+      vt__jkonst(c, p->x.k);
+      VT__JPUT(PUSH);
+      return 1;
+    case OP_LD:
+      VT__JPUT(STEP);
+      VT__JPUT(SP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      VT__JPUT(COPY);
+      VT__JPUT(PUSH);
+      return 1;
+    case OP_ST:
+      VT__JPUT(STEP);
+      vt__jdrop(c, 1);
+      VT__JPUT(S0);
+      vt__jlea(c, VT__JPUT(D), p->a);
+      VT__JPUT(COPY);
+      return 1;
+    case OP_LDG:
+      VT__JPUT(STEP);
+      VT__JPUT(SP);
+      vt_jit_set32(&c->b, VT__JPUT(GLD) + 5, p->a * (uint32_t)sizeof(vt_value));
+      VT__JPUT(PUSH);
+      return 1;
+    case OP_STG:
+      VT__JPUT(STEP);
+      vt__jdrop(c, 1);
+      VT__JPUT(S0);
+      vt_jit_set32(&c->b, VT__JPUT(GST) + 9, p->a * (uint32_t)sizeof(vt_value));
+      return 1;
+    case OP_POP:
+      VT__JPUT(STEP);
+      vt__jdrop(c, p->a);
+      return 1;
+    case OP_DUP:
+      VT__JPUT(STEP);
+      VT__JPUT(S1);
+      VT__JPUT(SP);
+      VT__JPUT(COPY);
+      VT__JPUT(PUSH);
+      return 1;
+    case OP_SWAP:
+      VT__JPUT(STEP);
+      VT__JPUT(SWAP);
+      return 1;
+    case OP_ADD:
+    case OP_SUB:
+    case OP_MUL:
+    case OP_DIV:
+    case OP_MOD:
+      VT__JPUT(STEP);
+      VT__JPUT(S2);
+      vt__jarith(c, VT_IR_ADD + (uint32_t)(p->op - OP_ADD));
+      vt__jdrop(c, 1);
+      return 1;
+    case OP_NEG:
+      VT__JPUT(STEP);
+      VT__JPUT(S1);
+      vt__jarith(c, VT_IR_NEG);
+      return 1;
+    case OP_EQ:
+    case OP_NE:
+    case OP_LT:
+    case OP_LE:
+    case OP_GT:
+    case OP_GE:
+      VT__JPUT(STEP);
+      VT__JPUT(S2);
+      vt__jarith(c, VT_IR_EQ + (uint32_t)(p->op - OP_EQ));
+      vt__jdrop(c, 1);
+      return 1;
+    case OP_JMP: goto jmp;
+    case OP_JT:
+    case OP_JF:
+      VT__JPUT(STEP);
+      VT__JPUT(S1);
+      VT__JGUARD(TRUTH, TRUTH);
+      vt__jdrop(c, 1);
+      vt__jcc(c, VT__JPUT(TEST) + 6, p->op == OP_JT ? 0x85 : 0x84, p->x.j.t);
+      return 1;
+    case OP_LD_ADDI_ST:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      vt__jlea(c, VT__JPUT(D), p->d);
+      at = VT__JGUARD(ADDI, ONE);
+      vt_jit_set64(&c->b, at + 11, (uint64_t)p->x.i);
+      return 1;
+    case OP_CMP_JF:
+      VT__JPUT(STEP);
+      VT__JPUT(S2);
+      VT__JGUARD(CMPG, CMP);
+      vt__jdrop(c, 2);
+      vt__jcc(c, VT__JPUT(CMPJ) + 5, VT__JNOT[p->c], p->x.j.t);
+      return 1;
+    default: return 0;
+  }
+
+regs:
+  switch (p->op) {
+    case VT__R_MOV:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      vt__jlea(c, VT__JPUT(D), p->d);
+      VT__JPUT(COPY);
+      return 1;
+    case VT__R_LOADI:
+    case VT__R_LOADF:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(D), p->d);
+      vt__jimm(c, p->op == VT__R_LOADI ? VT_INT : VT_FLOAT, p->x.i);
+      return 1;
+    case VT__R_LOADK:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(D), p->d);
+      vt__jkonst(c, p->x.k);
+      return 1;
+    case VT__R_LDG:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(D), p->d);
+      vt_jit_set32(&c->b, VT__JPUT(GLD) + 5, p->b * (uint32_t)sizeof(vt_value));
+      return 1;
+    case VT__R_STG:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      vt_jit_set32(&c->b, VT__JPUT(GST) + 9, p->b * (uint32_t)sizeof(vt_value));
+      return 1;
+    case VT__R_ADD:
+    case VT__R_SUB:
+    case VT__R_MUL:
+    case VT__R_DIV:
+    case VT__R_MOD:
+    case VT__R_EQ:
+    case VT__R_NE:
+    case VT__R_LT:
+    case VT__R_LE:
+    case VT__R_GT:
+    case VT__R_GE:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      vt__jlea(c, VT__JPUT(B), p->b);
+      vt__jlea(c, VT__JPUT(D), p->d);
+      vt__jarith(c, (uint32_t)(p->op - OP__COUNT));
+      return 1;
+    case VT__R_NEG:
+    case VT__R_ADDI:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      vt__jlea(c, VT__JPUT(D), p->d);
+      if (p->op == VT__R_NEG) {
+        vt__jarith(c, VT_IR_NEG);
+      } else {
+        at = VT__JGUARD(ADDI, ONE);
+        vt_jit_set64(&c->b, at + 11, (uint64_t)p->x.i);
+      }
+      return 1;
+    case VT__R_JMP: goto jmp;
+    case VT__R_JT:
+    case VT__R_JF:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      VT__JGUARD(TRUTH, TRUTH);
+      vt__jcc(c, VT__JPUT(TEST) + 6, p->op == VT__R_JT ? 0x85 : 0x84,
+              p->x.j.t);
+      return 1;
+    case VT__R_CMPJF:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      vt__jlea(c, VT__JPUT(B), p->b);
+      VT__JGUARD(CMPG, CMP);
+      vt__jcc(c, VT__JPUT(CMPJ) + 5, VT__JNOT[p->c], p->x.j.t);
+      return 1;
+    case VT__R_CMPJFI:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(A), p->a);
+      at = VT__JGUARD(CMPJI, ONE);
+      vt_jit_set32(&c->b, at + 13, (uint32_t)p->x.j.k);
+      vt__jcc(c, at + 18, VT__JNOT[p->c], p->x.j.t);
+      return 1;
+    case VT__R_SETSP:
+      VT__JPUT(STEP);
+      vt__jlea(c, VT__JPUT(SETSP), p->a);
+      return 1;
+    default: return 0;
+  }
+
+jmp:
+  VT__JPUT(STEP);
+  if (p->x.j.t > i) {
+    vt__jbranch(c, VT__JPUT(JMP) + 1, p->x.j.t);
+  } else {
+    at = VT__JPUT(BACK);
+    vt__jfix_add(c, at + 6, p->x.j.t, VT__JF_LABEL);
+    vt_jit_set32(&c->b, at + 11, p->x.j.t);
+    vt_jit_rel32(&c->b, at + 16, VT__JEPI);
+  }
+  return 1;
+}
+#undef VT__JGUARD
+#undef VT__JPUT
+
+static void vt__jfn_free(vt__jfn* jf) {
+  vt_jit_release(&jf->code);
+  free(jf->off);
+  jf->off = NULL;
+}
+
+/* Compile la fonction fi de vm->prog dans vm->jit[fi]. */
+static int vt__jit_compile(vt_vm* vm, uint32_t fi) {
+  const vt__vfunc* f = &vm->prog->funcs[fi];
+  const vt__pinsn* code = vm->prog->insns;
+  vt__jfn* jf = &vm->jit[fi];
+  uint32_t n = f->end - f->entry;
+  vt__jc c;
+  memset(&c, 0, sizeof c);
+  vt_jit_buf_init(&c.b);
+  jf->off = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+  if (!jf->off) return -ENOMEM;
+  vt_jit_put(&c.b, VT__JB_PRO, sizeof VT__JB_PRO);
+  vt_jit_put(&c.b, VT__JB_EPI, sizeof VT__JB_EPI);
+  for (uint32_t k = 0; k < n; k++) {
+    jf->off[k] = (uint32_t)c.b.len;
+    if (!vt__jinsn(&c, &code[f->entry + k], f->entry + k)) {
+      vt__jexit(&c, f->entry + k);
+      jf->off[k] |= VT__JNONE;
+    }
+  }
+  vt__jexit(&c, f->end); /* inatteignable: le code vérifié ne déborde pas */
+  /* Stubs hors ligne, puis résolution des sauts. Les sorties DEOPT d’une
+     même insn partagent un stub (fixups émis dans l’ordre des insns). */
+  size_t nfix = c.nfix, deopt = 0;
+  uint32_t deopt_t = UINT32_MAX;
+  for (size_t k = 0; k < nfix; k++) {
+    const vt__jfix fx = c.fix[k];
+    size_t to = jf->off[fx.t - f->entry] & ~VT__JNONE;
+    if (fx.kind == VT__JF_DEOPT) {
+      if (fx.t != deopt_t) {
+        deopt = vt_jit_put(&c.b, VT__JB_DEOPT, sizeof VT__JB_DEOPT);
+        vt_jit_set32(&c.b, deopt + 4, fx.t);
+        vt_jit_rel32(&c.b, deopt + 9, VT__JEPI);
+        deopt_t = fx.t;
+      }
+      to = deopt;
+    } else if (fx.kind == VT__JF_BACK) {
+      size_t at = vt_jit_put(&c.b, VT__JB_BACK, sizeof VT__JB_BACK);
+      vt_jit_rel32(&c.b, at + 6, to);
+      vt_jit_set32(&c.b, at + 11, fx.t);
+      vt_jit_rel32(&c.b, at + 16, VT__JEPI);
+      to = at;
+    }
+    vt_jit_rel32(&c.b, fx.at, to);
+  }
+  int rc = vt_jit_seal(&c.b, &jf->code);
+  vt_jit_buf_free(&c.b);
+  free(c.fix);
+  if (rc != 0) vt__jfn_free(jf);
+  return rc;
+}
+
+/* Entrée native à l’insn at de la fonction du frame courant (saut arrière
+   ou entrée de fonction); compile la fonction au cfg.jit_hot-ième passage.
+   Renvoie l’insn où reprendre, UINT32_MAX si rien n’a été exécuté. */
+static uint32_t vt__jit_enter(vt_vm* vm, uint32_t at, vt__jctx* ctx) {
+  uint32_t fi = vm->frames[vm->nframes - 1].fn;
+  vt__jfn* jf = &vm->jit[fi];
+  if (!jf->code.mem) {
+    /* hot reste à jit_hot après un échec: pas de nouvel essai */
+    if (jf->hot >= vm->cfg.jit_hot || ++jf->hot < vm->cfg.jit_hot)
+      return UINT32_MAX;
+    if (vt__jit_compile(vm, fi) != 0) return UINT32_MAX;
+  }
+  uint32_t off = jf->off[at - vm->prog->funcs[fi].entry];
+  if ((off & VT__JNONE) || ctx->steps >= ctx->limit) return UINT32_MAX;
+  vt__jentry fn = (vt__jentry)(uintptr_t)jf->code.mem;
+  return fn(ctx, (const uint8_t*)jf->code.mem + off);
+}
+
+static void vt__jit_free(vt_vm* vm) {
+  for (size_t i = 0; vm->jit && i < vm->njit; i++) vt__jfn_free(&vm->jit[i]);
+  free(vm->jit);
+  vm->jit = NULL;
+  vm->njit = 0;
+}
+#endif /* VT_VM_JIT */
+
+/* -------------------------------------------------------------------------- */
+/* Programme pré-décodé                                                       */
+/* -------------------------------------------------------------------------- */
+static void vt__prog_free(void* p) {
+  vt__vprog* pg = (vt__vprog*)p;
+  if (!pg) return;
+  for (size_t i = 0; i < pg->nconsts; i++)
+    if (vt__is_heap(&pg->consts[i])) free(vt_as_ptr(&pg->consts[i]));
+  free(pg->consts);
+  free(pg->funcs);
+  free(pg->insns);
+  free(pg->rlive);
+  free(pg);
+}
+
+static void vt__unload(vt_vm* vm) {
+#if VT_VM_JIT
+  vt__jit_free(vm);
+#endif
+  free(vm->ic);
+  vm->ic = NULL;
+  vt__prog_free(vm->prog_own);
+  vm->prog_own = NULL;
+  if (vm->img) vt_img_release(vm->img); /* libère aussi le cache d’image */
+  vm->img = NULL;
+  vm->prog = NULL;
+  vm->sp = vm->ip = 0;
+  vm->nframes = vm->nhandlers = 0;
+  vm->status = VT__IDLE;
+  vm->steps = 0;
+}
+
+static int vt__ensure_globals(vt_vm* vm, size_t need) {
+  if (need <= vm->nglobals) return 0;
+  vt_value* g = (vt_value*)realloc(vm->globals, need * sizeof(vt_value));
+  if (!g) return -ENOMEM;
+  for (size_t i = vm->nglobals; i < need; i++) g[i] = vt_nil();
+  vm->globals = g;
+  vm->nglobals = need;
+  return 0;
+}
+
+static int vt__ensure_stack(vt_vm* vm, size_t need) {
+  if (need <= vm->stack_cap) return 0;
+  size_t cap = vm->stack_cap ? vm->stack_cap : 256;
+  while (cap < need) cap *= 2;
+  vt_value* s = (vt_value*)realloc(vm->stack, cap * sizeof(vt_value));
+  if (!s) return -ENOMEM;
+  vm->stack = s;
+  vm->stack_cap = cap;
+  return 0;
+}
+
+/* FUNC → pg->funcs. entry/end reçoivent des offsets octets, convertis en
+   index d’insn par vt__predecode. */
+static int vt__parse_funcs(vt_vm* vm, vt__vprog* pg, const uint8_t* p,
+                           size_t n, size_t code_len) {
+  if (n < 4) return vt__fail(vm, -ENOEXEC, "FUNC: section tronquée");
+  uint32_t cnt = vt__u32(p);
+  if (cnt == 0 || (n - 4) / 12 < cnt)
+    return vt__fail(vm, -ENOEXEC, "FUNC: %u entrées invalides", cnt);
+  pg->funcs = (vt__vfunc*)calloc(cnt, sizeof(vt__vfunc));
+  if (!pg->funcs) return -ENOMEM;
+  pg->nfuncs = cnt;
+  for (uint32_t i = 0; i < cnt; i++) {
+    const uint8_t* e = p + 4 + (size_t)i * 12;
+    vt__vfunc* f = &pg->funcs[i];
+    uint32_t off = vt__u32(e), len = vt__u32(e + 4);
+    f->nparams = vt__u16(e + 8);
+    f->nlocals = vt__u16(e + 10);
+    if ((size_t)off > code_len || (size_t)len > code_len - off || !len)
+      return vt__fail(vm, -ENOEXEC, "FUNC #%u: plage CODE invalide", i);
+    if (f->nlocals < f->nparams)
+      return vt__fail(vm, -ENOEXEC, "FUNC #%u: nlocals < nparams", i);
+    f->entry = off;
+    f->end = off + len;
+  }
+  return 0;
+}
+
+static vt__vstr* vt__str_perm(const char* s, size_t n) {
+  vt__vstr* o = (vt__vstr*)malloc(sizeof(vt__vstr) + n + 1);
+  if (!o) return NULL;
+  o->perm = 1;
+  o->len = n;
+  if (n) memcpy(o->data, s, n);
+  vt__str_seal(o);
+  return o;
+}
+
+static int vt__parse_consts(vt_vm* vm, vt__vprog* pg, const uint8_t* p,
+                            size_t n) {
+  if (!p || n == 0) return 0;
+  if (n < 4) return vt__fail(vm, -ENOEXEC, "KCON: section tronquée");
+  uint32_t cnt = vt__u32(p);
+  if (cnt > n - 4) return vt__fail(vm, -ENOEXEC, "KCON: compte invalide");
+  pg->consts = (vt_value*)calloc(cnt ? cnt : 1, sizeof(vt_value));
+  if (!pg->consts) return -ENOMEM;
+  size_t off = 4;
+  for (uint32_t i = 0; i < cnt; i++) {
+    if (off >= n) return vt__fail(vm, -ENOEXEC, "KCON #%u: tronqué", i);
+    uint8_t tag = p[off++];
+    size_t left = n - off;
+    vt_value v = vt_nil();
+    switch (tag) {
+      case VT_NIL: break;
+      case VT_BOOL:
+        if (left < 1) goto trunc;
+        v = vt_bool(p[off]);
+        off += 1;
+        break;
+      case VT_INT:
+        if (left < 8) goto trunc;
+        v = vt_int((int64_t)vt__u64(p + off));
+        off += 8;
+        break;
+      case VT_FLOAT:
+        if (left < 8) goto trunc;
+        v = vt_float(vt__f64(p + off));
+        off += 8;
+        break;
+      case VT_STR: {
+        if (left < 4) goto trunc;
+        uint32_t len = vt__u32(p + off);
+        if (len > left - 4) goto trunc;
+        vt__vstr* s = vt__str_perm((const char*)p + off + 4, len);
+        if (!s) return -ENOMEM;
+        v = vt_obj(VT_STR, s);
+        off += 4 + (size_t)len;
+      } break;
+      case VT_FUNC: {
+        if (left < 4) goto trunc;
+        uint32_t fi = vt__u32(p + off);
+        if (fi >= pg->nfuncs)
+          return vt__fail(vm, -ENOEXEC, "KCON #%u: fonction %u inconnue", i, fi);
+        vt__vclo* c = (vt__vclo*)calloc(1, sizeof(vt__vclo));
+        if (!c) return -ENOMEM;
+        c->perm = 1;
+        c->id = fi;
+        c->fn = fi;
+        v = vt_obj(VT_FUNC, c);
+        off += 4;
+      } break;
+      default:
+        return vt__fail(vm, -ENOEXEC, "KCON #%u: tag %u non supporté", i, tag);
+    }
+    pg->consts[i] = v;
+    pg->nconsts = i + 1; /* libéré par vt__prog_free en cas d’échec */
+  }
+  return 0;
+trunc:
+  return vt__fail(vm, -ENOEXEC, "KCON: entrée tronquée");
+}
+
+static int vt__is_jump(uint8_t op) {
+  return op == OP_JMP || op == OP_JT || op == OP_JF || op == OP_CMP_JF ||
+         op == OP_TENTER;
+}
+
+/* Remplit pi depuis une insn décodée (sauf la cible de saut, laissée au
+   chargeur). Contrôle les constantes. off: position pour les messages. */
+static int vt__pinsn_set(vt_vm* vm, vt__vprog* pg, const vt_insn* in,
+                         vt__pinsn* pi, size_t off) {
+  memset(pi, 0, sizeof *pi);
+  pi->op = (uint8_t)in->op;
+  switch (in->op) {
+    case OP_ICONST:
+      pi->x.i = (int64_t)in->imm[0];
+      break;
+    case OP_FCONST:
+      memcpy(&pi->x.f, &in->imm[0], sizeof(double));
+      break;
+    case OP_SCONST:
+    case OP_LOADK:
+    case OP_CLOSURE: {
+      if (in->imm[0] >= pg->nconsts)
+        return vt__fail(vm, -ENOEXEC, "constante %u inconnue @0x%zx",
+                        (unsigned)in->imm[0], off);
+      const vt_value* k = &pg->consts[in->imm[0]];
+      if ((in->op == OP_SCONST && vt_value_type(k) != VT_STR) ||
+          (in->op == OP_CLOSURE && vt_value_type(k) != VT_FUNC))
+        return vt__fail(vm, -ENOEXEC, "%s: constante de type %s @0x%zx",
+                        vt_op_info(in->op)->name,
+                        VT__TNAMES[vt_value_type(k)], off);
+      pi->x.k = k;
+      pi->c = (uint8_t)in->imm[1];
+    } break;
+    case OP_CALL:
+      pi->a = (uint16_t)in->imm[0];
+      pi->c = (uint8_t)in->imm[1];
+      break;
+    case OP_CMP_JF:
+      if (in->imm[1] > 5)
+        return vt__fail(vm, -ENOEXEC, "cmp_jf: condition %u @0x%zx",
+                        (unsigned)in->imm[1], off);
+      pi->c = (uint8_t)in->imm[1];
+      break;
+    case OP_JMP:
+    case OP_JT:
+    case OP_JF:
+    case OP_TENTER:
+      break;
+    case OP_LDG:
+    case OP_STG:
+      if (in->imm[0] + 1 > pg->nglobals) pg->nglobals = (size_t)in->imm[0] + 1;
+      pi->a = (uint16_t)in->imm[0];
+      break;
+    case OP_LD_ADDI_ST:
+      pi->a = (uint16_t)in->imm[0];
+      pi->x.i = (int64_t)in->imm[1];
+      pi->d = (uint16_t)in->imm[2];
+      break;
+    default:
+      if (vt_op_info(in->op)->argc) pi->a = (uint16_t)in->imm[0];
+      break;
+  }
+  return 0;
+}
+
+/* CODE → pg->insns en une passe linéaire. Les cibles de saut et les bornes
+   de fonctions doivent tomber sur un début d’instruction (ce que vt_verify
+   contrôlait par rebalayage). */
+static int vt__predecode(vt_vm* vm, vt__vprog* pg, const uint8_t* code,
+                         size_t len) {
+  if (len > UINT32_MAX) return vt__fail(vm, -EFBIG, "CODE: trop volumineux");
+  uint32_t* map = (uint32_t*)malloc((len + 1) * sizeof(uint32_t));
+  pg->insns = (vt__pinsn*)malloc(len * sizeof(vt__pinsn));
+  if (!map || !pg->insns) {
+    free(map);
+    return -ENOMEM;
+  }
+  for (size_t i = 0; i <= len; i++) map[i] = UINT32_MAX;
+
+  int rc = 0;
+  size_t off = 0, n = 0;
+  while (off < len) {
+    vt_insn in;
+    size_t got = vt_decode(code + off, len - off, &in);
+    if (!got) {
+      rc = vt__fail(vm, -ENOEXEC, "CODE: décodage @0x%zx", off);
+      goto out;
+    }
+    map[off] = (uint32_t)n;
+    vt__pinsn* pi = &pg->insns[n++];
+    rc = vt__pinsn_set(vm, pg, &in, pi, off);
+    if (rc != 0) goto out;
+    if (vt__is_jump(pi->op)) {
+      int64_t tgt = (int64_t)(off + got) + (int64_t)(int32_t)in.imm[0];
+      if (tgt < 0 || (uint64_t)tgt >= len) {
+        rc = vt__fail(vm, -ENOEXEC, "saut hors CODE @0x%zx", off);
+        goto out;
+      }
+      pi->x.j.t = (uint32_t)tgt; /* offset octet, résolu plus bas */
+    }
+    off += got;
+  }
+  map[len] = (uint32_t)n;
+  pg->ninsns = n;
+
+  for (size_t i = 0; i < n; i++) {
+    vt__pinsn* pi = &pg->insns[i];
+    if (!vt__is_jump(pi->op)) continue;
+    if (map[pi->x.j.t] == UINT32_MAX) {
+      rc = vt__fail(vm, -ENOEXEC, "cible 0x%x non alignée", pi->x.j.t);
+      goto out;
+    }
+    pi->x.j.t = map[pi->x.j.t];
+  }
+  for (size_t i = 0; i < pg->nfuncs; i++) {
+    vt__vfunc* f = &pg->funcs[i];
+    if (map[f->entry] == UINT32_MAX || map[f->end] == UINT32_MAX) {
+      rc = vt__fail(vm, -ENOEXEC, "FUNC #%zu: bornes non alignées", i);
+      goto out;
+    }
+    f->entry = map[f->entry];
+    f->end = map[f->end];
+  }
+  vt__pinsn* shrunk =
+      (vt__pinsn*)realloc(pg->insns, (n ? n : 1) * sizeof(vt__pinsn));
+  if (shrunk) pg->insns = shrunk;
+
+out:
+  free(map);
+  return rc;
+}
+
+/* Effets de pile exacts d’une instruction pré-décodée. */
+static void vt__stack_effect(const vt__pinsn* pi, int* pop, int* push) {
+  switch (pi->op) {
+    case OP_POP: *pop = pi->a; *push = 0; return;
+    case OP_NEWA: *pop = pi->a; *push = 1; return;
+    case OP_NEWM: *pop = 2 * pi->a; *push = 1; return;
+    case OP_CALL: *pop = pi->a + 1; *push = pi->c; return;
+    case OP_RET: *pop = pi->a; *push = 0; return;
+    case OP_CLOSURE: *pop = pi->c; *push = 1; return;
+    default: {
+      const vt_opcode_info* ii = vt_op_info((vt_opcode)pi->op);
+      *pop = ii->stack_in;
+      *push = ii->stack_out;
+      return;
+    }
+  }
+}
+
+/* Vérifie une fonction: opérandes, cibles internes, profondeur de pile
+   cohérente sur tous les chemins (flot de données). */
+static int vt__verify_func(vt_vm* vm, vt__vprog* pg, uint32_t fi) {
+  vt__vfunc* f = &pg->funcs[fi];
+  const vt__pinsn* code = pg->insns + f->entry;
+  size_t len = f->end - f->entry;
+  if (!len) return vt__fail(vm, -ENOEXEC, "func #%u: vide", fi);
+  int32_t* depth = (int32_t*)malloc(len * sizeof(int32_t));
+  size_t* work = (size_t*)malloc((len + 1) * sizeof(size_t));
+  if (!depth || !work) {
+    free(depth);
+    free(work);
+    return -ENOMEM;
+  }
+  for (size_t i = 0; i < len; i++) depth[i] = -1;
+  size_t nw = 0;
+  int rc = 0, mx = 0;
+  depth[0] = 0;
+  work[nw++] = 0;
+
+#define VT__VFAIL(...)                          \
+  do {                                          \
+    rc = vt__fail(vm, -ENOEXEC, __VA_ARGS__);   \
+    goto out;                                   \
+  } while (0)
+#define VT__FLOW(TGT, D)                                                   \
+  do {                                                                     \
+    size_t t_ = (TGT);                                                     \
+    if (t_ >= len) VT__VFAIL("func #%u: sortie de plage @%zu", fi, at);    \
+    if (depth[t_] < 0) {                                                   \
+      depth[t_] = (D);                                                     \
+      work[nw++] = t_;                                                     \
+    } else if (depth[t_] != (D)) {                                         \
+      VT__VFAIL("func #%u: profondeur incohérente @%zu", fi, t_);          \
+    }                                                                      \
+  } while (0)
+
+  while (nw) {
+    size_t at = work[--nw];
+    const vt__pinsn* pi = &code[at];
+    const vt_opcode_info* ii = vt_op_info((vt_opcode)pi->op);
+    int d = depth[at], pop = 0, push = 0;
+    vt__stack_effect(pi, &pop, &push);
+    if (pop < 0 || d < pop) VT__VFAIL("func #%u: sous-pile @%zu", fi, at);
+    int nd = d - pop + push;
+    if (nd > mx) mx = nd;
+
+    if ((pi->op == OP_LD || pi->op == OP_ST || pi->op == OP_CAPTURE) &&
+        pi->a >= f->nlocals)
+      VT__VFAIL("func #%u: slot %u hors locaux @%zu", fi, pi->a, at);
+    if (pi->op == OP_LD_ADDI_ST && (pi->a >= f->nlocals || pi->d >= f->nlocals))
+      VT__VFAIL("func #%u: slot hors locaux @%zu", fi, at);
+
+    if (vt__is_jump(pi->op)) {
+      if (pi->x.j.t < f->entry)
+        VT__VFAIL("func #%u: cible hors fonction @%zu", fi, at);
+      size_t tgt = pi->x.j.t - f->entry;
+      if (pi->op == OP_TENTER) {
+        VT__FLOW(tgt, nd + 1);
+        if (nd + 1 > mx) mx = nd + 1;
+      } else {
+        VT__FLOW(tgt, nd);
+        if (pi->op == OP_JMP) continue;
+      }
+    }
+    if (ii->flags & VT_OF_TERM) continue;
+    VT__FLOW(at + 1, nd);
+  }
+  f->max_stack = (uint32_t)mx;
+
+out:
+#undef VT__FLOW
+#undef VT__VFAIL
+  free(depth);
+  free(work);
+  return rc;
+}
+
+/* Applique vt_fuse sur une copie de CODE et reporte les bornes de fonctions
+   (encore en octets). *fused reste NULL si rien n’a été fusionné ou si le
+   code est invalide (le pré-décodage de l’original produira l’erreur). */
+static int vt__fuse(vt_vm* vm, vt__vprog* pg, const uint8_t* code, size_t len,
+                    vt_bcode* fused) {
+  uint32_t* remap = (uint32_t*)malloc((len + 1) * sizeof(uint32_t));
+  vt_bcode bc = {(uint8_t*)malloc(len), len, len};
+  if (!remap || !bc.data) {
+    free(remap);
+    vt_bcode_free(&bc);
+    return -ENOMEM;
+  }
+  memcpy(bc.data, code, len);
+  int rc = 0, nf = vt_fuse(&bc, remap);
+  if (nf > 0) {
+    for (size_t i = 0; i < pg->nfuncs; i++) {
+      vt__vfunc* f = &pg->funcs[i];
+      if (remap[f->entry] == UINT32_MAX || remap[f->end] == UINT32_MAX) {
+        rc = vt__fail(vm, -ENOEXEC, "FUNC #%zu: bornes non alignées", i);
+        break;
+      }
+      f->entry = remap[f->entry];
+      f->end = remap[f->end];
+    }
+  }
+  free(remap);
+  if (rc == 0 && nf > 0) *fused = bc;
+  else vt_bcode_free(&bc);
+  return rc;
+}
+
+/* Forme registres d’une fonction: une insn par insn IR à partir de base
+   (out/live). VT_IR_STK redevient l’insn pile d’origine. */
+static int vt__emit_ir(vt_vm* vm, vt__vprog* pg, const vt_ir* ir,
+                       uint32_t base, vt__pinsn* out, uint16_t* live) {
+  for (size_t i = 0; i < ir->len; i++) {
+    const vt_ir_insn* r = &ir->code[i];
+    vt__pinsn* pi = &out[i];
+    live[i] = r->live;
+    if (r->op == VT_IR_STK) {
+      vt_insn in = {(vt_opcode)r->sop, {(uint64_t)r->k, r->k2, 0}, 0};
+      int rc = vt__pinsn_set(vm, pg, &in, pi, i);
+      if (rc != 0) return rc;
+      if (vt__is_jump(pi->op)) pi->x.j.t = base + r->t;
+      continue;
+    }
+    memset(pi, 0, sizeof *pi);
+    pi->op = (uint8_t)(OP__COUNT + r->op);
+    pi->c = r->cond;
+    pi->a = r->a;
+    pi->b = r->b;
+    pi->d = r->d;
+    switch (r->op) {
+      case VT_IR_LOADF:
+        memcpy(&pi->x.f, &r->k, sizeof(double));
+        break;
+      case VT_IR_LOADK:
+        if ((uint64_t)r->k >= pg->nconsts)
+          return vt__fail(vm, -ENOEXEC, "constante %lld inconnue",
+                          (long long)r->k);
+        pi->x.k = &pg->consts[r->k];
+        break;
+      case VT_IR_LDG:
+      case VT_IR_STG:
+        pi->b = (uint16_t)r->k;
+        break;
+      case VT_IR_JMP:
+      case VT_IR_JT:
+      case VT_IR_JF:
+      case VT_IR_CMPJF:
+        pi->x.j.t = base + r->t;
+        break;
+      case VT_IR_CMPJFI:
+        pi->x.j.t = base + r->t;
+        pi->x.j.k = (int32_t)r->k;
+        break;
+      default:
+        pi->x.i = r->k;
+        break;
+    }
+  }
+  return 0;
+}
+
+/* Remplace pg->insns (vérifié, forme pile) par la forme registres.
+   ranges[2i], ranges[2i+1]: bornes octets de la fonction i dans code.
+   Une fonction refusée par vt_ir_lower (trop de registres) reste en forme
+   pile: les frames ont la même disposition dans les deux formes. */
+static int vt__regs(vt_vm* vm, vt__vprog* pg, const uint8_t* code,
+                    const uint32_t* ranges) {
+  vt_ir* irs = (vt_ir*)calloc(pg->nfuncs, sizeof(vt_ir));
+  if (!irs) return -ENOMEM;
+  vt__pinsn* insns = NULL;
+  uint16_t* live = NULL;
+  size_t total = 0;
+  int rc = 0;
+  for (size_t i = 0; i < pg->nfuncs; i++) {
+    const vt__vfunc* f = &pg->funcs[i];
+    vt_ir_init(&irs[i]);
+    rc = vt_ir_lower(code + ranges[2 * i], ranges[2 * i + 1] - ranges[2 * i],
+                     f->nlocals, &irs[i], NULL, 0);
+    if (rc == -ENOMEM) goto out;
+    rc = 0;
+    total += irs[i].len ? irs[i].len : (size_t)(f->end - f->entry);
+  }
+  if (total > UINT32_MAX) {
+    rc = vt__fail(vm, -EFBIG, "CODE: trop volumineux");
+    goto out;
+  }
+  insns = (vt__pinsn*)malloc((total ? total : 1) * sizeof(vt__pinsn));
+  live = (uint16_t*)calloc(total ? total : 1, sizeof(uint16_t));
+  if (!insns || !live) {
+    rc = -ENOMEM;
+    goto out;
+  }
+  uint32_t pos = 0;
+  for (size_t i = 0; i < pg->nfuncs; i++) {
+    vt__vfunc* f = &pg->funcs[i];
+    if (irs[i].len) {
+      rc = vt__emit_ir(vm, pg, &irs[i], pos, insns + pos, live + pos);
+      if (rc != 0) goto out;
+      if (irs[i].max_stack > f->max_stack) f->max_stack = irs[i].max_stack;
+      f->entry = pos;
+      pos += (uint32_t)irs[i].len;
+    } else {
+      uint32_t n = f->end - f->entry;
+      memcpy(insns + pos, pg->insns + f->entry, n * sizeof(vt__pinsn));
+      for (uint32_t k = 0; k < n; k++)
+        if (vt__is_jump(insns[pos + k].op))
+          insns[pos + k].x.j.t = insns[pos + k].x.j.t - f->entry + pos;
+      f->entry = pos;
+      pos += n;
+    }
+    f->end = pos;
+  }
+  free(pg->insns);
+  pg->insns = insns;
+  pg->ninsns = total;
+  pg->rlive = live;
+  insns = NULL;
+  live = NULL;
+
+out:
+  for (size_t i = 0; i < pg->nfuncs; i++) vt_ir_free(&irs[i]);
+  free(irs);
+  free(insns);
+  free(live);
+  return rc;
+}
+
+/* Numérote les sites à cache en ligne, une fois la forme finale fixée. */
+static void vt__ic_number(vt__vprog* pg) {
+  pg->nic = 0;
+  for (size_t i = 0; i < pg->ninsns; i++) {
+    vt__pinsn* pi = &pg->insns[i];
+    if (pi->op == OP_MGET || pi->op == OP_MSET || pi->op == OP_CALL)
+      pi->x.ic = pg->nic++;
+  }
+}
+
+/* Construit un programme depuis les sections brutes. fsec=NULL: une seule
+   fonction d’entrée couvrant tout CODE avec nlocals locaux. */
+static int vt__prog_build(vt_vm* vm, const uint8_t* code, size_t len,
+                          const uint8_t* fsec, size_t fsz,
+                          const uint8_t* ksec, size_t ksz, uint16_t nlocals,
+                          vt__vprog** out) {
+  vt_bcode fused;
+  vt_bcode_init(&fused);
+  vt__vprog* pg = (vt__vprog*)calloc(1, sizeof *pg);
+  if (!pg) return -ENOMEM;
+  int rc = 0;
+  if (fsec) {
+    rc = vt__parse_funcs(vm, pg, fsec, fsz, len);
+  } else {
+    pg->funcs = (vt__vfunc*)calloc(1, sizeof(vt__vfunc));
+    if (!pg->funcs) rc = -ENOMEM;
+    else {
+      pg->nfuncs = 1;
+      pg->funcs[0].end = (uint32_t)len;
+      pg->funcs[0].nlocals = nlocals;
+    }
+  }
+  if (rc == 0) rc = vt__parse_consts(vm, pg, ksec, ksz);
+  if (rc == 0 && !vm->cfg.no_fuse) rc = vt__fuse(vm, pg, code, len, &fused);
+  if (fused.len) {
+    code = fused.data;
+    len = fused.len;
+  }
+  /* bornes octets, conservées pour l’abaissement en registres */
+  uint32_t* ranges = NULL;
+  if (rc == 0 && !vm->cfg.no_regs) {
+    ranges = (uint32_t*)malloc(pg->nfuncs * 2 * sizeof(uint32_t));
+    if (!ranges) rc = -ENOMEM;
+    for (size_t i = 0; rc == 0 && i < pg->nfuncs; i++) {
+      ranges[2 * i] = pg->funcs[i].entry;
+      ranges[2 * i + 1] = pg->funcs[i].end;
+    }
+  }
+  if (rc == 0) rc = vt__predecode(vm, pg, code, len);
+  for (uint32_t i = 0; rc == 0 && i < pg->nfuncs; i++)
+    rc = vt__verify_func(vm, pg, i);
+  if (rc == 0 && ranges) rc = vt__regs(vm, pg, code, ranges);
+  if (rc == 0) vt__ic_number(pg);
+  free(ranges);
+  vt_bcode_free(&fused);
+  if (rc != 0) {
+    vt__prog_free(pg);
+    return rc;
+  }
+  *out = pg;
+  return 0;
+}
+
+static int vt__attach(vt_vm* vm, const vt__vprog* pg) {
+  if (vt__ensure_globals(vm, pg->nglobals) != 0) return -ENOMEM;
+  vm->ic = (vt__ic*)calloc(pg->nic ? pg->nic : 1, sizeof(vt__ic));
+  if (!vm->ic) return -ENOMEM;
+#if VT_VM_JIT
+  if (vm->cfg.jit_hot) {
+    vm->jit = (vt__jfn*)calloc(pg->nfuncs, sizeof(vt__jfn));
+    if (!vm->jit) return -ENOMEM;
+    vm->njit = pg->nfuncs;
+  }
+#endif
+  vm->prog = pg;
+  vm->err[0] = 0;
+  return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Exceptions                                                                 */
+/* -------------------------------------------------------------------------- */
+/* Déroule vers le handler le plus proche. 1=rattrapée, 0=non rattrapée. */
+static int vt__unwind(vt_vm* vm, vt_value exc) {
+  if (vm->nhandlers == 0) {
+    char buf[64];
+    size_t n = 0;
+    const char* s = vt__text(&exc, buf, sizeof buf, &n);
+    vt__fail(vm, -ECANCELED, "exception non rattrapée: %.*s", (int)n, s);
+    return 0;
+  }
+  vt__handler h = vm->handlers[--vm->nhandlers];
+  vm->nframes = h.nframes;
+  vm->sp = h.sp;
+  vm->stack[vm->sp++] = exc;
+  vm->ip = h.ip;
+  return 1;
+}
+
+static int vt__raise(vt_vm* vm, const char* fmt, ...) {
+  char msg[200];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(msg, sizeof msg, fmt, ap);
+  va_end(ap);
+  if (n < 0) n = 0;
+  if ((size_t)n >= sizeof msg) n = (int)sizeof msg - 1;
+  vt__vstr* s = vt__str_new(vm, msg, (size_t)n);
+  if (!s) {
+    vt__fail(vm, -ENOMEM, "%s", msg);
+    return 0;
+  }
+  return vt__unwind(vm, vt_obj(VT_STR, s));
+}
+
+/* -------------------------------------------------------------------------- */
+/* Appels                                                                     */
+/* -------------------------------------------------------------------------- */
+/* Prépare un frame pour la closure située en stack[callee]. vm->sp/ip
+   doivent être synchronisés. ic: cache du site d’appel (NULL: aucun).
+   1=ok (frame empilé, ou erreur levée puis rattrapée: recharger l’état),
+   0=exception non rattrapée, <0 erreur fatale.
+ */
+static int vt__enter(vt_vm* vm, size_t callee, uint32_t nargs, uint32_t nrets,
+                     size_t ret_ip, vt__ic* ic) {
+  const vt__vclo* c = (const vt__vclo*)vt_as_ptr(&vm->stack[callee]);
+  const vt__vfunc* f = &vm->prog->funcs[c->fn];
+  if (!ic || !vt__ic_call(vm, ic, c)) {
+    if (nargs > f->nparams)
+      return vt__raise(vm, "func #%u: %u argument(s) pour %u paramètre(s)",
+                       c->fn, nargs, f->nparams) ? 1 : 0;
+    if ((size_t)f->nparams + c->nup > f->nlocals)
+      return vt__raise(vm, "func #%u: %u upvalue(s) excèdent les locaux",
+                       c->fn, c->nup) ? 1 : 0;
+    if (ic) vt__ic_fill(ic, c->fn + 1, c->nup);
+  }
+  if (vm->nframes >= VT_VM_MAX_FRAMES)
+    return vt__raise(vm, "débordement de pile d’appels") ? 1 : 0;
+  if (vm->nframes == vm->frame_cap) {
+    size_t ncap = vm->frame_cap ? vm->frame_cap * 2 : 32;
+    vt__frame* nf = (vt__frame*)realloc(vm->frames, ncap * sizeof(vt__frame));
+    if (!nf) return vt__fail(vm, -ENOMEM, "frames: mémoire insuffisante");
+    vm->frames = nf;
+    vm->frame_cap = ncap;
+  }
+  size_t bp = callee + 1;
+  if (vt__ensure_stack(vm, bp + f->nlocals + f->max_stack + 1) != 0)
+    return vt__fail(vm, -ENOMEM, "pile: mémoire insuffisante");
+  vt_value* base = vm->stack + bp;
+  for (uint32_t i = nargs; i < f->nparams; i++) base[i] = vt_nil();
+  for (uint32_t i = 0; i < c->nup; i++) base[f->nparams + i] = c->up[i];
+  for (size_t i = (size_t)f->nparams + c->nup; i < f->nlocals; i++)
+    base[i] = vt_nil();
+  vt__frame* fr = &vm->frames[vm->nframes++];
+  fr->fn = c->fn;
+  fr->nrets = nrets;
+  fr->ret_ip = ret_ip;
+  fr->bp = bp;
+  fr->nhandlers = vm->nhandlers;
+  vm->sp = bp + f->nlocals;
+  vm->ip = f->entry;
+  return 1;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Boucle d’interprétation                                                    */
+/* -------------------------------------------------------------------------- */
+static int vt__start(vt_vm* vm) {
+  vt__vclo* entry = vt__clo_new(vm, 0, 0);
+  if (!entry) return vt__fail(vm, -ENOMEM, "mémoire insuffisante");
+  vm->sp = vm->nframes = vm->nhandlers = 0;
+  if (vt__ensure_stack(vm, 1) != 0) return -ENOMEM;
+  vm->stack[vm->sp++] = vt_obj(VT_FUNC, entry);
+  int rc = vt__enter(vm, 0, 0, 1, 0, NULL);
+  if (rc <= 0) return rc < 0 ? rc : -ECANCELED;
+  vm->status = VT__SUSPENDED;
+  vm->err[0] = 0;
+  return 0;
+}
+
+/* CMP_JF: bit (c+1) de VT__CONDMASK[cond] vrai pour c = -1, 0, 1 */
+static const uint8_t VT__CONDMASK[6] = {2, 5, 1, 3, 4, 6};
+
+static int vt__exec(vt_vm* vm, uint64_t limit) {
+  const vt__pinsn* const code = vm->prog->insns;
+  vt_value* sp;
+  vt_value* bp;
+  const vt__pinsn* ip;
+  uint64_t steps = 0;
+  int rc = 0;
+
+#define VM_SAVE()                              \
+  do {                                         \
+    vm->sp = (size_t)(sp - vm->stack);         \
+    vm->ip = (size_t)(ip - code);              \
+  } while (0)
+#define VM_LOAD()                                         \
+  do {                                                    \
+    bp = vm->stack + vm->frames[vm->nframes - 1].bp;      \
+    sp = vm->stack + vm->sp;                              \
+    ip = code + vm->ip;                                   \
+  } while (0)
+#define VM_TICK()                                            \
+  do {                                                       \
+    if (VT_VM_UNLIKELY(++steps > limit)) {                   \
+      steps--;                                               \
+      rc = -EAGAIN;                                          \
+      goto suspend;                                          \
+    }                                                        \
+  } while (0)
+  /* Lève une erreur runtime (catchable). ip doit pointer l’insn fautive. */
+#define VM_RAISE(...)                          \
+  do {                                         \
+    VM_SAVE();                                 \
+    if (!vt__raise(vm, __VA_ARGS__)) {         \
+      rc = -ECANCELED;                         \
+      goto done;                               \
+    }                                          \
+    VM_LOAD();                                 \
+    VM_NEXT;                                   \
+  } while (0)
+  /* Forme registres: sp n’est à jour qu’aux insns pile; le recaler sur les
+     slots valides (racines GC) avant de lever. */
+#define VM_RRAISE(...)                         \
+  do {                                         \
+    sp = bp + vm->prog->rlive[ip - code];      \
+    VM_RAISE(__VA_ARGS__);                     \
+  } while (0)
+#define VM_OOM()                                                \
+  do {                                                          \
+    rc = vt__fail(vm, -ENOMEM, "mémoire insuffisante");         \
+    goto done;                                                  \
+  } while (0)
+  /* Point sûr GC en fin d’insn allouante (ip déjà avancé): la collecte
+     mineure réécrit les slots de pile en place, la pile ne bouge pas. */
+#define VM_GCPOINT()                           \
+  do {                                         \
+    VM_SAVE();                                 \
+    vt_gc_safepoint(vm->gc);                   \
+  } while (0)
+
+  /* Tiering: passe au code natif de la fonction courante (compilé au
+     cfg.jit_hot-ième passage) et reprend à l’insn où il rend la main. */
+#if VT_VM_JIT
+#define VM_JIT()                                                     \
+  do {                                                               \
+    if (vm->jit) {                                                   \
+      vt__jctx jc_ = {bp, sp, vm->globals, steps, limit};            \
+      uint32_t t_ = vt__jit_enter(vm, (uint32_t)(ip - code), &jc_);  \
+      if (t_ != UINT32_MAX) {                                        \
+        sp = jc_.sp;                                                 \
+        steps = jc_.steps;                                           \
+        ip = code + t_;                                              \
+      }                                                              \
+    }                                                                \
+  } while (0)
+#else
+#define VM_JIT() ((void)0)
+#endif
+
+#ifdef VT_VM_PROFILE
+#define VM_PROF()                      \
+  do {                                 \
+    if (vm->prof) vm->prof[ip->op]++;  \
+  } while (0)
+#else
+#define VM_PROF() ((void)0)
+#endif
+
+#if VT_VM_THREADED
+#define VM_OP(name) L_##name:
+#define VM_NEXT                  \
+  do {                           \
+    VM_TICK();                   \
+    VM_PROF();                   \
+    goto* vt__labels[ip->op];    \
+  } while (0)
+  static const void* const vt__labels[VT__OP_MAX] = {
+      [OP_NOP] = &&L_OP_NOP,         [OP_HALT] = &&L_OP_HALT,
+      [OP_ICONST] = &&L_OP_ICONST,   [OP_FCONST] = &&L_OP_FCONST,
+      [OP_SCONST] = &&L_OP_SCONST,   [OP_LOADK] = &&L_OP_LOADK,
+      [OP_LD] = &&L_OP_LD,           [OP_ST] = &&L_OP_ST,
+      [OP_LDG] = &&L_OP_LDG,         [OP_STG] = &&L_OP_STG,
+      [OP_POP] = &&L_OP_POP,         [OP_DUP] = &&L_OP_DUP,
+      [OP_SWAP] = &&L_OP_SWAP,       [OP_ADD] = &&L_OP_ADD,
+      [OP_SUB] = &&L_OP_SUB,         [OP_MUL] = &&L_OP_MUL,
+      [OP_DIV] = &&L_OP_DIV,         [OP_MOD] = &&L_OP_MOD,
+      [OP_NEG] = &&L_OP_NEG,         [OP_NOT] = &&L_OP_NOT,
+      [OP_EQ] = &&L_OP_EQ,           [OP_NE] = &&L_OP_NE,
+      [OP_LT] = &&L_OP_LT,           [OP_LE] = &&L_OP_LE,
+      [OP_GT] = &&L_OP_GT,           [OP_GE] = &&L_OP_GE,
+      [OP_NEWA] = &&L_OP_NEWA,       [OP_APUSH] = &&L_OP_APUSH,
+      [OP_AGET] = &&L_OP_AGET,       [OP_ASET] = &&L_OP_ASET,
+      [OP_NEWM] = &&L_OP_NEWM,       [OP_MGET] = &&L_OP_MGET,
+      [OP_MSET] = &&L_OP_MSET,       [OP_JMP] = &&L_OP_JMP,
+      [OP_JT] = &&L_OP_JT,           [OP_JF] = &&L_OP_JF,
+      [OP_CALL] = &&L_OP_CALL,       [OP_RET] = &&L_OP_RET,
+      [OP_CLOSURE] = &&L_OP_CLOSURE, [OP_CAPTURE] = &&L_OP_CAPTURE,
+      [OP_TYPEOF] = &&L_OP_TYPEOF,   [OP_CONCAT] = &&L_OP_CONCAT,
+      [OP_THROW] = &&L_OP_THROW,     [OP_TENTER] = &&L_OP_TENTER,
+      [OP_TLEAVE] = &&L_OP_TLEAVE,   [OP_PRINT] = &&L_OP_PRINT,
+      [OP_LD_ADDI_ST] = &&L_OP_LD_ADDI_ST,
+      [OP_CMP_JF] = &&L_OP_CMP_JF,
+      [VT__R_MOV] = &&L_VT__R_MOV,       [VT__R_LOADI] = &&L_VT__R_LOADI,
+      [VT__R_LOADF] = &&L_VT__R_LOADF,   [VT__R_LOADK] = &&L_VT__R_LOADK,
+      [VT__R_LDG] = &&L_VT__R_LDG,       [VT__R_STG] = &&L_VT__R_STG,
+      [VT__R_ADD] = &&L_VT__R_ADD,       [VT__R_SUB] = &&L_VT__R_SUB,
+      [VT__R_MUL] = &&L_VT__R_MUL,       [VT__R_DIV] = &&L_VT__R_DIV,
+      [VT__R_MOD] = &&L_VT__R_MOD,       [VT__R_ADDI] = &&L_VT__R_ADDI,
+      [VT__R_NEG] = &&L_VT__R_NEG,       [VT__R_NOT] = &&L_VT__R_NOT,
+      [VT__R_EQ] = &&L_VT__R_EQ,         [VT__R_NE] = &&L_VT__R_NE,
+      [VT__R_LT] = &&L_VT__R_LT,         [VT__R_LE] = &&L_VT__R_LE,
+      [VT__R_GT] = &&L_VT__R_GT,         [VT__R_GE] = &&L_VT__R_GE,
+      [VT__R_JMP] = &&L_VT__R_JMP,       [VT__R_JT] = &&L_VT__R_JT,
+      [VT__R_JF] = &&L_VT__R_JF,         [VT__R_CMPJF] = &&L_VT__R_CMPJF,
+      [VT__R_CMPJFI] = &&L_VT__R_CMPJFI, [VT__R_SETSP] = &&L_VT__R_SETSP,
+  };
+#else
+#define VM_OP(name) case name:
+#define VM_NEXT goto vm_next
+#endif
+
+/* Arithmétique binaire: int∘int → int (wrap), sinon flottant. */
+#define VM_ARITH(IOP, FOP)                                                 \
+  do {                                                                     \
+    vt_value* a_ = sp - 2;                                                 \
+    const vt_value* b_ = sp - 1;                                           \
+    if (VT_VM_LIKELY(vt_is_int(a_) && vt_is_int(b_))) {                    \
+      *a_ = vt_int(                                                        \
+          (int64_t)((uint64_t)vt_as_int(a_) IOP(uint64_t) vt_as_int(b_))); \
+    } else if (vt__is_num(a_) && vt__is_num(b_)) {                         \
+      *a_ = vt_float(vt__num(a_) FOP vt__num(b_));                         \
+    } else {                                                               \
+      VM_RAISE("arith: opérandes %s, %s", VT__TNAMES[vt_value_type(a_)],   \
+               VT__TNAMES[vt_value_type(b_)]);                             \
+    }                                                                      \
+    sp--;                                                                  \
+    ip++;                                                               \
+    VM_NEXT;                                                               \
+  } while (0)
+#define VM_CMP(TEST)                                                        \
+  do {                                                                      \
+    vt_value* a_ = sp - 2;                                                  \
+    int c_;                                                                 \
+    if (VT_VM_LIKELY(vt_is_int(a_) && vt_is_int(sp - 1)))                   \
+      c_ = (vt_as_int(a_) > vt_as_int(sp - 1)) -                            \
+           (vt_as_int(a_) < vt_as_int(sp - 1));                             \
+    else                                                                    \
+      c_ = vt__compare(a_, sp - 1);                                         \
+    if (c_ == 2 && !(vt__is_num(a_) && vt__is_num(sp - 1)))                 \
+      VM_RAISE("comparaison: %s, %s", VT__TNAMES[vt_value_type(a_)],        \
+               VT__TNAMES[vt_value_type(sp - 1)]);                          \
+    *a_ = vt_bool(c_ != 2 && (TEST));                                       \
+    sp--;                                                                   \
+    ip++;                                                                \
+    VM_NEXT;                                                                \
+  } while (0)
+
+/* T = (A cond B), cond = ip->c (0=eq..5=ge), comme EQ..GE. */
+#define VM_CONDTEST(T, A, B, RAISE)                                        \
+  do {                                                                     \
+    if (VT_VM_LIKELY(vt_is_int(A) && vt_is_int(B))) {                      \
+      int c_ =                                                             \
+          (vt_as_int(A) > vt_as_int(B)) - (vt_as_int(A) < vt_as_int(B));   \
+      T = (VT__CONDMASK[ip->c] >> (c_ + 1)) & 1;                           \
+    } else if (ip->c <= 1) {                                               \
+      T = vt__equal((A), (B)) == (ip->c == 0);                             \
+    } else {                                                               \
+      int c_ = vt__compare((A), (B));                                      \
+      if (c_ == 2 && !(vt__is_num(A) && vt__is_num(B)))                    \
+        RAISE("comparaison: %s, %s", VT__TNAMES[vt_value_type(A)],         \
+              VT__TNAMES[vt_value_type(B)]);                               \
+      T = c_ != 2 && ((VT__CONDMASK[ip->c] >> (c_ + 1)) & 1);              \
+    }                                                                      \
+  } while (0)
+/* Forme registres: d = a op b (int∘int → int wrap, sinon flottant). */
+#define VM_RARITH(IOP, FOP)                                                \
+  do {                                                                     \
+    const vt_value* a_ = &bp[ip->a];                                       \
+    const vt_value* b_ = &bp[ip->b];                                       \
+    if (VT_VM_LIKELY(vt_is_int(a_) && vt_is_int(b_))) {                    \
+      bp[ip->d] = vt_int(                                                  \
+          (int64_t)((uint64_t)vt_as_int(a_) IOP(uint64_t) vt_as_int(b_))); \
+    } else if (vt__is_num(a_) && vt__is_num(b_)) {                         \
+      bp[ip->d] = vt_float(vt__num(a_) FOP vt__num(b_));                   \
+    } else {                                                               \
+      VM_RRAISE("arith: opérandes %s, %s", VT__TNAMES[vt_value_type(a_)],  \
+                VT__TNAMES[vt_value_type(b_)]);                            \
+    }                                                                      \
+    ip++;                                                                  \
+    VM_NEXT;                                                               \
+  } while (0)
+#define VM_RCMP(TEST)                                                       \
+  do {                                                                      \
+    const vt_value* a_ = &bp[ip->a];                                        \
+    const vt_value* b_ = &bp[ip->b];                                        \
+    int c_;                                                                 \
+    if (VT_VM_LIKELY(vt_is_int(a_) && vt_is_int(b_)))                       \
+      c_ = (vt_as_int(a_) > vt_as_int(b_)) -                                \
+           (vt_as_int(a_) < vt_as_int(b_));                                 \
+    else                                                                    \
+      c_ = vt__compare(a_, b_);                                             \
+    if (c_ == 2 && !(vt__is_num(a_) && vt__is_num(b_)))                     \
+      VM_RRAISE("comparaison: %s, %s", VT__TNAMES[vt_value_type(a_)],       \
+                VT__TNAMES[vt_value_type(b_)]);                             \
+    bp[ip->d] = vt_bool(c_ != 2 && (TEST));                                 \
+    ip++;                                                                   \
+    VM_NEXT;                                                                \
+  } while (0)
+
+  VM_LOAD();
+
+#if VT_VM_THREADED
+  VM_NEXT;
+#else
+vm_next:
+  VM_TICK();
+  VM_PROF();
+  switch (ip->op) {
+#endif
+
+  VM_OP(OP_NOP) {
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_HALT) {
+    vm->status = VT__DONE;
+    goto done;
+  }
+
+  VM_OP(OP_ICONST) {
+    *sp++ = vt_int(ip->x.i);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_FCONST) {
+    *sp++ = vt_float(ip->x.f);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_SCONST)
+  VM_OP(OP_LOADK) {
+    *sp++ = *ip->x.k;
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_LD) {
+    *sp++ = bp[ip->a];
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_ST) {
+    bp[ip->a] = *--sp;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_LDG) {
+    *sp++ = vm->globals[ip->a];
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_STG) {
+    vm->globals[ip->a] = *--sp;
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_POP) {
+    sp -= ip->a;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_DUP) {
+    sp[0] = sp[-1];
+    sp++;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_SWAP) {
+    vt_value t = sp[-1];
+    sp[-1] = sp[-2];
+    sp[-2] = t;
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_ADD) { VM_ARITH(+, +); }
+  VM_OP(OP_SUB) { VM_ARITH(-, -); }
+  VM_OP(OP_MUL) { VM_ARITH(*, *); }
+  VM_OP(OP_DIV) {
+    vt_value* a = sp - 2;
+    const vt_value* b = sp - 1;
+    if (vt_is_int(a) && vt_is_int(b)) {
+      if (vt_as_int(b) == 0) VM_RAISE("division par zéro");
+      *a = vt_int((vt_as_int(b) == -1)
+                      ? (int64_t)(0 - (uint64_t)vt_as_int(a))
+                      : vt_as_int(a) / vt_as_int(b));
+    } else if (vt__is_num(a) && vt__is_num(b)) {
+      *a = vt_float(vt__num(a) / vt__num(b));
+    } else {
+      VM_RAISE("div: opérandes %s, %s", VT__TNAMES[vt_value_type(a)],
+               VT__TNAMES[vt_value_type(b)]);
+    }
+    sp--;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_MOD) {
+    vt_value* a = sp - 2;
+    const vt_value* b = sp - 1;
+    if (vt_is_int(a) && vt_is_int(b)) {
+      if (vt_as_int(b) == 0) VM_RAISE("modulo par zéro");
+      *a = vt_int((vt_as_int(b) == -1) ? 0 : vt_as_int(a) % vt_as_int(b));
+    } else if (vt__is_num(a) && vt__is_num(b)) {
+      *a = vt_float(fmod(vt__num(a), vt__num(b)));
+    } else {
+      VM_RAISE("mod: opérandes %s, %s", VT__TNAMES[vt_value_type(a)],
+               VT__TNAMES[vt_value_type(b)]);
+    }
+    sp--;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_NEG) {
+    vt_value* a = sp - 1;
+    if (vt_is_int(a))
+      *a = vt_int((int64_t)(0 - (uint64_t)vt_as_int(a)));
+    else if (vt_is_float(a))
+      *a = vt_float(-vt_as_float(a));
+    else
+      VM_RAISE("neg: opérande %s", VT__TNAMES[vt_value_type(a)]);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_NOT) {
+    sp[-1] = vt_bool(!vt__truthy(sp - 1));
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_EQ) {
+    sp[-2] = vt_bool(vt__equal(sp - 2, sp - 1));
+    sp--;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_NE) {
+    sp[-2] = vt_bool(!vt__equal(sp - 2, sp - 1));
+    sp--;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_LT) { VM_CMP(c_ < 0); }
+  VM_OP(OP_LE) { VM_CMP(c_ <= 0); }
+  VM_OP(OP_GT) { VM_CMP(c_ > 0); }
+  VM_OP(OP_GE) { VM_CMP(c_ >= 0); }
+
+  VM_OP(OP_NEWA) {
+    size_t n = ip->a;
+    VM_SAVE();
+    vt__varr* a = vt__arr_new(vm, n);
+    if (!a || (n && !a->items)) VM_OOM();
+    if (n) memcpy(a->items, sp - n, n * sizeof(vt_value));
+    a->len = n;
+    sp -= n;
+    *sp++ = vt_obj(VT_ARRAY, a);
+    ip++;
+    VM_GCPOINT();
+    VM_NEXT;
+  }
+  VM_OP(OP_APUSH) {
+    if (vt_value_type(sp - 2) != VT_ARRAY)
+      VM_RAISE("apush: %s", VT__TNAMES[vt_value_type(sp - 2)]);
+    vt__varr* a = (vt__varr*)vt_as_ptr(sp - 2);
+    if (!vt__arr_reserve(a, a->len + 1)) VM_OOM();
+    a->items[a->len++] = sp[-1];
+    vt__wb(vm, a, sp - 1);
+    sp--;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_AGET) {
+    if (vt_value_type(sp - 2) != VT_ARRAY || !vt_is_int(sp - 1))
+      VM_RAISE("aget: %s[%s]", VT__TNAMES[vt_value_type(sp - 2)],
+               VT__TNAMES[vt_value_type(sp - 1)]);
+    const vt__varr* a = (const vt__varr*)vt_as_ptr(sp - 2);
+    uint64_t i = (uint64_t)vt_as_int(sp - 1);
+    if (i >= a->len) VM_RAISE("aget: index %lld hors bornes", (long long)i);
+    sp[-2] = a->items[i];
+    sp--;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_ASET) {
+    if (vt_value_type(sp - 3) != VT_ARRAY || !vt_is_int(sp - 2))
+      VM_RAISE("aset: %s[%s]", VT__TNAMES[vt_value_type(sp - 3)],
+               VT__TNAMES[vt_value_type(sp - 2)]);
+    vt__varr* a = (vt__varr*)vt_as_ptr(sp - 3);
+    uint64_t i = (uint64_t)vt_as_int(sp - 2);
+    if (i > a->len) VM_RAISE("aset: index %lld hors bornes", (long long)i);
+    if (i == a->len) {
+      if (!vt__arr_reserve(a, a->len + 1)) VM_OOM();
+      a->len++;
+    }
+    a->items[i] = sp[-1];
+    if (i < a->clean) a->clean = i;
+    vt__wb(vm, a, sp - 1);
+    sp -= 2;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_NEWM) {
+    size_t n = ip->a;
+    VM_SAVE();
+    vt__vmap* m = vt__map_new(vm);
+    if (!m) VM_OOM();
+    vt_value* kv = sp - 2 * n;
+    for (size_t i = 0; i < n; i++)
+      if (!vt__map_set(m, kv[2 * i], kv[2 * i + 1])) VM_OOM();
+    sp = kv;
+    *sp++ = vt_obj(VT_MAP, m);
+    ip++;
+    VM_GCPOINT();
+    VM_NEXT;
+  }
+  VM_OP(OP_MGET) {
+    if (vt_value_type(sp - 2) != VT_MAP)
+      VM_RAISE("mget: %s", VT__TNAMES[vt_value_type(sp - 2)]);
+    const vt__vment* e = vt__ic_map(vm, &vm->ic[ip->x.ic],
+                                    (const vt__vmap*)vt_as_ptr(sp - 2),
+                                    sp - 1, 0);
+    sp[-2] = e ? e->val : vt_nil();
+    sp--;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_MSET) {
+    if (vt_value_type(sp - 3) != VT_MAP)
+      VM_RAISE("mset: %s", VT__TNAMES[vt_value_type(sp - 3)]);
+    if (!vt__ic_mset(vm, &vm->ic[ip->x.ic], (vt__vmap*)vt_as_ptr(sp - 3),
+                     sp[-2], sp[-1]))
+      VM_OOM();
+    sp -= 2;
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_JMP) {
+    const vt__pinsn* t = code + ip->x.j.t;
+    if (t <= ip) {
+      ip = t;
+      VM_JIT();
+    } else {
+      ip = t;
+    }
+    VM_NEXT;
+  }
+  VM_OP(OP_JT) {
+    if (vt__truthy(--sp))
+      ip = code + ip->x.j.t;
+    else
+      ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_JF) {
+    if (!vt__truthy(--sp))
+      ip = code + ip->x.j.t;
+    else
+      ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_CALL) {
+    uint32_t nargs = ip->a, nrets = ip->c;
+    vt_value* callee = sp - nargs - 1;
+    if (vt_value_type(callee) == VT_FUNC) {
+      VM_SAVE();
+      int r = vt__enter(vm, (size_t)(callee - vm->stack), nargs, nrets,
+                        vm->ip + 1, &vm->ic[ip->x.ic]);
+      if (r < 0) {
+        rc = r;
+        goto done;
+      }
+      if (r == 0) {
+        rc = -ECANCELED;
+        goto done;
+      }
+      VM_LOAD();
+      VM_JIT();
+      VM_NEXT;
+    }
+    if (vt_value_type(callee) == VT_PTR && vt_as_ptr(callee)) {
+      vt_cfunc fn = (vt_cfunc)vt_as_ptr(callee);
+      VM_SAVE();
+      vt_value r = fn(vm, (int)nargs, callee + 1);
+      sp = callee;
+      if (nrets) {
+        *sp++ = r;
+        for (uint32_t i = 1; i < nrets; i++) *sp++ = vt_nil();
+      }
+      ip++;
+      VM_NEXT;
+    }
+    VM_RAISE("call: %s non appelable", VT__TNAMES[vt_value_type(callee)]);
+  }
+  VM_OP(OP_RET) {
+    uint32_t n = ip->a;
+    vt__frame* fr = &vm->frames[vm->nframes - 1];
+    vt_value* dst = vm->stack + fr->bp - 1; /* slot du callee */
+    uint32_t want = fr->nrets;
+    uint32_t k = n < want ? n : want;
+    memmove(dst, sp - n, k * sizeof(vt_value));
+    for (uint32_t i = k; i < want; i++) dst[i] = vt_nil();
+    sp = dst + want;
+    vm->nhandlers = fr->nhandlers;
+    if (--vm->nframes == 0) {
+      vm->status = VT__DONE;
+      goto done;
+    }
+    ip = code + fr->ret_ip;
+    bp = vm->stack + vm->frames[vm->nframes - 1].bp;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_CLOSURE) {
+    const vt__vclo* proto = (const vt__vclo*)vt_as_ptr(ip->x.k);
+    uint32_t nup = ip->c;
+    VM_SAVE();
+    vt__vclo* c = vt__clo_new(vm, proto->fn, nup);
+    if (!c || (nup && !c->up)) VM_OOM();
+    if (nup) memcpy(c->up, sp - nup, nup * sizeof(vt_value));
+    c->nup = nup;
+    sp -= nup;
+    *sp++ = vt_obj(VT_FUNC, c);
+    ip++;
+    VM_GCPOINT();
+    VM_NEXT;
+  }
+  VM_OP(OP_CAPTURE) {
+    if (vt_value_type(sp - 1) != VT_FUNC)
+      VM_RAISE("capture: %s", VT__TNAMES[vt_value_type(sp - 1)]);
+    vt__vclo* c = (vt__vclo*)vt_as_ptr(sp - 1);
+    if (!vt__clo_push(c, bp[ip->a])) VM_OOM();
+    vt__wb(vm, c, &bp[ip->a]);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_TYPEOF) {
+    uint32_t t = vt_value_type(sp - 1);
+    if (vt_value_type(&vm->tnames[t]) != VT_STR) {
+      VM_SAVE();
+      vt__vstr* s = vt__str_new(vm, VT__TNAMES[t], strlen(VT__TNAMES[t]));
+      if (!s) VM_OOM();
+      vm->tnames[t] = vt_obj(VT_STR, s);
+      VM_GCPOINT(); /* tnames est une racine: relu ci-dessous */
+    }
+    sp[-1] = vm->tnames[t];
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_CONCAT) {
+    vt_value* a = sp - 2;
+    const vt_value* b = sp - 1;
+    VM_SAVE();
+    if (vt_value_type(a) == VT_ARRAY && vt_value_type(b) == VT_ARRAY) {
+      const vt__varr* x = (const vt__varr*)vt_as_ptr(a);
+      const vt__varr* y = (const vt__varr*)vt_as_ptr(b);
+      vt__varr* r = vt__arr_new(vm, x->len + y->len);
+      if (!r || (x->len + y->len && !r->items)) VM_OOM();
+      if (x->len) memcpy(r->items, x->items, x->len * sizeof(vt_value));
+      if (y->len) memcpy(r->items + x->len, y->items, y->len * sizeof(vt_value));
+      r->len = x->len + y->len;
+      *a = vt_obj(VT_ARRAY, r);
+    } else {
+      char ba[64], bb[64];
+      size_t na = 0, nb = 0;
+      const char* sa = vt__text(a, ba, sizeof ba, &na);
+      const char* sb = vt__text(b, bb, sizeof bb, &nb);
+      /* a et b restent sur la pile (enracinés) pendant l’allocation */
+      vt__vstr* r = vt__str_alloc(vm, na + nb);
+      if (!r) VM_OOM();
+      memcpy(r->data, sa, na);
+      memcpy(r->data + na, sb, nb);
+      vt__str_seal(r);
+      *a = vt_obj(VT_STR, r);
+    }
+    sp--;
+    ip++;
+    VM_GCPOINT();
+    VM_NEXT;
+  }
+
+  VM_OP(OP_THROW) {
+    vt_value exc = *--sp;
+    VM_SAVE();
+    if (!vt__unwind(vm, exc)) {
+      rc = -ECANCELED;
+      goto done;
+    }
+    VM_LOAD();
+    VM_NEXT;
+  }
+  VM_OP(OP_TENTER) {
+    if (vm->nhandlers == vm->handler_cap) {
+      size_t ncap = vm->handler_cap ? vm->handler_cap * 2 : 8;
+      vt__handler* nh =
+          (vt__handler*)realloc(vm->handlers, ncap * sizeof(vt__handler));
+      if (!nh) VM_OOM();
+      vm->handlers = nh;
+      vm->handler_cap = ncap;
+    }
+    vt__handler* h = &vm->handlers[vm->nhandlers++];
+    h->nframes = vm->nframes;
+    h->sp = (size_t)(sp - vm->stack);
+    h->ip = ip->x.j.t;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_TLEAVE) {
+    if (vm->nhandlers > vm->frames[vm->nframes - 1].nhandlers) vm->nhandlers--;
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(OP_PRINT) {
+    vt__print(--sp);
+    ip++;
+    VM_NEXT;
+  }
+
+  /* Superinstructions (vt_fuse). Mêmes sémantiques et mêmes erreurs que
+     la séquence d’origine. */
+  VM_OP(OP_LD_ADDI_ST) {
+    const vt_value* a = &bp[ip->a];
+    if (VT_VM_LIKELY(vt_is_int(a)))
+      bp[ip->d] = vt_int((int64_t)((uint64_t)vt_as_int(a) + (uint64_t)ip->x.i));
+    else if (vt_is_float(a))
+      bp[ip->d] = vt_float(vt_as_float(a) + (double)ip->x.i);
+    else
+      VM_RAISE("arith: opérandes %s, %s", VT__TNAMES[vt_value_type(a)],
+               VT__TNAMES[VT_INT]);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(OP_CMP_JF) {
+    int t;
+    VM_CONDTEST(t, sp - 2, sp - 1, VM_RAISE);
+    sp -= 2;
+    ip = t ? ip + 1 : code + ip->x.j.t;
+    VM_NEXT;
+  }
+
+  /* Forme registres (ir.h). Mêmes sémantiques et mêmes erreurs que les
+     insns pile d’origine; les opérandes sont lus avant d’écrire d. */
+  VM_OP(VT__R_MOV) {
+    bp[ip->d] = bp[ip->a];
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_LOADI) {
+    bp[ip->d] = vt_int(ip->x.i);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_LOADF) {
+    bp[ip->d] = vt_float(ip->x.f);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_LOADK) {
+    bp[ip->d] = *ip->x.k;
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_LDG) {
+    bp[ip->d] = vm->globals[ip->b];
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_STG) {
+    vm->globals[ip->b] = bp[ip->a];
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(VT__R_ADD) { VM_RARITH(+, +); }
+  VM_OP(VT__R_SUB) { VM_RARITH(-, -); }
+  VM_OP(VT__R_MUL) { VM_RARITH(*, *); }
+  VM_OP(VT__R_DIV) {
+    const vt_value* a = &bp[ip->a];
+    const vt_value* b = &bp[ip->b];
+    if (vt_is_int(a) && vt_is_int(b)) {
+      if (vt_as_int(b) == 0) VM_RRAISE("division par zéro");
+      bp[ip->d] = vt_int((vt_as_int(b) == -1)
+                             ? (int64_t)(0 - (uint64_t)vt_as_int(a))
+                             : vt_as_int(a) / vt_as_int(b));
+    } else if (vt__is_num(a) && vt__is_num(b)) {
+      bp[ip->d] = vt_float(vt__num(a) / vt__num(b));
+    } else {
+      VM_RRAISE("div: opérandes %s, %s", VT__TNAMES[vt_value_type(a)],
+                VT__TNAMES[vt_value_type(b)]);
+    }
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_MOD) {
+    const vt_value* a = &bp[ip->a];
+    const vt_value* b = &bp[ip->b];
+    if (vt_is_int(a) && vt_is_int(b)) {
+      if (vt_as_int(b) == 0) VM_RRAISE("modulo par zéro");
+      bp[ip->d] =
+          vt_int((vt_as_int(b) == -1) ? 0 : vt_as_int(a) % vt_as_int(b));
+    } else if (vt__is_num(a) && vt__is_num(b)) {
+      bp[ip->d] = vt_float(fmod(vt__num(a), vt__num(b)));
+    } else {
+      VM_RRAISE("mod: opérandes %s, %s", VT__TNAMES[vt_value_type(a)],
+                VT__TNAMES[vt_value_type(b)]);
+    }
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_ADDI) {
+    const vt_value* a = &bp[ip->a];
+    if (VT_VM_LIKELY(vt_is_int(a)))
+      bp[ip->d] = vt_int((int64_t)((uint64_t)vt_as_int(a) + (uint64_t)ip->x.i));
+    else if (vt_is_float(a))
+      bp[ip->d] = vt_float(vt_as_float(a) + (double)ip->x.i);
+    else
+      VM_RRAISE("arith: opérandes %s, %s", VT__TNAMES[vt_value_type(a)],
+                VT__TNAMES[VT_INT]);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_NEG) {
+    const vt_value* a = &bp[ip->a];
+    if (vt_is_int(a))
+      bp[ip->d] = vt_int((int64_t)(0 - (uint64_t)vt_as_int(a)));
+    else if (vt_is_float(a))
+      bp[ip->d] = vt_float(-vt_as_float(a));
+    else
+      VM_RRAISE("neg: opérande %s", VT__TNAMES[vt_value_type(a)]);
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_NOT) {
+    bp[ip->d] = vt_bool(!vt__truthy(&bp[ip->a]));
+    ip++;
+    VM_NEXT;
+  }
+
+  VM_OP(VT__R_EQ) {
+    bp[ip->d] = vt_bool(vt__equal(&bp[ip->a], &bp[ip->b]));
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_NE) {
+    bp[ip->d] = vt_bool(!vt__equal(&bp[ip->a], &bp[ip->b]));
+    ip++;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_LT) { VM_RCMP(c_ < 0); }
+  VM_OP(VT__R_LE) { VM_RCMP(c_ <= 0); }
+  VM_OP(VT__R_GT) { VM_RCMP(c_ > 0); }
+  VM_OP(VT__R_GE) { VM_RCMP(c_ >= 0); }
+
+  VM_OP(VT__R_JMP) {
+    const vt__pinsn* t = code + ip->x.j.t;
+    if (t <= ip) {
+      ip = t;
+      VM_JIT();
+    } else {
+      ip = t;
+    }
+    VM_NEXT;
+  }
+  VM_OP(VT__R_JT) {
+    ip = vt__truthy(&bp[ip->a]) ? code + ip->x.j.t : ip + 1;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_JF) {
+    ip = vt__truthy(&bp[ip->a]) ? ip + 1 : code + ip->x.j.t;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_CMPJF) {
+    int t;
+    VM_CONDTEST(t, &bp[ip->a], &bp[ip->b], VM_RRAISE);
+    ip = t ? ip + 1 : code + ip->x.j.t;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_CMPJFI) {
+    const vt_value* a = &bp[ip->a];
+    int t;
+    if (VT_VM_LIKELY(vt_is_int(a))) {
+      int64_t k = ip->x.j.k;
+      int c = (vt_as_int(a) > k) - (vt_as_int(a) < k);
+      t = (VT__CONDMASK[ip->c] >> (c + 1)) & 1;
+    } else {
+      const vt_value b = vt_int(ip->x.j.k);
+      VM_CONDTEST(t, a, &b, VM_RRAISE);
+    }
+    ip = t ? ip + 1 : code + ip->x.j.t;
+    VM_NEXT;
+  }
+  VM_OP(VT__R_SETSP) {
+    sp = bp + ip->a;
+    ip++;
+    VM_NEXT;
+  }
+
+#if !VT_VM_THREADED
+    default:
+      rc = vt__fail(vm, -EILSEQ, "opcode 0x%02x invalide @%zu", ip->op,
+                    (size_t)(ip - code));
+      goto done;
+  }
+#endif
+
+suspend:
+  VM_SAVE();
+  vm->steps += steps;
+  return rc;
+done:
+  if (vm->status == VT__DONE) VM_SAVE();
+  vm->steps += steps;
+  if (rc != 0 && rc != -EAGAIN) vm->status = VT__IDLE;
+  return rc;
+
+#undef VM_RCMP
+#undef VM_RARITH
+#undef VM_CONDTEST
+#undef VM_CMP
+#undef VM_ARITH
+#undef VM_NEXT
+#undef VM_PROF
+#undef VM_JIT
+#undef VM_OP
+#undef VM_OOM
+#undef VM_RRAISE
+#undef VM_RAISE
+#undef VM_TICK
+#undef VM_LOAD
+#undef VM_SAVE
+}
+#endif /* VT_OBJECT_H */
+
 /* -------------------------------------------------------------------------- */
 /* API publique                                                                */
 /* -------------------------------------------------------------------------- */
@@ -50,11 +2948,49 @@ vt_vm* vt_vm_new(const vt_vm_config* cfg) {
   vm->cfg = cfg ? *cfg : VT_VM_DEFAULT_CFG;
   vm->natives = NULL;
   vm->native_cap = 0;
+#ifdef VT_OBJECT_H
+  const vt_gc_config gcfg = {
+    .nursery_bytes = vm->cfg.no_nursery ? 0 : VT__NURSERY,
+    .incremental = vm->cfg.gc_slice_us > 0,
+    .slice_us = vm->cfg.gc_slice_us,
+    .mark_threads = vm->cfg.gc_threads,
+    .concurrent_sweep = vm->cfg.gc_threads > 1,
+  };
+  vm->gc = vt_gc_create(&gcfg);
+  if (!vm->gc) {
+    free(vm);
+    return NULL;
+  }
+  vm->root = (vt__vroot*)vt_gc_alloc_young(vm->gc, sizeof(vt__vroot),
+                                           vt__root_update, NULL, 0);
+  if (!vm->root) {
+    vt_gc_destroy(vm->gc);
+    free(vm);
+    return NULL;
+  }
+  vm->root->vm = vm;
+  vt_gc_add_root(vm->gc, (void**)&vm->root);
+  size_t scap = vm->cfg.initial_stack_cap > 0 ? (size_t)vm->cfg.initial_stack_cap
+                                              : 256;
+  if (vt__ensure_stack(vm, scap) != 0) {
+    vt_vm_free(vm);
+    return NULL;
+  }
+#endif
   return vm;
 }
 
 void vt_vm_free(vt_vm* vm) {
   if (!vm) return;
+#ifdef VT_OBJECT_H
+  vt__unload(vm);
+  if (vm->root) vm->root->vm = NULL;
+  vt_gc_destroy(vm->gc);
+  free(vm->stack);
+  free(vm->frames);
+  free(vm->handlers);
+  free(vm->globals);
+#endif
   free(vm->natives);
   free(vm);
 }
@@ -63,16 +2999,16 @@ int vt_vm_set_native(vt_vm* vm, uint16_t symbol_id, vt_cfunc fn) {
   if (!vm) return -EINVAL;
   if (vt__ensure_native_cap(vm, (size_t)symbol_id + 1) != 0) return -ENOMEM;
   vm->natives[symbol_id] = fn;
+#ifdef VT_OBJECT_H
+  if (vt__ensure_globals(vm, (size_t)symbol_id + 1) != 0) return -ENOMEM;
+  vm->globals[symbol_id] = fn ? vt_make_native(fn) : vt_nil();
+#endif
   return 0;
 }
 
 vt_value vt_make_native(vt_cfunc fn) {
 #ifdef VT_OBJECT_H
-  vt_value val;
-  val.type  = VT_PTR;
-  val.flags = 0;
-  val.as.p  = (void*)fn;
-  return val;
+  return vt_ptr((void*)fn);
 #else
   vt_value val;
   memset(&val, 0, sizeof val);
@@ -82,14 +3018,932 @@ vt_value vt_make_native(vt_cfunc fn) {
 #endif
 }
 
+#ifdef VT_OBJECT_H
+/* Le programme pré-décodé est mis en cache sur l’image: un second chargement
+   (autre VM, même image) ne redécode ni ne revérifie rien. */
+static int vt__load_img(vt_vm* vm, vt_img* img, int owned) {
+  vt__unload(vm);
+  if (owned) vm->img = img;
+  /* cfg.no_fuse/no_regs: programme privé, le cache ne contient que la forme
+     par défaut (fusionnée, registres) */
+  const int priv = vm->cfg.no_fuse || vm->cfg.no_regs;
+  const vt__vprog* pg = priv ? NULL : (const vt__vprog*)vt_img_cache_get(img);
+  if (!pg) {
+    const uint8_t *code = NULL, *fsec = NULL, *ksec = NULL;
+    size_t len = 0, fsz = 0, ksz = 0;
+    if (vt_img_find(img, (const char[4]){'C', 'O', 'D', 'E'}, &code, &len) != 0) {
+      vt__unload(vm);
+      return vt__fail(vm, -ENOEXEC, "section CODE absente");
+    }
+    if (vt_img_find(img, (const char[4]){'F', 'U', 'N', 'C'}, &fsec, &fsz) != 0) {
+      vt__unload(vm);
+      return vt__fail(vm, -ENOEXEC, "section FUNC absente");
+    }
+    (void)vt_img_find(img, (const char[4]){'K', 'C', 'O', 'N'}, &ksec, &ksz);
+    vt__vprog* built = NULL;
+    int rc = vt__prog_build(vm, code, len, fsec, fsz, ksec, ksz, 0, &built);
+    if (rc != 0) {
+      vt__unload(vm);
+      return rc;
+    }
+    if (priv) {
+      vm->prog_own = built;
+      pg = built;
+    } else if (vt_img_cache_set(img, built, vt__prog_free) != 0) {
+      vt__prog_free(built); /* course perdue: un autre chargeur a publié */
+      pg = (const vt__vprog*)vt_img_cache_get(img);
+    } else {
+      pg = built;
+    }
+  }
+  int rc = vt__attach(vm, pg);
+  if (rc != 0) vt__unload(vm);
+  return rc;
+}
+#endif
+
 int vt_vm_load_image(vt_vm* vm, const char* path) {
-  (void)vm;
-  (void)path;
+  if (!vm || !path) return -EINVAL;
+#ifdef VT_OBJECT_H
+  vt_img* img = NULL;
+  int rc = vt_img_load_file(path, &img);
+  if (rc != 0) return vt__fail(vm, rc, "%s: image VTBC illisible", path);
+  return vt__load_img(vm, img, 1);
+#else
+  return -ENOSYS;
+#endif
+}
+
+int vt_vm_load_memory(vt_vm* vm, const void* data, size_t size) {
+  if (!vm || !data || !size) return -EINVAL;
+#ifdef VT_OBJECT_H
+  vt_img* img = NULL;
+  int rc = vt_img_load_memory(data, size, /*copy=*/1, &img);
+  if (rc != 0) return vt__fail(vm, rc, "image VTBC invalide");
+  return vt__load_img(vm, img, 1);
+#else
   return -ENOSYS;
+#endif
+}
+
+int vt_vm_load_img(vt_vm* vm, vt_img* img) {
+  if (!vm || !img) return -EINVAL;
+#ifdef VT_OBJECT_H
+  return vt__load_img(vm, img, 0);
+#else
+  return -ENOSYS;
+#endif
+}
+
+int vt_vm_load_code(vt_vm* vm, const uint8_t* code, size_t len,
+                    uint16_t nlocals) {
+  if (!vm || !code || !len || len > UINT32_MAX) return -EINVAL;
+#ifdef VT_OBJECT_H
+  vt__unload(vm);
+  vt__vprog* pg = NULL;
+  int rc = vt__prog_build(vm, code, len, NULL, 0, NULL, 0, nlocals, &pg);
+  if (rc != 0) return rc;
+  vm->prog_own = pg;
+  rc = vt__attach(vm, pg);
+  if (rc != 0) vt__unload(vm);
+  return rc;
+#else
+  (void)nlocals;
+  return -ENOSYS;
+#endif
 }
 
 int vt_vm_run(vt_vm* vm, uint64_t step_limit) {
-  (void)vm;
+  if (!vm) return -EINVAL;
+#ifdef VT_OBJECT_H
+  if (!vm->prog) return vt__fail(vm, -ENOENT, "aucun programme chargé");
+  if (vm->status != VT__SUSPENDED) {
+    int rc = vt__start(vm);
+    if (rc != 0) return rc;
+  }
+  if (!step_limit) step_limit = vm->cfg.default_step_limit;
+  return vt__exec(vm, step_limit ? step_limit : UINT64_MAX);
+#else
   (void)step_limit;
   return -ENOSYS;
+#endif
+}
+
+int vt_vm_result(const vt_vm* vm, vt_value* out) {
+#ifdef VT_OBJECT_H
+  if (!vm || vm->status != VT__DONE || vm->sp == 0) return 0;
+  if (out) *out = vm->stack[vm->sp - 1];
+  return 1;
+#else
+  (void)vm;
+  (void)out;
+  return 0;
+#endif
+}
+
+const char* vt_vm_last_error(const vt_vm* vm) { return vm ? vm->err : ""; }
+
+uint64_t vt_vm_steps(const vt_vm* vm) {
+#ifdef VT_OBJECT_H
+  return vm ? vm->steps : 0;
+#else
+  (void)vm;
+  return 0;
+#endif
+}
+
+int vt_vm_ic_stats(const vt_vm* vm, vt_vm_icstats* out) {
+  if (!vm || !out) return -EINVAL;
+#if defined(VT_OBJECT_H) && defined(VT_VM_PROFILE)
+  *out = vm->icstat;
+  return 0;
+#else
+  memset(out, 0, sizeof *out);
+  return -ENOTSUP;
+#endif
+}
+
+int vt_vm_set_profile(vt_vm* vm, uint64_t* hits) {
+  if (!vm) return -EINVAL;
+#if defined(VT_OBJECT_H) && defined(VT_VM_PROFILE)
+  vm->prof = hits;
+  return 0;
+#else
+  (void)hits;
+  return -ENOTSUP;
+#endif
+}
+
+/* ----------------------------------------------------------------------------
+   Micro-benchmarks par famille d’opcodes
+   cc -std=gnu17 -O2 -DVT_VM_BENCH vm.c ir.c opcodes.c undump.c hash.c gc.c \
+      jit.c mem.c mmap.c -lm
+   (ajouter -DVT_VM_NO_THREADED pour mesurer le dispatch par switch;
+    profil par opcode avant/après fusion: -DVT_VM_PROFILE ... jumptab.c;
+    valeurs NaN-boxées sur 8 octets: -DVT_VALUE_NANBOX, à comparer au défaut)
+   Test différentiel des mêmes programmes: -DVT_VM_TEST au lieu de
+   -DVT_VM_BENCH (voir plus bas).
+---------------------------------------------------------------------------- */
+#if (defined(VT_VM_BENCH) || defined(VT_VM_TEST)) && defined(VT_OBJECT_H)
+static void vb_op(vt_bcode* bc, vt_opcode op, uint64_t a, uint64_t b) {
+  uint64_t imm[3] = {a, b, 0};
+  vt_emit_insn(bc, op, imm);
+}
+static void vb_fop(vt_bcode* bc, vt_opcode op, double d) {
+  uint64_t u;
+  memcpy(&u, &d, sizeof u);
+  vb_op(bc, op, u, 0);
+}
+static void vb_patch(vt_bcode* bc, size_t at, size_t target) {
+  vt_patch_rel32(bc->data, at, (int32_t)((int64_t)target - (int64_t)(at + 5)));
+}
+
+/* slot 0 = compteur; pre() initialise les autres locaux. */
+typedef void (*vb_emit_fn)(vt_bcode* bc);
+static void vb_loop(vt_bcode* bc, int64_t n, vb_emit_fn pre, vb_emit_fn body) {
+  if (pre) pre(bc);
+  vb_op(bc, OP_ICONST, 0, 0);
+  vb_op(bc, OP_ST, 0, 0);
+  size_t top = bc->len;
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_ICONST, (uint64_t)n, 0);
+  vb_op(bc, OP_LT, 0, 0);
+  size_t jf = bc->len;
+  vb_op(bc, OP_JF, 0, 0);
+  if (body) body(bc);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_ICONST, 1, 0);
+  vb_op(bc, OP_ADD, 0, 0);
+  vb_op(bc, OP_ST, 0, 0);
+  size_t jmp = bc->len;
+  vb_op(bc, OP_JMP, 0, 0);
+  vb_patch(bc, jmp, top);
+  vb_patch(bc, jf, bc->len);
+  vb_op(bc, OP_HALT, 0, 0);
+}
+
+static void b_nop(vt_bcode* bc) {
+  for (int i = 0; i < 8; i++) vb_op(bc, OP_NOP, 0, 0);
+}
+static void b_stack(vt_bcode* bc) {
+  vb_op(bc, OP_ICONST, 1, 0);
+  vb_op(bc, OP_DUP, 0, 0);
+  vb_op(bc, OP_SWAP, 0, 0);
+  vb_op(bc, OP_POP, 2, 0);
+}
+static void b_locals(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_ST, 2, 0);
+  vb_op(bc, OP_LD, 2, 0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void p_int(vt_bcode* bc) {
+  vb_op(bc, OP_ICONST, 1, 0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void b_iarith(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_ICONST, 3, 0);
+  vb_op(bc, OP_MUL, 0, 0);
+  vb_op(bc, OP_ICONST, 7, 0);
+  vb_op(bc, OP_ADD, 0, 0);
+  vb_op(bc, OP_ICONST, 1000003, 0);
+  vb_op(bc, OP_MOD, 0, 0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void p_flt(vt_bcode* bc) {
+  vb_fop(bc, OP_FCONST, 1.0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void b_farith(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_fop(bc, OP_FCONST, 1.0000001);
+  vb_op(bc, OP_MUL, 0, 0);
+  vb_fop(bc, OP_FCONST, 0.5);
+  vb_op(bc, OP_SUB, 0, 0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void b_branch(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_ICONST, 5, 0);
+  vb_op(bc, OP_GE, 0, 0);
+  size_t j = bc->len;
+  vb_op(bc, OP_JT, 0, 0);
+  vb_op(bc, OP_NOP, 0, 0);
+  vb_patch(bc, j, bc->len);
+}
+static void p_arr(vt_bcode* bc) {
+  vb_op(bc, OP_NEWA, 0, 0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void b_arr(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_APUSH, 0, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_AGET, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+}
+static void b_afill(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_APUSH, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+}
+/* Tableau l1 de `count` entiers construit avant la boucle (compteur slot 2,
+   remis à 0). */
+static void vb_fill(vt_bcode* bc, int64_t count) {
+  p_arr(bc);
+  vb_op(bc, OP_ICONST, 0, 0);
+  vb_op(bc, OP_ST, 2, 0);
+  size_t top = bc->len;
+  vb_op(bc, OP_LD, 2, 0);
+  vb_op(bc, OP_ICONST, (uint64_t)count, 0);
+  vb_op(bc, OP_LT, 0, 0);
+  size_t jf = bc->len;
+  vb_op(bc, OP_JF, 0, 0);
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 2, 0);
+  vb_op(bc, OP_APUSH, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+  vb_op(bc, OP_LD, 2, 0);
+  vb_op(bc, OP_ICONST, 1, 0);
+  vb_op(bc, OP_ADD, 0, 0);
+  vb_op(bc, OP_ST, 2, 0);
+  size_t jmp = bc->len;
+  vb_op(bc, OP_JMP, 0, 0);
+  vb_patch(bc, jmp, top);
+  vb_patch(bc, jf, bc->len);
+  vb_op(bc, OP_ICONST, 0, 0);
+  vb_op(bc, OP_ST, 2, 0);
+}
+/* Tableau de VB_ASCAN entiers, puis parcours séquentiel: sensible à la
+   taille de vt_value. */
+#define VB_ASCAN (1 << 20)
+static void p_ascan(vt_bcode* bc) { vb_fill(bc, VB_ASCAN); }
+static void b_ascan(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 2, 0);
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_ICONST, VB_ASCAN, 0);
+  vb_op(bc, OP_MOD, 0, 0);
+  vb_op(bc, OP_AGET, 0, 0);
+  vb_op(bc, OP_ADD, 0, 0);
+  vb_op(bc, OP_ST, 2, 0);
+}
+static void p_map(vt_bcode* bc) {
+  vb_op(bc, OP_NEWM, 0, 0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void b_map(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_ICONST, 256, 0);
+  vb_op(bc, OP_MOD, 0, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_MSET, 0, 0);
+  vb_op(bc, OP_ICONST, 7, 0);
+  vb_op(bc, OP_MGET, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+}
+/* Accès "champs": clés fixes sur une map de 8 entrées (caches en ligne). */
+static void p_props(vt_bcode* bc) {
+  vb_op(bc, OP_NEWM, 0, 0);
+  vb_op(bc, OP_ST, 1, 0);
+  for (int k = 0; k < 8; k++) {
+    vb_op(bc, OP_LD, 1, 0);
+    vb_op(bc, OP_ICONST, (uint64_t)(16 * k + 3), 0);
+    vb_op(bc, OP_ICONST, (uint64_t)k, 0);
+    vb_op(bc, OP_MSET, 0, 0);
+    vb_op(bc, OP_POP, 1, 0);
+  }
+}
+static void b_props(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_ICONST, 3, 0);
+  vb_op(bc, OP_MGET, 0, 0);
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_ICONST, 51, 0);
+  vb_op(bc, OP_MGET, 0, 0);
+  vb_op(bc, OP_ADD, 0, 0);
+  vb_op(bc, OP_ST, 2, 0);
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_ICONST, 99, 0);
+  vb_op(bc, OP_LD, 2, 0);
+  vb_op(bc, OP_MSET, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+}
+static void p_global(vt_bcode* bc) {
+  vb_op(bc, OP_ICONST, 0, 0);
+  vb_op(bc, OP_STG, 1, 0);
+}
+static void b_global(vt_bcode* bc) {
+  vb_op(bc, OP_LDG, 1, 0);
+  vb_op(bc, OP_ICONST, 1, 0);
+  vb_op(bc, OP_ADD, 0, 0);
+  vb_op(bc, OP_STG, 1, 0);
+}
+static void b_native(vt_bcode* bc) {
+  vb_op(bc, OP_LDG, 0, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_CALL, 1, 1);
+  vb_op(bc, OP_POP, 1, 0);
+}
+/* objets éphémères: [i, i] remplace le précédent dans l2 */
+static void b_alloc(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_NEWA, 2, 0);
+  vb_op(bc, OP_ST, 2, 0);
+}
+static void b_strcat(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_ICONST, 7, 0);
+  vb_op(bc, OP_CONCAT, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+}
+/* survivants: [i] poussé dans un tableau ancien (barrière + promotion) */
+static void b_retain(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_NEWA, 1, 0);
+  vb_op(bc, OP_APUSH, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+}
+/* anneau de VB_RING survivants: [i] remplace l1[i % VB_RING], qui devient
+   déchet dans l’ancien; vivants bornés, cycles réguliers */
+#define VB_RING (1 << 15)
+static void p_ring(vt_bcode* bc) { vb_fill(bc, VB_RING); }
+static void b_ring(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_ICONST, VB_RING, 0);
+  vb_op(bc, OP_MOD, 0, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_NEWA, 1, 0);
+  vb_op(bc, OP_ASET, 0, 0);
+  vb_op(bc, OP_POP, 1, 0);
+}
+static void b_try(vt_bcode* bc) {
+  size_t t = bc->len;
+  vb_op(bc, OP_TENTER, 0, 0);
+  vb_op(bc, OP_ICONST, 1, 0);
+  vb_op(bc, OP_THROW, 0, 0);
+  vb_patch(bc, t, bc->len);
+  vb_op(bc, OP_POP, 1, 0);
+}
+static void p_clo(vt_bcode* bc) {
+  vb_op(bc, OP_LOADK, 0, 0);
+  vb_op(bc, OP_ST, 1, 0);
+}
+static void b_call(vt_bcode* bc) {
+  vb_op(bc, OP_LD, 1, 0);
+  vb_op(bc, OP_LD, 0, 0);
+  vb_op(bc, OP_CALL, 1, 1);
+  vb_op(bc, OP_POP, 1, 0);
+}
+
+static vt_value vb_native_inc(vt_vm* vm, int argc, vt_value* argv) {
+  (void)vm;
+  return vt_int(argc ? vt_as_int(&argv[0]) + 1 : 0);
+}
+
+/* Image VTBC minimale: CODE (main + f(x)=x+1), FUNC, KCON. */
+static uint8_t* vb_image(const vt_bcode* main_bc, size_t* out_sz) {
+  vt_bcode fn;
+  vt_bcode_init(&fn);
+  vb_op(&fn, OP_LD, 0, 0);
+  vb_op(&fn, OP_ICONST, 1, 0);
+  vb_op(&fn, OP_ADD, 0, 0);
+  vb_op(&fn, OP_RET, 1, 0);
+  uint8_t funcs[4 + 2 * 12] = {2};
+  uint8_t kcon[4 + 1 + 4] = {1, 0, 0, 0, VT_FUNC, 1, 0, 0, 0};
+  uint32_t ent[2][3] = {{0, (uint32_t)main_bc->len, 0x00030000u},
+                        {(uint32_t)main_bc->len, (uint32_t)fn.len, 0x00010001u}};
+  for (int i = 0; i < 2; i++)
+    for (int k = 0; k < 3; k++)
+      for (int b = 0; b < 4; b++)
+        funcs[4 + i * 12 + k * 4 + b] = (uint8_t)(ent[i][k] >> (8 * b));
+  const size_t hdr = 32 + 3 * 24;
+  size_t code_sz = main_bc->len + fn.len;
+  size_t total = hdr + code_sz + sizeof funcs + sizeof kcon;
+  uint8_t* img = (uint8_t*)calloc(1, total);
+  if (!img) return NULL;
+  memcpy(img, "VTBC", 4);
+  img[4] = 1;  /* ver 1.0 */
+  img[8] = 1;  /* LE */
+  img[12] = (uint8_t)hdr;
+  for (int b = 0; b < 8; b++) img[16 + b] = (uint8_t)((uint64_t)total >> (8 * b));
+  img[28] = 3;
+  const char* tags[3] = {"CODE", "FUNC", "KCON"};
+  size_t offs[3] = {hdr, hdr + code_sz, hdr + code_sz + sizeof funcs};
+  size_t szs[3] = {code_sz, sizeof funcs, sizeof kcon};
+  for (int i = 0; i < 3; i++) {
+    uint8_t* e = img + 32 + i * 24;
+    memcpy(e, tags[i], 4);
+    for (int b = 0; b < 8; b++) {
+      e[8 + b] = (uint8_t)((uint64_t)offs[i] >> (8 * b));
+      e[16 + b] = (uint8_t)((uint64_t)szs[i] >> (8 * b));
+    }
+  }
+  memcpy(img + hdr, main_bc->data, main_bc->len);
+  memcpy(img + hdr + main_bc->len, fn.data, fn.len);
+  memcpy(img + offs[1], funcs, sizeof funcs);
+  memcpy(img + offs[2], kcon, sizeof kcon);
+  uint32_t c = ~0u;
+  for (size_t i = hdr; i < total; i++) {
+    c ^= img[i];
+    for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+  }
+  c = ~c;
+  for (int b = 0; b < 4; b++) img[24 + b] = (uint8_t)(c >> (8 * b));
+  vt_bcode_free(&fn);
+  *out_sz = total;
+  return img;
+}
+
+#endif /* VT_VM_BENCH || VT_VM_TEST */
+
+#if defined(VT_VM_BENCH) && defined(VT_OBJECT_H)
+#include <time.h>
+
+#ifdef VT_VM_PROFILE
+/* Profileur de jumptab.c (API autonome, sans header dédié). */
+typedef void (*vt_jt_handler)(void* ctx, uint8_t op, const uint8_t* code,
+                              size_t len, size_t* ip);
+typedef struct {
+  vt_jt_handler table[256];
+  vt_jt_handler def_handler;
+  uint64_t hits[256];
+  int profile_on;
+} vt_jumptab;
+void vt_jt_init(vt_jumptab* jt, vt_jt_handler def_handler);
+void vt_jt_profile(vt_jumptab* jt, int on);
+void vt_jt_profile_dump(const vt_jumptab* jt, FILE* out);
+#endif
+
+static double vb_now(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double vb_run(const char* name, vb_emit_fn pre, vb_emit_fn body,
+                     int64_t n, int image, double base_ns) {
+  vt_bcode bc;
+  vt_bcode_init(&bc);
+  vb_loop(&bc, n, pre, body);
+  vt_vm* vm = vt_vm_new(NULL);
+  vt_vm_set_native(vm, 0, vb_native_inc);
+  int rc;
+  if (image) {
+    size_t sz = 0;
+    uint8_t* img = vb_image(&bc, &sz);
+    rc = img ? vt_vm_load_memory(vm, img, sz) : -ENOMEM;
+    free(img);
+  } else {
+    rc = vt_vm_load_code(vm, bc.data, bc.len, 3);
+  }
+  double ns = 0.0;
+  if (rc == 0) {
+    double t0 = vb_now();
+    rc = vt_vm_run(vm, 0);
+    double dt = vb_now() - t0;
+    ns = dt * 1e9 / (double)n;
+    uint64_t steps = vt_vm_steps(vm);
+    if (rc == 0)
+        printf("  %-16s %8.2f ns/iter  %8.2f ns/iter net  %7.1f Minsn/s\n",
+             name, ns, ns - base_ns, (double)steps / dt * 1e-6);
+#ifdef VT_VM_PROFILE
+    vt_vm_icstats ic;
+    if (rc == 0 && vt_vm_ic_stats(vm, &ic) == 0 &&
+        ic.mget_hits + ic.mget_misses + ic.mset_hits + ic.mset_misses +
+            ic.call_hits + ic.call_misses)
+      printf("  %-16s ic mget %llu/%llu  mset %llu/%llu  call %llu/%llu\n",
+             "", (unsigned long long)ic.mget_hits,
+             (unsigned long long)ic.mget_misses,
+             (unsigned long long)ic.mset_hits,
+             (unsigned long long)ic.mset_misses,
+             (unsigned long long)ic.call_hits,
+             (unsigned long long)ic.call_misses);
+#endif
+  }
+  if (rc != 0) printf("  %-16s ERREUR %d: %s\n", name, rc, vt_vm_last_error(vm));
+  vt_vm_free(vm);
+  vt_bcode_free(&bc);
+  return ns;
+}
+
+/* Nursery (défaut) contre mark-sweep seul (cfg.no_nursery). Cycles et
+   part des collectes complètes (marquage + sweep) dans le temps mesuré:
+   un coût dominé par le GC se voit au lieu d’être imputé à l’allocateur. */
+static void vb_gc(const char* name, vb_emit_fn pre, vb_emit_fn body,
+                  int64_t n) {
+  vt_bcode bc;
+  vt_bcode_init(&bc);
+  vb_loop(&bc, n, pre, body);
+  printf("  %s\n", name);
+  for (int m = 0; m < 2; m++) {
+    vt_vm_config cfg = VT_VM_DEFAULT_CFG;
+    cfg.no_nursery = m == 1;
+    vt_vm* vm = vt_vm_new(&cfg);
+    int rc = vt_vm_load_code(vm, bc.data, bc.len, 3);
+    double t0 = vb_now();
+    if (rc == 0) rc = vt_vm_run(vm, 0);
+    double dt = vb_now() - t0;
+    vt_gc_stats st;
+    vt_gc_get_stats(vm->gc, &st);
+    if (rc == 0)
+      printf("    %-9s %8.2f ns/iter  cycles %llu  mineures %llu  "
+             "complètes %4.1f %%\n", m ? "mark-sweep" : "nursery",
+             dt * 1e9 / (double)n, (unsigned long long)st.cycles,
+             (unsigned long long)st.minors,
+             (double)(st.mark_ns_total + st.sweep_ns_total) * 1e-7 / dt);
+    else
+      printf("    ERREUR %d: %s\n", rc, vt_vm_last_error(vm));
+    vt_vm_free(vm);
+  }
+  vt_bcode_free(&bc);
+}
+
+/* Pause maximale: collectes d’un bloc contre tranches incrémentales. Sans
+   cycle complet les chiffres ne mesurent rien: -1. */
+static int vb_pause(const char* name, vb_emit_fn pre, vb_emit_fn body,
+                    int64_t n) {
+  vt_bcode bc;
+  vt_bcode_init(&bc);
+  vb_loop(&bc, n, pre, body);
+  printf("  %s\n", name);
+  int ret = 0;
+  for (int m = 0; m < 2; m++) {
+    vt_vm_config cfg = VT_VM_DEFAULT_CFG;
+    cfg.gc_slice_us = m ? 200 : 0;
+    vt_vm* vm = vt_vm_new(&cfg);
+    int rc = vt_vm_load_code(vm, bc.data, bc.len, 3);
+    double t0 = vb_now();
+    if (rc == 0) rc = vt_vm_run(vm, 0);
+    double dt = vb_now() - t0;
+    vt_gc_stats st;
+    vt_gc_get_stats(vm->gc, &st);
+    uint64_t worst = st.stw_ns_max;
+    if (st.slice_ns_max > worst) worst = st.slice_ns_max;
+    if (st.remark_ns_max > worst) worst = st.remark_ns_max;
+    if (rc != 0) {
+      printf("    ERREUR %d: %s\n", rc, vt_vm_last_error(vm));
+      ret = -1;
+    } else if (st.cycles == 0) {
+      printf("    ERREUR: aucun cycle en %lld itérations\n", (long long)n);
+      ret = -1;
+    } else {
+      printf("    %-11s %8.2f ns/iter  cycles %llu  tranches %llu  "
+             "pause max %.3f ms (remarque %.3f, mineure %.3f)\n",
+             m ? "incrémental" : "bloc", dt * 1e9 / (double)n,
+             (unsigned long long)st.cycles, (unsigned long long)st.slices,
+             (double)worst * 1e-6, (double)st.remark_ns_max * 1e-6,
+             (double)st.minor_ns_max * 1e-6);
+    }
+    vt_vm_free(vm);
+  }
+  vt_bcode_free(&bc);
+  return ret;
+}
+
+/* Même boucle en pile brute, pile + superinstructions, forme registres,
+   puis forme registres + JIT (x86-64): dispatchs et temps. */
+static void vb_fuse(const char* name, vb_emit_fn pre, vb_emit_fn body,
+                    int64_t n) {
+  static const char* const modes[4] = {"brut", "fusionné", "registres",
+                                       "jit"};
+  vt_bcode bc;
+  vt_bcode_init(&bc);
+  vb_loop(&bc, n, pre, body);
+  printf("  %s\n", name);
+  for (int m = 0; m < 3 + VT_VM_JIT; m++) {
+    vt_vm_config cfg = VT_VM_DEFAULT_CFG;
+    cfg.no_fuse = m == 0;
+    cfg.no_regs = m < 2;
+    cfg.jit_hot = m == 3 ? 100 : 0;
+    vt_vm* vm = vt_vm_new(&cfg);
+#ifdef VT_VM_PROFILE
+    vt_jumptab jt;
+    vt_jt_init(&jt, NULL);
+    vt_jt_profile(&jt, 1);
+    vt_vm_set_profile(vm, jt.hits);
+#endif
+    int rc = vt_vm_load_code(vm, bc.data, bc.len, 3);
+    double t0 = vb_now();
+    if (rc == 0) rc = vt_vm_run(vm, 0);
+    double dt = vb_now() - t0;
+    if (rc == 0)
+      printf("    %-9s %12llu dispatchs  %6.2f/iter  %8.2f ns/iter\n",
+             modes[m], (unsigned long long)vt_vm_steps(vm),
+             (double)vt_vm_steps(vm) / (double)n, dt * 1e9 / (double)n);
+    else
+      printf("    ERREUR %d: %s\n", rc, vt_vm_last_error(vm));
+#ifdef VT_VM_PROFILE
+    vt_jt_profile_dump(&jt, stdout);
+#endif
+    vt_vm_free(vm);
+  }
+  vt_bcode_free(&bc);
+}
+
+int main(int argc, char** argv) {
+  int64_t n = argc > 1 ? atoll(argv[1]) : 5000000;
+  printf("vm bench: %lld itérations, dispatch=%s, valeurs=%s (%zu octets)\n",
+         (long long)n, VT_VM_THREADED ? "threaded" : "switch",
+#ifdef VT_VALUE_NANBOX
+         "nanbox",
+#else
+         "struct",
+#endif
+         sizeof(vt_value));
+  double base = vb_run("boucle vide", NULL, NULL, n, 0, 0.0);
+  vb_run("nop x8", NULL, b_nop, n, 0, base);
+  vb_run("pile", NULL, b_stack, n, 0, base);
+  vb_run("locaux", NULL, b_locals, n, 0, base);
+  vb_run("globaux", p_global, b_global, n, 0, base);
+  vb_run("arith int", p_int, b_iarith, n, 0, base);
+  vb_run("arith float", p_flt, b_farith, n, 0, base);
+  vb_run("cmp/branch", NULL, b_branch, n, 0, base);
+  vb_run("array", p_arr, b_arr, n / 4, 0, base);
+  vb_run("array fill", p_arr, b_afill, n, 0, base);
+  vb_run("array scan", p_ascan, b_ascan, n, 0, base);
+  vb_run("map", p_map, b_map, n, 0, base);
+  vb_run("map champs", p_props, b_props, n, 0, base);
+  vb_run("call native", NULL, b_native, n, 0, base);
+  vb_run("call closure", p_clo, b_call, n, 1, base);
+  vb_run("try/throw", NULL, b_try, n / 4, 0, base);
+  printf("superinstructions (vt_fuse), forme registres (ir.h), JIT:\n");
+  vb_fuse("boucle vide", NULL, NULL, n);
+  vb_fuse("locaux", NULL, b_locals, n);
+  vb_fuse("arith int", p_int, b_iarith, n);
+  vb_fuse("arith float", p_flt, b_farith, n);
+  vb_fuse("cmp/branch", NULL, b_branch, n);
+  vb_fuse("globaux", p_global, b_global, n);
+  printf("GC, génération jeune:\n");
+  vb_gc("alloc array", NULL, b_alloc, n);
+  vb_gc("alloc string", NULL, b_strcat, n);
+  vb_gc("array gardés", p_arr, b_retain, n / 4);
+  printf("GC, pauses (anneau de %d survivants):\n", VB_RING);
+  return vb_pause("array remplacés", p_ring, b_ring, n / 2) ? 1 : 0;
+}
+#endif /* VT_VM_BENCH */
+
+/* ----------------------------------------------------------------------------
+   Test différentiel: chaque programme du bench tourne dans chaque mode
+   (pile brute, superinstructions, registres, JIT) et doit laisser le même
+   résultat, la même pile finale et les mêmes globaux que la pile brute.
+   cc -std=gnu17 -O2 -DVT_VM_TEST vm.c ir.c opcodes.c undump.c hash.c gc.c \
+      jit.c mem.c mmap.c -lm
+---------------------------------------------------------------------------- */
+#if defined(VT_VM_TEST) && defined(VT_OBJECT_H)
+/* Égalité structurelle: les objets de deux VM n'ont jamais la même adresse. */
+static int vt__tsame(const vt_value* a, const vt_value* b, int depth) {
+  if (vt_value_type(a) != vt_value_type(b)) return 0;
+  if (depth > 16) return 1;
+  switch (vt_value_type(a)) {
+    case VT_NIL: return 1;
+    case VT_BOOL:
+    case VT_INT: return vt_as_int(a) == vt_as_int(b);
+    case VT_FLOAT: {
+      double x = vt_as_float(a), y = vt_as_float(b);
+      return memcmp(&x, &y, sizeof x) == 0;
+    }
+    case VT_STR: {
+      const vt__vstr* x = (const vt__vstr*)vt_as_ptr(a);
+      const vt__vstr* y = (const vt__vstr*)vt_as_ptr(b);
+      return x->len == y->len && memcmp(x->data, y->data, x->len) == 0;
+    }
+    case VT_ARRAY: {
+      const vt__varr* x = (const vt__varr*)vt_as_ptr(a);
+      const vt__varr* y = (const vt__varr*)vt_as_ptr(b);
+      if (x->len != y->len) return 0;
+      for (size_t i = 0; i < x->len; i++)
+        if (!vt__tsame(&x->items[i], &y->items[i], depth + 1)) return 0;
+      return 1;
+    }
+    case VT_MAP: {
+      const vt__vmap* x = (const vt__vmap*)vt_as_ptr(a);
+      const vt__vmap* y = (const vt__vmap*)vt_as_ptr(b);
+      if (x->len != y->len) return 0;
+      for (size_t i = 0; i < x->cap; i++) {
+        const vt__vment* e = &x->ents[i];
+        if (!e->h) continue;
+        const vt__vment* f = vt__map_slot(y, &e->key, e->h);
+        if (!f->h || !vt__tsame(&e->val, &f->val, depth + 1)) return 0;
+      }
+      return 1;
+    }
+    case VT_FUNC: {
+      const vt__vclo* x = (const vt__vclo*)vt_as_ptr(a);
+      const vt__vclo* y = (const vt__vclo*)vt_as_ptr(b);
+      if (x->fn != y->fn || x->nup != y->nup) return 0;
+      for (uint32_t i = 0; i < x->nup; i++)
+        if (!vt__tsame(&x->up[i], &y->up[i], depth + 1)) return 0;
+      return 1;
+    }
+    default: return vt_as_ptr(a) == vt_as_ptr(b);
+  }
+}
+
+typedef struct {
+  const char* name;
+  vb_emit_fn pre, body;
+  int64_t n;
+  int image;
+} vt__tprog;
+
+static const char* const vt__tmodes[] = {"brut", "fusionné", "registres",
+                                         "jit", "sans nursery"};
+
+/* Modes 0-3 comme vb_fuse; 4 = registres, GC mark-sweep sans nursery. */
+static void vt__tmode(vt_vm_config* cfg, int m) {
+  *cfg = VT_VM_DEFAULT_CFG;
+  cfg->no_fuse = m == 0;
+  cfg->no_regs = m < 2;
+  cfg->jit_hot = m == 3 ? 100 : 0;
+  cfg->no_nursery = m == 4;
+}
+
+static vt_vm* vt__trun(const vt__tprog* p, const vt_vm_config* cfg, int* rc) {
+  vt_bcode bc;
+  vt_bcode_init(&bc);
+  vb_loop(&bc, p->n, p->pre, p->body);
+  vt_vm* vm = vt_vm_new(cfg);
+  vt_vm_set_native(vm, 0, vb_native_inc);
+  if (p->image) {
+    size_t sz = 0;
+    uint8_t* img = vb_image(&bc, &sz);
+    *rc = img ? vt_vm_load_memory(vm, img, sz) : -ENOMEM;
+    free(img);
+  } else {
+    *rc = vt_vm_load_code(vm, bc.data, bc.len, 3);
+  }
+  if (*rc == 0) *rc = vt_vm_run(vm, 0);
+  vt_bcode_free(&bc);
+  return vm;
+}
+
+/* 0 si vm et ref ont fini pareil; sinon message et 1. */
+static int vt__tcheck(const char* name, const char* mode, vt_vm* vm, int rc,
+                      vt_vm* ref, int ref_rc) {
+  const char* what = NULL;
+  vt_value x = vt_nil(), y = vt_nil();
+  if (rc != ref_rc || rc != 0) {
+    what = "code retour";
+  } else if (vt_vm_result(vm, &x) != vt_vm_result(ref, &y) ||
+             !vt__tsame(&x, &y, 0)) {
+    what = "résultat";
+  } else if (vm->sp != ref->sp) {
+    what = "hauteur de pile";
+  } else if (vm->nglobals != ref->nglobals) {
+    what = "nombre de globaux";
+  } else {
+    for (size_t i = 0; i < vm->sp && !what; i++)
+      if (!vt__tsame(&vm->stack[i], &ref->stack[i], 0)) what = "pile";
+    for (size_t i = 0; i < vm->nglobals && !what; i++)
+      if (!vt__tsame(&vm->globals[i], &ref->globals[i], 0)) what = "globaux";
+  }
+  if (!what) return 0;
+  fprintf(stderr, "vm: échec %s [%s]: %s (rc %d, réf. %d)%s%s\n", name, mode,
+          what, rc, ref_rc, rc ? ": " : "", rc ? vt_vm_last_error(vm) : "");
+  return 1;
+}
+
+int main(void) {
+  static const vt__tprog progs[] = {
+      {"boucle vide", NULL, NULL, 20000, 0},
+      {"nop x8", NULL, b_nop, 20000, 0},
+      {"pile", NULL, b_stack, 20000, 0},
+      {"locaux", NULL, b_locals, 20000, 0},
+      {"globaux", p_global, b_global, 20000, 0},
+      {"arith int", p_int, b_iarith, 20000, 0},
+      {"arith float", p_flt, b_farith, 20000, 0},
+      {"cmp/branch", NULL, b_branch, 20000, 0},
+      {"array", p_arr, b_arr, 5000, 0},
+      {"array fill", p_arr, b_afill, 20000, 0},
+      {"array scan", p_ascan, b_ascan, 2000, 0},
+      {"map", p_map, b_map, 20000, 0},
+      {"map champs", p_props, b_props, 20000, 0},
+      {"call native", NULL, b_native, 20000, 0},
+      {"call closure", p_clo, b_call, 20000, 1},
+      {"try/throw", NULL, b_try, 5000, 0},
+      {"alloc array", NULL, b_alloc, 20000, 0},
+      {"alloc string", NULL, b_strcat, 20000, 0},
+      {"array gardés", p_arr, b_retain, 5000, 0},
+      {"array remplacés", p_ring, b_ring, 20000, 0},
+  };
+  int fails = 0;
+  for (size_t i = 0; i < sizeof progs / sizeof progs[0]; i++) {
+    const vt__tprog* p = &progs[i];
+    vt_vm_config cfg;
+    vt__tmode(&cfg, 0);
+    int ref_rc;
+    vt_vm* ref = vt__trun(p, &cfg, &ref_rc);
+    for (int m = 0; m < 5; m++) {
+      if (m == 3 && !VT_VM_JIT) continue;
+      vt__tmode(&cfg, m);
+      int rc;
+      vt_vm* vm = vt__trun(p, &cfg, &rc);
+      fails += vt__tcheck(p->name, vt__tmodes[m], vm, rc, ref, ref_rc);
+      vt_vm_free(vm);
+    }
+    vt_vm_free(ref);
+  }
+  /* Stress GC: anneau de survivants remplacés, nursery + incrémental, assez
+     d'itérations pour des mineures et des cycles complets en tranches. */
+  {
+    const vt__tprog p = {"gc stress", p_ring, b_ring, 300000, 0};
+    vt_vm_config cfg;
+    vt__tmode(&cfg, 0);
+    int ref_rc, rc;
+    vt_vm* ref = vt__trun(&p, &cfg, &ref_rc);
+    vt__tmode(&cfg, 2);
+    cfg.gc_slice_us = 50;
+    vt_vm* vm = vt__trun(&p, &cfg, &rc);
+    vt_gc_stats st;
+    vt_gc_get_stats(vm->gc, &st);
+    if (vt__tcheck(p.name, "nursery + incrémental", vm, rc, ref, ref_rc)) {
+      fails++;
+    } else if (!st.minors || !st.cycles || !st.slices) {
+      fprintf(stderr, "vm: échec gc stress: mineures %llu, cycles %llu, "
+              "tranches %llu\n", (unsigned long long)st.minors,
+              (unsigned long long)st.cycles, (unsigned long long)st.slices);
+      fails++;
+    }
+    vt_vm_free(vm);
+    vt_vm_free(ref);
+  }
+  /* Tas vivant au-delà de la limite (8 Mio): le seuil suit les survivants,
+     quelques cycles et non une collecte complète par allocation. */
+  {
+    const vt__tprog p = {"tas gardé", p_arr, b_retain, 400000, 0};
+    vt_vm_config cfg;
+    vt__tmode(&cfg, 0);
+    int ref_rc;
+    vt_vm* ref = vt__trun(&p, &cfg, &ref_rc);
+    for (int m = 2; m < 5; m += 2) {
+      int rc;
+      vt__tmode(&cfg, m);
+      vt_vm* vm = vt__trun(&p, &cfg, &rc);
+      vt_gc_stats st;
+      vt_gc_get_stats(vm->gc, &st);
+      if (vt__tcheck(p.name, vt__tmodes[m], vm, rc, ref, ref_rc)) {
+        fails++;
+      } else if (vt_gc_bytes_live(vm->gc) <= (8u << 20) || !st.cycles ||
+                 st.cycles >= 32) {
+        fprintf(stderr, "vm: échec tas gardé [%s]: %zu octets, %llu cycles\n",
+                vt__tmodes[m], vt_gc_bytes_live(vm->gc),
+                (unsigned long long)st.cycles);
+        fails++;
+      }
+      vt_vm_free(vm);
+    }
+    vt_vm_free(ref);
+  }
+  if (fails) return 1;
+  printf("vm: OK\n");
+  return 0;
 }
+#endif /* VT_VM_TEST */
@@ -84,6 +84,15 @@ typedef struct vt_vm_config {
   int initial_frame_cap;       /* 0 = défaut */
   uint64_t default_step_limit; /* 0 = illimité */
   int enable_traces;           /* 0/1 (si debug.h présent) */
+  int no_fuse;                 /* 1 = pas de superinstructions (vt_fuse) */
+  int no_regs;                 /* 1 = pas de forme registres (ir.h) */
+  uint32_t jit_hot;            /* JIT x86-64 d’une fonction après N entrées
+                                  + sauts arrière; 0 = interprète seul */
+  int no_nursery;              /* 1 = GC sans génération jeune (gc.h) */
+  uint32_t gc_slice_us;        /* >0: GC incrémental, tranches plafonnées
+                                  à N µs; 0 = collectes d’un bloc */
+  uint32_t gc_threads;         /* >1: collectes complètes marquées à N
+                                  threads, sweep en fond */
 } vt_vm_config;
 
 /* --------------------------------------------------------------------------
@@ -104,15 +113,66 @@ VT_VM_API vt_value vt_make_native(vt_cfunc fn);
 /* Chargement d’une image bytecode (VTBC). Nécessite undump.h dans l’impl. */
 VT_VM_API int vt_vm_load_image(vt_vm* vm, const char* path);
 
-/* Exécution : boucle jusqu’à OP_HALT ou erreur. step_limit=0 → illimité.
-   Retourne 0 si OK, code négatif (errno-like) sinon. */
+/* Chargement depuis un tampon mémoire (image VTBC complète, copiée). */
+VT_VM_API int vt_vm_load_memory(vt_vm* vm, const void* data, size_t size);
+
+/* Chargement d’une image déjà ouverte (empruntée: elle doit survivre à la VM).
+   Le flux pré-décodé est mis en cache sur l’image et partagé entre VM. */
+typedef struct vt_img vt_img;
+VT_VM_API int vt_vm_load_img(vt_vm* vm, vt_img* img);
+
+/* Chargement d’un flux CODE brut (une seule fonction d’entrée, sans
+   constantes). Pratique pour les tests et benchs via vt_emit_insn. */
+VT_VM_API int vt_vm_load_code(vt_vm* vm, const uint8_t* code, size_t len,
+                              uint16_t nlocals);
+
+/* Exécution : boucle jusqu’à OP_HALT ou erreur. step_limit=0 → limite par
+   défaut de la config (0 = illimité).
+   Retourne 0 si OK, code négatif (errno-like) sinon:
+     -EAGAIN    : step_limit atteint, un nouvel appel reprend l’exécution
+     -ECANCELED : exception non rattrapée (message: vt_vm_last_error)
+     -ENOENT    : aucun programme chargé */
 VT_VM_API int vt_vm_run(vt_vm* vm, uint64_t step_limit);
 
+/* Sommet de pile après exécution (valeur de HALT/RET). 1=ok, 0=pile vide. */
+VT_VM_API int vt_vm_result(const vt_vm* vm, vt_value* out);
+
+/* Dernier message d’erreur ("" si aucun). */
+VT_VM_API const char* vt_vm_last_error(const vt_vm* vm);
+
+/* Nombre total d’instructions dispatchées depuis le chargement. */
+VT_VM_API uint64_t vt_vm_steps(const vt_vm* vm);
+
+/* Profil de dispatch: hits[op] += 1 à chaque instruction dispatchée (256
+   compteurs, même disposition que vt_jumptab.hits de jumptab.c). NULL coupe.
+   Build -DVT_VM_PROFILE requis, sinon -ENOTSUP. */
+VT_VM_API int vt_vm_set_profile(vt_vm* vm, uint64_t* hits);
+
+/* Caches en ligne des sites MGET/MSET/CALL: succès/échecs cumulés depuis
+   la création. Même build que le profil (-DVT_VM_PROFILE), sinon
+   -ENOTSUP. */
+typedef struct vt_vm_icstats {
+  uint64_t mget_hits, mget_misses;
+  uint64_t mset_hits, mset_misses;
+  uint64_t call_hits, call_misses;
+} vt_vm_icstats;
+VT_VM_API int vt_vm_ic_stats(const vt_vm* vm, vt_vm_icstats* out);
+
 /* --------------------------------------------------------------------------
    Notes:
-   - vt_vm_run peut écrire un message d’erreur interne (non exposé ici).
+   - vt_vm_run écrit un message d’erreur interne (voir vt_vm_last_error).
    - L’ABI des opcodes est définie dans opcodes.h; l’image VTBC fournit
-   CODE/KCON/STRS.
+   CODE/KCON/FUNC (LE):
+     FUNC: u32 count, puis count × { u32 code_off; u32 code_len;
+                                     u16 nparams; u16 nlocals; }
+           La fonction 0 est le point d’entrée.
+     KCON: u32 count, puis count × { u8 tag (vt_type); payload }
+           NIL: -, BOOL: u8, INT: i64, FLOAT: f64, STR: u32 len + octets,
+           FUNC: u32 index dans FUNC.
+   - Globaux: LDG/STG indexent une table de slots; vt_vm_set_native lie le
+     slot symbol_id à la native.
+   - Appels: CALL attend [callee, args...]. Pour une closure, les locaux
+     sont [params..., upvalues..., autres] (upvalues capturées par valeur).
    - vt_value est minimale si object.h absent; si présent, la représentation
      concrète vient de votre runtime.
    -------------------------------------------------------------------------- */
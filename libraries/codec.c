@@ -4,7 +4,8 @@
 // Namespace: "codec"
 //
 // Build:
-//   cc -std=c17 -O2 -Wall -Wextra -pedantic -c codec.c
+//   cc -std=c17 -O2 -Wall -Wextra -pedantic -I.. -c codec.c
+//   (link core/hash.c, core/utf8.c, core/base64.c)
 //
 // Couverture:
 //   - Base64: codec_b64_encode / codec_b64_decode
@@ -26,59 +27,31 @@
 //
 // Notes:
 //   - Retour 0 = OK, -1 = erreur (OOM/entrée invalide).
-//   - Pas de dépendances externes.
+//   - Dépend seulement de core/hash.c (CRC32), core/utf8.c (UTF-8) et
+//     core/base64.c (base64, hex).
 //
 // Option tests:
-//   cc -std=c17 -O2 -Wall -Wextra -pedantic -DCODEC_TEST codec.c && ./a.out
+//   cc -std=c17 -O2 -Wall -Wextra -pedantic -I.. -DCODEC_TEST codec.c ../core/hash.c ../core/utf8.c ../core/base64.c && ./a.out
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
 
+#include "core/hash.h"
+#include "core/utf8.h"
+#include "core/base64.h"
+
 #define RET_ERR() do { return -1; } while (0)
 #define RET_OK()  do { return  0; } while (0)
 
 /* ========================= Base64 ========================= */
 
-static const char B64TAB[] =
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-static const unsigned char B64REV[256] = {
-    /* init at first call */
-};
-
-static void b64rev_init(unsigned char rev[256]) {
-    static int done = 0;
-    if (done) return;
-    for (int i = 0; i < 256; i++) rev[i] = 0x80; // invalid
-    for (int i = 0; i < 64; i++) rev[(unsigned char)B64TAB[i]] = (unsigned char)i;
-    rev[(unsigned char)'='] = 0x40; // pad
-    done = 1;
-}
-
+/* Moteur vectoriel de core/base64.c; seules les allocations restent ici. */
 int codec_b64_encode(const void* in, size_t n, char** out, size_t* outlen) {
-    const unsigned char* p = (const unsigned char*)in;
-    size_t olen = ((n + 2) / 3) * 4;
-    char* o = (char*)malloc(olen + 1);
+    char* o = (char*)malloc(VT_B64_ENC_LEN(n) + 1);
     if (!o) RET_ERR();
-    size_t i = 0, j = 0;
-    while (i + 3 <= n) {
-        uint32_t v = (p[i] << 16) | (p[i+1] << 8) | p[i+2];
-        o[j++] = B64TAB[(v >> 18) & 63];
-        o[j++] = B64TAB[(v >> 12) & 63];
-        o[j++] = B64TAB[(v >> 6) & 63];
-        o[j++] = B64TAB[v & 63];
-        i += 3;
-    }
-    if (i < n) {
-        uint32_t v = p[i] << 16;
-        int rem = (int)(n - i);
-        if (rem == 2) v |= p[i+1] << 8;
-        o[j++] = B64TAB[(v >> 18) & 63];
-        o[j++] = B64TAB[(v >> 12) & 63];
-        o[j++] = (rem == 2) ? B64TAB[(v >> 6) & 63] : '=';
-        o[j++] = '=';
-    }
+    size_t j = vt_b64_encode(in, n, o, 0);
     o[j] = 0;
     *out = o;
     if (outlen) *outlen = j;
@@ -86,39 +59,12 @@ int codec_b64_encode(const void* in, size_t n, char** out, size_t* outlen) {
 }
 
 int codec_b64_decode(const char* in, size_t n, unsigned char** out, size_t* outlen) {
-    b64rev_init((unsigned char*)B64REV);
     const unsigned char* s = (const unsigned char*)in;
     while (n && (s[n-1] == '\n' || s[n-1] == '\r' || s[n-1] == ' ' || s[n-1] == '\t')) n--; // trim
-    if (n % 4 != 0) RET_ERR();
-    size_t olen = (n / 4) * 3;
-    if (n >= 4) {
-        if (s[n-1] == '=') olen--;
-        if (s[n-2] == '=') olen--;
-    }
-    unsigned char* o = (unsigned char*)malloc(olen ? olen : 1);
+    unsigned char* o = (unsigned char*)malloc(n ? VT_B64_DEC_MAX(n) : 1);
     if (!o) RET_ERR();
-    size_t i = 0, j = 0;
-    for (; i < n; i += 4) {
-        unsigned char a = B64REV[s[i]];
-        unsigned char b = B64REV[s[i+1]];
-        unsigned char c = B64REV[s[i+2]];
-        unsigned char d = B64REV[s[i+3]];
-        if (a & 0x80 || b & 0x80) { free(o); RET_ERR(); }
-        uint32_t v = (a << 18) | (b << 12);
-        o[j++] = (v >> 16) & 0xFF;
-        if (c != 0x40) {
-            if (c & 0x80) { free(o); RET_ERR(); }
-            v |= (c << 6);
-            o[j++] = (v >> 8) & 0xFF;
-            if (d != 0x40) {
-                if (d & 0x80) { free(o); RET_ERR(); }
-                v |= d;
-                o[j++] = v & 0xFF;
-            }
-        } else {
-            if (d != 0x40) { free(o); RET_ERR(); }
-        }
-    }
+    size_t j = 0;
+    if (vt_b64_decode(in, n, o, &j, 0) != 0) { free(o); RET_ERR(); }
     *out = o;
     if (outlen) *outlen = j;
     RET_OK();
@@ -126,14 +72,6 @@ int codec_b64_decode(const char* in, size_t n, unsigned char** out, size_t* outl
 
 /* ========================= Hex ========================= */
 
-static inline int is_hex(char c) {
-    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
-}
-static inline unsigned to_hex(int v, int upper) {
-    v &= 0xF;
-    if (v < 10) return '0' + v;
-    return (upper ? 'A' : 'a') + (v - 10);
-}
 static inline int from_hex(char c) {
     if (c >= '0' && c <= '9') return c - '0';
     if (c >= 'a' && c <= 'f') return c - 'a' + 10;
@@ -142,14 +80,10 @@ static inline int from_hex(char c) {
 }
 
 int codec_hex_encode(const void* in, size_t n, int upper, char** out, size_t* outlen) {
-    const unsigned char* p = (const unsigned char*)in;
     size_t olen = n * 2;
     char* o = (char*)malloc(olen + 1);
     if (!o) RET_ERR();
-    for (size_t i = 0, j = 0; i < n; i++) {
-        o[j++] = (char)to_hex(p[i] >> 4, upper);
-        o[j++] = (char)to_hex(p[i], upper);
-    }
+    vt_b16_encode(in, n, o, upper ? VT_B16_UPPER : 0);
     o[olen] = 0;
     *out = o;
     if (outlen) *outlen = olen;
@@ -158,15 +92,10 @@ int codec_hex_encode(const void* in, size_t n, int upper, char** out, size_t* ou
 
 int codec_hex_decode(const char* in, size_t n, unsigned char** out, size_t* outlen) {
     if (n % 2 != 0) RET_ERR();
-    for (size_t i = 0; i < n; i++) if (!is_hex(in[i])) RET_ERR();
-    size_t olen = n / 2;
-    unsigned char* o = (unsigned char*)malloc(olen ? olen : 1);
+    unsigned char* o = (unsigned char*)malloc(n ? n / 2 : 1);
     if (!o) RET_ERR();
-    for (size_t i = 0, j = 0; i < n; i += 2) {
-        int hi = from_hex(in[i]);
-        int lo = from_hex(in[i+1]);
-        o[j++] = (unsigned char)((hi << 4) | lo);
-    }
+    size_t olen = 0;
+    if (vt_b16_decode(in, n, o, &olen) != 0) { free(o); RET_ERR(); }
     *out = o;
     if (outlen) *outlen = olen;
     RET_OK();
@@ -233,52 +162,15 @@ int codec_url_decode(const char* in, size_t n, char** out, size_t* outlen) {
 
 /* ========================= UTF-8 validator ========================= */
 
+/* Stricte (RFC 3629), vectorisée: voir core/utf8.c */
 int codec_utf8_validate(const unsigned char* s, size_t n) {
-    size_t i = 0;
-    while (i < n) {
-        unsigned char c = s[i++];
-        if (c < 0x80) continue;
-        int extra =
-            (c >= 0xC2 && c <= 0xDF) ? 1 :
-            (c >= 0xE0 && c <= 0xEF) ? 2 :
-            (c >= 0xF0 && c <= 0xF4) ? 3 : -1;
-        if (extra < 0 || i + (size_t)extra > n) return 0;
-
-        // first byte specific constraints
-        if (c == 0xE0 && (s[i] < 0xA0 || s[i] > 0xBF)) return 0;        // U+0800..U+0FFF start
-        else if (c == 0xED && (s[i] < 0x80 || s[i] > 0x9F)) return 0;   // no surrogates
-        else if (c == 0xF0 && (s[i] < 0x90 || s[i] > 0xBF)) return 0;   // U+10000..U+3FFFF
-        else if (c == 0xF4 && (s[i] < 0x80 || s[i] > 0x8F)) return 0;   // up to U+10FFFF
-        else if ((c >= 0xC2 && c <= 0xDF) && (s[i] < 0x80 || s[i] > 0xBF)) return 0;
-
-        // continuation bytes
-        for (int k = 0; k < extra; k++) {
-            if (s[i] < 0x80 || s[i] > 0xBF) return 0;
-            i++;
-        }
-    }
-    return 1;
+    return utf8_validate((const char*)s, n);
 }
 
 /* ========================= Checksums ========================= */
 
 uint32_t codec_crc32(uint32_t crc, const void* buf, size_t n) {
-    static uint32_t table[256];
-    static int init = 0;
-    if (!init) {
-        for (uint32_t i = 0; i < 256; i++) {
-            uint32_t c = i;
-            for (int k = 0; k < 8; k++)
-                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
-            table[i] = c;
-        }
-        init = 1;
-    }
-    crc = ~crc;
-    const unsigned char* p = (const unsigned char*)buf;
-    for (size_t i = 0; i < n; i++)
-        crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
-    return ~crc;
+    return vt_crc32(buf, n, crc);
 }
 
 uint32_t codec_adler32(uint32_t adler, const void* buf, size_t n) {
@@ -1,21 +1,33 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 //
-// corolib.c — Coroutines + tiny cooperative scheduler (C17, portable)
+// corolib.c — Coroutines + cooperative schedulers (C17, portable)
 // Namespace: "coro"
 //
 // Features:
-//   - Stackful coroutines: POSIX ucontext or Windows Fibers.
-//   - Tiny round-robin scheduler with sleep (coro_sleep_ms).
-//   - Safe yield/resume, current() accessor, status flags.
-//   - No threads; cooperative only.
+//   - Stackful coroutines: hand-written context switch on x86-64 / AArch64
+//     (callee-saved registers only, no syscall), POSIX ucontext elsewhere,
+//     Windows Fibers.
+//   - Single-thread scheduler: ready FIFO + timer heap; a sleeping coroutine
+//     is parked until its deadline and the scheduler sleeps exactly until
+//     the earliest one.
+//   - M:N runtime (POSIX): N worker threads, each with a ready queue (work
+//     stealing between workers), a timer heap and an ioloop; coroutines
+//     park on fd readiness with coro_wait_fd.
 //
 // Build:
 //   POSIX:   cc -std=c17 -O2 -Wall -Wextra -pedantic -c corolib.c
+//            + ioloop.c (-D_GNU_SOURCE on Linux, see there)
 //   Windows: cl /std:c17 /O2 /W4 /c corolib.c
+//   -DCORO_UCONTEXT forces ucontext on x86-64/AArch64 too (sanitizers must be
+//   told about stack switches; they know swapcontext, not ours). TSan builds
+//   pick ucontext by themselves and annotate the fiber switches.
+//   Test:  cc -std=gnu17 -O2 -DCORO_TEST  corolib.c ioloop.c -lpthread && ./a.out
+//   Bench: cc -std=gnu17 -O2 -DCORO_BENCH corolib.c ioloop.c -lpthread && ./a.out
 //
 // Public API:
 //   typedef struct coro       coro_t;
 //   typedef struct coro_sched coro_sched_t;
+//   typedef struct coro_rt    coro_rt_t;
 //
 //   // Coroutines
 //   coro_t*  coro_create(void (*fn)(void*), void* arg, size_t stack_size);
@@ -26,7 +38,7 @@
 //   coro_t*  coro_current(void);                     // NULL if not inside a coro
 //   void     coro_free(coro_t* c);                   // free resources (not while running)
 //
-//   // Sleep (cooperative): marks current coro as sleeping until deadline and yields.
+//   // Sleep (cooperative): parks current coro until deadline.
 //   void     coro_sleep_ms(int ms);
 //
 //   // Scheduler (optional convenience)
@@ -35,15 +47,54 @@
 //   void          coro_sched_run(coro_sched_t* s);   // runs until all added coroutines are done
 //   void          coro_sched_destroy(coro_sched_t* s);
 //
+//   // M:N runtime (POSIX; ENOSYS elsewhere)
+//   coro_rt_t* coro_rt_create(size_t nthreads);      // 0 = one worker per online CPU
+//   int        coro_rt_spawn(coro_rt_t* rt, void (*fn)(void*), void* arg,
+//                            size_t stack_size);     // 0 or -errno; from any thread
+//   int        coro_rt_run(coro_rt_t* rt);           // caller is worker 0; returns when all done
+//   void       coro_rt_destroy(coro_rt_t* rt);       // not while running
+//   int        coro_wait_fd(int fd, unsigned ev, int timeout_ms);
+//                // ev: IO_READ|IO_WRITE (ioloop.c values). Returns the ready mask
+//                // (IO_CLOSE on hangup/error), 0 on timeout (<0: none), -errno.
+//
+//   // Stacks (POSIX; ENOSYS / no-op elsewhere)
+//   int        coro_stack_stats(coro_stack_stats_t* st);  // 0 or -errno
+//   void       coro_stack_trim(void);           // unmap the calling thread's cached stacks
+//   void       coro_stack_allow_unguarded(int on);  // 1: past the guard budget, map
+//                                                   // stacks without a guard (default 0)
+//
 // Notes:
-//   - One thread only. No preemption. Always call from the same thread you created things on.
-//   - Yield inside the same thread only. Do not call from signal handlers.
+//   - coro_resume/coro_yield_to/coro_sched_*: one thread only, no preemption.
+//     Yield inside the same thread only. Do not call from signal handlers.
 //   - Sleep uses a millisecond monotonic clock where available; otherwise best effort.
+//   - M:N: inside a runtime coroutine, coro_yield requeues it, coro_sleep_ms
+//     parks it in its worker's timer heap, coro_wait_fd in its worker's
+//     ioloop. It may resume on another thread after any of these: do not keep
+//     thread-local addresses (errno included) across them. Runtime coroutines
+//     are freed when they return; no coro_resume/coro_yield_to/coro_free on them.
+//   - POSIX stacks are mmap'ed with a guard page below them and committed
+//     lazily by the kernel; stack_size is rounded up to a page. Freed stacks
+//     are cached per thread (64 at most) and reused for the same size. Each
+//     guard costs two kernel mappings, so at most 3/8 of vm.max_map_count
+//     stacks (~24k by default on Linux) can be guarded at once. Past that
+//     budget coro_create fails with ENOMEM (coro_rt_spawn: -ENOMEM), unless
+//     coro_stack_allow_unguarded(1): then new stacks are UNPROTECTED, and an
+//     overflow on one of them silently corrupts the neighbouring memory.
+//     coro_stack_stats reports how many are unguarded.
+//   - coro_wait_fd registers the fd for one wake-up (add, then delete when it
+//     fires or times out); one waiter per fd and per worker. Wake-ups may be
+//     spurious: retry the read/write and wait again on EAGAIN.
 
 #if defined(__unix__) || defined(__APPLE__)
 #  ifndef _XOPEN_SOURCE
 #    define _XOPEN_SOURCE 700
 #  endif
+#  ifndef _DEFAULT_SOURCE
+#    define _DEFAULT_SOURCE     // MAP_ANONYMOUS, madvise, mincore (glibc)
+#  endif
+#  if defined(__APPLE__) && !defined(_DARWIN_C_SOURCE)
+#    define _DARWIN_C_SOURCE
+#  endif
 #endif
 
 #include <stdio.h>
@@ -52,6 +103,21 @@
 #include <errno.h>
 #include <time.h>
 #include <stdint.h>
+#include <limits.h>
+
+typedef struct coro coro_t;
+typedef struct coro_sched coro_sched_t;
+typedef struct coro_rt coro_rt_t;
+
+typedef struct {
+    size_t stacks;      // mapped: live + cached in some thread
+    size_t live;        // owned by a coro
+    size_t reserved;    // address space, guard pages included
+    size_t committed;   // resident pages (mincore)
+    size_t unguarded;   // mapped without a guard page (vm.max_map_count)
+} coro_stack_stats_t;
+
+#define CORO__NOHEAP ((size_t)-1)
 
 #if defined(_WIN32)
 // ================= Windows Fibers =================
@@ -69,11 +135,8 @@ struct coro {
     int   running;
     uint64_t wake_ms;     // scheduler wake deadline
     coro_sched_t* owner;  // scheduler owning this coro (for yield_to safety)
-};
-
-struct coro_sched {
-    coro_t** v;
-    size_t n, cap;
+    struct coro* next;    // ready list link
+    size_t hidx;          // index in a timer heap, CORO__NOHEAP if none
 };
 
 static __declspec(thread) coro_t* t_current = NULL;
@@ -106,7 +169,7 @@ coro_t* coro_create(void (*fn)(void*), void* arg, size_t stack_size){
     if (!t_main_fiber) t_main_fiber = ConvertThreadToFiber(NULL);
     coro_t* c = (coro_t*)calloc(1, sizeof(*c));
     if (!c) { errno = ENOMEM; return NULL; }
-    c->fn = fn; c->arg = arg; c->wake_ms = 0;
+    c->fn = fn; c->arg = arg; c->wake_ms = 0; c->hidx = CORO__NOHEAP;
     c->fiber = CreateFiber(stack_size? stack_size: 0, fiber_entry, c);
     if (!c->fiber) { free(c); errno = EIO; return NULL; }
     return c;
@@ -139,6 +202,13 @@ void coro_free(coro_t* c){
     free(c);
 }
 
+static void coro__sleep_os(uint64_t ms){ Sleep((DWORD)ms); }
+
+// Fibers reserve their stack with a guard and commit it on demand already.
+int  coro_stack_stats(coro_stack_stats_t* st){ (void)st; return -ENOSYS; }
+void coro_stack_trim(void){}
+void coro_stack_allow_unguarded(int on){ (void)on; }
+
 void coro_sleep_ms(int ms){
     if (!t_current) return;
     uint64_t n = now_ms();
@@ -146,81 +216,175 @@ void coro_sleep_ms(int ms){
     coro_yield();
 }
 
-// ------------- scheduler -------------
-static void sched_push(coro_sched_t* s, coro_t* c){
-    if (s->n == s->cap){
-        size_t nc = s->cap? s->cap*2 : 8;
-        coro_t** nv = (coro_t**)realloc(s->v, nc * sizeof(*nv));
-        if (!nv) { perror("oom"); abort(); }
-        s->v = nv; s->cap = nc;
-    }
-    c->owner = s;
-    s->v[s->n++] = c;
-}
+#elif defined(__unix__) || defined(__APPLE__)
+// ================= POSIX: native switch or ucontext =================
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
-coro_sched_t* coro_sched_create(void){
-    coro_sched_t* s = (coro_sched_t*)calloc(1,sizeof(*s));
-    if (!s) { errno = ENOMEM; return NULL; }
-    return s;
-}
+#if defined(__SANITIZE_THREAD__)
+// TSan follows stack switches only if told; done on the ucontext path
+#  define CORO__TSAN 1
+void* __tsan_get_current_fiber(void);
+void* __tsan_create_fiber(unsigned flags);
+void  __tsan_destroy_fiber(void* fiber);
+void  __tsan_switch_to_fiber(void* fiber, unsigned flags);
+#endif
 
-void coro_sched_add(coro_sched_t* s, coro_t* c){
-    if (!s || !c) return;
-    sched_push(s, c);
-}
+#if !defined(CORO_UCONTEXT) && !CORO__TSAN && (defined(__x86_64__) || defined(__aarch64__))
+#  define CORO_ASM 1
+#else
+#  include <ucontext.h>
+#endif
 
-void coro_sched_run(coro_sched_t* s){
-    if (!s) return;
-    size_t alive;
-    do {
-        alive = 0;
-        uint64_t n = now_ms();
-        for (size_t i=0;i<s->n;i++){
-            coro_t* c = s->v[i];
-            if (!c || c->done) continue;
-            alive = 1;
-            if (c->wake_ms && n < c->wake_ms) continue; // still sleeping
-            c->wake_ms = 0;
-            coro_resume(c);
-        }
-        if (alive) {
-            // prevent busy spin if everyone sleeps in future
-            Sleep(1);
-        }
-    } while (alive);
+#if CORO_ASM
+// A context is just the saved stack pointer: coro__switch pushes the
+// callee-saved registers on the stack it leaves and pops them from the one it
+// enters. A fresh context "returns" into coro__boot, which calls fn(arg).
+typedef struct { void* sp; } coro__ctx;
+void coro__switch(coro__ctx* from, coro__ctx* to);
+void coro__boot(void);
+
+#if defined(__APPLE__)
+#  define CORO__SYM(s)  "_" #s
+#  define CORO__HIDE(s) ".private_extern _" #s "\n"
+#else
+#  define CORO__SYM(s)  #s
+#  define CORO__HIDE(s) ".hidden " #s "\n"
+#endif
+
+#if defined(__x86_64__)
+// SysV: rbx rbp r12-r15, MXCSR and x87 control word. Boot: fn in r12, arg in r13.
+__asm__(
+    ".text\n"
+    ".globl " CORO__SYM(coro__switch) "\n" CORO__HIDE(coro__switch)
+    ".p2align 4\n"
+    CORO__SYM(coro__switch) ":\n"
+    "  pushq %rbp\n  pushq %rbx\n  pushq %r12\n  pushq %r13\n  pushq %r14\n  pushq %r15\n"
+    "  subq $8, %rsp\n  stmxcsr (%rsp)\n  fnstcw 4(%rsp)\n"
+    "  movq %rsp, (%rdi)\n"
+    "  movq (%rsi), %rsp\n"
+    "  ldmxcsr (%rsp)\n  fldcw 4(%rsp)\n  addq $8, %rsp\n"
+    "  popq %r15\n  popq %r14\n  popq %r13\n  popq %r12\n  popq %rbx\n  popq %rbp\n"
+    "  ret\n"
+    ".globl " CORO__SYM(coro__boot) "\n" CORO__HIDE(coro__boot)
+    ".p2align 4\n"
+    CORO__SYM(coro__boot) ":\n"
+    "  movq %r13, %rdi\n"
+    "  callq *%r12\n"
+    "  ud2\n");
+
+static int coro__ctx_make(coro__ctx* x, char* stack, size_t size, void (*fn)(void*), void* arg){
+    // frame: [mxcsr|fpucw][r15][r14][r13][r12][rbx][rbp][ret] then 16 bytes
+    // of padding; rsp is 16-aligned after the ret, as a call site expects
+    uintptr_t top = (uintptr_t)(stack + size) & ~(uintptr_t)15;
+    uint64_t* f = (uint64_t*)(top - 80);
+    uint32_t mx = 0x1F80; uint16_t cw = 0x037F;
+    memset(f, 0, 80);
+    memcpy(f, &mx, 4); memcpy((char*)f + 4, &cw, 2);
+    f[3] = (uint64_t)(uintptr_t)arg;
+    f[4] = (uint64_t)(uintptr_t)fn;
+    f[7] = (uint64_t)(uintptr_t)coro__boot;
+    x->sp = f;
+    return 0;
 }
+#else
+// AAPCS64: x19-x29, lr, d8-d15, FPCR. Boot: fn in x19, arg in x20.
+__asm__(
+    ".text\n"
+    ".globl " CORO__SYM(coro__switch) "\n" CORO__HIDE(coro__switch)
+    ".p2align 4\n"
+    CORO__SYM(coro__switch) ":\n"
+    "  sub sp, sp, #176\n"
+    "  stp x19, x20, [sp, #0]\n  stp x21, x22, [sp, #16]\n  stp x23, x24, [sp, #32]\n"
+    "  stp x25, x26, [sp, #48]\n  stp x27, x28, [sp, #64]\n  stp x29, x30, [sp, #80]\n"
+    "  stp d8, d9, [sp, #96]\n  stp d10, d11, [sp, #112]\n"
+    "  stp d12, d13, [sp, #128]\n  stp d14, d15, [sp, #144]\n"
+    "  mrs x9, fpcr\n  str x9, [sp, #160]\n"
+    "  mov x9, sp\n  str x9, [x0]\n"
+    "  ldr x9, [x1]\n  mov sp, x9\n"
+    "  ldp x19, x20, [sp, #0]\n  ldp x21, x22, [sp, #16]\n  ldp x23, x24, [sp, #32]\n"
+    "  ldp x25, x26, [sp, #48]\n  ldp x27, x28, [sp, #64]\n  ldp x29, x30, [sp, #80]\n"
+    "  ldp d8, d9, [sp, #96]\n  ldp d10, d11, [sp, #112]\n"
+    "  ldp d12, d13, [sp, #128]\n  ldp d14, d15, [sp, #144]\n"
+    "  ldr x9, [sp, #160]\n  msr fpcr, x9\n"
+    "  add sp, sp, #176\n"
+    "  ret\n"
+    ".globl " CORO__SYM(coro__boot) "\n" CORO__HIDE(coro__boot)
+    ".p2align 4\n"
+    CORO__SYM(coro__boot) ":\n"
+    "  mov x0, x20\n"
+    "  blr x19\n"
+    "  brk #0\n");
 
-void coro_sched_destroy(coro_sched_t* s){
-    if (!s) return;
-    free(s->v);
-    free(s);
+static int coro__ctx_make(coro__ctx* x, char* stack, size_t size, void (*fn)(void*), void* arg){
+    uintptr_t top = (uintptr_t)(stack + size) & ~(uintptr_t)15;
+    uint64_t* f = (uint64_t*)(top - 176);
+    memset(f, 0, 176);
+    f[0]  = (uint64_t)(uintptr_t)fn;          // x19
+    f[1]  = (uint64_t)(uintptr_t)arg;         // x20
+    f[11] = (uint64_t)(uintptr_t)coro__boot;  // x30
+    x->sp = f;
+    return 0;
 }
+#endif
 
-#elif defined(__unix__) || defined(__APPLE__)
-// ================= POSIX ucontext =================
-#include <ucontext.h>
-#include <sys/time.h>
-#include <unistd.h>
+#else
+// ucontext: swapcontext also saves/restores the signal mask (one syscall
+// per switch), hence the native path above.
+typedef struct {
+    ucontext_t uc; void (*fn)(void*); void* arg;
+#if CORO__TSAN
+    void* tsan;
+#endif
+} coro__ctx;
+static __thread coro__ctx* t_boot;
+static void coro__uc_boot(void){ coro__ctx* x = t_boot; x->fn(x->arg); }
+static int coro__ctx_make(coro__ctx* x, char* stack, size_t size, void (*fn)(void*), void* arg){
+    if (getcontext(&x->uc) != 0) return -1;
+    x->uc.uc_link = NULL;
+    x->uc.uc_stack.ss_sp = stack;
+    x->uc.uc_stack.ss_size = size;
+    x->fn = fn; x->arg = arg;
+    makecontext(&x->uc, coro__uc_boot, 0);
+#if CORO__TSAN
+    x->tsan = __tsan_create_fiber(0);
+#endif
+    return 0;
+}
+static void coro__switch(coro__ctx* from, coro__ctx* to){
+    t_boot = to;
+#if CORO__TSAN
+    from->tsan = __tsan_get_current_fiber();
+    __tsan_switch_to_fiber(to->tsan, 0);
+#endif
+    if (swapcontext(&from->uc, &to->uc) != 0) { perror("swapcontext"); }
+}
+#endif
 
-typedef struct coro coro_t;
-typedef struct coro_sched coro_sched_t;
+#if CORO__TSAN
+static void coro__ctx_free(coro__ctx* x){ __tsan_destroy_fiber(x->tsan); }
+#else
+#define coro__ctx_free(x) ((void)(x))
+#endif
 
 struct coro {
-    ucontext_t ctx;
-    ucontext_t caller;     // where to return on yield
+    coro__ctx ctx;
+    coro__ctx caller;      // where to return on yield (coro_resume)
     void (*fn)(void*);
     void* arg;
-    char* stack;
-    size_t stack_size;
+    struct coro__stk* stk;
     int   done;
     int   running;
     uint64_t wake_ms;
     coro_sched_t* owner;
-};
-
-struct coro_sched {
-    coro_t** v;
-    size_t n, cap;
+    struct coro* next;     // ready list link
+    size_t hidx;           // index in a timer heap, CORO__NOHEAP if none
+    coro_rt_t* rt;         // M:N runtime owning this coro, NULL otherwise
+    int   wfd;             // coro_wait_fd: fd waited on, -1 if none
+    unsigned wres;         // coro_wait_fd: result
 };
 
 static __thread coro_t* t_current = NULL;
@@ -235,14 +399,203 @@ static uint64_t now_ms(void){
 #endif
 }
 
-static void coro_trampoline(void){
-    coro_t* c = t_current;
-    if (!c) return;
+static void coro__sleep_os(uint64_t ms){
+    struct timespec ts = { .tv_sec = (time_t)(ms / 1000), .tv_nsec = (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+// ---------------- Stacks ----------------
+// One mmap per stack: [guard page | usable stack], the guard below since
+// stacks grow down, so an overflow faults instead of corrupting the heap.
+// Pages are committed by the kernel on first touch (MAP_NORESERVE): a 64 KiB
+// stack whose coro stays shallow costs a page or two of RAM.
+// Released stacks go to a per-thread cache (no lock on the hot path) after
+// MADV_DONTNEED on all but their top page; beyond CORO__STK_CACHE they are
+// unmapped. Every mapping is also on a global list, touched only by
+// mmap/munmap, for coro_stack_stats.
+// Page-aligned stacks all start at the same offset in a page, so the hot
+// frames of every coro would share the same L1 sets: each stack gets its top
+// lowered by a "colour", a multiple of 64 bytes below 2 KiB.
+#ifndef MAP_ANONYMOUS
+#  define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#  define MAP_NORESERVE 0
+#endif
+#ifndef MAP_STACK
+#  define MAP_STACK 0
+#endif
+#define CORO__STK_CACHE 64
+
+typedef struct coro__stk {
+    char*  map;            // mapping start (guard page, if any)
+    size_t map_len;
+    char*  base;           // usable stack [base, base+size)
+    size_t size;
+    int    guarded;
+    size_t color;          // bytes left unused at the top
+    struct coro__stk* next;              // per-thread cache
+    struct coro__stk *gnext, *gprev;     // global list
+} coro__stk;
+
+static pthread_mutex_t g_stk_mu = PTHREAD_MUTEX_INITIALIZER;
+static coro__stk* g_stk;
+static atomic_size_t g_stk_live;        // handed out, not yet released
+static atomic_uint g_stk_color;
+static size_t g_stk_nguard;             // under g_stk_mu
+static atomic_int g_stk_bare_ok;        // coro_stack_allow_unguarded
+
+// Each guard costs two kernel mappings. On Linux they are capped by
+// vm.max_map_count, which malloc needs too: guards get 3/4 of it at most,
+// the rest of the process keeps the remainder.
+static size_t coro__guard_max(void){   // under g_stk_mu
+    static size_t mx;
+    if (mx) return mx;
+    size_t lim = 0;
+#if defined(__linux__)
+    FILE* f = fopen("/proc/sys/vm/max_map_count", "r");
+    unsigned long v;
+    if (f) { if (fscanf(f, "%lu", &v) == 1) lim = (size_t)v; fclose(f); }
+    if (!lim) lim = 65530;
+#endif
+    mx = lim ? lim / 4 * 3 / 2 : SIZE_MAX;
+    return mx;
+}
+
+static __thread coro__stk* t_stk_cache;
+static __thread size_t t_stk_ncache;
+
+static size_t coro__page(void){
+    static atomic_size_t pg;   // same value from any thread: a race is harmless
+    size_t v = atomic_load_explicit(&pg, memory_order_relaxed);
+    if (!v) {
+        long r = sysconf(_SC_PAGESIZE);
+        v = r > 0 ? (size_t)r : 4096;
+        atomic_store_explicit(&pg, v, memory_order_relaxed);
+    }
+    return v;
+}
+
+static coro__stk* coro__stk_map(size_t size){
+    size_t pg = coro__page();
+    coro__stk* k = (coro__stk*)calloc(1, sizeof(*k));
+    if (!k) return NULL;
+    k->map_len = size + pg;
+    k->map = (char*)mmap(NULL, k->map_len, PROT_READ|PROT_WRITE,
+                         MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE|MAP_STACK, -1, 0);
+    if (k->map == MAP_FAILED) { free(k); return NULL; }
+    k->base = k->map + pg;
+    k->size = size;
+    k->color = (atomic_fetch_add_explicit(&g_stk_color, 1, memory_order_relaxed) % 32u) * 64u;
+    pthread_mutex_lock(&g_stk_mu);
+    // past the budget (or if mprotect fails) no stack at all, unless the
+    // caller opted into unprotected ones
+    if (g_stk_nguard < coro__guard_max() && mprotect(k->map, pg, PROT_NONE) == 0) {
+        k->guarded = 1;
+        g_stk_nguard++;
+    } else if (!atomic_load_explicit(&g_stk_bare_ok, memory_order_relaxed)) {
+        pthread_mutex_unlock(&g_stk_mu);
+        munmap(k->map, k->map_len);
+        free(k);
+        errno = ENOMEM;
+        return NULL;
+    }
+    k->gnext = g_stk;
+    if (g_stk) g_stk->gprev = k;
+    g_stk = k;
+    pthread_mutex_unlock(&g_stk_mu);
+    return k;
+}
+
+static void coro__stk_unmap(coro__stk* k){
+    pthread_mutex_lock(&g_stk_mu);
+    if (k->gprev) k->gprev->gnext = k->gnext; else g_stk = k->gnext;
+    if (k->gnext) k->gnext->gprev = k->gprev;
+    g_stk_nguard -= (size_t)k->guarded;
+    pthread_mutex_unlock(&g_stk_mu);
+    munmap(k->map, k->map_len);
+    free(k);
+}
+
+static coro__stk* coro__stk_get(size_t size){
+    size_t pg = coro__page();
+    size = (size + pg - 1) & ~(pg - 1);
+    coro__stk* k = NULL;
+    for (coro__stk** pp = &t_stk_cache; *pp; pp = &(*pp)->next)
+        if ((*pp)->size == size) { k = *pp; *pp = k->next; t_stk_ncache--; break; }
+    if (!k && !(k = coro__stk_map(size))) return NULL;
+    k->next = NULL;
+    atomic_fetch_add_explicit(&g_stk_live, 1, memory_order_relaxed);
+    return k;
+}
+
+static void coro__stk_put(coro__stk* k){
+    if (!k) return;
+    atomic_fetch_sub_explicit(&g_stk_live, 1, memory_order_relaxed);
+    if (t_stk_ncache >= CORO__STK_CACHE) { coro__stk_unmap(k); return; }
+    size_t pg = coro__page();
+#if defined(MADV_DONTNEED)
+    if (k->size > pg) madvise(k->base, k->size - pg, MADV_DONTNEED);
+#endif
+    k->next = t_stk_cache;
+    t_stk_cache = k;
+    t_stk_ncache++;
+}
+
+void coro_stack_allow_unguarded(int on){
+    atomic_store_explicit(&g_stk_bare_ok, on != 0, memory_order_relaxed);
+}
+
+void coro_stack_trim(void){
+    while (t_stk_cache) {
+        coro__stk* k = t_stk_cache;
+        t_stk_cache = k->next;
+        coro__stk_unmap(k);
+    }
+    t_stk_ncache = 0;
+}
+
+int coro_stack_stats(coro_stack_stats_t* st){
+    if (!st) return -EINVAL;
+    memset(st, 0, sizeof(*st));
+    size_t pg = coro__page();
+    unsigned char* vec = NULL;
+    size_t vcap = 0;
+    int rc = 0;
+    pthread_mutex_lock(&g_stk_mu);
+    for (coro__stk* k = g_stk; k; k = k->gnext) {
+        st->stacks++;
+        st->reserved += k->map_len;
+        if (!k->guarded) st->unguarded++;
+        size_t np = k->size / pg;
+        if (np > vcap) {
+            unsigned char* nv = (unsigned char*)realloc(vec, np);
+            if (!nv) { rc = -ENOMEM; break; }
+            vec = nv; vcap = np;
+        }
+        if (mincore(k->base, k->size, (void*)vec) != 0) { st->committed += k->size; continue; }
+        for (size_t i = 0; i < np; i++) if (vec[i] & 1) st->committed += pg;
+    }
+    pthread_mutex_unlock(&g_stk_mu);
+    st->live = atomic_load_explicit(&g_stk_live, memory_order_relaxed);
+    free(vec);
+    return rc;
+}
+
+// M:N hooks (below)
+static void coro__rt_yield(coro_t* c);
+static void coro__rt_sleep(coro_t* c, int ms);
+static void coro__rt_exit(coro_t* c);
+
+static void coro_trampoline(void* arg){
+    coro_t* c = (coro_t*)arg;
     c->running = 1;
     c->fn(c->arg);
     c->running = 0;
     c->done = 1;
-    setcontext(&c->caller); // never returns
+    if (c->rt) coro__rt_exit(c);
+    coro__switch(&c->ctx, &c->caller); // never resumed
+    abort();
 }
 
 coro_t* coro_create(void (*fn)(void*), void* arg, size_t stack_size){
@@ -250,34 +603,35 @@ coro_t* coro_create(void (*fn)(void*), void* arg, size_t stack_size){
     coro_t* c = (coro_t*)calloc(1,sizeof(*c));
     if (!c) { errno = ENOMEM; return NULL; }
     c->fn = fn; c->arg = arg;
-    c->stack_size = stack_size ? stack_size : (64*1024);
-    c->stack = (char*)malloc(c->stack_size);
-    if (!c->stack) { free(c); errno = ENOMEM; return NULL; }
-    if (getcontext(&c->ctx) != 0) { free(c->stack); free(c); return NULL; }
-    c->ctx.uc_link = &c->caller;
-    c->ctx.uc_stack.ss_sp = c->stack;
-    c->ctx.uc_stack.ss_size = c->stack_size;
-    makecontext(&c->ctx, coro_trampoline, 0);
+    c->hidx = CORO__NOHEAP; c->wfd = -1;
+    c->stk = coro__stk_get(stack_size ? stack_size : (64*1024));
+    if (!c->stk) { free(c); errno = ENOMEM; return NULL; }
+    if (coro__ctx_make(&c->ctx, c->stk->base, c->stk->size - c->stk->color, coro_trampoline, c) != 0) {
+        coro__stk_put(c->stk); free(c); return NULL;
+    }
     return c;
 }
 
 void coro_resume(coro_t* c){
-    if (!c || c->done) return;
+    if (!c || c->done || c->rt) return;
+    coro_t* prev = t_current;
     t_current = c;
-    if (swapcontext(&c->caller, &c->ctx) != 0) { perror("swapcontext"); }
-    t_current = NULL;
+    coro__switch(&c->caller, &c->ctx);
+    t_current = prev;
 }
 
 void coro_yield(void){
-    if (!t_current) return;
-    if (swapcontext(&t_current->ctx, &t_current->caller) != 0) { perror("swapcontext"); }
+    coro_t* c = t_current;
+    if (!c) return;
+    if (c->rt) { coro__rt_yield(c); return; }
+    coro__switch(&c->ctx, &c->caller);
 }
 
 void coro_yield_to(coro_t* other){
-    if (!t_current || !other || other->done) return;
     coro_t* prev = t_current;
+    if (!prev || !other || other->done || prev->rt || other->rt) return;
     t_current = other;
-    if (swapcontext(&prev->ctx, &other->ctx) != 0) { perror("swapcontext"); }
+    coro__switch(&prev->ctx, &other->ctx);
     t_current = prev; // restored on resume back
 }
 
@@ -287,29 +641,118 @@ coro_t* coro_current(void){ return t_current; }
 void coro_free(coro_t* c){
     if (!c) return;
     if (c->running) { errno = EBUSY; return; }
-    free(c->stack);
+    coro__ctx_free(&c->ctx);
+    coro__stk_put(c->stk);
     free(c);
 }
 
 void coro_sleep_ms(int ms){
-    if (!t_current) return;
+    coro_t* c = t_current;
+    if (!c) return;
+    if (c->rt) { coro__rt_sleep(c, ms); return; }
     uint64_t n = now_ms();
-    t_current->wake_ms = n + (ms > 0 ? (uint64_t)ms : 0);
+    c->wake_ms = n + (ms > 0 ? (uint64_t)ms : 0);
     coro_yield();
 }
 
-// ------------- scheduler -------------
-static void sched_push(coro_sched_t* s, coro_t* c){
-    if (s->n == s->cap){
-        size_t nc = s->cap? s->cap*2 : 8;
-        coro_t** nv = (coro_t**)realloc(s->v, nc * sizeof(*nv));
-        if (!nv) { perror("oom"); abort(); }
-        s->v = nv; s->cap = nc;
+#else
+// ================= Stubs =================
+typedef struct coro { int done; } coro_t;
+typedef struct coro_sched { int _; } coro_sched_t;
+
+coro_t*  coro_create(void (*fn)(void*), void* arg, size_t stack_size){ (void)fn;(void)arg;(void)stack_size; errno=ENOSYS; return NULL; }
+void     coro_resume(coro_t* c){ (void)c; errno=ENOSYS; }
+void     coro_yield(void){ errno=ENOSYS; }
+void     coro_yield_to(coro_t* other){ (void)other; errno=ENOSYS; }
+int      coro_is_done(const coro_t* c){ (void)c; return 1; }
+coro_t*  coro_current(void){ return NULL; }
+void     coro_free(coro_t* c){ (void)c; }
+void     coro_sleep_ms(int ms){ (void)ms; errno=ENOSYS; }
+int      coro_stack_stats(coro_stack_stats_t* st){ (void)st; return -ENOSYS; }
+void     coro_stack_trim(void){}
+void     coro_stack_allow_unguarded(int on){ (void)on; }
+
+coro_sched_t* coro_sched_create(void){ errno=ENOSYS; return NULL; }
+void          coro_sched_add(coro_sched_t* s, coro_t* c){ (void)s;(void)c; errno=ENOSYS; }
+void          coro_sched_run(coro_sched_t* s){ (void)s; errno=ENOSYS; }
+void          coro_sched_destroy(coro_sched_t* s){ (void)s; }
+#endif
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+// ================= Timer heap, ready list, scheduler =================
+// Min-heap on wake_ms; each coro remembers its slot (hidx) so that a wait
+// that ends early (fd ready) leaves the heap in O(log n).
+typedef struct { coro_t** a; size_t n, cap; } coro__heap;
+
+static void coro__heap_set(coro__heap* h, size_t i, coro_t* c){ h->a[i] = c; c->hidx = i; }
+static void coro__heap_up(coro__heap* h, size_t i){
+    coro_t* c = h->a[i];
+    while (i) {
+        size_t p = (i-1)/2;
+        if (h->a[p]->wake_ms <= c->wake_ms) break;
+        coro__heap_set(h, i, h->a[p]); i = p;
     }
-    c->owner = s;
-    s->v[s->n++] = c;
+    coro__heap_set(h, i, c);
+}
+static void coro__heap_dn(coro__heap* h, size_t i){
+    coro_t* c = h->a[i];
+    for (;;) {
+        size_t l = 2*i+1, m = l;
+        if (l >= h->n) break;
+        if (l+1 < h->n && h->a[l+1]->wake_ms < h->a[l]->wake_ms) m = l+1;
+        if (h->a[m]->wake_ms >= c->wake_ms) break;
+        coro__heap_set(h, i, h->a[m]); i = m;
+    }
+    coro__heap_set(h, i, c);
+}
+static int coro__heap_push(coro__heap* h, coro_t* c){
+    if (h->n == h->cap) {
+        size_t nc = h->cap ? h->cap*2 : 64;
+        coro_t** na = (coro_t**)realloc(h->a, nc * sizeof(*na));
+        if (!na) return -ENOMEM;
+        h->a = na; h->cap = nc;
+    }
+    h->a[h->n] = c;
+    coro__heap_up(h, h->n++);
+    return 0;
+}
+static void coro__heap_del(coro__heap* h, coro_t* c){
+    size_t i = c->hidx;
+    coro_t* last = h->a[--h->n];
+    c->hidx = CORO__NOHEAP;
+    if (i == h->n) return;
+    coro__heap_set(h, i, last);
+    coro__heap_up(h, i);
+    coro__heap_dn(h, last->hidx);
+}
+static coro_t* coro__heap_pop_due(coro__heap* h, uint64_t now){
+    if (!h->n || h->a[0]->wake_ms > now) return NULL;
+    coro_t* c = h->a[0];
+    coro__heap_del(h, c);
+    return c;
+}
+
+typedef struct { coro_t* head; coro_t* tail; size_t n; } coro__list;
+
+static void coro__list_push(coro__list* q, coro_t* c){
+    c->next = NULL;
+    if (q->tail) q->tail->next = c; else q->head = c;
+    q->tail = c; q->n++;
+}
+static coro_t* coro__list_pop(coro__list* q){
+    coro_t* c = q->head;
+    if (!c) return NULL;
+    q->head = c->next;
+    if (!q->head) q->tail = NULL;
+    q->n--; c->next = NULL;
+    return c;
 }
 
+struct coro_sched {
+    coro__list ready;      // FIFO
+    coro__heap sleeping;   // coro_sleep_ms
+    size_t live;           // added and not done
+};
+
 coro_sched_t* coro_sched_create(void){
     coro_sched_t* s = (coro_sched_t*)calloc(1,sizeof(*s));
     if (!s) { errno = ENOMEM; return NULL; }
@@ -317,58 +760,386 @@ coro_sched_t* coro_sched_create(void){
 }
 
 void coro_sched_add(coro_sched_t* s, coro_t* c){
-    if (!s || !c) return;
-    sched_push(s, c);
+    if (!s || !c || c->done) return;
+    c->owner = s;
+    coro__list_push(&s->ready, c);
+    s->live++;
 }
 
 void coro_sched_run(coro_sched_t* s){
     if (!s) return;
-    size_t alive;
-    do {
-        alive = 0;
+    while (s->live) {
         uint64_t n = now_ms();
-        int idled = 1;
-        for (size_t i=0;i<s->n;i++){
-            coro_t* c = s->v[i];
-            if (!c || c->done) continue;
-            alive = 1;
-            if (c->wake_ms && n < c->wake_ms) continue;
-            idled = 0;
-            c->wake_ms = 0;
-            coro_resume(c);
-        }
-        if (alive && idled) {
-            // everybody sleeping; sleep a bit to avoid CPU spin
-            struct timespec ts = { .tv_sec = 0, .tv_nsec = 1*1000*1000 }; // 1ms
-            nanosleep(&ts, NULL);
+        coro_t* c;
+        while ((c = coro__heap_pop_due(&s->sleeping, n))) coro__list_push(&s->ready, c);
+        c = coro__list_pop(&s->ready);
+        if (!c) {
+            // everybody sleeping: sleep until the earliest deadline, no polling
+            if (!s->sleeping.n) break;
+            coro__sleep_os(s->sleeping.a[0]->wake_ms - n);
+            continue;
         }
-    } while (alive);
+        c->wake_ms = 0;
+        coro_resume(c);
+        if (c->done) { s->live--; continue; }
+        if (c->wake_ms > now_ms() && coro__heap_push(&s->sleeping, c) == 0) continue;
+        coro__list_push(&s->ready, c);
+    }
 }
 
 void coro_sched_destroy(coro_sched_t* s){
     if (!s) return;
-    free(s->v);
+    free(s->sleeping.a);
     free(s);
 }
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+// ================= M:N runtime =================
+// Each worker owns a ready queue (mutex, stolen from by idle workers), a
+// timer heap and an ioloop, touched only by itself except for the queue.
+// Everything that makes a coro runnable again (timer, fd, yield) happens on
+// the worker that parked it, in its scheduler context, once the coro has
+// switched out: a coro is never queued while still on its own stack.
+#include <fcntl.h>
+#if defined(__linux__)
+#  include <sys/eventfd.h>
+#endif
+
+// ioloop.c (linked alongside)
+typedef struct ioloop ioloop;
+typedef void (*io_cb)(int fd, unsigned ev, void* ud);
+enum { IO_READ=1u, IO_WRITE=2u, IO_CLOSE=4u, IO_TIMER=8u };
+ioloop* io_new(void);
+void    io_free(ioloop* L);
+int     io_poll(ioloop* L, int timeout_ms);
+int     io_add_fd(ioloop* L, int fd, unsigned flags, io_cb cb, void* ud);
+int     io_del_fd(ioloop* L, int fd);
+
+enum { CORO__RUN = 0, CORO__YIELD, CORO__PARK, CORO__EXIT };
+
+typedef struct coro__w {
+    coro_rt_t* rt;
+    size_t     id;
+    pthread_t  th;
+    coro__ctx  sched;          // the worker's own context; coros switch back here
+    int        act;            // what the coro that just switched out asked for
+    pthread_mutex_t mu;        // guards rq
+    coro__list rq;
+    atomic_size_t rq_n;        // rq.n, readable without the lock
+    coro__heap timers;
+    ioloop*    loop;
+    int        wake_rd, wake_wr;
+    atomic_int sleeping;       // 1 while (about to be) blocked in io_poll
+    uint64_t   rng;
+    char       pad_[64];
+} coro__w;
+
+struct coro_rt {
+    coro__w*      w;
+    size_t        nw;
+    atomic_size_t live;        // spawned and not finished
+    atomic_int    done;
+    atomic_size_t rr;          // placement of spawns from outside the runtime
+    atomic_size_t nidle;
+};
+
+static __thread coro__w* t_w;
+
+// Out of line on purpose: a coro may resume on another thread, so a TLS
+// address must not be computed once and reused across a switch.
+__attribute__((noinline)) static coro__w* coro__self(void){
+    __asm__ volatile("");
+    return t_w;
+}
+__attribute__((noinline)) static coro_t* coro__cur(void){
+    __asm__ volatile("");
+    return t_current;
+}
 
+static void coro__wake(coro__w* w){
+    if (!atomic_exchange(&w->sleeping, 0)) return;
+#if defined(__linux__)
+    uint64_t v = 1;
 #else
-// ================= Stubs =================
-typedef struct coro { int done; } coro_t;
-typedef struct coro_sched { int _; } coro_sched_t;
+    char v = 1;
+#endif
+    ssize_t r = write(w->wake_wr, &v, sizeof v);
+    (void)r;
+}
 
-coro_t*  coro_create(void (*fn)(void*), void* arg, size_t stack_size){ (void)fn;(void)arg;(void)stack_size; errno=ENOSYS; return NULL; }
-void     coro_resume(coro_t* c){ (void)c; errno=ENOSYS; }
-void     coro_yield(void){ errno=ENOSYS; }
-void     coro_yield_to(coro_t* other){ (void)other; errno=ENOSYS; }
-int      coro_is_done(const coro_t* c){ (void)c; return 1; }
-coro_t*  coro_current(void){ return NULL; }
-void     coro_free(coro_t* c){ (void)c; }
-void     coro_sleep_ms(int ms){ (void)ms; errno=ENOSYS; }
+static void coro__wake_idle(coro_rt_t* rt, coro__w* self){
+    if (!atomic_load(&rt->nidle)) return;
+    for (size_t k = 1; k < rt->nw; k++) {
+        coro__w* v = &rt->w[(self->id + k) % rt->nw];
+        if (atomic_load_explicit(&v->sleeping, memory_order_relaxed)) { coro__wake(v); return; }
+    }
+}
 
-coro_sched_t* coro_sched_create(void){ errno=ENOSYS; return NULL; }
-void          coro_sched_add(coro_sched_t* s, coro_t* c){ (void)s;(void)c; errno=ENOSYS; }
-void          coro_sched_run(coro_sched_t* s){ (void)s; errno=ENOSYS; }
-void          coro_sched_destroy(coro_sched_t* s){ (void)s; }
+// Make c runnable on w. Own queue: wake an idle worker if there is something
+// to steal; another worker's queue: wake that worker.
+static void coro__ready(coro__w* w, coro_t* c){
+    pthread_mutex_lock(&w->mu);
+    coro__list_push(&w->rq, c);
+    size_t n = w->rq.n;
+    atomic_store(&w->rq_n, n);
+    pthread_mutex_unlock(&w->mu);
+    if (w == coro__self()) { if (n > 1) coro__wake_idle(w->rt, w); }
+    else coro__wake(w);
+}
+
+static coro_t* coro__pop(coro__w* w){
+    if (!atomic_load_explicit(&w->rq_n, memory_order_relaxed)) return NULL;
+    pthread_mutex_lock(&w->mu);
+    coro_t* c = coro__list_pop(&w->rq);
+    atomic_store_explicit(&w->rq_n, w->rq.n, memory_order_relaxed);
+    pthread_mutex_unlock(&w->mu);
+    return c;
+}
+
+// Take half of a random victim's queue; run the first, keep the rest.
+static coro_t* coro__steal(coro__w* w){
+    coro_rt_t* rt = w->rt;
+    if (rt->nw < 2) return NULL;
+    w->rng ^= w->rng << 13; w->rng ^= w->rng >> 7; w->rng ^= w->rng << 17;
+    size_t start = (size_t)(w->rng % rt->nw);
+    for (size_t k = 0; k < rt->nw; k++) {
+        coro__w* v = &rt->w[(start + k) % rt->nw];
+        if (v == w || !atomic_load_explicit(&v->rq_n, memory_order_relaxed)) continue;
+        if (pthread_mutex_trylock(&v->mu) != 0) continue;
+        coro__list got = {0};
+        for (size_t take = (v->rq.n + 1) / 2; take; take--) coro__list_push(&got, coro__list_pop(&v->rq));
+        atomic_store_explicit(&v->rq_n, v->rq.n, memory_order_relaxed);
+        pthread_mutex_unlock(&v->mu);
+        coro_t* first = coro__list_pop(&got);
+        if (!first) continue;
+        if (got.n) {
+            pthread_mutex_lock(&w->mu);
+            while (got.head) coro__list_push(&w->rq, coro__list_pop(&got));
+            atomic_store_explicit(&w->rq_n, w->rq.n, memory_order_relaxed);
+            pthread_mutex_unlock(&w->mu);
+        }
+        return first;
+    }
+    return NULL;
+}
+
+// Does some other worker have more than it is about to run itself?
+static int coro__stealable(coro__w* w){
+    for (size_t k = 0; k < w->rt->nw; k++)
+        if (&w->rt->w[k] != w && atomic_load_explicit(&w->rt->w[k].rq_n, memory_order_relaxed) > 1) return 1;
+    return 0;
+}
+
+// --- coro side (runs on the coro stack) ---
+static void coro__park(coro_t* c, int act){
+    coro__w* w = coro__self();
+    w->act = act;
+    coro__switch(&c->ctx, &w->sched);
+}
+static void coro__rt_yield(coro_t* c){ coro__park(c, CORO__YIELD); }
+static void coro__rt_exit(coro_t* c){ coro__park(c, CORO__EXIT); }
+static void coro__rt_sleep(coro_t* c, int ms){
+    if (ms <= 0) { coro__park(c, CORO__YIELD); return; }
+    c->wake_ms = now_ms() + (uint64_t)ms;
+    if (coro__heap_push(&coro__self()->timers, c) != 0) { coro__park(c, CORO__YIELD); return; }
+    coro__park(c, CORO__PARK);
+}
+
+static void coro__on_fd(int fd, unsigned ev, void* ud){
+    coro_t* c = (coro_t*)ud;
+    coro__w* w = coro__self();
+    io_del_fd(w->loop, fd);
+    if (c->hidx != CORO__NOHEAP) coro__heap_del(&w->timers, c);
+    c->wfd = -1;
+    c->wres = ev ? ev : IO_CLOSE;
+    coro__ready(w, c);
+}
+
+int coro_wait_fd(int fd, unsigned ev, int timeout_ms){
+    coro_t* c = coro__cur();
+    if (!c || !c->rt) return -EINVAL;
+    ev &= IO_READ|IO_WRITE;
+    if (fd < 0 || !ev) return -EINVAL;
+    coro__w* w = coro__self();
+    int rc = io_add_fd(w->loop, fd, ev, coro__on_fd, c);
+    if (rc) return rc;
+    c->wfd = fd; c->wres = 0;
+    if (timeout_ms >= 0) {
+        c->wake_ms = now_ms() + (uint64_t)timeout_ms;
+        if (coro__heap_push(&w->timers, c) != 0) { io_del_fd(w->loop, fd); c->wfd = -1; return -ENOMEM; }
+    }
+    coro__park(c, CORO__PARK);
+    return (int)c->wres;
+}
+
+// --- worker side ---
+static void coro__finish(coro_rt_t* rt, coro_t* c){
+    coro__ctx_free(&c->ctx);
+    coro__stk_put(c->stk);
+    free(c);
+    if (atomic_fetch_sub(&rt->live, 1) != 1) return;
+    atomic_store(&rt->done, 1);
+    for (size_t k = 0; k < rt->nw; k++) coro__wake(&rt->w[k]);
+}
+
+static void coro__exec(coro__w* w, coro_t* c){
+    t_current = c;
+    w->act = CORO__RUN;
+    coro__switch(&w->sched, &c->ctx);
+    t_current = NULL;
+    if (w->act == CORO__YIELD) coro__ready(w, c);
+    else if (w->act == CORO__EXIT) coro__finish(w->rt, c);
+    // CORO__PARK: in the timer heap and/or the ioloop, woken from there
+}
+
+static int coro__expire(coro__w* w){
+    uint64_t n = now_ms();
+    int k = 0;
+    coro_t* c;
+    while ((c = coro__heap_pop_due(&w->timers, n))) {
+        if (c->wfd >= 0) { io_del_fd(w->loop, c->wfd); c->wfd = -1; c->wres = 0; }
+        coro__ready(w, c);
+        k++;
+    }
+    return k;
+}
+
+static void coro__drain(int fd, unsigned ev, void* ud){
+    (void)ev; (void)ud;
+    char b[64];
+    while (read(fd, b, sizeof b) > 0) {}
+}
+
+static void coro__loop(coro__w* w){
+    coro_rt_t* rt = w->rt;
+    unsigned tick = 0;
+    t_w = w;
+    while (!atomic_load(&rt->done)) {
+        coro_t* c = coro__pop(w);
+        if (!c) c = coro__steal(w);
+        if (c) {
+            coro__exec(w, c);
+            // under sustained load, timers and fds still get their turn
+            if ((++tick & 63) == 0) { coro__expire(w); io_poll(w->loop, 0); }
+            continue;
+        }
+        if (coro__expire(w)) continue;
+        int tmo = -1;
+        if (w->timers.n) {
+            uint64_t n = now_ms(), d = w->timers.a[0]->wake_ms;
+            tmo = d <= n ? 0 : (d - n > INT_MAX ? INT_MAX : (int)(d - n));
+        }
+        // sleeping=1 before the last look at the queues: a concurrent
+        // coro__ready either is seen here or sees sleeping and writes wake_wr
+        atomic_store(&w->sleeping, 1);
+        atomic_fetch_add(&rt->nidle, 1);
+        if (!atomic_load(&w->rq_n) && !atomic_load(&rt->done) && !coro__stealable(w))
+            io_poll(w->loop, tmo);
+        atomic_store(&w->sleeping, 0);
+        atomic_fetch_sub(&rt->nidle, 1);
+    }
+    t_w = NULL;
+}
+
+static void* coro__thread(void* arg){
+    coro__loop((coro__w*)arg);
+    coro_stack_trim();   // this thread's cache would leak with it
+    return NULL;
+}
+
+static int coro__w_init(coro_rt_t* rt, coro__w* w, size_t id){
+    w->rt = rt; w->id = id;
+    w->wake_rd = w->wake_wr = -1;
+    w->rng = 0x9E3779B97F4A7C15ull * (id + 1);
+    atomic_init(&w->rq_n, 0);
+    atomic_init(&w->sleeping, 0);
+    if (pthread_mutex_init(&w->mu, NULL) != 0) return -1;
+    if (!(w->loop = io_new())) return -1;
+#if defined(__linux__)
+    w->wake_rd = w->wake_wr = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (w->wake_rd < 0) return -1;
+#else
+    int p[2];
+    if (pipe(p) != 0) return -1;
+    w->wake_rd = p[0]; w->wake_wr = p[1];
+    for (int i = 0; i < 2; i++) {
+        fcntl(p[i], F_SETFL, fcntl(p[i], F_GETFL) | O_NONBLOCK);
+        fcntl(p[i], F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    return io_add_fd(w->loop, w->wake_rd, IO_READ, coro__drain, NULL) ? -1 : 0;
+}
+
+void coro_rt_destroy(coro_rt_t* rt);
+
+coro_rt_t* coro_rt_create(size_t nthreads){
+    if (!nthreads) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = n > 0 ? (size_t)n : 1;
+    }
+    coro_rt_t* rt = (coro_rt_t*)calloc(1, sizeof(*rt));
+    if (!rt) { errno = ENOMEM; return NULL; }
+    atomic_init(&rt->live, 0); atomic_init(&rt->done, 0);
+    atomic_init(&rt->rr, 0); atomic_init(&rt->nidle, 0);
+    rt->w = (coro__w*)calloc(nthreads, sizeof(*rt->w));
+    if (!rt->w) { free(rt); errno = ENOMEM; return NULL; }
+    for (size_t i = 0; i < nthreads; i++) {
+        rt->nw = i + 1;
+        if (coro__w_init(rt, &rt->w[i], i) != 0) { coro_rt_destroy(rt); errno = EIO; return NULL; }
+    }
+    return rt;
+}
+
+int coro_rt_spawn(coro_rt_t* rt, void (*fn)(void*), void* arg, size_t stack_size){
+    if (!rt || !fn) return -EINVAL;
+    coro_t* c = coro_create(fn, arg, stack_size);
+    if (!c) return -(errno ? errno : ENOMEM);
+    c->rt = rt;
+    atomic_fetch_add(&rt->live, 1);
+    coro__w* self = coro__self();
+    if (self && self->rt == rt) coro__ready(self, c);
+    else coro__ready(&rt->w[atomic_fetch_add(&rt->rr, 1) % rt->nw], c);
+    return 0;
+}
+
+int coro_rt_run(coro_rt_t* rt){
+    if (!rt) return -EINVAL;
+    if (!atomic_load(&rt->live)) return 0;
+    atomic_store(&rt->done, 0);
+    // a worker that fails to start still has its queue emptied by stealing
+    size_t started = 1;
+    for (size_t i = 1; i < rt->nw; i++) {
+        if (pthread_create(&rt->w[i].th, NULL, coro__thread, &rt->w[i]) != 0) break;
+        started++;
+    }
+    coro__loop(&rt->w[0]);
+    for (size_t i = 1; i < started; i++) pthread_join(rt->w[i].th, NULL);
+    return 0;
+}
+
+void coro_rt_destroy(coro_rt_t* rt){
+    if (!rt) return;
+    for (size_t i = 0; i < rt->nw; i++) {
+        coro__w* w = &rt->w[i];
+        coro_t* c;
+        while ((c = coro__list_pop(&w->rq))) coro_free(c);   // spawned, never run
+        if (w->loop) io_free(w->loop);
+        if (w->wake_rd >= 0) close(w->wake_rd);
+        if (w->wake_wr >= 0 && w->wake_wr != w->wake_rd) close(w->wake_wr);
+        pthread_mutex_destroy(&w->mu);
+        free(w->timers.a);
+    }
+    free(rt->w);
+    free(rt);
+}
+
+#else
+coro_rt_t* coro_rt_create(size_t nthreads){ (void)nthreads; errno=ENOSYS; return NULL; }
+int        coro_rt_spawn(coro_rt_t* rt, void (*fn)(void*), void* arg, size_t stack_size){ (void)rt;(void)fn;(void)arg;(void)stack_size; return -ENOSYS; }
+int        coro_rt_run(coro_rt_t* rt){ (void)rt; return -ENOSYS; }
+void       coro_rt_destroy(coro_rt_t* rt){ (void)rt; }
+int        coro_wait_fd(int fd, unsigned ev, int timeout_ms){ (void)fd;(void)ev;(void)timeout_ms; return -ENOSYS; }
 #endif
 
 // ================= Optional demo =================
@@ -392,3 +1163,319 @@ int main(void){
     return 0;
 }
 #endif
+
+// ================= Tests =================
+#if defined(CORO_TEST) && (defined(__unix__) || defined(__APPLE__))
+#include <assert.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+static int t_order[8], t_n;
+static void t_sleeper(void* arg){
+    int ms = (int)(intptr_t)arg;
+    coro_sleep_ms(ms);
+    t_order[t_n++] = ms;
+}
+
+static atomic_long t_count;
+static void t_yielder(void* arg){
+    (void)arg;
+    for (int i = 0; i < 10000; i++) { atomic_fetch_add(&t_count, 1); coro_yield(); }
+}
+static void t_rt_sleeper(void* arg){
+    int ms = (int)(intptr_t)arg;
+    uint64_t t0 = now_ms();
+    coro_sleep_ms(ms);
+    assert(now_ms() - t0 + 1 >= (uint64_t)ms);
+    atomic_fetch_add(&t_count, 1);
+}
+
+typedef struct { int fd; int rounds; } t_pp;
+static void t_ping(void* arg){
+    t_pp* p = (t_pp*)arg;
+    for (int i = 0; i < p->rounds; i++) {
+        int v = i;
+        assert(write(p->fd, &v, sizeof v) == sizeof v);
+        for (;;) {
+            ssize_t r = read(p->fd, &v, sizeof v);
+            if (r == (ssize_t)sizeof v) break;
+            assert(r < 0 && errno == EAGAIN);
+            assert(coro_wait_fd(p->fd, IO_READ, 5000) & IO_READ);
+        }
+        assert(v == i + 1);
+    }
+    atomic_fetch_add(&t_count, 1);
+}
+static void t_pong(void* arg){
+    t_pp* p = (t_pp*)arg;
+    for (int i = 0; i < p->rounds; i++) {
+        int v;
+        for (;;) {
+            ssize_t r = read(p->fd, &v, sizeof v);
+            if (r == (ssize_t)sizeof v) break;
+            assert(r < 0 && errno == EAGAIN);
+            assert(coro_wait_fd(p->fd, IO_READ, 5000) & IO_READ);
+        }
+        v++;
+        assert(write(p->fd, &v, sizeof v) == sizeof v);
+    }
+    atomic_fetch_add(&t_count, 1);
+}
+static void t_timeout(void* arg){
+    int fd = (int)(intptr_t)arg;
+    uint64_t t0 = now_ms();
+    assert(coro_wait_fd(fd, IO_READ, 20) == 0);
+    assert(now_ms() - t0 + 1 >= 20);
+    atomic_fetch_add(&t_count, 1);
+}
+
+static coro_rt_t* t_rt;
+static void t_leaf(void* arg){ (void)arg; coro_yield(); atomic_fetch_add(&t_count, 1); }
+static void t_parent(void* arg){
+    (void)arg;
+    for (int i = 0; i < 100; i++) assert(coro_rt_spawn(t_rt, t_leaf, NULL, 0) == 0);
+    atomic_fetch_add(&t_count, 1);
+}
+
+static int t_recurse(int d){
+    volatile char b[256];
+    b[0] = (char)d;
+    return d ? t_recurse(d - 1) + b[0] : b[0];
+}
+static void t_overflow(void* arg){ (void)arg; t_recurse(100000); }
+static void t_touch(void* arg){
+    volatile char b[8192];
+    for (size_t i = 0; i < sizeof b; i += 512) b[i] = (char)(intptr_t)arg;
+    coro_yield();
+}
+
+static void t_stacks(void){
+    // overflow hits the guard page: the child dies of SIGSEGV (sanitizers
+    // catch it first and exit non-zero)
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        if (!freopen("/dev/null", "w", stderr)) _exit(0);
+        coro_t* c = coro_create(t_overflow, NULL, 64*1024);
+        coro_resume(c);
+        _exit(0);
+    }
+    int wst = 0;
+    assert(waitpid(pid, &wst, 0) == pid);
+    assert(WIFSIGNALED(wst) ? WTERMSIG(wst) == SIGSEGV || WTERMSIG(wst) == SIGBUS
+                            : WEXITSTATUS(wst) != 0);
+
+    // lazy commit, reuse, trim
+    coro_stack_stats_t st;
+    coro_stack_trim();
+    assert(coro_stack_stats(&st) == 0 && st.stacks == 0 && st.live == 0);
+    coro_t* cs[16];
+    for (int i = 0; i < 16; i++) { cs[i] = coro_create(t_touch, (void*)(intptr_t)i, 1 << 20); coro_resume(cs[i]); }
+    assert(coro_stack_stats(&st) == 0);
+    assert(st.stacks == 16 && st.live == 16 && st.unguarded == 0);
+    assert(st.reserved >= 16u * ((1u << 20) + 4096));
+    assert(st.committed >= 16u * 8192 && st.committed <= st.reserved / 8);
+    coro__stk* k0 = cs[0]->stk;
+    for (int i = 0; i < 16; i++) { coro_resume(cs[i]); coro_free(cs[i]); }
+    assert(coro_stack_stats(&st) == 0 && st.stacks == 16 && st.live == 0);
+    assert(st.committed <= 16u * coro__page());          // MADV_DONTNEED
+    coro_t* c = coro_create(t_touch, NULL, (1 << 20) - 100);  // same size once rounded
+    int reused = 0;
+    for (coro__stk* k = t_stk_cache; k; k = k->next) reused |= k == k0;
+    assert(c->stk->size == (size_t)1 << 20 && (c->stk == k0 || reused));
+    assert(coro_stack_stats(&st) == 0 && st.stacks == 16 && st.live == 1);
+    coro_free(c);
+    coro_stack_trim();
+    assert(coro_stack_stats(&st) == 0 && st.stacks == 0);
+
+    // guard budget spent: ENOMEM, or an unguarded stack once allowed
+    pthread_mutex_lock(&g_stk_mu);
+    size_t nguard = g_stk_nguard;
+    g_stk_nguard = coro__guard_max();
+    pthread_mutex_unlock(&g_stk_mu);
+    errno = 0;
+    assert(coro_create(t_touch, NULL, 64*1024) == NULL && errno == ENOMEM);
+    assert(coro_stack_stats(&st) == 0 && st.stacks == 0);
+    coro_stack_allow_unguarded(1);
+    c = coro_create(t_touch, NULL, 64*1024);
+    assert(c && !c->stk->guarded);
+    assert(coro_stack_stats(&st) == 0 && st.stacks == 1 && st.unguarded == 1);
+    coro_stack_allow_unguarded(0);
+    coro_resume(c); coro_resume(c); coro_free(c);
+    coro_stack_trim();
+    pthread_mutex_lock(&g_stk_mu);
+    g_stk_nguard = nguard;
+    pthread_mutex_unlock(&g_stk_mu);
+}
+
+static void t_nonblock(int fd){ fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+int main(void){
+    // classic scheduler: wake-up order follows deadlines, no busy spin
+    coro_sched_t* S = coro_sched_create();
+    int ms[] = { 60, 20, 40, 0 };
+    coro_t* cs[4];
+    for (int i = 0; i < 4; i++) { cs[i] = coro_create(t_sleeper, (void*)(intptr_t)ms[i], 0); coro_sched_add(S, cs[i]); }
+    clock_t c0 = clock(); uint64_t t0 = now_ms();
+    coro_sched_run(S);
+    assert(t_n == 4 && t_order[0] == 0 && t_order[1] == 20 && t_order[2] == 40 && t_order[3] == 60);
+    assert(now_ms() - t0 >= 60);
+    assert((double)(clock() - c0) / CLOCKS_PER_SEC < 0.03);
+    for (int i = 0; i < 4; i++) coro_free(cs[i]);
+    coro_sched_destroy(S);
+
+    t_stacks();
+
+    // M:N runtime
+    t_rt = coro_rt_create(4);
+    assert(t_rt);
+    for (int i = 0; i < 10; i++) assert(coro_rt_spawn(t_rt, t_yielder, NULL, 0) == 0);
+    assert(coro_rt_run(t_rt) == 0);
+    assert(atomic_load(&t_count) == 100000);
+
+    atomic_store(&t_count, 0);
+    for (int i = 0; i < 50; i++) coro_rt_spawn(t_rt, t_rt_sleeper, (void*)(intptr_t)(i % 5 * 10), 0);
+    assert(coro_rt_run(t_rt) == 0);
+    assert(atomic_load(&t_count) == 50);
+
+    atomic_store(&t_count, 0);
+    int sv[8][2];
+    t_pp pp[16];
+    for (int i = 0; i < 8; i++) {
+        assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sv[i]) == 0);
+        t_nonblock(sv[i][0]); t_nonblock(sv[i][1]);
+        pp[2*i]   = (t_pp){ sv[i][0], 1000 };
+        pp[2*i+1] = (t_pp){ sv[i][1], 1000 };
+        coro_rt_spawn(t_rt, t_ping, &pp[2*i], 0);
+        coro_rt_spawn(t_rt, t_pong, &pp[2*i+1], 0);
+    }
+    int quiet[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, quiet) == 0);
+    coro_rt_spawn(t_rt, t_timeout, (void*)(intptr_t)quiet[0], 0);
+    assert(coro_rt_run(t_rt) == 0);
+    assert(atomic_load(&t_count) == 17);
+    for (int i = 0; i < 8; i++) { close(sv[i][0]); close(sv[i][1]); }
+    close(quiet[0]); close(quiet[1]);
+
+    atomic_store(&t_count, 0);
+    for (int i = 0; i < 10; i++) coro_rt_spawn(t_rt, t_parent, NULL, 0);
+    assert(coro_rt_run(t_rt) == 0);
+    assert(atomic_load(&t_count) == 10 + 1000);
+
+    assert(coro_rt_run(t_rt) == 0);   // nothing to do
+    coro_rt_destroy(t_rt);
+    puts("coro: OK");
+    return 0;
+}
+#endif
+
+// ================= Bench =================
+#if defined(CORO_BENCH) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/socket.h>
+
+static double b_now(void){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void b_spin(void* arg){ for (;;) { (*(long*)arg)++; coro_yield(); } }
+
+static atomic_long b_n;
+static void b_yield(void* arg){
+    long k = (long)(intptr_t)arg;
+    for (long i = 0; i < k; i++) coro_yield();
+    atomic_fetch_add(&b_n, k);
+}
+
+typedef struct { int fd; int rounds; int first; } b_pp;
+static void b_pingpong(void* arg){
+    b_pp* p = (b_pp*)arg;
+    char c = 0;
+    for (int i = 0; i < p->rounds; i++) {
+        if (p->first || i) while (write(p->fd, &c, 1) != 1) coro_wait_fd(p->fd, IO_WRITE, -1);
+        if (!p->first && i == p->rounds - 1) break;
+        while (read(p->fd, &c, 1) != 1) coro_wait_fd(p->fd, IO_READ, -1);
+    }
+    if (!p->first) while (write(p->fd, &c, 1) != 1) coro_wait_fd(p->fd, IO_WRITE, -1);
+    atomic_fetch_add(&b_n, 1);
+}
+
+static void b_park(void* arg){ coro_sleep_ms((int)(intptr_t)arg); atomic_fetch_add(&b_n, 1); }
+
+static coro_stack_stats_t b_st;
+static void b_probe(void* arg){ coro_sleep_ms((int)(intptr_t)arg); coro_stack_stats(&b_st); }
+static void b_nop(void* arg){ (void)arg; }
+
+int main(int argc, char** argv){
+    size_t nt = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 0;
+
+    // 1) raw switch: resume + yield = two switches
+    long cnt = 0;
+    coro_t* c = coro_create(b_spin, &cnt, 0);
+    const long N = 5000000;
+    double t0 = b_now();
+    for (long i = 0; i < N; i++) coro_resume(c);
+    double dt = b_now() - t0;
+#if CORO_ASM
+    const char* how = "asm";
+#else
+    const char* how = "ucontext";
+#endif
+    printf("switch (%s): %.1f ns/switch\n", how, dt * 1e9 / (2.0 * (double)N));
+    (void)cnt;
+
+    // 2) runtime yield throughput
+    coro_rt_t* rt = coro_rt_create(nt);
+    atomic_store(&b_n, 0);
+    for (int i = 0; i < 1000; i++) coro_rt_spawn(rt, b_yield, (void*)(intptr_t)2000, 0);
+    t0 = b_now(); coro_rt_run(rt); dt = b_now() - t0;
+    printf("rt yield: %.2f M yields/s (1000 coros)\n", (double)atomic_load(&b_n) / dt / 1e6);
+
+    // 3) socketpair ping-pong through coro_wait_fd
+    enum { PAIRS = 64, ROUNDS = 5000 };
+    int sv[PAIRS][2]; b_pp pp[2*PAIRS];
+    for (int i = 0; i < PAIRS; i++) {
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sv[i]);
+        for (int k = 0; k < 2; k++) fcntl(sv[i][k], F_SETFL, fcntl(sv[i][k], F_GETFL) | O_NONBLOCK);
+        pp[2*i] = (b_pp){ sv[i][0], ROUNDS, 1 }; pp[2*i+1] = (b_pp){ sv[i][1], ROUNDS, 0 };
+        coro_rt_spawn(rt, b_pingpong, &pp[2*i], 0);
+        coro_rt_spawn(rt, b_pingpong, &pp[2*i+1], 0);
+    }
+    t0 = b_now(); coro_rt_run(rt); dt = b_now() - t0;
+    printf("ping-pong: %.0f k round trips/s (%d pairs)\n", PAIRS * (double)ROUNDS / dt / 1e3, PAIRS);
+    for (int i = 0; i < PAIRS; i++) { close(sv[i][0]); close(sv[i][1]); }
+
+    // 4) many parked coroutines (small stacks): more than the guard budget,
+    // the rest run on unguarded stacks
+    const int M = 100000;
+    coro_stack_allow_unguarded(1);
+    atomic_store(&b_n, 0);
+    t0 = b_now();
+    for (int i = 0; i < M; i++) coro_rt_spawn(rt, b_park, (void*)(intptr_t)(500 + i % 50), 16*1024);
+    coro_rt_spawn(rt, b_probe, (void*)(intptr_t)0, 0);
+    coro_rt_run(rt); dt = b_now() - t0;
+    printf("parked: %ld coros, spawn+sleep+exit in %.0f ms\n", (long)atomic_load(&b_n), dt * 1e3);
+    printf("  stacks: %zu live, %.0f MiB reserved, %.0f MiB committed, %zu without guard\n",
+           b_st.live, (double)b_st.reserved / (1 << 20), (double)b_st.committed / (1 << 20), b_st.unguarded);
+    coro_stack_allow_unguarded(0);
+
+    // 5) create + run + free: cached stack vs fresh mapping each time
+    const long K = 200000;
+    for (int pass = 0; pass < 2; pass++) {
+        t0 = b_now();
+        for (long i = 0; i < K; i++) {
+            coro_t* x = coro_create(b_nop, NULL, 64*1024);
+            coro_resume(x);
+            coro_free(x);
+            if (pass) coro_stack_trim();
+        }
+        dt = b_now() - t0;
+        printf("create+run+free (%s): %.0f ns\n", pass ? "mmap" : "cached", dt * 1e9 / (double)K);
+    }
+
+    coro_rt_destroy(rt);
+    coro_free(c);
+    return 0;
+}
+#endif
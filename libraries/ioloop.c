@@ -4,24 +4,39 @@
 // Namespace: "ioloop"
 //
 // Build examples:
-//   cc -std=c17 -O2 -Wall -Wextra -pedantic -D_GNU_SOURCE -c ioloop.c     # Linux (epoll)
+//   cc -std=c17 -O2 -Wall -Wextra -pedantic -D_GNU_SOURCE -c ioloop.c     # Linux (io_uring, epoll)
 //   cc -std=c17 -O2 -Wall -Wextra -pedantic -c ioloop.c                    # macOS/BSD (kqueue)
 //   # Fallback poll(2) if neither epoll/kqueue is available.
+//   # -DIO_NO_URING: Linux sans io_uring (epoll seul).
+//   Test:  cc -std=gnu17 -O2 -D_GNU_SOURCE -DIOLOOP_TEST  ioloop.c && ./a.out
+//   Bench: cc -std=gnu17 -O2 -D_GNU_SOURCE -DIOLOOP_BENCH ioloop.c && ./a.out
 //
 // Model:
-//   - FDs non-bloquants: watch READ/WRITE.
+//   - FDs non-bloquants: watch READ/WRITE (niveau, comme epoll sans EPOLLET).
+//   - Opérations à complétion: read/write/accept/connect; le callback reçoit
+//     le résultat, plus de read/write après coup. Sous io_uring tout ce qui
+//     est posté part en un lot: un seul io_uring_enter par itération soumet
+//     et attend. Ailleurs, émulées: essai immédiat, sinon attente READ/WRITE.
 //   - Timers (monotonic) one-shot ou périodiques.
 //   - Callbacks en C, boucle réentrante safe (post de tâches).
 //
 // API (C symbol layer):
 //   typedef struct ioloop ioloop;
 //   typedef void (*io_cb)(int fd, unsigned ev, void* ud);  // ev: IO_READ|IO_WRITE|IO_CLOSE|IO_TIMER
-//   ioloop*  io_new(void);
+//   ioloop*  io_new(void);                 // meilleur backend disponible
 //   void     io_free(ioloop* L);
 //   int      io_run(ioloop* L);            // boucle jusqu’à io_stop()
+//   int      io_poll(ioloop* L, int timeout_ms); // une itération: attend au plus
+//                                          // timeout_ms (-1 infini, 0 non bloquant),
+//                                          // dispatch; retourne le nb d’événements
 //   void     io_stop(ioloop* L);
 //   uint64_t io_now_ms(void);              // horloge monotone
 //
+//   // Backends
+//   enum { IO_BE_AUTO=0, IO_BE_URING, IO_BE_EPOLL, IO_BE_KQUEUE, IO_BE_POLL };
+//   ioloop*     io_new_backend(int be);    // NULL, errno=ENOTSUP si absent ici
+//   const char* io_backend_name(const ioloop* L);
+//
 //   // FDs
 //   enum { IO_READ=1u, IO_WRITE=2u, IO_CLOSE=4u, IO_TIMER=8u };
 //   int  io_add_fd(ioloop* L, int fd, unsigned flags, io_cb cb, void* ud);
@@ -34,10 +49,42 @@
 //                         io_cb cb, void* ud);
 //   int      io_cancel_timer(ioloop* L, io_timer id);
 //
+//   // Opérations à complétion: id >0 ou -errno. cb(res, ud) est appelé par
+//   // io_poll, jamais par l’appel qui poste. res: octets, nouveau fd, 0, ou
+//   // -errno (-ETIMEDOUT à l’échéance, -ECANCELED après io_cancel_op).
+//   // off: -1 = position courante (sockets, pipes). timeout_ms: -1 = aucun.
+//   typedef void (*io_done)(int res, void* ud);
+//   int io_read   (ioloop* L, int fd, void* buf, size_t n, int64_t off,
+//                  int timeout_ms, io_done cb, void* ud);
+//   int io_write  (ioloop* L, int fd, const void* buf, size_t n, int64_t off,
+//                  int timeout_ms, io_done cb, void* ud);
+//   int io_accept (ioloop* L, int fd, int timeout_ms, io_done cb, void* ud);
+//                  // nouveau fd non bloquant, close-on-exec
+//   int io_connect(ioloop* L, int fd, const struct sockaddr* sa, socklen_t len,
+//                  int timeout_ms, io_done cb, void* ud);
+//   int io_cancel_op(ioloop* L, int id);
+//
+//   // Buffers enregistrés: io_uring les épingle une fois pour toutes au lieu
+//   // d’une fois par opération. Ailleurs: lecture/écriture ordinaires.
+//   int io_register_buffers(ioloop* L, const struct iovec* iov, unsigned n);
+//   int io_unregister_buffers(ioloop* L);
+//   int io_read_fixed (ioloop* L, int fd, unsigned bi, void* buf, size_t n,
+//                      int64_t off, int timeout_ms, io_done cb, void* ud);
+//   int io_write_fixed(ioloop* L, int fd, unsigned bi, const void* buf, size_t n,
+//                      int64_t off, int timeout_ms, io_done cb, void* ud);
+//
 // Notes:
 //   - Couche neutre VM. Le binding VM doit traduire vers objets/closures.
 //   - Erreurs: -EINVAL, -ENOMEM, -EIO.
 //   - Les callbacks reçoivent fd=-1 pour les timers.
+//   - io_uring (Linux >= 5.11, FEAT_EXT_ARG) est pris par io_new si le noyau
+//     le permet, sinon epoll. La disponibilité y passe par des POLL_ADD
+//     one-shot réarmés après chaque callback: même sémantique (niveau).
+//   - Les buffers et la sockaddr d’une opération restent à l’appelant jusqu’au
+//     callback (la sockaddr est copiée). io_del_fd avant close(fd).
+//   - Une boucle n’est utilisée que par un thread à la fois. io_uring annule
+//     les requêtes d’un thread qui se termine: la disponibilité est reposée
+//     seule, une opération en vol se termine en erreur (-ECANCELED).
 //
 // Deps VM optionnels: auxlib.h, state.h, object.h, vm.h
 
@@ -48,6 +95,11 @@
 #include <stdbool.h>
 #include <time.h>
 #include <unistd.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #ifndef EINVAL
 #  define EINVAL 22
@@ -86,20 +138,35 @@ VL_EXPORT uint64_t io_now_ms(void) { return mono_ms(); }
 #if defined(__linux__)
 #  define IO_EPOLL 1
 #  include <sys/epoll.h>
+#  if !defined(IO_NO_URING) && defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#      define IO_URING 1
+#      include <linux/io_uring.h>
+#      include <sys/mman.h>
+#      include <sys/syscall.h>
+#      ifndef POLLRDHUP
+#        define POLLRDHUP 0x2000       // <poll.h> ne l’expose qu’avec _GNU_SOURCE
+#      endif
+#    endif
+#  endif
 #elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
 #  define IO_KQUEUE 1
 #  include <sys/event.h>
 #  include <sys/time.h>
 #else
 #  define IO_POLL 1
-#  include <poll.h>
-#  include <limits.h>
 #endif
 
 // ---------- Public flags ----------
 enum { IO_READ=1u, IO_WRITE=2u, IO_CLOSE=4u, IO_TIMER=8u };
+enum { IO_BE_AUTO=0, IO_BE_URING, IO_BE_EPOLL, IO_BE_KQUEUE, IO_BE_POLL };
 
 typedef void (*io_cb)(int fd, unsigned ev, void* ud);
+typedef void (*io_done)(int res, void* ud);
+
+struct ioloop;
+VL_EXPORT int io_add_timer(struct ioloop* L, uint64_t delay_ms, uint64_t period_ms, io_cb cb, void* ud);
+VL_EXPORT int io_cancel_timer(struct ioloop* L, int id);
 
 // ---------- Timer heap ----------
 typedef struct {
@@ -155,15 +222,77 @@ static TNode* heap_top(THeap* h){ return h->n? &h->a[0] : NULL; }
 
 // ---------- FD table ----------
 typedef struct {
-  int used;
+  int used;           // enregistré par io_add_fd
   unsigned mask;
   io_cb cb;
   void* ud;
+  int ops;            // émulation: opérations en attente sur ce fd (liste)
+  unsigned emask;     // émulation: masque posé au backend (utilisateur | ops)
+  int reg;            // émulation: fd connu du backend
+  uint32_t gen;       // io_uring: change à chaque add/mod/del
+  int armed;          // io_uring: 1 POLL_ADD en vol, 0 à réarmer, -1 arrêté (erreur)
 } FDent;
 
+// ---------- Opérations à complétion ----------
+enum { OP_FREE=0, OP_READ, OP_WRITE, OP_ACCEPT, OP_CONNECT };
+enum { OPS_NEW=0, OPS_WAIT, OPS_DONE };   // émulation
+
+typedef struct {
+  int      kind;
+  int      state;
+  int      fd;
+  void*    buf;
+  size_t   n;
+  int64_t  off;
+  int      fixed;
+  unsigned bi;
+  struct sockaddr_storage sa;
+  socklen_t salen;
+  int      connecting;
+  int      timeout_ms;
+  int      timer;      // émulation: timer d’échéance, 0 si aucun
+  int      cancelled;
+  int      res;
+  uint32_t gen;
+  int      next;       // liste libre / liste du fd / terminées
+  int      idx;
+  struct ioloop* loop;
+  io_done  cb;
+  void*    ud;
+#if IO_URING
+  struct __kernel_timespec ts;   // lu par le noyau à la soumission
+#endif
+} IoOp;
+
+// Blocs de taille fixe: une IoOp ne bouge jamais (sockaddr et timespec
+// sont lus par le noyau après l’appel qui poste).
+#define OPS_CHUNK 256
+#define OPS_MAX   ((1 << 21) - 1)
+
+#if IO_URING
+#define UR_ENTRIES 256
+typedef struct {
+  int fd;
+  void* ring; size_t ring_len;
+  struct io_uring_sqe* sqes; size_t sqes_len;
+  unsigned *sq_head, *sq_tail, *sq_flags, *sq_array;
+  unsigned sq_mask, sq_entries;
+  unsigned tail;                   // copie locale de *sq_tail
+  unsigned *cq_head, *cq_tail;
+  unsigned cq_mask;
+  struct io_uring_cqe* cqes;
+  int nbufs;
+} URing;
+#endif
+
 // ---------- Loop ----------
 typedef struct ioloop {
   int running;
+  int be;
+#if IO_URING
+  URing ur;
+  int rearm;          // des POLL_ADD n’ont pas trouvé de place: à reposer
+#endif
 #if IO_EPOLL
   int ep;
 #elif IO_KQUEUE
@@ -171,10 +300,16 @@ typedef struct ioloop {
 #else
   struct pollfd* pfds;
   int pfds_n, pfds_cap;
+  int pdirty;         // pfds à reconstruire
 #endif
   FDent* fdt;
   int fdt_n, fdt_cap;
 
+  IoOp** opc;         // blocs d’OPS_CHUNK
+  int opc_n;
+  int op_free;        // liste libre, -1 si vide
+  int done_head, done_tail;   // émulation: terminées, à livrer
+
   THeap th;
 } ioloop;
 
@@ -188,13 +323,67 @@ static int fdt_reserve(ioloop* L, int fd){
     if (cap > (1<<20)) return -ENOMEM;
     cap <<= 1;
   }
-  void* p = realloc(L->fdt, (size_t)cap * sizeof(FDent));
-  if (!p) return -ENOMEM;
-  for (int i=L->fdt_cap;i<cap;i++){ L->fdt[i].used=0; L->fdt[i].mask=0; L->fdt[i].cb=NULL; L->fdt[i].ud=NULL; }
-  L->fdt = (FDent*)p; L->fdt_cap = cap; L->fdt_n = need;
+  if (cap > L->fdt_cap) {
+    void* p = realloc(L->fdt, (size_t)cap * sizeof(FDent));
+    if (!p) return -ENOMEM;
+    L->fdt = (FDent*)p;
+    for (int i=L->fdt_cap;i<cap;i++){ memset(&L->fdt[i], 0, sizeof(FDent)); L->fdt[i].ops = -1; }
+    L->fdt_cap = cap;
+  }
+  L->fdt_n = need;
   return 0;
 }
 
+static IoOp* op_at(ioloop* L, int i){ return &L->opc[i / OPS_CHUNK][i % OPS_CHUNK]; }
+
+static int op_alloc(ioloop* L){
+  if (L->op_free < 0) {
+    if ((L->opc_n + 1) * OPS_CHUNK > OPS_MAX) return -ENOMEM;
+    IoOp** pc = (IoOp**)realloc(L->opc, (size_t)(L->opc_n + 1) * sizeof(*pc));
+    if (!pc) return -ENOMEM;
+    L->opc = pc;
+    IoOp* c = (IoOp*)calloc(OPS_CHUNK, sizeof(IoOp));
+    if (!c) return -ENOMEM;
+    L->opc[L->opc_n] = c;
+    int base = L->opc_n++ * OPS_CHUNK;
+    for (int i = OPS_CHUNK - 1; i >= 0; i--) {
+      c[i].idx = base + i; c[i].loop = L;
+      c[i].next = L->op_free; L->op_free = base + i;
+    }
+  }
+  int i = L->op_free;
+  IoOp* o = op_at(L, i);
+  L->op_free = o->next;
+  o->next = -1;
+  return i;
+}
+
+static void op_release(ioloop* L, int i){
+  IoOp* o = op_at(L, i);
+  o->kind = OP_FREE;
+  o->gen++;
+  o->next = L->op_free;
+  L->op_free = i;
+}
+
+static int op_id(ioloop* L, int i){ return (int)(((op_at(L, i)->gen & 0x3FFu) << 21) | (uint32_t)(i + 1)); }
+
+static int op_from_id(ioloop* L, int id){
+  if (id <= 0) return -1;
+  int i = (id & OPS_MAX) - 1;
+  if (i < 0 || i >= L->opc_n * OPS_CHUNK) return -1;
+  IoOp* o = op_at(L, i);
+  if (o->kind == OP_FREE || (o->gen & 0x3FFu) != ((unsigned)id >> 21)) return -1;
+  return i;
+}
+
+static unsigned op_dir(const IoOp* o){
+  return (o->kind == OP_READ || o->kind == OP_ACCEPT) ? IO_READ : IO_WRITE;
+}
+
+// Libère l’entrée puis appelle le callback (qui peut reposter aussitôt).
+static void op_finish(ioloop* L, int i, int res);
+
 // ---------- Backend ops ----------
 #if IO_EPOLL
 static int be_add(ioloop* L, int fd, unsigned m){
@@ -213,13 +402,18 @@ static int be_del(ioloop* L, int fd){
   return epoll_ctl(L->ep, EPOLL_CTL_DEL, fd, NULL);
 }
 #elif IO_KQUEUE
+// Un filtre par appel: supprimer un filtre jamais posé (ENOENT) n’est pas
+// une erreur, sinon io_add_fd(IO_READ) échouerait sur le EV_DELETE d’écriture.
+static int be_one(ioloop* L, int fd, int filt, int flags) {
+  struct kevent ch;
+  EV_SET(&ch, fd, filt, flags, 0, 0, NULL);
+  int rc = kevent(L->kq, &ch, 1, NULL, 0, NULL);
+  return (rc < 0 && errno == ENOENT && (flags & EV_DELETE)) ? 0 : rc;
+}
 static int be_apply(ioloop* L, int fd, unsigned m, int add) {
-  struct kevent ch[2]; int n=0;
-  if (m & IO_READ)  EV_SET(&ch[n++], fd, EVFILT_READ,  add?EV_ADD:EV_DELETE, 0, 0, NULL);
-  else              EV_SET(&ch[n++], fd, EVFILT_READ,  EV_DELETE,          0, 0, NULL);
-  if (m & IO_WRITE) EV_SET(&ch[n++], fd, EVFILT_WRITE, add?EV_ADD:EV_DELETE,0, 0, NULL);
-  else              EV_SET(&ch[n++], fd, EVFILT_WRITE, EV_DELETE,          0, 0, NULL);
-  return kevent(L->kq, ch, n, NULL, 0, NULL);
+  int r = be_one(L, fd, EVFILT_READ,  (add && (m & IO_READ))  ? EV_ADD : EV_DELETE);
+  int w = be_one(L, fd, EVFILT_WRITE, (add && (m & IO_WRITE)) ? EV_ADD : EV_DELETE);
+  return (r < 0 || w < 0) ? -1 : 0;
 }
 static int be_add(ioloop* L, int fd, unsigned m){ return be_apply(L,fd,m,1); }
 static int be_mod(ioloop* L, int fd, unsigned m){ return be_apply(L,fd,m,1); }
@@ -233,45 +427,487 @@ static int pfds_reserve(ioloop* L, int need){
   if (!p) return -ENOMEM;
   L->pfds = (struct pollfd*)p; L->pfds_cap=cap; return 0;
 }
+// Reconstruit seulement après un changement d’enregistrement, pas à
+// chaque itération.
 static int be_rebuild_poll(ioloop* L){
   int cnt=0;
-  for (int fd=0; fd<L->fdt_n; ++fd) if (L->fdt[fd].used) cnt++;
+  for (int fd=0; fd<L->fdt_n; ++fd) if (L->fdt[fd].reg) cnt++;
   if (pfds_reserve(L, cnt)!=0) return -ENOMEM;
   L->pfds_n = 0;
   for (int fd=0; fd<L->fdt_n; ++fd){
-    if (!L->fdt[fd].used) continue;
+    if (!L->fdt[fd].reg) continue;
     struct pollfd p={0};
     p.fd = fd;
-    p.events = (L->fdt[fd].mask&IO_READ?POLLIN:0) | (L->fdt[fd].mask&IO_WRITE?POLLOUT:0);
+    p.events = (L->fdt[fd].emask&IO_READ?POLLIN:0) | (L->fdt[fd].emask&IO_WRITE?POLLOUT:0);
     L->pfds[L->pfds_n++] = p;
   }
+  L->pdirty = 0;
   return 0;
 }
-static int be_add(ioloop* L, int fd, unsigned m){ (void)fd;(void)m; return be_rebuild_poll(L); }
-static int be_mod(ioloop* L, int fd, unsigned m){ (void)fd;(void)m; return be_rebuild_poll(L); }
-static int be_del(ioloop* L, int fd){ (void)fd; return be_rebuild_poll(L); }
+static int be_add(ioloop* L, int fd, unsigned m){ (void)fd;(void)m; L->pdirty = 1; return 0; }
+static int be_mod(ioloop* L, int fd, unsigned m){ (void)fd;(void)m; L->pdirty = 1; return 0; }
+static int be_del(ioloop* L, int fd){ (void)fd; L->pdirty = 1; return 0; }
 #endif
 
+// ---------- Émulation des opérations (epoll/kqueue/poll) ----------
+// Accorde le masque posé au backend avec l’utilisateur et les opérations
+// en attente sur fd.
+static int fd_sync(ioloop* L, int fd){
+  FDent* e = &L->fdt[fd];
+  unsigned om = 0;
+  for (int i = e->ops; i >= 0; i = op_at(L, i)->next) om |= op_dir(op_at(L, i));
+  unsigned want = (e->used ? e->mask : 0) | om;
+  if (!e->used && !om) {
+    if (e->reg) { be_del(L, fd); e->reg = 0; e->emask = 0; }
+    return 0;
+  }
+  if (e->reg && want == e->emask) return 0;
+  if ((e->reg ? be_mod(L, fd, want) : be_add(L, fd, want)) != 0) return -EIO;
+  e->reg = 1; e->emask = want;
+  return 0;
+}
+
+static void done_push(ioloop* L, int i){
+  IoOp* o = op_at(L, i);
+  o->state = OPS_DONE;
+  o->next = -1;
+  if (L->done_tail >= 0) op_at(L, L->done_tail)->next = i; else L->done_head = i;
+  L->done_tail = i;
+}
+
+static void op_unlink(ioloop* L, int i){
+  IoOp* o = op_at(L, i);
+  for (int* pp = &L->fdt[o->fd].ops; *pp >= 0; pp = &op_at(L, *pp)->next)
+    if (*pp == i) { *pp = o->next; break; }
+  o->next = -1;
+}
+
+// 1: terminée (o->res), 0: à réessayer quand le fd sera prêt.
+static int op_try(IoOp* o){
+  ssize_t r = -1;
+  do {
+    switch (o->kind) {
+    case OP_READ:
+      r = o->off < 0 ? read(o->fd, o->buf, o->n) : pread(o->fd, o->buf, o->n, (off_t)o->off);
+      break;
+    case OP_WRITE:
+      r = o->off < 0 ? write(o->fd, o->buf, o->n) : pwrite(o->fd, o->buf, o->n, (off_t)o->off);
+      break;
+    case OP_ACCEPT:
+#if defined(__linux__) && defined(_GNU_SOURCE)
+      r = accept4(o->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+      r = accept(o->fd, NULL, NULL);
+      if (r >= 0) {
+        fcntl((int)r, F_SETFL, fcntl((int)r, F_GETFL) | O_NONBLOCK);
+        fcntl((int)r, F_SETFD, FD_CLOEXEC);
+      }
+#endif
+      break;
+    case OP_CONNECT:
+      if (!o->connecting) {
+        r = connect(o->fd, (const struct sockaddr*)&o->sa, o->salen);
+        if (r < 0 && errno == EINPROGRESS) { o->connecting = 1; return 0; }
+      } else {
+        int err = 0;
+        socklen_t l = sizeof err;
+        if (getsockopt(o->fd, SOL_SOCKET, SO_ERROR, &err, &l) != 0) err = errno;
+        if (err) { errno = err; r = -1; } else r = 0;
+      }
+      break;
+    }
+  } while (r < 0 && errno == EINTR);
+  if (r < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+    o->res = -errno;
+    return 1;
+  }
+  o->res = (int)r;
+  return 1;
+}
+
+// Timer d’échéance d’une opération en attente.
+static void em_expire(int fd, unsigned ev, void* ud){
+  (void)fd; (void)ev;
+  IoOp* o = (IoOp*)ud;
+  ioloop* L = o->loop;
+  if (o->kind == OP_FREE || o->state != OPS_WAIT) return;
+  int f = o->fd;
+  op_unlink(L, o->idx);
+  o->timer = 0;
+  o->res = -ETIMEDOUT;
+  done_push(L, o->idx);
+  fd_sync(L, f);
+}
+
+static int em_post(ioloop* L, int i){
+  IoOp* o = op_at(L, i);
+  if (op_try(o)) { done_push(L, i); return 0; }
+  if (fdt_reserve(L, o->fd) != 0) return -ENOMEM;
+  int* pp = &L->fdt[o->fd].ops;       // FIFO par fd
+  while (*pp >= 0) pp = &op_at(L, *pp)->next;
+  *pp = i;
+  o->state = OPS_WAIT;
+  if (fd_sync(L, o->fd) != 0) { op_unlink(L, i); return -EIO; }
+  if (o->timeout_ms >= 0) {
+    int t = io_add_timer(L, (uint64_t)o->timeout_ms, 0, em_expire, o);
+    if (t > 0) o->timer = t;
+  }
+  return 0;
+}
+
+// Disponibilité sur fd: d’abord les opérations en attente, puis l’utilisateur
+// pour ce qu’il a demandé.
+static int fd_event(ioloop* L, int fd, unsigned m){
+  if (fd < 0 || fd >= L->fdt_n) return 0;
+  FDent* e = &L->fdt[fd];
+  if (e->ops >= 0) {
+    int changed = 0;
+    for (int* pp = &e->ops; *pp >= 0; ) {
+      int i = *pp;
+      IoOp* o = op_at(L, i);
+      if (!(m & (op_dir(o) | IO_CLOSE)) || !op_try(o)) { pp = &o->next; continue; }
+      *pp = o->next;
+      done_push(L, i);
+      changed = 1;
+    }
+    if (changed) fd_sync(L, fd);
+  }
+  unsigned um = m & (e->mask | IO_CLOSE);
+  if (!e->used || !e->cb || !um) return 0;
+  e->cb(fd, um, e->ud);
+  return 1;
+}
+
+// Livre les opérations terminées avant cet appel; celles qui terminent
+// pendant la livraison attendent l’itération suivante.
+static int done_flush(ioloop* L){
+  int i = L->done_head, n = 0;
+  L->done_head = L->done_tail = -1;
+  while (i >= 0) {
+    IoOp* o = op_at(L, i);
+    int next = o->next;
+    op_finish(L, i, o->res);
+    i = next;
+    n++;
+  }
+  return n;
+}
+
+// ---------- io_uring ----------
+#if IO_URING
+// user_data: type (8 bits) | génération (24 bits) | fd ou indice d’opération
+enum { UK_IGN = 0, UK_POLL = 1, UK_OP = 2 };
+static uint64_t ud_pack(unsigned kind, uint32_t gen, int idx){
+  return ((uint64_t)kind << 56) | ((uint64_t)(gen & 0xFFFFFFu) << 32) | (uint32_t)idx;
+}
+
+static int ur_enter(int fd, unsigned sub, unsigned minc, unsigned flags, void* arg, size_t argsz){
+  return (int)syscall(__NR_io_uring_enter, fd, sub, minc, flags, arg, argsz);
+}
+
+static void ur_close(URing* R){
+  if (R->sqes) munmap(R->sqes, R->sqes_len);
+  if (R->ring) munmap(R->ring, R->ring_len);
+  if (R->fd >= 0) close(R->fd);
+  R->fd = -1; R->ring = NULL; R->sqes = NULL;
+}
+
+static int ur_init(URing* R){
+  struct io_uring_params p;
+  memset(&p, 0, sizeof p);
+  p.flags = IORING_SETUP_CQSIZE;
+  p.cq_entries = UR_ENTRIES * 8;       // marge: un lot de POLL peut tout compléter
+#ifdef IORING_SETUP_COOP_TASKRUN
+  p.flags |= IORING_SETUP_COOP_TASKRUN;
+#endif
+  R->fd = (int)syscall(__NR_io_uring_setup, UR_ENTRIES, &p);
+  if (R->fd < 0 && errno == EINVAL) {  // noyau < 5.19: sans COOP_TASKRUN
+    memset(&p, 0, sizeof p);
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = UR_ENTRIES * 8;
+    R->fd = (int)syscall(__NR_io_uring_setup, UR_ENTRIES, &p);
+  }
+  if (R->fd < 0) return -1;
+  unsigned need = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+  if ((p.features & need) != need) { ur_close(R); errno = ENOTSUP; return -1; }
+
+  size_t sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  size_t cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  R->ring_len = sq_len > cq_len ? sq_len : cq_len;
+  R->ring = mmap(NULL, R->ring_len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, R->fd, IORING_OFF_SQ_RING);
+  if (R->ring == MAP_FAILED) { R->ring = NULL; ur_close(R); return -1; }
+  R->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+  R->sqes = (struct io_uring_sqe*)mmap(NULL, R->sqes_len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, R->fd, IORING_OFF_SQES);
+  if (R->sqes == MAP_FAILED) { R->sqes = NULL; ur_close(R); return -1; }
+
+  char* b = (char*)R->ring;
+  R->sq_head  = (unsigned*)(b + p.sq_off.head);
+  R->sq_tail  = (unsigned*)(b + p.sq_off.tail);
+  R->sq_flags = (unsigned*)(b + p.sq_off.flags);
+  R->sq_array = (unsigned*)(b + p.sq_off.array);
+  R->sq_mask  = *(unsigned*)(b + p.sq_off.ring_mask);
+  R->sq_entries = p.sq_entries;
+  R->cq_head  = (unsigned*)(b + p.cq_off.head);
+  R->cq_tail  = (unsigned*)(b + p.cq_off.tail);
+  R->cq_mask  = *(unsigned*)(b + p.cq_off.ring_mask);
+  R->cqes     = (struct io_uring_cqe*)(b + p.cq_off.cqes);
+  for (unsigned i = 0; i < p.sq_entries; i++) R->sq_array[i] = i;   // identité
+  R->tail = *R->sq_tail;
+  return 0;
+}
+
+static unsigned ur_queued(URing* R){ return R->tail - __atomic_load_n(R->sq_head, __ATOMIC_ACQUIRE); }
+
+// Soumet ce qui attend sans rien attendre (SQ pleine).
+static int ur_flush(URing* R){
+  unsigned q = ur_queued(R);
+  if (!q) return 0;
+  int rc;
+  do rc = ur_enter(R->fd, q, 0, 0, NULL, 0); while (rc < 0 && errno == EINTR);
+  return rc < 0 ? -errno : 0;
+}
+
+// Garantit k entrées libres consécutives (une opération + son LINK_TIMEOUT
+// doivent partir dans le même lot).
+static int ur_room(URing* R, unsigned k){
+  if (R->sq_entries - ur_queued(R) >= k) return 0;
+  ur_flush(R);
+  return R->sq_entries - ur_queued(R) >= k ? 0 : -EBUSY;
+}
+
+static struct io_uring_sqe* ur_sqe(URing* R){
+  if (ur_room(R, 1) != 0) return NULL;
+  struct io_uring_sqe* e = &R->sqes[R->tail & R->sq_mask];
+  memset(e, 0, sizeof *e);
+  R->tail++;
+  // sans SQPOLL, le noyau ne lit la queue qu’à io_uring_enter
+  __atomic_store_n(R->sq_tail, R->tail, __ATOMIC_RELEASE);
+  return e;
+}
+
+static uint32_t ur_poll_mask(unsigned m){
+  uint32_t ev = POLLRDHUP | ((m & IO_READ) ? POLLIN : 0) | ((m & IO_WRITE) ? POLLOUT : 0);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  ev = (ev << 16) | (ev >> 16);      // poll32_events: demi-mots échangés
+#endif
+  return ev;
+}
+
+static int ur_arm(ioloop* L, int fd){
+  FDent* e = &L->fdt[fd];
+  struct io_uring_sqe* s = ur_sqe(&L->ur);
+  if (!s) { e->armed = 0; L->rearm = 1; return -EBUSY; }
+  s->opcode = IORING_OP_POLL_ADD;
+  s->fd = fd;
+  s->poll32_events = ur_poll_mask(e->mask);
+  s->user_data = ud_pack(UK_POLL, e->gen, fd);
+  e->armed = 1;
+  return 0;
+}
+
+static void ur_disarm(ioloop* L, int fd){
+  FDent* e = &L->fdt[fd];
+  if (e->armed == 1) {
+    // sans place, le POLL_ADD finira tout seul et sera ignoré (génération)
+    struct io_uring_sqe* s = ur_sqe(&L->ur);
+    if (s) {
+      s->opcode = IORING_OP_POLL_REMOVE;
+      s->fd = -1;
+      s->addr = ud_pack(UK_POLL, e->gen, fd);
+      s->user_data = ud_pack(UK_IGN, 0, 0);
+    }
+  }
+  e->armed = 0;
+  e->gen++;
+}
+
+static int ur_op(ioloop* L, int i){
+  IoOp* o = op_at(L, i);
+  URing* R = &L->ur;
+  if (ur_room(R, o->timeout_ms >= 0 ? 2 : 1) != 0) return -EBUSY;
+  struct io_uring_sqe* s = ur_sqe(R);
+  s->fd = o->fd;
+  s->user_data = ud_pack(UK_OP, o->gen, i);
+  switch (o->kind) {
+  case OP_READ:
+  case OP_WRITE:
+    if (o->fixed) s->opcode = o->kind == OP_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+    else          s->opcode = o->kind == OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+    s->addr = (uint64_t)(uintptr_t)o->buf;
+    s->len = (uint32_t)o->n;
+    s->off = (uint64_t)o->off;       // -1: position courante
+    s->buf_index = (uint16_t)o->bi;
+    break;
+  case OP_ACCEPT:
+    s->opcode = IORING_OP_ACCEPT;
+    s->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    break;
+  case OP_CONNECT:
+    s->opcode = IORING_OP_CONNECT;
+    s->addr = (uint64_t)(uintptr_t)&o->sa;
+    s->off = o->salen;
+    break;
+  }
+  if (o->timeout_ms >= 0) {
+    s->flags |= IOSQE_IO_LINK;
+    o->ts.tv_sec = o->timeout_ms / 1000;
+    o->ts.tv_nsec = (long long)(o->timeout_ms % 1000) * 1000000LL;
+    struct io_uring_sqe* t = ur_sqe(R);
+    t->opcode = IORING_OP_LINK_TIMEOUT;
+    t->fd = -1;
+    t->addr = (uint64_t)(uintptr_t)&o->ts;
+    t->len = 1;
+    t->user_data = ud_pack(UK_IGN, 0, 0);
+  }
+  return 0;
+}
+
+static int ur_dispatch(ioloop* L, const struct io_uring_cqe* c){
+  unsigned kind = (unsigned)(c->user_data >> 56);
+  uint32_t gen = (uint32_t)(c->user_data >> 32) & 0xFFFFFFu;
+  int idx = (int)(uint32_t)c->user_data;
+  if (kind == UK_POLL) {
+    if (idx >= L->fdt_n) return 0;
+    FDent* e = &L->fdt[idx];
+    if (!e->used || (e->gen & 0xFFFFFFu) != gen) return 0;   // retiré ou modifié depuis
+    e->armed = 0;
+    // annulé sans retrait de notre part (le thread qui l’avait soumis est
+    // sorti): on repose, rien à signaler
+    if (c->res == -ECANCELED) { ur_arm(L, idx); return 0; }
+    unsigned m = 0;
+    if (c->res < 0) m = IO_CLOSE;
+    else {
+      if (c->res & POLLIN)  m |= IO_READ;
+      if (c->res & POLLOUT) m |= IO_WRITE;
+      if (c->res & (POLLHUP|POLLERR|POLLRDHUP)) m |= IO_CLOSE;
+    }
+    m &= e->mask | IO_CLOSE;
+    if (m) e->cb(idx, m, e->ud);
+    e = &L->fdt[idx];                 // fdt a pu être réallouée
+    if (e->used && (e->gen & 0xFFFFFFu) == gen && e->armed == 0) {
+      if (c->res < 0) e->armed = -1;  // fd invalide: pas de boucle d’erreurs
+      else ur_arm(L, idx);
+    }
+    return m ? 1 : 0;
+  }
+  if (kind == UK_OP) {
+    if (idx >= L->opc_n * OPS_CHUNK) return 0;
+    IoOp* o = op_at(L, idx);
+    if (o->kind == OP_FREE || (o->gen & 0xFFFFFFu) != gen) return 0;
+    int res = c->res;
+    if (res == -ECANCELED && o->timeout_ms >= 0 && !o->cancelled) res = -ETIMEDOUT;
+    op_finish(L, idx, res);
+    return 1;
+  }
+  return 0;
+}
+
+static int ur_wait(ioloop* L, int timeout_ms){
+  URing* R = &L->ur;
+  if (L->rearm) {
+    L->rearm = 0;
+    for (int fd = 0; fd < L->fdt_n; fd++)
+      if (L->fdt[fd].used && L->fdt[fd].armed == 0) ur_arm(L, fd);
+  }
+  if (__atomic_load_n(R->cq_tail, __ATOMIC_ACQUIRE) != *R->cq_head) timeout_ms = 0;
+  unsigned q = ur_queued(R);
+  unsigned sqf = __atomic_load_n(R->sq_flags, __ATOMIC_RELAXED);
+  unsigned kick = IORING_SQ_CQ_OVERFLOW;
+#ifdef IORING_SQ_TASKRUN
+  kick |= IORING_SQ_TASKRUN;
+#endif
+  // un seul appel: soumission du lot + attente bornée
+  if (q || timeout_ms != 0 || (sqf & kick)) {
+    int rc;
+    if (timeout_ms != 0) {
+      struct __kernel_timespec ts;
+      struct io_uring_getevents_arg ga;
+      memset(&ga, 0, sizeof ga);
+      if (timeout_ms > 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL;
+        ga.ts = (uint64_t)(uintptr_t)&ts;
+      }
+      rc = ur_enter(R->fd, q, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &ga, sizeof ga);
+    } else {
+      rc = ur_enter(R->fd, q, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+    if (rc < 0 && errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN) return -EIO;
+  }
+  int n = 0;
+  unsigned head = *R->cq_head;
+  unsigned tail = __atomic_load_n(R->cq_tail, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    struct io_uring_cqe c = R->cqes[head & R->cq_mask];
+    __atomic_store_n(R->cq_head, ++head, __ATOMIC_RELEASE);
+    n += ur_dispatch(L, &c);
+  }
+  return n;
+}
+#endif // IO_URING
+
+static void op_finish(ioloop* L, int i, int res){
+  IoOp* o = op_at(L, i);
+  io_done cb = o->cb; void* ud = o->ud;
+  if (o->timer) io_cancel_timer(L, o->timer);
+  op_release(L, i);
+  cb(res, ud);
+}
+
 // ---------- Public API ----------
-VL_EXPORT ioloop* io_new(void){
+VL_EXPORT ioloop* io_new_backend(int be){
   ioloop* L = (ioloop*)calloc(1, sizeof(*L));
   if (!L) return NULL;
+  L->fdt = NULL; L->fdt_n = L->fdt_cap = 0;
+  L->th.a = NULL; L->th.n = L->th.cap = 0; L->th.next_id = 1;
+  L->op_free = -1;
+  L->done_head = L->done_tail = -1;
+#if IO_EPOLL
+  L->ep = -1;
+#endif
+#if IO_URING
+  L->ur.fd = -1;
+  if (be == IO_BE_AUTO || be == IO_BE_URING) {
+    if (ur_init(&L->ur) == 0) { L->be = IO_BE_URING; return L; }
+    if (be == IO_BE_URING) { free(L); errno = ENOTSUP; return NULL; }
+  }
+#endif
 #if IO_EPOLL
+  if (be != IO_BE_AUTO && be != IO_BE_EPOLL) { free(L); errno = ENOTSUP; return NULL; }
+  L->be = IO_BE_EPOLL;
   L->ep = epoll_create1(EPOLL_CLOEXEC);
   if (L->ep < 0) { free(L); return NULL; }
 #elif IO_KQUEUE
+  if (be != IO_BE_AUTO && be != IO_BE_KQUEUE) { free(L); errno = ENOTSUP; return NULL; }
+  L->be = IO_BE_KQUEUE;
   L->kq = kqueue();
   if (L->kq < 0) { free(L); return NULL; }
 #else
+  if (be != IO_BE_AUTO && be != IO_BE_POLL) { free(L); errno = ENOTSUP; return NULL; }
+  L->be = IO_BE_POLL;
   L->pfds = NULL; L->pfds_n = L->pfds_cap = 0;
 #endif
-  L->fdt = NULL; L->fdt_n = L->fdt_cap = 0;
-  L->th.a = NULL; L->th.n = L->th.cap = 0; L->th.next_id = 1;
   return L;
 }
 
+VL_EXPORT ioloop* io_new(void){ return io_new_backend(IO_BE_AUTO); }
+
+VL_EXPORT const char* io_backend_name(const ioloop* L){
+  if (!L) return "none";
+  switch (L->be) {
+  case IO_BE_URING:  return "io_uring";
+  case IO_BE_EPOLL:  return "epoll";
+  case IO_BE_KQUEUE: return "kqueue";
+  default:           return "poll";
+  }
+}
+
 VL_EXPORT void io_free(ioloop* L){
   if (!L) return;
+#if IO_URING
+  if (L->ur.fd >= 0) ur_close(&L->ur);
+#endif
 #if IO_EPOLL
   if (L->ep >= 0) close(L->ep);
 #elif IO_KQUEUE
@@ -279,6 +915,8 @@ VL_EXPORT void io_free(ioloop* L){
 #else
   free(L->pfds);
 #endif
+  for (int i = 0; i < L->opc_n; i++) free(L->opc[i]);
+  free(L->opc);
   free(L->fdt);
   free(L->th.a);
   free(L);
@@ -289,25 +927,45 @@ VL_EXPORT void io_stop(ioloop* L){ if (L) L->running = 0; }
 VL_EXPORT int io_add_fd(ioloop* L, int fd, unsigned flags, io_cb cb, void* ud){
   if (!L || fd < 0 || !cb) return -EINVAL;
   if (fdt_reserve(L, fd)!=0) return -ENOMEM;
-  L->fdt[fd].used = 1;
-  L->fdt[fd].mask = flags & (IO_READ|IO_WRITE);
-  L->fdt[fd].cb   = cb;
-  L->fdt[fd].ud   = ud;
-  if (be_add(L, fd, L->fdt[fd].mask) != 0) return -EIO;
+  FDent* e = &L->fdt[fd];
+#if IO_URING
+  if (L->be == IO_BE_URING && e->used) ur_disarm(L, fd);
+#endif
+  e->used = 1;
+  e->mask = flags & (IO_READ|IO_WRITE);
+  e->cb   = cb;
+  e->ud   = ud;
+#if IO_URING
+  if (L->be == IO_BE_URING) {
+    e->gen++;
+    ur_arm(L, fd);                    // soumis au prochain io_poll
+    return 0;
+  }
+#endif
+  if (fd_sync(L, fd) != 0) { e->used = 0; return -EIO; }
   return 0;
 }
 
 VL_EXPORT int io_mod_fd(ioloop* L, int fd, unsigned flags){
   if (!L || fd < 0 || fd >= L->fdt_n || !L->fdt[fd].used) return -EINVAL;
   L->fdt[fd].mask = flags & (IO_READ|IO_WRITE);
-  if (be_mod(L, fd, L->fdt[fd].mask) != 0) return -EIO;
+#if IO_URING
+  if (L->be == IO_BE_URING) { ur_disarm(L, fd); ur_arm(L, fd); return 0; }
+#endif
+  if (fd_sync(L, fd) != 0) return -EIO;
   return 0;
 }
 
 VL_EXPORT int io_del_fd(ioloop* L, int fd){
   if (!L || fd < 0 || fd >= L->fdt_n || !L->fdt[fd].used) return -EINVAL;
-  be_del(L, fd);
+#if IO_URING
+  if (L->be == IO_BE_URING) ur_disarm(L, fd);
+#endif
   L->fdt[fd].used = 0; L->fdt[fd].mask=0; L->fdt[fd].cb=NULL; L->fdt[fd].ud=NULL;
+#if IO_URING
+  if (L->be == IO_BE_URING) return 0;
+#endif
+  fd_sync(L, fd);
   return 0;
 }
 
@@ -318,82 +976,96 @@ VL_EXPORT int io_cancel_timer(ioloop* L, int id){
   return -EINVAL;
 }
 
-VL_EXPORT int io_run(ioloop* L){
-  if (!L) return -EINVAL;
-  L->running = 1;
+// Attente readiness des backends classiques; dispatch via fd_event.
+#if !IO_URING || IO_EPOLL
+static int be_wait(ioloop* L, int timeout_ms){
+  int n=0, k=0;
 #if IO_EPOLL
   struct epoll_event evs[128];
+  n = epoll_wait(L->ep, evs, (int)(sizeof(evs)/sizeof(evs[0])), timeout_ms);
+  if (n < 0) { if (errno != EINTR) return -EIO; n = 0; }
+  for (int i=0; i<n; ++i){
+    unsigned m = 0;
+    if (evs[i].events & (EPOLLIN))  m |= IO_READ;
+    if (evs[i].events & (EPOLLOUT)) m |= IO_WRITE;
+    if (evs[i].events & (EPOLLHUP|EPOLLERR|EPOLLRDHUP)) m |= IO_CLOSE;
+    k += fd_event(L, (int)evs[i].data.u32, m);
+  }
 #elif IO_KQUEUE
   struct kevent evs[128];
-#else
-  (void)evs;
+  struct timespec ts, *tsp=NULL;
+  if (timeout_ms >= 0) { ts.tv_sec = timeout_ms/1000; ts.tv_nsec=(timeout_ms%1000)*1000000L; tsp=&ts; }
+  n = kevent(L->kq, NULL, 0, evs, (int)(sizeof(evs)/sizeof(evs[0])), tsp);
+  if (n < 0) { if (errno != EINTR) return -EIO; n = 0; }
+  for (int i=0; i<n; ++i){
+    unsigned m = 0;
+    if (evs[i].filter == EVFILT_READ)  m |= IO_READ;
+    if (evs[i].filter == EVFILT_WRITE) m |= IO_WRITE;
+    if (evs[i].flags  & (EV_EOF|EV_ERROR)) m |= IO_CLOSE;
+    k += fd_event(L, (int)evs[i].ident, m);
+  }
+#else // poll
+  if (L->pdirty && be_rebuild_poll(L)!=0) return -EIO;
+  n = poll(L->pfds, (nfds_t)L->pfds_n, timeout_ms);
+  if (n < 0) { if (errno != EINTR) return -EIO; n = 0; }
+  for (int i=0; i<L->pfds_n && n > 0; ++i){
+    if (!L->pfds[i].revents) continue;
+    n--;
+    unsigned m = 0;
+    if (L->pfds[i].revents & (POLLIN))  m |= IO_READ;
+    if (L->pfds[i].revents & (POLLOUT)) m |= IO_WRITE;
+    if (L->pfds[i].revents & (POLLHUP|POLLERR)) m |= IO_CLOSE;
+    k += fd_event(L, L->pfds[i].fd, m);
+  }
+#endif
+  return k;
+}
 #endif
 
-  while (L->running) {
-    // timeout to next timer
-    int timeout_ms = -1;
-    uint64_t now = mono_ms();
-    TNode* top = heap_top(&L->th);
-    if (top) {
-      if (!top->alive) { TNode tmp; heap_pop(&L->th,&tmp); continue; }
-      timeout_ms = (top->when <= now) ? 0 : (int)(top->when - now);
-    }
+VL_EXPORT int io_poll(ioloop* L, int timeout_ms){
+  if (!L) return -EINVAL;
 
-    int n=0;
+  // timeout borné par le prochain timer (entrées annulées purgées au passage)
+  uint64_t now = mono_ms();
+  TNode* top;
+  while ((top = heap_top(&L->th)) && !top->alive) heap_pop(&L->th, NULL);
+  if (top) {
+    uint64_t d = (top->when <= now) ? 0 : top->when - now;
+    if (d > INT32_MAX) d = INT32_MAX;
+    if (timeout_ms < 0 || (uint64_t)timeout_ms > d) timeout_ms = (int)d;
+  }
+  if (L->done_head >= 0) timeout_ms = 0;   // des complétions attendent déjà
 
-#if IO_EPOLL
-    n = epoll_wait(L->ep, evs, (int)(sizeof(evs)/sizeof(evs[0])), timeout_ms);
-    if (n < 0 && errno == EINTR) continue;
-    for (int i=0; i<n; ++i){
-      int fd = (int)evs[i].data.u32;
-      unsigned m = 0;
-      if (evs[i].events & (EPOLLIN))  m |= IO_READ;
-      if (evs[i].events & (EPOLLOUT)) m |= IO_WRITE;
-      if (evs[i].events & (EPOLLHUP|EPOLLERR|EPOLLRDHUP)) m |= IO_CLOSE;
-      if (fd>=0 && fd<L->fdt_n && L->fdt[fd].used && L->fdt[fd].cb)
-        L->fdt[fd].cb(fd, m, L->fdt[fd].ud);
-    }
-#elif IO_KQUEUE
-    struct timespec ts, *tsp=NULL;
-    if (timeout_ms >= 0) { ts.tv_sec = timeout_ms/1000; ts.tv_nsec=(timeout_ms%1000)*1000000L; tsp=&ts; }
-    n = kevent(L->kq, NULL, 0, evs, (int)(sizeof(evs)/sizeof(evs[0])), tsp);
-    if (n < 0 && errno == EINTR) continue;
-    for (int i=0; i<n; ++i){
-      int fd = (int)evs[i].ident;
-      unsigned m = 0;
-      if (evs[i].filter == EVFILT_READ)  m |= IO_READ;
-      if (evs[i].filter == EVFILT_WRITE) m |= IO_WRITE;
-      if (evs[i].flags  & (EV_EOF|EV_ERROR)) m |= IO_CLOSE;
-      if (fd>=0 && fd<L->fdt_n && L->fdt[fd].used && L->fdt[fd].cb)
-        L->fdt[fd].cb(fd, m, L->fdt[fd].ud);
-    }
-#else // poll
-    if (be_rebuild_poll(L)!=0) return -EIO;
-    n = poll(L->pfds, (nfds_t)L->pfds_n, timeout_ms);
-    if (n < 0 && errno == EINTR) continue;
-    for (int i=0; i<L->pfds_n; ++i){
-      if (!L->pfds[i].revents) continue;
-      int fd = L->pfds[i].fd;
-      unsigned m = 0;
-      if (L->pfds[i].revents & (POLLIN))  m |= IO_READ;
-      if (L->pfds[i].revents & (POLLOUT)) m |= IO_WRITE;
-      if (L->pfds[i].revents & (POLLHUP|POLLERR)) m |= IO_CLOSE;
-      if (fd>=0 && fd<L->fdt_n && L->fdt[fd].used && L->fdt[fd].cb)
-        L->fdt[fd].cb(fd, m, L->fdt[fd].ud);
-    }
+  int n;
+#if IO_URING
+  if (L->be == IO_BE_URING) n = ur_wait(L, timeout_ms);
+  else
 #endif
+  n = be_wait(L, timeout_ms);
+  if (n < 0) return n;
 
-    // timers
-    now = mono_ms();
-    while ((top = heap_top(&L->th)) && top->when <= now) {
-      TNode t; heap_pop(&L->th, &t);
-      if (!t.alive) continue;
-      if (t.cb) t.cb(-1, IO_TIMER, t.ud);
-      if (t.period && t.alive) {
-        t.when = now + t.period;
-        heap_push(&L->th, t);
-      }
+  // timers
+  now = mono_ms();
+  while ((top = heap_top(&L->th)) && top->when <= now) {
+    TNode t; heap_pop(&L->th, &t);
+    if (!t.alive) continue;
+    if (t.cb) t.cb(-1, IO_TIMER, t.ud);
+    if (t.period && t.alive) {
+      t.when = now + t.period;
+      heap_push(&L->th, t);
     }
+    n++;
+  }
+  n += done_flush(L);
+  return n;
+}
+
+VL_EXPORT int io_run(ioloop* L){
+  if (!L) return -EINVAL;
+  L->running = 1;
+  while (L->running) {
+    int rc = io_poll(L, -1);
+    if (rc < 0) return rc;
   }
   return 0;
 }
@@ -411,4 +1083,344 @@ VL_EXPORT int io_add_timer(ioloop* L, uint64_t delay_ms, uint64_t period_ms,
   t.alive  = 1;
   if (heap_push(&L->th, t)!=0) return -ENOMEM;
   return t.id;
-}
\ No newline at end of file
+}
+
+// ---------- Opérations à complétion ----------
+static int op_post(ioloop* L, int kind, int fd, void* buf, size_t n, int64_t off,
+                   int fixed, unsigned bi, const struct sockaddr* sa, socklen_t salen,
+                   int timeout_ms, io_done cb, void* ud){
+  if (!L || fd < 0 || !cb) return -EINVAL;
+  if (sa && (size_t)salen > sizeof(struct sockaddr_storage)) return -EINVAL;
+  int i = op_alloc(L);
+  if (i < 0) return i;
+  IoOp* o = op_at(L, i);
+  o->kind = kind; o->state = OPS_NEW; o->fd = fd;
+  o->buf = buf; o->n = n > INT_MAX ? INT_MAX : n; o->off = off < 0 ? -1 : off;
+  o->fixed = fixed; o->bi = bi;
+  o->salen = sa ? salen : 0;
+  if (sa) memcpy(&o->sa, sa, (size_t)salen);
+  o->connecting = 0; o->timer = 0; o->cancelled = 0; o->res = 0;
+  o->timeout_ms = timeout_ms < 0 ? -1 : timeout_ms;
+  o->cb = cb; o->ud = ud;
+  int id = op_id(L, i);
+  int rc;
+#if IO_URING
+  if (L->be == IO_BE_URING) rc = ur_op(L, i);
+  else
+#endif
+  rc = em_post(L, i);
+  if (rc < 0) { op_release(L, i); return rc; }
+  return id;
+}
+
+VL_EXPORT int io_read(ioloop* L, int fd, void* buf, size_t n, int64_t off,
+                      int timeout_ms, io_done cb, void* ud){
+  return op_post(L, OP_READ, fd, buf, n, off, 0, 0, NULL, 0, timeout_ms, cb, ud);
+}
+
+VL_EXPORT int io_write(ioloop* L, int fd, const void* buf, size_t n, int64_t off,
+                       int timeout_ms, io_done cb, void* ud){
+  return op_post(L, OP_WRITE, fd, (void*)(uintptr_t)buf, n, off, 0, 0, NULL, 0, timeout_ms, cb, ud);
+}
+
+VL_EXPORT int io_read_fixed(ioloop* L, int fd, unsigned bi, void* buf, size_t n, int64_t off,
+                            int timeout_ms, io_done cb, void* ud){
+  return op_post(L, OP_READ, fd, buf, n, off, 1, bi, NULL, 0, timeout_ms, cb, ud);
+}
+
+VL_EXPORT int io_write_fixed(ioloop* L, int fd, unsigned bi, const void* buf, size_t n, int64_t off,
+                             int timeout_ms, io_done cb, void* ud){
+  return op_post(L, OP_WRITE, fd, (void*)(uintptr_t)buf, n, off, 1, bi, NULL, 0, timeout_ms, cb, ud);
+}
+
+VL_EXPORT int io_accept(ioloop* L, int fd, int timeout_ms, io_done cb, void* ud){
+  return op_post(L, OP_ACCEPT, fd, NULL, 0, -1, 0, 0, NULL, 0, timeout_ms, cb, ud);
+}
+
+VL_EXPORT int io_connect(ioloop* L, int fd, const struct sockaddr* sa, socklen_t len,
+                         int timeout_ms, io_done cb, void* ud){
+  if (!sa || !len) return -EINVAL;
+  return op_post(L, OP_CONNECT, fd, NULL, 0, -1, 0, 0, sa, len, timeout_ms, cb, ud);
+}
+
+VL_EXPORT int io_cancel_op(ioloop* L, int id){
+  if (!L) return -EINVAL;
+  int i = op_from_id(L, id);
+  if (i < 0) return -ENOENT;
+  IoOp* o = op_at(L, i);
+#if IO_URING
+  if (L->be == IO_BE_URING) {
+    if (o->cancelled) return 0;
+    struct io_uring_sqe* s = ur_sqe(&L->ur);
+    if (!s) return -EBUSY;
+    s->opcode = IORING_OP_ASYNC_CANCEL;
+    s->fd = -1;
+    s->addr = ud_pack(UK_OP, o->gen, i);
+    s->user_data = ud_pack(UK_IGN, 0, 0);
+    o->cancelled = 1;
+    return 0;
+  }
+#endif
+  if (o->state == OPS_WAIT) {
+    int f = o->fd;
+    op_unlink(L, i);
+    o->res = -ECANCELED;
+    o->cancelled = 1;
+    done_push(L, i);
+    fd_sync(L, f);
+  }
+  return 0;   // OPS_DONE: le résultat déjà obtenu sera livré
+}
+
+VL_EXPORT int io_register_buffers(ioloop* L, const struct iovec* iov, unsigned n){
+  if (!L || (n && !iov)) return -EINVAL;
+#if IO_URING
+  if (L->be == IO_BE_URING) {
+    if (L->ur.nbufs) return -EBUSY;
+    if (syscall(__NR_io_uring_register, L->ur.fd, IORING_REGISTER_BUFFERS, iov, n) < 0) return -errno;
+    L->ur.nbufs = (int)n;
+  }
+#endif
+  return 0;
+}
+
+VL_EXPORT int io_unregister_buffers(ioloop* L){
+  if (!L) return -EINVAL;
+#if IO_URING
+  if (L->be == IO_BE_URING && L->ur.nbufs) {
+    if (syscall(__NR_io_uring_register, L->ur.fd, IORING_UNREGISTER_BUFFERS, NULL, 0) < 0) return -errno;
+    L->ur.nbufs = 0;
+  }
+#endif
+  return 0;
+}
+
+// ---------- Test (optionnel) ----------
+#ifdef IOLOOP_TEST
+#include <assert.h>
+#include <stdio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+static void t_nonblock(int fd){ fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+typedef struct { int calls; unsigned ev; } t_rd;
+static void t_on_fd(int fd, unsigned ev, void* ud){ (void)fd; t_rd* r = (t_rd*)ud; r->calls++; r->ev |= ev; }
+
+typedef struct { int done; int res; } t_res;
+static void t_on_done(int res, void* ud){ t_res* r = (t_res*)ud; r->done++; r->res = res; }
+
+static void t_spin(ioloop* L, const int* flag, int want){
+  uint64_t t0 = io_now_ms();
+  while (*flag < want) { assert(io_poll(L, 100) >= 0); assert(io_now_ms() - t0 < 5000); }
+}
+
+static void t_backend(int be){
+  ioloop* L = io_new_backend(be);
+  if (!L) { assert(errno == ENOTSUP); return; }
+  printf("ioloop: %s\n", io_backend_name(L));
+
+  // disponibilité (niveau): ré-signalé tant que non consommé
+  int sv[2];
+  assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  t_nonblock(sv[0]); t_nonblock(sv[1]);
+  t_rd rd = {0, 0};
+  assert(io_add_fd(L, sv[0], IO_READ, t_on_fd, &rd) == 0);
+  assert(io_poll(L, 0) == 0 && rd.calls == 0);
+  assert(write(sv[1], "x", 1) == 1);
+  t_spin(L, &rd.calls, 1);
+  assert(rd.ev & IO_READ);
+  t_spin(L, &rd.calls, 2);
+  char c;
+  assert(read(sv[0], &c, 1) == 1);
+  int before = rd.calls;
+  io_poll(L, 0); io_poll(L, 20);
+  assert(rd.calls == before);
+  assert(io_mod_fd(L, sv[0], IO_WRITE) == 0);
+  rd.ev = 0;
+  t_spin(L, &rd.calls, before + 1);
+  assert(rd.ev == IO_WRITE);
+  assert(io_del_fd(L, sv[0]) == 0);
+  before = rd.calls;
+  io_poll(L, 20);
+  assert(rd.calls == before);
+
+  // read en attente puis write: deux complétions
+  char in[16] = {0};
+  t_res r1 = {0, 0}, w1 = {0, 0};
+  assert(io_read(L, sv[0], in, sizeof in, -1, -1, t_on_done, &r1) > 0);
+  io_poll(L, 0);
+  assert(r1.done == 0);
+  assert(io_write(L, sv[1], "hello", 5, -1, -1, t_on_done, &w1) > 0);
+  assert(w1.done == 0);                 // jamais depuis l’appel qui poste
+  t_spin(L, &r1.done, 1);
+  t_spin(L, &w1.done, 1);
+  assert(r1.res == 5 && memcmp(in, "hello", 5) == 0 && w1.res == 5);
+
+  // échéance et annulation
+  t_res to = {0, 0}, ca = {0, 0};
+  uint64_t t0 = io_now_ms();
+  assert(io_read(L, sv[0], in, sizeof in, -1, 30, t_on_done, &to) > 0);
+  t_spin(L, &to.done, 1);
+  assert(to.res == -ETIMEDOUT && io_now_ms() - t0 >= 25);
+  int id = io_read(L, sv[0], in, sizeof in, -1, -1, t_on_done, &ca);
+  assert(id > 0);
+  io_poll(L, 0);
+  assert(io_cancel_op(L, id) == 0);
+  t_spin(L, &ca.done, 1);
+  assert(ca.res == -ECANCELED);
+  assert(io_cancel_op(L, id) == -ENOENT);
+
+  // buffers enregistrés
+  static char fixed[2][64];
+  struct iovec iov[2] = { { fixed[0], sizeof fixed[0] }, { fixed[1], sizeof fixed[1] } };
+  assert(io_register_buffers(L, iov, 2) == 0);
+  memcpy(fixed[0], "fixed!", 6);
+  t_res fr = {0, 0}, fw = {0, 0};
+  assert(io_read_fixed(L, sv[0], 1, fixed[1], sizeof fixed[1], -1, -1, t_on_done, &fr) > 0);
+  assert(io_write_fixed(L, sv[1], 0, fixed[0], 6, -1, -1, t_on_done, &fw) > 0);
+  t_spin(L, &fr.done, 1);
+  t_spin(L, &fw.done, 1);
+  assert(fw.res == 6 && fr.res == 6 && memcmp(fixed[1], "fixed!", 6) == 0);
+  assert(io_unregister_buffers(L) == 0);
+  close(sv[0]); close(sv[1]);
+
+  // accept + connect (TCP local)
+  int ls = socket(AF_INET, SOCK_STREAM, 0);
+  assert(ls >= 0);
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof a);
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  assert(bind(ls, (struct sockaddr*)&a, sizeof a) == 0 && listen(ls, 16) == 0);
+  socklen_t al = sizeof a;
+  assert(getsockname(ls, (struct sockaddr*)&a, &al) == 0);
+  t_nonblock(ls);
+  int cs = socket(AF_INET, SOCK_STREAM, 0);
+  t_nonblock(cs);
+  t_res ac = {0, 0}, co = {0, 0};
+  assert(io_accept(L, ls, 2000, t_on_done, &ac) > 0);
+  assert(io_connect(L, cs, (struct sockaddr*)&a, al, 2000, t_on_done, &co) > 0);
+  memset(&a, 0xAB, sizeof a);           // copiée par io_connect
+  t_spin(L, &ac.done, 1);
+  t_spin(L, &co.done, 1);
+  assert(ac.res >= 0 && co.res == 0);
+  assert(fcntl(ac.res, F_GETFL) & O_NONBLOCK);
+  assert(fcntl(ac.res, F_GETFD) & FD_CLOEXEC);
+  close(ac.res); close(cs);
+  t_res ato = {0, 0};
+  assert(io_accept(L, ls, 20, t_on_done, &ato) > 0);
+  t_spin(L, &ato.done, 1);
+  assert(ato.res == -ETIMEDOUT);
+  close(ls);
+
+  // un lot plus grand que la SQ: 600 paires, lecture postée avant l’écriture
+  enum { P = 600 };
+  static int pr[P][2];
+  static char buf[P][8];
+  static t_res rr[P], ww[P];
+  static int val[P];                    // vivants jusqu’à la complétion
+  int nrr = 0;
+  for (int i = 0; i < P; i++) {
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, pr[i]) == 0);
+    t_nonblock(pr[i][0]); t_nonblock(pr[i][1]);
+    rr[i].done = ww[i].done = 0;
+    assert(io_read(L, pr[i][0], buf[i], sizeof buf[i], -1, -1, t_on_done, &rr[i]) > 0);
+    val[i] = i;
+    assert(io_write(L, pr[i][1], &val[i], sizeof val[i], -1, -1, t_on_done, &ww[i]) > 0);
+  }
+  t0 = io_now_ms();
+  while (nrr < P) {
+    assert(io_poll(L, 100) >= 0 && io_now_ms() - t0 < 5000);
+    nrr = 0;
+    for (int i = 0; i < P; i++) nrr += rr[i].done;
+  }
+  for (int i = 0; i < P; i++) {
+    int v; memcpy(&v, buf[i], sizeof v);
+    assert(rr[i].res == (int)sizeof i && v == i);
+    close(pr[i][0]); close(pr[i][1]);
+  }
+  io_free(L);
+}
+
+int main(void){
+  int bes[] = { IO_BE_URING, IO_BE_EPOLL, IO_BE_KQUEUE, IO_BE_POLL };
+  for (size_t i = 0; i < sizeof bes / sizeof bes[0]; i++) t_backend(bes[i]);
+  ioloop* L = io_new();
+  assert(L);
+  io_free(L);
+  puts("ioloop: OK");
+  return 0;
+}
+#endif
+
+// ---------- Bench (optionnel) ----------
+#ifdef IOLOOP_BENCH
+#include <stdio.h>
+
+// Écho d’un octet sur K paires de sockets: A écrit, B renvoie, A relance.
+enum { B_PAIRS = 256, B_ROUNDS = 2000 };
+typedef struct b_end { ioloop* L; int fd; int peer_a; long left; char c; } b_end;
+static long b_done;
+
+// Disponibilité + read/write: deux appels système par saut, plus l’attente.
+static void b_on_ready(int fd, unsigned ev, void* ud){
+  (void)ev;
+  b_end* e = (b_end*)ud;
+  if (read(fd, &e->c, 1) != 1) return;
+  if (e->peer_a && --e->left <= 0) { b_done++; return; }
+  if (write(fd, &e->c, 1) != 1) return;
+}
+
+// Complétions: le read est reposé et le write posté sans appel système;
+// tout part au prochain io_poll.
+static void b_on_write(int res, void* ud){ (void)res; (void)ud; }
+static void b_on_read(int res, void* ud){
+  b_end* e = (b_end*)ud;
+  if (res != 1) return;
+  if (e->peer_a && --e->left <= 0) { b_done++; return; }
+  io_write(e->L, e->fd, &e->c, 1, -1, -1, b_on_write, NULL);
+  io_read(e->L, e->fd, &e->c, 1, -1, -1, b_on_read, e);
+}
+
+static double b_now(void){
+  struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void b_run(int be, int ops){
+  ioloop* L = io_new_backend(be);
+  if (!L) return;
+  static int sv[B_PAIRS][2];
+  static b_end ends[B_PAIRS][2];
+  for (int i = 0; i < B_PAIRS; i++) {
+    socketpair(AF_UNIX, SOCK_STREAM, 0, sv[i]);
+    for (int k = 0; k < 2; k++) {
+      fcntl(sv[i][k], F_SETFL, fcntl(sv[i][k], F_GETFL) | O_NONBLOCK);
+      ends[i][k] = (b_end){ L, sv[i][k], k == 0, B_ROUNDS, 'x' };
+      if (ops) io_read(L, sv[i][k], &ends[i][k].c, 1, -1, -1, b_on_read, &ends[i][k]);
+      else io_add_fd(L, sv[i][k], IO_READ, b_on_ready, &ends[i][k]);
+    }
+  }
+  b_done = 0;
+  double t0 = b_now();
+  for (int i = 0; i < B_PAIRS; i++) {
+    if (ops) io_write(L, sv[i][0], &ends[i][0].c, 1, -1, -1, b_on_write, NULL);
+    else if (write(sv[i][0], "x", 1) != 1) return;
+  }
+  long iters = 0;
+  while (b_done < B_PAIRS) { io_poll(L, 1000); iters++; }
+  double dt = b_now() - t0;
+  printf("%-8s %-10s %7.0f k round trips/s, %.1f hops per io_poll\n", io_backend_name(L),
+         ops ? "complete" : "readiness", (double)B_PAIRS * B_ROUNDS / dt / 1e3,
+         2.0 * B_PAIRS * B_ROUNDS / (double)iters);
+  for (int i = 0; i < B_PAIRS; i++) { close(sv[i][0]); close(sv[i][1]); }
+  io_free(L);
+}
+
+int main(void){
+  int bes[] = { IO_BE_EPOLL, IO_BE_KQUEUE, IO_BE_POLL, IO_BE_URING };
+  for (size_t i = 0; i < sizeof bes / sizeof bes[0]; i++) { b_run(bes[i], 0); b_run(bes[i], 1); }
+  return 0;
+}
+#endif
@@ -4,16 +4,17 @@
 // Namespace: "kv"
 //
 // Build:
-//   cc -std=c17 -O2 -Wall -Wextra -pedantic -c kv.c
+//   cc -std=c17 -O2 -Wall -Wextra -pedantic -I.. -c kv.c   (link core/hash.c)
 //
 // Model:
 //   - Stores string keys and arbitrary byte values.
-//   - Hash table with open addressing (linear probing).
+//   - Hash table with open addressing (linear probing), keys hashed with
+//     vt_hash64 seeded per store from vt_hash_seed().
 //   - API: create, destroy, put, get, remove, clear, size, iter.
 //   - Keys are copied (null-terminated). Values copied as raw bytes.
 //
 // Note:
-//   This module is standalone. No external deps beyond libc.
+//   Only depends on libc and core/hash.c.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,6 +22,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "core/hash.h"
+
 typedef struct {
     char   *key;
     void   *value;
@@ -32,19 +35,14 @@ typedef struct {
     KVEntry *entries;
     size_t   capacity;
     size_t   count;
+    uint64_t seed;
 } KVStore;
 
 #define KV_INITIAL_CAPACITY 64
 #define KV_LOAD_FACTOR 0.7
 
-// simple FNV-1a 64-bit hash
-static uint64_t kv_hash(const char *s) {
-    uint64_t h = 1469598103934665603ull;
-    while (*s) {
-        h ^= (unsigned char)(*s++);
-        h *= 1099511628211ull;
-    }
-    return h;
+static uint64_t kv_hash(const KVStore *kv, const char *s) {
+    return vt_hash64(s, strlen(s), kv->seed);
 }
 
 static KVStore *kv_create_capacity(size_t cap) {
@@ -54,6 +52,7 @@ static KVStore *kv_create_capacity(size_t cap) {
     if (!kv->entries) { free(kv); return NULL; }
     kv->capacity = cap;
     kv->count = 0;
+    kv->seed = vt_hash_seed();
     return kv;
 }
 
@@ -81,7 +80,7 @@ bool kv_put(KVStore *kv, const char *key, const void *val, size_t vlen) {
         if (!kv_resize(kv, kv->capacity * 2)) return false;
     }
 
-    uint64_t h = kv_hash(key);
+    uint64_t h = kv_hash(kv, key);
     size_t idx = h % kv->capacity;
 
     for (;;) {
@@ -111,7 +110,7 @@ bool kv_put(KVStore *kv, const char *key, const void *val, size_t vlen) {
 
 void *kv_get(KVStore *kv, const char *key, size_t *vlen_out) {
     if (!kv || !key) return NULL;
-    uint64_t h = kv_hash(key);
+    uint64_t h = kv_hash(kv, key);
     size_t idx = h % kv->capacity;
 
     for (;;) {
@@ -127,7 +126,7 @@ void *kv_get(KVStore *kv, const char *key, size_t *vlen_out) {
 
 bool kv_remove(KVStore *kv, const char *key) {
     if (!kv || !key) return false;
-    uint64_t h = kv_hash(key);
+    uint64_t h = kv_hash(kv, key);
     size_t idx = h % kv->capacity;
 
     for (;;) {
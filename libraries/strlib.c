@@ -15,10 +15,10 @@
 //   - StringBuilder: sb_* (init, append, appendn, appendf, data, len, clear, free)
 //
 // Build:
-//   cc -std=c17 -O2 -Wall -Wextra -pedantic -c strlib.c
+//   cc -std=c17 -O2 -Wall -Wextra -pedantic -I.. -c strlib.c
 //
 // Test (STR_TEST):
-//   cc -std=c17 -O2 -Wall -Wextra -pedantic -DSTR_TEST strlib.c && ./a.out
+//   cc -std=c17 -O2 -Wall -Wextra -pedantic -I.. -DSTR_TEST strlib.c ../core/base64.c && ./a.out
 
 #include <stdlib.h>
 #include <string.h>
@@ -26,6 +26,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include "libctype.h"
+#include "core/base64.h"
 
 #ifndef STR_API
 #define STR_API
@@ -277,77 +278,42 @@ STR_API char* str_unescape_c(const char* s){
 
 /* ===================== Hex ===================== */
 
+/* Encodage/décodage: moteur vectoriel de core/base64.c */
 STR_API char* str_hex_encode(const void* data, size_t n, int uppercase){
     if (!data && n) return NULL;
-    const unsigned char* b=(const unsigned char*)data;
-    const char* hex = uppercase? "0123456789ABCDEF" : "0123456789abcdef";
     char* out=(char*)malloc(n*2+1); if(!out) return NULL;
-    for (size_t i=0;i<n;i++){ out[2*i]=hex[b[i]>>4]; out[2*i+1]=hex[b[i]&0xF]; }
+    vt_b16_encode(data,n,out,uppercase?VT_B16_UPPER:0);
     out[2*n]=0; return out;
 }
 STR_API int str_hex_decode(const char* hex, void** out_data, size_t* out_n){
     if (!hex||!out_data||!out_n) return -1;
     size_t L=strlen(hex); if (L%2) return -1;
-    unsigned char* out=(unsigned char*)malloc(L/2); if(!out) return -1;
-    for (size_t i=0;i<L; i+=2){
-        int h1=_hexval((unsigned char)hex[i]), h2=_hexval((unsigned char)hex[i+1]);
-        if (h1<0||h2<0){ free(out); return -1; }
-        out[i/2]=(unsigned char)((h1<<4)|h2);
-    }
-    *out_data=out; *out_n=L/2; return 0;
+    unsigned char* out=(unsigned char*)malloc(L?L/2:1); if(!out) return -1;
+    if (vt_b16_decode(hex,L,out,out_n)!=0){ free(out); return -1; }
+    *out_data=out; return 0;
 }
 
 /* ===================== Base64 ===================== */
 
-static const char _b64tab[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-static inline int _b64val(int c){
-    if (c>='A'&&c<='Z') return c-'A';
-    if (c>='a'&&c<='z') return 26 + c-'a';
-    if (c>='0'&&c<='9') return 52 + c-'0';
-    if (c=='+') return 62; if (c=='/') return 63;
-    if (c=='=') return -2; return -1;
-}
 STR_API char* str_base64_encode(const void* data, size_t n){
     if (!data && n) return NULL;
-    const unsigned char* in=(const unsigned char*)data;
-    size_t outlen = ((n+2)/3)*4;
-    char* out=(char*)malloc(outlen+1); if(!out) return NULL;
-    size_t i=0,o=0;
-    while (i<n){
-        uint32_t v=0; size_t left=n-i;
-        v  = (uint32_t)in[i]<<16;
-        if (left>1) v |= (uint32_t)in[i+1]<<8;
-        if (left>2) v |= (uint32_t)in[i+2];
-        out[o++] = _b64tab[(v>>18)&63];
-        out[o++] = _b64tab[(v>>12)&63];
-        out[o++] = (left>1)? _b64tab[(v>>6)&63] : '=';
-        out[o++] = (left>2)? _b64tab[v&63]      : '=';
-        i += 3;
-    }
-    out[o]=0; return out;
+    char* out=(char*)malloc(VT_B64_ENC_LEN(n)+1); if(!out) return NULL;
+    out[vt_b64_encode(data,n,out,0)]=0; return out;
+}
+/* Blancs ignorés, padding facultatif */
+/* Tolérant comme avant: tout caractère hors alphabet (espaces, ponctuation,
+   « - », « _ »...) est ignoré; seuls les '=' mal placés échouent. */
+static inline int _b64keep(unsigned char c){
+    return (c>='A'&&c<='Z')||(c>='a'&&c<='z')||(c>='0'&&c<='9')||c=='+'||c=='/'||c=='=';
 }
 STR_API int str_base64_decode(const char* s, void** out_data, size_t* out_n){
     if (!s||!out_data||!out_n) return -1;
-    size_t L=strlen(s);
-    /* trim trailing ws */
-    while (L && (s[L-1]=='\n'||s[L-1]=='\r'||s[L-1]==' '||s[L-1]=='\t')) L--;
-    size_t cap=(L/4)*3; if (!cap) cap=1;
-    unsigned char* out=(unsigned char*)malloc(cap); if(!out) return -1;
-    size_t o=0; uint32_t buf=0; int pad=0; int n=0;
-    for (size_t i=0;i<L;i++){
-        int v=_b64val((unsigned char)s[i]);
-        if (v==-1) continue; /* ignore whitespace/invalids */
-        if (v==-2){ v=0; pad++; }
-        buf=(buf<<6) | (uint32_t)v; n++;
-        if (n==4){
-            if (o+3>cap){ size_t nc=cap+3; unsigned char* nb=(unsigned char*)realloc(out,nc); if(!nb){ free(out); return -1; } out=nb; cap=nc; }
-            out[o++] = (unsigned char)((buf>>16)&0xFF);
-            if (pad<2) out[o++] = (unsigned char)((buf>>8)&0xFF);
-            if (pad<1) out[o++] = (unsigned char)(buf&0xFF);
-            buf=0; n=0; pad=0;
-        }
-    }
-    *out_data=out; *out_n=o; return 0;
+    size_t L=strlen(s), k=0;
+    char* tmp=(char*)malloc(L+1); if(!tmp) return -1;
+    for (size_t i=0;i<L;i++) if (_b64keep((unsigned char)s[i])) tmp[k++]=s[i];
+    unsigned char* out=(unsigned char*)malloc(k?VT_B64_DEC_MAX(k):1);
+    if (!out||vt_b64_decode(tmp,k,out,out_n,VT_B64_NOPAD)!=0){ free(tmp); free(out); return -1; }
+    free(tmp); *out_data=out; return 0;
 }
 
 /* ===================== StringBuilder ===================== */
@@ -415,6 +381,9 @@ int main(void){
     void* back=NULL; size_t bn=0; _assert(str_hex_decode(hx,&back,&bn)==0 && bn==4 && ((unsigned char*)back)[2]==0xFE,"hex"); free(hx); free(back);
 
     char* b64=str_base64_encode("hello",5); void* db=NULL; size_t dn=0; _assert(str_base64_decode(b64,&db,&dn)==0 && dn==5 && memcmp(db,"hello",5)==0,"b64"); free(b64); free(db);
+    _assert(str_base64_decode(" aGV*s\nbG8=\t!",&db,&dn)==0 && dn==5 && memcmp(db,"hello",5)==0,"b64 lenient"); free(db);
+    _assert(str_base64_decode("aGVsbG8",&db,&dn)==0 && dn==5 && memcmp(db,"hello",5)==0,"b64 nopad"); free(db);
+    _assert(str_base64_decode("aG=Vs",&db,&dn)==-1,"b64 pad");
 
     str_sb sb; sb_init(&sb); sb_append(&sb,"Hello "); sb_appendf(&sb,"%d",123); _assert(strcmp(sb_data(&sb),"Hello 123")==0,"sb"); sb_free(&sb);
 
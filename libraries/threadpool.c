@@ -10,8 +10,11 @@
 //   Types:
 //     typedef void (*tp_task_fn)(void*);
 //     typedef struct tp_pool tp_pool;
+//     typedef struct tp_group tp_group;                                 // sur la pile de l’appelant
 //   Création / arrêt:
 //     int  tp_init(tp_pool* p, size_t nthreads, size_t queue_cap);     // cap>=1
+//     int  tp_init_ex(tp_pool* p, size_t nthreads, size_t queue_cap,
+//                     int flags);                                       // TP_STEAL: vol de travail
 //     void tp_shutdown(tp_pool* p, int drain);                          // drain=1 vide avant arrêt, 0 abort
 //   Soumission:
 //     int  tp_submit(tp_pool* p, tp_task_fn fn, void* arg);             // bloque si file pleine
@@ -22,10 +25,26 @@
 //                          void* const* args, size_t n);                // bloque par fragments
 //   Attentes:
 //     void tp_wait_idle(tp_pool* p);                                    // file vide + aucun travail actif
-//   Parallélisme de plage:
+//   Groupes de tâches (fork/join, imbricables):
+//     void tp_group_init(tp_group* g, tp_pool* p);
+//     int  tp_group_spawn(tp_group* g, tp_task_fn fn, void* arg);       // ne bloque jamais
+//     void tp_group_wait(tp_group* g);                                  // aide le pool en attendant
+//   Algorithmes parallèles (appelables depuis une tâche; 0, -1 args/OOM):
 //     int  tp_parallel_for(tp_pool* p, size_t begin, size_t end,
-//                          size_t chunk,
+//                          size_t chunk,                                // grain min, 0=auto
 //                          void (*cb)(size_t i0,size_t i1,void* u), void* u);
+//     int  tp_parallel_reduce(tp_pool* p, size_t begin, size_t end, size_t grain,
+//                             void* acc, const void* identity, size_t acc_size,
+//                             void (*leaf)(size_t i0,size_t i1,void* acc,void* u),
+//                             void (*join)(void* acc,const void* rhs,void* u), void* u);
+//     int  tp_parallel_map(tp_pool* p, const void* in, size_t in_size,
+//                          void* out, size_t out_size, size_t n,
+//                          void (*fn)(const void* x,void* y,void* u), void* u);
+//     int  tp_parallel_scan(tp_pool* p, const void* in, void* out, size_t n,
+//                           size_t size,                               // inclusif, in==out permis
+//                           void (*op)(void* acc,const void* x,void* u), void* u);
+//     int  tp_parallel_sort(tp_pool* p, void* base, size_t n, size_t size,
+//                           int (*cmp)(const void*,const void*,void* u), void* u); // stable
 //   Infos / stats (instantanées):
 //     size_t tp_queue_len(tp_pool* p);
 //     size_t tp_queue_cap(tp_pool* p);
@@ -37,11 +56,61 @@
 //   - File bornée MPMC bloquante.
 //   - Pas d’allocation dans le chemin worker sauf pour le ctx de lancement.
 //   - Pas de noms/règles temps-réel pour rester portable.
+//
+// Groupes et algorithmes:
+//   - tp_group_wait n’attend que les tâches du groupe (pas tout le pool) et
+//     exécute des tâches en file pendant l’attente: un worker qui attend un
+//     sous-groupe ne bloque donc pas le pool, à toute profondeur. File
+//     pleine ou pool arrêté: tp_group_spawn exécute la tâche sur place.
+//   - Un seul thread attend un groupe donné; le groupe se réutilise après
+//     tp_group_wait. Ne pas arrêter le pool (tp_shutdown) avec des groupes
+//     en vol.
+//   - for/reduce/map: découpage paresseux; une plage ne cède sa moitié
+//     droite que si un autre thread peut la prendre (deque locale vide, ou
+//     file plus courte que le nombre de workers), sinon avance par tranches
+//     de grain. reduce: join appelé de gauche à droite, associatif suffit.
+//   - scan: 3 passes par blocs (totaux, préfixe des totaux, remplissage),
+//     op associatif. sort: fusion stable, tampon de n*size octets.
+//
+// Mode TP_STEAL (vol de travail):
+//   - Une deque Chase-Lev par worker: une tâche soumise depuis une tâche du
+//     même pool va en bas de la deque locale (LIFO, sans verrou, extensible,
+//     jamais pleine); les autres workers volent par le haut, victime au hasard.
+//   - Soumissions externes: file d’injection MPMC bornée sans verrou
+//     (queue_cap arrondi à une puissance de 2); tp_submit attend de la place.
+//   - Workers inactifs garés sur un eventcount (futex sous Linux, mutex/cond
+//     ailleurs); un seul réveil par tâche publiée et seulement s’il y a des
+//     dormeurs.
+//   - tp_wait_idle ne doit pas être appelé depuis une tâche du pool (comme en
+//     mode file); tp_group_wait si.
+//
+// Bench (débit de création de tâches, latence fork/join, 1 à 64 threads):
+//   cc -std=gnu17 -O2 -DTP_BENCH threadpool.c pthread.c -lpthread && ./a.out
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* syscall */
+#endif
 
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <time.h>
+
+#if defined(__linux__)
+  #include <unistd.h>
+  #include <sys/syscall.h>
+  #include <linux/futex.h>
+  #define TP_FUTEX 1
+#endif
+
+#if defined(_MSC_VER)
+  #define TP_TLS __declspec(thread)
+#else
+  #define TP_TLS _Thread_local
+#endif
 
 #ifndef TP_API
 #define TP_API
@@ -98,12 +167,56 @@ PTH_API int  pth_cond_timedwait_ms(pth_cond*, pth_mutex*, unsigned);
 
 typedef void (*tp_task_fn)(void*);
 
-typedef struct { tp_task_fn fn; void* arg; } tp_task;
+struct tp_group;
+typedef struct { tp_task_fn fn; void* arg; struct tp_group* g; } tp_task;
 
 typedef struct {
     tp_task* q; size_t cap, head, tail, len;
 } tp_queue;
 
+enum { TP_STEAL = 1 };
+
+/* ===== eventcount =====
+   Attente: k=tp__ev_prepare(); revérifier la condition; puis tp__ev_cancel()
+   ou tp__ev_wait(k). Notification: publier, puis tp__ev_notify(); ne coûte
+   qu’une barrière s’il n’y a aucun dormeur. */
+typedef struct {
+    _Atomic(uint32_t) epoch;
+    atomic_int        waiters;
+#if !defined(TP_FUTEX)
+    pth_mutex mu; pth_cond cv;
+#endif
+} tp__ev;
+
+/* ===== deque Chase-Lev (Lê et al., PPoPP 2013, modèle C11) ===== */
+typedef struct { _Atomic(tp_task_fn) fn; _Atomic(void*) arg; _Atomic(struct tp_group*) g; } tp__slot;
+typedef struct tp__arr { int64_t mask; struct tp__arr* old; tp__slot s[]; } tp__arr;
+typedef struct {
+    atomic_llong      top;
+    char              pad0_[64 - sizeof(atomic_llong)];
+    atomic_llong      bottom;
+    _Atomic(tp__arr*) arr;
+    char              pad1_[64];
+} tp__deque;
+
+/* ===== file d’injection MPMC bornée (Vyukov) ===== */
+typedef struct { atomic_size_t seq; tp_task_fn fn; void* arg; struct tp_group* g; } tp__cell;
+typedef struct {
+    tp__cell*     c; size_t mask;
+    atomic_size_t enq;
+    char          pad_[64 - sizeof(atomic_size_t)];
+    atomic_size_t deq;
+} tp__inj;
+
+typedef struct tp__worker {
+    tp__deque       dq;
+    struct tp_pool* p;
+    uint64_t        rng;
+    size_t          id;
+    /* écrits par le seul propriétaire (pas de RMW partagé), sommés à la lecture */
+    atomic_size_t   active, completed;
+} tp__worker;
+
 typedef struct tp_pool {
     pth_thread* th; size_t nth;
 
@@ -114,11 +227,25 @@ typedef struct tp_pool {
 
     tp_queue    que;
 
-    int         stop;        /* 0=run, 1=drain then stop, 2=abort now */
+    atomic_int  stop;        /* 0=run, 1=drain then stop, 2=abort now */
     size_t      active;      /* tâches en cours */
     size_t      completed;   /* cumul best-effort */
+
+    /* TP_STEAL */
+    int           steal;
+    tp__worker*   w;
+    tp__inj       inj;
+    tp__ev        ev_work, ev_space, ev_idle;
+    atomic_size_t pending;   /* soumises et pas encore terminées */
+    atomic_size_t xcompleted; /* exécutées par des threads hors pool (aide) */
 } tp_pool;
 
+/* Groupe de tâches: n = 2 * tâches en vol | 1 si quelqu’un attend garé */
+typedef struct tp_group {
+    tp_pool*      p;
+    atomic_size_t n;
+} tp_group;
+
 /* ===== queue helpers ===== */
 static int  q_init(tp_queue* q, size_t cap){
     if (!q || cap==0) return -1;
@@ -146,6 +273,20 @@ static int  q_pop(tp_queue* q, tp_task* out){
 /* ===== worker ===== */
 typedef struct { tp_pool* p; } tp_ctx;
 
+static void tp__group_done(tp_pool* p, tp_group* g);
+
+/* Exécute une tâche déjà retirée de la file (active++ fait sous le verrou) */
+static int tp__q_exec(tp_pool* p, tp_task t){
+    if (t.fn) t.fn(t.arg);
+    tp__group_done(p, t.g);
+    if (pth_mutex_lock(&p->mu)!=0) return -1;
+    p->active--;
+    p->completed++;
+    if (p->active==0 && p->que.len==0) pth_cond_broadcast(&p->cv_idle);
+    pth_mutex_unlock(&p->mu);
+    return 0;
+}
+
 static int tp_worker(void* arg){
     tp_ctx* c = (tp_ctx*)arg;
     tp_pool* p = c->p;
@@ -166,21 +307,342 @@ static int tp_worker(void* arg){
         pth_cond_signal(&p->cv_not_full);
         pth_mutex_unlock(&p->mu);
 
-        if (t.fn) t.fn(t.arg);
+        if (tp__q_exec(p, t)!=0) return 0;
+    }
+}
 
-        if (pth_mutex_lock(&p->mu)!=0) return 0;
-        p->active--;
-        p->completed++;
-        if (p->active==0 && p->que.len==0) pth_cond_broadcast(&p->cv_idle);
-        pth_mutex_unlock(&p->mu);
+/* ===== mode vol de travail ===== */
+static TP_TLS tp__worker* tp__self;
+
+#if defined(TP_FUTEX)
+static void tp__futex_wait(_Atomic(uint32_t)* a, uint32_t v, unsigned ms){
+    struct timespec ts = { (time_t)(ms / 1000u), (long)(ms % 1000u) * 1000000L };
+    syscall(SYS_futex, (uint32_t*)a, FUTEX_WAIT_PRIVATE, v, ms ? &ts : NULL, NULL, 0);
+}
+static void tp__futex_wake(_Atomic(uint32_t)* a, int n){
+    syscall(SYS_futex, (uint32_t*)a, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
+#endif
+
+static int tp__ev_init(tp__ev* e){
+    atomic_init(&e->epoch, 0u); atomic_init(&e->waiters, 0);
+#if !defined(TP_FUTEX)
+    if (pth_mutex_init(&e->mu)!=0) return -1;
+    if (pth_cond_init(&e->cv)!=0) return -1;
+#endif
+    return 0;
+}
+static void tp__ev_destroy(tp__ev* e){
+#if !defined(TP_FUTEX)
+    pth_mutex_destroy(&e->mu); pth_cond_destroy(&e->cv);
+#else
+    (void)e;
+#endif
+}
+static uint32_t tp__ev_prepare(tp__ev* e){
+    atomic_fetch_add(&e->waiters, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    return atomic_load_explicit(&e->epoch, memory_order_acquire);
+}
+static void tp__ev_cancel(tp__ev* e){ atomic_fetch_sub(&e->waiters, 1); }
+/* ms=0: sans limite. Réveils parasites possibles: l’appelant reboucle. */
+static void tp__ev_wait(tp__ev* e, uint32_t key, unsigned ms){
+#if defined(TP_FUTEX)
+    if (atomic_load_explicit(&e->epoch, memory_order_acquire)==key) tp__futex_wait(&e->epoch, key, ms);
+#else
+    pth_mutex_lock(&e->mu);
+    if (atomic_load_explicit(&e->epoch, memory_order_acquire)==key){
+        if (ms) pth_cond_timedwait_ms(&e->cv, &e->mu, ms); else pth_cond_wait(&e->cv, &e->mu);
     }
+    pth_mutex_unlock(&e->mu);
+#endif
+    atomic_fetch_sub(&e->waiters, 1);
+}
+static void tp__ev_notify(tp__ev* e, int all){
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&e->waiters, memory_order_relaxed)==0) return;
+#if defined(TP_FUTEX)
+    atomic_fetch_add_explicit(&e->epoch, 1u, memory_order_release);
+    tp__futex_wake(&e->epoch, all ? INT_MAX : 1);
+#else
+    pth_mutex_lock(&e->mu);
+    atomic_fetch_add_explicit(&e->epoch, 1u, memory_order_release);
+    if (all) pth_cond_broadcast(&e->cv); else pth_cond_signal(&e->cv);
+    pth_mutex_unlock(&e->mu);
+#endif
+}
+
+static tp__arr* tp__arr_new(int64_t cap){
+    tp__arr* a = (tp__arr*)calloc(1, sizeof *a + (size_t)cap * sizeof(tp__slot));
+    if (a) a->mask = cap - 1;
+    return a;
+}
+static int tp__dq_init(tp__deque* d){
+    atomic_init(&d->top, 0); atomic_init(&d->bottom, 0);
+    tp__arr* a = tp__arr_new(256); if (!a) return -1;
+    atomic_init(&d->arr, a);
+    return 0;
+}
+static void tp__dq_free(tp__deque* d){
+    tp__arr* a = atomic_load_explicit(&d->arr, memory_order_relaxed);
+    while (a){ tp__arr* o=a->old; free(a); a=o; }
+    atomic_store_explicit(&d->arr, NULL, memory_order_relaxed);
+}
+/* Les anciens tableaux restent chaînés jusqu’à tp_shutdown: un voleur peut
+   encore y lire. */
+static int tp__dq_push(tp__deque* d, tp_task t){
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    int64_t tp = atomic_load_explicit(&d->top, memory_order_acquire);
+    tp__arr* a = atomic_load_explicit(&d->arr, memory_order_relaxed);
+    if (b - tp > a->mask){
+        tp__arr* n = tp__arr_new((a->mask + 1) * 2); if (!n) return -1;
+        for (int64_t i=tp;i<b;i++){
+            tp__slot* f=&a->s[i & a->mask]; tp__slot* g=&n->s[i & n->mask];
+            atomic_store_explicit(&g->fn, atomic_load_explicit(&f->fn, memory_order_relaxed), memory_order_relaxed);
+            atomic_store_explicit(&g->arg, atomic_load_explicit(&f->arg, memory_order_relaxed), memory_order_relaxed);
+            atomic_store_explicit(&g->g, atomic_load_explicit(&f->g, memory_order_relaxed), memory_order_relaxed);
+        }
+        n->old = a;
+        atomic_store_explicit(&d->arr, n, memory_order_release);
+        a = n;
+    }
+    atomic_store_explicit(&a->s[b & a->mask].fn, t.fn, memory_order_relaxed);
+    atomic_store_explicit(&a->s[b & a->mask].arg, t.arg, memory_order_relaxed);
+    atomic_store_explicit(&a->s[b & a->mask].g, t.g, memory_order_relaxed);
+    /* store-release plutôt que barrière + relaxed: même effet, et visible
+       des outils (TSan ignore les barrières isolées) */
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+    return 0;
+}
+static int tp__dq_pop(tp__deque* d, tp_task* out){
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    tp__arr* a = atomic_load_explicit(&d->arr, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&d->top, memory_order_relaxed);
+    if (t > b){ atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed); return 0; }
+    out->fn = atomic_load_explicit(&a->s[b & a->mask].fn, memory_order_relaxed);
+    out->arg = atomic_load_explicit(&a->s[b & a->mask].arg, memory_order_relaxed);
+    out->g = atomic_load_explicit(&a->s[b & a->mask].g, memory_order_relaxed);
+    if (t == b){
+        /* dernier élément: course avec les voleurs */
+        int won = atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                      memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return 1;
+}
+/* 1 volé, 0 vide, -1 course perdue (réessayer) */
+static int tp__dq_steal(tp__deque* d, tp_task* out){
+    int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) return 0;
+    tp__arr* a = atomic_load_explicit(&d->arr, memory_order_acquire);
+    out->fn = atomic_load_explicit(&a->s[t & a->mask].fn, memory_order_relaxed);
+    out->arg = atomic_load_explicit(&a->s[t & a->mask].arg, memory_order_relaxed);
+    out->g = atomic_load_explicit(&a->s[t & a->mask].g, memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+            memory_order_seq_cst, memory_order_relaxed)) return -1;
+    return 1;
+}
+
+static int tp__inj_init(tp__inj* q, size_t cap){
+    size_t n=2; while (n<cap) n<<=1;
+    q->c = (tp__cell*)calloc(n, sizeof *q->c); if (!q->c) return -1;
+    for (size_t i=0;i<n;i++) atomic_init(&q->c[i].seq, i);
+    q->mask = n-1;
+    atomic_init(&q->enq, 0); atomic_init(&q->deq, 0);
+    return 0;
+}
+static int tp__inj_push(tp__inj* q, tp_task t){
+    size_t pos = atomic_load_explicit(&q->enq, memory_order_relaxed);
+    for(;;){
+        tp__cell* c = &q->c[pos & q->mask];
+        size_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif==0){
+            if (atomic_compare_exchange_weak_explicit(&q->enq, &pos, pos+1,
+                    memory_order_relaxed, memory_order_relaxed)){
+                c->fn=t.fn; c->arg=t.arg; c->g=t.g;
+                atomic_store_explicit(&c->seq, pos+1, memory_order_release);
+                return 0;
+            }
+        } else if (dif<0) return -1;    /* pleine */
+        else pos = atomic_load_explicit(&q->enq, memory_order_relaxed);
+    }
+}
+static int tp__inj_pop(tp__inj* q, tp_task* out){
+    size_t pos = atomic_load_explicit(&q->deq, memory_order_relaxed);
+    for(;;){
+        tp__cell* c = &q->c[pos & q->mask];
+        size_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos+1);
+        if (dif==0){
+            if (atomic_compare_exchange_weak_explicit(&q->deq, &pos, pos+1,
+                    memory_order_relaxed, memory_order_relaxed)){
+                out->fn=c->fn; out->arg=c->arg; out->g=c->g;
+                atomic_store_explicit(&c->seq, pos + q->mask + 1, memory_order_release);
+                return 1;
+            }
+        } else if (dif<0) return 0;     /* vide */
+        else pos = atomic_load_explicit(&q->deq, memory_order_relaxed);
+    }
+}
+
+/* Local d’abord (LIFO), puis injection, puis vol chez une victime au hasard.
+   w=NULL: thread hors pool qui aide (tp_group_wait), pas de deque à lui. */
+static TP_TLS uint64_t tp__xrng;
+static int tp__find(tp_pool* p, tp__worker* w, tp_task* t){
+    if (w && tp__dq_pop(&w->dq, t)) return 1;
+    if (tp__inj_pop(&p->inj, t)){ tp__ev_notify(&p->ev_space, 0); return 1; }
+    if (w && p->nth < 2) return 0;
+    uint64_t* rng = w ? &w->rng : &tp__xrng;
+    if (!*rng) *rng = (uint64_t)(uintptr_t)&tp__xrng | 1;
+    for (int round=0; round<4; round++){
+        *rng ^= *rng << 13; *rng ^= *rng >> 7; *rng ^= *rng << 17;
+        size_t start = (size_t)(*rng % p->nth), lost = 0;
+        for (size_t k=0;k<p->nth;k++){
+            size_t v = (start + k) % p->nth;
+            if (w && v==w->id) continue;
+            int r = tp__dq_steal(&p->w[v].dq, t);
+            if (r>0) return 1;
+            if (r<0) lost++;
+        }
+        if (!lost) return 0;
+    }
+    return 0;
+}
+
+static void tp__run(tp_pool* p, tp__worker* w, tp_task t){
+    if (w){
+        /* imbriqué (aide dans tp_group_wait): active reste à 1 */
+        size_t was = atomic_load_explicit(&w->active, memory_order_relaxed);
+        atomic_store_explicit(&w->active, 1, memory_order_relaxed);
+        t.fn(t.arg);
+        atomic_store_explicit(&w->active, was, memory_order_relaxed);
+        atomic_store_explicit(&w->completed,
+            atomic_load_explicit(&w->completed, memory_order_relaxed) + 1, memory_order_relaxed);
+    } else {
+        t.fn(t.arg);
+        atomic_fetch_add_explicit(&p->xcompleted, 1, memory_order_relaxed);
+    }
+    tp__group_done(p, t.g);
+    if (atomic_fetch_sub_explicit(&p->pending, 1, memory_order_acq_rel)==1){
+        tp__ev_notify(&p->ev_idle, 1);
+        if (atomic_load(&p->stop)) tp__ev_notify(&p->ev_work, 1);
+    }
+}
+
+static size_t tp__ws_sum(tp_pool* p, int completed){
+    size_t v=0;
+    for (size_t i=0;i<p->nth;i++)
+        v += atomic_load_explicit(completed ? &p->w[i].completed : &p->w[i].active, memory_order_relaxed);
+    if (completed) v += atomic_load_explicit(&p->xcompleted, memory_order_relaxed);
+    return v;
+}
+
+typedef struct { tp_pool* p; size_t id; } tp__wctx;
+
+static int tp__ws_worker(void* arg){
+    tp__wctx* c = (tp__wctx*)arg;
+    tp_pool* p = c->p;
+    tp__worker* w = &p->w[c->id];
+    free(c);
+    tp__self = w;
+    for(;;){
+        tp_task t;
+        if (atomic_load_explicit(&p->stop, memory_order_relaxed)==2) break;
+        if (tp__find(p, w, &t)){ tp__run(p, w, t); continue; }
+        uint32_t key = tp__ev_prepare(&p->ev_work);
+        if (tp__find(p, w, &t)){ tp__ev_cancel(&p->ev_work); tp__run(p, w, t); continue; }
+        int st = atomic_load(&p->stop);
+        if (st==2 || (st==1 && atomic_load(&p->pending)==0)){ tp__ev_cancel(&p->ev_work); break; }
+        tp__ev_wait(&p->ev_work, key, 0);
+    }
+    tp__self = NULL;
+    return 0;
+}
+
+/* Depuis une tâche du pool: deque locale; sinon injection. 0, -1 (arrêt),
+   -3 (file d’injection pleine). */
+static int tp__ws_push(tp_pool* p, tp_task t){
+    tp__worker* w = tp__self;
+    int st = atomic_load(&p->stop);
+    if (w && w->p==p){
+        if (st==2) return -1;
+        atomic_fetch_add(&p->pending, 1);
+        if (tp__dq_push(&w->dq, t)!=0){ atomic_fetch_sub(&p->pending, 1); return -1; }
+    } else {
+        if (st) return -1;
+        atomic_fetch_add(&p->pending, 1);
+        if (tp__inj_push(&p->inj, t)!=0){ atomic_fetch_sub(&p->pending, 1); return -3; }
+    }
+    tp__ev_notify(&p->ev_work, 0);
+    return 0;
+}
+
+/* Attente de place dans l’injection; ms=0 sans limite. */
+static int tp__ws_submit_wait(tp_pool* p, tp_task_fn fn, void* arg, unsigned ms){
+    struct timespec t0; timespec_get(&t0, TIME_UTC);
+    for(;;){
+        int rc = tp__ws_push(p, (tp_task){fn,arg,NULL});
+        if (rc!=-3) return rc;
+        unsigned left = 0;
+        if (ms){
+            struct timespec t1; timespec_get(&t1, TIME_UTC);
+            long long el = (long long)(t1.tv_sec - t0.tv_sec)*1000 + (t1.tv_nsec - t0.tv_nsec)/1000000;
+            if (el >= (long long)ms) return -2;
+            left = ms - (unsigned)el;
+        }
+        uint32_t key = tp__ev_prepare(&p->ev_space);
+        rc = tp__ws_push(p, (tp_task){fn,arg,NULL});
+        if (rc!=-3){ tp__ev_cancel(&p->ev_space); return rc; }
+        tp__ev_wait(&p->ev_space, key, left);
+    }
+}
+
+static int tp__ws_init(tp_pool* p, size_t nthreads, size_t queue_cap){
+    p->steal = 1;
+    atomic_init(&p->pending, 0); atomic_init(&p->xcompleted, 0);
+    if (tp__ev_init(&p->ev_work)!=0 || tp__ev_init(&p->ev_space)!=0 || tp__ev_init(&p->ev_idle)!=0) return -1;
+    if (tp__inj_init(&p->inj, queue_cap)!=0) return -1;
+    p->w = (tp__worker*)calloc(nthreads, sizeof *p->w); if (!p->w) return -1;
+    for (size_t i=0;i<nthreads;i++){
+        p->w[i].p = p; p->w[i].id = i;
+        atomic_init(&p->w[i].active, 0); atomic_init(&p->w[i].completed, 0);
+        p->w[i].rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        if (tp__dq_init(&p->w[i].dq)!=0) return -1;
+    }
+    p->th = (pth_thread*)calloc(nthreads, sizeof *p->th); if(!p->th) return -1;
+    p->nth = nthreads;
+    for (size_t i=0;i<nthreads;i++){
+        tp__wctx* c = (tp__wctx*)malloc(sizeof *c); if(!c) return -1;
+        c->p = p; c->id = i;
+        if (pth_thread_create(&p->th[i], tp__ws_worker, c, 0)!=0) return -1;
+    }
+    return 0;
+}
+
+static void tp__ws_shutdown(tp_pool* p, int drain){
+    atomic_store(&p->stop, drain?1:2);
+    tp__ev_notify(&p->ev_work, 1);
+    tp__ev_notify(&p->ev_space, 1);
+    for (size_t i=0;i<p->nth;i++) (void)pth_thread_join(&p->th[i], NULL);
+    free(p->th); p->th=NULL;
+    for (size_t i=0;i<p->nth;i++) tp__dq_free(&p->w[i].dq);
+    free(p->w); free(p->inj.c);
+    tp__ev_destroy(&p->ev_work); tp__ev_destroy(&p->ev_space); tp__ev_destroy(&p->ev_idle);
+    memset(p,0,sizeof *p);
 }
 
 /* ===== API ===== */
 
-TP_API int tp_init(tp_pool* p, size_t nthreads, size_t queue_cap){
+TP_API int tp_init_ex(tp_pool* p, size_t nthreads, size_t queue_cap, int flags){
     if (!p || nthreads==0 || queue_cap==0) return -1;
     memset(p,0,sizeof *p);
+    if (flags & TP_STEAL) return tp__ws_init(p, nthreads, queue_cap);
     if (pth_mutex_init(&p->mu)!=0) return -1;
     if (pth_cond_init(&p->cv_not_empty)!=0) return -1;
     if (pth_cond_init(&p->cv_not_full)!=0) return -1;
@@ -197,8 +659,13 @@ TP_API int tp_init(tp_pool* p, size_t nthreads, size_t queue_cap){
     return 0;
 }
 
+TP_API int tp_init(tp_pool* p, size_t nthreads, size_t queue_cap){
+    return tp_init_ex(p, nthreads, queue_cap, 0);
+}
+
 TP_API void tp_shutdown(tp_pool* p, int drain){
     if (!p) return;
+    if (p->steal){ tp__ws_shutdown(p, drain); return; }
     if (pth_mutex_lock(&p->mu)!=0) return;
     p->stop = drain?1:2;
     pth_cond_broadcast(&p->cv_not_empty);
@@ -218,12 +685,13 @@ TP_API void tp_shutdown(tp_pool* p, int drain){
 
 TP_API int tp_submit(tp_pool* p, tp_task_fn fn, void* arg){
     if (!p || !fn) return -1;
+    if (p->steal) return tp__ws_submit_wait(p, fn, arg, 0);
     if (pth_mutex_lock(&p->mu)!=0) return -1;
     while (p->que.len==p->que.cap && p->stop==0){
         pth_cond_wait(&p->cv_not_full, &p->mu);
     }
     if (p->stop){ pth_mutex_unlock(&p->mu); return -1; }
-    (void)q_push(&p->que, (tp_task){fn,arg});
+    (void)q_push(&p->que, (tp_task){fn,arg,NULL});
     pth_cond_signal(&p->cv_not_empty);
     pth_mutex_unlock(&p->mu);
     return 0;
@@ -231,11 +699,12 @@ TP_API int tp_submit(tp_pool* p, tp_task_fn fn, void* arg){
 
 TP_API int tp_try_submit(tp_pool* p, tp_task_fn fn, void* arg){
     if (!p || !fn) return -1;
+    if (p->steal) return tp__ws_push(p, (tp_task){fn,arg,NULL}) ? -1 : 0;
     if (pth_mutex_lock(&p->mu)!=0) return -1;
     int rc = 0;
     if (p->stop || p->que.len==p->que.cap) rc=-1;
     else {
-        (void)q_push(&p->que, (tp_task){fn,arg});
+        (void)q_push(&p->que, (tp_task){fn,arg,NULL});
         pth_cond_signal(&p->cv_not_empty);
     }
     pth_mutex_unlock(&p->mu);
@@ -244,6 +713,7 @@ TP_API int tp_try_submit(tp_pool* p, tp_task_fn fn, void* arg){
 
 TP_API int tp_timed_submit(tp_pool* p, tp_task_fn fn, void* arg, unsigned timeout_ms){
     if (!p || !fn) return -1;
+    if (p->steal) return tp__ws_submit_wait(p, fn, arg, timeout_ms?timeout_ms:1);
     if (pth_mutex_lock(&p->mu)!=0) return -1;
     int rc=0;
     while (p->que.len==p->que.cap && p->stop==0){
@@ -254,7 +724,7 @@ TP_API int tp_timed_submit(tp_pool* p, tp_task_fn fn, void* arg, unsigned timeou
     if (rc==0){
         if (p->stop) rc=-1;
         else {
-            (void)q_push(&p->que,(tp_task){fn,arg});
+            (void)q_push(&p->que,(tp_task){fn,arg,NULL});
             pth_cond_signal(&p->cv_not_empty);
         }
     }
@@ -273,6 +743,13 @@ TP_API int tp_submit_batch(tp_pool* p, const tp_task_fn* fns, void* const* args,
 
 TP_API void tp_wait_idle(tp_pool* p){
     if (!p) return;
+    if (p->steal){
+        for(;;){
+            uint32_t key = tp__ev_prepare(&p->ev_idle);
+            if (atomic_load(&p->pending)==0){ tp__ev_cancel(&p->ev_idle); return; }
+            tp__ev_wait(&p->ev_idle, key, 0);
+        }
+    }
     if (pth_mutex_lock(&p->mu)!=0) return;
     while (p->active>0 || p->que.len>0){
         pth_cond_wait(&p->cv_idle, &p->mu);
@@ -280,63 +757,575 @@ TP_API void tp_wait_idle(tp_pool* p){
     pth_mutex_unlock(&p->mu);
 }
 
-/* ===== Parallel for ===== */
+/* ===== Groupes de tâches (fork/join) ===== */
+#define TP__GW ((size_t)1)   /* bit « attente garée » de tp_group.n */
+
+/* Appelée après chaque tâche; réveille l’attente garée du groupe, s’il y en a. */
+static void tp__group_done(tp_pool* p, tp_group* g){
+    if (!g) return;
+    /* g peut disparaître dès que le compte tombe à 0: ne plus y toucher */
+    if (atomic_fetch_sub(&g->n, 2)!=(2|TP__GW)) return;
+    if (p->steal){ tp__ev_notify(&p->ev_work, 1); return; }
+    if (pth_mutex_lock(&p->mu)!=0) return;
+    pth_cond_broadcast(&p->cv_not_empty);
+    pth_mutex_unlock(&p->mu);
+}
+
+TP_API void tp_group_init(tp_group* g, tp_pool* p){
+    if (!g) return;
+    g->p = p;
+    atomic_init(&g->n, 0);
+}
+
+TP_API int tp_group_spawn(tp_group* g, tp_task_fn fn, void* arg){
+    if (!g || !g->p || !fn) return -1;
+    tp_pool* p = g->p;
+    tp_task t = {fn, arg, g};
+    atomic_fetch_add_explicit(&g->n, 2, memory_order_relaxed);
+    if (p->steal){
+        if (tp__ws_push(p, t)==0) return 0;
+    } else if (pth_mutex_lock(&p->mu)==0){
+        int ok = !p->stop && q_push(&p->que, t)==0;
+        if (ok) pth_cond_signal(&p->cv_not_empty);
+        pth_mutex_unlock(&p->mu);
+        if (ok) return 0;
+    }
+    /* file pleine ou pool arrêté: sur place plutôt que bloquer */
+    fn(arg);
+    tp__group_done(p, g);
+    return 0;
+}
+
+/* Aide à vider le pool (tâches du groupe ou non) tant que le groupe n’est pas
+   terminé; ne se gare que s’il n’y a rien à prendre. D’où l’absence
+   d’interblocage en imbrication: un worker qui attend continue d’exécuter. */
+TP_API void tp_group_wait(tp_group* g){
+    if (!g || !g->p) return;
+    tp_pool* p = g->p;
+    int slept = 0;
+    if (p->steal){
+        tp__worker* w = (tp__self && tp__self->p==p) ? tp__self : NULL;
+        tp_task t;
+        while (atomic_load(&g->n) >> 1){
+            if (tp__find(p, w, &t)){ tp__run(p, w, t); continue; }
+            uint32_t key = tp__ev_prepare(&p->ev_work);
+            atomic_fetch_or(&g->n, TP__GW);
+            if ((atomic_load(&g->n) >> 1)==0){ tp__ev_cancel(&p->ev_work); break; }
+            if (tp__find(p, w, &t)){ tp__ev_cancel(&p->ev_work); tp__run(p, w, t); continue; }
+            tp__ev_wait(&p->ev_work, key, 0);
+            slept = 1;
+        }
+        /* un réveil destiné à un worker a pu nous échoir: le relayer */
+        if (slept) tp__ev_notify(&p->ev_work, 0);
+    } else {
+        if (pth_mutex_lock(&p->mu)!=0) return;
+        while (atomic_load(&g->n) >> 1){
+            tp_task t;
+            if (q_pop(&p->que, &t)==0){
+                p->active++;
+                pth_cond_signal(&p->cv_not_full);
+                pth_mutex_unlock(&p->mu);
+                if (tp__q_exec(p, t)!=0 || pth_mutex_lock(&p->mu)!=0) return;
+                continue;
+            }
+            atomic_fetch_or(&g->n, TP__GW);
+            if ((atomic_load(&g->n) >> 1)==0) break;
+            pth_cond_wait(&p->cv_not_empty, &p->mu);
+            slept = 1;
+        }
+        if (slept && p->que.len) pth_cond_signal(&p->cv_not_empty);
+        pth_mutex_unlock(&p->mu);
+    }
+    atomic_fetch_and(&g->n, ~TP__GW);
+}
+
+/* ===== Algorithmes parallèles ===== */
+static size_t tp__ws_queued(tp_pool* p);
+TP_API size_t tp_queue_len(tp_pool* p);
+
+/* Découpage paresseux: ne couper une plage que si quelqu’un peut prendre la
+   moitié (deque locale vide, ou moins de tâches en file que de workers). */
+static int tp__want_split(tp_pool* p){
+    if (p->steal){
+        tp__worker* w = tp__self;
+        if (w && w->p==p)
+            return p->nth > 1
+                && atomic_load_explicit(&w->dq.bottom, memory_order_relaxed)
+                   - atomic_load_explicit(&w->dq.top, memory_order_relaxed) <= 0;
+        return tp__ws_queued(p) < p->nth;
+    }
+    return tp_queue_len(p) < p->nth;
+}
+static size_t tp__grain(tp_pool* p, size_t n, size_t grain){
+    if (grain) return grain;
+    grain = n / (p->nth * 8);
+    return grain ? grain : 1;
+}
+
+/* --- for --- */
 typedef struct {
-    size_t next, end, chunk;
-    void (*cb)(size_t,size_t,void*);
-    void* u;
-    pth_mutex mu;
-} tp_parfor_state;
+    tp_pool* p; size_t grain;
+    void (*cb)(size_t,size_t,void*); void* u;
+} tp__pfor;
+typedef struct { const tp__pfor* S; size_t i0, i1; } tp__range;
 
-static void tp_parfor_worker(void* arg){
-    tp_parfor_state* S=(tp_parfor_state*)arg;
-    for(;;){
-        if (pth_mutex_lock(&S->mu)!=0) return;
-        size_t i0=S->next;
-        if (i0>=S->end){ pth_mutex_unlock(&S->mu); return; }
-        size_t i1 = i0 + S->chunk; if (i1>S->end) i1=S->end;
-        S->next = i1;
-        pth_mutex_unlock(&S->mu);
-        S->cb(i0,i1,S->u);
+/* Traite [i0,i1) par tranches de grain; à chaque tranche, cède la moitié
+   droite du reste si un autre thread peut la prendre. */
+static void tp__pfor_task(void* arg){
+    tp__range* r = (tp__range*)arg;
+    const tp__pfor* S = r->S;
+    size_t i0 = r->i0, i1 = r->i1;
+    tp_group g; tp_group_init(&g, S->p);
+    tp__range kid[64]; int nk = 0;
+    while (i1 - i0 > S->grain){
+        if (nk < 64 && tp__want_split(S->p)){
+            size_t mid = i0 + (i1 - i0) / 2;
+            kid[nk] = (tp__range){S, mid, i1};
+            tp_group_spawn(&g, tp__pfor_task, &kid[nk++]);
+            i1 = mid;
+            continue;
+        }
+        S->cb(i0, i0 + S->grain, S->u);
+        i0 += S->grain;
     }
+    if (i0 < i1) S->cb(i0, i1, S->u);
+    tp_group_wait(&g);
 }
 
 TP_API int tp_parallel_for(tp_pool* p, size_t begin, size_t end, size_t chunk,
                            void (*cb)(size_t,size_t,void*), void* u){
-    if (!p || !cb || end<begin) return -1;
-    if (chunk==0) chunk=1;
-    tp_parfor_state S; S.next=begin; S.end=end; S.chunk=chunk; S.cb=cb; S.u=u;
-    pth_mutex_init(&S.mu);
+    if (!p || !cb || end<begin || !p->nth) return -1;
+    if (begin==end) return 0;
+    tp__pfor S = {p, tp__grain(p, end-begin, chunk), cb, u};
+    tp__range r = {&S, begin, end};
+    tp__pfor_task(&r);
+    return 0;
+}
+
+/* --- reduce --- */
+typedef struct {
+    tp_pool* p; size_t grain, asz;
+    const void* ident;
+    void (*leaf)(size_t,size_t,void*,void*);
+    void (*join)(void*,const void*,void*);
+    void* u;
+} tp__pred;
+typedef struct tp__rnode {
+    const tp__pred* S; size_t i0, i1; void* acc;
+    struct tp__rnode* next;
+} tp__rnode;
+#define TP__RHDR ((sizeof(tp__rnode) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1))
+
+/* Comme tp__pfor_task; chaque moitié cédée a son accumulateur (alloué avec
+   le nœud), rejoint de gauche à droite: join n’a pas à être commutatif. */
+static void tp__pred_task(void* arg){
+    tp__rnode* r = (tp__rnode*)arg;
+    const tp__pred* S = r->S;
+    size_t i0 = r->i0, i1 = r->i1;
+    tp_group g; tp_group_init(&g, S->p);
+    tp__rnode* kids = NULL;     /* le plus récent (le plus à gauche) d’abord */
+    while (i1 - i0 > S->grain){
+        if (tp__want_split(S->p)){
+            tp__rnode* k = (tp__rnode*)malloc(TP__RHDR + S->asz);
+            if (k){
+                size_t mid = i0 + (i1 - i0) / 2;
+                k->S = S; k->i0 = mid; k->i1 = i1;
+                k->acc = (unsigned char*)k + TP__RHDR;
+                memcpy(k->acc, S->ident, S->asz);
+                k->next = kids; kids = k;
+                tp_group_spawn(&g, tp__pred_task, k);
+                i1 = mid;
+                continue;
+            }
+        }
+        S->leaf(i0, i0 + S->grain, r->acc, S->u);
+        i0 += S->grain;
+    }
+    if (i0 < i1) S->leaf(i0, i1, r->acc, S->u);
+    tp_group_wait(&g);
+    while (kids){
+        tp__rnode* k = kids; kids = k->next;
+        S->join(r->acc, k->acc, S->u);
+        free(k);
+    }
+}
+
+TP_API int tp_parallel_reduce(tp_pool* p, size_t begin, size_t end, size_t grain,
+                              void* acc, const void* identity, size_t acc_size,
+                              void (*leaf)(size_t,size_t,void*,void*),
+                              void (*join)(void*,const void*,void*), void* u){
+    if (!p || !acc || !identity || !acc_size || !leaf || !join || end<begin || !p->nth) return -1;
+    if (begin==end) return 0;
+    tp__pred S = {p, tp__grain(p, end-begin, grain), acc_size, identity, leaf, join, u};
+    tp__rnode r = {&S, begin, end, acc, NULL};
+    tp__pred_task(&r);
+    return 0;
+}
+
+/* --- map --- */
+typedef struct {
+    const unsigned char* in; unsigned char* out; size_t isz, osz;
+    void (*fn)(const void*,void*,void*); void* u;
+} tp__pmap;
+static void tp__pmap_cb(size_t i0, size_t i1, void* arg){
+    const tp__pmap* M = (const tp__pmap*)arg;
+    for (size_t i=i0;i<i1;i++) M->fn(M->in + i*M->isz, M->out + i*M->osz, M->u);
+}
 
-    size_t k = p->nth? p->nth : 1, launched=0;
-    for (size_t i=0;i<k;i++){
-        if (tp_submit(p, (tp_task_fn)tp_parfor_worker, &S)==0) launched++;
-        else break;
+TP_API int tp_parallel_map(tp_pool* p, const void* in, size_t in_size,
+                           void* out, size_t out_size, size_t n,
+                           void (*fn)(const void*,void*,void*), void* u){
+    if (!p || !fn || (n && (!in || !out))) return -1;
+    tp__pmap M = {(const unsigned char*)in, (unsigned char*)out, in_size, out_size, fn, u};
+    return tp_parallel_for(p, 0, n, 0, tp__pmap_cb, &M);
+}
+
+/* --- scan (inclusif, 3 passes par blocs) --- */
+#define TP__SCAN_MIN 4096   /* éléments par bloc au minimum */
+typedef struct {
+    const unsigned char* in; unsigned char* out; size_t n, sz, nb;
+    unsigned char* sums;    /* total de chaque bloc, puis accumulateur du bloc 0 */
+    unsigned char* carry;   /* carry[b] = total des blocs < b */
+    void (*op)(void*,const void*,void*); void* u;
+} tp__pscan;
+static size_t tp__blk(const tp__pscan* C, size_t b){
+    return (C->n / C->nb) * b + (b < C->n % C->nb ? b : C->n % C->nb);
+}
+static void tp__pscan_sum(size_t b0, size_t b1, void* arg){
+    const tp__pscan* C = (const tp__pscan*)arg;
+    for (size_t b=b0;b<b1;b++){
+        size_t lo = tp__blk(C, b), hi = tp__blk(C, b+1);
+        unsigned char* acc = C->sums + b*C->sz;
+        memcpy(acc, C->in + lo*C->sz, C->sz);
+        for (size_t i=lo+1;i<hi;i++) C->op(acc, C->in + i*C->sz, C->u);
+    }
+}
+static void tp__pscan_fill(size_t b0, size_t b1, void* arg){
+    const tp__pscan* C = (const tp__pscan*)arg;
+    for (size_t b=b0;b<b1;b++){
+        size_t lo = tp__blk(C, b), hi = tp__blk(C, b+1);
+        unsigned char* acc;
+        if (b==0){
+            acc = C->sums;
+            memcpy(acc, C->in, C->sz);
+            memcpy(C->out, acc, C->sz);
+            lo++;
+        } else acc = C->carry + b*C->sz;
+        /* in[i] lu avant l’écriture de out[i]: in==out permis */
+        for (size_t i=lo;i<hi;i++){
+            C->op(acc, C->in + i*C->sz, C->u);
+            memcpy(C->out + i*C->sz, acc, C->sz);
+        }
     }
-    tp_wait_idle(p);
-    pth_mutex_destroy(&S.mu);
-    return launched?0:-1;
+}
+
+TP_API int tp_parallel_scan(tp_pool* p, const void* in, void* out, size_t n, size_t size,
+                            void (*op)(void*,const void*,void*), void* u){
+    if (!p || !op || !size || (n && (!in || !out)) || !p->nth) return -1;
+    if (n==0) return 0;
+    size_t nb = n / TP__SCAN_MIN;
+    if (nb > p->nth * 4) nb = p->nth * 4;
+    if (nb < 2) nb = 1;
+    tp__pscan C = {(const unsigned char*)in, (unsigned char*)out, n, size, nb, NULL, NULL, op, u};
+    C.sums = (unsigned char*)malloc(2 * nb * size);
+    if (!C.sums) return -1;
+    C.carry = C.sums + nb * size;
+    if (nb > 1){
+        tp_parallel_for(p, 0, nb - 1, 1, tp__pscan_sum, &C);
+        memcpy(C.carry + size, C.sums, size);
+        for (size_t b=2;b<nb;b++){
+            memcpy(C.carry + b*size, C.carry + (b-1)*size, size);
+            op(C.carry + b*size, C.sums + (b-1)*size, u);
+        }
+        tp_parallel_for(p, 0, nb, 1, tp__pscan_fill, &C);
+    } else tp__pscan_fill(0, 1, &C);
+    free(C.sums);
+    return 0;
+}
+
+/* --- sort (fusion stable, fusions elles-mêmes parallèles) --- */
+#define TP__SORT_SEQ  2048   /* en dessous: tri séquentiel */
+#define TP__MERGE_SEQ 8192   /* en dessous: fusion séquentielle */
+#define TP__INS       16     /* en dessous: insertion */
+typedef struct {
+    tp_pool* p; size_t sz;
+    int (*cmp)(const void*,const void*,void*); void* u;
+} tp__psort;
+
+static inline void tp__cpy(unsigned char* d, const unsigned char* s, size_t sz){
+    switch (sz){
+    case 4: memcpy(d, s, 4); break;
+    case 8: memcpy(d, s, 8); break;
+    default: memcpy(d, s, sz);
+    }
+}
+static void tp__ins_sort(const tp__psort* S, unsigned char* a, size_t n){
+    size_t sz = S->sz;
+    for (size_t i=1;i<n;i++)
+        for (size_t j=i; j>0 && S->cmp(a+(j-1)*sz, a+j*sz, S->u) > 0; j--){
+            unsigned char* x = a+(j-1)*sz; unsigned char* y = a+j*sz;
+            for (size_t k=0;k<sz;k++){ unsigned char c=x[k]; x[k]=y[k]; y[k]=c; }
+        }
+}
+/* a avant b à égalité: stable */
+static void tp__merge_seq(const tp__psort* S, const unsigned char* a, size_t na,
+                          const unsigned char* b, size_t nb, unsigned char* d){
+    size_t sz = S->sz;
+    while (na && nb){
+        if (S->cmp(b, a, S->u) < 0){ tp__cpy(d, b, sz); b+=sz; nb--; }
+        else                       { tp__cpy(d, a, sz); a+=sz; na--; }
+        d += sz;
+    }
+    memcpy(d, a, na*sz); d += na*sz;
+    memcpy(d, b, nb*sz);
+}
+
+typedef struct {
+    const tp__psort* S;
+    const unsigned char* a; size_t na;
+    const unsigned char* b; size_t nb;
+    unsigned char* d;
+} tp__pmerge;
+
+/* Coupe la plus longue suite en son milieu, cherche le point de coupe
+   correspondant dans l’autre (bornes choisies pour rester stable), fusionne
+   les deux moitiés en parallèle. */
+static void tp__merge_task(void* arg){
+    const tp__pmerge* m = (const tp__pmerge*)arg;
+    const tp__psort* S = m->S;
+    size_t sz = S->sz, ia, ib;
+    if (m->na + m->nb <= TP__MERGE_SEQ){ tp__merge_seq(S, m->a, m->na, m->b, m->nb, m->d); return; }
+    if (m->na >= m->nb){
+        const unsigned char* x = m->a + (ia = m->na/2)*sz;
+        size_t lo=0, hi=m->nb;      /* premier b >= x */
+        while (lo<hi){ size_t k=lo+(hi-lo)/2; if (S->cmp(m->b + k*sz, x, S->u) < 0) lo=k+1; else hi=k; }
+        ib = lo;
+    } else {
+        const unsigned char* y = m->b + (ib = m->nb/2)*sz;
+        size_t lo=0, hi=m->na;      /* premier a > y */
+        while (lo<hi){ size_t k=lo+(hi-lo)/2; if (S->cmp(y, m->a + k*sz, S->u) < 0) hi=k; else lo=k+1; }
+        ia = lo;
+    }
+    tp__pmerge L = {S, m->a, ia, m->b, ib, m->d};
+    tp__pmerge R = {S, m->a + ia*sz, m->na - ia, m->b + ib*sz, m->nb - ib, m->d + (ia+ib)*sz};
+    tp_group g; tp_group_init(&g, S->p);
+    tp_group_spawn(&g, tp__merge_task, &R);
+    tp__merge_task(&L);
+    tp_group_wait(&g);
+}
+
+/* Trie a[0..n); résultat dans t si into_t, sinon dans a; l’autre sert de
+   tampon (alternance à chaque niveau). */
+typedef struct { const tp__psort* S; unsigned char* a; unsigned char* t; size_t n; int into_t; } tp__pmsort;
+
+static void tp__msort_seq(const tp__psort* S, unsigned char* a, unsigned char* t, size_t n, int into_t){
+    size_t sz = S->sz, h = n/2;
+    if (n <= TP__INS){
+        tp__ins_sort(S, a, n);
+        if (into_t) memcpy(t, a, n*sz);
+        return;
+    }
+    tp__msort_seq(S, a, t, h, !into_t);
+    tp__msort_seq(S, a + h*sz, t + h*sz, n - h, !into_t);
+    if (into_t) tp__merge_seq(S, a, h, a + h*sz, n - h, t);
+    else        tp__merge_seq(S, t, h, t + h*sz, n - h, a);
+}
+static void tp__msort_task(void* arg){
+    const tp__pmsort* s = (const tp__pmsort*)arg;
+    const tp__psort* S = s->S;
+    size_t sz = S->sz, h = s->n/2;
+    if (s->n <= TP__SORT_SEQ){ tp__msort_seq(S, s->a, s->t, s->n, s->into_t); return; }
+    tp__pmsort L = {S, s->a, s->t, h, !s->into_t};
+    tp__pmsort R = {S, s->a + h*sz, s->t + h*sz, s->n - h, !s->into_t};
+    tp_group g; tp_group_init(&g, S->p);
+    tp_group_spawn(&g, tp__msort_task, &R);
+    tp__msort_task(&L);
+    tp_group_wait(&g);
+    unsigned char* src = s->into_t ? s->a : s->t;
+    unsigned char* dst = s->into_t ? s->t : s->a;
+    tp__pmerge m = {S, src, h, src + h*sz, s->n - h, dst};
+    tp__merge_task(&m);
+}
+
+TP_API int tp_parallel_sort(tp_pool* p, void* base, size_t n, size_t size,
+                            int (*cmp)(const void*,const void*,void*), void* u){
+    if (!p || !cmp || !size || (n && !base)) return -1;
+    if (n < 2) return 0;
+    unsigned char* t = (unsigned char*)malloc(n * size);
+    if (!t) return -1;
+    tp__psort S = {p, size, cmp, u};
+    tp__pmsort s = {&S, (unsigned char*)base, t, n, 0};
+    tp__msort_task(&s);
+    free(t);
+    return 0;
 }
 
 /* ===== Infos / stats ===== */
-TP_API size_t tp_queue_len(tp_pool* p){ if(!p) return 0; if (pth_mutex_lock(&p->mu)!=0) return 0; size_t v=p->que.len; pth_mutex_unlock(&p->mu); return v; }
-TP_API size_t tp_queue_cap(tp_pool* p){ return p? p->que.cap : 0; }
+static size_t tp__ws_queued(tp_pool* p){
+    size_t e=atomic_load_explicit(&p->inj.enq, memory_order_relaxed), d=atomic_load_explicit(&p->inj.deq, memory_order_relaxed);
+    size_t n = e>d ? e-d : 0;
+    for (size_t i=0;i<p->nth;i++){
+        long long k = atomic_load_explicit(&p->w[i].dq.bottom, memory_order_relaxed)
+                    - atomic_load_explicit(&p->w[i].dq.top, memory_order_relaxed);
+        if (k>0) n += (size_t)k;
+    }
+    return n;
+}
+TP_API size_t tp_queue_len(tp_pool* p){ if(!p) return 0; if (p->steal) return tp__ws_queued(p); if (pth_mutex_lock(&p->mu)!=0) return 0; size_t v=p->que.len; pth_mutex_unlock(&p->mu); return v; }
+TP_API size_t tp_queue_cap(tp_pool* p){ return p? (p->steal? p->inj.mask+1 : p->que.cap) : 0; }
 TP_API size_t tp_threads(tp_pool* p){ return p? p->nth : 0; }
-TP_API size_t tp_active(tp_pool* p){ if(!p) return 0; if (pth_mutex_lock(&p->mu)!=0) return 0; size_t v=p->active; pth_mutex_unlock(&p->mu); return v; }
-TP_API size_t tp_completed(tp_pool* p){ if(!p) return 0; if (pth_mutex_lock(&p->mu)!=0) return 0; size_t v=p->completed; pth_mutex_unlock(&p->mu); return v; }
+TP_API size_t tp_active(tp_pool* p){ if(!p) return 0; if (p->steal) return tp__ws_sum(p, 0); if (pth_mutex_lock(&p->mu)!=0) return 0; size_t v=p->active; pth_mutex_unlock(&p->mu); return v; }
+TP_API size_t tp_completed(tp_pool* p){ if(!p) return 0; if (p->steal) return tp__ws_sum(p, 1); if (pth_mutex_lock(&p->mu)!=0) return 0; size_t v=p->completed; pth_mutex_unlock(&p->mu); return v; }
 
 /* ===== Test minimal ===== */
 #ifdef TP_TEST
 #include <stdio.h>
 static void w(void* a){ volatile unsigned long s=0; for (unsigned i=0;i<100000;i++) s+=i; (void)s; if(a) (*(int*)a)++; }
 static void pf(size_t i0,size_t i1,void* u){ (void)u; for(size_t i=i0;i<i1;i++) w(NULL); }
+static tp_pool* g_tp;
+static atomic_int g_leaves;
+static void tree(void* a){
+    size_t d=(size_t)(uintptr_t)a;
+    if (!d){ atomic_fetch_add(&g_leaves,1); return; }
+    tp_submit(g_tp,tree,(void*)(uintptr_t)(d-1)); tp_submit(g_tp,tree,(void*)(uintptr_t)(d-1));
+}
+/* fork/join imbriqué: fib par groupes, parallel_for dans des tâches */
+typedef struct { unsigned n; unsigned long r; } fibt;
+static void fib(void* a){
+    fibt* f=(fibt*)a;
+    if (f->n<2){ f->r=f->n; return; }
+    fibt x={f->n-1,0}, y={f->n-2,0};
+    tp_group g; tp_group_init(&g,g_tp);
+    tp_group_spawn(&g,fib,&x); fib(&y); tp_group_wait(&g);
+    f->r=x.r+y.r;
+}
+static atomic_long g_sum;
+static void addr(size_t i0,size_t i1,void* u){ (void)u; long s=0; for(size_t i=i0;i<i1;i++) s+=(long)i; atomic_fetch_add(&g_sum,s); }
+static void nest(void* a){ (void)a; tp_parallel_for(g_tp,0,1000,7,addr,NULL); }
+static void rleaf(size_t i0,size_t i1,void* acc,void* u){ (void)u; for(size_t i=i0;i<i1;i++) *(uint64_t*)acc+=i; }
+static void rjoin(void* acc,const void* rhs,void* u){ (void)u; *(uint64_t*)acc+=*(const uint64_t*)rhs; }
+static void sadd(void* acc,const void* x,void* u){ (void)u; *(uint32_t*)acc+=*(const uint32_t*)x; }
+static void sq(const void* x,void* y,void* u){ (void)u; *(uint64_t*)y=(uint64_t)*(const uint32_t*)x**(const uint32_t*)x; }
+typedef struct { uint32_t key, idx; } kv;
+static int kcmp(const void* a,const void* b,void* u){ (void)u; const kv* x=a; const kv* y=b; return (x->key>y->key)-(x->key<y->key); }
+static int algos(tp_pool* tp){
+    g_tp=tp;
+    fibt f={22,0}; fib(&f);
+    if (f.r!=17711) return 1;
+    atomic_store(&g_sum,0);
+    tp_group g; tp_group_init(&g,tp);
+    for (int i=0;i<20;i++) tp_group_spawn(&g,nest,NULL);
+    tp_group_wait(&g);
+    if (atomic_load(&g_sum)!=20L*499500) return 2;
+    const size_t N=300000;
+    uint64_t acc=0, zero=0;
+    tp_parallel_reduce(tp,0,N,0,&acc,&zero,sizeof acc,rleaf,rjoin,NULL);
+    if (acc!=(uint64_t)N*(N-1)/2) return 3;
+    uint32_t* v=(uint32_t*)malloc(N*sizeof *v); uint64_t* o=(uint64_t*)malloc(N*sizeof *o); kv* k=(kv*)malloc(N*sizeof *k);
+    if (!v||!o||!k) return 9;
+    for (size_t i=0;i<N;i++) v[i]=1;
+    tp_parallel_scan(tp,v,v,N,sizeof *v,sadd,NULL);
+    for (size_t i=0;i<N;i++) if (v[i]!=i+1) return 4;
+    tp_parallel_map(tp,v,sizeof *v,o,sizeof *o,N,sq,NULL);
+    for (size_t i=0;i<N;i++) if (o[i]!=(uint64_t)(i+1)*(i+1)) return 5;
+    uint32_t x=12345; for (size_t i=0;i<N;i++){ x^=x<<13; x^=x>>17; x^=x<<5; k[i].key=x%1000; k[i].idx=(uint32_t)i; }
+    tp_parallel_sort(tp,k,N,sizeof *k,kcmp,NULL);
+    for (size_t i=1;i<N;i++) if (k[i-1].key>k[i].key || (k[i-1].key==k[i].key && k[i-1].idx>k[i].idx)) return 6;
+    free(v); free(o); free(k);
+    return 0;
+}
+int main(void){
+    for (int mode=0; mode<2; mode++){
+        tp_pool tp; if (tp_init_ex(&tp,4,mode?16:4096,mode?TP_STEAL:0)!=0){ fprintf(stderr,"init fail\n"); return 1; }
+        int cnt=0; for (int i=0;i<200;i++) tp_submit(&tp,w,NULL), cnt++;
+        tp_wait_idle(&tp);
+        g_tp=&tp; atomic_store(&g_leaves,0);
+        tp_submit(&tp,tree,(void*)(uintptr_t)10);
+        tp_wait_idle(&tp);
+        printf("%s: completed=%zu cnt=%d leaves=%d q=%zu\n", mode?"steal":"mutex",
+               tp_completed(&tp), cnt, atomic_load(&g_leaves), tp_queue_len(&tp));
+        if (tp_completed(&tp)!=200+2047 || atomic_load(&g_leaves)!=1024) return 1;
+        tp_parallel_for(&tp,0,1000,50,pf,NULL);
+        int rc=algos(&tp);
+        tp_shutdown(&tp,1);
+        /* un seul worker, file de 2: l’imbrication doit avancer quand même */
+        if (!rc){
+            if (tp_init_ex(&tp,1,2,mode?TP_STEAL:0)!=0) return 1;
+            rc=algos(&tp)*10;
+            tp_shutdown(&tp,1);
+        }
+        printf("%s: groupes/algos %s (%d)\n", mode?"steal":"mutex", rc?"ECHEC":"ok", rc);
+        if (rc) return 1;
+    }
+    return 0;
+}
+#endif
+
+/* ===== Bench ===== */
+#ifdef TP_BENCH
+#include <stdio.h>
+static tp_pool* tb_pool;
+static void tb_tree(void* a){
+    size_t d=(size_t)(uintptr_t)a;
+    if (d){ tp_submit(tb_pool,tb_tree,(void*)(uintptr_t)(d-1)); tp_submit(tb_pool,tb_tree,(void*)(uintptr_t)(d-1)); }
+}
+static void tb_nop(void* a){ (void)a; }
+static double tb_now(void){ struct timespec ts; timespec_get(&ts,TIME_UTC); return (double)ts.tv_sec+(double)ts.tv_nsec*1e-9; }
+static int tb_cmp(const void* a,const void* b,void* u){ (void)u; uint32_t x=*(const uint32_t*)a, y=*(const uint32_t*)b; return (x>y)-(x<y); }
+static int tb_qcmp(const void* a,const void* b){ return tb_cmp(a,b,NULL); }
+static void tb_sleaf(size_t i0,size_t i1,void* acc,void* u){ const uint32_t* v=(const uint32_t*)u; uint64_t s=0; for(size_t i=i0;i<i1;i++) s+=v[i]; *(uint64_t*)acc+=s; }
+static void tb_sjoin(void* acc,const void* rhs,void* u){ (void)u; *(uint64_t*)acc+=*(const uint64_t*)rhs; }
 int main(void){
-    tp_pool tp; if (tp_init(&tp,4,128)!=0){ fprintf(stderr,"init fail\n"); return 1; }
-    int cnt=0; for (int i=0;i<200;i++) tp_submit(&tp,w,&cnt);
-    tp_wait_idle(&tp);
-    printf("completed=%zu cnt=%d q=%zu\n", tp_completed(&tp), cnt, tp_queue_len(&tp));
-    tp_parallel_for(&tp,0,1000,50,pf,NULL);
-    tp_shutdown(&tp,1);
+    const unsigned depth=16; const size_t tasks=((size_t)1<<(depth+1))-1; const int rounds=2000;
+    printf("création: arbre binaire de %zu tâches soumises depuis les tâches\n", tasks);
+    printf("fork/join: nthreads tâches vides soumises de l’extérieur puis tp_wait_idle\n");
+    printf("%8s %6s %12s %14s\n","threads","mode","Mtâches/s","fork/join µs");
+    for (size_t nt=1; nt<=64; nt*=2){
+        for (int mode=0; mode<2; mode++){
+            tp_pool p; if (tp_init_ex(&p, nt, tasks+1, mode?TP_STEAL:0)!=0) return 1;
+            tb_pool=&p;
+            double best=1e9;
+            for (int r=0;r<3;r++){
+                double t0=tb_now();
+                tp_submit(&p,tb_tree,(void*)(uintptr_t)depth);
+                tp_wait_idle(&p);
+                double dt=tb_now()-t0; if (dt<best) best=dt;
+            }
+            double t0=tb_now();
+            for (int r=0;r<rounds;r++){ for (size_t k=0;k<nt;k++) tp_submit(&p,tb_nop,NULL); tp_wait_idle(&p); }
+            double fj=(tb_now()-t0)/rounds*1e6;
+            if (tp_completed(&p)!=3*tasks+(size_t)rounds*nt){ printf("compte faux\n"); return 1; }
+            printf("%8zu %6s %12.2f %14.2f\n", nt, mode?"steal":"mutex", (double)tasks/best/1e6, fj);
+            tp_shutdown(&p,1);
+        }
+    }
+
+    /* tri stable parallèle et réduction, 4M uint32 */
+    const size_t N=(size_t)1<<22;
+    uint32_t* src=(uint32_t*)malloc(N*4); uint32_t* v=(uint32_t*)malloc(N*4);
+    if (!src || !v) return 1;
+    uint32_t x=2463534242u; for (size_t i=0;i<N;i++){ x^=x<<13; x^=x>>17; x^=x<<5; src[i]=x; }
+    memcpy(v,src,N*4);
+    double t0=tb_now(); qsort(v,N,4,tb_qcmp); double tq=tb_now()-t0;
+    printf("\ntri de %zu uint32: qsort %.1f ms\n", N, tq*1e3);
+    printf("%8s %6s %12s %14s\n","threads","mode","sort ms","reduce Go/s");
+    for (size_t nt=1; nt<=8; nt*=2){
+        for (int mode=0; mode<2; mode++){
+            tp_pool p; if (tp_init_ex(&p, nt, 256, mode?TP_STEAL:0)!=0) return 1;
+            memcpy(v,src,N*4);
+            t0=tb_now(); tp_parallel_sort(&p,v,N,4,tb_cmp,NULL); double ts=tb_now()-t0;
+            for (size_t i=1;i<N;i++) if (v[i-1]>v[i]){ printf("tri faux\n"); return 1; }
+            uint64_t acc=0, zero=0; double best=1e9;
+            for (int r=0;r<5;r++){
+                acc=0; t0=tb_now();
+                tp_parallel_reduce(&p,0,N,0,&acc,&zero,sizeof acc,tb_sleaf,tb_sjoin,src);
+                double dt=tb_now()-t0; if (dt<best) best=dt;
+            }
+            printf("%8zu %6s %12.1f %14.2f\n", nt, mode?"steal":"mutex", ts*1e3, (double)N*4/best/1e9);
+            tp_shutdown(&p,1);
+        }
+    }
+    free(src); free(v);
     return 0;
 }
 #endif
\ No newline at end of file
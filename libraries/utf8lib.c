@@ -25,6 +25,7 @@
 #include <stddef.h>
 #include <string.h>
 #include "libctype.h"
+#include "core/utf8.h"
 
 /* ---------- Helpers ---------- */
 
@@ -107,12 +108,7 @@ const char* u8_prev(const char* begin,const char* s,uint32_t* cp){
 /* ---------- Validation / nettoyage ---------- */
 
 int u8_valid(const char* s,size_t n){
-    size_t i=0; while(i<n){
-        uint32_t cp; size_t used;
-        if(u8_decode(s+i,n-i,&cp,&used)!=1) return 0;
-        i+=used;
-    }
-    return 1;
+    return utf8_validate(s,n); /* SIMD, mêmes règles que u8_decode */
 }
 
 size_t u8_strip_invalid(const char* s,size_t n,char* out){
@@ -135,6 +131,7 @@ size_t u8_trim_bom(const char* s,size_t n){
 /* ---------- Mesures / accès ---------- */
 
 size_t u8_cp_count(const char* s,size_t n){
+    if(utf8_validate(s,n)) return utf8_count(s,n);
     size_t i=0,cnt=0;
     while(i<n){ uint32_t cp; size_t used; int rc=u8_decode(s+i,n-i,&cp,&used); if(rc!=1){ used=(used?used:1); } i+=used; cnt++; }
     return cnt;
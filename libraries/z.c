@@ -4,14 +4,14 @@
 // Namespace: "z"
 //
 // Points clés:
-//   • CRC32 (table générée à l’exécution)
+//   • CRC32 (core/hash.c: slice-by-16, PCLMULQDQ ou ARMv8 selon le CPU)
 //   • Mémoire: deflate/inflate (zlib si dispo, sinon passthrough)
 //   • Flux   : compress/decompress FILE*↔FILE* (chunks)
 //   • GZip   : lecture/écriture, détection auto (magic 1F 8B)
 //   • Options: niveau, stratégie simple, tailles tampon
 //
 // Build (avec zlib):
-//   cc -std=c17 -O2 -Wall -Wextra -pedantic -DHAVE_ZLIB z.c -lz
+//   cc -std=c17 -O2 -Wall -Wextra -pedantic -I.. -DHAVE_ZLIB z.c ../core/hash.c -lz
 // Build (fallback sans zlib): compile et fonctionne, mais sans compression.
 //
 // Codes retour communs:
@@ -22,6 +22,8 @@
 #include <string.h>
 #include <stdint.h>
 
+#include "core/hash.h"
+
 #if defined(HAVE_ZLIB)
   #include <zlib.h>
 #endif
@@ -32,24 +34,8 @@
 
 /* ===================== CRC32 ===================== */
 
-static uint32_t z__crc_tbl[256];
-static int z__crc_init_done = 0;
-
-static void z__crc_init(void){
-    if (z__crc_init_done) return;
-    for (uint32_t i=0;i<256;i++){
-        uint32_t c=i;
-        for (int k=0;k<8;k++) c = (c&1)? (0xEDB88320u ^ (c>>1)) : (c>>1);
-        z__crc_tbl[i]=c;
-    }
-    z__crc_init_done=1;
-}
 Z_API uint32_t z_crc32(const void* p, size_t n){
-    z__crc_init();
-    const uint8_t* s=(const uint8_t*)p;
-    uint32_t c=~0u;
-    for (size_t i=0;i<n;i++) c = z__crc_tbl[(c ^ s[i]) & 0xFFu] ^ (c>>8);
-    return ~c;
+    return vt_crc32(p, n, 0);
 }
 
 /* ===================== Mémoire ===================== */